@@ -0,0 +1,72 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POLYGON_COVERAGE_BENCHMARK_INSTANCES_H_
+#define POLYGON_COVERAGE_BENCHMARK_INSTANCES_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <polygon_coverage_geometry/cgal_definitions.h>
+
+namespace polygon_coverage_planning {
+
+// A named benchmark polygon.
+struct Instance {
+  std::string name;
+  PolygonWithHoles polygon;
+};
+
+// The layout of the pwh_instances download: one subfolder per number of holes
+// 0, ..., kMaxNumHoles, each with kNumInstances files 0000.yaml, 0001.yaml, ...
+const size_t kMaxNumHoles = 15;
+const size_t kNumInstances = 20;
+
+// Load a polygon with holes from a yaml file with a hull and a list of holes,
+// each a list of points with x and y. Holes are subtracted from the hull.
+// Files ending in .pwh are binary polygon files, see polygon_file.h.
+bool loadPolygonFromFile(const std::string& file, PolygonWithHoles* polygon);
+
+// Append the pwh_instances in directory with up to max_num_holes holes and up
+// to num_instances instances per number of holes to instances. The instances
+// are named <num_holes>/<id>, e.g., 3/0007.
+bool loadInstances(const std::string& directory, size_t max_num_holes,
+                   size_t num_instances, std::vector<Instance>* instances);
+
+// The parameters of a random polygon with holes.
+struct SyntheticSettings {
+  size_t num_holes = 0;
+  size_t num_hull_vertices = 4;  // 4: A rectangle. Otherwise star-shaped.
+  size_t num_hole_vertices = 4;  // Of each star-shaped hole.
+  double area = 1.0e4;           // Of the bounding rectangle. [m^2]
+  double aspect_ratio = 1.0;     // Width over height of the rectangle.
+  uint32_t seed = 0;             // Equal settings give equal polygons.
+};
+
+// Create a random polygon with holes. The holes are placed in distinct cells
+// of a grid, such that they neither overlap each other nor the hull. Returns
+// false if the settings are invalid or not all holes fit into the hull. Named
+// synthetic/<holes>_<hull vertices>_<hole vertices>_<area>_<ratio>_<seed>.
+bool createSyntheticInstance(const SyntheticSettings& settings,
+                             Instance* instance);
+
+}  // namespace polygon_coverage_planning
+
+#endif  // POLYGON_COVERAGE_BENCHMARK_INSTANCES_H_
@@ -0,0 +1,112 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POLYGON_COVERAGE_BENCHMARK_RUNNER_H_
+#define POLYGON_COVERAGE_BENCHMARK_RUNNER_H_
+
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <polygon_coverage_planners/memory.h>
+
+#include "polygon_coverage_benchmark/instances.h"
+
+namespace polygon_coverage_planning {
+
+// The statistics of one timer during a run. [s]
+struct TimerStatistics {
+  size_t num_samples = 0;
+  double total = 0.0;
+  double mean = 0.0;
+  double min = 0.0;
+  double max = 0.0;
+  double variance = 0.0;
+  // Tail latency from the timer histogram.
+  double p50 = 0.0;
+  double p95 = 0.0;
+  double p99 = 0.0;
+};
+
+// The result of one planner on one instance.
+struct RunResult {
+  std::string planner;
+  std::string instance;
+  std::string status;  // ok, failed, timeout or crashed.
+  size_t num_holes = 0;
+  size_t num_hole_vertices = 0;
+  size_t num_cells = 0;
+  size_t num_nodes = 0;
+  size_t num_edges = 0;
+  double cost = 0.0;       // The velocity ramp cost of the path. [s]
+  double wall_time = 0.0;  // The duration of the whole run. [s]
+  std::map<std::string, TimerStatistics> timers;
+  std::map<std::string, memory::Usage> memory;
+  // The geometric operations per stage, e.g., sweeps.edge_intersections, and
+  // in total, e.g., total.edge_intersections.
+  std::map<std::string, uint64_t> counters;
+};
+
+// One planner on one instance.
+struct Job {
+  std::string planner;
+  size_t instance;  // Index into the instances.
+};
+
+struct RunnerSettings {
+  size_t num_jobs = 1;  // Parallel worker processes. 0: hardware concurrency.
+  double timeout = 0.0;  // Per job. 0: unlimited. [s]
+  size_t num_solves = 1;  // Solves per job to sample the solve latency.
+};
+
+// The planner configurations: our_bcd, our_tcd, one_dir_gkma, gtsp_exact and
+// one_dir_exact.
+const std::vector<std::string>& getBenchmarkPlanners();
+bool isExactPlanner(const std::string& planner);
+
+// Plan an instance in this process and collect the timers, memory usage and
+// geometric operation counters.
+// Returns false if the planner is unknown. A planner that fails to set up or
+// solve sets the status failed. Solving num_solves times samples the tail
+// latency of the solve stages.
+bool runPlanner(const std::string& planner, const Instance& instance,
+                size_t num_solves, RunResult* result);
+
+// Run every job in its own forked worker process, such that crashes, timeouts
+// and process-wide state, e.g., the Mono runtime of the GK MA solver, stay
+// isolated. Up to num_jobs workers run at a time. Results are in job order.
+void runJobs(const std::vector<Instance>& instances,
+             const std::vector<Job>& jobs, const RunnerSettings& settings,
+             std::vector<RunResult>* results);
+
+// The line-based format in which workers return their result.
+void writeResult(const RunResult& result, std::ostream& out);
+bool readResult(std::istream& in, RunResult* result);
+
+// One row per result. Timer, memory and counter columns are the union over all
+// results and empty if a result lacks them.
+bool writeCsv(const std::string& file, const std::vector<RunResult>& results);
+// An array with one object per result.
+bool writeJson(const std::string& file, const std::vector<RunResult>& results);
+
+}  // namespace polygon_coverage_planning
+
+#endif  // POLYGON_COVERAGE_BENCHMARK_RUNNER_H_
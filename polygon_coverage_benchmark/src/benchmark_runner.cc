@@ -0,0 +1,155 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Run the benchmark planners on the pwh_instances or on synthetic instances in
+// parallel worker processes and write the results as CSV and JSON:
+//   rosrun polygon_coverage_benchmark benchmark_runner
+//       [--instances=<pwh_instances directory>] [--num_instances=20]
+//       [--planners=our_bcd,gtsp_exact] [--max_exact_holes=2] [--jobs=0]
+//       [--timeout=600] [--num_solves=1] [--output=/tmp/coverage_results]
+// The pwh_instances are downloaded to
+// build/polygon_coverage_ros/pwh_instances-prefix/src/pwh_instances.
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <ros/console.h>
+
+#include "polygon_coverage_benchmark/instances.h"
+#include "polygon_coverage_benchmark/runner.h"
+
+using namespace polygon_coverage_planning;
+
+namespace {
+const std::vector<size_t> kSyntheticNumHoles = {0, 1, 2, 4, 8, 16};
+
+struct Arguments {
+  std::string instances;
+  size_t num_instances = kNumInstances;
+  std::vector<std::string> planners = getBenchmarkPlanners();
+  size_t max_exact_holes = 2;
+  RunnerSettings runner_settings;
+  std::string output = "/tmp/coverage_results";
+};
+
+std::vector<std::string> split(const std::string& s) {
+  std::vector<std::string> tokens;
+  std::stringstream ss(s);
+  std::string token;
+  while (std::getline(ss, token, ',')) {
+    if (!token.empty()) tokens.push_back(token);
+  }
+  return tokens;
+}
+
+bool parseArguments(int argc, char** argv, Arguments* args) {
+  args->runner_settings.num_jobs = 0;
+  args->runner_settings.timeout = 600.0;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const size_t equal = arg.find('=');
+    const std::string key = arg.substr(0, equal);
+    const std::string value =
+        equal == std::string::npos ? "" : arg.substr(equal + 1);
+    if (key == "--instances") {
+      args->instances = value;
+    } else if (key == "--num_instances") {
+      args->num_instances = std::stoul(value);
+    } else if (key == "--planners") {
+      args->planners = split(value);
+    } else if (key == "--max_exact_holes") {
+      args->max_exact_holes = std::stoul(value);
+    } else if (key == "--jobs") {
+      args->runner_settings.num_jobs = std::stoul(value);
+    } else if (key == "--timeout") {
+      args->runner_settings.timeout = std::stod(value);
+    } else if (key == "--num_solves") {
+      args->runner_settings.num_solves = std::stoul(value);
+    } else if (key == "--output") {
+      args->output = value;
+    } else {
+      ROS_ERROR_STREAM("Unknown argument " << arg);
+      return false;
+    }
+  }
+  const std::vector<std::string>& planners = getBenchmarkPlanners();
+  for (const std::string& planner : args->planners) {
+    if (std::find(planners.begin(), planners.end(), planner) ==
+        planners.end()) {
+      ROS_ERROR_STREAM("Unknown planner " << planner);
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  Arguments args;
+  try {
+    if (!parseArguments(argc, argv, &args)) return EXIT_FAILURE;
+  } catch (const std::exception& e) {
+    ROS_ERROR_STREAM("Invalid argument: " << e.what());
+    return EXIT_FAILURE;
+  }
+
+  std::vector<Instance> instances;
+  if (args.instances.empty()) {
+    for (size_t num_holes : kSyntheticNumHoles) {
+      SyntheticSettings settings;
+      settings.num_holes = num_holes;
+      instances.push_back(Instance());
+      if (!createSyntheticInstance(settings, &instances.back())) {
+        return EXIT_FAILURE;
+      }
+    }
+  } else if (!loadInstances(args.instances, kMaxNumHoles, args.num_instances,
+                            &instances)) {
+    ROS_ERROR_STREAM("Failed to load pwh_instances from " << args.instances);
+    return EXIT_FAILURE;
+  }
+
+  // The exact planners are exponential in the number of cells.
+  std::vector<Job> jobs;
+  for (size_t i = 0; i < instances.size(); ++i) {
+    for (const std::string& planner : args.planners) {
+      if (isExactPlanner(planner) &&
+          instances[i].polygon.number_of_holes() > args.max_exact_holes) {
+        continue;
+      }
+      jobs.push_back(Job{planner, i});
+    }
+  }
+  ROS_INFO_STREAM("Running " << jobs.size() << " jobs on " << instances.size()
+                             << " instances.");
+
+  std::vector<RunResult> results;
+  runJobs(instances, jobs, args.runner_settings, &results);
+  if (!writeCsv(args.output + ".csv", results) ||
+      !writeJson(args.output + ".json", results)) {
+    return EXIT_FAILURE;
+  }
+  ROS_INFO_STREAM("Saved results to " << args.output << ".csv and "
+                                      << args.output << ".json");
+  return EXIT_SUCCESS;
+}
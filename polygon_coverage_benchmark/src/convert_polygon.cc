@@ -0,0 +1,53 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Convert a yaml polygon with holes, e.g., a pwh_instance, to the binary
+// polygon file loaded by the planner parameter polygon_file:
+//   rosrun polygon_coverage_benchmark convert_polygon <polygon.yaml>
+//       <polygon.pwh> [<altitude>]
+
+#include <cstdlib>
+#include <string>
+
+#include <ros/console.h>
+
+#include <polygon_coverage_geometry/polygon_file.h>
+
+#include "polygon_coverage_benchmark/instances.h"
+
+int main(int argc, char** argv) {
+  using namespace polygon_coverage_planning;
+  if (argc < 3 || argc > 4) {
+    ROS_ERROR_STREAM("Usage: " << argv[0]
+                               << " <polygon.yaml> <polygon.pwh> [<altitude>]");
+    return EXIT_FAILURE;
+  }
+  const double altitude = argc == 4 ? std::atof(argv[3]) : 1.0;
+
+  PolygonWithHoles polygon;
+  if (!loadPolygonFromFile(argv[1], &polygon) ||
+      !savePolygonFile(argv[2], polygon, altitude)) {
+    return EXIT_FAILURE;
+  }
+  ROS_INFO_STREAM("Wrote " << argv[2] << " with "
+                           << polygon.outer_boundary().size()
+                           << " hull vertices and "
+                           << polygon.number_of_holes() << " holes.");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,226 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Google benchmark microbenchmarks of the geometry kernels and the boolean
+// lattice. Runs on synthetic instances and optionally on the pwh_instances:
+//   rosrun polygon_coverage_benchmark geometry_benchmark
+//       [--benchmark_filter=<regex>] [<pwh_instances directory>]
+// The pwh_instances are downloaded to
+// build/polygon_coverage_ros/pwh_instances-prefix/src/pwh_instances.
+
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <ros/console.h>
+
+#include <polygon_coverage_geometry/bcd.h>
+#include <polygon_coverage_geometry/decomposition.h>
+#include <polygon_coverage_geometry/offset.h>
+#include <polygon_coverage_geometry/sweep.h>
+#include <polygon_coverage_geometry/tcd.h>
+#include <polygon_coverage_geometry/visibility_graph.h>
+#include <polygon_coverage_geometry/visibility_polygon.h>
+#include <polygon_coverage_solvers/boolean_lattice.h>
+
+#include "polygon_coverage_benchmark/instances.h"
+
+namespace polygon_coverage_planning {
+namespace {
+const double kSweepDistance = 3.0;
+const double kWallDistance = 1.0;
+const Direction_2 kDecompositionDirection(0.0, 1.0);
+const std::vector<size_t> kSyntheticNumHoles = {0, 1, 4, 16, 64};
+
+// The centers of the trapezoidal cells are inside the polygon.
+std::vector<Point_2> createQueryPoints(const PolygonWithHoles& pwh) {
+  std::vector<Point_2> points;
+  for (const Polygon_2& cell : computeTCD(pwh, kDecompositionDirection)) {
+    FT x = 0.0, y = 0.0;
+    for (const Point_2& v : cell.container()) {
+      x += v.x();
+      y += v.y();
+    }
+    const double n = static_cast<double>(cell.size());
+    points.push_back(Point_2(x / n, y / n));
+  }
+  return points;
+}
+
+void BM_BCD(::benchmark::State& state, const PolygonWithHoles& pwh) {
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(computeBCD(pwh, kDecompositionDirection));
+  }
+}
+
+void BM_TCD(::benchmark::State& state, const PolygonWithHoles& pwh) {
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(computeTCD(pwh, kDecompositionDirection));
+  }
+}
+
+void BM_VisibilityPolygon(::benchmark::State& state,
+                          const PolygonWithHoles& pwh) {
+  const std::vector<Point_2> points = createQueryPoints(pwh);
+  size_t i = 0;
+  for (auto _ : state) {
+    Polygon_2 visibility_polygon;
+    ::benchmark::DoNotOptimize(computeVisibilityPolygon(
+        pwh, points[i++ % points.size()], &visibility_polygon));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_OffsetPolygon(::benchmark::State& state,
+                      const PolygonWithHoles& pwh) {
+  for (auto _ : state) {
+    PolygonWithHoles offset_polygon;
+    computeOffsetPolygon(pwh, kWallDistance, &offset_polygon);
+    ::benchmark::DoNotOptimize(offset_polygon);
+  }
+}
+
+// Sweep every cell of the boustrophedon decomposition in its best direction.
+void BM_Sweep(::benchmark::State& state, const PolygonWithHoles& pwh) {
+  const std::vector<Polygon_2> cells = computeBCD(pwh, kDecompositionDirection);
+  std::vector<visibility_graph::VisibilityGraph> graphs;
+  std::vector<Direction_2> directions(cells.size());
+  for (size_t i = 0; i < cells.size(); ++i) {
+    graphs.emplace_back(cells[i]);
+    findBestSweepDir(cells[i], &directions[i]);
+  }
+  for (auto _ : state) {
+    for (size_t i = 0; i < cells.size(); ++i) {
+      std::vector<Point_2> waypoints;
+      ::benchmark::DoNotOptimize(computeSweep(cells[i], graphs[i],
+                                              kSweepDistance, directions[i],
+                                              true, &waypoints));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * cells.size());
+}
+
+void BM_AllSweeps(::benchmark::State& state, const PolygonWithHoles& pwh) {
+  const std::vector<Polygon_2> cells = computeBCD(pwh, kDecompositionDirection);
+  for (auto _ : state) {
+    for (const Polygon_2& cell : cells) {
+      std::vector<std::vector<Point_2>> sweeps;
+      ::benchmark::DoNotOptimize(
+          computeAllSweeps(cell, kSweepDistance, &sweeps));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * cells.size());
+}
+
+void BM_VisibilityGraphCreate(::benchmark::State& state,
+                              const PolygonWithHoles& pwh) {
+  for (auto _ : state) {
+    visibility_graph::VisibilityGraph graph(pwh);
+    ::benchmark::DoNotOptimize(graph.size());
+  }
+}
+
+// Shortest paths between consecutive query points. The path memo is cleared
+// outside the timed region, such that every query searches the graph.
+void BM_VisibilityGraphQuery(::benchmark::State& state,
+                             const PolygonWithHoles& pwh) {
+  const std::vector<Point_2> points = createQueryPoints(pwh);
+  visibility_graph::VisibilityGraph graph(pwh);
+  size_t i = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    graph.clearCachedPaths();
+    state.ResumeTiming();
+    std::vector<Point_2> waypoints;
+    ::benchmark::DoNotOptimize(graph.solve(points[i % points.size()],
+                                           points[(i + 1) % points.size()],
+                                           &waypoints));
+    ++i;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_BooleanLatticeCreate(::benchmark::State& state) {
+  for (auto _ : state) {
+    boolean_lattice::BooleanLattice lattice(state.range(0));
+    ::benchmark::DoNotOptimize(lattice.size());
+  }
+}
+BENCHMARK(BM_BooleanLatticeCreate)->DenseRange(2, 12, 2);
+
+// The adjacency matrix is quadratic in the 2^n lattice nodes.
+void BM_BooleanLatticeAdjacencyMatrix(::benchmark::State& state) {
+  const boolean_lattice::BooleanLattice lattice(state.range(0));
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(lattice.getAdjacencyMatrix());
+  }
+}
+BENCHMARK(BM_BooleanLatticeAdjacencyMatrix)->DenseRange(2, 10, 2);
+
+void registerBenchmarks(const Instance& instance) {
+  typedef std::function<void(::benchmark::State&, const PolygonWithHoles&)>
+      InstanceBenchmark;
+  const std::vector<std::pair<std::string, InstanceBenchmark>> benchmarks = {
+      {"BM_BCD", BM_BCD},
+      {"BM_TCD", BM_TCD},
+      {"BM_VisibilityPolygon", BM_VisibilityPolygon},
+      {"BM_OffsetPolygon", BM_OffsetPolygon},
+      {"BM_Sweep", BM_Sweep},
+      {"BM_AllSweeps", BM_AllSweeps},
+      {"BM_VisibilityGraphCreate", BM_VisibilityGraphCreate},
+      {"BM_VisibilityGraphQuery", BM_VisibilityGraphQuery}};
+  for (const std::pair<std::string, InstanceBenchmark>& b : benchmarks) {
+    const InstanceBenchmark run = b.second;
+    const PolygonWithHoles pwh = instance.polygon;
+    ::benchmark::RegisterBenchmark(
+        (b.first + "/" + instance.name).c_str(),
+        [run, pwh](::benchmark::State& state) { run(state, pwh); })
+        ->Unit(::benchmark::kMicrosecond);
+  }
+}
+}  // namespace
+}  // namespace polygon_coverage_planning
+
+int main(int argc, char** argv) {
+  using namespace polygon_coverage_planning;
+  ::benchmark::Initialize(&argc, argv);
+
+  std::vector<Instance> instances;
+  for (size_t num_holes : kSyntheticNumHoles) {
+    SyntheticSettings settings;
+    settings.num_holes = num_holes;
+    instances.push_back(Instance());
+    if (!createSyntheticInstance(settings, &instances.back())) {
+      return EXIT_FAILURE;
+    }
+  }
+  if (argc > 1 &&
+      !loadInstances(argv[1], kMaxNumHoles, kNumInstances, &instances)) {
+    ROS_ERROR_STREAM("Failed to load pwh_instances from " << argv[1]);
+    return 1;
+  }
+  for (const Instance& instance : instances) {
+    registerBenchmarks(instance);
+  }
+
+  ::benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,225 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "polygon_coverage_benchmark/instances.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iterator>
+#include <list>
+#include <numeric>
+#include <random>
+#include <sstream>
+
+#include <CGAL/intersections.h>
+#include <ros/assert.h>
+#include <ros/console.h>
+#include <yaml-cpp/yaml.h>
+
+#include <polygon_coverage_geometry/boolean.h>
+#include <polygon_coverage_geometry/polygon_file.h>
+
+namespace polygon_coverage_planning {
+namespace {
+bool loadPolygonFromNode(const YAML::Node& node, Polygon_2* polygon) {
+  ROS_ASSERT(polygon);
+  if (!node) return false;
+  const YAML::Node points = node["points"];
+  if (!points || points.size() < 3) return false;
+  polygon->clear();
+  for (size_t i = 0; i < points.size(); ++i) {
+    const YAML::Node point = points[i];
+    if (!point["x"] || !point["y"]) return false;
+    polygon->push_back(
+        Point_2(point["x"].as<double>(), point["y"].as<double>()));
+  }
+  return true;
+}
+
+// Whether polygon lies strictly inside hull.
+bool isInside(const Polygon_2& polygon, const Polygon_2& hull) {
+  for (const Point_2& v : polygon.container()) {
+    if (hull.bounded_side(v) != CGAL::ON_BOUNDED_SIDE) return false;
+  }
+  for (EdgeConstIterator e = polygon.edges_begin(); e != polygon.edges_end();
+       ++e) {
+    for (EdgeConstIterator h = hull.edges_begin(); h != hull.edges_end(); ++h) {
+      if (CGAL::do_intersect(*e, *h)) return false;
+    }
+  }
+  return true;
+}
+}  // namespace
+
+bool loadPolygonFromFile(const std::string& file, PolygonWithHoles* polygon) {
+  ROS_ASSERT(polygon);
+  const std::string kPolygonFileExtension = ".pwh";
+  if (file.size() >= kPolygonFileExtension.size() &&
+      file.compare(file.size() - kPolygonFileExtension.size(),
+                   kPolygonFileExtension.size(), kPolygonFileExtension) == 0) {
+    double altitude = 0.0;
+    return loadPolygonFile(file, polygon, &altitude);
+  }
+  YAML::Node node;
+  try {
+    node = YAML::LoadFile(file);
+  } catch (const YAML::Exception& e) {
+    ROS_ERROR_STREAM("Cannot load " << file << ": " << e.what());
+    return false;
+  }
+
+  PolygonWithHoles pwh;
+  if (!loadPolygonFromNode(node["hull"], &pwh.outer_boundary())) {
+    ROS_ERROR_STREAM("Invalid hull in " << file);
+    return false;
+  }
+  if (pwh.outer_boundary().is_clockwise_oriented()) {
+    pwh.outer_boundary().reverse_orientation();
+  }
+  const YAML::Node holes_node = node["holes"];
+  std::list<Polygon_2> holes;
+  for (size_t i = 0; holes_node && i < holes_node.size(); ++i) {
+    holes.emplace_back();
+    if (!loadPolygonFromNode(holes_node[i], &holes.back())) {
+      ROS_ERROR_STREAM("Invalid hole " << i << " in " << file);
+      return false;
+    }
+  }
+  // Holes may touch the hull or each other. Then they are cut from the hull.
+  std::list<PolygonWithHoles> difference =
+      computeDifference(pwh.outer_boundary(), holes.begin(), holes.end());
+  if (difference.empty()) {
+    ROS_ERROR_STREAM("Holes cover the hull in " << file);
+    return false;
+  }
+
+  *polygon = difference.front();
+  return true;
+}
+
+bool loadInstances(const std::string& directory, size_t max_num_holes,
+                   size_t num_instances, std::vector<Instance>* instances) {
+  ROS_ASSERT(instances);
+  instances->reserve(instances->size() + (max_num_holes + 1) * num_instances);
+  for (size_t num_holes = 0; num_holes <= max_num_holes; ++num_holes) {
+    for (size_t i = 0; i < num_instances; ++i) {
+      std::stringstream id;
+      id << std::setw(4) << std::setfill('0') << i;
+      Instance instance;
+      instance.name = std::to_string(num_holes) + "/" + id.str();
+      if (!loadPolygonFromFile(directory + "/" + instance.name + ".yaml",
+                               &instance.polygon)) {
+        return false;
+      }
+      instances->push_back(instance);
+    }
+  }
+  return true;
+}
+
+bool createSyntheticInstance(const SyntheticSettings& settings,
+                             Instance* instance) {
+  ROS_ASSERT(instance);
+  if (settings.num_hull_vertices < 3 || settings.num_hole_vertices < 3 ||
+      settings.area <= 0.0 || settings.aspect_ratio <= 0.0) {
+    ROS_ERROR_STREAM("Invalid synthetic instance settings.");
+    return false;
+  }
+  std::mt19937 rng(settings.seed);
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+  std::stringstream name;
+  name << "synthetic/" << settings.num_holes << "_"
+       << settings.num_hull_vertices << "_" << settings.num_hole_vertices
+       << "_" << settings.area << "_" << settings.aspect_ratio << "_"
+       << settings.seed;
+  instance->name = name.str();
+  instance->polygon = PolygonWithHoles();
+
+  // The hull is a rectangle or star-shaped with vertices close to the
+  // rectangle boundary, ordered counter-clockwise by angle.
+  const double height = std::sqrt(settings.area / settings.aspect_ratio);
+  const double width = settings.aspect_ratio * height;
+  Polygon_2& hull = instance->polygon.outer_boundary();
+  if (settings.num_hull_vertices == 4) {
+    hull.push_back(Point_2(0.0, 0.0));
+    hull.push_back(Point_2(width, 0.0));
+    hull.push_back(Point_2(width, height));
+    hull.push_back(Point_2(0.0, height));
+  } else {
+    const double step = 2.0 * M_PI / settings.num_hull_vertices;
+    for (size_t i = 0; i < settings.num_hull_vertices; ++i) {
+      const double angle = (i + 0.8 * (unit(rng) - 0.5)) * step;
+      const double dx = std::cos(angle);
+      const double dy = std::sin(angle);
+      // The ray from the center hits the rectangle boundary at scale.
+      const double kEpsilon = 1.0e-9;
+      const double scale =
+          0.5 * std::min(width / std::max(std::abs(dx), kEpsilon),
+                         height / std::max(std::abs(dy), kEpsilon));
+      const double r = (0.9 + 0.1 * unit(rng)) * scale;
+      hull.push_back(Point_2(0.5 * width + r * dx, 0.5 * height + r * dy));
+    }
+  }
+  if (settings.num_holes == 0) {
+    return true;
+  }
+
+  // Grid cells inside the rectangle margin with twice as many cells as holes.
+  // Cells whose hole does not fit into the hull are skipped.
+  const double margin = 0.05;
+  const size_t num_cells = 2 * settings.num_holes;
+  const size_t num_cols = std::max<size_t>(
+      1, static_cast<size_t>(
+             std::round(std::sqrt(num_cells * settings.aspect_ratio))));
+  const size_t num_rows = (num_cells + num_cols - 1) / num_cols;
+  const double cell_width = (1.0 - 2.0 * margin) * width / num_cols;
+  const double cell_height = (1.0 - 2.0 * margin) * height / num_rows;
+  const double radius = 0.4 * std::min(cell_width, cell_height);
+  std::vector<size_t> cells(num_cols * num_rows);
+  std::iota(cells.begin(), cells.end(), 0);
+  std::shuffle(cells.begin(), cells.end(), rng);
+
+  const double step = 2.0 * M_PI / settings.num_hole_vertices;
+  for (size_t cell : cells) {
+    if (instance->polygon.number_of_holes() == settings.num_holes) break;
+    const double cx = margin * width + (cell % num_cols + 0.5) * cell_width;
+    const double cy = margin * height + (cell / num_cols + 0.5) * cell_height;
+    Polygon_2 hole;
+    for (size_t i = 0; i < settings.num_hole_vertices; ++i) {
+      const double angle = (i + 0.6 * (unit(rng) - 0.5)) * step;
+      const double r = (0.5 + 0.5 * unit(rng)) * radius;
+      hole.push_back(
+          Point_2(cx + r * std::cos(angle), cy + r * std::sin(angle)));
+    }
+    if (!isInside(hole, hull)) continue;
+    hole.reverse_orientation();  // Holes are clockwise.
+    instance->polygon.add_hole(hole);
+  }
+  if (instance->polygon.number_of_holes() < settings.num_holes) {
+    ROS_ERROR_STREAM("Only " << instance->polygon.number_of_holes() << " of "
+                             << settings.num_holes << " holes fit into "
+                             << instance->name);
+    return false;
+  }
+  return true;
+}
+
+}  // namespace polygon_coverage_planning
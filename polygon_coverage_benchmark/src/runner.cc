@@ -0,0 +1,572 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "polygon_coverage_benchmark/runner.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <thread>
+
+#include <ros/assert.h>
+#include <ros/console.h>
+
+#include <polygon_coverage_geometry/counters.h>
+#include <polygon_coverage_planners/cost_functions/path_cost_functions.h>
+#include <polygon_coverage_planners/planners/polygon_stripmap_planner.h>
+#include <polygon_coverage_planners/planners/polygon_stripmap_planner_exact.h>
+#include <polygon_coverage_planners/sensor_models/line.h>
+#include <polygon_coverage_planners/timing.h>
+
+namespace polygon_coverage_planning {
+namespace {
+const double kSweepDistance = 3.0;
+const double kOverlap = 0.0;
+const double kVMax = 3.0;
+const double kAMax = 1.0;
+const Point_2 kStart(0.0, 0.0);
+const Point_2 kGoal = kStart;
+const int kPollIntervalMs = 100;
+
+sweep_plan_graph::SweepPlanGraph::Settings createSettings(
+    const std::string& planner, const PolygonWithHoles& polygon) {
+  sweep_plan_graph::SweepPlanGraph::Settings settings;
+  settings.polygon = polygon;
+  settings.cost_function =
+      makePathCostFunction(CostFunctionType::kTime, kVMax, kAMax);
+  settings.sensor_model = std::make_shared<Line>(kSweepDistance, kOverlap);
+  settings.offset_polygons = true;
+  settings.decomposition_type = planner == "our_tcd"
+                                    ? DecompositionType::kTrapezoidal
+                                    : DecompositionType::kBCD;
+  settings.sweep_single_direction =
+      planner == "one_dir_gkma" || planner == "one_dir_exact";
+  return settings;
+}
+
+// Set the fields that do not depend on the run.
+void initResult(const std::string& planner, const Instance& instance,
+                RunResult* result) {
+  ROS_ASSERT(result);
+  *result = RunResult();
+  result->planner = planner;
+  result->instance = instance.name;
+  result->num_holes = instance.polygon.number_of_holes();
+  for (PolygonWithHoles::Hole_const_iterator hit =
+           instance.polygon.holes_begin();
+       hit != instance.polygon.holes_end(); ++hit) {
+    result->num_hole_vertices += hit->size();
+  }
+}
+
+void collectStatistics(RunResult* result) {
+  ROS_ASSERT(result);
+  const timing::Timing::map_t timers = timing::Timing::GetTimers();
+  for (const std::pair<const std::string, size_t>& timer : timers) {
+    const size_t num_samples = timing::Timing::GetNumSamples(timer.second);
+    if (num_samples == 0) continue;
+    TimerStatistics& statistics = result->timers[timer.first];
+    statistics.num_samples = num_samples;
+    statistics.total = timing::Timing::GetTotalSeconds(timer.second);
+    statistics.mean = timing::Timing::GetMeanSeconds(timer.second);
+    statistics.min = timing::Timing::GetMinSeconds(timer.second);
+    statistics.max = timing::Timing::GetMaxSeconds(timer.second);
+    statistics.variance = timing::Timing::GetVarianceSeconds(timer.second);
+    statistics.p50 = timing::Timing::GetPercentileSeconds(timer.second, 50.0);
+    statistics.p95 = timing::Timing::GetPercentileSeconds(timer.second, 95.0);
+    statistics.p99 = timing::Timing::GetPercentileSeconds(timer.second, 99.0);
+  }
+  result->memory = memory::Memory::GetUsage();
+
+  std::map<std::string, counters::Counts> stages =
+      counters::Counters::GetStages();
+  stages["total"] = counters::Counters::GetCounts();
+  for (const std::pair<const std::string, counters::Counts>& stage : stages) {
+    for (size_t i = 0; i < counters::kNumCounters; ++i) {
+      const counters::Counter counter = static_cast<counters::Counter>(i);
+      result->counters[stage.first + "." +
+                       counters::Counters::GetName(counter)] =
+          stage.second[i];
+    }
+  }
+}
+
+double getSeconds(const std::chrono::steady_clock::time_point& start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+
+// A forked worker process and the output it has written so far.
+struct Worker {
+  pid_t pid;
+  int fd;  // The read end of the result pipe.
+  size_t job;
+  std::chrono::steady_clock::time_point start;
+  std::string output;
+};
+
+// Plan in the forked child and write the result to fd. Never returns.
+void runWorker(const std::string& planner, const Instance& instance,
+               size_t num_solves, int fd) {
+  RunResult result;
+  bool success = runPlanner(planner, instance, num_solves, &result);
+  std::stringstream ss;
+  writeResult(result, ss);
+  const std::string output = ss.str();
+  size_t num_written = 0;
+  while (success && num_written < output.size()) {
+    const ssize_t n =
+        write(fd, output.data() + num_written, output.size() - num_written);
+    if (n < 0 && errno == EINTR) continue;
+    success = n > 0;
+    num_written += success ? n : 0;
+  }
+  close(fd);
+  _exit(success ? 0 : 1);
+}
+
+// Read all available output of a worker. Returns false at the end of the
+// output.
+bool readOutput(Worker* worker) {
+  ROS_ASSERT(worker);
+  char buffer[4096];
+  while (true) {
+    const ssize_t n = read(worker->fd, buffer, sizeof(buffer));
+    if (n > 0) {
+      worker->output.append(buffer, n);
+    } else if (n < 0 && errno == EINTR) {
+      continue;
+    } else {
+      return n < 0 && errno == EAGAIN;
+    }
+  }
+}
+
+bool startWorker(const std::vector<Instance>& instances, const Job& job,
+                 size_t job_id, size_t num_solves,
+                 std::vector<Worker>* workers) {
+  ROS_ASSERT(workers);
+  int fds[2];
+  if (pipe(fds) != 0) {
+    ROS_ERROR_STREAM("Cannot create pipe: " << std::strerror(errno));
+    return false;
+  }
+  // The child inherits unflushed output.
+  std::cout.flush();
+  std::fflush(stdout);
+  std::fflush(stderr);
+  const pid_t pid = fork();
+  if (pid == 0) {
+    close(fds[0]);
+    runWorker(job.planner, instances[job.instance], num_solves, fds[1]);
+  }
+  close(fds[1]);
+  if (pid < 0) {
+    ROS_ERROR_STREAM("Cannot fork worker: " << std::strerror(errno));
+    close(fds[0]);
+    return false;
+  }
+  fcntl(fds[0], F_SETFL, O_NONBLOCK);
+  workers->push_back(
+      Worker{pid, fds[0], job_id, std::chrono::steady_clock::now(), ""});
+  return true;
+}
+
+void writeString(const std::string& s, std::ostream& out) {
+  out << '"';
+  for (const char c : s) {
+    if (c == '"' || c == '\\') {
+      out << '\\';
+    }
+    out << c;
+  }
+  out << '"';
+}
+
+void writeNumber(double x, std::ostream& out) {
+  if (std::isfinite(x)) {
+    out << x;
+  } else {
+    out << "null";
+  }
+}
+}  // namespace
+
+const std::vector<std::string>& getBenchmarkPlanners() {
+  static const std::vector<std::string> kPlanners = {
+      "our_bcd", "our_tcd", "one_dir_gkma", "gtsp_exact", "one_dir_exact"};
+  return kPlanners;
+}
+
+bool isExactPlanner(const std::string& planner) {
+  return planner == "gtsp_exact" || planner == "one_dir_exact";
+}
+
+bool runPlanner(const std::string& planner, const Instance& instance,
+                size_t num_solves, RunResult* result) {
+  ROS_ASSERT(result);
+  const std::vector<std::string>& planners = getBenchmarkPlanners();
+  if (std::find(planners.begin(), planners.end(), planner) == planners.end()) {
+    ROS_ERROR_STREAM("Unknown planner " << planner);
+    return false;
+  }
+  initResult(planner, instance, result);
+  result->status = "failed";
+  const std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  timing::Timing::Reset();
+  memory::Memory::Reset();
+  counters::Counters::Start();
+
+  const sweep_plan_graph::SweepPlanGraph::Settings settings =
+      createSettings(planner, instance.polygon);
+  std::unique_ptr<PolygonStripmapPlanner> stripmap_planner(
+      isExactPlanner(planner) ? new PolygonStripmapPlannerExact(settings)
+                              : new PolygonStripmapPlanner(settings));
+
+  timing::Timer timer_setup("timer_setup");
+  bool success = stripmap_planner->setup();
+  timer_setup.Stop();
+  std::vector<Point_2> solution;
+  for (size_t i = 0; success && i < std::max<size_t>(num_solves, 1); ++i) {
+    timing::Timer timer_solve("timer_solve");
+    success = stripmap_planner->solve(kStart, kGoal, &solution);
+    timer_solve.Stop();
+  }
+  if (success) {
+    result->status = "ok";
+    result->cost = computeVelocityRampPathCost(solution, kVMax, kAMax);
+  }
+  result->num_cells = stripmap_planner->getDecompositionSize();
+  result->num_nodes = stripmap_planner->getNumberOfNodes();
+  result->num_edges = stripmap_planner->getNumberOfEdges();
+  memory::Memory::ReportPeakRss("peak_rss.total");
+  counters::Counters::Stop();
+  collectStatistics(result);
+  result->wall_time = getSeconds(start);
+  return true;
+}
+
+void runJobs(const std::vector<Instance>& instances,
+             const std::vector<Job>& jobs, const RunnerSettings& settings,
+             std::vector<RunResult>* results) {
+  ROS_ASSERT(results);
+  results->resize(jobs.size());
+  for (size_t i = 0; i < jobs.size(); ++i) {
+    ROS_ASSERT(jobs[i].instance < instances.size());
+    initResult(jobs[i].planner, instances[jobs[i].instance], &(*results)[i]);
+    (*results)[i].status = "crashed";
+  }
+  const size_t num_workers =
+      settings.num_jobs > 0
+          ? settings.num_jobs
+          : std::max<size_t>(1, std::thread::hardware_concurrency());
+
+  std::vector<Worker> workers;
+  size_t next_job = 0;
+  size_t num_done = 0;
+  while (next_job < jobs.size() || !workers.empty()) {
+    while (workers.size() < num_workers && next_job < jobs.size()) {
+      if (!startWorker(instances, jobs[next_job], next_job,
+                       settings.num_solves, &workers)) {
+        ++num_done;
+      }
+      ++next_job;
+    }
+
+    std::vector<pollfd> fds;
+    for (const Worker& worker : workers) {
+      fds.push_back(pollfd{worker.fd, POLLIN, 0});
+    }
+    poll(fds.data(), fds.size(), kPollIntervalMs);
+
+    for (std::vector<Worker>::iterator it = workers.begin();
+         it != workers.end();) {
+      RunResult& result = (*results)[it->job];
+      const bool is_open = readOutput(&*it);
+      int status = 0;
+      const pid_t pid = waitpid(it->pid, &status, WNOHANG);
+      const double elapsed = getSeconds(it->start);
+      if (pid == it->pid) {
+        if (is_open) {
+          readOutput(&*it);  // Exited after the last read.
+        }
+        std::stringstream output(it->output);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0 ||
+            !readResult(output, &result)) {
+          result.status = "crashed";
+          result.wall_time = elapsed;
+        }
+      } else if (settings.timeout > 0.0 && elapsed > settings.timeout) {
+        kill(it->pid, SIGKILL);
+        waitpid(it->pid, &status, 0);
+        result.status = "timeout";
+        result.wall_time = elapsed;
+      } else {
+        ++it;
+        continue;
+      }
+      close(it->fd);
+      ++num_done;
+      ROS_INFO_STREAM("[" << num_done << "/" << jobs.size() << "] "
+                          << result.planner << " on " << result.instance
+                          << ": " << result.status << " in "
+                          << result.wall_time << " s.");
+      it = workers.erase(it);
+    }
+  }
+}
+
+void writeResult(const RunResult& result, std::ostream& out) {
+  const std::ios::fmtflags flags = out.flags();
+  const std::streamsize precision = out.precision();
+  out << std::setprecision(17);
+  out << "planner " << result.planner << "\n";
+  out << "instance " << result.instance << "\n";
+  out << "status " << result.status << "\n";
+  out << "num_holes " << result.num_holes << "\n";
+  out << "num_hole_vertices " << result.num_hole_vertices << "\n";
+  out << "num_cells " << result.num_cells << "\n";
+  out << "num_nodes " << result.num_nodes << "\n";
+  out << "num_edges " << result.num_edges << "\n";
+  out << "cost " << result.cost << "\n";
+  out << "wall_time " << result.wall_time << "\n";
+  for (const std::pair<const std::string, TimerStatistics>& timer :
+       result.timers) {
+    const TimerStatistics& s = timer.second;
+    out << "timer " << timer.first << " " << s.num_samples << " " << s.total
+        << " " << s.mean << " " << s.min << " " << s.max << " " << s.variance
+        << " " << s.p50 << " " << s.p95 << " " << s.p99 << "\n";
+  }
+  for (const std::pair<const std::string, memory::Usage>& usage :
+       result.memory) {
+    out << "memory " << usage.first << " " << usage.second.bytes << " "
+        << usage.second.count << "\n";
+  }
+  for (const std::pair<const std::string, uint64_t>& counter :
+       result.counters) {
+    out << "counter " << counter.first << " " << counter.second << "\n";
+  }
+  out.flags(flags);
+  out.precision(precision);
+}
+
+bool readResult(std::istream& in, RunResult* result) {
+  ROS_ASSERT(result);
+  *result = RunResult();
+  std::string line;
+  while (std::getline(in, line)) {
+    std::stringstream ss(line);
+    std::string key;
+    ss >> key;
+    if (key == "planner") {
+      ss >> result->planner;
+    } else if (key == "instance") {
+      ss >> result->instance;
+    } else if (key == "status") {
+      ss >> result->status;
+    } else if (key == "num_holes") {
+      ss >> result->num_holes;
+    } else if (key == "num_hole_vertices") {
+      ss >> result->num_hole_vertices;
+    } else if (key == "num_cells") {
+      ss >> result->num_cells;
+    } else if (key == "num_nodes") {
+      ss >> result->num_nodes;
+    } else if (key == "num_edges") {
+      ss >> result->num_edges;
+    } else if (key == "cost") {
+      ss >> result->cost;
+    } else if (key == "wall_time") {
+      ss >> result->wall_time;
+    } else if (key == "timer") {
+      std::string tag;
+      TimerStatistics s;
+      ss >> tag >> s.num_samples >> s.total >> s.mean >> s.min >> s.max >>
+          s.variance >> s.p50 >> s.p95 >> s.p99;
+      result->timers[tag] = s;
+    } else if (key == "memory") {
+      std::string tag;
+      memory::Usage usage;
+      ss >> tag >> usage.bytes >> usage.count;
+      result->memory[tag] = usage;
+    } else if (key == "counter") {
+      std::string tag;
+      uint64_t value = 0;
+      ss >> tag >> value;
+      result->counters[tag] = value;
+    } else {
+      ROS_ERROR_STREAM("Unknown result key " << key);
+      return false;
+    }
+    if (ss.fail()) {
+      ROS_ERROR_STREAM("Invalid result line: " << line);
+      return false;
+    }
+  }
+  return !result->status.empty();
+}
+
+bool writeCsv(const std::string& file, const std::vector<RunResult>& results) {
+  std::ofstream out(file);
+  if (!out.is_open()) {
+    ROS_ERROR_STREAM("Cannot open " << file);
+    return false;
+  }
+  std::set<std::string> timer_tags, memory_tags, counter_tags;
+  for (const RunResult& result : results) {
+    for (const auto& timer : result.timers) timer_tags.insert(timer.first);
+    for (const auto& usage : result.memory) memory_tags.insert(usage.first);
+    for (const auto& counter : result.counters) {
+      counter_tags.insert(counter.first);
+    }
+  }
+
+  out << "planner,instance,status,num_holes,num_hole_vertices,num_cells,"
+         "num_nodes,num_edges,cost,wall_time";
+  for (const std::string& tag : timer_tags) {
+    out << "," << tag << "_num_samples," << tag << "_total," << tag
+        << "_mean," << tag << "_min," << tag << "_max," << tag << "_variance,"
+        << tag << "_p50," << tag << "_p95," << tag << "_p99";
+  }
+  for (const std::string& tag : memory_tags) {
+    out << "," << tag << "_bytes," << tag << "_count";
+  }
+  for (const std::string& tag : counter_tags) {
+    out << "," << tag;
+  }
+  out << "\n";
+
+  out << std::setprecision(10);
+  for (const RunResult& r : results) {
+    out << r.planner << "," << r.instance << "," << r.status << ","
+        << r.num_holes << "," << r.num_hole_vertices << "," << r.num_cells
+        << "," << r.num_nodes << "," << r.num_edges << "," << r.cost << ","
+        << r.wall_time;
+    for (const std::string& tag : timer_tags) {
+      const auto it = r.timers.find(tag);
+      if (it == r.timers.end()) {
+        out << ",,,,,,,,,";
+        continue;
+      }
+      const TimerStatistics& s = it->second;
+      out << "," << s.num_samples << "," << s.total << "," << s.mean << ","
+          << s.min << "," << s.max << "," << s.variance << "," << s.p50 << ","
+          << s.p95 << "," << s.p99;
+    }
+    for (const std::string& tag : memory_tags) {
+      const auto it = r.memory.find(tag);
+      if (it == r.memory.end()) {
+        out << ",,";
+        continue;
+      }
+      out << "," << it->second.bytes << "," << it->second.count;
+    }
+    for (const std::string& tag : counter_tags) {
+      const auto it = r.counters.find(tag);
+      out << ",";
+      if (it != r.counters.end()) out << it->second;
+    }
+    out << "\n";
+  }
+  return out.good();
+}
+
+bool writeJson(const std::string& file,
+               const std::vector<RunResult>& results) {
+  std::ofstream out(file);
+  if (!out.is_open()) {
+    ROS_ERROR_STREAM("Cannot open " << file);
+    return false;
+  }
+  out << std::setprecision(10) << "[";
+  for (size_t i = 0; i < results.size(); ++i) {
+    const RunResult& r = results[i];
+    out << (i == 0 ? "\n" : ",\n") << "{\"planner\":";
+    writeString(r.planner, out);
+    out << ",\"instance\":";
+    writeString(r.instance, out);
+    out << ",\"status\":";
+    writeString(r.status, out);
+    out << ",\"num_holes\":" << r.num_holes
+        << ",\"num_hole_vertices\":" << r.num_hole_vertices
+        << ",\"num_cells\":" << r.num_cells << ",\"num_nodes\":" << r.num_nodes
+        << ",\"num_edges\":" << r.num_edges << ",\"cost\":";
+    writeNumber(r.cost, out);
+    out << ",\"wall_time\":";
+    writeNumber(r.wall_time, out);
+    out << ",\"timers\":{";
+    for (auto it = r.timers.begin(); it != r.timers.end(); ++it) {
+      const TimerStatistics& s = it->second;
+      if (it != r.timers.begin()) out << ",";
+      writeString(it->first, out);
+      out << ":{\"num_samples\":" << s.num_samples << ",\"total\":";
+      writeNumber(s.total, out);
+      out << ",\"mean\":";
+      writeNumber(s.mean, out);
+      out << ",\"min\":";
+      writeNumber(s.min, out);
+      out << ",\"max\":";
+      writeNumber(s.max, out);
+      out << ",\"variance\":";
+      writeNumber(s.variance, out);
+      out << ",\"p50\":";
+      writeNumber(s.p50, out);
+      out << ",\"p95\":";
+      writeNumber(s.p95, out);
+      out << ",\"p99\":";
+      writeNumber(s.p99, out);
+      out << "}";
+    }
+    out << "},\"memory\":{";
+    for (auto it = r.memory.begin(); it != r.memory.end(); ++it) {
+      if (it != r.memory.begin()) out << ",";
+      writeString(it->first, out);
+      out << ":{\"bytes\":" << it->second.bytes
+          << ",\"count\":" << it->second.count << "}";
+    }
+    out << "},\"counters\":{";
+    for (auto it = r.counters.begin(); it != r.counters.end(); ++it) {
+      if (it != r.counters.begin()) out << ",";
+      writeString(it->first, out);
+      out << ":" << it->second;
+    }
+    out << "}}";
+  }
+  out << "\n]\n";
+  return out.good();
+}
+
+}  // namespace polygon_coverage_planning
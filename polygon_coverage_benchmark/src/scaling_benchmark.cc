@@ -0,0 +1,290 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Sweep one synthetic instance parameter at a time, run the planners on every
+// instance and fit how the time and memory of each planner stage grow:
+//   rosrun polygon_coverage_benchmark scaling_benchmark
+//       [--sweeps=num_holes,area] [--planners=our_bcd] [--seeds=3]
+//       [--jobs=0] [--timeout=600] [--num_solves=1]
+//       [--output=/tmp/coverage_scaling]
+// Writes the raw results to <output>.csv and <output>.json, the mean of every
+// stage metric per parameter value to <output>_scaling.csv and the fitted
+// exponent of metric ~ value^exponent to <output>_growth.csv.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <ros/console.h>
+
+#include "polygon_coverage_benchmark/instances.h"
+#include "polygon_coverage_benchmark/runner.h"
+
+using namespace polygon_coverage_planning;
+
+namespace {
+// A parameter of the synthetic instances and the values it takes. The other
+// parameters keep their base values.
+struct Sweep {
+  std::string name;
+  std::vector<double> values;
+  std::function<void(double, SyntheticSettings*)> set;
+};
+
+SyntheticSettings createBaseSettings() {
+  SyntheticSettings settings;
+  settings.num_holes = 4;
+  return settings;
+}
+
+const std::vector<Sweep>& getSweeps() {
+  static const std::vector<Sweep> kSweeps = {
+      {"num_holes",
+       {0, 1, 2, 4, 8, 16, 32, 64},
+       [](double v, SyntheticSettings* s) {
+         s->num_holes = static_cast<size_t>(v);
+       }},
+      {"num_hole_vertices",
+       {3, 4, 8, 16, 32},
+       [](double v, SyntheticSettings* s) {
+         s->num_hole_vertices = static_cast<size_t>(v);
+       }},
+      {"num_hull_vertices",
+       {4, 8, 16, 32, 64},
+       [](double v, SyntheticSettings* s) {
+         s->num_hull_vertices = static_cast<size_t>(v);
+       }},
+      {"area",
+       {1.0e3, 1.0e4, 1.0e5, 1.0e6},
+       [](double v, SyntheticSettings* s) { s->area = v; }},
+      {"aspect_ratio",
+       {1, 2, 4, 8, 16},
+       [](double v, SyntheticSettings* s) { s->aspect_ratio = v; }}};
+  return kSweeps;
+}
+
+struct Arguments {
+  std::vector<std::string> sweeps;
+  std::vector<std::string> planners = {"our_bcd", "our_tcd", "one_dir_gkma"};
+  size_t num_seeds = 3;
+  RunnerSettings runner_settings;
+  std::string output = "/tmp/coverage_scaling";
+};
+
+std::vector<std::string> split(const std::string& s) {
+  std::vector<std::string> tokens;
+  std::stringstream ss(s);
+  std::string token;
+  while (std::getline(ss, token, ',')) {
+    if (!token.empty()) tokens.push_back(token);
+  }
+  return tokens;
+}
+
+bool parseArguments(int argc, char** argv, Arguments* args) {
+  for (const Sweep& sweep : getSweeps()) {
+    args->sweeps.push_back(sweep.name);
+  }
+  args->runner_settings.num_jobs = 0;
+  args->runner_settings.timeout = 600.0;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const size_t equal = arg.find('=');
+    const std::string key = arg.substr(0, equal);
+    const std::string value =
+        equal == std::string::npos ? "" : arg.substr(equal + 1);
+    if (key == "--sweeps") {
+      args->sweeps = split(value);
+    } else if (key == "--planners") {
+      args->planners = split(value);
+    } else if (key == "--seeds") {
+      args->num_seeds = std::stoul(value);
+    } else if (key == "--jobs") {
+      args->runner_settings.num_jobs = std::stoul(value);
+    } else if (key == "--timeout") {
+      args->runner_settings.timeout = std::stod(value);
+    } else if (key == "--num_solves") {
+      args->runner_settings.num_solves = std::stoul(value);
+    } else if (key == "--output") {
+      args->output = value;
+    } else {
+      ROS_ERROR_STREAM("Unknown argument " << arg);
+      return false;
+    }
+  }
+  const std::vector<std::string>& planners = getBenchmarkPlanners();
+  for (const std::string& planner : args->planners) {
+    if (std::find(planners.begin(), planners.end(), planner) ==
+        planners.end()) {
+      ROS_ERROR_STREAM("Unknown planner " << planner);
+      return false;
+    }
+  }
+  return true;
+}
+
+// The time of every timer and the bytes of every memory stage of a result.
+std::map<std::string, double> getMetrics(const RunResult& result) {
+  std::map<std::string, double> metrics;
+  metrics["wall_time"] = result.wall_time;
+  metrics["num_nodes"] = result.num_nodes;
+  metrics["num_edges"] = result.num_edges;
+  for (const auto& timer : result.timers) {
+    metrics[timer.first + "_total"] = timer.second.total;
+  }
+  for (const auto& usage : result.memory) {
+    metrics[usage.first + "_bytes"] = usage.second.bytes;
+  }
+  return metrics;
+}
+
+// The least squares slope of log(y) over log(x). Ignores non-positive points.
+// Returns false with fewer than two points.
+bool fitExponent(const std::vector<std::pair<double, double>>& points,
+                 double* exponent) {
+  double n = 0.0, sx = 0.0, sy = 0.0, sxx = 0.0, sxy = 0.0;
+  for (const std::pair<double, double>& p : points) {
+    if (p.first <= 0.0 || p.second <= 0.0) continue;
+    const double x = std::log(p.first);
+    const double y = std::log(p.second);
+    n += 1.0;
+    sx += x;
+    sy += y;
+    sxx += x * x;
+    sxy += x * y;
+  }
+  const double denominator = n * sxx - sx * sx;
+  if (n < 2.0 || denominator <= 0.0) return false;
+  *exponent = (n * sxy - sx * sy) / denominator;
+  return true;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  Arguments args;
+  try {
+    if (!parseArguments(argc, argv, &args)) return EXIT_FAILURE;
+  } catch (const std::exception& e) {
+    ROS_ERROR_STREAM("Invalid argument: " << e.what());
+    return EXIT_FAILURE;
+  }
+
+  // Instances of all sweeps with the sweep and parameter value they belong to.
+  std::vector<Instance> instances;
+  std::vector<std::pair<std::string, double>> parameters;
+  for (const std::string& name : args.sweeps) {
+    const std::vector<Sweep>& sweeps = getSweeps();
+    std::vector<Sweep>::const_iterator sweep =
+        std::find_if(sweeps.begin(), sweeps.end(),
+                     [&name](const Sweep& s) { return s.name == name; });
+    if (sweep == sweeps.end()) {
+      ROS_ERROR_STREAM("Unknown sweep " << name);
+      return EXIT_FAILURE;
+    }
+    for (double value : sweep->values) {
+      for (size_t seed = 0; seed < args.num_seeds; ++seed) {
+        SyntheticSettings settings = createBaseSettings();
+        sweep->set(value, &settings);
+        settings.seed = seed;
+        Instance instance;
+        if (!createSyntheticInstance(settings, &instance)) {
+          return EXIT_FAILURE;
+        }
+        instances.push_back(instance);
+        parameters.emplace_back(name, value);
+      }
+    }
+  }
+
+  std::vector<Job> jobs;
+  for (size_t i = 0; i < instances.size(); ++i) {
+    for (const std::string& planner : args.planners) {
+      jobs.push_back(Job{planner, i});
+    }
+  }
+  ROS_INFO_STREAM("Running " << jobs.size() << " jobs on " << instances.size()
+                             << " instances.");
+  std::vector<RunResult> results;
+  runJobs(instances, jobs, args.runner_settings, &results);
+  if (!writeCsv(args.output + ".csv", results) ||
+      !writeJson(args.output + ".json", results)) {
+    return EXIT_FAILURE;
+  }
+
+  // Mean metric over the successful seeds.
+  // (sweep, planner, metric) -> value -> (sum, count)
+  typedef std::map<double, std::pair<double, size_t>> Series;
+  std::map<std::tuple<std::string, std::string, std::string>, Series> series;
+  for (size_t i = 0; i < jobs.size(); ++i) {
+    if (results[i].status != "ok") continue;
+    const std::pair<std::string, double>& parameter =
+        parameters[jobs[i].instance];
+    for (const std::pair<const std::string, double>& metric :
+         getMetrics(results[i])) {
+      std::pair<double, size_t>& mean =
+          series[std::make_tuple(parameter.first, jobs[i].planner,
+                                 metric.first)][parameter.second];
+      mean.first += metric.second;
+      ++mean.second;
+    }
+  }
+
+  std::ofstream scaling(args.output + "_scaling.csv");
+  std::ofstream growth(args.output + "_growth.csv");
+  if (!scaling.is_open() || !growth.is_open()) {
+    ROS_ERROR_STREAM("Cannot open " << args.output << "_*.csv");
+    return EXIT_FAILURE;
+  }
+  scaling << std::setprecision(10) << "sweep,planner,metric,value,mean\n";
+  growth << std::setprecision(4) << "sweep,planner,metric,exponent\n";
+  for (const auto& s : series) {
+    const std::string& sweep = std::get<0>(s.first);
+    const std::string& planner = std::get<1>(s.first);
+    const std::string& metric = std::get<2>(s.first);
+    std::vector<std::pair<double, double>> points;
+    for (const auto& value : s.second) {
+      const double mean = value.second.first / value.second.second;
+      scaling << sweep << "," << planner << "," << metric << ","
+              << value.first << "," << mean << "\n";
+      points.emplace_back(value.first, mean);
+    }
+    double exponent = 0.0;
+    if (!fitExponent(points, &exponent)) continue;
+    growth << sweep << "," << planner << "," << metric << "," << exponent
+           << "\n";
+    if (metric.size() > 6 &&
+        metric.compare(metric.size() - 6, 6, "_total") == 0) {
+      ROS_INFO_STREAM(planner << " " << metric << " ~ " << sweep << "^"
+                              << std::setprecision(3) << exponent);
+    }
+  }
+  ROS_INFO_STREAM("Saved results to " << args.output << "*.csv and "
+                                      << args.output << ".json");
+  return EXIT_SUCCESS;
+}
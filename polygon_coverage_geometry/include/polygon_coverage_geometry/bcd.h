@@ -20,6 +20,11 @@
 #ifndef POLYGON_COVERAGE_GEOMETRY_BCD_H_
 #define POLYGON_COVERAGE_GEOMETRY_BCD_H_
 
+#include <list>
+#include <memory_resource>
+#include <set>
+#include <vector>
+
 #include "polygon_coverage_geometry/cgal_definitions.h"
 
 // Choset, Howie. "Coverage of known spaces: The boustrophedon cellular
@@ -32,13 +37,17 @@ std::vector<Polygon_2> computeBCD(const PolygonWithHoles& polygon_in,
 void sortPolygon(PolygonWithHoles* pwh);
 std::vector<VertexConstCirculator> getXSortedVertices(
     const PolygonWithHoles& p);
+// The event structures of a decomposition are allocated from one arena.
+// intersections is scratch space reused between events.
 void processEvent(const PolygonWithHoles& pwh, const VertexConstCirculator& v,
                   std::vector<VertexConstCirculator>* sorted_vertices,
-                  std::vector<Point_2>* processed_vertices,
-                  std::list<Segment_2>* L, std::list<Polygon_2>* open_polygons,
-                  std::vector<Polygon_2>* closed_polygons);
-std::vector<Point_2> getIntersections(const std::list<Segment_2>& L,
-                                      const Line_2& l);
+                  std::pmr::set<Point_2>* processed_vertices,
+                  std::pmr::list<Segment_2>* L,
+                  std::pmr::list<Polygon_2>* open_polygons,
+                  std::vector<Polygon_2>* closed_polygons,
+                  std::vector<Point_2>* intersections);
+void getIntersections(const std::pmr::list<Segment_2>& L, const Line_2& l,
+                      std::vector<Point_2>* intersections);
 bool outOfPWH(const PolygonWithHoles& pwh, const Point_2& p);
 // Removes duplicate vertices. Returns if resulting polygon is simple and has
 // some area.
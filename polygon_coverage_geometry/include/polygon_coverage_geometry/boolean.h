@@ -25,7 +25,17 @@
 // Wrapper functions to form the union of a list of polygons.
 namespace polygon_coverage_planning {
 
-// Compute difference between hull and holes.
+// Add the holes to the hull without boolean operations. Requires simple rings,
+// holes inside the hull and no two rings touching or overlapping, checked with
+// a segment sweep. Orients the hull counter-clockwise and the holes clockwise.
+// Returns false if the holes need to be cut with boolean operations.
+bool addDisjointHoles(const Polygon_2& hull,
+                      const std::list<Polygon_2>::const_iterator& holes_begin,
+                      const std::list<Polygon_2>::const_iterator& holes_end,
+                      PolygonWithHoles* pwh);
+
+// Compute difference between hull and holes. Takes the addDisjointHoles fast
+// path for valid polygons with holes.
 std::list<PolygonWithHoles> computeDifference(
     const std::list<Polygon_2>::const_iterator& hull,
     const std::list<Polygon_2>::const_iterator& holes_begin,
@@ -33,6 +33,9 @@ inline bool pointInPolygon(const Polygon_2& poly, const Point_2& p) {
 bool pointsInPolygon(const PolygonWithHoles& pwh,
                      const std::vector<Point_2>::iterator& begin,
                      const std::vector<Point_2>::iterator& end);
+// Helper to check whether a segment is inside or on the boundary of the
+// polygon.
+bool segmentInPolygon(const PolygonWithHoles& pwh, const Segment_2& s);
 
 // Definition according to
 // https://doc.cgal.org/latest/Straight_skeleton_2/index.html
@@ -41,6 +44,8 @@ bool isStrictlySimple(const PolygonWithHoles& pwh);
 // Project a point on a polygon.
 Point_2 projectOnPolygon2(const Polygon_2& poly, const Point_2& p,
                           FT* squared_distance);
+// Project a point on a segment.
+Point_2 projectOnSegment2(const Segment_2& s, const Point_2& p);
 // Project a point on the polygon boundary.
 Point_2 projectPointOnHull(const PolygonWithHoles& pwh, const Point_2& p);
 
@@ -52,6 +57,18 @@ inline FT computeArea(const Polygon_2& poly) {
 // Remove collinear vertices.
 void simplifyPolygon(Polygon_2* polygon);
 void simplifyPolygon(PolygonWithHoles* pwh);
+// Remove the vertices of a valid polygon with holes, i.e., counter-clockwise
+// hull and clockwise holes, that lie within tolerance of the simplified
+// boundary, smallest deviation first. Only cuts off convex corners that contain
+// no other vertex. Thus the simplified polygon lies inside the original and its
+// rings stay simple and disjoint. Returns the number of removed vertices.
+size_t simplifyPolygonBoundary(PolygonWithHoles* pwh, double tolerance);
+// Snap all vertices to a grid. The resolution is rounded down to a power of
+// two such that the grid coordinates are exact doubles, e.g., 2^-10 m for a
+// millimeter grid. Removes repeated and collinear vertices and collapsed
+// holes. Returns false and leaves the polygon unchanged if the snapped rings
+// are not simple and disjoint.
+bool snapPolygonToGrid(PolygonWithHoles* pwh, double resolution);
 
 PolygonWithHoles rotatePolygon(const PolygonWithHoles& polygon_in,
                                const Direction_2& dir);
@@ -0,0 +1,95 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POLYGON_COVERAGE_GEOMETRY_COUNTERS_H_
+#define POLYGON_COVERAGE_GEOMETRY_COUNTERS_H_
+
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <string>
+
+namespace polygon_coverage_planning {
+namespace counters {
+
+// Geometric operations on the exact kernel.
+enum Counter {
+  kLinePolygonIntersections = 0,  // Line queries against a polygon.
+  kEdgeIntersections,             // Exact line-edge constructions.
+  kExactFallbacks,  // Inexact fast paths that had to be recomputed exactly.
+  kPointInPolygon,  // Point in polygon tests.
+  kVisibilityPolygons,    // Visibility polygon computations.
+  kShortestPathQueries,   // Visibility graph shortest path queries.
+  kShortestPathCacheHits,  // Queries answered from the path memo.
+  kWaypointCopies,  // Waypoint vectors copied on their way into the graph.
+  kNumCounters
+};
+
+typedef std::array<uint64_t, kNumCounters> Counts;
+
+// Optional counters of geometric operations, e.g., to compare algorithmic
+// improvements by the work they save. Counting is off by default; a counted
+// operation then costs a single atomic load. Stages attribute the operations
+// counted while they are open, including those of worker threads. Concurrent
+// stages see each other's operations. CGAL's own interval filter failures are
+// only counted by CGAL itself if it is compiled with CGAL_PROFILE.
+class Counters {
+ public:
+  // Start counting. Removes previous counts.
+  static void Start();
+  // Stop counting. Keeps the counts.
+  static void Stop();
+  static bool IsCounting();
+  static void Reset();
+
+  static void Increment(Counter counter, uint64_t n = 1);
+  static uint64_t Get(Counter counter);
+  static Counts GetCounts();
+  // The operations counted in each stage, summed over repeated stages.
+  static std::map<std::string, Counts> GetStages();
+  static const char* GetName(Counter counter);
+
+  static void Print(std::ostream& out);
+  static std::string Print();
+
+ private:
+  friend class Stage;
+  static void AddStage(const std::string& tag, const Counts& counts);
+};
+
+// Attributes the operations counted between construction and End or
+// destruction to a stage.
+//   counters::Stage stage("decomposition");
+class Stage {
+ public:
+  explicit Stage(const char* tag);
+  ~Stage();
+  void End();
+
+ private:
+  const char* tag_;
+  bool is_open_;
+  Counts start_;
+};
+
+}  // namespace counters
+}  // namespace polygon_coverage_planning
+
+#endif  // POLYGON_COVERAGE_GEOMETRY_COUNTERS_H_
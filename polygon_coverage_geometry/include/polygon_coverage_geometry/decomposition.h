@@ -35,23 +35,36 @@ std::vector<Direction_2> findPerpEdgeDirections(const PolygonWithHoles& pwh);
 // with the smallest polygon altitude. Returns the smallest altitude.
 double findBestSweepDir(const Polygon_2& cell, Direction_2* best_dir = nullptr);
 
-// Compute BCDs for every edge direction. Return any with the smallest possible
-// altitude sum.
+// Compute BCDs for every edge direction. Return the first with the smallest
+// possible altitude sum. The directions are evaluated on num_threads threads
+// (0: hardware concurrency), which requires thread-safe CGAL.
 bool computeBestBCDFromPolygonWithHoles(const PolygonWithHoles& pwh,
-                                        std::vector<Polygon_2>* bcd_polygons);
+                                        std::vector<Polygon_2>* bcd_polygons,
+                                        size_t num_threads = 1);
 
-// Compute TCDs for every edge direction. Return any with the smallest possible
-// altitude sum.
+// Compute TCDs for every edge direction. Return the first with the smallest
+// possible altitude sum. The directions are evaluated on num_threads threads
+// (0: hardware concurrency), which requires thread-safe CGAL.
 bool computeBestTCDFromPolygonWithHoles(const PolygonWithHoles& pwh,
-                                        std::vector<Polygon_2>* trap_polygons);
+                                        std::vector<Polygon_2>* trap_polygons,
+                                        size_t num_threads = 1);
+
+// Greedily merge the triangles of the constrained Delaunay triangulation into
+// cells. Every cell is weakly monotone perpendicular to one of its edges. A
+// single pass without a search over directions, so it is fast, but usually
+// yields more cells than the BCD.
+bool computeTMDFromPolygonWithHoles(const PolygonWithHoles& pwh,
+                                    std::vector<Polygon_2>* tmd_polygons);
 
 enum DecompositionType {
   kBCD = 0,  // Boustrophedon.
-  kTCD       // Trapezoidal.
+  kTCD,      // Trapezoidal.
+  kTMD       // Triangulation merge.
 };
 
 inline bool checkDecompositionTypeValid(const int type) {
-  return (type == DecompositionType::kBCD) || (type == DecompositionType::kTCD);
+  return (type == DecompositionType::kBCD) ||
+         (type == DecompositionType::kTCD) || (type == DecompositionType::kTMD);
 }
 
 inline std::string getDecompositionTypeName(const DecompositionType& type) {
@@ -60,11 +73,20 @@ inline std::string getDecompositionTypeName(const DecompositionType& type) {
       return "Boustrophedon Cell Decomposition";
     case DecompositionType::kTCD:
       return "Trapezoidal Cell Decomposition";
+    case DecompositionType::kTMD:
+      return "Triangulation Merge Decomposition";
     default:
       return "Unknown!";
   }
 }
 
+// Compute the decomposition of the given type. The BCD and TCD search their
+// directions on num_threads threads.
+bool computeDecomposition(const PolygonWithHoles& pwh,
+                          const DecompositionType& type,
+                          std::vector<Polygon_2>* polygons,
+                          size_t num_threads = 1);
+
 }  // namespace polygon_coverage_planning
 
 #endif  // POLYGON_COVERAGE_GEOMETRY_DECOMPOSITION_H_
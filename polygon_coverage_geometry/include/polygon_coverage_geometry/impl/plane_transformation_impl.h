@@ -21,6 +21,7 @@
 #define POLYGON_COVERAGE_GEOMETRY_PLANE_TRANSFORMATION_IMPL_H_
 
 #include <CGAL/number_utils.h>
+#include <ros/assert.h>
 #include <cmath>
 
 namespace polygon_coverage_planning {
@@ -50,6 +51,13 @@ PlaneTransformation<Kernel>::PlaneTransformation(const Plane_3& plane)
   const FT c = -plane.d() / (plane.a() * plane.a() + plane.b() * plane.b() +
                              plane.c() * plane.c());
   p_0_ = c * Vector_3(plane.a(), plane.b(), plane.c());
+
+  // Batch coefficients.
+  for (int i = 0; i < 3; ++i) {
+    origin_[i] = CGAL::to_double(p_0_[i]);
+    basis_1_[i] = CGAL::to_double(b_1_[i]);
+    basis_2_[i] = CGAL::to_double(b_2_[i]);
+  }
 }
 
 template <class Kernel>
@@ -120,6 +128,29 @@ PlaneTransformation<Kernel>::to3d(const std::vector<Point_2>& p_2) const {
   return p_3;
 }
 
+template <class Kernel>
+void PlaneTransformation<Kernel>::to3d(const double* p_2, size_t n,
+                                       double* p_3) const {
+  ROS_ASSERT(n == 0 || (p_2 && p_3));
+  // Independent iterations without branches. The compiler vectorizes them.
+  for (size_t i = 0; i < n; ++i) {
+    to3d(p_2[2 * i], p_2[2 * i + 1], p_3 + 3 * i);
+  }
+}
+
+template <class Kernel>
+void PlaneTransformation<Kernel>::to3d(const std::vector<Point_2>& p_2,
+                                       std::vector<double>* p_3) const {
+  ROS_ASSERT(p_3);
+  p_3->resize(3 * p_2.size());
+  // Convert and transform in a single pass.
+  double* it = p_3->data();
+  for (const Point_2& p : p_2) {
+    to3d(CGAL::to_double(p.x()), CGAL::to_double(p.y()), it);
+    it += 3;
+  }
+}
+
 template <class Kernel>
 typename Kernel::Point_3 PlaneTransformation<Kernel>::to3dOnPlane(
     const Point_2& p_2) const {
@@ -0,0 +1,83 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POLYGON_COVERAGE_GEOMETRY_SWEEP_IMPL_H_
+#define POLYGON_COVERAGE_GEOMETRY_SWEEP_IMPL_H_
+
+#include <algorithm>
+
+#include <CGAL/intersections.h>
+
+#include "polygon_coverage_geometry/counters.h"
+
+namespace polygon_coverage_planning {
+
+template <class Kernel>
+std::vector<typename Kernel::Point_2> sortVerticesToLine(
+    const CGAL::Polygon_2<Kernel>& p, const typename Kernel::Line_2& l) {
+  // Copy points.
+  std::vector<typename Kernel::Point_2> pts(p.vertices_begin(),
+                                            p.vertices_end());
+
+  // Sort.
+  std::sort(pts.begin(), pts.end(),
+            [&l](const typename Kernel::Point_2& a,
+                 const typename Kernel::Point_2& b) -> bool {
+              return CGAL::has_smaller_signed_distance_to_line(l, a, b);
+            });
+
+  return pts;
+}
+
+template <class Kernel>
+std::vector<typename Kernel::Point_2> findIntersections(
+    const CGAL::Polygon_2<Kernel>& p, const typename Kernel::Line_2& l) {
+  typedef typename Kernel::Point_2 Point;
+  typedef typename Kernel::Segment_2 Segment;
+  std::vector<Point> intersections;
+  counters::Counters::Increment(counters::kLinePolygonIntersections);
+  counters::Counters::Increment(counters::kEdgeIntersections, p.size());
+
+  for (typename CGAL::Polygon_2<Kernel>::Edge_const_iterator it =
+           p.edges_begin();
+       it != p.edges_end(); ++it) {
+    auto result = CGAL::intersection(*it, l);
+    if (result) {
+      if (const Segment* s = boost::get<Segment>(&*result)) {
+        intersections.push_back(s->source());
+        intersections.push_back(s->target());
+      } else {
+        intersections.push_back(*boost::get<Point>(&*result));
+      }
+    }
+  }
+
+  // Sort.
+  const typename Kernel::Line_2 perp_l = l.perpendicular(l.point(0));
+  std::sort(intersections.begin(), intersections.end(),
+            [&perp_l](const Point& a, const Point& b) -> bool {
+              return CGAL::has_smaller_signed_distance_to_line(perp_l, a, b);
+            });
+
+  return intersections;
+}
+
+}  // namespace polygon_coverage_planning
+
+#endif  // POLYGON_COVERAGE_GEOMETRY_SWEEP_IMPL_H_
@@ -20,6 +20,7 @@
 #ifndef POLYGON_COVERAGE_GEOMETRY_PLANE_TRANSFORMATION_H_
 #define POLYGON_COVERAGE_GEOMETRY_PLANE_TRANSFORMATION_H_
 
+#include <cstddef>
 #include <vector>
 
 namespace polygon_coverage_planning {
@@ -42,17 +43,32 @@ class PlaneTransformation {
   std::vector<Point_2> to2d(const std::vector<Point_3>& p_3) const;
   Point_3 to3d(const Point_2& p_2) const;
   std::vector<Point_3> to3d(const std::vector<Point_2>& p_2) const;
+  // Batch variants for long paths. p_2 holds n points as x, y pairs and p_3
+  // receives them as x, y, z triplets, e.g., the storage of an
+  // Eigen::Matrix3Xd. Uses the double coefficients of the transformation
+  // instead of kernel arithmetic.
+  void to3d(const double* p_2, size_t n, double* p_3) const;
+  void to3d(const std::vector<Point_2>& p_2, std::vector<double>* p_3) const;
   Point_3 to3dOnPlane(const Point_2& p_2) const;
   inline Plane_3 getPlane() const { return plane_; }
 
  private:
   enum ProjectionType { kXY, kYZ, kZX };
   Vector_3 normalize(const Vector_3& v) const;
+  inline void to3d(double x, double y, double* p_3) const {
+    p_3[0] = origin_[0] + x * basis_1_[0] + y * basis_2_[0];
+    p_3[1] = origin_[1] + x * basis_1_[1] + y * basis_2_[1];
+    p_3[2] = origin_[2] + x * basis_1_[2] + y * basis_2_[2];
+  }
   Vector_3 b_1_;
   Vector_3 b_2_;
   Vector_3 p_0_;
   Plane_3 plane_;
   ProjectionType projection_type_;
+  // p_0_, b_1_ and b_2_ in double precision.
+  double origin_[3];
+  double basis_1_[3];
+  double basis_2_[3];
   bool is_edge_case_;
 };
 }  // namespace polygon_coverage_planning
@@ -0,0 +1,48 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POLYGON_COVERAGE_GEOMETRY_POLYGON_FILE_H_
+#define POLYGON_COVERAGE_GEOMETRY_POLYGON_FILE_H_
+
+#include <string>
+
+#include "polygon_coverage_geometry/cgal_definitions.h"
+
+namespace polygon_coverage_planning {
+
+// A compact binary polygon with holes file for very large polygons. Layout in
+// native byte order, all fields 8 bytes:
+// magic | version | altitude | number of holes | hull | holes
+// Every ring is its number of vertices followed by x, y of each vertex as
+// double. Rings are stored without the closing vertex.
+
+// Write the polygon and its altitude. Coordinates are rounded to double.
+bool savePolygonFile(const std::string& file, const PolygonWithHoles& polygon,
+                     double altitude);
+
+// Map the file into memory and construct the polygon with holes directly. The
+// hull is oriented counter-clockwise and the holes clockwise. Unlike the
+// message conversion, holes are not cut from the hull, i.e., they must lie
+// strictly inside the hull and must not overlap.
+bool loadPolygonFile(const std::string& file, PolygonWithHoles* polygon,
+                     double* altitude);
+
+}  // namespace polygon_coverage_planning
+
+#endif  // POLYGON_COVERAGE_GEOMETRY_POLYGON_FILE_H_
@@ -0,0 +1,107 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POLYGON_COVERAGE_GEOMETRY_POLYGON_INDEX_H_
+#define POLYGON_COVERAGE_GEOMETRY_POLYGON_INDEX_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "polygon_coverage_geometry/cgal_definitions.h"
+
+namespace polygon_coverage_planning {
+
+// A uniform grid over the boundary edges of a polygon with holes. Built once
+// per polygon, it answers containment and boundary projection queries by
+// visiting the edges close to the query point instead of scanning all edges.
+// The results are exact and identical to pointInPolygon and
+// projectPointOnHull.
+// If all vertex coordinates are doubles, batches of points are classified with
+// a floating point crossing test on each grid row. Only points within the
+// rounding error of an edge fall back to the exact predicates.
+// If all vertices lie on a bounded dyadic grid, e.g., after
+// snapPolygonToGrid, containment of grid points is decided with exact 128 bit
+// integer predicates instead of the kernel.
+class PolygonIndex {
+ public:
+  explicit PolygonIndex(const PolygonWithHoles& pwh);
+
+  // Check whether a point is inside or on the boundary of the polygon.
+  bool containsPoint(const Point_2& p) const;
+  // Check whether all points are inside or on the boundary of the polygon.
+  // Optionally returns the containment of every point, otherwise stops at the
+  // first point outside.
+  bool containsPoints(const std::vector<Point_2>& points,
+                      std::vector<bool>* inside = nullptr) const;
+  // Project a point on the polygon boundary.
+  Point_2 projectOnHull(const Point_2& p) const;
+
+  inline size_t getNumberOfEdges() const { return edges_.size(); }
+  inline bool hasIntegerGrid() const { return has_integer_grid_; }
+
+ private:
+  // An edge in integer grid coordinates.
+  struct GridEdge {
+    int64_t source_x, source_y, target_x, target_y;
+  };
+  enum class Containment { kOutside, kInside, kUncertain };
+  // Copy the edges of every row into the row arrays.
+  void createRowEdges();
+  // Floating point crossing test on the edges of the row of (x, y).
+  Containment classifyPoint(double x, double y) const;
+
+  // Find the scale 2^grid_exponent_ that maps all vertices to integers.
+  void createIntegerGrid();
+  bool toGridCoordinate(const FT& v, int64_t* k) const;
+  bool containsGridPoint(const std::vector<size_t>& candidates, int64_t x,
+                         int64_t y) const;
+
+  size_t getColumn(double x) const;
+  size_t getRow(double y) const;
+  inline const std::vector<size_t>& getCell(size_t row, size_t col) const {
+    return cells_[row * num_cols_ + col];
+  }
+
+  // Outer boundary edges first, then the hole edges in order.
+  std::vector<Segment_2> edges_;
+  std::vector<CGAL::Bbox_2> edge_bboxes_;
+  CGAL::Bbox_2 bbox_;
+  size_t num_cols_;
+  size_t num_rows_;
+  double cell_width_;
+  double cell_height_;
+  // Row-major ids of the edges whose bounding box overlaps a cell.
+  std::vector<std::vector<size_t>> cells_;
+  // Double coordinates of the edges whose bounding box overlaps a row, row
+  // after row. Empty if a vertex coordinate is not a double.
+  bool has_row_edges_;
+  std::vector<size_t> row_offsets_;
+  std::vector<double> row_source_x_;
+  std::vector<double> row_source_y_;
+  std::vector<double> row_target_x_;
+  std::vector<double> row_target_y_;
+  // Integer grid coordinates of the edges. Empty without integer grid.
+  bool has_integer_grid_;
+  int grid_exponent_;
+  std::vector<GridEdge> grid_edges_;
+};
+
+}  // namespace polygon_coverage_planning
+
+#endif  // POLYGON_COVERAGE_GEOMETRY_POLYGON_INDEX_H_
@@ -0,0 +1,41 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POLYGON_COVERAGE_GEOMETRY_ROTATIONAL_SWEEP_H_
+#define POLYGON_COVERAGE_GEOMETRY_ROTATIONAL_SWEEP_H_
+
+#include <vector>
+
+#include "polygon_coverage_geometry/cgal_definitions.h"
+
+namespace polygon_coverage_planning {
+
+// Find all polygon vertices that are visible from the polygon vertex source
+// with a rotational plane sweep in O(n log n). D. T. Lee. Proximity and
+// reachability in the plane. PhD thesis, University of Illinois, 1978.
+// Vertices are indexed along the outer boundary first, then along the holes in
+// order. A vertex is visible if the segment to it lies inside or on the
+// boundary of the polygon. The polygon needs to be strictly simple with a
+// counter-clockwise outer boundary and clockwise holes.
+std::vector<bool> computeVisibleVertices(const PolygonWithHoles& pwh,
+                                         size_t source);
+
+}  // namespace polygon_coverage_planning
+
+#endif  // POLYGON_COVERAGE_GEOMETRY_ROTATIONAL_SWEEP_H_
@@ -0,0 +1,61 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POLYGON_COVERAGE_GEOMETRY_SHORTEST_PATH_CACHE_H_
+#define POLYGON_COVERAGE_GEOMETRY_SHORTEST_PATH_CACHE_H_
+
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "polygon_coverage_geometry/cgal_definitions.h"
+
+namespace polygon_coverage_planning {
+namespace visibility_graph {
+
+// A thread-safe memo of shortest paths between exact endpoint pairs in a
+// single polygon. Shortest paths are symmetric, i.e., the path from goal to
+// start is the reversed path from start to goal, so each pair is stored once.
+class ShortestPathCache {
+ public:
+  // Returns true and the path from start to goal if either direction has been
+  // stored before.
+  bool find(const Point_2& start, const Point_2& goal,
+            std::vector<Point_2>* path) const;
+  // Store the path from start to goal.
+  void insert(const Point_2& start, const Point_2& goal,
+              const std::vector<Point_2>& path);
+
+  size_t size() const;
+  void clear();
+
+ private:
+  // Key with the lexicographically smaller endpoint first. The path is stored
+  // from key.first to key.second.
+  typedef std::pair<Point_2, Point_2> Key;
+
+  mutable std::mutex mutex_;
+  std::map<Key, std::vector<Point_2>> paths_;
+};
+
+}  // namespace visibility_graph
+}  // namespace polygon_coverage_planning
+
+#endif  // POLYGON_COVERAGE_GEOMETRY_SHORTEST_PATH_CACHE_H_
@@ -31,10 +31,23 @@ bool computeSweep(const Polygon_2& in,
                   const FT offset, const Direction_2& dir,
                   bool counter_clockwise, std::vector<Point_2>* waypoints);
 
+// Compute the lanes of a sweep from the bottom to the top of the polygon. The
+// lanes do not depend on the sweep orientation.
+bool computeSweepLanes(const Polygon_2& in, const FT offset,
+                       const Direction_2& dir, std::vector<Segment_2>* lanes);
+
+// Connect the lanes in alternating direction using the visibility graph.
+bool connectSweepLanes(
+    const visibility_graph::VisibilityGraph& visibility_graph,
+    const std::vector<Segment_2>& lanes, bool counter_clockwise,
+    std::vector<Point_2>* waypoints);
+
 // Compute sweeps in all sweepable directions, starting counter-clockwise,
-// clockwise, and reverse.
+// clockwise, and reverse. The directions are processed on num_threads threads
+// (0: hardware concurrency).
 bool computeAllSweeps(const Polygon_2& poly, const double max_sweep_offset,
-                      std::vector<std::vector<Point_2>>* cluster_sweeps);
+                      std::vector<std::vector<Point_2>>* cluster_sweeps,
+                      size_t num_threads = 1);
 
 // A segment is observable if all vertices between two sweeps are observable.
 void checkObservability(
@@ -44,13 +57,57 @@ void checkObservability(
 
 // Find the intersections between a polygon and a line and sort them by the
 // distance to the perpendicular direction of the line.
+template <class Kernel>
+std::vector<typename Kernel::Point_2> findIntersections(
+    const CGAL::Polygon_2<Kernel>& p, const typename Kernel::Line_2& l);
 std::vector<Point_2> findIntersections(const Polygon_2& p, const Line_2& l);
 
 // Same as findIntersections but only return first and last intersection.
+// Locates the two intersected edges with inexact arithmetic first and only
+// constructs their intersections exactly. Falls back to findIntersections if
+// the inexact order is not certain, e.g., if the line passes near a vertex.
 bool findSweepSegment(const Polygon_2& p, const Line_2& l,
                       Segment_2* sweep_segment);
 
+// Finds the sweep segments of parallel lines with non-decreasing offset along
+// the line normal, e.g., the lanes of a sweep. The edges are sorted once by
+// their extent along the normal and only the edges spanning the current line
+// are intersected. Queries may step back behind the previous line by up to one
+// line. Stepping back further restarts the sweep.
+class SweepLineIntersector {
+ public:
+  SweepLineIntersector(const Polygon_2& p, const Direction_2& dir);
+
+  // Same result as findSweepSegment(p, l) for a line l parallel to dir.
+  bool findSweepSegment(const Line_2& l, Segment_2* sweep_segment);
+
+ private:
+  // Offset of a point along the line normal.
+  inline FT computeOffset(const Point_2& p) const {
+    return normal_ * (p - CGAL::ORIGIN);
+  }
+
+  const Polygon_2 polygon_;
+  const Vector_2 normal_;
+  std::vector<FT> min_offsets_;
+  std::vector<FT> max_offsets_;
+  // Edge indices sorted by their minimum offset.
+  std::vector<size_t> sorted_edges_;
+
+  size_t next_edge_;
+  // Edges that have started and not ended before floor_offset_.
+  std::vector<size_t> active_edges_;
+  bool has_query_;
+  FT last_offset_;
+  FT floor_offset_;
+  // Scratch space reused between the lines of a sweep.
+  std::vector<Point_2> intersections_;
+};
+
 // Sort vertices of polygon based on signed distance to line l.
+template <class Kernel>
+std::vector<typename Kernel::Point_2> sortVerticesToLine(
+    const CGAL::Polygon_2<Kernel>& p, const typename Kernel::Line_2& l);
 std::vector<Point_2> sortVerticesToLine(const Polygon_2& p, const Line_2& l);
 
 // Connect to points in the polygon using the visibility graph.
@@ -61,4 +118,6 @@ bool calculateShortestPath(
 
 }  // namespace polygon_coverage_planning
 
+#include "polygon_coverage_geometry/impl/sweep_impl.h"
+
 #endif  // POLYGON_COVERAGE_GEOMETRY_SWEEP_H_
@@ -20,6 +20,10 @@
 #ifndef POLYGON_COVERAGE_GEOMETRY_TRIANGULATION_H_
 #define POLYGON_COVERAGE_GEOMETRY_TRIANGULATION_H_
 
+#include <array>
+#include <mutex>
+#include <vector>
+
 #include <CGAL/Constrained_Delaunay_triangulation_2.h>
 #include <CGAL/Triangulation_face_base_with_info_2.h>
 #include "polygon_coverage_geometry/cgal_definitions.h"
@@ -30,9 +34,10 @@
 namespace polygon_coverage_planning {
 
 struct FaceInfo2 {
-  FaceInfo2() {}
+  FaceInfo2() : nesting_level(-1), id(0) {}
   int nesting_level;
   bool in_domain() { return nesting_level % 2 == 1; }
+  size_t id;  // Index among the faces in the domain.
 };
 
 typedef CGAL::Triangulation_vertex_base_2<K> Vb;
@@ -50,6 +55,34 @@ void mark_domains(CDT& cdt);
 void triangulatePolygon(const PolygonWithHoles& pwh,
                         std::vector<std::vector<Point_2>>* faces);
 
+// Shortest paths in a polygon with holes without visibility polygons. A* over
+// the adjacent triangles of the constrained Delaunay triangulation finds a
+// channel from start to goal. The funnel algorithm pulls the path taut inside
+// the channel. Lee, D. T., and Preparata, F. P. Euclidean shortest paths in the
+// presence of rectilinear barriers. Networks 14.3 (1984): 393-410.
+// Without holes the path is the Euclidean shortest path. With holes it is the
+// shortest path through the channel, which may pass a hole on the longer side.
+class TriangulationShortestPath {
+ public:
+  explicit TriangulationShortestPath(const PolygonWithHoles& pwh);
+
+  // Start and goal need to be inside or on the boundary of the polygon.
+  bool solve(const Point_2& start, const Point_2& goal,
+             std::vector<Point_2>* waypoints) const;
+
+  inline size_t getNumberOfFaces() const { return faces_.size(); }
+
+ private:
+  // Find a face in the domain containing p.
+  bool locateFace(const Point_2& p, size_t* face_id) const;
+
+  CDT cdt_;
+  std::vector<CDT::Face_handle> faces_;  // The faces in the domain.
+  std::vector<std::array<double, 2>> centroids_;
+  // The point location walk of the triangulation is not thread-safe.
+  mutable std::mutex mutex_;
+};
+
 }  // namespace polygon_coverage_planning
 
 #endif  // POLYGON_COVERAGE_GEOMETRY_TRIANGULATION_H_
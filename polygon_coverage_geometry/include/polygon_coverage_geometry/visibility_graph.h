@@ -21,34 +21,62 @@
 #define POLYGON_COVERAGE_GEOMETRY_VISIBILITY_GRAPH_H_
 
 #include <map>
+#include <memory>
+#include <vector>
 
 #include <polygon_coverage_solvers/graph_base.h>
 
 #include "polygon_coverage_geometry/cgal_definitions.h"
+#include "polygon_coverage_geometry/polygon_index.h"
+#include "polygon_coverage_geometry/shortest_path_cache.h"
+#include "polygon_coverage_geometry/visibility_polygon_cache.h"
 
 namespace polygon_coverage_planning {
 namespace visibility_graph {
 
 struct NodeProperty {
-  NodeProperty() : coordinates(Point_2(CGAL::ORIGIN)) {}
+  NodeProperty() : coordinates(Point_2(CGAL::ORIGIN)), x(0.0), y(0.0) {}
   NodeProperty(const Point_2& coordinates, const Polygon_2& visibility)
-      : coordinates(coordinates), visibility(visibility) {}
+      : coordinates(coordinates),
+        visibility(visibility),
+        x(CGAL::to_double(coordinates.x())),
+        y(CGAL::to_double(coordinates.y())) {}
   Point_2 coordinates;   // The 2D coordinates.
-  Polygon_2 visibility;  // The visibile polygon from the vertex.
+  Polygon_2 visibility;  // The visibile polygon from a start or goal vertex.
+  double x, y;           // The coordinates for the search heuristic.
 };
 
 struct EdgeProperty {};
 
 // Shortest path calculation in the reduced visibility graph.
 // https://www.david-gouveia.com/pathfinding-on-a-2d-polygonal-map
+// Thread safety: After construction all const member functions may be called
+// concurrently on one shared instance. Queries only read the graph. Their
+// search buffers live in thread-local workspaces and the shared caches are
+// synchronized. Non-const functions need exclusive access.
 class VisibilityGraph : public GraphBase<NodeProperty, EdgeProperty> {
  public:
-  // Creates an undirected, weighted visibility graph.
-  VisibilityGraph(const PolygonWithHoles& polygon);
-  VisibilityGraph(const Polygon_2& polygon)
-      : VisibilityGraph(PolygonWithHoles(polygon)) {}
-
-  VisibilityGraph() : GraphBase() {}
+  // Creates an undirected, weighted visibility graph. The rotational plane
+  // sweeps from the graph vertices run on num_threads threads (0: hardware
+  // concurrency). With bitangent_only the graph vertices are only connected
+  // if the edge is tangent to the boundary at both ends. Shortest paths only
+  // use such edges, so paths are equally short with far fewer edges.
+  VisibilityGraph(const PolygonWithHoles& polygon, size_t num_threads = 1,
+                  bool bitangent_only = false);
+  VisibilityGraph(const Polygon_2& polygon, size_t num_threads = 1,
+                  bool bitangent_only = false)
+      : VisibilityGraph(PolygonWithHoles(polygon), num_threads,
+                        bitangent_only) {}
+
+  VisibilityGraph()
+      : GraphBase(),
+        num_threads_(1),
+        bitangent_only_(false),
+        defer_edges_(false),
+        shortest_path_cache_(std::make_shared<ShortestPathCache>()),
+        visibility_polygon_cache_(
+            std::make_shared<VisibilityPolygonCache>(polygon_)),
+        polygon_index_(std::make_shared<PolygonIndex>(polygon_)) {}
 
   virtual bool create() override;
 
@@ -60,19 +88,78 @@ class VisibilityGraph : public GraphBase<NodeProperty, EdgeProperty> {
              std::vector<Point_2>* waypoints) const;
   // Same as solve but provide a precomputed visibility graph for the polygon.
   // Note: Start and goal need to be contained in the polygon_.
+  // Shortest paths are memoized per endpoint pair and shared between copies of
+  // this graph.
   bool solve(const Point_2& start, const Polygon_2& start_visibility_polygon,
              const Point_2& goal, const Polygon_2& goal_visibility_polygon,
              std::vector<Point_2>* waypoints) const;
+  // Compute the shortest paths from one start to many goals with a single
+  // Dijkstra search over the graph vertices. Visibility polygons may be
+  // nullptr and are then looked up in the visibility polygon cache. Goals
+  // that cannot be reached get an empty path and infinite cost. Shortest
+  // paths are memoized like in solve.
+  // Note: Start and goals need to be contained in the polygon_.
+  bool solveOneToMany(
+      const Point_2& start, const Polygon_2* start_visibility_polygon,
+      const std::vector<Point_2>& goals,
+      const std::vector<const Polygon_2*>& goal_visibility_polygons,
+      std::vector<std::vector<Point_2>>* waypoints,
+      std::vector<double>* costs = nullptr) const;
+
+  // Optionally precompute the shortest paths between all graph vertices on
+  // num_threads threads. Afterwards queries connect start and goal to their
+  // best pair of visible vertices by table lookup instead of a graph search.
+  // The table is shared between copies of this graph and dropped by create().
+  bool createShortestPathTable();
+  inline bool hasShortestPathTable() const {
+    return shortest_path_table_ != nullptr;
+  }
+  // Estimated bytes of the graph, the visibility polygons of its nodes and the
+  // shortest path table. Excludes the caches.
+  size_t getMemoryBytes() const;
 
   // Convenience function: addtionally adds original start and goal to shortest
   // path, if they were outside of polygon.
   bool solveWithOutsideStartAndGoal(const Point_2& start, const Point_2& goal,
                                     std::vector<Point_2>* waypoints) const;
+  // Look up a shortest path between start and goal that has been solved
+  // before in either direction.
+  inline bool findCachedPath(const Point_2& start, const Point_2& goal,
+                             std::vector<Point_2>* waypoints) const {
+    return shortest_path_cache_->find(start, goal, waypoints);
+  }
+  inline size_t getNumberOfCachedPaths() const {
+    return shortest_path_cache_->size();
+  }
+  inline void clearCachedPaths() { shortest_path_cache_->clear(); }
   // Given a solution, get the concatenated 2D waypoints.
   bool getWaypoints(const Solution& solution,
                     std::vector<Point_2>* waypoints) const;
 
-  inline PolygonWithHoles getPolygon() const { return polygon_; }
+  inline const PolygonWithHoles& getPolygon() const { return polygon_; }
+  // Containment and boundary projection in the polygon through its edge
+  // index. Same results as pointInPolygon and projectPointOnHull.
+  inline bool containsPoint(const Point_2& p) const {
+    return polygon_index_->containsPoint(p);
+  }
+  inline Point_2 projectOnHull(const Point_2& p) const {
+    return polygon_index_->projectOnHull(p);
+  }
+
+  // Compute the visibility polygon of a point inside the polygon. Results are
+  // kept in a bounded cache that is shared between copies of this graph.
+  inline bool computeVisibility(const Point_2& query_point,
+                                Polygon_2* visibility_polygon) const {
+    return visibility_polygon_cache_->compute(query_point, visibility_polygon);
+  }
+  // Compute the visibility polygons of many points inside the polygon on
+  // num_threads threads (0: hardware concurrency).
+  inline bool computeVisibility(
+      const std::vector<Point_2>& query_points, size_t num_threads,
+      std::vector<Polygon_2>* visibility_polygons) const {
+    return visibility_polygon_cache_->compute(query_points, num_threads,
+                                              visibility_polygons);
+  }
 
  private:
   // Adds all line of sight neighbors.
@@ -80,9 +167,28 @@ class VisibilityGraph : public GraphBase<NodeProperty, EdgeProperty> {
   // matrix.
   virtual bool addEdges() override;
 
-  // Calculate the Euclidean distance to goal for all given nodes.
-  virtual bool calculateHeuristic(size_t goal,
-                                  Heuristic* heuristic) const override;
+  // Solve a query that is not in the shortest path cache.
+  bool solveUncached(const Point_2& start,
+                     const Polygon_2& start_visibility_polygon,
+                     const Point_2& goal,
+                     const Polygon_2& goal_visibility_polygon,
+                     std::vector<Point_2>* waypoints) const;
+
+  // Find the graph vertices inside the visibility polygon of p and their
+  // distance to p.
+  bool findVisibleNodes(const Point_2& p, const Polygon_2& visibility_polygon,
+                        std::vector<std::pair<size_t, double>>* nodes) const;
+
+  // Solve a query with the all-pairs shortest path table.
+  bool solveWithTable(const Point_2& start,
+                      const Polygon_2& start_visibility_polygon,
+                      const Point_2& goal,
+                      const Polygon_2& goal_visibility_polygon,
+                      std::vector<Point_2>* waypoints) const;
+
+  // The Euclidean distance to goal.
+  virtual bool createHeuristic(size_t goal,
+                               Heuristic* heuristic) const override;
 
   // Find and append concave outer boundary vertices.
   void findConcaveOuterBoundaryVertices(
@@ -96,6 +202,26 @@ class VisibilityGraph : public GraphBase<NodeProperty, EdgeProperty> {
                                      const Point_2& to) const;
 
   PolygonWithHoles polygon_;
+  size_t num_threads_;
+  bool bitangent_only_;
+  // Skip addEdges while create() adds the graph vertices.
+  bool defer_edges_;
+  // Thread-safe memo of solved queries.
+  std::shared_ptr<ShortestPathCache> shortest_path_cache_;
+  // Thread-safe LRU cache of visibility polygons in polygon_.
+  std::shared_ptr<VisibilityPolygonCache> visibility_polygon_cache_;
+  // Edge index of polygon_.
+  std::shared_ptr<const PolygonIndex> polygon_index_;
+
+  // All-pairs shortest paths between the graph vertices. Row-major matrices
+  // indexed by (from, to).
+  struct ShortestPathTable {
+    size_t num_nodes;
+    std::vector<double> costs;
+    // The node following from on the shortest path to to.
+    std::vector<size_t> next_hops;
+  };
+  std::shared_ptr<const ShortestPathTable> shortest_path_table_;
 };
 
 }  // namespace visibility_graph
@@ -20,14 +20,57 @@
 #ifndef POLYGON_COVERAGE_GEOMETRY_VISIBILITY_POLYGON_H_
 #define POLYGON_COVERAGE_GEOMETRY_VISIBILITY_POLYGON_H_
 
+#include <memory>
+#include <mutex>
+
+#include <CGAL/Arr_landmarks_point_location.h>
+#include <CGAL/Arr_segment_traits_2.h>
+#include <CGAL/Arrangement_2.h>
+#include <CGAL/Triangular_expansion_visibility_2.h>
+
 #include "polygon_coverage_geometry/cgal_definitions.h"
 
 namespace polygon_coverage_planning {
 
+// Answers repeated visibility polygon queries in a single strictly simple
+// polygon with holes. The arrangement, its triangulation and the landmark
+// point location are built once on construction. Queries are serialized,
+// because the triangular expansion keeps internal scratch state.
+class VisibilityOracle {
+ public:
+  VisibilityOracle(const PolygonWithHoles& pwh);
+  // The visibility structures point into the arrangement.
+  VisibilityOracle(const VisibilityOracle&) = delete;
+  VisibilityOracle& operator=(const VisibilityOracle&) = delete;
+
+  // Compute the visibility polygon of a query point inside the polygon.
+  bool compute(const Point_2& query_point, Polygon_2* visibility_polygon) const;
+
+  inline const PolygonWithHoles& getPolygon() const { return polygon_; }
+
+ private:
+  typedef CGAL::Arr_segment_traits_2<K> Traits;
+  typedef CGAL::Arrangement_2<Traits> Arrangement;
+  typedef CGAL::Triangular_expansion_visibility_2<Arrangement, CGAL::Tag_true>
+      TEV;
+  typedef CGAL::Arr_landmarks_point_location<Arrangement> PointLocation;
+
+  const PolygonWithHoles polygon_;
+  Arrangement arrangement_;
+  // The bounded face between outer boundary and holes.
+  Arrangement::Face_const_handle main_face_;
+  std::unique_ptr<TEV> tev_;
+  std::unique_ptr<PointLocation> point_location_;
+
+  mutable std::mutex mutex_;
+};
+
 // Compute the visibility polygon given a point inside a strictly simple
 // polygon. Francisc Bungiu, Michael Hemmer, John Hershberger, Kan Huang, and
 // Alexander Kröller. Efficient computation of visibility polygons. CoRR,
 // abs/1403.3905, 2014.
+// Builds a one-off VisibilityOracle. Use an oracle for repeated queries.
+// Thread-safe, it shares no state between calls.
 bool computeVisibilityPolygon(const PolygonWithHoles& pwh,
                               const Point_2& query_point,
                               Polygon_2* visibility_polygon);
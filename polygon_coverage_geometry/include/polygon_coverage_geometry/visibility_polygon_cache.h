@@ -0,0 +1,80 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POLYGON_COVERAGE_GEOMETRY_VISIBILITY_POLYGON_CACHE_H_
+#define POLYGON_COVERAGE_GEOMETRY_VISIBILITY_POLYGON_CACHE_H_
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "polygon_coverage_geometry/cgal_definitions.h"
+#include "polygon_coverage_geometry/visibility_polygon.h"
+
+namespace polygon_coverage_planning {
+
+// A bounded, thread-safe least recently used cache of the visibility polygons
+// of a single polygon with holes, keyed by exact query point. Visibility
+// polygons are computed on a miss by a VisibilityOracle. Concurrent misses
+// each use their own oracle from a pool that grows to the number of concurrent
+// callers.
+class VisibilityPolygonCache {
+ public:
+  static constexpr size_t kDefaultCapacity = 4096;
+
+  VisibilityPolygonCache(const PolygonWithHoles& polygon,
+                         size_t capacity = kDefaultCapacity)
+      : polygon_(polygon), capacity_(capacity) {}
+
+  // Return the cached visibility polygon of the query point or compute it.
+  bool compute(const Point_2& query_point, Polygon_2* visibility_polygon);
+  // Compute the visibility polygons of all query points on num_threads threads
+  // (0: hardware concurrency).
+  bool compute(const std::vector<Point_2>& query_points, size_t num_threads,
+               std::vector<Polygon_2>* visibility_polygons);
+
+  size_t size() const;
+  inline size_t capacity() const { return capacity_; }
+  inline const PolygonWithHoles& getPolygon() const { return polygon_; }
+  void clear();
+
+ private:
+  typedef std::list<std::pair<Point_2, Polygon_2>> Entries;
+
+  // Take an idle oracle or build a new one.
+  std::unique_ptr<VisibilityOracle> acquireOracle();
+  void releaseOracle(std::unique_ptr<VisibilityOracle> oracle);
+
+  const PolygonWithHoles polygon_;
+  const size_t capacity_;
+
+  mutable std::mutex mutex_;
+  // Entries ordered from most to least recently used.
+  Entries entries_;
+  std::map<Point_2, Entries::iterator> index_;
+  // Oracles that are not answering a query. They survive clear().
+  std::vector<std::unique_ptr<VisibilityOracle>> idle_oracles_;
+};
+
+}  // namespace polygon_coverage_planning
+
+#endif  // POLYGON_COVERAGE_GEOMETRY_VISIBILITY_POLYGON_CACHE_H_
@@ -17,6 +17,10 @@
  * this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+#include <set>
 #include <vector>
 
 #include <ros/assert.h>
@@ -26,6 +30,9 @@
 #include "polygon_coverage_geometry/cgal_comm.h"
 
 namespace polygon_coverage_planning {
+namespace {
+const size_t kArenaBufferSize = 16384;
+}  // namespace
 
 std::vector<Polygon_2> computeBCD(const PolygonWithHoles& polygon_in,
                                   const Direction_2& dir) {
@@ -39,19 +46,22 @@ std::vector<Polygon_2> computeBCD(const PolygonWithHoles& polygon_in,
   std::vector<VertexConstCirculator> sorted_vertices =
       getXSortedVertices(rotated_polygon);
 
-  // Initialize edge list.
-  std::list<Segment_2> L;
-  std::list<Polygon_2> open_polygons;
+  // Initialize edge list. The list and set nodes live until the end of the
+  // decomposition and are released at once. Small polygons fit into the stack
+  // buffer.
+  std::array<std::byte, kArenaBufferSize> buffer;
+  std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+  std::pmr::list<Segment_2> L(&arena);
+  std::pmr::list<Polygon_2> open_polygons(&arena);
   std::vector<Polygon_2> closed_polygons;
-  std::vector<Point_2> processed_vertices;
+  std::pmr::set<Point_2> processed_vertices(&arena);
+  std::vector<Point_2> intersections;
   for (size_t i = 0; i < sorted_vertices.size(); ++i) {
     const VertexConstCirculator& v = sorted_vertices[i];
     // v already processed.
-    if (std::find(processed_vertices.begin(), processed_vertices.end(), *v) !=
-        processed_vertices.end())
-      continue;
+    if (processed_vertices.count(*v) > 0) continue;
     processEvent(rotated_polygon, v, &sorted_vertices, &processed_vertices, &L,
-                 &open_polygons, &closed_polygons);
+                 &open_polygons, &closed_polygons, &intersections);
   }
 
   // Rotate back all polygons.
@@ -93,20 +103,24 @@ std::vector<VertexConstCirculator> getXSortedVertices(
 
 void processEvent(const PolygonWithHoles& pwh, const VertexConstCirculator& v,
                   std::vector<VertexConstCirculator>* sorted_vertices,
-                  std::vector<Point_2>* processed_vertices,
-                  std::list<Segment_2>* L, std::list<Polygon_2>* open_polygons,
-                  std::vector<Polygon_2>* closed_polygons) {
+                  std::pmr::set<Point_2>* processed_vertices,
+                  std::pmr::list<Segment_2>* L,
+                  std::pmr::list<Polygon_2>* open_polygons,
+                  std::vector<Polygon_2>* closed_polygons,
+                  std::vector<Point_2>* intersections_buffer) {
   ROS_ASSERT(sorted_vertices);
   ROS_ASSERT(processed_vertices);
   ROS_ASSERT(L);
   ROS_ASSERT(open_polygons);
   ROS_ASSERT(closed_polygons);
+  ROS_ASSERT(intersections_buffer);
+  std::vector<Point_2>& intersections = *intersections_buffer;
 
   Polygon_2::Traits::Equal_2 eq_2;
 
-  // Compute intersection.
+  // The intersections with the edge list are only needed when cells are
+  // split or merged. Regular vertices only update one edge.
   Line_2 l(*v, Direction_2(0, 1));
-  std::vector<Point_2> intersections = getIntersections(*L, l);
 
   // Get e_lower and e_upper.
   Segment_2 e_prev(*v, *std::prev(v));
@@ -138,7 +152,7 @@ void processEvent(const PolygonWithHoles& pwh, const VertexConstCirculator& v,
     bool close_one = outOfPWH(pwh, *v + Vector_2(1e-6, 0));
 
     // Find edges to remove.
-    std::list<Segment_2>::iterator e_lower_it = L->begin();
+    std::pmr::list<Segment_2>::iterator e_lower_it = L->begin();
     size_t e_lower_id = 0;
     for (; e_lower_it != L->end(); ++e_lower_it) {
       if (*e_lower_it == e_lower || *e_lower_it == e_lower.opposite()) {
@@ -147,13 +161,13 @@ void processEvent(const PolygonWithHoles& pwh, const VertexConstCirculator& v,
       e_lower_id++;
     }
 
-    std::list<Segment_2>::iterator e_upper_it = std::next(e_lower_it);
+    std::pmr::list<Segment_2>::iterator e_upper_it = std::next(e_lower_it);
     size_t e_upper_id = e_lower_id + 1;
     size_t lower_cell_id = e_lower_id / 2;
     size_t upper_cell_id = e_upper_id / 2;
 
     if (close_one) {
-      std::list<Polygon_2>::iterator cell =
+      std::pmr::list<Polygon_2>::iterator cell =
           std::next(open_polygons->begin(), lower_cell_id);
       cell->push_back(e_lower.source());
       Polygon_2::Traits::Equal_2 eq_2;
@@ -166,16 +180,17 @@ void processEvent(const PolygonWithHoles& pwh, const VertexConstCirculator& v,
       open_polygons->erase(cell);
     } else {
       // Close two cells, open one.
+      getIntersections(*L, l, &intersections);
       // Close lower cell.
       ROS_ASSERT(e_lower_id > 0);
       ROS_ASSERT(intersections.size() > e_upper_id + 1);
-      std::list<Polygon_2>::iterator lower_cell =
+      std::pmr::list<Polygon_2>::iterator lower_cell =
           std::next(open_polygons->begin(), lower_cell_id);
       lower_cell->push_back(intersections[e_lower_id - 1]);
       lower_cell->push_back(intersections[e_lower_id]);
       if (cleanupPolygon(&*lower_cell)) closed_polygons->push_back(*lower_cell);
       // Close upper cell.
-      std::list<Polygon_2>::iterator upper_cell =
+      std::pmr::list<Polygon_2>::iterator upper_cell =
           std::next(open_polygons->begin(), upper_cell_id);
       upper_cell->push_back(intersections[e_upper_id]);
       upper_cell->push_back(intersections[e_upper_id + 1]);
@@ -186,7 +201,7 @@ void processEvent(const PolygonWithHoles& pwh, const VertexConstCirculator& v,
       L->erase(e_upper_it);
 
       // Open one new cell.
-      std::list<Polygon_2>::iterator new_polygon =
+      std::pmr::list<Polygon_2>::iterator new_polygon =
           open_polygons->insert(lower_cell, Polygon_2());
       new_polygon->push_back(intersections[e_upper_id + 1]);
       new_polygon->push_back(intersections[e_lower_id - 1]);
@@ -194,9 +209,9 @@ void processEvent(const PolygonWithHoles& pwh, const VertexConstCirculator& v,
       open_polygons->erase(lower_cell);
       open_polygons->erase(upper_cell);
     }
-    processed_vertices->push_back(e_lower.source());
+    processed_vertices->insert(e_lower.source());
     if (!eq_2(e_lower.source(), e_upper.source())) {
-      processed_vertices->push_back(e_upper.source());
+      processed_vertices->insert(e_upper.source());
     }
   } else if (!less_x_2(e_lower.target(), e_lower.source()) &&
              !less_x_2(e_upper.target(), e_upper.source())) {
@@ -210,6 +225,7 @@ void processEvent(const PolygonWithHoles& pwh, const VertexConstCirculator& v,
 
     // Determine whether we open one or close one and open two.
     bool open_one = outOfPWH(pwh, *v - Vector_2(1e-6, 0));
+    getIntersections(*L, l, &intersections);
 
     // Find edge to update.
     size_t e_LOWER_id = 0;
@@ -231,8 +247,8 @@ void processEvent(const PolygonWithHoles& pwh, const VertexConstCirculator& v,
     }
     if (open_one) {
       // Add one new cell above e_UPPER.
-      std::list<Segment_2>::iterator e_UPPER = L->begin();
-      std::list<Polygon_2>::iterator open_cell = open_polygons->begin();
+      std::pmr::list<Segment_2>::iterator e_UPPER = L->begin();
+      std::pmr::list<Polygon_2>::iterator open_cell = open_polygons->begin();
       if (!L->empty() && found_e_lower_id) {
         e_UPPER = std::next(e_UPPER, e_LOWER_id + 1);
         open_cell = std::next(open_cell, e_LOWER_id / 2 + 1);
@@ -245,13 +261,13 @@ void processEvent(const PolygonWithHoles& pwh, const VertexConstCirculator& v,
         L->insert(L->begin(), e_upper);
         L->insert(L->begin(), e_lower);
       } else {
-        std::list<Segment_2>::iterator inserter = std::next(e_UPPER);
+        std::pmr::list<Segment_2>::iterator inserter = std::next(e_UPPER);
         L->insert(inserter, e_lower);
         L->insert(inserter, e_upper);
       }
 
       // Create new polygon.
-      std::list<Polygon_2>::iterator open_polygon =
+      std::pmr::list<Polygon_2>::iterator open_polygon =
           open_polygons->insert(open_cell, Polygon_2());
       open_polygon->push_back(e_upper.source());
       if (!eq_2(e_lower.source(), e_upper.source())) {
@@ -259,18 +275,18 @@ void processEvent(const PolygonWithHoles& pwh, const VertexConstCirculator& v,
       }
     } else {
       // Add new polygon between e_LOWER and e_UPPER.
-      std::list<Segment_2>::iterator e_LOWER =
+      std::pmr::list<Segment_2>::iterator e_LOWER =
           std::next(L->begin(), e_LOWER_id);
-      std::list<Polygon_2>::iterator cell =
+      std::pmr::list<Polygon_2>::iterator cell =
           std::next(open_polygons->begin(), e_LOWER_id / 2);
 
       // Add e_lower and e_upper
-      std::list<Segment_2>::iterator e_lower_it =
+      std::pmr::list<Segment_2>::iterator e_lower_it =
           L->insert(std::next(e_LOWER), e_lower);
       L->insert(std::next(e_lower_it), e_upper);
 
       // Add new cell.
-      std::list<Polygon_2>::iterator new_polygon =
+      std::pmr::list<Polygon_2>::iterator new_polygon =
           open_polygons->insert(cell, Polygon_2());
 
       // Close one cell.
@@ -289,15 +305,15 @@ void processEvent(const PolygonWithHoles& pwh, const VertexConstCirculator& v,
       // Close old cell.
       open_polygons->erase(cell);
     }
-    processed_vertices->push_back(e_lower.source());
+    processed_vertices->insert(e_lower.source());
     if (!eq_2(e_lower.source(), e_upper.source())) {
-      processed_vertices->push_back(e_upper.source());
+      processed_vertices->insert(e_upper.source());
     }
   } else {
     // TODO(rikba): Sort vertices correctly in the first place.
     // Check if v exits among edges.
     VertexConstCirculator v_middle = v;
-    std::list<Segment_2>::iterator it = L->end();
+    std::pmr::list<Segment_2>::iterator it = L->end();
     while (it == L->end()) {
       for (it = L->begin(); it != L->end(); it++) {
         if (*v_middle == it->source() || *v_middle == it->target()) {
@@ -338,7 +354,7 @@ void processEvent(const PolygonWithHoles& pwh, const VertexConstCirculator& v,
     e_next = Segment_2(*v_middle, *std::next(v_middle));
 
     // Find edge to update.
-    std::list<Segment_2>::iterator old_e_it = L->begin();
+    std::pmr::list<Segment_2>::iterator old_e_it = L->begin();
     Segment_2 new_edge;
     size_t edge_id = 0;
     for (; old_e_it != L->end(); ++old_e_it) {
@@ -355,7 +371,7 @@ void processEvent(const PolygonWithHoles& pwh, const VertexConstCirculator& v,
 
     // Update cell with new vertex.
     size_t cell_id = edge_id / 2;
-    std::list<Polygon_2>::iterator cell =
+    std::pmr::list<Polygon_2>::iterator cell =
         std::next(open_polygons->begin(), cell_id);
 
     if ((edge_id % 2) == 0) {
@@ -369,17 +385,19 @@ void processEvent(const PolygonWithHoles& pwh, const VertexConstCirculator& v,
     L->insert(old_e_it, new_edge);
     L->erase(old_e_it);
 
-    processed_vertices->push_back(*v_middle);
+    processed_vertices->insert(*v_middle);
   }
 }
-std::vector<Point_2> getIntersections(const std::list<Segment_2>& L,
-                                      const Line_2& l) {
+void getIntersections(const std::pmr::list<Segment_2>& L, const Line_2& l,
+                      std::vector<Point_2>* intersections) {
+  ROS_ASSERT(intersections);
   typedef CGAL::cpp11::result_of<Intersect_2(Segment_2, Line_2)>::type
       Intersection;
 
-  std::vector<Point_2> intersections(L.size());
-  std::vector<Point_2>::iterator intersection = intersections.begin();
-  for (std::list<Segment_2>::const_iterator it = L.begin(); it != L.end();
+  intersections->clear();
+  intersections->resize(L.size());
+  std::vector<Point_2>::iterator intersection = intersections->begin();
+  for (std::pmr::list<Segment_2>::const_iterator it = L.begin(); it != L.end();
        ++it) {
     Intersection result = CGAL::intersection(*it, l);
     if (result) {
@@ -393,8 +411,6 @@ std::vector<Point_2> getIntersections(const std::list<Segment_2>& L,
       ROS_ERROR_STREAM("No intersection found!");
     }
   }
-
-  return intersections;
 }
 
 void sortPolygon(PolygonWithHoles* pwh) {
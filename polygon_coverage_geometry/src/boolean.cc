@@ -20,13 +20,73 @@
 #include "polygon_coverage_geometry/boolean.h"
 #include "polygon_coverage_geometry/cgal_definitions.h"
 
+#include <set>
+#include <vector>
+
+#include <CGAL/Arr_segment_traits_2.h>
 #include <CGAL/General_polygon_set_2.h>
 #include <CGAL/Gps_segment_traits_2.h>
+#if __has_include(<CGAL/Surface_sweep_2_algorithms.h>)
+#include <CGAL/Surface_sweep_2_algorithms.h>
+#else
+#include <CGAL/Sweep_line_2_algorithms.h>
+#endif
 #include <ros/assert.h>
 #include <ros/console.h>
 
 namespace polygon_coverage_planning {
 
+bool addDisjointHoles(const Polygon_2& hull,
+                      const std::list<Polygon_2>::const_iterator& holes_begin,
+                      const std::list<Polygon_2>::const_iterator& holes_end,
+                      PolygonWithHoles* pwh) {
+  ROS_ASSERT(pwh);
+  typedef CGAL::Arr_segment_traits_2<K> Traits_2;
+
+  // Distinct vertices and no interior edge intersections imply simple and
+  // pairwise disjoint rings.
+  std::vector<const Polygon_2*> rings = {&hull};
+  for (auto h = holes_begin; h != holes_end; ++h) rings.push_back(&(*h));
+  std::set<Point_2> vertices;
+  std::vector<Traits_2::Curve_2> edges;
+  for (const Polygon_2* ring : rings) {
+    if (ring->size() < 3) return false;
+    for (const Point_2& v : *ring) {
+      if (!vertices.insert(v).second) return false;
+    }
+    for (auto e = ring->edges_begin(); e != ring->edges_end(); ++e) {
+      edges.emplace_back(*e);
+    }
+  }
+  if (CGAL::do_curves_intersect(edges.begin(), edges.end())) return false;
+
+  // With disjoint boundaries one vertex decides containment. Holes must be
+  // inside the hull and outside all other holes.
+  std::vector<CGAL::Bbox_2> boxes;
+  for (size_t i = 1; i < rings.size(); ++i) boxes.push_back(rings[i]->bbox());
+  for (size_t i = 1; i < rings.size(); ++i) {
+    const Point_2& v = *rings[i]->vertices_begin();
+    if (hull.bounded_side(v) != CGAL::ON_BOUNDED_SIDE) return false;
+    for (size_t j = 1; j < rings.size(); ++j) {
+      if (i != j && CGAL::do_overlap(boxes[i - 1], boxes[j - 1]) &&
+          rings[j]->bounded_side(v) == CGAL::ON_BOUNDED_SIDE) {
+        return false;
+      }
+    }
+  }
+
+  *pwh = PolygonWithHoles(hull);
+  if (pwh->outer_boundary().is_clockwise_oriented()) {
+    pwh->outer_boundary().reverse_orientation();
+  }
+  for (auto h = holes_begin; h != holes_end; ++h) {
+    Polygon_2 hole = *h;
+    if (hole.is_counterclockwise_oriented()) hole.reverse_orientation();
+    pwh->add_hole(hole);
+  }
+  return true;
+}
+
 std::list<PolygonWithHoles> computeDifference(
     const std::list<Polygon_2>::const_iterator& hull,
     const std::list<Polygon_2>::const_iterator& holes_begin,
@@ -38,6 +98,13 @@ std::list<PolygonWithHoles> computeDifference(
     const Polygon_2& hull,
     const std::list<Polygon_2>::const_iterator& holes_begin,
     const std::list<Polygon_2>::const_iterator& holes_end) {
+  std::list<PolygonWithHoles> res;
+  PolygonWithHoles pwh;
+  if (addDisjointHoles(hull, holes_begin, holes_end, &pwh)) {
+    res.push_back(pwh);
+    return res;
+  }
+
   typedef CGAL::Gps_segment_traits_2<K> Traits_2;
   typedef CGAL::General_polygon_set_2<Traits_2> Polygon_set_2;
 
@@ -46,7 +113,6 @@ std::list<PolygonWithHoles> computeDifference(
     gps.difference(*h);
   }
 
-  std::list<PolygonWithHoles> res;
   gps.polygons_with_holes(std::back_inserter(res));
   return res;
 }
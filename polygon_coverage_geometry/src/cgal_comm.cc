@@ -18,12 +18,25 @@
  */
 
 #include "polygon_coverage_geometry/cgal_comm.h"
-
+#include "polygon_coverage_geometry/boolean.h"
+#include "polygon_coverage_geometry/counters.h"
+#include "polygon_coverage_geometry/polygon_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <queue>
+#include <vector>
+
+#include <CGAL/intersections.h>
 #include <ros/assert.h>
 
 namespace polygon_coverage_planning {
 
 bool pointInPolygon(const PolygonWithHoles& pwh, const Point_2& p) {
+  counters::Counters::Increment(counters::kPointInPolygon);
   // Point inside outer boundary.
   CGAL::Bounded_side result =
       CGAL::bounded_side_2(pwh.outer_boundary().vertices_begin(),
@@ -44,8 +57,43 @@ bool pointInPolygon(const PolygonWithHoles& pwh, const Point_2& p) {
 bool pointsInPolygon(const PolygonWithHoles& pwh,
                      const std::vector<Point_2>::iterator& begin,
                      const std::vector<Point_2>::iterator& end) {
-  for (std::vector<Point_2>::iterator it = begin; it != end; ++it) {
-    if (!pointInPolygon(pwh, *it)) return false;
+  return PolygonIndex(pwh).containsPoints(std::vector<Point_2>(begin, end));
+}
+
+bool segmentInPolygon(const PolygonWithHoles& pwh, const Segment_2& s) {
+  if (s.is_degenerate()) return pointInPolygon(pwh, s.source());
+
+  // Split the segment at the boundary.
+  std::vector<Point_2> splits = {s.source(), s.target()};
+  const CGAL::Bbox_2 s_bbox = s.bbox();
+  auto split = [&s, &s_bbox, &splits](const Polygon_2& poly) {
+    for (EdgeConstIterator eit = poly.edges_begin(); eit != poly.edges_end();
+         ++eit) {
+      if (!CGAL::do_overlap(eit->bbox(), s_bbox)) continue;
+      auto result = CGAL::intersection(*eit, s);
+      if (!result) continue;
+      if (const Segment_2* overlap = boost::get<Segment_2>(&*result)) {
+        splits.push_back(overlap->source());
+        splits.push_back(overlap->target());
+      } else {
+        splits.push_back(*boost::get<Point_2>(&*result));
+      }
+    }
+  };
+  split(pwh.outer_boundary());
+  for (PolygonWithHoles::Hole_const_iterator hit = pwh.holes_begin();
+       hit != pwh.holes_end(); ++hit)
+    split(*hit);
+
+  // Every piece between two splits is either inside or outside.
+  std::sort(splits.begin(), splits.end(),
+            [&s](const Point_2& a, const Point_2& b) {
+              return CGAL::has_smaller_distance_to_point(s.source(), a, b);
+            });
+  splits.erase(std::unique(splits.begin(), splits.end()), splits.end());
+  for (size_t i = 1; i < splits.size(); ++i) {
+    if (!pointInPolygon(pwh, CGAL::midpoint(splits[i - 1], splits[i])))
+      return false;
   }
   return true;
 }
@@ -78,17 +126,18 @@ Point_2 projectOnPolygon2(const Polygon_2& poly, const Point_2& p,
                          return lhs.first < rhs.first;
                        });
 
-  EdgeConstIterator closest_edge = closest_pair->second;
   *squared_distance = closest_pair->first;
+  return projectOnSegment2(*closest_pair->second, p);
+}
 
-  // Project p on supporting line of closest edge.
-  Point_2 projection = closest_edge->supporting_line().projection(p);
+Point_2 projectOnSegment2(const Segment_2& s, const Point_2& p) {
+  // Project p on supporting line of the segment.
+  Point_2 projection = s.supporting_line().projection(p);
   // Check if p is on edge. If not snap it to source or target.
-  if (!closest_edge->has_on(projection)) {
-    FT d_source = CGAL::squared_distance(p, closest_edge->source());
-    FT d_target = CGAL::squared_distance(p, closest_edge->target());
-    projection =
-        d_source < d_target ? closest_edge->source() : closest_edge->target();
+  if (!s.has_on(projection)) {
+    FT d_source = CGAL::squared_distance(p, s.source());
+    FT d_target = CGAL::squared_distance(p, s.target());
+    projection = d_source < d_target ? s.source() : s.target();
   }
 
   return projection;
@@ -156,6 +205,256 @@ void simplifyPolygon(PolygonWithHoles* pwh) {
     simplifyPolygon(&*hi);
 }
 
+namespace {
+// Removes vertices from the rings of a polygon with holes. All rings form one
+// vertex list with previous and next links. A uniform grid over the original
+// vertices finds the vertices inside the cut off corner triangles.
+class BoundarySimplifier {
+ public:
+  BoundarySimplifier(PolygonWithHoles* pwh, double tolerance)
+      : pwh_(pwh), squared_tolerance_(tolerance * tolerance) {
+    ROS_ASSERT(pwh_);
+    rings_.push_back(&pwh_->outer_boundary());
+    for (PolygonWithHoles::Hole_iterator hi = pwh_->holes_begin();
+         hi != pwh_->holes_end(); ++hi) {
+      rings_.push_back(&*hi);
+    }
+    for (size_t r = 0; r < rings_.size(); ++r) {
+      const size_t first = points_.size();
+      const size_t n = rings_[r]->size();
+      ring_sizes_.push_back(n);
+      for (size_t i = 0; i < n; ++i) {
+        points_.push_back(rings_[r]->vertex(i));
+        prev_.push_back(first + (i + n - 1) % n);
+        next_.push_back(first + (i + 1) % n);
+        ring_of_.push_back(r);
+      }
+    }
+    chains_.resize(points_.size());
+    removed_.resize(points_.size(), false);
+    versions_.resize(points_.size(), 0);
+    createGrid();
+  }
+
+  size_t simplify() {
+    for (size_t v = 0; v < points_.size(); ++v) push(v);
+    size_t num_removed = 0;
+    while (!queue_.empty()) {
+      const Candidate c = queue_.top();
+      queue_.pop();
+      if (removed_[c.vertex] || c.version != versions_[c.vertex]) continue;
+      if (!isRemovable(c.vertex)) continue;
+      remove(c.vertex);
+      ++num_removed;
+    }
+    if (num_removed > 0) writeRings();
+    return num_removed;
+  }
+
+ private:
+  struct Candidate {
+    double deviation;
+    size_t vertex;
+    size_t version;
+    bool operator<(const Candidate& other) const {
+      return deviation > other.deviation;  // Smallest deviation on top.
+    }
+  };
+
+  // The maximum squared distance of the vertex and the vertices removed next
+  // to it from the edge that replaces it.
+  FT computeDeviation(size_t v) const {
+    const Segment_2 edge(points_[prev_[v]], points_[next_[v]]);
+    FT deviation = CGAL::squared_distance(edge, points_[v]);
+    for (size_t chain : {prev_[v], v}) {
+      for (size_t u : chains_[chain]) {
+        deviation =
+            std::max(deviation, CGAL::squared_distance(edge, points_[u]));
+      }
+    }
+    return deviation;
+  }
+
+  void push(size_t v) {
+    if (ring_sizes_[ring_of_[v]] <= 3) return;
+    const FT deviation = computeDeviation(v);
+    if (deviation > squared_tolerance_) return;
+    queue_.push({CGAL::to_double(deviation), v, versions_[v]});
+  }
+
+  // The corner is convex, i.e., the free space is left of every edge, and the
+  // triangle contains no other vertex.
+  bool isRemovable(size_t v) const {
+    if (ring_sizes_[ring_of_[v]] <= 3) return false;
+    const size_t a = prev_[v];
+    const size_t b = next_[v];
+    if (!CGAL::left_turn(points_[a], points_[v], points_[b])) return false;
+    const Triangle_2 corner(points_[a], points_[v], points_[b]);
+    const CGAL::Bbox_2 bbox = corner.bbox();
+    const size_t x_min = getCell(bbox.xmin(), x_min_, num_x_);
+    const size_t x_max = getCell(bbox.xmax(), x_min_, num_x_);
+    const size_t y_min = getCell(bbox.ymin(), y_min_, num_y_);
+    const size_t y_max = getCell(bbox.ymax(), y_min_, num_y_);
+    // Keep long corners, instead of testing most of the grid.
+    const size_t kMaxCells = 1024;
+    if ((x_max - x_min + 1) * (y_max - y_min + 1) > kMaxCells) return false;
+    for (size_t x = x_min; x <= x_max; ++x) {
+      for (size_t y = y_min; y <= y_max; ++y) {
+        for (size_t w : grid_[x * num_y_ + y]) {
+          // Removed vertices are outside the current free space.
+          if (w == a || w == v || w == b || removed_[w]) continue;
+          if (!corner.has_on_unbounded_side(points_[w])) return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  void remove(size_t v) {
+    const size_t a = prev_[v];
+    const size_t b = next_[v];
+    chains_[a].push_back(v);
+    chains_[a].insert(chains_[a].end(), chains_[v].begin(), chains_[v].end());
+    chains_[v].clear();
+    next_[a] = b;
+    prev_[b] = a;
+    removed_[v] = true;
+    --ring_sizes_[ring_of_[v]];
+    for (size_t u : {a, b}) {
+      ++versions_[u];
+      push(u);
+    }
+  }
+
+  void createGrid() {
+    CGAL::Bbox_2 bbox = pwh_->outer_boundary().bbox();
+    x_min_ = bbox.xmin();
+    y_min_ = bbox.ymin();
+    // About one vertex per cell and at most one row of cells per vertex.
+    const double width = bbox.xmax() - bbox.xmin();
+    const double height = bbox.ymax() - bbox.ymin();
+    const double n = static_cast<double>(points_.size());
+    cell_size_ = std::max({std::sqrt(width * height / n),
+                           std::max(width, height) / n,
+                           std::numeric_limits<double>::min()});
+    num_x_ = static_cast<size_t>((bbox.xmax() - x_min_) / cell_size_) + 1;
+    num_y_ = static_cast<size_t>((bbox.ymax() - y_min_) / cell_size_) + 1;
+    grid_.resize(num_x_ * num_y_);
+    for (size_t v = 0; v < points_.size(); ++v) {
+      const CGAL::Bbox_2 point_bbox = points_[v].bbox();
+      // Vertices on cell borders are in all touching cells.
+      for (size_t x = getCell(point_bbox.xmin(), x_min_, num_x_);
+           x <= getCell(point_bbox.xmax(), x_min_, num_x_); ++x) {
+        for (size_t y = getCell(point_bbox.ymin(), y_min_, num_y_);
+             y <= getCell(point_bbox.ymax(), y_min_, num_y_); ++y) {
+          grid_[x * num_y_ + y].push_back(v);
+        }
+      }
+    }
+  }
+
+  size_t getCell(double c, double min, size_t num_cells) const {
+    const double i = std::floor((c - min) / cell_size_);
+    if (i <= 0.0) return 0;
+    return std::min(static_cast<size_t>(i), num_cells - 1);
+  }
+
+  void writeRings() {
+    std::vector<bool> written(rings_.size(), false);
+    for (size_t v = 0; v < points_.size(); ++v) {
+      const size_t r = ring_of_[v];
+      if (removed_[v] || written[r]) continue;
+      Polygon_2 ring;
+      ring.container().reserve(ring_sizes_[r]);
+      size_t u = v;
+      do {
+        ring.push_back(points_[u]);
+        u = next_[u];
+      } while (u != v);
+      *rings_[r] = ring;
+      written[r] = true;
+    }
+  }
+
+  PolygonWithHoles* pwh_;
+  FT squared_tolerance_;
+  std::vector<Polygon_2*> rings_;
+  std::vector<size_t> ring_sizes_;
+  std::vector<Point_2> points_;
+  std::vector<size_t> prev_;
+  std::vector<size_t> next_;
+  std::vector<size_t> ring_of_;
+  // The removed vertices between a vertex and its next vertex.
+  std::vector<std::vector<size_t>> chains_;
+  std::vector<bool> removed_;
+  std::vector<size_t> versions_;  // Invalidate queued candidates.
+  std::priority_queue<Candidate> queue_;
+
+  double x_min_ = 0.0;
+  double y_min_ = 0.0;
+  double cell_size_ = 1.0;
+  size_t num_x_ = 1;
+  size_t num_y_ = 1;
+  std::vector<std::vector<size_t>> grid_;
+};
+}  // namespace
+
+size_t simplifyPolygonBoundary(PolygonWithHoles* pwh, double tolerance) {
+  ROS_ASSERT(pwh);
+  if (tolerance <= 0.0 || pwh->outer_boundary().size() < 3) return 0;
+  return BoundarySimplifier(pwh, tolerance).simplify();
+}
+
+namespace {
+// Snap the vertices of a ring to multiples of step and drop repeated and
+// collinear ones.
+Polygon_2 snapRingToGrid(const Polygon_2& ring, double step) {
+  Polygon_2 snapped;
+  snapped.container().reserve(ring.size());
+  for (const Point_2& p : ring) {
+    const Point_2 v(std::round(CGAL::to_double(p.x()) / step) * step,
+                    std::round(CGAL::to_double(p.y()) / step) * step);
+    if (snapped.is_empty() || v != snapped.container().back()) {
+      snapped.push_back(v);
+    }
+  }
+  while (snapped.size() > 1 &&
+         snapped.container().front() == snapped.container().back()) {
+    snapped.container().pop_back();
+  }
+  // Nearly collinear vertices, e.g., of densely sampled boundaries, may become
+  // exactly collinear.
+  if (snapped.size() >= 3) {
+    simplifyPolygon(&snapped);
+  }
+  return snapped;
+}
+}  // namespace
+
+bool snapPolygonToGrid(PolygonWithHoles* pwh, double resolution) {
+  ROS_ASSERT(pwh);
+  if (!(resolution > 0.0)) return false;
+  const double step = std::exp2(std::floor(std::log2(resolution)));
+
+  const Polygon_2 hull = snapRingToGrid(pwh->outer_boundary(), step);
+  if (hull.size() < 3 || !hull.is_simple()) return false;
+  std::list<Polygon_2> holes;
+  for (PolygonWithHoles::Hole_const_iterator hit = pwh->holes_begin();
+       hit != pwh->holes_end(); ++hit) {
+    Polygon_2 hole = snapRingToGrid(*hit, step);
+    if (hole.size() < 3) continue;  // Collapsed.
+    if (!hole.is_simple()) return false;
+    holes.push_back(std::move(hole));
+  }
+
+  PolygonWithHoles snapped;
+  if (!addDisjointHoles(hull, holes.cbegin(), holes.cend(), &snapped)) {
+    return false;
+  }
+  *pwh = std::move(snapped);
+  return true;
+}
+
 PolygonWithHoles rotatePolygon(const PolygonWithHoles& polygon_in,
                                const Direction_2& dir) {
   CGAL::Aff_transformation_2<K> rotation(CGAL::ROTATION, dir, 1, 1e9);
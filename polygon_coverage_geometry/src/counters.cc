@@ -0,0 +1,154 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "polygon_coverage_geometry/counters.h"
+
+#include <atomic>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+
+namespace polygon_coverage_planning {
+namespace counters {
+namespace {
+struct Registry {
+  std::atomic<bool> is_counting{false};
+  std::array<std::atomic<uint64_t>, kNumCounters> counts{};
+  std::mutex mutex;  // Guards stages.
+  std::map<std::string, Counts> stages;
+};
+
+Registry& getRegistry() {
+  static Registry registry;
+  return registry;
+}
+
+const char* const kNames[kNumCounters] = {
+    "line_polygon_intersections", "edge_intersections",
+    "exact_fallbacks",            "point_in_polygon",
+    "visibility_polygons",        "shortest_path_queries",
+    "shortest_path_cache_hits",   "waypoint_copies"};
+}  // namespace
+
+void Counters::Start() {
+  Reset();
+  getRegistry().is_counting = true;
+}
+
+void Counters::Stop() { getRegistry().is_counting = false; }
+
+bool Counters::IsCounting() {
+  return getRegistry().is_counting.load(std::memory_order_relaxed);
+}
+
+void Counters::Reset() {
+  Registry& registry = getRegistry();
+  for (std::atomic<uint64_t>& count : registry.counts) {
+    count = 0;
+  }
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.stages.clear();
+}
+
+void Counters::Increment(Counter counter, uint64_t n) {
+  Registry& registry = getRegistry();
+  if (!registry.is_counting.load(std::memory_order_relaxed)) return;
+  registry.counts[counter].fetch_add(n, std::memory_order_relaxed);
+}
+
+uint64_t Counters::Get(Counter counter) {
+  return getRegistry().counts[counter].load(std::memory_order_relaxed);
+}
+
+Counts Counters::GetCounts() {
+  Counts counts;
+  for (size_t i = 0; i < kNumCounters; ++i) {
+    counts[i] = Get(static_cast<Counter>(i));
+  }
+  return counts;
+}
+
+std::map<std::string, Counts> Counters::GetStages() {
+  Registry& registry = getRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  return registry.stages;
+}
+
+const char* Counters::GetName(Counter counter) { return kNames[counter]; }
+
+void Counters::AddStage(const std::string& tag, const Counts& counts) {
+  Registry& registry = getRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  Counts& stage = registry.stages[tag];
+  for (size_t i = 0; i < kNumCounters; ++i) {
+    stage[i] += counts[i];
+  }
+}
+
+void Counters::Print(std::ostream& out) {
+  const std::map<std::string, Counts> stages = GetStages();
+  out << "SM Counters\n";
+  out << "-----------\n";
+  out.width(24);
+  out.setf(std::ios::left, std::ios::adjustfield);
+  out << "stage";
+  for (size_t i = 0; i < kNumCounters; ++i) {
+    out << "\t" << kNames[i];
+  }
+  out << "\n";
+  std::map<std::string, Counts> rows = stages;
+  rows["total"] = GetCounts();
+  for (const std::pair<const std::string, Counts>& row : rows) {
+    out.width(24);
+    out << row.first;
+    for (uint64_t count : row.second) {
+      out << "\t" << count;
+    }
+    out << "\n";
+  }
+}
+
+std::string Counters::Print() {
+  std::stringstream ss;
+  Print(ss);
+  return ss.str();
+}
+
+Stage::Stage(const char* tag)
+    : tag_(tag), is_open_(Counters::IsCounting()), start_() {
+  if (is_open_) {
+    start_ = Counters::GetCounts();
+  }
+}
+
+Stage::~Stage() { End(); }
+
+void Stage::End() {
+  if (!is_open_) return;
+  is_open_ = false;
+  const Counts end = Counters::GetCounts();
+  Counts counts;
+  for (size_t i = 0; i < kNumCounters; ++i) {
+    counts[i] = end[i] - start_[i];
+  }
+  Counters::AddStage(tag_, counts);
+}
+
+}  // namespace counters
+}  // namespace polygon_coverage_planning
@@ -20,11 +20,20 @@
 #include "polygon_coverage_geometry/bcd.h"
 #include "polygon_coverage_geometry/decomposition.h"
 #include "polygon_coverage_geometry/tcd.h"
+#include "polygon_coverage_geometry/triangulation.h"
 #include "polygon_coverage_geometry/weakly_monotone.h"
 
+#include <atomic>
+#include <limits>
+#include <list>
+#include <map>
+#include <queue>
+
 #include <ros/assert.h>
 #include <ros/console.h>
 
+#include <polygon_coverage_solvers/parallel.h>
+
 namespace polygon_coverage_planning {
 
 std::vector<Direction_2> findEdgeDirections(const PolygonWithHoles& pwh) {
@@ -98,70 +107,268 @@ double findBestSweepDir(const Polygon_2& cell, Direction_2* best_dir) {
   return min_altitude;
 }
 
-bool computeBestBCDFromPolygonWithHoles(const PolygonWithHoles& pwh,
-                                        std::vector<Polygon_2>* bcd_polygons) {
-  ROS_ASSERT(bcd_polygons);
-  bcd_polygons->clear();
-  double min_altitude_sum = std::numeric_limits<double>::max();
+namespace {
+// Lower the shared best altitude sum to value.
+void updateMin(std::atomic<double>* min, double value) {
+  ROS_ASSERT(min);
+  double current = min->load();
+  while (value < current && !min->compare_exchange_weak(current, value)) {
+  }
+}
+
+// Decompose the polygon perpendicular to every edge direction and return the
+// first decomposition with the smallest altitude sum. The reduction is in
+// direction order, so the result does not depend on the number of threads.
+template <class Decompose>
+bool computeBestDecomposition(const PolygonWithHoles& pwh,
+                              const Decompose& decompose, size_t num_threads,
+                              std::vector<Polygon_2>* polygons) {
+  ROS_ASSERT(polygons);
+  polygons->clear();
 
   // Get all possible decomposition directions.
   std::vector<Direction_2> directions = findPerpEdgeDirections(pwh);
 
-  // For all possible rotations:
-  for (const auto& dir : directions) {
-    // Calculate decomposition.
-    std::vector<Polygon_2> cells = computeBCD(pwh, dir);
-
-    // Calculate minimum altitude sum for each cell.
-    double min_altitude_sum_tmp = 0.0;
-    for (const auto& cell : cells) {
-      min_altitude_sum_tmp += findBestSweepDir(cell);
+  // For all possible rotations calculate the decomposition and the minimum
+  // altitude sum of its cells. Altitudes are non-negative, so the summation
+  // stops once the sum exceeds the best complete sum. A decomposition that
+  // ties the best sum is always completed, which keeps the first best one.
+  const double kInfinity = std::numeric_limits<double>::infinity();
+  std::atomic<double> best_altitude_sum(kInfinity);
+  std::vector<std::vector<Polygon_2>> cells(directions.size());
+  std::vector<double> min_altitude_sums(directions.size(), kInfinity);
+  parallelFor(directions.size(), num_threads, [&](size_t i) {
+    cells[i] = decompose(pwh, directions[i]);
+    double min_altitude_sum = 0.0;
+    for (const auto& cell : cells[i]) {
+      min_altitude_sum += findBestSweepDir(cell);
+      if (min_altitude_sum > best_altitude_sum.load()) {
+        cells[i].clear();  // Cannot be the best decomposition.
+        return true;
+      }
     }
+    min_altitude_sums[i] = min_altitude_sum;
+    updateMin(&best_altitude_sum, min_altitude_sum);
+    return true;
+  });
 
-    // Update best decomposition.
-    if (min_altitude_sum_tmp < min_altitude_sum) {
-      min_altitude_sum = min_altitude_sum_tmp;
-      *bcd_polygons = cells;
+  // Find best decomposition.
+  double min_altitude_sum = std::numeric_limits<double>::max();
+  size_t best = directions.size();
+  for (size_t i = 0; i < directions.size(); ++i) {
+    if (min_altitude_sums[i] < min_altitude_sum) {
+      min_altitude_sum = min_altitude_sums[i];
+      best = i;
     }
   }
-
-  if (bcd_polygons->empty())
+  if (best == directions.size() || cells[best].empty()) {
     return false;
-  else
-    return true;
+  }
+  *polygons = std::move(cells[best]);
+  return true;
+}
+}  // namespace
+
+bool computeBestBCDFromPolygonWithHoles(const PolygonWithHoles& pwh,
+                                        std::vector<Polygon_2>* bcd_polygons,
+                                        size_t num_threads) {
+  return computeBestDecomposition(
+      pwh,
+      [](const PolygonWithHoles& p, const Direction_2& dir) {
+        return computeBCD(p, dir);
+      },
+      num_threads, bcd_polygons);
 }
 
 bool computeBestTCDFromPolygonWithHoles(const PolygonWithHoles& pwh,
-                                        std::vector<Polygon_2>* tcd_polygons) {
-  ROS_ASSERT(tcd_polygons);
-  tcd_polygons->clear();
-  double min_altitude_sum = std::numeric_limits<double>::max();
+                                        std::vector<Polygon_2>* tcd_polygons,
+                                        size_t num_threads) {
+  return computeBestDecomposition(
+      pwh,
+      [](const PolygonWithHoles& p, const Direction_2& dir) {
+        return computeTCD(p, dir);
+      },
+      num_threads, tcd_polygons);
+}
 
-  // Get all possible decomposition directions.
-  std::vector<Direction_2> directions = findPerpEdgeDirections(pwh);
+namespace {
+// Strict order of points perpendicular to the sweep axis. Ties in the distance
+// to the axis are broken along the axis. A ring with a single local maximum in
+// this order is weakly monotone perpendicular to the axis.
+class SweepOrder {
+ public:
+  SweepOrder(const Point_2& source, const Point_2& target)
+      : axis_(source, target), perp_(axis_.perpendicular(source)) {}
+
+  bool less(const Point_2& p, const Point_2& q) const {
+    CGAL::Comparison_result c =
+        CGAL::compare_signed_distance_to_line(axis_, p, q);
+    if (c == CGAL::EQUAL) {
+      c = CGAL::compare_signed_distance_to_line(perp_, p, q);
+    }
+    return c == CGAL::SMALLER;
+  }
+
+  int isMaximum(const CDT::Vertex_handle& prev, const CDT::Vertex_handle& v,
+                const CDT::Vertex_handle& next) const {
+    return less(prev->point(), v->point()) && less(next->point(), v->point());
+  }
+
+ private:
+  Line_2 axis_;
+  Line_2 perp_;
+};
 
-  // For all possible rotations:
-  for (const auto& dir : directions) {
-    // Calculate decomposition.
-    std::vector<Polygon_2> cells = computeTCD(pwh, dir);
+typedef std::list<CDT::Vertex_handle> Ring;
 
-    // Calculate minimum altitude sum for each cell.
-    double min_altitude_sum_tmp = 0.0;
-    for (const auto& cell : cells) {
-      min_altitude_sum_tmp += findBestSweepDir(cell);
+Ring::iterator nextInRing(Ring* ring, Ring::iterator it) {
+  ROS_ASSERT(ring);
+  return ++it == ring->end() ? ring->begin() : it;
+}
+
+Ring::iterator prevInRing(Ring* ring, Ring::iterator it) {
+  ROS_ASSERT(ring);
+  return it == ring->begin() ? std::prev(ring->end()) : --it;
+}
+
+// An unmerged edge of a cell ring. The edge is opposite vertex index of face
+// and starts at source in the counter-clockwise ring.
+struct FrontierEdge {
+  CDT::Face_handle face;
+  int index;
+  Ring::iterator source;
+};
+}  // namespace
+
+bool computeTMDFromPolygonWithHoles(const PolygonWithHoles& pwh,
+                                    std::vector<Polygon_2>* tmd_polygons) {
+  ROS_ASSERT(tmd_polygons);
+  tmd_polygons->clear();
+
+  CDT cdt;
+  cdt.insert_constraint(pwh.outer_boundary().vertices_begin(),
+                        pwh.outer_boundary().vertices_end(), true);
+  for (PolygonWithHoles::Hole_const_iterator hit = pwh.holes_begin();
+       hit != pwh.holes_end(); ++hit) {
+    cdt.insert_constraint(hit->vertices_begin(), hit->vertices_end(), true);
+  }
+  mark_domains(cdt);
+
+  std::vector<CDT::Face_handle> faces;
+  for (CDT::Finite_faces_iterator fit = cdt.finite_faces_begin();
+       fit != cdt.finite_faces_end(); ++fit) {
+    if (!fit->info().in_domain()) continue;
+    fit->info().id = faces.size();
+    faces.push_back(fit);
+  }
+  if (faces.empty()) {
+    ROS_ERROR_STREAM("Polygon has no triangles.");
+    return false;
+  }
+
+  const size_t kUnassigned = std::numeric_limits<size_t>::max();
+  std::vector<size_t> face_cell(faces.size(), kUnassigned);
+  // The last cell whose ring contains the vertex.
+  std::map<CDT::Vertex_handle, size_t> vertex_cell;
+  for (size_t seed = 0; seed < faces.size(); ++seed) {
+    if (face_cell[seed] != kUnassigned) continue;
+    const size_t cell = tmd_polygons->size();
+    const CDT::Face_handle f = faces[seed];
+    face_cell[seed] = cell;
+
+    // The sweep axis is the longest boundary edge of the seed triangle, or its
+    // longest edge if it has none. The axis edge is never merged over, so the
+    // cell can be swept along it.
+    auto squared_length = [&f](int i) {
+      return CGAL::squared_distance(f->vertex(CDT::ccw(i))->point(),
+                                    f->vertex(CDT::cw(i))->point());
+    };
+    int axis = 0;
+    for (int i = 1; i < 3; ++i) {
+      const bool constrained = cdt.is_constrained(CDT::Edge(f, i));
+      const bool axis_constrained = cdt.is_constrained(CDT::Edge(f, axis));
+      if (constrained != axis_constrained) {
+        if (constrained) axis = i;
+      } else if (squared_length(i) > squared_length(axis)) {
+        axis = i;
+      }
+    }
+    const SweepOrder order(f->vertex(CDT::ccw(axis))->point(),
+                           f->vertex(CDT::cw(axis))->point());
+
+    // Grow the cell across its unconstrained edges. A triangle is merged if its
+    // apex is not yet on the ring, which keeps the cell simple and without
+    // holes, and if the ring keeps a single maximum. Only the apex and the two
+    // shared vertices can change their maximum status, so the test is O(1).
+    Ring ring;
+    for (int i = 0; i < 3; ++i) {
+      ring.push_back(f->vertex(i));
+      vertex_cell[f->vertex(i)] = cell;
+    }
+    std::queue<FrontierEdge> frontier;
+    for (int i = 0; i < 3; ++i) {
+      if (i == axis) continue;
+      frontier.push({f, i, std::next(ring.begin(), CDT::ccw(i))});
     }
+    int num_maxima = 1;
+    while (!frontier.empty()) {
+      const FrontierEdge e = frontier.front();
+      frontier.pop();
+      const CDT::Face_handle n = e.face->neighbor(e.index);
+      if (cdt.is_constrained(CDT::Edge(e.face, e.index)) ||
+          cdt.is_infinite(n) || !n->info().in_domain() ||
+          face_cell[n->info().id] != kUnassigned) {
+        continue;
+      }
+      const CDT::Vertex_handle apex = n->vertex(n->index(e.face));
+      std::map<CDT::Vertex_handle, size_t>::const_iterator vit =
+          vertex_cell.find(apex);
+      if (vit != vertex_cell.end() && vit->second == cell) continue;
+
+      const Ring::iterator a = e.source;
+      const Ring::iterator b = nextInRing(&ring, a);
+      const CDT::Vertex_handle prev = *prevInRing(&ring, a);
+      const CDT::Vertex_handle next = *nextInRing(&ring, b);
+      const int removed =
+          order.isMaximum(prev, *a, *b) + order.isMaximum(*a, *b, next);
+      const int added = order.isMaximum(prev, *a, apex) +
+                        order.isMaximum(*a, apex, *b) +
+                        order.isMaximum(apex, *b, next);
+      if (num_maxima - removed + added > 1) continue;
 
-    // Update best decomposition.
-    if (min_altitude_sum_tmp < min_altitude_sum) {
-      min_altitude_sum = min_altitude_sum_tmp;
-      *tcd_polygons = cells;
+      num_maxima += added - removed;
+      const Ring::iterator apex_it = ring.insert(b, apex);
+      face_cell[n->info().id] = cell;
+      vertex_cell[apex] = cell;
+      frontier.push({n, n->index(*b), a});
+      frontier.push({n, n->index(*a), apex_it});
     }
+
+    Polygon_2 polygon;
+    polygon.container().reserve(ring.size());
+    for (const CDT::Vertex_handle& v : ring) polygon.push_back(v->point());
+    tmd_polygons->push_back(std::move(polygon));
   }
 
-  if (tcd_polygons->empty())
-    return false;
-  else
-    return true;
+  return true;
+}
+
+bool computeDecomposition(const PolygonWithHoles& pwh,
+                          const DecompositionType& type,
+                          std::vector<Polygon_2>* polygons,
+                          size_t num_threads) {
+  ROS_ASSERT(polygons);
+  switch (type) {
+    case DecompositionType::kBCD:
+      return computeBestBCDFromPolygonWithHoles(pwh, polygons, num_threads);
+    case DecompositionType::kTCD:
+      return computeBestTCDFromPolygonWithHoles(pwh, polygons, num_threads);
+    case DecompositionType::kTMD:
+      return computeTMDFromPolygonWithHoles(pwh, polygons);
+    default:
+      ROS_ERROR_STREAM("No valid decomposition type set.");
+      return false;
+  }
 }
 
 }  // namespace polygon_coverage_planning
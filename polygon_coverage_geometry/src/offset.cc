@@ -22,7 +22,10 @@
 
 #include <CGAL/Boolean_set_operations_2.h>
 #include <CGAL/Cartesian_converter.h>
+#include <CGAL/Straight_skeleton_2.h>
+#include <CGAL/create_offset_polygons_2.h>
 #include <CGAL/create_offset_polygons_from_polygon_with_holes_2.h>
+#include <CGAL/create_straight_skeleton_2.h>
 #include <boost/make_shared.hpp>
 
 #include <ros/assert.h>
@@ -39,10 +42,27 @@ void computeOffsetPolygon(const PolygonWithHoles& pwh, FT max_offset,
 
   // TODO(rikba): Check weak simplicity.
 
+  // Build the straight skeleton once and offset all distances from it.
+  typedef CGAL::Straight_skeleton_2<InexactKernel> StraightSkeleton;
+  std::vector<Polygon_2> holes(sorted_pwh.holes_begin(),
+                               sorted_pwh.holes_end());
+  boost::shared_ptr<StraightSkeleton> skeleton =
+      CGAL::create_interior_straight_skeleton_2(
+          sorted_pwh.outer_boundary().vertices_begin(),
+          sorted_pwh.outer_boundary().vertices_end(), holes.begin(),
+          holes.end(), InexactKernel());
+  auto offset = [&sorted_pwh, &skeleton](const FT& distance) {
+    if (!skeleton) {
+      return CGAL::create_interior_skeleton_and_offset_polygons_with_holes_2(
+          distance, sorted_pwh);
+    }
+    return CGAL::arrange_offset_polygons_2<PolygonWithHoles>(
+        CGAL::create_offset_polygons_2<Polygon_2>(distance, *skeleton, K()));
+  };
+
   // Try maximum offsetting.
   std::vector<boost::shared_ptr<PolygonWithHoles>> result =
-      CGAL::create_interior_skeleton_and_offset_polygons_with_holes_2(
-          max_offset, sorted_pwh);
+      offset(max_offset);
   if (checkValidOffset(sorted_pwh, result)) {
     *offset_polygon = *result.front();
     return;
@@ -52,15 +72,23 @@ void computeOffsetPolygon(const PolygonWithHoles& pwh, FT max_offset,
     result = {boost::make_shared<PolygonWithHoles>(sorted_pwh)};
   }
 
+  // The topology changes at the first skeleton event at the latest.
+  FT max = max_offset;
+  if (skeleton) {
+    for (StraightSkeleton::Vertex_const_iterator vit =
+             skeleton->vertices_begin();
+         vit != skeleton->vertices_end(); ++vit) {
+      if (vit->is_skeleton() && vit->time() < max) max = vit->time();
+    }
+  }
+
   // Binary search for smaller valid offset.
   FT min = 0.0;
-  FT max = max_offset;
   const FT kBinarySearchResolution = 0.1;
   while (max - min > kBinarySearchResolution) {
     const FT mid = (min + max) / 2.0;
     std::vector<boost::shared_ptr<PolygonWithHoles>> temp_result =
-        CGAL::create_interior_skeleton_and_offset_polygons_with_holes_2(
-            mid, sorted_pwh);
+        offset(mid);
     if (checkValidOffset(sorted_pwh, temp_result)) {
       min = mid;
       result = temp_result;
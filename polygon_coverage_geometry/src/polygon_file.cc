@@ -0,0 +1,203 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "polygon_coverage_geometry/polygon_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include <ros/assert.h>
+#include <ros/console.h>
+
+namespace polygon_coverage_planning {
+
+namespace {
+const char kPolygonFileMagic[8] = {'P', 'C', 'P', 'P', 'O', 'L', 'Y', '\0'};
+const uint64_t kPolygonFileVersion = 1;
+
+void writeWord(uint64_t v, std::ostream* os) {
+  os->write(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+void writeWord(double v, std::ostream* os) {
+  os->write(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+void writeRing(const Polygon_2& ring, std::ostream* os) {
+  writeWord(static_cast<uint64_t>(ring.size()), os);
+  for (const Point_2& p : ring) {
+    writeWord(CGAL::to_double(p.x()), os);
+    writeWord(CGAL::to_double(p.y()), os);
+  }
+}
+
+// Reads 8 byte words from a mapped file. Every read fails once the file ends.
+class WordReader {
+ public:
+  WordReader(const char* data, size_t size) : data_(data), size_(size) {}
+
+  template <typename T>
+  bool read(T* v) {
+    static_assert(sizeof(T) == kWordSize, "Fields are 8 bytes.");
+    ROS_ASSERT(v);
+    if (size_ - offset_ < kWordSize) return false;
+    std::memcpy(v, data_ + offset_, kWordSize);
+    offset_ += kWordSize;
+    return true;
+  }
+  bool readRing(Polygon_2* ring) {
+    ROS_ASSERT(ring);
+    uint64_t num_vertices = 0;
+    if (!read(&num_vertices) || num_vertices < 3 ||
+        num_vertices > (size_ - offset_) / (2 * kWordSize)) {
+      return false;
+    }
+    // Construct the vertices in place.
+    ring->clear();
+    ring->container().reserve(num_vertices);
+    for (uint64_t i = 0; i < num_vertices; ++i) {
+      double x, y;
+      read(&x);
+      read(&y);
+      // The exact kernel cannot represent NaN or infinity.
+      if (!std::isfinite(x) || !std::isfinite(y)) {
+        return false;
+      }
+      ring->push_back(Point_2(x, y));
+    }
+    return true;
+  }
+  bool atEnd() const { return offset_ == size_; }
+
+ private:
+  static const size_t kWordSize = 8;
+  const char* data_;
+  size_t size_;
+  size_t offset_ = 0;
+};
+
+// A read-only memory map of a file.
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& file) {
+    const int fd = open(file.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+      void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data != MAP_FAILED) {
+        data_ = static_cast<const char*>(data);
+        size_ = static_cast<size_t>(st.st_size);
+      }
+    }
+    close(fd);
+  }
+  ~MappedFile() {
+    if (data_) munmap(const_cast<char*>(data_), size_);
+  }
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  const char* data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+};
+}  // namespace
+
+bool savePolygonFile(const std::string& file, const PolygonWithHoles& polygon,
+                     double altitude) {
+  std::ofstream os(file, std::ios::binary | std::ios::trunc);
+  if (!os) {
+    ROS_ERROR_STREAM("Cannot open polygon file " << file);
+    return false;
+  }
+  os.write(kPolygonFileMagic, sizeof(kPolygonFileMagic));
+  writeWord(kPolygonFileVersion, &os);
+  writeWord(altitude, &os);
+  writeWord(static_cast<uint64_t>(polygon.number_of_holes()), &os);
+  writeRing(polygon.outer_boundary(), &os);
+  for (PolygonWithHoles::Hole_const_iterator h = polygon.holes_begin();
+       h != polygon.holes_end(); ++h) {
+    writeRing(*h, &os);
+  }
+  if (!os.good()) {
+    ROS_ERROR_STREAM("Failed writing polygon file " << file);
+    return false;
+  }
+  return true;
+}
+
+bool loadPolygonFile(const std::string& file, PolygonWithHoles* polygon,
+                     double* altitude) {
+  ROS_ASSERT(polygon);
+  ROS_ASSERT(altitude);
+  const MappedFile mapped(file);
+  if (mapped.data() == nullptr) {
+    ROS_ERROR_STREAM("Cannot map polygon file " << file);
+    return false;
+  }
+  WordReader reader(mapped.data(), mapped.size());
+  uint64_t magic = 0;
+  uint64_t version = 0;
+  uint64_t num_holes = 0;
+  if (!reader.read(&magic) ||
+      std::memcmp(&magic, kPolygonFileMagic, sizeof(magic)) != 0 ||
+      !reader.read(&version) || version != kPolygonFileVersion) {
+    ROS_ERROR_STREAM("Not a polygon file of version " << kPolygonFileVersion
+                                                      << ": " << file);
+    return false;
+  }
+
+  PolygonWithHoles pwh;
+  if (!reader.read(altitude) || !reader.read(&num_holes) ||
+      !reader.readRing(&pwh.outer_boundary())) {
+    ROS_ERROR_STREAM("Invalid hull in polygon file " << file);
+    return false;
+  }
+  if (pwh.outer_boundary().is_clockwise_oriented()) {
+    pwh.outer_boundary().reverse_orientation();
+  }
+  for (uint64_t i = 0; i < num_holes; ++i) {
+    Polygon_2 hole;
+    if (!reader.readRing(&hole)) {
+      ROS_ERROR_STREAM("Invalid hole " << i << " in polygon file " << file);
+      return false;
+    }
+    if (hole.is_counterclockwise_oriented()) hole.reverse_orientation();
+    pwh.add_hole(std::move(hole));
+  }
+  if (!reader.atEnd()) {
+    ROS_ERROR_STREAM("Trailing data in polygon file " << file);
+    return false;
+  }
+
+  *polygon = std::move(pwh);
+  return true;
+}
+
+}  // namespace polygon_coverage_planning
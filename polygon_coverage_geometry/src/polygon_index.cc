@@ -0,0 +1,425 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "polygon_coverage_geometry/polygon_index.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <initializer_list>
+#include <limits>
+#include <utility>
+
+#include <ros/assert.h>
+
+#include "polygon_coverage_geometry/cgal_comm.h"
+#include "polygon_coverage_geometry/counters.h"
+
+namespace polygon_coverage_planning {
+namespace {
+
+// Bound on the magnitude of grid coordinates. Differences of two coordinates
+// and orientation determinants then fit into 128 bit integers.
+const double kMaxGridCoordinate = 2305843009213693952.0;  // 2^61
+
+// Relative error bound of the floating point orientation determinant with
+// rounded coordinate differences. Shewchuk, J. R. Adaptive precision
+// floating-point arithmetic and fast robust geometric predicates. Discrete &
+// Computational Geometry 18.3 (1997): 305-363.
+const double kRoundoff = 0.5 * std::numeric_limits<double>::epsilon();
+const double kOrientationErrorBound = (3.0 + 16.0 * kRoundoff) * kRoundoff;
+
+// The double value of v if it is exact.
+bool getExactDouble(const FT& v, double* d) {
+  const std::pair<double, double> interval = CGAL::to_interval(v);
+  if (interval.first != interval.second) return false;
+  *d = interval.first;
+  return true;
+}
+
+// The smallest exponent e such that d * 2^e is an integer.
+int getFractionalBits(double d) {
+  ROS_ASSERT(d != 0.0);
+  int exponent = 0;
+  const double mantissa = std::frexp(d, &exponent);
+  // d = m * 2^(exponent - 53) with an integer m of at most 53 bits.
+  int64_t m = static_cast<int64_t>(
+      std::ldexp(mantissa, std::numeric_limits<double>::digits));
+  int bits = std::numeric_limits<double>::digits - exponent;
+  while ((m & 1) == 0) {
+    m >>= 1;
+    --bits;
+  }
+  return bits;
+}
+
+// Lower bound on the distance between a point and any point in a box.
+double computeBboxDistance(const CGAL::Bbox_2& bbox, double x, double y) {
+  const double dx = std::max({bbox.xmin() - x, 0.0, x - bbox.xmax()});
+  const double dy = std::max({bbox.ymin() - y, 0.0, y - bbox.ymax()});
+  return std::sqrt(dx * dx + dy * dy);
+}
+
+}  // namespace
+
+PolygonIndex::PolygonIndex(const PolygonWithHoles& pwh)
+    : num_cols_(1),
+      num_rows_(1),
+      cell_width_(1.0),
+      cell_height_(1.0),
+      has_row_edges_(false),
+      has_integer_grid_(false),
+      grid_exponent_(0) {
+  edges_.insert(edges_.end(), pwh.outer_boundary().edges_begin(),
+                pwh.outer_boundary().edges_end());
+  for (PolygonWithHoles::Hole_const_iterator hit = pwh.holes_begin();
+       hit != pwh.holes_end(); ++hit)
+    edges_.insert(edges_.end(), hit->edges_begin(), hit->edges_end());
+
+  cells_.resize(1);
+  if (edges_.empty()) return;
+
+  edge_bboxes_.reserve(edges_.size());
+  for (const Segment_2& e : edges_) edge_bboxes_.push_back(e.bbox());
+  bbox_ = edge_bboxes_.front();
+  for (const CGAL::Bbox_2& b : edge_bboxes_) bbox_ += b;
+
+  // About one edge per square cell.
+  const double width = bbox_.xmax() - bbox_.xmin();
+  const double height = bbox_.ymax() - bbox_.ymin();
+  const double n = static_cast<double>(edges_.size());
+  if (width > 0.0 && height > 0.0) {
+    num_cols_ = std::min(
+        std::max(static_cast<size_t>(std::ceil(std::sqrt(n * width / height))),
+                 size_t(1)),
+        edges_.size());
+    num_rows_ = std::min(
+        std::max(static_cast<size_t>(std::ceil(std::sqrt(n * height / width))),
+                 size_t(1)),
+        edges_.size());
+  }
+  if (width > 0.0) cell_width_ = width / num_cols_;
+  if (height > 0.0) cell_height_ = height / num_rows_;
+
+  cells_.resize(num_rows_ * num_cols_);
+  for (size_t id = 0; id < edges_.size(); ++id) {
+    const CGAL::Bbox_2& b = edge_bboxes_[id];
+    for (size_t r = getRow(b.ymin()); r <= getRow(b.ymax()); ++r)
+      for (size_t c = getColumn(b.xmin()); c <= getColumn(b.xmax()); ++c)
+        cells_[r * num_cols_ + c].push_back(id);
+  }
+
+  createRowEdges();
+  createIntegerGrid();
+}
+
+void PolygonIndex::createRowEdges() {
+  std::vector<std::array<double, 4>> coordinates(edges_.size());
+  for (size_t id = 0; id < edges_.size(); ++id) {
+    const Segment_2& e = edges_[id];
+    if (!getExactDouble(e.source().x(), &coordinates[id][0]) ||
+        !getExactDouble(e.source().y(), &coordinates[id][1]) ||
+        !getExactDouble(e.target().x(), &coordinates[id][2]) ||
+        !getExactDouble(e.target().y(), &coordinates[id][3]))
+      return;
+  }
+
+  row_offsets_.assign(num_rows_ + 1, 0);
+  for (const CGAL::Bbox_2& b : edge_bboxes_)
+    for (size_t r = getRow(b.ymin()); r <= getRow(b.ymax()); ++r)
+      ++row_offsets_[r + 1];
+  for (size_t r = 0; r < num_rows_; ++r) row_offsets_[r + 1] += row_offsets_[r];
+
+  const size_t num_row_edges = row_offsets_.back();
+  row_source_x_.resize(num_row_edges);
+  row_source_y_.resize(num_row_edges);
+  row_target_x_.resize(num_row_edges);
+  row_target_y_.resize(num_row_edges);
+  std::vector<size_t> next(row_offsets_.begin(), row_offsets_.end() - 1);
+  for (size_t id = 0; id < edges_.size(); ++id) {
+    const CGAL::Bbox_2& b = edge_bboxes_[id];
+    for (size_t r = getRow(b.ymin()); r <= getRow(b.ymax()); ++r) {
+      const size_t i = next[r]++;
+      row_source_x_[i] = coordinates[id][0];
+      row_source_y_[i] = coordinates[id][1];
+      row_target_x_[i] = coordinates[id][2];
+      row_target_y_[i] = coordinates[id][3];
+    }
+  }
+  has_row_edges_ = true;
+}
+
+PolygonIndex::Containment PolygonIndex::classifyPoint(double x,
+                                                      double y) const {
+  ROS_ASSERT(has_row_edges_);
+  if (x < bbox_.xmin() || x > bbox_.xmax() || y < bbox_.ymin() ||
+      y > bbox_.ymax())
+    return Containment::kOutside;
+
+  // Same ray crossing rules as containsPoint. The loop is branch free over
+  // the row arrays so that the compiler can vectorize it. Edges left of the
+  // point do not pass the orientation test, so the whole row is scanned.
+  const size_t row = getRow(y);
+  const double* source_x = row_source_x_.data();
+  const double* source_y = row_source_y_.data();
+  const double* target_x = row_target_x_.data();
+  const double* target_y = row_target_y_.data();
+  unsigned int crossings = 0;
+  unsigned int uncertain = 0;
+  for (size_t i = row_offsets_[row]; i < row_offsets_[row + 1]; ++i) {
+    const double left = (target_x[i] - source_x[i]) * (y - source_y[i]);
+    const double right = (target_y[i] - source_y[i]) * (x - source_x[i]);
+    const double orientation = left - right;
+    // The absolute term covers underflow of the products.
+    const double error =
+        kOrientationErrorBound * (std::abs(left) + std::abs(right)) +
+        std::numeric_limits<double>::min();
+    const unsigned int source_above = source_y[i] > y;
+    const unsigned int target_above = target_y[i] > y;
+    const unsigned int straddles = source_above ^ target_above;
+    const unsigned int touches =
+        (std::min(source_x[i], target_x[i]) <= x) &
+        (x <= std::max(source_x[i], target_x[i])) &
+        (std::min(source_y[i], target_y[i]) <= y) &
+        (y <= std::max(source_y[i], target_y[i]));
+    const unsigned int left_turn = orientation > error;
+    const unsigned int right_turn = orientation < -error;
+    crossings +=
+        straddles & ((target_above & left_turn) | (source_above & right_turn));
+    uncertain |= (straddles | touches) & (1u ^ (left_turn | right_turn));
+  }
+  if (uncertain) return Containment::kUncertain;
+  return (crossings & 1u) ? Containment::kInside : Containment::kOutside;
+}
+
+void PolygonIndex::createIntegerGrid() {
+#ifdef __SIZEOF_INT128__
+  // The finest grid of all exact vertex coordinates.
+  bool has_exponent = false;
+  for (const Segment_2& e : edges_) {
+    for (const FT& v : {e.source().x(), e.source().y()}) {
+      double d = 0.0;
+      if (!getExactDouble(v, &d)) return;
+      if (d == 0.0) continue;
+      const int bits = getFractionalBits(d);
+      grid_exponent_ = has_exponent ? std::max(grid_exponent_, bits) : bits;
+      has_exponent = true;
+    }
+  }
+
+  grid_edges_.resize(edges_.size());
+  for (size_t id = 0; id < edges_.size(); ++id) {
+    GridEdge& grid_edge = grid_edges_[id];
+    if (!toGridCoordinate(edges_[id].source().x(), &grid_edge.source_x) ||
+        !toGridCoordinate(edges_[id].source().y(), &grid_edge.source_y) ||
+        !toGridCoordinate(edges_[id].target().x(), &grid_edge.target_x) ||
+        !toGridCoordinate(edges_[id].target().y(), &grid_edge.target_y)) {
+      grid_edges_.clear();
+      return;
+    }
+  }
+  has_integer_grid_ = true;
+#endif
+}
+
+bool PolygonIndex::toGridCoordinate(const FT& v, int64_t* k) const {
+  ROS_ASSERT(k);
+  double d = 0.0;
+  if (!getExactDouble(v, &d)) return false;
+  const double scaled = std::ldexp(d, grid_exponent_);
+  if (!(std::abs(scaled) <= kMaxGridCoordinate) ||
+      scaled != std::floor(scaled))
+    return false;
+  *k = static_cast<int64_t>(scaled);
+  return true;
+}
+
+bool PolygonIndex::containsGridPoint(const std::vector<size_t>& candidates,
+                                     int64_t x, int64_t y) const {
+#ifdef __SIZEOF_INT128__
+  // Same ray crossing rules as containsPoint.
+  bool inside = false;
+  for (size_t id : candidates) {
+    const GridEdge& e = grid_edges_[id];
+    const __int128 orientation =
+        static_cast<__int128>(e.target_x - e.source_x) * (y - e.source_y) -
+        static_cast<__int128>(e.target_y - e.source_y) * (x - e.source_x);
+    if (orientation == 0 && std::min(e.source_x, e.target_x) <= x &&
+        x <= std::max(e.source_x, e.target_x) &&
+        std::min(e.source_y, e.target_y) <= y &&
+        y <= std::max(e.source_y, e.target_y))
+      return true;
+    const bool source_above = e.source_y > y;
+    const bool target_above = e.target_y > y;
+    if (source_above == target_above) continue;
+    if (target_above ? orientation > 0 : orientation < 0) inside = !inside;
+  }
+  return inside;
+#else
+  ROS_ASSERT_MSG(false, "Integer grid requires 128 bit integers.");
+  return false;
+#endif
+}
+
+size_t PolygonIndex::getColumn(double x) const {
+  const double col = (x - bbox_.xmin()) / cell_width_;
+  if (!(col > 0.0)) return 0;
+  if (col >= static_cast<double>(num_cols_)) return num_cols_ - 1;
+  return static_cast<size_t>(col);
+}
+
+size_t PolygonIndex::getRow(double y) const {
+  const double row = (y - bbox_.ymin()) / cell_height_;
+  if (!(row > 0.0)) return 0;
+  if (row >= static_cast<double>(num_rows_)) return num_rows_ - 1;
+  return static_cast<size_t>(row);
+}
+
+bool PolygonIndex::containsPoint(const Point_2& p) const {
+  counters::Counters::Increment(counters::kPointInPolygon);
+  if (edges_.empty()) return false;
+  const CGAL::Bbox_2 p_bbox = p.bbox();
+  if (!CGAL::do_overlap(p_bbox, bbox_)) return false;
+
+  // Only edges in the cells right of p can cross the horizontal ray from p.
+  std::vector<size_t> candidates;
+  for (size_t r = getRow(p_bbox.ymin()); r <= getRow(p_bbox.ymax()); ++r) {
+    for (size_t c = getColumn(p_bbox.xmin()); c < num_cols_; ++c) {
+      const std::vector<size_t>& cell = getCell(r, c);
+      candidates.insert(candidates.end(), cell.begin(), cell.end());
+    }
+  }
+  std::sort(candidates.begin(), candidates.end());
+  candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                   candidates.end());
+
+  int64_t x = 0, y = 0;
+  if (has_integer_grid_ && toGridCoordinate(p.x(), &x) &&
+      toGridCoordinate(p.y(), &y))
+    return containsGridPoint(candidates, x, y);
+
+  // Count the ray crossings. Holes lie inside the outer boundary, so the
+  // parity over all edges decides containment.
+  bool inside = false;
+  for (size_t id : candidates) {
+    const Segment_2& e = edges_[id];
+    if (CGAL::do_overlap(edge_bboxes_[id], p_bbox) && e.has_on(p)) return true;
+    // Half-open rule: vertices on the ray count for the edge above them.
+    const bool source_above = e.source().y() > p.y();
+    const bool target_above = e.target().y() > p.y();
+    if (source_above == target_above) continue;
+    const CGAL::Orientation orientation =
+        CGAL::orientation(e.source(), e.target(), p);
+    if (orientation == (target_above ? CGAL::LEFT_TURN : CGAL::RIGHT_TURN))
+      inside = !inside;
+  }
+  return inside;
+}
+
+bool PolygonIndex::containsPoints(const std::vector<Point_2>& points,
+                                  std::vector<bool>* inside) const {
+  if (inside) inside->assign(points.size(), false);
+  bool all_inside = true;
+  for (size_t i = 0; i < points.size(); ++i) {
+    double x = 0.0, y = 0.0;
+    Containment containment = Containment::kUncertain;
+    if (has_row_edges_ && getExactDouble(points[i].x(), &x) &&
+        getExactDouble(points[i].y(), &y))
+      containment = classifyPoint(x, y);
+    bool contained = false;
+    if (containment == Containment::kUncertain) {
+      contained = containsPoint(points[i]);
+    } else {
+      counters::Counters::Increment(counters::kPointInPolygon);
+      contained = containment == Containment::kInside;
+    }
+    if (inside) {
+      (*inside)[i] = contained;
+    } else if (!contained) {
+      return false;
+    }
+    all_inside = all_inside && contained;
+  }
+  return all_inside;
+}
+
+Point_2 PolygonIndex::projectOnHull(const Point_2& p) const {
+  ROS_ASSERT(!edges_.empty());
+  const double x = CGAL::to_double(p.x());
+  const double y = CGAL::to_double(p.y());
+  // Margin on the floating point distance bounds.
+  const double slack =
+      1e-9 * (bbox_.xmax() - bbox_.xmin() + bbox_.ymax() - bbox_.ymin() +
+              std::abs(x) + std::abs(y));
+
+  // Ties go to the lowest edge id as in projectPointOnHull.
+  size_t best_id = edges_.size();
+  FT best_squared_distance = 0.0;
+  double best_distance = std::numeric_limits<double>::infinity();
+  auto visit = [&](size_t r, size_t c) {
+    for (size_t id : getCell(r, c)) {
+      if (computeBboxDistance(edge_bboxes_[id], x, y) >
+          best_distance * (1.0 + 1e-9) + slack)
+        continue;
+      const FT d = CGAL::squared_distance(edges_[id], p);
+      if (best_id == edges_.size() || d < best_squared_distance ||
+          (d == best_squared_distance && id < best_id)) {
+        best_id = id;
+        best_squared_distance = d;
+        best_distance = std::sqrt(CGAL::to_double(d));
+      }
+    }
+  };
+
+  // Visit rings of cells around p until no closer edge can be left.
+  const size_t row = getRow(y);
+  const size_t col = getColumn(x);
+  for (size_t ring = 0;; ++ring) {
+    const size_t r0 = row >= ring ? row - ring : 0;
+    const size_t r1 = std::min(row + ring, num_rows_ - 1);
+    const size_t c0 = col >= ring ? col - ring : 0;
+    const size_t c1 = std::min(col + ring, num_cols_ - 1);
+    for (size_t r = r0; r <= r1; ++r) {
+      if (r + ring == row || r == row + ring) {
+        for (size_t c = c0; c <= c1; ++c) visit(r, c);
+      } else {
+        if (col >= ring) visit(r, col - ring);
+        if (ring > 0 && col + ring < num_cols_) visit(r, col + ring);
+      }
+    }
+
+    // Distance to the closest cell outside the visited block.
+    double bound = std::numeric_limits<double>::infinity();
+    if (c0 > 0) bound = std::min(bound, x - (bbox_.xmin() + c0 * cell_width_));
+    if (c1 + 1 < num_cols_)
+      bound = std::min(bound, bbox_.xmin() + (c1 + 1) * cell_width_ - x);
+    if (r0 > 0)
+      bound = std::min(bound, y - (bbox_.ymin() + r0 * cell_height_));
+    if (r1 + 1 < num_rows_)
+      bound = std::min(bound, bbox_.ymin() + (r1 + 1) * cell_height_ - y);
+    if (std::isinf(bound)) break;  // Visited all cells.
+    if (best_id < edges_.size() &&
+        bound > best_distance * (1.0 + 1e-9) + slack)
+      break;
+  }
+
+  return projectOnSegment2(edges_[best_id], p);
+}
+
+}  // namespace polygon_coverage_planning
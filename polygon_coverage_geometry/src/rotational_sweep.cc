@@ -0,0 +1,271 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "polygon_coverage_geometry/rotational_sweep.h"
+
+#include <algorithm>
+#include <set>
+
+#include <CGAL/intersections.h>
+#include <ros/assert.h>
+
+namespace polygon_coverage_planning {
+namespace {
+
+// A polygon vertex with its neighbors along the boundary. The polygon interior
+// is to the left of prev -> vertex -> next. Edge i is (i, next).
+struct BoundaryVertex {
+  Point_2 point;
+  size_t prev;
+  size_t next;
+};
+
+std::vector<BoundaryVertex> getBoundaryVertices(const PolygonWithHoles& pwh) {
+  std::vector<BoundaryVertex> vertices;
+  auto add = [&vertices](const Polygon_2& poly) {
+    const size_t offset = vertices.size();
+    const size_t n = poly.size();
+    for (size_t i = 0; i < n; ++i) {
+      vertices.push_back(
+          {poly[i], offset + (i + n - 1) % n, offset + (i + 1) % n});
+    }
+  };
+  add(pwh.outer_boundary());
+  for (PolygonWithHoles::Hole_const_iterator hit = pwh.holes_begin();
+       hit != pwh.holes_end(); ++hit)
+    add(*hit);
+  return vertices;
+}
+
+// Whether direction d points into the closed interior at vertex v.
+bool pointsInside(const std::vector<BoundaryVertex>& vertices, size_t v,
+                  const Vector_2& d) {
+  const Point_2& p = vertices[v].point;
+  const Point_2& prev = vertices[vertices[v].prev].point;
+  const Point_2& next = vertices[vertices[v].next].point;
+  const Vector_2 to_prev = prev - p;
+  const Vector_2 to_next = next - p;
+  switch (CGAL::orientation(prev, p, next)) {
+    case CGAL::LEFT_TURN:  // Convex: interior from to_next to to_prev.
+      return CGAL::orientation(to_next, d) != CGAL::RIGHT_TURN &&
+             CGAL::orientation(d, to_prev) != CGAL::RIGHT_TURN;
+    case CGAL::RIGHT_TURN:  // Reflex: exterior from to_prev to to_next.
+      return CGAL::orientation(to_prev, d) != CGAL::LEFT_TURN ||
+             CGAL::orientation(d, to_next) != CGAL::LEFT_TURN;
+    default:  // Straight: interior left of to_next.
+      return CGAL::orientation(to_next, d) != CGAL::RIGHT_TURN;
+  }
+}
+
+// Counter-clockwise angle order around the source starting at the positive x
+// axis. Points on the same ray are ordered by distance.
+class AngleLess {
+ public:
+  explicit AngleLess(const Point_2& source) : source_(source) {}
+
+  bool operator()(const Point_2& a, const Point_2& b) const {
+    const Vector_2 da = a - source_;
+    const Vector_2 db = b - source_;
+    const int half_a = getHalf(da);
+    const int half_b = getHalf(db);
+    if (half_a != half_b) return half_a < half_b;
+    const CGAL::Orientation orientation = CGAL::orientation(da, db);
+    if (orientation != CGAL::COLLINEAR) return orientation == CGAL::LEFT_TURN;
+    return da.squared_length() < db.squared_length();
+  }
+
+  bool isSameRay(const Point_2& a, const Point_2& b) const {
+    const Vector_2 da = a - source_;
+    const Vector_2 db = b - source_;
+    return getHalf(da) == getHalf(db) &&
+           CGAL::orientation(da, db) == CGAL::COLLINEAR;
+  }
+
+ private:
+  // 0: angle in [0, pi), 1: angle in [pi, 2 pi).
+  static int getHalf(const Vector_2& d) {
+    return (d.y() > 0 || (d.y() == 0 && d.x() > 0)) ? 0 : 1;
+  }
+
+  const Point_2 source_;
+};
+
+// Orders the edges crossed by the current sweep ray by their distance along
+// the ray. Edges never cross, so the order stays valid while the ray rotates.
+class RayDistanceLess {
+ public:
+  RayDistanceLess(const std::vector<BoundaryVertex>& vertices,
+                  const Point_2& source, const Point_2* ray_point)
+      : vertices_(vertices), source_(source), ray_point_(ray_point) {}
+
+  bool operator()(size_t e1, size_t e2) const {
+    if (e1 == e2) return false;
+    const FT d1 = computeSquaredDistance(e1);
+    const FT d2 = computeSquaredDistance(e2);
+    if (d1 != d2) return d1 < d2;
+
+    // Both edges start on the ray at their shared vertex. The first edge is
+    // closer if it separates the source from the second edge.
+    const size_t shared =
+        (e1 == vertices_[e2].next) ? e1 : vertices_[e1].next;
+    const Point_2& s = vertices_[shared].point;
+    const Point_2& a = vertices_[getOther(e1, shared)].point;
+    const Point_2& b = vertices_[getOther(e2, shared)].point;
+    return CGAL::orientation(s, a, source_) != CGAL::orientation(s, a, b);
+  }
+
+  // The squared distance from the source to the edge along the ray.
+  FT computeSquaredDistance(size_t e) const {
+    const Point_2& a = vertices_[e].point;
+    const Point_2& b = vertices_[vertices_[e].next].point;
+    if (CGAL::collinear(source_, *ray_point_, a))
+      return CGAL::squared_distance(source_, a);
+    if (CGAL::collinear(source_, *ray_point_, b))
+      return CGAL::squared_distance(source_, b);
+    auto result = CGAL::intersection(Line_2(source_, *ray_point_),
+                                     Line_2(a, b));
+    ROS_ASSERT(result);
+    const Point_2* intersection = boost::get<Point_2>(&*result);
+    ROS_ASSERT(intersection);
+    return CGAL::squared_distance(source_, *intersection);
+  }
+
+ private:
+  size_t getOther(size_t e, size_t v) const {
+    return e == v ? vertices_[e].next : e;
+  }
+
+  const std::vector<BoundaryVertex>& vertices_;
+  const Point_2 source_;
+  const Point_2* ray_point_;
+};
+
+// Whether the edge (a, b) crosses the ray from source through ray_point in its
+// interior.
+bool crossesRay(const Point_2& source, const Point_2& ray_point,
+                const Point_2& a, const Point_2& b) {
+  const CGAL::Orientation side_a = CGAL::orientation(source, ray_point, a);
+  const CGAL::Orientation side_b = CGAL::orientation(source, ray_point, b);
+  if (side_a == CGAL::COLLINEAR || side_b == CGAL::COLLINEAR ||
+      side_a == side_b)
+    return false;
+  // The source is left of the edge directed from its right to its left end.
+  return side_a == CGAL::RIGHT_TURN
+             ? CGAL::orientation(a, b, source) == CGAL::LEFT_TURN
+             : CGAL::orientation(b, a, source) == CGAL::LEFT_TURN;
+}
+
+}  // namespace
+
+std::vector<bool> computeVisibleVertices(const PolygonWithHoles& pwh,
+                                         size_t source) {
+  const std::vector<BoundaryVertex> vertices = getBoundaryVertices(pwh);
+  std::vector<bool> visible(vertices.size(), false);
+  ROS_ASSERT(source < vertices.size());
+  const Point_2& p = vertices[source].point;
+
+  // Sweep events.
+  std::vector<size_t> events;
+  events.reserve(vertices.size());
+  for (size_t i = 0; i < vertices.size(); ++i) {
+    if (i != source) events.push_back(i);
+  }
+  if (events.empty()) return visible;
+  const AngleLess angle_less(p);
+  std::sort(events.begin(), events.end(), [&](size_t a, size_t b) {
+    return angle_less(vertices[a].point, vertices[b].point);
+  });
+
+  // The edges incident to the source never block.
+  auto isIncidentToSource = [&](size_t e) {
+    return e == source || vertices[e].next == source;
+  };
+
+  // Edges crossed by the current ray ordered by their distance.
+  Point_2 ray_point = vertices[events.front()].point;
+  typedef std::set<size_t, RayDistanceLess> ActiveEdges;
+  ActiveEdges active(RayDistanceLess(vertices, p, &ray_point));
+  std::vector<ActiveEdges::iterator> handles(vertices.size(), active.end());
+  for (size_t e = 0; e < vertices.size(); ++e) {
+    if (!isIncidentToSource(e) &&
+        crossesRay(p, ray_point, vertices[e].point,
+                   vertices[vertices[e].next].point)) {
+      handles[e] = active.insert(e).first;
+    }
+  }
+
+  for (size_t begin = 0; begin < events.size();) {
+    size_t end = begin + 1;
+    while (end < events.size() &&
+           angle_less.isSameRay(vertices[events[begin]].point,
+                                vertices[events[end]].point)) {
+      ++end;
+    }
+    ray_point = vertices[events[begin]].point;
+
+    // Visit the edges that end or start on the ray. side is the side of their
+    // other vertex.
+    auto forEachEventEdge = [&](CGAL::Orientation side, auto visit) {
+      for (size_t i = begin; i < end; ++i) {
+        const size_t w = events[i];
+        for (size_t e : {w, vertices[w].prev}) {
+          if (isIncidentToSource(e)) continue;
+          const size_t other = e == w ? vertices[w].next : e;
+          if (CGAL::orientation(p, ray_point, vertices[other].point) == side)
+            visit(e);
+        }
+      }
+    };
+
+    // Remove the edges that end on the ray.
+    forEachEventEdge(CGAL::RIGHT_TURN, [&](size_t e) {
+      if (handles[e] != active.end()) {
+        active.erase(handles[e]);
+        handles[e] = active.end();
+      }
+    });
+
+    // Walk along the ray until it leaves the polygon.
+    const Vector_2 d = ray_point - p;
+    bool inside = pointsInside(vertices, source, d);
+    const bool is_blocked = !active.empty();
+    const FT sq_blocker_distance =
+        is_blocked ? active.key_comp().computeSquaredDistance(*active.begin())
+                   : FT(0);
+    for (size_t i = begin; i < end && inside; ++i) {
+      const size_t w = events[i];
+      if (is_blocked &&
+          CGAL::squared_distance(p, vertices[w].point) >= sq_blocker_distance)
+        break;
+      visible[w] = true;
+      inside = pointsInside(vertices, w, d);
+    }
+
+    // Insert the edges that start on the ray.
+    forEachEventEdge(CGAL::LEFT_TURN, [&](size_t e) {
+      if (handles[e] == active.end()) handles[e] = active.insert(e).first;
+    });
+
+    begin = end;
+  }
+
+  return visible;
+}
+
+}  // namespace polygon_coverage_planning
@@ -0,0 +1,72 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "polygon_coverage_geometry/shortest_path_cache.h"
+
+#include <algorithm>
+
+#include <ros/assert.h>
+
+namespace polygon_coverage_planning {
+namespace visibility_graph {
+
+bool ShortestPathCache::find(const Point_2& start, const Point_2& goal,
+                             std::vector<Point_2>* path) const {
+  ROS_ASSERT(path);
+  const bool is_reversed = goal < start;
+  const Key key = is_reversed ? Key(goal, start) : Key(start, goal);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto it = paths_.find(key);
+  if (it == paths_.end()) {
+    return false;
+  }
+  if (is_reversed) {
+    path->assign(it->second.rbegin(), it->second.rend());
+  } else {
+    *path = it->second;
+  }
+  return true;
+}
+
+void ShortestPathCache::insert(const Point_2& start, const Point_2& goal,
+                               const std::vector<Point_2>& path) {
+  const bool is_reversed = goal < start;
+  const Key key = is_reversed ? Key(goal, start) : Key(start, goal);
+  std::vector<Point_2> value = path;
+  if (is_reversed) {
+    std::reverse(value.begin(), value.end());
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  paths_.emplace(key, std::move(value));
+}
+
+size_t ShortestPathCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return paths_.size();
+}
+
+void ShortestPathCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  paths_.clear();
+}
+
+}  // namespace visibility_graph
+}  // namespace polygon_coverage_planning
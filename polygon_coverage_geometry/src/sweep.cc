@@ -17,10 +17,17 @@
  * this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "polygon_coverage_geometry/cgal_comm.h"
+#include "polygon_coverage_geometry/counters.h"
 #include "polygon_coverage_geometry/sweep.h"
 #include "polygon_coverage_geometry/visibility_polygon.h"
 #include "polygon_coverage_geometry/weakly_monotone.h"
 
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include <polygon_coverage_solvers/parallel.h>
 #include <ros/assert.h>
 #include <ros/console.h>
 
@@ -32,6 +39,17 @@ bool computeSweep(const Polygon_2& in,
                   bool counter_clockwise, std::vector<Point_2>* waypoints) {
   ROS_ASSERT(waypoints);
   waypoints->clear();
+
+  std::vector<Segment_2> lanes;
+  return computeSweepLanes(in, offset, dir, &lanes) &&
+         connectSweepLanes(visibility_graph, lanes, counter_clockwise,
+                           waypoints);
+}
+
+bool computeSweepLanes(const Polygon_2& in, const FT offset,
+                       const Direction_2& dir, std::vector<Segment_2>* lanes) {
+  ROS_ASSERT(lanes);
+  lanes->clear();
   const FT kSqOffset = offset * offset;
 
   // Assertions.
@@ -48,41 +66,23 @@ bool computeSweep(const Polygon_2& in,
                   std::sqrt(CGAL::to_double(offset_vector.squared_length()));
   const CGAL::Aff_transformation_2<K> kOffset(CGAL::TRANSLATION, offset_vector);
 
+  SweepLineIntersector intersector(in, dir);
   Segment_2 sweep_segment;
-  bool has_sweep_segment = findSweepSegment(in, sweep, &sweep_segment);
+  bool has_sweep_segment = intersector.findSweepSegment(sweep, &sweep_segment);
   while (has_sweep_segment) {
-    // Align sweep segment.
-    if (counter_clockwise) sweep_segment = sweep_segment.opposite();
-    // Connect previous sweep.
-    if (!waypoints->empty()) {
-      std::vector<Point_2> shortest_path;
-      if (!calculateShortestPath(visibility_graph, waypoints->back(),
-                                 sweep_segment.source(), &shortest_path))
-        return false;
-      for (std::vector<Point_2>::iterator it = std::next(shortest_path.begin());
-           it != std::prev(shortest_path.end()); ++it) {
-        waypoints->push_back(*it);
-      }
-    }
-    // Traverse sweep.
-    waypoints->push_back(sweep_segment.source());
-    if (!sweep_segment.is_degenerate())
-      waypoints->push_back(sweep_segment.target());
+    lanes->push_back(sweep_segment);
 
     // Offset sweep.
     sweep = sweep.transform(kOffset);
     // Find new sweep segment.
-    Segment_2 prev_sweep_segment =
-        counter_clockwise ? sweep_segment.opposite() : sweep_segment;
-    has_sweep_segment = findSweepSegment(in, sweep, &sweep_segment);
+    const Segment_2 prev_sweep_segment = sweep_segment;
+    has_sweep_segment = intersector.findSweepSegment(sweep, &sweep_segment);
     // Add a final sweep.
     if (!has_sweep_segment &&
-        !((!waypoints->empty() &&
-           *std::prev(waypoints->end(), 1) == sorted_pts.back()) ||
-          (waypoints->size() > 1 &&
-           *std::prev(waypoints->end(), 2) == sorted_pts.back()))) {
+        prev_sweep_segment.source() != sorted_pts.back() &&
+        prev_sweep_segment.target() != sorted_pts.back()) {
       sweep = Line_2(sorted_pts.back(), dir);
-      has_sweep_segment = findSweepSegment(in, sweep, &sweep_segment);
+      has_sweep_segment = intersector.findSweepSegment(sweep, &sweep_segment);
       if (!has_sweep_segment) {
         ROS_ERROR_STREAM("Failed to calculate final sweep.");
         return false;
@@ -99,7 +99,8 @@ bool computeSweep(const Polygon_2& in,
                          kSqOffset, &unobservable_point);
       if (unobservable_point != sorted_pts.end()) {
         sweep = Line_2(*unobservable_point, dir);
-        has_sweep_segment = findSweepSegment(in, sweep, &sweep_segment);
+        has_sweep_segment =
+            intersector.findSweepSegment(sweep, &sweep_segment);
         if (!has_sweep_segment) {
           ROS_ERROR_STREAM("Failed to calculate extra sweep at point: "
                            << *unobservable_point);
@@ -107,6 +108,37 @@ bool computeSweep(const Polygon_2& in,
         }
       }
     }
+  }
+
+  return true;
+}
+
+bool connectSweepLanes(
+    const visibility_graph::VisibilityGraph& visibility_graph,
+    const std::vector<Segment_2>& lanes, bool counter_clockwise,
+    std::vector<Point_2>* waypoints) {
+  ROS_ASSERT(waypoints);
+  waypoints->clear();
+
+  waypoints->reserve(2 * lanes.size());
+  std::vector<Point_2> shortest_path;
+  for (Segment_2 sweep_segment : lanes) {
+    // Align sweep segment.
+    if (counter_clockwise) sweep_segment = sweep_segment.opposite();
+    // Connect previous sweep.
+    if (!waypoints->empty()) {
+      if (!calculateShortestPath(visibility_graph, waypoints->back(),
+                                 sweep_segment.source(), &shortest_path))
+        return false;
+      for (std::vector<Point_2>::iterator it = std::next(shortest_path.begin());
+           it != std::prev(shortest_path.end()); ++it) {
+        waypoints->push_back(*it);
+      }
+    }
+    // Traverse sweep.
+    waypoints->push_back(sweep_segment.source());
+    if (!sweep_segment.is_degenerate())
+      waypoints->push_back(sweep_segment.target());
 
     // Swap directions.
     counter_clockwise = !counter_clockwise;
@@ -115,14 +147,205 @@ bool computeSweep(const Polygon_2& in,
   return true;
 }
 
+namespace {
+enum class InexactResult { kFound, kNotFound, kUncertain };
+
+// Find the edges with the first and the last intersection along the line
+// using double arithmetic. Certain if no vertex is near the line and no two
+// crossings are near each other.
+InexactResult findSweepSegmentEdges(const Polygon_2& p, const Line_2& l,
+                                    size_t* first_edge, size_t* last_edge) {
+  ROS_ASSERT(first_edge);
+  ROS_ASSERT(last_edge);
+  const double a = CGAL::to_double(l.a());
+  const double b = CGAL::to_double(l.b());
+  const double c = CGAL::to_double(l.c());
+  const double norm = std::sqrt(a * a + b * b);
+  if (p.size() < 3 || norm == 0.0) {
+    return InexactResult::kUncertain;
+  }
+
+  std::vector<double> x(p.size()), y(p.size()), d(p.size());
+  double scale = std::abs(c) / norm;
+  for (size_t i = 0; i < p.size(); ++i) {
+    x[i] = CGAL::to_double(p[i].x());
+    y[i] = CGAL::to_double(p[i].y());
+    d[i] = (a * x[i] + b * y[i] + c) / norm;
+    scale = std::max({scale, std::abs(x[i]), std::abs(y[i])});
+  }
+  const double kRelativeTolerance = 1.0e-9;
+  const double tolerance = kRelativeTolerance * (scale + 1.0);
+
+  // Position of the crossings along the line direction (b, -a).
+  double min_t = 0.0, second_min_t = 0.0, max_t = 0.0, second_max_t = 0.0;
+  size_t num_crossings = 0;
+  for (size_t i = 0; i < p.size(); ++i) {
+    const size_t j = (i + 1) % p.size();
+    if (std::abs(d[i]) <= tolerance) {
+      return InexactResult::kUncertain;
+    }
+    if ((d[i] < 0.0) == (d[j] < 0.0)) {
+      continue;
+    }
+    const double s = d[i] / (d[i] - d[j]);
+    const double t = (b * (x[i] + s * (x[j] - x[i])) -
+                      a * (y[i] + s * (y[j] - y[i]))) /
+                     norm;
+    if (num_crossings == 0 || t < min_t) {
+      second_min_t = min_t;
+      min_t = t;
+      *first_edge = i;
+    } else if (num_crossings == 1 || t < second_min_t) {
+      second_min_t = t;
+    }
+    if (num_crossings == 0 || t > max_t) {
+      second_max_t = max_t;
+      max_t = t;
+      *last_edge = i;
+    } else if (num_crossings == 1 || t > second_max_t) {
+      second_max_t = t;
+    }
+    ++num_crossings;
+  }
+
+  if (num_crossings == 0) {
+    return InexactResult::kNotFound;
+  }
+  if (num_crossings < 2 || second_min_t - min_t <= tolerance ||
+      max_t - second_max_t <= tolerance) {
+    return InexactResult::kUncertain;
+  }
+  return InexactResult::kFound;
+}
+}  // namespace
+
 bool findSweepSegment(const Polygon_2& p, const Line_2& l,
                       Segment_2* sweep_segment) {
+  ROS_ASSERT(sweep_segment);
+  // Fast path: only construct the first and last intersection exactly.
+  size_t first_edge = 0, last_edge = 0;
+  switch (findSweepSegmentEdges(p, l, &first_edge, &last_edge)) {
+    case InexactResult::kNotFound:
+      counters::Counters::Increment(counters::kLinePolygonIntersections);
+      return false;
+    case InexactResult::kFound: {
+      auto first = CGAL::intersection(p.edge(first_edge), l);
+      auto last = CGAL::intersection(p.edge(last_edge), l);
+      counters::Counters::Increment(counters::kEdgeIntersections, 2);
+      const Point_2* first_point =
+          first ? boost::get<Point_2>(&*first) : nullptr;
+      const Point_2* last_point = last ? boost::get<Point_2>(&*last) : nullptr;
+      if (first_point != nullptr && last_point != nullptr) {
+        // Order exactly like findIntersections.
+        const Line_2 perp_l = l.perpendicular(l.point(0));
+        if (CGAL::has_smaller_signed_distance_to_line(perp_l, *last_point,
+                                                      *first_point)) {
+          std::swap(first_point, last_point);
+        }
+        *sweep_segment = Segment_2(*first_point, *last_point);
+        counters::Counters::Increment(counters::kLinePolygonIntersections);
+        return true;
+      }
+      break;
+    }
+    case InexactResult::kUncertain:
+    default:
+      break;
+  }
+
+  // Exact fallback. Counts the line query.
+  counters::Counters::Increment(counters::kExactFallbacks);
   std::vector<Point_2> intersections = findIntersections(p, l);
   if (intersections.empty()) return false;
   *sweep_segment = Segment_2(intersections.front(), intersections.back());
   return true;
 }
 
+SweepLineIntersector::SweepLineIntersector(const Polygon_2& p,
+                                           const Direction_2& dir)
+    : polygon_(p),
+      normal_(-dir.dy(), dir.dx()),
+      next_edge_(0),
+      has_query_(false) {
+  min_offsets_.reserve(polygon_.size());
+  max_offsets_.reserve(polygon_.size());
+  for (size_t i = 0; i < polygon_.size(); ++i) {
+    const FT source = computeOffset(polygon_.edge(i).source());
+    const FT target = computeOffset(polygon_.edge(i).target());
+    min_offsets_.push_back(CGAL::min(source, target));
+    max_offsets_.push_back(CGAL::max(source, target));
+  }
+  sorted_edges_.resize(polygon_.size());
+  std::iota(sorted_edges_.begin(), sorted_edges_.end(), 0);
+  std::sort(sorted_edges_.begin(), sorted_edges_.end(),
+            [this](size_t a, size_t b) {
+              return min_offsets_[a] < min_offsets_[b];
+            });
+}
+
+bool SweepLineIntersector::findSweepSegment(const Line_2& l,
+                                            Segment_2* sweep_segment) {
+  ROS_ASSERT(sweep_segment);
+  const FT offset = computeOffset(l.point(0));
+  ROS_ASSERT(normal_ * l.to_vector() == 0);
+
+  // Restart if the line is behind the retained edges.
+  if (has_query_ && offset < floor_offset_) {
+    next_edge_ = 0;
+    active_edges_.clear();
+    has_query_ = false;
+  }
+  // Retain the edges of the previous line to allow stepping back to it.
+  floor_offset_ = has_query_ ? CGAL::min(last_offset_, offset) : offset;
+  last_offset_ = offset;
+  has_query_ = true;
+
+  // Advance.
+  while (next_edge_ < sorted_edges_.size() &&
+         min_offsets_[sorted_edges_[next_edge_]] <= offset) {
+    active_edges_.push_back(sorted_edges_[next_edge_++]);
+  }
+  active_edges_.erase(std::remove_if(active_edges_.begin(), active_edges_.end(),
+                                     [this](size_t e) {
+                                       return max_offsets_[e] < floor_offset_;
+                                     }),
+                      active_edges_.end());
+
+  // Intersect the spanning edges.
+  counters::Counters::Increment(counters::kLinePolygonIntersections);
+  std::vector<Point_2>& intersections = intersections_;
+  intersections.clear();
+  for (size_t e : active_edges_) {
+    if (min_offsets_[e] > offset || max_offsets_[e] < offset) {
+      continue;
+    }
+    counters::Counters::Increment(counters::kEdgeIntersections);
+    auto result = CGAL::intersection(polygon_.edge(e), l);
+    if (!result) {
+      continue;
+    }
+    if (const Segment_2* segment = boost::get<Segment_2>(&*result)) {
+      intersections.push_back(segment->source());
+      intersections.push_back(segment->target());
+    } else {
+      intersections.push_back(*boost::get<Point_2>(&*result));
+    }
+  }
+  if (intersections.empty()) {
+    return false;
+  }
+
+  // Order exactly like findIntersections.
+  const Line_2 perp_l = l.perpendicular(l.point(0));
+  const auto minmax = std::minmax_element(
+      intersections.begin(), intersections.end(),
+      [&perp_l](const Point_2& a, const Point_2& b) {
+        return CGAL::has_smaller_signed_distance_to_line(perp_l, a, b);
+      });
+  *sweep_segment = Segment_2(*minmax.first, *minmax.second);
+  return true;
+}
+
 void checkObservability(
     const Segment_2& prev_sweep, const Segment_2& sweep,
     const std::vector<Point_2>& sorted_pts, const FT max_sq_distance,
@@ -148,7 +371,8 @@ void checkObservability(
 }
 
 bool computeAllSweeps(const Polygon_2& poly, const double max_sweep_offset,
-                      std::vector<std::vector<Point_2>>* cluster_sweeps) {
+                      std::vector<std::vector<Point_2>>* cluster_sweeps,
+                      size_t num_threads) {
   ROS_ASSERT(cluster_sweeps);
   cluster_sweeps->clear();
   cluster_sweeps->reserve(2 * poly.size());
@@ -156,31 +380,40 @@ bool computeAllSweeps(const Polygon_2& poly, const double max_sweep_offset,
   // Find all sweepable directions.
   std::vector<Direction_2> dirs = getAllSweepableEdgeDirections(poly);
 
-  // Compute all possible sweeps.
+  // Compute all possible sweeps. The lanes of a direction are shared by its
+  // four sweeps.
   visibility_graph::VisibilityGraph vis_graph(poly);
-  for (const Direction_2& dir : dirs) {
-    bool counter_clockwise = true;
-    std::vector<Point_2> sweep;
-    if (!computeSweep(poly, vis_graph, max_sweep_offset, dir, counter_clockwise,
-                      &sweep)) {
-      ROS_ERROR_STREAM("Cannot compute counter-clockwise sweep.");
-      return false;
-    } else {
-      ROS_ASSERT(!sweep.empty());
-      cluster_sweeps->push_back(sweep);
-      std::reverse(sweep.begin(), sweep.end());
-      cluster_sweeps->push_back(sweep);
-    }
+  std::vector<std::vector<std::vector<Point_2>>> dir_sweeps(dirs.size());
+  if (!parallelFor(dirs.size(), num_threads, [&](size_t i) {
+        std::vector<Segment_2> lanes;
+        if (!computeSweepLanes(poly, max_sweep_offset, dirs[i], &lanes)) {
+          ROS_ERROR_STREAM("Cannot compute sweep lanes.");
+          return false;
+        }
+        for (bool counter_clockwise : {true, false}) {
+          std::vector<Point_2> sweep;
+          if (!connectSweepLanes(vis_graph, lanes, counter_clockwise,
+                                 &sweep)) {
+            ROS_ERROR_STREAM("Cannot compute "
+                             << (counter_clockwise ? "counter-clockwise"
+                                                   : "clockwise")
+                             << " sweep.");
+            return false;
+          }
+          ROS_ASSERT(!sweep.empty());
+          counters::Counters::Increment(counters::kWaypointCopies);
+          std::vector<Point_2> reverse_sweep(sweep.rbegin(), sweep.rend());
+          dir_sweeps[i].push_back(std::move(sweep));
+          dir_sweeps[i].push_back(std::move(reverse_sweep));
+        }
+        return true;
+      })) {
+    return false;
+  }
 
-    if (!computeSweep(poly, vis_graph, max_sweep_offset, dir,
-                      !counter_clockwise, &sweep)) {
-      ROS_ERROR_STREAM("Cannot compute clockwise sweep.");
-      return false;
-    } else {
-      ROS_ASSERT(!sweep.empty());
-      cluster_sweeps->push_back(sweep);
-      std::reverse(sweep.begin(), sweep.end());
-      cluster_sweeps->push_back(sweep);
+  for (std::vector<std::vector<Point_2>>& sweeps : dir_sweeps) {
+    for (std::vector<Point_2>& sweep : sweeps) {
+      cluster_sweeps->push_back(std::move(sweep));
     }
   }
   return true;
@@ -193,16 +426,29 @@ bool calculateShortestPath(
   ROS_ASSERT(shortest_path);
   shortest_path->clear();
 
+  // Within a monotone cell most lane transitions are straight.
+  if (segmentInPolygon(visibility_graph.getPolygon(), Segment_2(start, goal))) {
+    *shortest_path = {start, goal};
+    return true;
+  }
+
+  // Sweeps share many lane endpoints. Skip the visibility polygons if the
+  // transition has been solved before.
+  if (visibility_graph.findCachedPath(start, goal, shortest_path) &&
+      shortest_path->size() >= 2) {
+    counters::Counters::Increment(counters::kShortestPathQueries);
+    counters::Counters::Increment(counters::kShortestPathCacheHits);
+    return true;
+  }
+
   Polygon_2 start_visibility, goal_visibility;
-  if (!computeVisibilityPolygon(visibility_graph.getPolygon(), start,
-                                &start_visibility)) {
+  if (!visibility_graph.computeVisibility(start, &start_visibility)) {
     ROS_ERROR_STREAM("Cannot compute visibility polygon from start query point "
                      << start
                      << " in polygon: " << visibility_graph.getPolygon());
     return false;
   }
-  if (!computeVisibilityPolygon(visibility_graph.getPolygon(), goal,
-                                &goal_visibility)) {
+  if (!visibility_graph.computeVisibility(goal, &goal_visibility)) {
     ROS_ERROR_STREAM("Cannot compute visibility polygon from goal query point "
                      << goal
                      << " in polygon: " << visibility_graph.getPolygon());
@@ -225,48 +471,11 @@ bool calculateShortestPath(
 }
 
 std::vector<Point_2> sortVerticesToLine(const Polygon_2& p, const Line_2& l) {
-  // Copy points.
-  std::vector<Point_2> pts(p.size());
-  std::vector<Point_2>::iterator pts_it = pts.begin();
-  for (VertexConstIterator it = p.vertices_begin(); it != p.vertices_end();
-       ++it) {
-    *(pts_it++) = *it;
-  }
-
-  // Sort.
-  std::sort(pts.begin(), pts.end(),
-            [&l](const Point_2& a, const Point_2& b) -> bool {
-              return CGAL::has_smaller_signed_distance_to_line(l, a, b);
-            });
-
-  return pts;
+  return sortVerticesToLine<K>(p, l);
 }
 
 std::vector<Point_2> findIntersections(const Polygon_2& p, const Line_2& l) {
-  std::vector<Point_2> intersections;
-  typedef CGAL::cpp11::result_of<Intersect_2(Segment_2, Line_2)>::type
-      Intersection;
-
-  for (EdgeConstIterator it = p.edges_begin(); it != p.edges_end(); ++it) {
-    Intersection result = CGAL::intersection(*it, l);
-    if (result) {
-      if (const Segment_2* s = boost::get<Segment_2>(&*result)) {
-        intersections.push_back(s->source());
-        intersections.push_back(s->target());
-      } else {
-        intersections.push_back(*boost::get<Point_2>(&*result));
-      }
-    }
-  }
-
-  // Sort.
-  Line_2 perp_l = l.perpendicular(l.point(0));
-  std::sort(intersections.begin(), intersections.end(),
-            [&perp_l](const Point_2& a, const Point_2& b) -> bool {
-              return CGAL::has_smaller_signed_distance_to_line(perp_l, a, b);
-            });
-
-  return intersections;
+  return findIntersections<K>(p, l);
 }
 
 }  // namespace polygon_coverage_planning
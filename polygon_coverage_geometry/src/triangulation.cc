@@ -19,7 +19,11 @@
 
 #include "polygon_coverage_geometry/triangulation.h"
 
+#include <cmath>
+
+#include <polygon_coverage_solvers/graph_search.h>
 #include <ros/assert.h>
+#include <ros/console.h>
 
 namespace polygon_coverage_planning {
 
@@ -94,4 +98,165 @@ void triangulatePolygon(const PolygonWithHoles& pwh,
   }
 }
 
+TriangulationShortestPath::TriangulationShortestPath(
+    const PolygonWithHoles& pwh) {
+  cdt_.insert_constraint(pwh.outer_boundary().vertices_begin(),
+                         pwh.outer_boundary().vertices_end(), true);
+  for (PolygonWithHoles::Hole_const_iterator hit = pwh.holes_begin();
+       hit != pwh.holes_end(); ++hit) {
+    cdt_.insert_constraint(hit->vertices_begin(), hit->vertices_end(), true);
+  }
+  mark_domains(cdt_);
+
+  for (CDT::Finite_faces_iterator fit = cdt_.finite_faces_begin();
+       fit != cdt_.finite_faces_end(); ++fit) {
+    if (!fit->info().in_domain()) continue;
+    fit->info().id = faces_.size();
+    faces_.push_back(fit);
+    const Point_2 c = CGAL::centroid(fit->vertex(0)->point(),
+                                     fit->vertex(1)->point(),
+                                     fit->vertex(2)->point());
+    centroids_.push_back({CGAL::to_double(c.x()), CGAL::to_double(c.y())});
+  }
+}
+
+bool TriangulationShortestPath::locateFace(const Point_2& p,
+                                           size_t* face_id) const {
+  ROS_ASSERT(face_id);
+
+  CDT::Locate_type lt;
+  int li = 0;
+  CDT::Face_handle fh;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    fh = cdt_.locate(p, lt, li);
+  }
+
+  // Points on edges and vertices may be located in an adjacent face outside
+  // the domain.
+  std::vector<CDT::Face_handle> candidates;
+  if (lt == CDT::FACE) {
+    candidates.push_back(fh);
+  } else if (lt == CDT::EDGE) {
+    candidates.push_back(fh);
+    candidates.push_back(fh->neighbor(li));
+  } else if (lt == CDT::VERTEX) {
+    CDT::Face_circulator fc = cdt_.incident_faces(fh->vertex(li)), done(fc);
+    do {
+      candidates.push_back(fc);
+    } while (++fc != done);
+  }
+  for (const CDT::Face_handle& candidate : candidates) {
+    if (!cdt_.is_infinite(candidate) && candidate->info().in_domain()) {
+      *face_id = candidate->info().id;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool TriangulationShortestPath::solve(const Point_2& start,
+                                      const Point_2& goal,
+                                      std::vector<Point_2>* waypoints) const {
+  ROS_ASSERT(waypoints);
+  waypoints->clear();
+
+  size_t start_face = 0, goal_face = 0;
+  if (!locateFace(start, &start_face) || !locateFace(goal, &goal_face)) {
+    ROS_ERROR_STREAM("Start or goal is not in polygon.");
+    return false;
+  }
+
+  // Find the channel of faces.
+  auto distance = [this](size_t a, size_t b) {
+    return std::hypot(centroids_[a][0] - centroids_[b][0],
+                      centroids_[a][1] - centroids_[b][1]);
+  };
+  Solution channel;
+  if (!searchBestFirst(
+          faces_.size(), start_face, goal_face,
+          [this, &distance](size_t current, auto relax) {
+            for (int i = 0; i < 3; ++i) {
+              const CDT::Face_handle n = faces_[current]->neighbor(i);
+              if (cdt_.is_infinite(n) || !n->info().in_domain() ||
+                  cdt_.is_constrained(CDT::Edge(faces_[current], i))) {
+                continue;
+              }
+              relax(n->info().id, distance(current, n->info().id));
+            }
+            return true;
+          },
+          [&distance, goal_face](size_t n, double* h) {
+            *h = distance(n, goal_face);
+            return true;
+          },
+          &channel)) {
+    ROS_ERROR_STREAM("Start and goal are not connected.");
+    return false;
+  }
+
+  // The portals are the edges between the channel faces, left and right seen
+  // from start.
+  std::vector<std::pair<Point_2, Point_2>> portals = {{start, start}};
+  for (size_t i = 1; i < channel.size(); ++i) {
+    const CDT::Face_handle& from = faces_[channel[i - 1]];
+    const CDT::Face_handle& to = faces_[channel[i]];
+    const int k = from->index(to);
+    portals.emplace_back(from->vertex(CDT::cw(k))->point(),
+                         from->vertex(CDT::ccw(k))->point());
+  }
+  portals.emplace_back(goal, goal);
+
+  // Funnel algorithm.
+  // http://digestingduck.blogspot.com/2010/03/simple-stupid-funnel-algorithm.html
+  waypoints->push_back(start);
+  Point_2 apex = start, left = start, right = start;
+  size_t apex_index = 0, left_index = 0, right_index = 0;
+  for (size_t i = 1; i < portals.size(); ++i) {
+    const Point_2& new_left = portals[i].first;
+    const Point_2& new_right = portals[i].second;
+
+    // Narrow the funnel from the right.
+    if (CGAL::orientation(apex, right, new_right) != CGAL::RIGHT_TURN) {
+      if (apex == right ||
+          CGAL::orientation(apex, left, new_right) == CGAL::RIGHT_TURN) {
+        right = new_right;
+        right_index = i;
+      } else {
+        // The right side crosses the left side. Left becomes the new apex.
+        waypoints->push_back(left);
+        apex = left;
+        apex_index = left_index;
+        right = apex;
+        right_index = apex_index;
+        i = apex_index;
+        continue;
+      }
+    }
+
+    // Narrow the funnel from the left.
+    if (CGAL::orientation(apex, left, new_left) != CGAL::LEFT_TURN) {
+      if (apex == left ||
+          CGAL::orientation(apex, right, new_left) == CGAL::LEFT_TURN) {
+        left = new_left;
+        left_index = i;
+      } else {
+        // The left side crosses the right side. Right becomes the new apex.
+        waypoints->push_back(right);
+        apex = right;
+        apex_index = right_index;
+        left = apex;
+        left_index = apex_index;
+        i = apex_index;
+        continue;
+      }
+    }
+  }
+  if (waypoints->back() != goal) {
+    waypoints->push_back(goal);
+  }
+
+  return true;
+}
+
 }  // namespace polygon_coverage_planning
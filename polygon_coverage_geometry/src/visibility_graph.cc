@@ -18,39 +18,117 @@
  */
 
 #include "polygon_coverage_geometry/cgal_comm.h"
+#include "polygon_coverage_geometry/counters.h"
+#include "polygon_coverage_geometry/rotational_sweep.h"
 #include "polygon_coverage_geometry/visibility_graph.h"
 #include "polygon_coverage_geometry/visibility_polygon.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#include <polygon_coverage_solvers/parallel.h>
 #include <ros/assert.h>
 #include <ros/console.h>
 
 namespace polygon_coverage_planning {
 namespace visibility_graph {
+namespace {
+
+// The scratch buffers of the shortest path queries. One per thread, so that
+// concurrent queries on a shared graph do not allocate them per call.
+struct QueryWorkspace {
+  SearchWorkspace search;
+  // Graph vertices visible from start and goal with their distances.
+  std::vector<std::pair<size_t, double>> start_nodes;
+  std::vector<std::pair<size_t, double>> goal_nodes;
+  // The distance of every graph vertex to goal. Infinite if not visible.
+  std::vector<double> goal_costs;
+};
+
+QueryWorkspace& getQueryWorkspace() {
+  static thread_local QueryWorkspace workspace;
+  return workspace;
+}
+
+// Check whether the line through graph vertex v and w stays on one side of the
+// boundary next to v, i.e., a taut path can bend around v along it.
+bool isTangent(const VertexConstCirculator& v, const Point_2& w) {
+  const CGAL::Orientation prev = CGAL::orientation(*v, w, *std::prev(v));
+  const CGAL::Orientation next = CGAL::orientation(*v, w, *std::next(v));
+  return prev == CGAL::COLLINEAR || next == CGAL::COLLINEAR || prev == next;
+}
 
-VisibilityGraph::VisibilityGraph(const PolygonWithHoles& polygon)
-    : GraphBase(), polygon_(polygon) {
+}  // namespace
+
+VisibilityGraph::VisibilityGraph(const PolygonWithHoles& polygon,
+                                 size_t num_threads, bool bitangent_only)
+    : GraphBase(),
+      polygon_(polygon),
+      num_threads_(num_threads),
+      bitangent_only_(bitangent_only),
+      defer_edges_(false),
+      shortest_path_cache_(std::make_shared<ShortestPathCache>()) {
   // Build visibility graph.
   is_created_ = create();
 }
 
 bool VisibilityGraph::create() {
   clear();
+  shortest_path_cache_->clear();
+  shortest_path_table_.reset();
   // Sort vertices.
   sortVertices(&polygon_);
+  visibility_polygon_cache_ =
+      std::make_shared<VisibilityPolygonCache>(polygon_);
+  polygon_index_ = std::make_shared<PolygonIndex>(polygon_);
   // Select shortest path vertices.
   std::vector<VertexConstCirculator> graph_vertices;
   findConcaveOuterBoundaryVertices(&graph_vertices);
   findConvexHoleVertices(&graph_vertices);
 
+  // Index the graph vertices among all polygon vertices.
+  std::map<Point_2, size_t> vertex_ids;
+  for (const Point_2& v : getHullVertices(polygon_)) {
+    vertex_ids.emplace(v, vertex_ids.size());
+  }
+  for (const std::vector<Point_2>& hole : getHoleVertices(polygon_)) {
+    for (const Point_2& v : hole) {
+      vertex_ids.emplace(v, vertex_ids.size());
+    }
+  }
+
+  // Add the nodes. The edges are found by rotational plane sweeps.
+  defer_edges_ = true;
   for (const VertexConstCirculator& v : graph_vertices) {
-    // Compute visibility polygon.
-    Polygon_2 visibility;
-    if (!computeVisibilityPolygon(polygon_, *v, &visibility)) {
-      ROS_ERROR_STREAM("Cannot compute visibility polygon.");
+    if (!addNode(NodeProperty(*v, Polygon_2()))) {
+      defer_edges_ = false;
       return false;
     }
-    if (!addNode(NodeProperty(*v, visibility))) {
-      return false;
+  }
+  defer_edges_ = false;
+
+  std::vector<std::vector<bool>> visible(graph_vertices.size());
+  parallelFor(graph_vertices.size(), num_threads_, [&](size_t i) {
+    visible[i] =
+        computeVisibleVertices(polygon_, vertex_ids.at(*graph_vertices[i]));
+    return true;
+  });
+  for (size_t i = 0; i < graph_vertices.size(); ++i) {
+    for (size_t j = i + 1; j < graph_vertices.size(); ++j) {
+      if (!visible[i][vertex_ids.at(*graph_vertices[j])]) continue;
+      if (bitangent_only_ &&
+          (!isTangent(graph_vertices[i], *graph_vertices[j]) ||
+           !isTangent(graph_vertices[j], *graph_vertices[i]))) {
+        continue;
+      }
+      const double cost = computeEuclideanSegmentCost(
+          *graph_vertices[i], *graph_vertices[j]);  // Symmetric cost.
+      if (!addEdge(EdgeId(i, j), EdgeProperty(), cost) ||
+          !addEdge(EdgeId(j, i), EdgeProperty(), cost)) {
+        return false;
+      }
     }
   }
 
@@ -58,7 +136,8 @@ bool VisibilityGraph::create() {
                    << graph_.size() << " nodes and " << edge_properties_.size()
                    << " edges.");
 
-  return true;
+  // Freeze graph for fast queries.
+  return compact();
 }
 
 void VisibilityGraph::findConcaveOuterBoundaryVertices(
@@ -99,6 +178,9 @@ bool VisibilityGraph::addEdges() {
     ROS_ERROR_STREAM("Cannot add edges to an empty graph.");
     return false;
   }
+  if (defer_edges_) {
+    return true;  // Graph vertex edges are created by create().
+  }
 
   const size_t new_id = graph_.size() - 1;
   for (size_t adj_id = 0; adj_id < new_id; ++adj_id) {
@@ -130,17 +212,14 @@ bool VisibilityGraph::solve(const Point_2& start, const Point_2& goal,
   waypoints->clear();
 
   // Make sure start and end are inside the polygon.
-  const Point_2 start_new = pointInPolygon(polygon_, start)
-                                ? start
-                                : projectPointOnHull(polygon_, start);
-  const Point_2 goal_new = pointInPolygon(polygon_, goal)
-                               ? goal
-                               : projectPointOnHull(polygon_, goal);
+  const Point_2 start_new =
+      containsPoint(start) ? start : projectOnHull(start);
+  const Point_2 goal_new = containsPoint(goal) ? goal : projectOnHull(goal);
 
   // Compute start and goal visibility polygon.
   Polygon_2 start_visibility, goal_visibility;
-  if (!computeVisibilityPolygon(polygon_, start_new, &start_visibility) ||
-      !computeVisibilityPolygon(polygon_, goal_new, &goal_visibility)) {
+  if (!computeVisibility(start_new, &start_visibility) ||
+      !computeVisibility(goal_new, &goal_visibility)) {
     return false;
   }
 
@@ -156,49 +235,402 @@ bool VisibilityGraph::solve(const Point_2& start,
                             std::vector<Point_2>* waypoints) const {
   ROS_ASSERT(waypoints);
   waypoints->clear();
+  counters::Counters::Increment(counters::kShortestPathQueries);
+
+  if (is_created_ && findCachedPath(start, goal, waypoints)) {
+    counters::Counters::Increment(counters::kShortestPathCacheHits);
+    return true;
+  }
+  if (!solveUncached(start, start_visibility_polygon, goal,
+                     goal_visibility_polygon, waypoints)) {
+    return false;
+  }
+  shortest_path_cache_->insert(start, goal, *waypoints);
+  return true;
+}
+
+bool VisibilityGraph::solveUncached(const Point_2& start,
+                                    const Polygon_2& start_visibility_polygon,
+                                    const Point_2& goal,
+                                    const Polygon_2& goal_visibility_polygon,
+                                    std::vector<Point_2>* waypoints) const {
+  ROS_ASSERT(waypoints);
+  waypoints->clear();
 
   if (!is_created_) {
     ROS_ERROR_STREAM("Visibility graph not initialized.");
     return false;
-  } else if (!pointInPolygon(polygon_, start) ||
-             !pointInPolygon(polygon_, goal)) {
+  } else if (!containsPoint(start) || !containsPoint(goal)) {
     ROS_ERROR_STREAM("Start or goal is not in polygon.");
     return false;
   }
 
-  VisibilityGraph temp_visibility_graph = *this;
-  // Add start and goal node.
-  if (!temp_visibility_graph.addStartNode(
-          NodeProperty(start, start_visibility_polygon)) ||
-      !temp_visibility_graph.addGoalNode(
-          NodeProperty(goal, goal_visibility_polygon))) {
-    return false;
+  if (shortest_path_table_) {
+    return solveWithTable(start, start_visibility_polygon, goal,
+                          goal_visibility_polygon, waypoints);
   }
 
   // Check if start and goal are in line of sight.
-  size_t start_idx = temp_visibility_graph.getStartIdx();
-  size_t goal_idx = temp_visibility_graph.getGoalIdx();
-  const NodeProperty* start_node_property =
-      temp_visibility_graph.getNodeProperty(start_idx);
-  if (start_node_property == nullptr) {
-    return false;
-  }
-  if (pointInPolygon(start_node_property->visibility, goal)) {
+  if (pointInPolygon(start_visibility_polygon, goal)) {
     waypoints->push_back(start);
     waypoints->push_back(goal);
     return true;
   }
 
+  // Connect start and goal to their visible vertices without copying the
+  // graph. Start and goal are the nodes after the graph vertices.
+  QueryWorkspace& workspace = getQueryWorkspace();
+  const size_t num_nodes = graph_.size();
+  const size_t start_idx = num_nodes;
+  const size_t goal_idx = num_nodes + 1;
+  if (!findVisibleNodes(start, start_visibility_polygon,
+                        &workspace.start_nodes) ||
+      !findVisibleNodes(goal, goal_visibility_polygon,
+                        &workspace.goal_nodes)) {
+    return false;
+  }
+  workspace.goal_costs.assign(num_nodes,
+                              std::numeric_limits<double>::infinity());
+  for (const std::pair<size_t, double>& n : workspace.goal_nodes) {
+    workspace.goal_costs[n.first] = n.second;
+  }
+
   // Find shortest way using A*.
+  const double goal_x = CGAL::to_double(goal.x());
+  const double goal_y = CGAL::to_double(goal.y());
   Solution solution;
-  if (!temp_visibility_graph.solveAStar(start_idx, goal_idx, &solution)) {
+  if (!searchBestFirst(
+          num_nodes + 2, start_idx, goal_idx,
+          [this, &workspace, num_nodes, start_idx, goal_idx](size_t current,
+                                                             auto relax) {
+            if (current == start_idx) {
+              for (const std::pair<size_t, double>& n :
+                   workspace.start_nodes) {
+                relax(n.first, n.second);
+              }
+            } else if (current < num_nodes) {
+              forEachNeighbor(current, [&relax](size_t n, double cost) {
+                relax(n, cost);
+                return true;
+              });
+              if (std::isfinite(workspace.goal_costs[current])) {
+                relax(goal_idx, workspace.goal_costs[current]);
+              }
+            }
+            return true;
+          },
+          [this, num_nodes, goal_x, goal_y](size_t n, double* h) {
+            const NodeProperty* node_property =
+                n < num_nodes ? getNodeProperty(n) : nullptr;
+            *h = node_property == nullptr
+                     ? 0.0
+                     : std::hypot(node_property->x - goal_x,
+                                  node_property->y - goal_y);
+            return true;
+          },
+          &solution, &workspace.search)) {
+    ROS_ERROR_STREAM(
+        "Could not find shortest path. Graph not fully connected.");
+    return false;
+  }
+
+  // Reconstruct waypoints.
+  waypoints->reserve(solution.size());
+  for (size_t n : solution) {
+    if (n == start_idx) {
+      waypoints->push_back(start);
+    } else if (n == goal_idx) {
+      waypoints->push_back(goal);
+    } else {
+      waypoints->push_back(getNodeProperty(n)->coordinates);
+    }
+  }
+  return true;
+}
+
+bool VisibilityGraph::findVisibleNodes(
+    const Point_2& p, const Polygon_2& visibility_polygon,
+    std::vector<std::pair<size_t, double>>* nodes) const {
+  ROS_ASSERT(nodes);
+  nodes->clear();
+  for (size_t i = 0; i < graph_.size(); ++i) {
+    const NodeProperty* node_property = getNodeProperty(i);
+    if (node_property == nullptr) {
+      return false;
+    }
+    if (pointInPolygon(visibility_polygon, node_property->coordinates)) {
+      nodes->emplace_back(
+          i, computeEuclideanSegmentCost(p, node_property->coordinates));
+    }
+  }
+  return true;
+}
+
+bool VisibilityGraph::solveOneToMany(
+    const Point_2& start, const Polygon_2* start_visibility_polygon,
+    const std::vector<Point_2>& goals,
+    const std::vector<const Polygon_2*>& goal_visibility_polygons,
+    std::vector<std::vector<Point_2>>* waypoints,
+    std::vector<double>* costs) const {
+  ROS_ASSERT(waypoints);
+  ROS_ASSERT(goals.size() == goal_visibility_polygons.size());
+  counters::Counters::Increment(counters::kShortestPathQueries, goals.size());
+  waypoints->assign(goals.size(), std::vector<Point_2>());
+  if (costs) {
+    costs->assign(goals.size(), std::numeric_limits<double>::infinity());
+  }
+
+  if (!is_created_) {
+    ROS_ERROR_STREAM("Visibility graph not initialized.");
+    return false;
+  } else if (!containsPoint(start) || !polygon_index_->containsPoints(goals)) {
+    ROS_ERROR_STREAM("Start or goal is not in polygon.");
+    return false;
+  }
+
+  Polygon_2 start_visibility;
+  if (start_visibility_polygon == nullptr) {
+    if (!computeVisibility(start, &start_visibility)) {
+      return false;
+    }
+    start_visibility_polygon = &start_visibility;
+  }
+
+  // The shortest path tree from start is grown on the first goal that needs
+  // it. Node num_nodes is start connected to its visible vertices.
+  const size_t num_nodes = graph_.size();
+  std::vector<double> node_costs;
+  std::vector<size_t> came_from;
+  auto grow_tree = [&]() {
+    QueryWorkspace& workspace = getQueryWorkspace();
+    if (!findVisibleNodes(start, *start_visibility_polygon,
+                          &workspace.start_nodes)) {
+      return false;
+    }
+    return searchShortestPathTree(
+        num_nodes + 1, num_nodes,
+        [this, num_nodes, &workspace](size_t current, auto relax) {
+          if (current == num_nodes) {
+            for (const std::pair<size_t, double>& n : workspace.start_nodes) {
+              relax(n.first, n.second);
+            }
+          } else {
+            forEachNeighbor(current, [&relax](size_t n, double cost) {
+              relax(n, cost);
+              return true;
+            });
+          }
+          return true;
+        },
+        &node_costs, &came_from, &workspace.search);
+  };
+
+  for (size_t i = 0; i < goals.size(); ++i) {
+    const Point_2& goal = goals[i];
+    std::vector<Point_2>& path = (*waypoints)[i];
+    if (findCachedPath(start, goal, &path)) {
+      counters::Counters::Increment(counters::kShortestPathCacheHits);
+    } else {
+      if (pointInPolygon(*start_visibility_polygon, goal)) {
+        // Line of sight.
+        path = {start, goal};
+      } else {
+        Polygon_2 goal_visibility;
+        const Polygon_2* goal_visibility_polygon = goal_visibility_polygons[i];
+        if (goal_visibility_polygon == nullptr) {
+          if (!computeVisibility(goal, &goal_visibility)) {
+            return false;
+          }
+          goal_visibility_polygon = &goal_visibility;
+        }
+
+        if (shortest_path_table_) {
+          if (!solveWithTable(start, *start_visibility_polygon, goal,
+                              *goal_visibility_polygon, &path)) {
+            path.clear();
+          }
+        } else {
+          if (came_from.empty() && !grow_tree()) {
+            return false;
+          }
+          // Connect goal to the best visible vertex.
+          double best_cost = std::numeric_limits<double>::infinity();
+          size_t best_node = kNoParent;
+          for (size_t j = 0; j < num_nodes; ++j) {
+            if (!std::isfinite(node_costs[j]) ||
+                !pointInPolygon(*goal_visibility_polygon,
+                                getNodeProperty(j)->coordinates)) {
+              continue;
+            }
+            const double cost =
+                node_costs[j] +
+                computeEuclideanSegmentCost(getNodeProperty(j)->coordinates,
+                                            goal);
+            if (cost < best_cost) {
+              best_cost = cost;
+              best_node = j;
+            }
+          }
+          if (best_node == kNoParent) {
+            ROS_ERROR_STREAM(
+                "Could not find shortest path. Graph not fully connected.");
+            continue;
+          }
+
+          // Reconstruct waypoints.
+          path.push_back(goal);
+          for (size_t n = best_node; n != num_nodes; n = came_from[n]) {
+            path.push_back(getNodeProperty(n)->coordinates);
+          }
+          path.push_back(start);
+          std::reverse(path.begin(), path.end());
+        }
+        if (path.empty()) {
+          continue;
+        }
+      }
+      shortest_path_cache_->insert(start, goal, path);
+    }
+
+    if (costs) {
+      (*costs)[i] = 0.0;
+      for (size_t j = 1; j < path.size(); ++j) {
+        (*costs)[i] += computeEuclideanSegmentCost(path[j - 1], path[j]);
+      }
+    }
+  }
+
+  return true;
+}
+
+bool VisibilityGraph::createShortestPathTable() {
+  if (!is_created_) {
+    ROS_ERROR_STREAM("Visibility graph not initialized.");
+    return false;
+  }
+
+  auto table = std::make_shared<ShortestPathTable>();
+  const size_t num_nodes = graph_.size();
+  table->num_nodes = num_nodes;
+  table->costs.resize(num_nodes * num_nodes);
+  table->next_hops.resize(num_nodes * num_nodes);
+  // One shortest path tree per source.
+  if (!parallelFor(num_nodes, num_threads_, [&](size_t from) {
+        std::vector<double> costs;
+        std::vector<size_t> came_from;
+        if (!searchShortestPathTree(
+                num_nodes, from,
+                [this](size_t current, auto relax) {
+                  forEachNeighbor(current, [&relax](size_t n, double cost) {
+                    relax(n, cost);
+                    return true;
+                  });
+                  return true;
+                },
+                &costs, &came_from)) {
+          return false;
+        }
+        std::copy(costs.begin(), costs.end(),
+                  table->costs.begin() + from * num_nodes);
+        // The next hop of a node is the next hop of its predecessor.
+        std::vector<size_t> order(num_nodes);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&costs](size_t a, size_t b) {
+          return costs[a] < costs[b];
+        });
+        size_t* next_hops = &table->next_hops[from * num_nodes];
+        for (size_t to : order) {
+          if (came_from[to] == kNoParent) {
+            next_hops[to] = to == from ? from : kNoParent;
+          } else {
+            next_hops[to] =
+                came_from[to] == from ? to : next_hops[came_from[to]];
+          }
+        }
+        return true;
+      })) {
+    ROS_ERROR_STREAM("Cannot create shortest path table.");
+    return false;
+  }
+
+  shortest_path_table_ = table;
+  return true;
+}
+
+size_t VisibilityGraph::getMemoryBytes() const {
+  size_t bytes = getNodeBytes() + getEdgeBytes();
+  for (size_t i = 0; i < size(); ++i) {
+    const NodeProperty* node_property = getNodeProperty(i);
+    if (node_property) {
+      bytes += node_property->visibility.size() * sizeof(Point_2);
+    }
+  }
+  if (shortest_path_table_) {
+    bytes += shortest_path_table_->costs.capacity() * sizeof(double) +
+             shortest_path_table_->next_hops.capacity() * sizeof(size_t);
+  }
+  return bytes;
+}
+
+bool VisibilityGraph::solveWithTable(const Point_2& start,
+                                     const Polygon_2& start_visibility_polygon,
+                                     const Point_2& goal,
+                                     const Polygon_2& goal_visibility_polygon,
+                                     std::vector<Point_2>* waypoints) const {
+  ROS_ASSERT(waypoints);
+  ROS_ASSERT(shortest_path_table_);
+  waypoints->clear();
+
+  // Check if start and goal are in line of sight.
+  if (pointInPolygon(start_visibility_polygon, goal)) {
+    waypoints->push_back(start);
+    waypoints->push_back(goal);
+    return true;
+  }
+
+  // Connect start and goal to the visible vertices.
+  QueryWorkspace& workspace = getQueryWorkspace();
+  const std::vector<std::pair<size_t, double>>& start_nodes =
+      workspace.start_nodes;
+  const std::vector<std::pair<size_t, double>>& goal_nodes =
+      workspace.goal_nodes;
+  if (!findVisibleNodes(start, start_visibility_polygon,
+                        &workspace.start_nodes) ||
+      !findVisibleNodes(goal, goal_visibility_polygon, &workspace.goal_nodes)) {
+    return false;
+  }
+
+  // Find the best pair of visible vertices.
+  const ShortestPathTable& table = *shortest_path_table_;
+  double best_cost = std::numeric_limits<double>::infinity();
+  size_t best_from = kNoParent, best_to = kNoParent;
+  for (const std::pair<size_t, double>& from : start_nodes) {
+    for (const std::pair<size_t, double>& to : goal_nodes) {
+      const double cost = from.second +
+                          table.costs[from.first * table.num_nodes + to.first] +
+                          to.second;
+      if (cost < best_cost) {
+        best_cost = cost;
+        best_from = from.first;
+        best_to = to.first;
+      }
+    }
+  }
+  if (best_from == kNoParent) {
     ROS_ERROR_STREAM(
         "Could not find shortest path. Graph not fully connected.");
     return false;
   }
 
   // Reconstruct waypoints.
-  return temp_visibility_graph.getWaypoints(solution, waypoints);
+  waypoints->push_back(start);
+  for (size_t n = best_from; n != best_to;
+       n = table.next_hops[n * table.num_nodes + best_to]) {
+    waypoints->push_back(getNodeProperty(n)->coordinates);
+  }
+  waypoints->push_back(getNodeProperty(best_to)->coordinates);
+  waypoints->push_back(goal);
+  return true;
 }
 
 bool VisibilityGraph::getWaypoints(const Solution& solution,
@@ -216,10 +648,9 @@ bool VisibilityGraph::getWaypoints(const Solution& solution,
   return true;
 }
 
-bool VisibilityGraph::calculateHeuristic(size_t goal,
-                                         Heuristic* heuristic) const {
+bool VisibilityGraph::createHeuristic(size_t goal,
+                                      Heuristic* heuristic) const {
   ROS_ASSERT(heuristic);
-  heuristic->clear();
 
   const NodeProperty* goal_node_property = getNodeProperty(goal);
   if (goal_node_property == nullptr) {
@@ -227,16 +658,18 @@ bool VisibilityGraph::calculateHeuristic(size_t goal,
     return false;
   }
 
-  for (size_t adj_id = 0; adj_id < graph_.size(); ++adj_id) {
-    const NodeProperty* adj_node_property = getNodeProperty(adj_id);
-    if (adj_node_property == nullptr) {
+  const double goal_x = goal_node_property->x;
+  const double goal_y = goal_node_property->y;
+  *heuristic = [this, goal_x, goal_y](size_t n, double* h) {
+    const NodeProperty* node_property = getNodeProperty(n);
+    if (node_property == nullptr) {
       ROS_ERROR_STREAM(
           "Cannot access adjacent node property to calculate heuristic.");
       return false;
     }
-    (*heuristic)[adj_id] = computeEuclideanSegmentCost(
-        adj_node_property->coordinates, goal_node_property->coordinates);
-  }
+    *h = std::hypot(node_property->x - goal_x, node_property->y - goal_y);
+    return true;
+  };
 
   return true;
 }
@@ -247,10 +680,10 @@ bool VisibilityGraph::solveWithOutsideStartAndGoal(
   ROS_ASSERT(waypoints);
 
   if (solve(start, goal, waypoints)) {
-    if (!pointInPolygon(polygon_, start)) {
+    if (!containsPoint(start)) {
       waypoints->insert(waypoints->begin(), start);
     }
-    if (!pointInPolygon(polygon_, goal)) {
+    if (!containsPoint(goal)) {
       waypoints->push_back(goal);
     }
     return true;
@@ -20,91 +20,87 @@
 #include <ros/assert.h>
 #include <ros/console.h>
 
-#include <CGAL/Arr_naive_point_location.h>
-#include <CGAL/Arr_segment_traits_2.h>
-#include <CGAL/Triangular_expansion_visibility_2.h>
-
 #include "polygon_coverage_geometry/cgal_comm.h"
+#include "polygon_coverage_geometry/counters.h"
 #include "polygon_coverage_geometry/visibility_polygon.h"
 
 namespace polygon_coverage_planning {
 
-bool computeVisibilityPolygon(const PolygonWithHoles& pwh,
-                              const Point_2& query_point,
-                              Polygon_2* visibility_polygon) {
-  ROS_ASSERT(visibility_polygon);
-
+VisibilityOracle::VisibilityOracle(const PolygonWithHoles& pwh)
+    : polygon_(pwh) {
   // Preconditions.
-  ROS_ASSERT_MSG(pointInPolygon(pwh, query_point),
-                 "Query point outside of polygon.");
-  ROS_ASSERT_MSG(isStrictlySimple(pwh), "Polygon is not strictly simple.");
+  ROS_ASSERT_MSG(isStrictlySimple(polygon_), "Polygon is not strictly simple.");
 
   // Create 2D arrangement.
-  typedef CGAL::Arr_segment_traits_2<K> VisibilityTraits;
-  typedef CGAL::Arrangement_2<VisibilityTraits> VisibilityArrangement;
-  VisibilityArrangement poly;
-  CGAL::insert(poly, pwh.outer_boundary().edges_begin(),
-               pwh.outer_boundary().edges_end());
+  CGAL::insert(arrangement_, polygon_.outer_boundary().edges_begin(),
+               polygon_.outer_boundary().edges_end());
   // Store main face.
-  ROS_ASSERT_MSG(poly.number_of_unbounded_faces() == 1,
+  ROS_ASSERT_MSG(arrangement_.number_of_unbounded_faces() == 1,
                  "Polygon has unbounded curves.");
-  ROS_ASSERT_MSG(poly.number_of_faces() == 2,
+  ROS_ASSERT_MSG(arrangement_.number_of_faces() == 2,
                  "More than one bounded face in polygon.");
 
-  VisibilityArrangement::Face_const_handle main_face = poly.faces_begin();
-  while (main_face->is_unbounded()) {
-    main_face++;
+  main_face_ = arrangement_.faces_begin();
+  while (main_face_->is_unbounded()) {
+    main_face_++;
   }
 
-  for (PolygonWithHoles::Hole_const_iterator hit = pwh.holes_begin();
-       hit != pwh.holes_end(); ++hit)
-    CGAL::insert(poly, hit->edges_begin(), hit->edges_end());
+  for (PolygonWithHoles::Hole_const_iterator hit = polygon_.holes_begin();
+       hit != polygon_.holes_end(); ++hit)
+    CGAL::insert(arrangement_, hit->edges_begin(), hit->edges_end());
+
+  // Triangulate once for all queries.
+  tev_ = std::make_unique<TEV>(arrangement_);
+  point_location_ = std::make_unique<PointLocation>(arrangement_);
+}
+
+bool VisibilityOracle::compute(const Point_2& query_point,
+                               Polygon_2* visibility_polygon) const {
+  ROS_ASSERT(visibility_polygon);
+  counters::Counters::Increment(counters::kVisibilityPolygons);
+
+  // Preconditions.
+  ROS_ASSERT_MSG(pointInPolygon(polygon_, query_point),
+                 "Query point outside of polygon.");
 
-  // Create Triangular Expansion Visibility object.
-  typedef CGAL::Triangular_expansion_visibility_2<VisibilityArrangement,
-                                                  CGAL::Tag_true>
-      TEV;
-  TEV tev(poly);
+  std::lock_guard<std::mutex> lock(mutex_);
 
   // We need to determine the halfedge or face to which the query point
   // corresponds.
-  typedef CGAL::Arr_naive_point_location<VisibilityArrangement> NaivePL;
-  typedef CGAL::Arr_point_location_result<VisibilityArrangement>::Type PLResult;
-  NaivePL pl(poly);
-  PLResult pl_result = pl.locate(query_point);
-
-  VisibilityArrangement::Vertex_const_handle* v = nullptr;
-  VisibilityArrangement::Halfedge_const_handle* e = nullptr;
-  VisibilityArrangement::Face_const_handle* f = nullptr;
-
-  typedef VisibilityArrangement::Face_handle VisibilityFaceHandle;
-  VisibilityFaceHandle fh;
-  VisibilityArrangement visibility_arr;
-  if ((f = boost::get<VisibilityArrangement::Face_const_handle>(&pl_result))) {
+  typedef CGAL::Arr_point_location_result<Arrangement>::Type PLResult;
+  PLResult pl_result = point_location_->locate(query_point);
+
+  const Arrangement::Vertex_const_handle* v = nullptr;
+  const Arrangement::Halfedge_const_handle* e = nullptr;
+  const Arrangement::Face_const_handle* f = nullptr;
+
+  Arrangement::Face_handle fh;
+  Arrangement visibility_arr;
+  if ((f = boost::get<Arrangement::Face_const_handle>(&pl_result))) {
     // Located in face.
-    fh = tev.compute_visibility(query_point, *f, visibility_arr);
-  } else if ((v = boost::get<VisibilityArrangement::Vertex_const_handle>(
-                  &pl_result))) {
+    fh = tev_->compute_visibility(query_point, *f, visibility_arr);
+  } else if ((v = boost::get<Arrangement::Vertex_const_handle>(&pl_result))) {
     // Located on vertex.
     // Search the incident halfedge that contains the polygon face.
-    VisibilityArrangement::Halfedge_const_handle he = poly.halfedges_begin();
-    while ((he->target()->point() != (*v)->point()) ||
-           (he->face() != main_face)) {
-      he++;
-      if (he == poly.halfedges_end()) {
+    Arrangement::Halfedge_around_vertex_const_circulator first =
+        (*v)->incident_halfedges();
+    Arrangement::Halfedge_around_vertex_const_circulator he = first;
+    while (he->face() != main_face_) {
+      if (++he == first) {
         ROS_ERROR_STREAM("Cannot find halfedge corresponding to vertex.");
         return false;
       }
     }
 
-    fh = tev.compute_visibility(query_point, he, visibility_arr);
-  } else if ((e = boost::get<VisibilityArrangement::Halfedge_const_handle>(
+    fh = tev_->compute_visibility(
+        query_point, Arrangement::Halfedge_const_handle(he), visibility_arr);
+  } else if ((e = boost::get<Arrangement::Halfedge_const_handle>(
                   &pl_result))) {
     // Located on halfedge.
     // Find halfedge that has polygon interior as face.
-    VisibilityArrangement::Halfedge_const_handle he =
-        (*e)->face() == main_face ? (*e) : (*e)->twin();
-    fh = tev.compute_visibility(query_point, he, visibility_arr);
+    Arrangement::Halfedge_const_handle he =
+        (*e)->face() == main_face_ ? (*e) : (*e)->twin();
+    fh = tev_->compute_visibility(query_point, he, visibility_arr);
   } else {
     ROS_ERROR_STREAM("Cannot locate query point on arrangement.");
     return false;
@@ -121,7 +117,7 @@ bool computeVisibilityPolygon(const PolygonWithHoles& pwh,
   }
 
   // Convert to polygon.
-  VisibilityArrangement::Ccb_halfedge_circulator curr = fh->outer_ccb();
+  Arrangement::Ccb_halfedge_circulator curr = fh->outer_ccb();
   *visibility_polygon = Polygon_2();
   do {
     visibility_polygon->push_back(curr->source()->point());
@@ -134,4 +130,10 @@ bool computeVisibilityPolygon(const PolygonWithHoles& pwh,
   return true;
 }
 
+bool computeVisibilityPolygon(const PolygonWithHoles& pwh,
+                              const Point_2& query_point,
+                              Polygon_2* visibility_polygon) {
+  return VisibilityOracle(pwh).compute(query_point, visibility_polygon);
+}
+
 }  // namespace polygon_coverage_planning
@@ -0,0 +1,110 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "polygon_coverage_geometry/visibility_polygon_cache.h"
+
+#include <polygon_coverage_solvers/parallel.h>
+#include <ros/assert.h>
+
+namespace polygon_coverage_planning {
+
+constexpr size_t VisibilityPolygonCache::kDefaultCapacity;
+
+bool VisibilityPolygonCache::compute(const Point_2& query_point,
+                                     Polygon_2* visibility_polygon) {
+  ROS_ASSERT(visibility_polygon);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = index_.find(query_point);
+    if (it != index_.end()) {
+      // Move to front.
+      entries_.splice(entries_.begin(), entries_, it->second);
+      *visibility_polygon = it->second->second;
+      return true;
+    }
+  }
+
+  // Compute outside of the lock. Concurrent misses on the same point compute
+  // twice but store once.
+  std::unique_ptr<VisibilityOracle> oracle = acquireOracle();
+  const bool success = oracle->compute(query_point, visibility_polygon);
+  releaseOracle(std::move(oracle));
+  if (!success) {
+    return false;
+  }
+  if (capacity_ == 0) {
+    return true;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (index_.count(query_point) > 0) {
+    return true;
+  }
+  entries_.emplace_front(query_point, *visibility_polygon);
+  index_.emplace(query_point, entries_.begin());
+  if (entries_.size() > capacity_) {
+    index_.erase(entries_.back().first);
+    entries_.pop_back();
+  }
+  return true;
+}
+
+bool VisibilityPolygonCache::compute(
+    const std::vector<Point_2>& query_points, size_t num_threads,
+    std::vector<Polygon_2>* visibility_polygons) {
+  ROS_ASSERT(visibility_polygons);
+  visibility_polygons->resize(query_points.size());
+  return parallelFor(query_points.size(), num_threads, [&](size_t i) {
+    return compute(query_points[i], &(*visibility_polygons)[i]);
+  });
+}
+
+std::unique_ptr<VisibilityOracle> VisibilityPolygonCache::acquireOracle() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!idle_oracles_.empty()) {
+      std::unique_ptr<VisibilityOracle> oracle =
+          std::move(idle_oracles_.back());
+      idle_oracles_.pop_back();
+      return oracle;
+    }
+  }
+  // Build outside of the lock.
+  return std::make_unique<VisibilityOracle>(polygon_);
+}
+
+void VisibilityPolygonCache::releaseOracle(
+    std::unique_ptr<VisibilityOracle> oracle) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  idle_oracles_.push_back(std::move(oracle));
+}
+
+size_t VisibilityPolygonCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+void VisibilityPolygonCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  index_.clear();
+}
+
+}  // namespace polygon_coverage_planning
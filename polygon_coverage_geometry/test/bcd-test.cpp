@@ -22,7 +22,9 @@
 
 #include "polygon_coverage_geometry/bcd.h"
 #include "polygon_coverage_geometry/cgal_comm.h"
+#include "polygon_coverage_geometry/decomposition.h"
 #include "polygon_coverage_geometry/test_comm.h"
+#include "polygon_coverage_geometry/weakly_monotone.h"
 
 using namespace polygon_coverage_planning;
 
@@ -82,6 +84,55 @@ TEST(BctTest, computeBCD) {
   EXPECT_EQ(area, expected_area);
 }
 
+TEST(BctTest, computeBestBCDFromPolygonWithHoles) {
+  PolygonWithHoles rectangle_in_rectangle(
+      createRectangleInRectangle<Polygon_2, PolygonWithHoles>());
+  FT expected_area = rectangle_in_rectangle.outer_boundary().area();
+  for (PolygonWithHoles::Hole_const_iterator hit =
+           rectangle_in_rectangle.holes_begin();
+       hit != rectangle_in_rectangle.holes_end(); ++hit) {
+    expected_area -= hit->area();
+  }
+
+  std::vector<Polygon_2> bcd;
+  EXPECT_TRUE(computeBestBCDFromPolygonWithHoles(rectangle_in_rectangle, &bcd));
+  EXPECT_EQ(bcd.size(), static_cast<size_t>(4));
+  FT area = 0.0;
+  for (const Polygon_2& p : bcd) {
+    area += p.area();
+  }
+  EXPECT_EQ(area, expected_area);
+}
+
+TEST(BctTest, computeTMDFromPolygonWithHoles) {
+  // Diamond.
+  PolygonWithHoles diamond(createDiamond<Polygon_2>());
+  std::vector<Polygon_2> tmd;
+  EXPECT_TRUE(computeTMDFromPolygonWithHoles(diamond, &tmd));
+  EXPECT_EQ(tmd.size(), static_cast<size_t>(1));
+
+  // Ultimate test.
+  PolygonWithHoles pwh(createUltimateBCDTest<Polygon_2, PolygonWithHoles>());
+  FT expected_area = pwh.outer_boundary().area();
+  size_t num_vertices = pwh.outer_boundary().size();
+  for (PolygonWithHoles::Hole_const_iterator hit = pwh.holes_begin();
+       hit != pwh.holes_end(); ++hit) {
+    expected_area += hit->area();
+    num_vertices += hit->size();
+  }
+  EXPECT_TRUE(computeTMDFromPolygonWithHoles(pwh, &tmd));
+  // Fewer cells than triangles.
+  EXPECT_LT(tmd.size(), num_vertices + 2 * pwh.number_of_holes() - 2);
+  FT area = 0.0;
+  for (const Polygon_2& p : tmd) {
+    EXPECT_TRUE(p.is_simple()) << p;
+    EXPECT_TRUE(p.is_counterclockwise_oriented()) << p;
+    EXPECT_FALSE(getAllSweepableEdgeDirections(p).empty()) << p;
+    area += p.area();
+  }
+  EXPECT_EQ(area, expected_area);
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -17,9 +17,19 @@
  * this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <list>
+#include <string>
+
 #include <gtest/gtest.h>
 
+#include "polygon_coverage_geometry/boolean.h"
 #include "polygon_coverage_geometry/cgal_comm.h"
+#include "polygon_coverage_geometry/polygon_file.h"
+#include "polygon_coverage_geometry/polygon_index.h"
 #include "polygon_coverage_geometry/test_comm.h"
 
 using namespace polygon_coverage_planning;
@@ -57,6 +67,37 @@ TEST(CgalCommTest, pointInPolygon) {
   EXPECT_FALSE(pointInPolygon(rect_in_rect, v));
 }
 
+TEST(CgalCommTest, segmentInPolygon) {
+  PolygonWithHoles rect_in_rect(
+      createRectangleInRectangle<Polygon_2, PolygonWithHoles>());
+
+  // Segment in interior.
+  EXPECT_TRUE(segmentInPolygon(
+      rect_in_rect, Segment_2(Point_2(0.1, 0.1), Point_2(1.9, 1.0))));
+
+  // Segment along outer edge.
+  EXPECT_TRUE(segmentInPolygon(
+      rect_in_rect, Segment_2(Point_2(0.0, 0.0), Point_2(2.0, 0.0))));
+
+  // Segment along hole edge and touching hole vertex.
+  EXPECT_TRUE(segmentInPolygon(
+      rect_in_rect, Segment_2(Point_2(0.0, 1.25), Point_2(2.0, 1.25))));
+  EXPECT_TRUE(segmentInPolygon(
+      rect_in_rect, Segment_2(Point_2(0.0, 0.25), Point_2(1.75, 2.0))));
+
+  // Degenerate segment.
+  EXPECT_TRUE(segmentInPolygon(
+      rect_in_rect, Segment_2(Point_2(1.0, 1.0), Point_2(1.0, 1.0))));
+
+  // Segment through hole.
+  EXPECT_FALSE(segmentInPolygon(
+      rect_in_rect, Segment_2(Point_2(0.0, 1.5), Point_2(2.0, 1.5))));
+
+  // Segment leaving polygon.
+  EXPECT_FALSE(segmentInPolygon(
+      rect_in_rect, Segment_2(Point_2(1.0, 1.0), Point_2(3.0, 1.0))));
+}
+
 TEST(CgalCommTest, projectPointOnHull) {
   PolygonWithHoles poly(
       createRectangleInRectangle<Polygon_2, PolygonWithHoles>());
@@ -86,6 +127,250 @@ TEST(CgalCommTest, projectPointOnHull) {
   EXPECT_EQ(p, projectPointOnHull(poly, p));
 }
 
+TEST(CgalCommTest, PolygonIndex) {
+  const std::vector<PolygonWithHoles> polygons = {
+      createRectangleInRectangle<Polygon_2, PolygonWithHoles>(),
+      createSophisticatedPolygon<Polygon_2, PolygonWithHoles>()};
+  for (const PolygonWithHoles& pwh : polygons) {
+    PolygonIndex index(pwh);
+    // Query points on a grid cover vertices, edges, holes and the outside.
+    for (double x = -1.0; x <= 11.0; x += 0.25) {
+      for (double y = -1.0; y <= 11.0; y += 0.25) {
+        const Point_2 p(x, y);
+        EXPECT_EQ(pointInPolygon(pwh, p), index.containsPoint(p));
+        EXPECT_EQ(projectPointOnHull(pwh, p), index.projectOnHull(p));
+      }
+    }
+    // Query points on the vertices.
+    for (const Point_2& v : getHullVertices(pwh)) {
+      EXPECT_TRUE(index.containsPoint(v));
+      EXPECT_EQ(v, index.projectOnHull(v));
+    }
+    for (const std::vector<Point_2>& hole : getHoleVertices(pwh)) {
+      for (const Point_2& v : hole) {
+        EXPECT_TRUE(index.containsPoint(v));
+        EXPECT_EQ(v, index.projectOnHull(v));
+      }
+    }
+  }
+}
+
+TEST(CgalCommTest, PolygonIndexBatch) {
+  Polygon_2 non_double;
+  non_double.push_back(Point_2(0.0, 0.0));
+  non_double.push_back(Point_2(FT(10.0) / FT(3.0), 0.0));
+  non_double.push_back(Point_2(0.0, 10.0));
+  const std::vector<PolygonWithHoles> polygons = {
+      createRectangleInRectangle<Polygon_2, PolygonWithHoles>(),
+      createSophisticatedPolygon<Polygon_2, PolygonWithHoles>(),
+      PolygonWithHoles(non_double)};
+  for (const PolygonWithHoles& pwh : polygons) {
+    // Grid points cover vertices, edges, holes and the outside. Points that
+    // are not doubles use the exact predicates.
+    std::vector<Point_2> points = getHullVertices(pwh);
+    for (double x = -1.0; x <= 11.0; x += 0.25) {
+      for (double y = -1.0; y <= 11.0; y += 0.25) {
+        points.emplace_back(x, y);
+      }
+    }
+    points.emplace_back(FT(5.0) / FT(3.0), 5.0);
+    points.emplace_back(FT(10.0) / FT(3.0), 0.0);
+    PolygonIndex index(pwh);
+    std::vector<bool> inside;
+    EXPECT_FALSE(index.containsPoints(points, &inside));
+    ASSERT_EQ(points.size(), inside.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+      EXPECT_EQ(pointInPolygon(pwh, points[i]), inside[i]) << points[i];
+    }
+    EXPECT_FALSE(index.containsPoints(points));
+    EXPECT_TRUE(index.containsPoints(getHullVertices(pwh)));
+  }
+}
+
+TEST(CgalCommTest, PolygonIndexIntegerGrid) {
+  // Snapped polygons answer grid queries with integer predicates.
+  PolygonWithHoles pwh =
+      createSophisticatedPolygon<Polygon_2, PolygonWithHoles>();
+  PolygonIndex index(pwh);
+  EXPECT_TRUE(index.hasIntegerGrid());
+  Polygon_2 non_dyadic;
+  non_dyadic.push_back(Point_2(0.0, 0.0));
+  non_dyadic.push_back(Point_2(FT(1.0) / FT(3.0), 0.0));
+  non_dyadic.push_back(Point_2(0.0, 1.0));
+  EXPECT_FALSE(PolygonIndex(PolygonWithHoles(non_dyadic)).hasIntegerGrid());
+
+  // Off-grid queries fall back to the kernel.
+  for (const Point_2& p :
+       {Point_2(0.1, 0.1), Point_2(FT(1.0) / FT(3.0), 1.0),
+        Point_2(10.5, 1.5), Point_2(1.5, 4.5), Point_2(2.0, 4.5)}) {
+    EXPECT_EQ(pointInPolygon(pwh, p), index.containsPoint(p));
+  }
+}
+
+TEST(CgalCommTest, snapPolygonToGrid) {
+  PolygonWithHoles pwh =
+      createSophisticatedPolygon<Polygon_2, PolygonWithHoles>();
+  const double kResolution = 0.001;
+  const double kStep = 0.0009765625;  // 2^-10
+  // Perturb all vertices below the grid resolution.
+  PolygonWithHoles perturbed(pwh);
+  for (auto v = perturbed.outer_boundary().vertices_begin();
+       v != perturbed.outer_boundary().vertices_end(); ++v) {
+    *v = Point_2(v->x() + 1.0e-4, v->y() - 1.0e-4);
+  }
+  EXPECT_FALSE(PolygonIndex(perturbed).hasIntegerGrid());
+
+  PolygonWithHoles snapped(perturbed);
+  EXPECT_TRUE(snapPolygonToGrid(&snapped, kResolution));
+  EXPECT_TRUE(PolygonIndex(snapped).hasIntegerGrid());
+  EXPECT_EQ(pwh.outer_boundary().size(), snapped.outer_boundary().size());
+  EXPECT_EQ(pwh.number_of_holes(), snapped.number_of_holes());
+  EXPECT_TRUE(snapped.outer_boundary().is_counterclockwise_oriented());
+  for (const Point_2& v : getHullVertices(snapped)) {
+    const double x = CGAL::to_double(v.x()) / kStep;
+    const double y = CGAL::to_double(v.y()) / kStep;
+    EXPECT_EQ(std::round(x), x);
+    EXPECT_EQ(std::round(y), y);
+  }
+  EXPECT_NEAR(CGAL::to_double(computeArea(pwh)),
+              CGAL::to_double(computeArea(snapped)), 0.1);
+
+  // A densely sampled, nearly straight edge becomes collinear on the grid.
+  Polygon_2 sampled;
+  for (int i = 0; i < 100; ++i) {
+    sampled.push_back(Point_2(0.1 * i, (i % 2) * 1.0e-5));
+  }
+  sampled.push_back(Point_2(10.0, 0.0));
+  sampled.push_back(Point_2(10.0, 5.0));
+  sampled.push_back(Point_2(0.0, 5.0));
+  PolygonWithHoles straight(sampled);
+  EXPECT_TRUE(snapPolygonToGrid(&straight, kResolution));
+  EXPECT_EQ(4, straight.outer_boundary().size());
+  Polygon_2::Vertex_circulator vc =
+      straight.outer_boundary().vertices_circulator();
+  do {
+    EXPECT_FALSE(CGAL::collinear(*std::prev(vc), *vc, *std::next(vc)));
+  } while (++vc != straight.outer_boundary().vertices_circulator());
+
+  // A coarse grid collapses the polygon.
+  PolygonWithHoles collapsed(pwh);
+  EXPECT_FALSE(snapPolygonToGrid(&collapsed, 100.0));
+  EXPECT_EQ(getHullVertices(pwh), getHullVertices(collapsed));
+}
+
+TEST(CgalCommTest, PolygonFile) {
+  const std::string kFile = "polygon_file-test.pwh";
+  const std::vector<PolygonWithHoles> polygons = {
+      createRectangleInRectangle<Polygon_2, PolygonWithHoles>(),
+      createSophisticatedPolygon<Polygon_2, PolygonWithHoles>()};
+  for (const PolygonWithHoles& pwh : polygons) {
+    ASSERT_TRUE(savePolygonFile(kFile, pwh, 2.5));
+    PolygonWithHoles loaded;
+    double altitude = 0.0;
+    ASSERT_TRUE(loadPolygonFile(kFile, &loaded, &altitude));
+    EXPECT_EQ(2.5, altitude);
+    // The test coordinates are exact in double.
+    EXPECT_EQ(getHullVertices(pwh), getHullVertices(loaded));
+    EXPECT_TRUE(loaded.outer_boundary().is_counterclockwise_oriented());
+    ASSERT_EQ(pwh.number_of_holes(), loaded.number_of_holes());
+    auto loaded_hole = loaded.holes_begin();
+    for (auto h = pwh.holes_begin(); h != pwh.holes_end(); ++h) {
+      EXPECT_TRUE(loaded_hole->is_clockwise_oriented());
+      EXPECT_EQ(CGAL::abs(h->area()), CGAL::abs((loaded_hole++)->area()));
+    }
+  }
+
+  // A truncated file.
+  std::ofstream os(kFile, std::ios::binary | std::ios::trunc);
+  os.write("PCPPOLY", 8);
+  os.close();
+  PolygonWithHoles loaded;
+  double altitude = 0.0;
+  EXPECT_FALSE(loadPolygonFile(kFile, &loaded, &altitude));
+
+  // A non-finite coordinate.
+  os.open(kFile, std::ios::binary | std::ios::trunc);
+  os.write("PCPPOLY", 8);
+  const uint64_t kHeader[] = {1, 0, 0, 3};  // Version, altitude, holes, size.
+  os.write(reinterpret_cast<const char*>(kHeader), sizeof(kHeader));
+  const double kVertices[] = {0.0, 0.0, 1.0, 0.0, 1.0, std::nan("")};
+  os.write(reinterpret_cast<const char*>(kVertices), sizeof(kVertices));
+  os.close();
+  EXPECT_FALSE(loadPolygonFile(kFile, &loaded, &altitude));
+  std::remove(kFile.c_str());
+}
+
+TEST(CgalCommTest, addDisjointHoles) {
+  const PolygonWithHoles rectangle =
+      createRectangleInRectangle<Polygon_2, PolygonWithHoles>();
+  const Polygon_2& hull = rectangle.outer_boundary();
+  std::list<Polygon_2> holes(rectangle.holes_begin(), rectangle.holes_end());
+  PolygonWithHoles pwh;
+  EXPECT_TRUE(addDisjointHoles(hull, holes.begin(), holes.end(), &pwh));
+  EXPECT_EQ(1, pwh.number_of_holes());
+  EXPECT_TRUE(pwh.holes_begin()->is_clockwise_oriented());
+  EXPECT_EQ(computeArea(rectangle), computeArea(pwh));
+
+  // A hole inside the first hole.
+  Polygon_2 nested;
+  nested.push_back(Point_2(0.6, 1.4));
+  nested.push_back(Point_2(0.9, 1.4));
+  nested.push_back(Point_2(0.9, 1.6));
+  holes.push_back(nested);
+  EXPECT_FALSE(addDisjointHoles(hull, holes.begin(), holes.end(), &pwh));
+  holes.pop_back();
+
+  // A hole touching the hull falls back to boolean operations.
+  Polygon_2 touching;
+  touching.push_back(Point_2(1.5, 0.0));
+  touching.push_back(Point_2(1.75, 0.5));
+  touching.push_back(Point_2(1.25, 0.5));
+  holes.push_back(touching);
+  EXPECT_FALSE(addDisjointHoles(hull, holes.begin(), holes.end(), &pwh));
+  const std::list<PolygonWithHoles> difference =
+      computeDifference(hull, holes.begin(), holes.end());
+  ASSERT_EQ(1, difference.size());
+  EXPECT_EQ(FT(3.625), computeArea(difference.front()));
+}
+
+TEST(CgalCommTest, simplifyPolygonBoundary) {
+  // A square with 0.01 zigzag on every edge and a hole close to a corner.
+  PolygonWithHoles pwh;
+  const std::vector<Point_2> corners = {Point_2(0.0, 0.0), Point_2(10.0, 0.0),
+                                        Point_2(10.0, 10.0),
+                                        Point_2(0.0, 10.0)};
+  for (size_t i = 0; i < corners.size(); ++i) {
+    const Point_2& a = corners[i];
+    const Vector_2 d = corners[(i + 1) % corners.size()] - a;
+    const Vector_2 normal(-d.y() / 10.0, d.x() / 10.0);
+    for (int j = 0; j < 100; ++j) {
+      pwh.outer_boundary().push_back(a + d * (j / 100.0) +
+                                     normal * ((j % 2) * 0.01));
+    }
+  }
+  Polygon_2 hole;
+  hole.push_back(Point_2(9.8, 0.1));
+  hole.push_back(Point_2(9.8, 0.2));
+  hole.push_back(Point_2(9.9, 0.2));
+  pwh.add_hole(hole);
+  const PolygonWithHoles original = pwh;
+
+  EXPECT_EQ(0, simplifyPolygonBoundary(&pwh, 0.0));
+  EXPECT_LT(0, simplifyPolygonBoundary(&pwh, 0.5));
+  EXPECT_LT(pwh.outer_boundary().size(), original.outer_boundary().size());
+  EXPECT_TRUE(isStrictlySimple(pwh));
+  EXPECT_TRUE(pwh.outer_boundary().is_counterclockwise_oriented());
+  EXPECT_LE(computeArea(pwh), computeArea(original));
+  // The simplified polygon is inside the original one and keeps the hole.
+  ASSERT_EQ(1, pwh.number_of_holes());
+  for (const Point_2& v : getHullVertices(pwh)) {
+    EXPECT_TRUE(pointInPolygon(original, v));
+  }
+  for (const Point_2& v : hole) {
+    EXPECT_EQ(CGAL::ON_BOUNDED_SIDE, pwh.outer_boundary().bounded_side(v));
+  }
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -37,6 +37,22 @@ TEST(OffsetTest, OffsetPolygon) {
   }
 }
 
+TEST(OffsetTest, ReducedOffsetPolygon) {
+  PolygonWithHoles rectangle_in_rectangle(
+      createRectangleInRectangle<Polygon_2, PolygonWithHoles>());
+
+  // The hole is 0.25 from the outer boundary. A larger offset is reduced.
+  PolygonWithHoles offset_polygon;
+  computeOffsetPolygon(rectangle_in_rectangle, 1.0, &offset_polygon);
+  EXPECT_EQ(rectangle_in_rectangle.outer_boundary().size(),
+            offset_polygon.outer_boundary().size());
+  ASSERT_EQ(rectangle_in_rectangle.number_of_holes(),
+            offset_polygon.number_of_holes());
+  EXPECT_EQ(rectangle_in_rectangle.holes_begin()->size(),
+            offset_polygon.holes_begin()->size());
+  EXPECT_LT(computeArea(offset_polygon), computeArea(rectangle_in_rectangle));
+}
+
 TEST(OffsetTest, OffsetEdge) {
   PolygonWithHoles rectangle_in_rectangle(
       createRectangleInRectangle<Polygon_2, PolygonWithHoles>());
@@ -0,0 +1,73 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "polygon_coverage_geometry/cgal_definitions.h"
+#include "polygon_coverage_geometry/plane_transformation.h"
+#include "polygon_coverage_geometry/test_comm.h"
+
+using namespace polygon_coverage_planning;
+
+const double kPrecision = 1.0e-9;
+
+TEST(PlaneTransformationTest, BatchTo3d) {
+  // Horizontal plane: lift to the altitude.
+  const double kAltitude = 3.0;
+  PlaneTransformation<K> horizontal(Plane_3(0.0, 0.0, 1.0, -kAltitude));
+  std::vector<Point_2> p_2;
+  for (size_t i = 0; i < 100; ++i) {
+    p_2.emplace_back(createRandomDouble(-100.0, 100.0),
+                     createRandomDouble(-100.0, 100.0));
+  }
+  std::vector<double> p_3;
+  horizontal.to3d(p_2, &p_3);
+  ASSERT_EQ(3 * p_2.size(), p_3.size());
+  for (size_t i = 0; i < p_2.size(); ++i) {
+    EXPECT_NEAR(CGAL::to_double(p_2[i].x()), p_3[3 * i], kPrecision);
+    EXPECT_NEAR(CGAL::to_double(p_2[i].y()), p_3[3 * i + 1], kPrecision);
+    EXPECT_NEAR(kAltitude, p_3[3 * i + 2], kPrecision);
+  }
+
+  // Tilted planes: the same as the kernel transformation.
+  const std::vector<Plane_3> planes = {Plane_3(1.0, 2.0, 3.0, 4.0),
+                                       Plane_3(0.0, 1.0, 1.0e-9, -2.0),
+                                       Plane_3(-2.0, 0.5, 0.0, 1.0)};
+  for (const Plane_3& plane : planes) {
+    PlaneTransformation<K> transformation(plane);
+    std::vector<double> xy;
+    for (const Point_2& p : p_2) {
+      xy.push_back(CGAL::to_double(p.x()));
+      xy.push_back(CGAL::to_double(p.y()));
+    }
+    std::vector<double> xyz(3 * p_2.size());
+    transformation.to3d(xy.data(), p_2.size(), xyz.data());
+    for (size_t i = 0; i < p_2.size(); ++i) {
+      const Point_3 expected = transformation.to3d(p_2[i]);
+      EXPECT_NEAR(CGAL::to_double(expected.x()), xyz[3 * i], kPrecision);
+      EXPECT_NEAR(CGAL::to_double(expected.y()), xyz[3 * i + 1], kPrecision);
+      EXPECT_NEAR(CGAL::to_double(expected.z()), xyz[3 * i + 2], kPrecision);
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
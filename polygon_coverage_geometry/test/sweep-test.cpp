@@ -21,6 +21,7 @@
 #include <gtest/gtest.h>
 
 #include "polygon_coverage_geometry/cgal_comm.h"
+#include "polygon_coverage_geometry/counters.h"
 #include "polygon_coverage_geometry/sweep.h"
 #include "polygon_coverage_geometry/test_comm.h"
 
@@ -37,6 +38,105 @@ TEST(SweepTest, computeAllSweeps) {
     EXPECT_GE(waypoints.size(), 4);
     for (const Point_2& p : waypoints) EXPECT_TRUE(pointInPolygon(diamond, p));
   }
+
+  // Parallel directions keep the order.
+  std::vector<std::vector<Point_2>> parallel_sweeps;
+  EXPECT_TRUE(
+      computeAllSweeps(diamond, kMaxSweepDistance, &parallel_sweeps, 2));
+  EXPECT_EQ(cluster_sweeps, parallel_sweeps);
+
+  // The second sweep of a direction is the reversed first sweep.
+  ASSERT_GE(cluster_sweeps.size(), 2);
+  EXPECT_TRUE(std::equal(cluster_sweeps[0].begin(), cluster_sweeps[0].end(),
+                         cluster_sweeps[1].rbegin()));
+}
+
+TEST(SweepTest, findSweepSegment) {
+  Polygon_2 diamond(createDiamond<Polygon_2>());
+  const std::vector<Direction_2> dirs = {Direction_2(1.0, 0.0),
+                                         Direction_2(1.0, 1.0),
+                                         Direction_2(-1.0, 3.0)};
+  // Offsets through vertices, in between and outside the polygon.
+  const std::vector<double> offsets = {-1.0, 0.0, 0.3, 1.0, 1.7, 2.0, 3.5};
+  for (const Direction_2& dir : dirs) {
+    for (double offset : offsets) {
+      const Line_2 l(Point_2(offset, offset), dir);
+      const std::vector<Point_2> intersections = findIntersections(diamond, l);
+      Segment_2 sweep_segment;
+      const bool has_sweep_segment =
+          findSweepSegment(diamond, l, &sweep_segment);
+      EXPECT_EQ(!intersections.empty(), has_sweep_segment) << l;
+      if (has_sweep_segment) {
+        EXPECT_EQ(intersections.front(), sweep_segment.source()) << l;
+        EXPECT_EQ(intersections.back(), sweep_segment.target()) << l;
+      }
+    }
+  }
+
+  // The same geometry functions work on the inexact kernel.
+  typedef CGAL::Polygon_2<InexactKernel> InexactPolygon;
+  InexactPolygon inexact_diamond(createDiamond<InexactPolygon>());
+  const InexactKernel::Line_2 l(InexactKernel::Point_2(0.5, 0.5),
+                                InexactKernel::Direction_2(1.0, 0.0));
+  EXPECT_EQ(static_cast<size_t>(2),
+            findIntersections<InexactKernel>(inexact_diamond, l).size());
+  EXPECT_EQ(inexact_diamond.size(),
+            sortVerticesToLine<InexactKernel>(inexact_diamond, l).size());
+}
+
+TEST(SweepTest, SweepLineIntersector) {
+  Polygon_2 diamond(createDiamond<Polygon_2>());
+  const std::vector<Direction_2> dirs = {Direction_2(1.0, 0.0),
+                                         Direction_2(1.0, 1.0),
+                                         Direction_2(-1.0, 3.0)};
+  // Advance, step back by one line and restart.
+  const std::vector<double> offsets = {-1.0, 0.0, 0.3, 0.2, 1.0, 1.7,
+                                       2.0,  3.5, 0.5, 1.0, 0.0};
+  for (const Direction_2& dir : dirs) {
+    SweepLineIntersector intersector(diamond, dir);
+    for (double offset : offsets) {
+      const Line_2 l(Point_2(offset, offset), dir);
+      Segment_2 expected, sweep_segment;
+      const bool has_sweep_segment = findSweepSegment(diamond, l, &expected);
+      EXPECT_EQ(has_sweep_segment,
+                intersector.findSweepSegment(l, &sweep_segment))
+          << l;
+      if (has_sweep_segment) {
+        EXPECT_EQ(expected, sweep_segment) << l;
+      }
+    }
+  }
+}
+
+TEST(SweepTest, Counters) {
+  Polygon_2 diamond(createDiamond<Polygon_2>());
+  const Line_2 l(Point_2(0.5, 0.5), Direction_2(1.0, 0.0));
+
+  // Nothing is counted by default.
+  counters::Counters::Reset();
+  findIntersections(diamond, l);
+  EXPECT_EQ(0u, counters::Counters::Get(counters::kLinePolygonIntersections));
+
+  counters::Counters::Start();
+  {
+    counters::Stage stage("intersections");
+    findIntersections(diamond, l);
+  }
+  Segment_2 sweep_segment;
+  EXPECT_TRUE(findSweepSegment(diamond, l, &sweep_segment));
+  counters::Counters::Stop();
+  findIntersections(diamond, l);
+
+  EXPECT_EQ(2u, counters::Counters::Get(counters::kLinePolygonIntersections));
+  EXPECT_GE(counters::Counters::Get(counters::kEdgeIntersections),
+            diamond.size());
+  const std::map<std::string, counters::Counts> stages =
+      counters::Counters::GetStages();
+  ASSERT_EQ(1u, stages.count("intersections"));
+  const counters::Counts& counts = stages.at("intersections");
+  EXPECT_EQ(1u, counts[counters::kLinePolygonIntersections]);
+  EXPECT_EQ(diamond.size(), counts[counters::kEdgeIntersections]);
+  counters::Counters::Reset();
 }
 
 int main(int argc, char** argv) {
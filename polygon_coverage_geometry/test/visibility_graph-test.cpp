@@ -17,12 +17,17 @@
  * this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <cmath>
 #include <functional>
 
 #include <gtest/gtest.h>
+#include <polygon_coverage_solvers/parallel.h>
 
 #include "polygon_coverage_geometry/cgal_comm.h"
+#include "polygon_coverage_geometry/rotational_sweep.h"
 #include "polygon_coverage_geometry/test_comm.h"
+#include "polygon_coverage_geometry/triangulation.h"
 #include "polygon_coverage_geometry/visibility_graph.h"
 
 using namespace polygon_coverage_planning;
@@ -48,6 +53,249 @@ TEST(VisibilityGraphTest, ShortestPath) {
   }
 }
 
+TEST(VisibilityGraphTest, ShortestPathCache) {
+  PolygonWithHoles p(createRectangleInRectangle<Polygon_2, PolygonWithHoles>());
+
+  Point_2 start(0.0, 2.0);
+  Point_2 goal(2.0, 0.0);
+  visibility_graph::VisibilityGraph graph(p);
+  EXPECT_TRUE(graph.isInitialized());
+  EXPECT_EQ(0, graph.getNumberOfCachedPaths());
+
+  std::vector<Point_2> path;
+  EXPECT_FALSE(graph.findCachedPath(start, goal, &path));
+  EXPECT_TRUE(graph.solve(start, goal, &path));
+  EXPECT_EQ(1, graph.getNumberOfCachedPaths());
+
+  // Both directions are served from the cache.
+  std::vector<Point_2> cached_path;
+  EXPECT_TRUE(graph.findCachedPath(start, goal, &cached_path));
+  EXPECT_EQ(path, cached_path);
+  EXPECT_TRUE(graph.findCachedPath(goal, start, &cached_path));
+  std::reverse(cached_path.begin(), cached_path.end());
+  EXPECT_EQ(path, cached_path);
+
+  // Copies share the cache.
+  visibility_graph::VisibilityGraph copy = graph;
+  std::vector<Point_2> reverse_path;
+  EXPECT_TRUE(copy.solve(goal, start, &reverse_path));
+  EXPECT_EQ(1, graph.getNumberOfCachedPaths());
+  std::reverse(reverse_path.begin(), reverse_path.end());
+  EXPECT_EQ(path, reverse_path);
+}
+
+TEST(VisibilityGraphTest, RotationalSweep) {
+  const std::vector<PolygonWithHoles> polygons = {
+      createRectangleInRectangle<Polygon_2, PolygonWithHoles>(),
+      createSophisticatedPolygon<Polygon_2, PolygonWithHoles>()};
+  for (PolygonWithHoles p : polygons) {
+    sortVertices(&p);
+    std::vector<Point_2> vertices = getHullVertices(p);
+    for (const std::vector<Point_2>& hole : getHoleVertices(p)) {
+      vertices.insert(vertices.end(), hole.begin(), hole.end());
+    }
+
+    // The sweep agrees with the segment test for all vertex pairs.
+    for (size_t i = 0; i < vertices.size(); ++i) {
+      const std::vector<bool> visible = computeVisibleVertices(p, i);
+      ASSERT_EQ(vertices.size(), visible.size());
+      for (size_t j = 0; j < vertices.size(); ++j) {
+        if (i == j) continue;
+        EXPECT_EQ(segmentInPolygon(p, Segment_2(vertices[i], vertices[j])),
+                  visible[j])
+            << vertices[i] << " to " << vertices[j];
+      }
+    }
+  }
+}
+
+TEST(VisibilityGraphTest, ShortestPathTable) {
+  PolygonWithHoles p(createSophisticatedPolygon<Polygon_2, PolygonWithHoles>());
+  visibility_graph::VisibilityGraph graph(p);
+  visibility_graph::VisibilityGraph table_graph(p, 2);
+  EXPECT_FALSE(table_graph.hasShortestPathTable());
+  EXPECT_TRUE(table_graph.createShortestPathTable());
+  EXPECT_TRUE(table_graph.hasShortestPathTable());
+
+  auto length = [](const std::vector<Point_2>& path) {
+    double length = 0.0;
+    for (size_t i = 1; i < path.size(); ++i) {
+      length += std::sqrt(
+          CGAL::to_double(CGAL::squared_distance(path[i - 1], path[i])));
+    }
+    return length;
+  };
+
+  // Table lookups and graph searches find equally short paths.
+  const std::vector<Point_2> points(p.outer_boundary().vertices_begin(),
+                                    p.outer_boundary().vertices_end());
+  for (const Point_2& start : points) {
+    for (const Point_2& goal : points) {
+      std::vector<Point_2> path, table_path;
+      EXPECT_TRUE(graph.solve(start, goal, &path));
+      EXPECT_TRUE(table_graph.solve(start, goal, &table_path));
+      EXPECT_NEAR(length(path), length(table_path), 1.0e-6);
+      ASSERT_FALSE(table_path.empty());
+      EXPECT_EQ(start, table_path.front());
+      EXPECT_EQ(goal, table_path.back());
+    }
+  }
+}
+
+TEST(VisibilityGraphTest, OneToMany) {
+  PolygonWithHoles p(createSophisticatedPolygon<Polygon_2, PolygonWithHoles>());
+  visibility_graph::VisibilityGraph graph(p);
+  visibility_graph::VisibilityGraph one_to_many_graph(p);
+
+  auto length = [](const std::vector<Point_2>& path) {
+    double length = 0.0;
+    for (size_t i = 1; i < path.size(); ++i) {
+      length += std::sqrt(
+          CGAL::to_double(CGAL::squared_distance(path[i - 1], path[i])));
+    }
+    return length;
+  };
+
+  // A single search finds paths as short as one search per goal.
+  const std::vector<Point_2> points(p.outer_boundary().vertices_begin(),
+                                    p.outer_boundary().vertices_end());
+  const std::vector<const Polygon_2*> visibility_polygons(points.size(),
+                                                          nullptr);
+  for (const Point_2& start : points) {
+    std::vector<std::vector<Point_2>> paths;
+    std::vector<double> costs;
+    EXPECT_TRUE(one_to_many_graph.solveOneToMany(
+        start, nullptr, points, visibility_polygons, &paths, &costs));
+    ASSERT_EQ(points.size(), paths.size());
+    ASSERT_EQ(points.size(), costs.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+      std::vector<Point_2> path;
+      EXPECT_TRUE(graph.solve(start, points[i], &path));
+      EXPECT_NEAR(length(path), costs[i], 1.0e-6);
+      EXPECT_NEAR(length(path), length(paths[i]), 1.0e-6);
+      ASSERT_FALSE(paths[i].empty());
+      EXPECT_EQ(start, paths[i].front());
+      EXPECT_EQ(points[i], paths[i].back());
+    }
+  }
+}
+
+TEST(VisibilityGraphTest, Bitangent) {
+  PolygonWithHoles p(createSophisticatedPolygon<Polygon_2, PolygonWithHoles>());
+  visibility_graph::VisibilityGraph graph(p);
+  visibility_graph::VisibilityGraph bitangent_graph(p, 1, true);
+  EXPECT_LT(bitangent_graph.getNumberOfEdges(), graph.getNumberOfEdges());
+
+  auto length = [](const std::vector<Point_2>& path) {
+    double length = 0.0;
+    for (size_t i = 1; i < path.size(); ++i) {
+      length += std::sqrt(
+          CGAL::to_double(CGAL::squared_distance(path[i - 1], path[i])));
+    }
+    return length;
+  };
+
+  // Only bitangent edges lie on shortest paths.
+  const std::vector<Point_2> points(p.outer_boundary().vertices_begin(),
+                                    p.outer_boundary().vertices_end());
+  for (const Point_2& start : points) {
+    for (const Point_2& goal : points) {
+      std::vector<Point_2> path, bitangent_path;
+      EXPECT_TRUE(graph.solve(start, goal, &path));
+      EXPECT_TRUE(bitangent_graph.solve(start, goal, &bitangent_path));
+      EXPECT_NEAR(length(path), length(bitangent_path), 1.0e-6);
+    }
+  }
+}
+
+TEST(VisibilityGraphTest, ConcurrentQueries) {
+  PolygonWithHoles p(createSophisticatedPolygon<Polygon_2, PolygonWithHoles>());
+  const visibility_graph::VisibilityGraph graph(p);
+  const visibility_graph::VisibilityGraph shared_graph(p);
+
+  std::vector<std::pair<Point_2, Point_2>> queries;
+  const std::vector<Point_2> points(p.outer_boundary().vertices_begin(),
+                                    p.outer_boundary().vertices_end());
+  for (const Point_2& start : points) {
+    for (const Point_2& goal : points) {
+      queries.emplace_back(start, goal);
+    }
+  }
+
+  // Many threads share one graph and its caches.
+  std::vector<std::vector<Point_2>> paths(queries.size());
+  EXPECT_TRUE(parallelFor(queries.size(), 4, [&](size_t i) {
+    return shared_graph.solve(queries[i].first, queries[i].second, &paths[i]);
+  }));
+  auto length = [](const std::vector<Point_2>& path) {
+    double length = 0.0;
+    for (size_t i = 1; i < path.size(); ++i) {
+      length += std::sqrt(
+          CGAL::to_double(CGAL::squared_distance(path[i - 1], path[i])));
+    }
+    return length;
+  };
+  for (size_t i = 0; i < queries.size(); ++i) {
+    std::vector<Point_2> path;
+    EXPECT_TRUE(graph.solve(queries[i].first, queries[i].second, &path));
+    EXPECT_NEAR(length(path), length(paths[i]), 1.0e-6);
+    ASSERT_FALSE(paths[i].empty());
+    EXPECT_EQ(queries[i].first, paths[i].front());
+    EXPECT_EQ(queries[i].second, paths[i].back());
+  }
+}
+
+TEST(VisibilityGraphTest, TriangulationShortestPath) {
+  auto length = [](const std::vector<Point_2>& path) {
+    double length = 0.0;
+    for (size_t i = 1; i < path.size(); ++i) {
+      length += std::sqrt(
+          CGAL::to_double(CGAL::squared_distance(path[i - 1], path[i])));
+    }
+    return length;
+  };
+
+  // Without holes the funnel finds the shortest path.
+  PolygonWithHoles p(createSophisticatedPolygon<Polygon_2, PolygonWithHoles>());
+  const PolygonWithHoles simple(p.outer_boundary());
+  const std::vector<Point_2> points(p.outer_boundary().vertices_begin(),
+                                    p.outer_boundary().vertices_end());
+  visibility_graph::VisibilityGraph graph(simple);
+  TriangulationShortestPath funnel(simple);
+  EXPECT_GT(funnel.getNumberOfFaces(), 0u);
+  for (const Point_2& start : points) {
+    for (const Point_2& goal : points) {
+      std::vector<Point_2> path, funnel_path;
+      EXPECT_TRUE(graph.solve(start, goal, &path));
+      EXPECT_TRUE(funnel.solve(start, goal, &funnel_path));
+      EXPECT_NEAR(length(path), length(funnel_path), 1.0e-6);
+      ASSERT_FALSE(funnel_path.empty());
+      EXPECT_EQ(start, funnel_path.front());
+      EXPECT_EQ(goal, funnel_path.back());
+    }
+  }
+
+  // With holes the path is feasible but may be longer.
+  visibility_graph::VisibilityGraph graph_with_holes(p);
+  TriangulationShortestPath funnel_with_holes(p);
+  for (const Point_2& start : points) {
+    for (const Point_2& goal : points) {
+      std::vector<Point_2> path, funnel_path;
+      EXPECT_TRUE(graph_with_holes.solve(start, goal, &path));
+      EXPECT_TRUE(funnel_with_holes.solve(start, goal, &funnel_path));
+      EXPECT_GE(length(funnel_path), length(path) - 1.0e-6);
+      for (size_t i = 1; i < funnel_path.size(); ++i) {
+        EXPECT_TRUE(segmentInPolygon(
+            p, Segment_2(funnel_path[i - 1], funnel_path[i])));
+      }
+    }
+  }
+
+  // Points outside the polygon.
+  std::vector<Point_2> path;
+  EXPECT_FALSE(funnel.solve(Point_2(-100.0, -100.0), points.front(), &path));
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -23,6 +23,7 @@
 #include "polygon_coverage_geometry/cgal_comm.h"
 #include "polygon_coverage_geometry/test_comm.h"
 #include "polygon_coverage_geometry/visibility_polygon.h"
+#include "polygon_coverage_geometry/visibility_polygon_cache.h"
 
 using namespace polygon_coverage_planning;
 
@@ -107,6 +108,62 @@ TEST(VisibilityPolygonTest, computeVisibilityPolygon) {
   EXPECT_EQ(Point_2(2, 0), *vit++);
 }
 
+TEST(VisibilityPolygonTest, VisibilityOracle) {
+  PolygonWithHoles rectangle_in_rectangle(
+      createRectangleInRectangle<Polygon_2, PolygonWithHoles>());
+  VisibilityOracle oracle(rectangle_in_rectangle);
+
+  // Face, outer vertex, outer edge, hole vertex and hole edge queries.
+  const std::vector<Point_2> queries = {Point_2(0.5, 0.5), Point_2(0.0, 0.0),
+                                        Point_2(1.0, 0.0), Point_2(1.0, 1.25),
+                                        Point_2(0.75, 1.25)};
+  for (const Point_2& query : queries) {
+    Polygon_2 expected, visibility_polygon;
+    EXPECT_TRUE(
+        computeVisibilityPolygon(rectangle_in_rectangle, query, &expected));
+    EXPECT_TRUE(oracle.compute(query, &visibility_polygon));
+    EXPECT_EQ(expected, visibility_polygon);
+  }
+}
+
+TEST(VisibilityPolygonTest, VisibilityPolygonCache) {
+  PolygonWithHoles rectangle_in_rectangle(
+      createRectangleInRectangle<Polygon_2, PolygonWithHoles>());
+  VisibilityPolygonCache cache(rectangle_in_rectangle, 2);
+  EXPECT_EQ(static_cast<size_t>(0), cache.size());
+
+  const Point_2 a(0.0, 0.0), b(1.0, 1.25), c(2.0, 0.0);
+  Polygon_2 expected, visibility_polygon;
+  EXPECT_TRUE(computeVisibilityPolygon(rectangle_in_rectangle, a, &expected));
+  EXPECT_TRUE(cache.compute(a, &visibility_polygon));
+  EXPECT_EQ(expected, visibility_polygon);
+  EXPECT_TRUE(cache.compute(a, &visibility_polygon));
+  EXPECT_EQ(expected, visibility_polygon);
+  EXPECT_EQ(static_cast<size_t>(1), cache.size());
+
+  // The least recently used point is evicted.
+  EXPECT_TRUE(cache.compute(b, &visibility_polygon));
+  EXPECT_TRUE(cache.compute(a, &visibility_polygon));
+  EXPECT_TRUE(cache.compute(c, &visibility_polygon));
+  EXPECT_EQ(static_cast<size_t>(2), cache.size());
+  EXPECT_TRUE(cache.compute(a, &visibility_polygon));
+  EXPECT_EQ(expected, visibility_polygon);
+
+  cache.clear();
+  EXPECT_EQ(static_cast<size_t>(0), cache.size());
+
+  // Batched queries, including a repeated point.
+  const std::vector<Point_2> queries = {a, b, c, a};
+  std::vector<Polygon_2> visibility_polygons;
+  EXPECT_TRUE(cache.compute(queries, 2, &visibility_polygons));
+  ASSERT_EQ(queries.size(), visibility_polygons.size());
+  for (size_t i = 0; i < queries.size(); ++i) {
+    EXPECT_TRUE(computeVisibilityPolygon(rectangle_in_rectangle, queries[i],
+                                         &expected));
+    EXPECT_EQ(expected, visibility_polygons[i]);
+  }
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
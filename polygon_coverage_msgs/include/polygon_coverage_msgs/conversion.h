@@ -24,8 +24,13 @@
 #include <polygon_coverage_geometry/cgal_definitions.h>
 #include <polygon_coverage_msgs/PolygonWithHoles.h>
 
+#include <list>
+#include <vector>
+
 namespace polygon_coverage_planning {
 
+// The conversions size their destinations exactly and write in place, such
+// that reused messages and polygons keep their capacity.
 void convertPolygonWithHolesToMsg(const PolygonWithHoles& pwh,
                                   const double altitude,
                                   polygon_coverage_msgs::PolygonWithHoles* msg);
@@ -33,6 +38,20 @@ void convertPolygonWithHolesToMsg(const PolygonWithHoles& pwh,
 void convertPolygonToMsg(const Polygon_2& p, const double altitude,
                          geometry_msgs::Polygon* msg);
 
+// Batch variant, e.g., for all cells of a decomposition.
+void convertPolygonsWithHolesToMsg(
+    const std::vector<PolygonWithHoles>& pwhs, const double altitude,
+    std::vector<polygon_coverage_msgs::PolygonWithHoles>* msgs);
+
+// Ignores z.
+void convertPolygonFromMsg(const geometry_msgs::Polygon& msg, Polygon_2* p);
+
+// Batch variant, e.g., for all holes of a message. Replaces the content of
+// polygons.
+void convertPolygonsFromMsg(
+    const polygon_coverage_msgs::PolygonWithHoles::_holes_type& msgs,
+    std::list<Polygon_2>* polygons);
+
 }  // namespace polygon_coverage_planning
 
 #endif  // POLYGON_COVERAGE_MSGS_CONVERSION_H_
@@ -31,24 +31,56 @@ void convertPolygonWithHolesToMsg(
   ROS_ASSERT(msg);
 
   convertPolygonToMsg(pwh.outer_boundary(), altitude, &msg->hull);
-  for (auto h = pwh.holes_begin(); h != pwh.holes_end(); ++h) {
-    geometry_msgs::Polygon hole;
-    convertPolygonToMsg(*h, altitude, &hole);
-    msg->holes.push_back(hole);
+  msg->holes.resize(pwh.number_of_holes());
+  auto hole_msg = msg->holes.begin();
+  for (auto h = pwh.holes_begin(); h != pwh.holes_end(); ++h, ++hole_msg) {
+    convertPolygonToMsg(*h, altitude, &(*hole_msg));
   }
 }
 
 void convertPolygonToMsg(const Polygon_2& p, const double altitude,
                          geometry_msgs::Polygon* msg) {
   ROS_ASSERT(msg);
-  msg->points.clear();
-
-  for (auto v = p.vertices_begin(); v != p.vertices_end(); ++v) {
-    geometry_msgs::Point32 pt;
-    pt.x = CGAL::to_double(v->x());
-    pt.y = CGAL::to_double(v->y());
-    pt.z = altitude;
-    msg->points.push_back(pt);
+  msg->points.resize(p.size());
+
+  auto pt = msg->points.begin();
+  for (auto v = p.vertices_begin(); v != p.vertices_end(); ++v, ++pt) {
+    pt->x = CGAL::to_double(v->x());
+    pt->y = CGAL::to_double(v->y());
+    pt->z = altitude;
+  }
+}
+
+void convertPolygonsWithHolesToMsg(
+    const std::vector<PolygonWithHoles>& pwhs, const double altitude,
+    std::vector<polygon_coverage_msgs::PolygonWithHoles>* msgs) {
+  ROS_ASSERT(msgs);
+  msgs->resize(pwhs.size());
+
+  for (size_t i = 0; i < pwhs.size(); ++i) {
+    convertPolygonWithHolesToMsg(pwhs[i], altitude, &(*msgs)[i]);
+  }
+}
+
+void convertPolygonFromMsg(const geometry_msgs::Polygon& msg, Polygon_2* p) {
+  ROS_ASSERT(p);
+  p->clear();
+  p->container().reserve(msg.points.size());
+
+  for (const geometry_msgs::Point32& pt : msg.points) {
+    p->push_back(Point_2(pt.x, pt.y));
+  }
+}
+
+void convertPolygonsFromMsg(
+    const polygon_coverage_msgs::PolygonWithHoles::_holes_type& msgs,
+    std::list<Polygon_2>* polygons) {
+  ROS_ASSERT(polygons);
+  polygons->resize(msgs.size());
+
+  auto p = polygons->begin();
+  for (auto msg = msgs.begin(); msg != msgs.end(); ++msg, ++p) {
+    convertPolygonFromMsg(*msg, &(*p));
   }
 }
 
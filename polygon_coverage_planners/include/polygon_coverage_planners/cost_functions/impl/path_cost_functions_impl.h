@@ -0,0 +1,51 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POLYGON_COVERAGE_PLANNERS_COST_FUNCTIONS_PATH_COST_FUNCTIONS_IMPL_H_
+#define POLYGON_COVERAGE_PLANNERS_COST_FUNCTIONS_PATH_COST_FUNCTIONS_IMPL_H_
+
+namespace polygon_coverage_planning {
+
+template <class SegmentKernel>
+double computeSegmentPathCost(const double* x, const double* y,
+                              size_t num_points, const SegmentKernel& kernel) {
+  double cost = 0.0;
+  for (size_t i = 1; i < num_points; ++i) {
+    cost += kernel(x[i] - x[i - 1], y[i] - y[i - 1]);
+  }
+  return cost;
+}
+
+template <class SegmentKernel>
+double computeSegmentPathCost(const std::vector<Point_2>& path,
+                              const SegmentKernel& kernel) {
+  // Reuse the coordinate buffers of this thread across calls.
+  thread_local std::vector<double> x, y;
+  x.resize(path.size());
+  y.resize(path.size());
+  for (size_t i = 0; i < path.size(); ++i) {
+    x[i] = CGAL::to_double(path[i].x());
+    y[i] = CGAL::to_double(path[i].y());
+  }
+  return computeSegmentPathCost(x.data(), y.data(), path.size(), kernel);
+}
+
+}  // namespace polygon_coverage_planning
+
+#endif  // POLYGON_COVERAGE_PLANNERS_COST_FUNCTIONS_PATH_COST_FUNCTIONS_IMPL_H_
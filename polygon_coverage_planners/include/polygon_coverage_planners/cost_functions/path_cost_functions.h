@@ -20,7 +20,9 @@
 #ifndef POLYGON_COVERAGE_PLANNERS_COST_FUNCTIONS_PATH_COST_FUNCTIONS_H_
 #define POLYGON_COVERAGE_PLANNERS_COST_FUNCTIONS_PATH_COST_FUNCTIONS_H_
 
+#include <cmath>
 #include <functional>
+#include <string>
 #include <vector>
 
 #include <polygon_coverage_geometry/cgal_definitions.h>
@@ -30,6 +32,84 @@ namespace polygon_coverage_planning {
 typedef std::function<double(const std::vector<Point_2>& path)>
     PathCostFunction;
 
+enum CostFunctionType {
+  kDistance = 0,  // Minimize distance.
+  kTime,          // Minimize flight time.
+  kWaypoints
+};
+
+// Segment cost kernels evaluated on the double coordinate difference of two
+// consecutive waypoints. Inlined into computeSegmentPathCost at compile time.
+struct EuclideanSegmentKernel {
+  inline double operator()(double dx, double dy) const {
+    return std::sqrt(dx * dx + dy * dy);
+  }
+};
+
+// Rest-to-rest time assuming trapazoidal velocity profiles.
+struct VelocityRampSegmentKernel {
+  VelocityRampSegmentKernel(double v_max, double a_max);
+  inline double operator()(double dx, double dy) const {
+    const double distance = std::sqrt(dx * dx + dy * dy);
+    return distance < 2.0 * acc_distance
+               ? 2.0 * std::sqrt(distance / a_max)
+               : 2.0 * acc_time + (distance - 2.0 * acc_distance) / v_max;
+  }
+  double v_max;
+  double a_max;
+  double acc_time;      // Time to accelerate to maximum velocity.
+  double acc_distance;  // Distance covered during complete acceleration.
+};
+
+// Sum the segment costs of a path given as x and y coordinate arrays. The
+// loop has no dependencies but the sum and vectorizes.
+template <class SegmentKernel>
+double computeSegmentPathCost(const double* x, const double* y,
+                              size_t num_points, const SegmentKernel& kernel);
+// Convert the path to doubles once and sum its segment costs.
+template <class SegmentKernel>
+double computeSegmentPathCost(const std::vector<Point_2>& path,
+                              const SegmentKernel& kernel);
+
+// A built-in cost function. Wrapped into a PathCostFunction with
+// makePathCostFunction it can be recovered with getPathCostKernel, such that
+// callers evaluate it with the compile-time kernels instead of through the
+// type-erased call. Custom cost functions remain plain PathCostFunctions.
+class PathCostKernel {
+ public:
+  explicit PathCostKernel(CostFunctionType type, double v_max = 1.0,
+                          double a_max = 1.0);
+
+  double operator()(const std::vector<Point_2>& path) const;
+  double operator()(const double* x, const double* y,
+                    size_t num_points) const;
+  // The cost of the path {from, to} without creating it.
+  double computeSegmentCost(const Point_2& from, const Point_2& to) const;
+  // The cost of a segment with the double coordinate difference dx, dy.
+  double computeSegmentCost(double dx, double dy) const;
+
+  inline CostFunctionType getType() const { return type_; }
+
+ private:
+  CostFunctionType type_;
+  VelocityRampSegmentKernel velocity_ramp_;
+};
+
+PathCostFunction makePathCostFunction(CostFunctionType type,
+                                      double v_max = 1.0, double a_max = 1.0);
+
+// Returns the built-in kernel held by cost_function or nullptr if it is a
+// custom cost function.
+inline const PathCostKernel* getPathCostKernel(
+    const PathCostFunction& cost_function) {
+  return cost_function.target<PathCostKernel>();
+}
+
+// Evaluate the cost of the path {from, to}. Uses the kernel if cost_function
+// is built-in.
+double computeSegmentCost(const PathCostFunction& cost_function,
+                          const Point_2& from, const Point_2& to);
+
 // Returns the number of waypoints as cost.
 double computeWaypointsPathCost(const std::vector<Point_2>& path);
 
@@ -49,11 +129,6 @@ double computeVelocityRampPathCost(const std::vector<Point_2>& path,
 double computeVelocityRampSegmentCost(const Point_2& from, const Point_2& to,
                                       double v_max, double a_max);
 
-enum CostFunctionType {
-  kDistance = 0,  // Minimize distance.
-  kTime,          // Minimize flight time.
-  kWaypoints
-};
 
 inline bool checkCostFunctionTypeValid(const int type) {
   return (type == CostFunctionType::kDistance) ||
@@ -76,4 +151,6 @@ inline std::string getCostFunctionTypeName(const CostFunctionType& type) {
 
 }  // namespace polygon_coverage_planning
 
+#include "polygon_coverage_planners/cost_functions/impl/path_cost_functions_impl.h"
+
 #endif  // POLYGON_COVERAGE_PLANNERS_COST_FUNCTIONS_PATH_COST_FUNCTIONS_H_
@@ -20,35 +20,37 @@
 #ifndef POLYGON_COVERAGE_PLANNERS_GRAPHS_GTSPP_PRODUCT_GRAPH_H_
 #define POLYGON_COVERAGE_PLANNERS_GRAPHS_GTSPP_PRODUCT_GRAPH_H_
 
+#include <cstdint>
 #include <limits>
+#include <string>
 #include <vector>
 
-#include <polygon_coverage_solvers/boolean_lattice.h>
-#include <polygon_coverage_solvers/graph_base.h>
+#include <polygon_coverage_solvers/bitmask_lattice.h>
+#include <polygon_coverage_solvers/deadline.h>
+#include <polygon_coverage_solvers/graph_search.h>
 
 #include "polygon_coverage_planners/graphs/sweep_plan_graph.h"
 
 namespace polygon_coverage_planning {
 namespace gtspp_product_graph {
-// Internal node property. Stores the product graph information, i.e., the
-// corresponding sweep plan graph ID and boolean lattice ID.
-struct NodeProperty {
-  NodeProperty()
-      : sweep_plan_graph_id(std::numeric_limits<size_t>::max()),
-        boolean_lattice_id(std::numeric_limits<size_t>::max()) {}
-  NodeProperty(size_t sweep_plan_graph_id, size_t boolean_lattice_id)
-      : sweep_plan_graph_id(sweep_plan_graph_id),
-        boolean_lattice_id(boolean_lattice_id) {}
-  size_t sweep_plan_graph_id;
-  size_t boolean_lattice_id;
+
+// The upfront size of a product graph and of one search over it.
+struct MemoryEstimate {
+  size_t num_nodes = 0;     // Product graph nodes of a query.
+  size_t num_edges = 0;     // Stored product graph edges. 0 if implicit.
+  size_t graph_bytes = 0;   // Memory of the stored product graph.
+  size_t search_bytes = 0;  // Memory of the search buffers of a query.
+  inline size_t getTotalBytes() const { return graph_bytes + search_bytes; }
 };
 
-// Internal edge property. Stores information if an edge is E1 or E2.
-struct EdgeProperty {
-  enum Type { kE1 = 0, kE2, kUnknown };
-  EdgeProperty() : type(kUnknown) {}
-  EdgeProperty(Type type) : type(type) {}
-  Type type;
+// The cost-to-go of every product node towards one goal. Product node ids are
+// as in the product graph. Nodes without a path to the goal cost infinity.
+struct ReverseTree {
+  Point_2 goal;
+  sweep_plan_graph::Overlay goal_overlay;  // The goal and its edges.
+  std::vector<size_t> clusters;            // The cluster of every sweep.
+  std::vector<double> cost_to_go;
+  std::vector<uint32_t> next;  // The next sweep on the cheapest path.
 };
 
 // The GTSPP product graph is a product of boolean lattice and sweep plan graph.
@@ -56,91 +58,112 @@ struct EdgeProperty {
 // yet. Thus a normal graph search algorithm, e.g., Dijkstra, finds an optimal
 // solution. For details see: M. Rice, V. Tsotras, "Exact Graph Search
 // Algorithms for Generalized Traveling Salesman Path Problems"
-// It's a directed graph.
-class GtsppProductGraph : public GraphBase<NodeProperty, EdgeProperty> {
+// It's a directed graph. A product node id is computed from the visited
+// cluster bitmask and the sweep plan graph id:
+// id = mask * number of sweep plan graph nodes + sweep plan graph id.
+// No node properties are stored.
+class GtsppProductGraph {
  public:
-  GtsppProductGraph() : GtsppProductGraph(nullptr, nullptr) {}
-  GtsppProductGraph(const sweep_plan_graph::SweepPlanGraph* sweep_plan_graph,
-                    const boolean_lattice::BooleanLattice* boolean_lattice)
-      : GraphBase(),
-        sweep_plan_graph_(sweep_plan_graph),
-        boolean_lattice_(boolean_lattice) {}
-
-  // Compute the product graph given sweep plan graph and boolean lattice.
-  virtual bool create() override;
-  // Allocate nodes but do not create edges.
+  GtsppProductGraph() : GtsppProductGraph(nullptr) {}
+  GtsppProductGraph(const sweep_plan_graph::SweepPlanGraph* sweep_plan_graph)
+      : sweep_plan_graph_(sweep_plan_graph), is_created_(false) {}
+
+  // Precompute the product graph of the sweep plan graph and the lattice of
+  // its clusters. Only the edges are stored in a compressed sparse row layout.
+  bool create();
+  // Prepare the implicit product graph. Nodes and edges are generated during
+  // search and never materialized. Only requires the sweep plan graph.
   bool createOnline();
-  virtual void clear() override;
-  // Add a start node.
-  virtual bool addStartNode(const NodeProperty& node_property) override;
-  bool addStartNode();
-  // Add a goal node.
-  virtual bool addGoalNode(const NodeProperty& node_property) override;
-  bool addGoalNode();
+  void clear();
+
+  // Save the precomputed product graph to a versioned binary file. The file
+  // is keyed by the snapshot key of the sweep plan graph. The boolean lattice
+  // is implicit and only the number of clusters is stored.
+  bool save(const std::string& file) const;
+  // Load a product graph that was saved for an identical sweep plan graph,
+  // e.g., one loaded from the matching snapshot. Returns false and leaves the
+  // product graph uncreated if the file is missing, corrupt, of another
+  // version or saved for another sweep plan graph.
+  bool load(const std::string& file);
+
+  inline bool isInitialized() const { return is_created_; }
+  // The number of precomputed product nodes. 0 if implicit.
+  inline size_t size() const {
+    return offsets_.empty() ? 0 : offsets_.size() - 1;
+  }
+  inline size_t getNumberOfEdges() const { return neighbors_.size(); }
 
   // Update adjacency graph, e.g., when setting start and goal.
   inline void setSweepPlanGraph(
       const sweep_plan_graph::SweepPlanGraph* sweep_plan_graph) {
     sweep_plan_graph_ = sweep_plan_graph;
   }
-  // Update boolean lattice, e.g., when setting start and goal.
-  inline void setBooleanLattice(
-      const boolean_lattice::BooleanLattice* boolean_lattice) {
-    boolean_lattice_ = boolean_lattice;
-  }
 
-  // Solve the graph with Dijsktra search.
+  // Estimate the memory of create() (precompute) or createOnline() and of one
+  // query without allocating it. Returns false if the product graph is not
+  // addressable.
+  static bool estimateMemory(
+      const sweep_plan_graph::SweepPlanGraph& sweep_plan_graph,
+      bool precompute, MemoryEstimate* estimate);
+
+  // Solve the graph with A* search. Start and goal are searched on top of the
+  // shared product graph without copying it.
+  // deadline: Aborts the search. A* has no intermediate solution, so the
+  // search fails on expiry. Searches time out after 200 s regardless.
   bool solve(const Point_2& start, const Point_2& goal,
-             std::vector<Point_2>* waypoints) const;
-  // Build the graph while performing Dijkstra search.
-  bool solveOnline(const Point_2& start, const Point_2& goal,
-                   std::vector<Point_2>* waypoints) const;
-  // Given a solution, get the concatenated sweep plan graph waypoints.
-  bool getWaypoints(const Solution& solution,
+             std::vector<Point_2>* waypoints,
+             const Deadline& deadline = Deadline()) const;
+  // Search the implicit product graph with A*.
+  // upper_bound: Prune all paths that cost more, e.g., the cost of a
+  // heuristic solution. Fails if there is no cheaper solution.
+  // deadline: As in solve(). Its cancellation token aborts the search from
+  // another thread.
+  bool solveOnline(
+      const Point_2& start, const Point_2& goal,
+      std::vector<Point_2>* waypoints,
+      double upper_bound = std::numeric_limits<double>::infinity(),
+      const Deadline& deadline = Deadline()) const;
+
+  // Search backwards from the goal once by dynamic programming over the
+  // visited cluster sets in decreasing order. The tree has one entry per
+  // product node, i.e., memory grows with 2^clusters like a search.
+  // deadline: Fails on expiry.
+  bool createReverseTree(const Point_2& goal, ReverseTree* tree,
+                         const Deadline& deadline = Deadline()) const;
+  // Solve from a new start to the goal of the tree. Only the edges from the
+  // start are computed. The first sweep minimizes its edge cost plus the
+  // cost-to-go, so the solution is optimal like solveOnline.
+  bool solveReverse(const ReverseTree& tree, const Point_2& start,
                     std::vector<Point_2>* waypoints) const;
 
  private:
-  // Nodes are connected based on E1 or E2 criterion.
-  bool addEdges();
-
-  // E1: Two vertices u, v are connected inside the same "combination set" c if
-  // - they share the same boolean lattice node (c=c') AND
-  // - they are connected in the original sweep plan graph ((u,v) \in E) AND
-  // - v does belong to the covered polygons of c AND
-  // - u does not belong to the covered polygons of c.
-  bool isE1(const EdgeId& edge_id) const;
-  bool isE1(size_t from_boolean_lattice_id, size_t to_boolean_lattice_id,
-            size_t from_sweep_plan_graph_id, size_t to_sweep_plan_graph_id,
-            const std::set<size_t>& cluster_set, size_t from_sweep_cluster,
-            size_t to_sweep_cluster) const;
-
-  // E2: Two vertices are connected between two "combination sets" c, c' if
-  // - the covering node c is different from c' AND
-  // - they represent the same sweep plan graph vertex (u=v) AND
-  // - the two covering sets are connected in the original covering graph
-  // ((c,c') \in E(B_k)) AND
-  // - the "to"-vertex v polygon_id is NOT in the covered polygons of c AND
-  // - the "to"-vertex v polygon_id is in the covered polygons of c'
-  bool isE2(const EdgeId& edge_id) const;
-  bool isE2(size_t from_sweep_plan_graph_id, size_t to_sweep_plan_graph_id,
-            size_t from_boolean_lattice_id, size_t to_boolean_lattice_id,
-            const std::set<size_t>& from_cluster_set,
-            const std::set<size_t>& to_cluster_set, size_t sweep_cluster) const;
-
-  const boolean_lattice::NodeProperty* getBooleanLatticeNodeProperty(
-      size_t node_id) const;
-  const sweep_plan_graph::NodeProperty* getSweepPlanGraphNodeProperty(
-      size_t node_id) const;
-  bool getSweepPlanGraphEdgeCost(const EdgeId& edge_id, double* cost) const;
-  bool getBooleanLatticeEdgeCost(const EdgeId& edge_id, double* cost) const;
-
-  // Create the graph while solving Dijkstra.
-  bool createDijkstra(Solution* solution);
+  // The cheapest sweep plan graph edge entering each cluster from another
+  // cluster. Zero if a cluster cannot be entered.
+  static bool computeMinEntryCosts(
+      const sweep_plan_graph::Overlay& sweep_plan_graph,
+      std::vector<double>* min_entry_costs);
+
+  // A* search on the implicit product of sweep plan graph and bitmask
+  // lattice. E1 successors are the sweep plan graph out-edges at the same
+  // lattice id. The E2 successor flips the lattice bit of the current sweep
+  // cluster. Returns the solution in sweep plan graph indices.
+  static bool solveImplicit(
+      const sweep_plan_graph::Overlay& sweep_plan_graph,
+      const boolean_lattice::BitmaskLattice& boolean_lattice,
+      double upper_bound, const Deadline& deadline,
+      Solution* sweep_plan_solution);
 
   // Corresponding sweep plan graph.
   const sweep_plan_graph::SweepPlanGraph* sweep_plan_graph_;
-  // Corresponding boolean lattice.
-  const boolean_lattice::BooleanLattice* boolean_lattice_;
+  bool is_created_;
+
+  // Precomputed product graph edges. The successors of node i are stored in
+  // [offsets_[i], offsets_[i + 1]). E1 edges connect sweeps in the same
+  // lattice node, i.e., from a visited into an unvisited cluster. The E2 edge
+  // marks the cluster of the sweep visited.
+  std::vector<size_t> offsets_;
+  std::vector<uint32_t> neighbors_;
+  std::vector<double> costs_;
 };
 }  // namespace gtspp_product_graph
 }  // namespace polygon_coverage_planning
@@ -20,10 +20,20 @@
 #ifndef POLYGON_COVERAGE_PLANNING_GRAPHS_SWEEP_PLAN_GRAPH_H_
 #define POLYGON_COVERAGE_PLANNING_GRAPHS_SWEEP_PLAN_GRAPH_H_
 
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+
 #include <polygon_coverage_geometry/cgal_definitions.h>
 #include <polygon_coverage_geometry/decomposition.h>
 #include <polygon_coverage_geometry/visibility_graph.h>
+#include <polygon_coverage_solvers/deadline.h>
 #include <polygon_coverage_solvers/graph_base.h>
+#include <polygon_coverage_solvers/graph_overlay.h>
+#include <polygon_coverage_solvers/gtsp_solver.h>
 
 #include "polygon_coverage_planners/cost_functions/path_cost_functions.h"
 #include "polygon_coverage_planners/sensor_models/sensor_model_base.h"
@@ -33,13 +43,15 @@ namespace sweep_plan_graph {
 // Internal node property. Stores the sweep plan / waypoint information.
 struct NodeProperty {
   NodeProperty() : cost(-1.0), cluster(0) {}
-  NodeProperty(const std::vector<Point_2>& waypoints,
+  NodeProperty(std::vector<Point_2> waypoints,
                const PathCostFunction& cost_function, size_t cluster,
-               const std::vector<Polygon_2>& visibility_polygons)
-      : waypoints(waypoints),
-        cost(cost_function(waypoints)),
+               std::vector<Polygon_2> visibility_polygons)
+      : waypoints(std::move(waypoints)),
+        cost(cost_function(this->waypoints)),
         cluster(cluster),
-        visibility_polygons(visibility_polygons) {}
+        visibility_polygons(std::move(visibility_polygons)) {
+    cacheEndpoints();
+  }
   NodeProperty(const Point_2& waypoint, const PathCostFunction& cost_function,
                size_t cluster, const Polygon_2& visibility_polygon)
       : NodeProperty(std::vector<Point_2>({waypoint}), cost_function, cluster,
@@ -49,26 +61,66 @@ struct NodeProperty {
   size_t cluster;                  // The cluster these waypoints are covering.
   std::vector<Polygon_2> visibility_polygons;  // The visibility polygons at
                                                // start and goal of sweep.
+                                               // Empty if not stored.
+  double front_x = 0.0;  // Double approximations of the first and last
+  double front_y = 0.0;  // waypoint. Every pruning comparison bounds its
+  double back_x = 0.0;   // cost with them instead of converting the exact
+  double back_y = 0.0;   // coordinates again.
+
+  // Update the double approximations of the endpoints. Call after assigning
+  // waypoints directly.
+  void cacheEndpoints();
+
+  // The stored visibility polygon at the start or goal of the sweep. Returns
+  // nullptr if the visibility polygons are not stored.
+  inline const Polygon_2* getFrontVisibilityPolygon() const {
+    return visibility_polygons.empty() ? nullptr
+                                       : &visibility_polygons.front();
+  }
+  inline const Polygon_2* getBackVisibilityPolygon() const {
+    return visibility_polygons.empty() ? nullptr : &visibility_polygons.back();
+  }
 
   // Checks whether this node property is non-optimal compared to any node
   // in node_properties.
   bool isNonOptimal(const visibility_graph::VisibilityGraph& visibility_graph,
                     const std::vector<NodeProperty>& node_properties,
                     const PathCostFunction& cost_function) const;
+  // Checks whether going to the start of other, sweeping other and returning
+  // from its goal is cheaper than this sweep. Only cheaper sweeps are
+  // candidates. The straight segment cost between the endpoints bounds the
+  // shortest paths from below, such that most candidates are rejected
+  // without a visibility graph query. A cost function violating the bound
+  // only prunes less.
+  bool isDominatedBy(const visibility_graph::VisibilityGraph& visibility_graph,
+                     const NodeProperty& other,
+                     const PathCostFunction& cost_function) const;
 };
 
 // Internal edge property storage, i.e., shortest path.
 struct EdgeProperty {
   EdgeProperty() : cost(-1.0) {}
-  EdgeProperty(const std::vector<Point_2>& waypoints,
+  EdgeProperty(std::vector<Point_2> waypoints,
                const PathCostFunction& cost_function)
-      : waypoints(waypoints), cost(cost_function(waypoints)) {}
+      : waypoints(std::move(waypoints)), cost(cost_function(this->waypoints)) {}
   std::vector<Point_2> waypoints;  // The waypoints defining the edge.
   double cost;                     // The shortest path length.
 };
 
+// Start and goal of a query on top of a shared sweep plan graph.
+typedef GraphOverlay<NodeProperty, EdgeProperty> Overlay;
+
+// Visits a contiguous segment [begin, end) of a plan's waypoints. Returns
+// false to stop the traversal.
+typedef std::function<bool(std::vector<Point_2>::const_iterator begin,
+                           std::vector<Point_2>::const_iterator end)>
+    WaypointSegmentVisitor;
+
 // The adjacency graph contains all sweep plans (and waypoints) and its
 // interconnections (edges). It is a dense, asymmetric, bidirectional graph.
+// Thread safety: solve, solveHeldKarp and the other const queries may run
+// concurrently on one created instance. Start and goal are added to a
+// per-query overlay and the visibility graph queries are thread-safe.
 class SweepPlanGraph : public GraphBase<NodeProperty, EdgeProperty> {
  public:
   struct Settings {
@@ -78,13 +130,63 @@ class SweepPlanGraph : public GraphBase<NodeProperty, EdgeProperty> {
     DecompositionType decomposition_type =
         DecompositionType::kBCD;  // The decomposition type.
     FT wall_distance = 0.0;       // The minimum distance to the polygon walls.
+    double simplification_tolerance =
+        0.0;  // Maximum deviation of the simplified input polygon boundary
+              // relative to the sweep distance. 0: no simplification.
+    double grid_resolution =
+        0.0;  // [m] Snap the preprocessed polygon to this grid, rounded down
+              // to a power of two. Enables integer predicates. 0: no snapping.
     bool offset_polygons = true;  // Flag to offset neighboring cells.
     bool sweep_single_direction =
         false;  // Flag to sweep only in best direction.
+    gtsp::SolverType gtsp_solver_type =
+        gtsp::SolverType::kGkMa;  // The GTSP solver.
+    gtsp::SolverSettings
+        gtsp_solver_settings;  // Multi-start and time budget of the solver.
+    size_t num_threads = 1;  // Threads to search the decomposition
+                             // direction, to compute the visibility graph
+                             // and to create the cluster sweeps and edges.
+                             // 0: hardware concurrency. Requires
+                             // thread-safe CGAL.
+    bool store_edge_waypoints =
+        true;  // Flag to store the shortest path of every edge. Otherwise
+               // only the edge cost is stored and the paths of a solution
+               // are recomputed.
+    bool store_visibility_polygons =
+        true;  // Flag to store the start and goal visibility polygons of
+               // every sweep. Otherwise they are recomputed in the bounded
+               // visibility polygon cache when needed.
+    bool precompute_shortest_paths =
+        false;  // Flag to precompute the shortest paths between all
+                // visibility graph vertices before creating the edges.
+    bool bitangent_visibility_graph =
+        false;  // Flag to only keep the visibility graph edges that are
+                // tangent to the boundary at both ends. Same shortest
+                // paths, fewer edges.
+    size_t max_group_size =
+        8;  // Maximum number of adjacent cells per super-cluster of the
+            // hierarchical solver.
+    size_t max_region_size =
+        16;  // Maximum number of adjacent cells per region of the region
+             // planner.
+    size_t product_graph_memory_budget =
+        0;  // Maximum memory [bytes] of the exact product graph and one
+            // search. 0: unlimited.
+    bool product_graph_fallback =
+        true;  // Flag to solve with the heuristic GTSP solver if the exact
+               // product graph exceeds its memory budget. Otherwise the
+               // exact planner setup fails.
+    bool reverse_search =
+        false;  // Flag for the exact planners to search backwards from the
+                // goal once and reuse the cost-to-go for every start with the
+                // same goal.
   };
 
   SweepPlanGraph(const Settings& settings)
-      : GraphBase(), settings_(settings), visibility_graph_(settings_.polygon) {
+      : GraphBase(),
+        settings_(settings),
+        visibility_graph_(settings_.polygon, settings_.num_threads,
+                          settings_.bitangent_visibility_graph) {
     is_created_ = create();  // Auto-create.
   }
   SweepPlanGraph() : GraphBase() {}
@@ -93,15 +195,87 @@ class SweepPlanGraph : public GraphBase<NodeProperty, EdgeProperty> {
   // graph out of these.
   virtual bool create() override;
 
-  // Solve the GTSP using GK MA.
+  // Replace the input polygon after a local edit, e.g., an added hole or a
+  // moved vertex. Decomposition cells that are identical to a previous cell
+  // keep their sweeps. Previous shortest paths are kept if they stay clear of
+  // the bounding box of the edited region and every path through this box is
+  // longer. The result equals create() on the new polygon.
+  bool update(const PolygonWithHoles& polygon);
+
+  // Save the created graph to a versioned binary snapshot file.
+  bool save(const std::string& file) const;
+  // Load a snapshot that was saved from a graph with the same settings key.
+  // Returns false and leaves the graph uncreated if the file is missing,
+  // corrupt, of another version or created from different settings.
+  bool load(const Settings& settings, const std::string& file);
+  // Hash of the input polygon and all settings that change the graph. The
+  // cost function is identified by the cost of the polygon boundary.
+  static uint64_t computeSnapshotKey(const Settings& settings);
+  // The snapshot key of the current input.
+  inline uint64_t getSnapshotKey() const { return snapshot_key_; }
+
+  // Solve the GTSP using the selected GTSP solver. The remaining time of the
+  // deadline caps the GTSP solver time budget. The native solver returns its
+  // best tour when it runs out. GK MA always finishes its first run, see
+  // gtsp::checkSolverStopsOnBudget().
   bool solve(const Point_2& start, const Point_2& goal,
-             std::vector<Point_2>* waypoints) const;
+             std::vector<Point_2>* waypoints,
+             const Deadline& deadline = Deadline()) const;
+  // Solve the GTSPP exactly using Held-Karp dynamic programming. Fails if the
+  // deadline expires.
+  bool solveHeldKarp(const Point_2& start, const Point_2& goal,
+                     std::vector<Point_2>* waypoints,
+                     const Deadline& deadline = Deadline()) const;
+
+  // Solve the GTSPP hierarchically for large decompositions. Adjacent cells
+  // are grouped into super-clusters of at most max_group_size cells. The order
+  // of the groups is solved exactly over the cheapest transitions between
+  // groups. The cells of each group are then solved exactly in this order,
+  // entering from the previous group and leaving towards the next one. Exact
+  // if all cells fit into one group. Fails if the deadline expires.
+  bool solveHierarchical(const Point_2& start, const Point_2& goal,
+                         std::vector<Point_2>* waypoints,
+                         const Deadline& deadline = Deadline()) const;
+  // Group adjacent decomposition cells into connected groups of at most
+  // max_group_size cells.
+  bool computeCellGroups(size_t max_group_size,
+                         std::vector<std::vector<size_t>>* groups) const;
+
+  // Add start and goal and their edges to an overlay on top of this graph.
+  // Only the start and goal edges are computed; the graph is not copied. The
+  // overlay references this graph and is invalid once the graph changes.
+  bool createOverlay(const Point_2& start, const Point_2& goal,
+                     Overlay* overlay) const;
+  // Add only the goal and the edges of all sweeps to it, e.g., to share the
+  // goal edges between queries with the same goal.
+  bool createGoalOverlay(const Point_2& goal, Overlay* overlay) const;
+  // Add the start and its edges to all sweeps to a goal overlay.
+  bool addOverlayStart(const Point_2& start, Overlay* overlay) const;
 
   // Given a solution, get the concatenated 2D waypoints.
   bool getWaypoints(const Solution& solution,
                     std::vector<Point_2>* waypoints) const;
+  // Given a solution in overlay indices, get the concatenated 2D waypoints.
+  bool getWaypoints(const Overlay& overlay, const Solution& solution,
+                    std::vector<Point_2>* waypoints) const;
+  // Given a solution, visit the waypoints segment by segment, i.e., every
+  // sweep and every transition in order, without concatenating them. The
+  // concatenated segments equal getWaypoints. The visited range is only valid
+  // during the call. Aborts and returns false if the visitor returns false.
+  bool forEachWaypointSegment(const Solution& solution,
+                              const WaypointSegmentVisitor& visit) const;
+  bool forEachWaypointSegment(const Overlay& overlay, const Solution& solution,
+                              const WaypointSegmentVisitor& visit) const;
+  // Get the shortest path of an edge. Recomputes the path if only the edge
+  // cost is stored.
+  bool getEdgeWaypoints(const NodeProperty& from_node_property,
+                        const NodeProperty& to_node_property,
+                        const EdgeProperty& edge_property,
+                        std::vector<Point_2>* waypoints) const;
 
   bool getClusters(std::vector<std::vector<int>>* clusters) const;
+  static bool getClusters(const Overlay& overlay,
+                          std::vector<std::vector<int>>* clusters);
 
   inline std::vector<Polygon_2> getDecomposition() const {
     return polygon_clusters_;
@@ -110,8 +284,11 @@ class SweepPlanGraph : public GraphBase<NodeProperty, EdgeProperty> {
   inline size_t getDecompositionSize() const {
     return polygon_clusters_.size();
   }
+  // The sweeps pruned as non-optimal during the last creation or update.
+  inline size_t getNumberOfPrunedNodes() const { return num_pruned_nodes_; }
 
-  // Note: projects the start and goal inside the polygon.
+  // Note: projects the start and goal inside the polygon. The waypoints are
+  // moved into the node.
   bool createNodeProperty(size_t cluster, std::vector<Point_2>* waypoints,
                           NodeProperty* node) const;
   inline bool createNodeProperty(size_t cluster, const Point_2& waypoint,
@@ -121,8 +298,48 @@ class SweepPlanGraph : public GraphBase<NodeProperty, EdgeProperty> {
   }
 
  private:
+  // Returns an edge property computed by a previous graph. Returns false if
+  // the edge needs to be recomputed.
+  typedef std::function<bool(const EdgeId& edge_id,
+                             EdgeProperty* edge_property)>
+      EdgeReuseFunction;
+
+  // Compute the sweeps of a single cluster. Does not modify the graph.
+  bool computeClusterSweeps(size_t cluster,
+                            std::vector<std::vector<Point_2>>* sweeps) const;
+  // Create the node properties of the cluster sweeps and prune the
+  // non-optimal ones. Does not modify the graph.
+  bool createClusterNodes(size_t cluster,
+                          const std::vector<std::vector<Point_2>>& sweeps,
+                          std::vector<NodeProperty>* node_properties) const;
+  // Create nodes and edges from the cluster sweeps and freeze the graph.
+  bool createGraph(const EdgeReuseFunction& reuse_edge);
+
   virtual bool addEdges() override;
-  bool computeEdge(const EdgeId& edge_id, EdgeProperty* edge_property) const;
+  // Create the edges between all nodes at once. The shortest paths are
+  // computed concurrently unless reuse_edge provides them.
+  bool addAllEdges(const EdgeReuseFunction& reuse_edge = nullptr);
+  // Compute the edges that are not computed yet from a dense matrix of the
+  // shortest paths between the distinct sweep ends and sweep starts. The edge
+  // cost only depends on this endpoint pair. Edges without a path remain not
+  // computed.
+  void computeEndpointEdges(const std::vector<EdgeId>& edge_ids,
+                            std::vector<EdgeProperty>* edge_properties,
+                            std::vector<char>* is_computed) const;
+  bool computeEdge(const NodeProperty& from_node_property,
+                   const NodeProperty& to_node_property,
+                   EdgeProperty* edge_property, bool store_waypoints) const;
+  // Compute the given edges from or to the overlay nodes concurrently and add
+  // them to the overlay. Edges without a path are skipped.
+  bool addOverlayEdges(const std::vector<EdgeId>& edge_ids,
+                       Overlay* overlay) const;
+  // Compute the edges from a node to the adjacent nodes (forwards) or from the
+  // adjacent nodes to the node with one one-to-many shortest path query.
+  // Edges without a path are marked as not computed.
+  void computeEdges(const NodeProperty& node_property,
+                    const std::vector<size_t>& adj_ids, bool forwards,
+                    std::vector<EdgeProperty>* edge_properties,
+                    std::vector<char>* is_computed) const;
   // Calculate cost to go to node.
   // cost = from_sweep_cost + cost(from_end, to_start)
   bool computeCost(const EdgeId& edge_id, const EdgeProperty& edge_property,
@@ -138,15 +355,14 @@ class SweepPlanGraph : public GraphBase<NodeProperty, EdgeProperty> {
   // Compute the start and goal visibility polygon of a sweep. Also resets the
   // start and goal vertex in case they are not inside the polygon.
   bool computeStartAndGoalVisibility(
-      const PolygonWithHoles& polygon, std::vector<Point_2>* sweep,
+      std::vector<Point_2>* sweep,
       std::vector<Polygon_2>* visibility_polygons) const;
 
   // Projects vertex into polygon and computes its visibility polygon.
-  bool computeVisibility(const PolygonWithHoles& polygon, Point_2* vertex,
-                         Polygon_2* visibility_polygon) const;
+  bool computeVisibility(Point_2* vertex, Polygon_2* visibility_polygon) const;
 
-  // Offset the polygon from wall.
-  void offsetPolygonFromWalls();
+  // Simplify the polygon and offset it from wall.
+  void preprocessPolygon();
 
   // Compute the desired decomposition.
   bool computeDecomposition();
@@ -161,10 +377,34 @@ class SweepPlanGraph : public GraphBase<NodeProperty, EdgeProperty> {
 
   bool offsetAdjacentCells(const std::map<size_t, std::set<size_t>>& adj);
 
+  // Cache the GTSP distance matrix and the clusters of the created graph.
+  // Queries only add the start and goal rows and columns. Leaves the cache
+  // empty on failure, such that queries compute everything.
+  void createQueryCache();
+  // The distance matrix and clusters of an overlay on top of this graph. Use
+  // the query cache if it matches the graph.
+  bool getOverlayDistanceMatrix(const Overlay& overlay,
+                                DistanceMatrix<int>* m) const;
+  bool getOverlayClusters(const Overlay& overlay,
+                          std::vector<std::vector<int>>* clusters) const;
+  // Report the estimated memory of the nodes, edges, visibility graph and
+  // query cache to memory::Memory.
+  void reportMemory() const;
+
   Settings settings_;  // User input settings.
   visibility_graph::VisibilityGraph
       visibility_graph_;                     // The visibility to compute edges.
   std::vector<Polygon_2> polygon_clusters_;  // The polygon clusters.
+  std::map<size_t, std::set<size_t>>
+      decomposition_adjacency_;  // The adjacent cells before offsetting.
+  std::vector<std::vector<std::vector<Point_2>>>
+      cluster_sweeps_;          // The unpruned sweeps of each cluster.
+  bool defer_edges_ = false;     // Skip edge creation in addNode.
+  size_t num_pruned_nodes_ = 0;  // Not part of the snapshot.
+  uint64_t snapshot_key_ = 0;    // The settings key of the input.
+  // The cached GTSP distance matrix and clusters of the created graph.
+  DistanceMatrix<int> base_distance_matrix_;
+  std::vector<std::vector<int>> base_clusters_;
 };
 
 }  // namespace sweep_plan_graph
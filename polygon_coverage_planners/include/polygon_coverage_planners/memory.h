@@ -0,0 +1,70 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POLYGON_COVERAGE_PLANNERS_MEMORY_H_
+#define POLYGON_COVERAGE_PLANNERS_MEMORY_H_
+
+#include <iosfwd>
+#include <map>
+#include <string>
+
+namespace polygon_coverage_planning {
+namespace memory {
+
+// The memory held by one stage of the pipeline.
+// bytes: estimated heap and object bytes.
+// count: number of elements, e.g., nodes or edges.
+struct Usage {
+  size_t bytes = 0;
+  size_t count = 0;
+};
+
+// Registry of per-stage memory usage with the same static interface as
+// timing::Timing. Stages report estimates of their data structures after
+// construction and the process peak resident set size (RSS) after each phase.
+// All functions are thread-safe.
+//
+// The estimates are shallow: they count container capacities and element
+// sizes, but neither allocator overhead nor memory shared through reference
+// counting, e.g., exact CGAL numbers.
+class Memory {
+ public:
+  typedef std::map<std::string, Usage> map_t;
+
+  // Set the usage of a stage. Reporting a tag again replaces its usage.
+  static void Report(const std::string& tag, size_t bytes, size_t count);
+  // Set the usage of tag to the current process peak RSS. The peak RSS never
+  // decreases, so reporting it after each phase shows which phase raised it.
+  static void ReportPeakRss(const std::string& tag);
+  static size_t GetBytes(const std::string& tag);
+  static size_t GetCount(const std::string& tag);
+  // The peak RSS of the process in bytes. 0 if unavailable.
+  static size_t GetPeakRssBytes();
+  static map_t GetUsage();
+  static void Print(std::ostream& out);
+  static std::string Print();
+  static std::string BytesToString(size_t bytes);
+
+  static void Reset();
+};
+
+}  // namespace memory
+}  // namespace polygon_coverage_planning
+
+#endif  // POLYGON_COVERAGE_PLANNERS_MEMORY_H_
@@ -0,0 +1,60 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POLYGON_COVERAGE_PLANNERS_PLANNERS_BATCH_PLANNER_H_
+#define POLYGON_COVERAGE_PLANNERS_PLANNERS_BATCH_PLANNER_H_
+
+#include <vector>
+
+#include <polygon_coverage_geometry/cgal_definitions.h>
+
+#include "polygon_coverage_planners/graphs/sweep_plan_graph.h"
+#include "polygon_coverage_planners/planners/polygon_stripmap_planner.h"
+
+namespace polygon_coverage_planning {
+
+// A single planning problem of a batch.
+struct BatchTask {
+  sweep_plan_graph::SweepPlanGraph::Settings settings;
+  Point_2 start;
+  Point_2 goal;
+};
+
+struct BatchResult {
+  bool success = false;
+  std::vector<Point_2> solution;
+};
+
+// Setup a planner and solve for every task on up to num_threads threads (0:
+// hardware concurrency). Idle threads pull the next task, such that large and
+// small polygons balance. The results are in task order. A failing task does
+// not stop the others. Returns whether all tasks succeeded.
+// With more than one thread every task creates its graph and solves single
+// threaded. GK MA solves are serialized in the process, because Mono hosts a
+// single solver instance. Use gtsp::SolverType::kNative to solve
+// concurrently.
+template <class Planner = PolygonStripmapPlanner>
+bool planBatch(const std::vector<BatchTask>& tasks, size_t num_threads,
+               std::vector<BatchResult>* results);
+
+}  // namespace polygon_coverage_planning
+
+#include "polygon_coverage_planners/planners/impl/batch_planner_impl.h"
+
+#endif  // POLYGON_COVERAGE_PLANNERS_PLANNERS_BATCH_PLANNER_H_
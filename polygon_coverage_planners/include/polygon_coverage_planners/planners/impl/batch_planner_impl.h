@@ -0,0 +1,63 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POLYGON_COVERAGE_PLANNERS_PLANNERS_BATCH_PLANNER_IMPL_H_
+#define POLYGON_COVERAGE_PLANNERS_PLANNERS_BATCH_PLANNER_IMPL_H_
+
+#include <algorithm>
+
+#include <polygon_coverage_solvers/parallel.h>
+#include <ros/assert.h>
+#include <ros/console.h>
+
+namespace polygon_coverage_planning {
+
+template <class Planner>
+bool planBatch(const std::vector<BatchTask>& tasks, size_t num_threads,
+               std::vector<BatchResult>* results) {
+  ROS_ASSERT(results);
+  results->assign(tasks.size(), BatchResult());
+
+  // Parallelize over tasks instead of inside every task.
+  const bool is_parallel =
+      std::min(getNumThreads(num_threads), tasks.size()) > 1;
+  parallelFor(tasks.size(), num_threads, [&](size_t i) {
+    sweep_plan_graph::SweepPlanGraph::Settings settings = tasks[i].settings;
+    if (is_parallel) {
+      settings.num_threads = 1;
+      settings.gtsp_solver_settings.num_threads = 1;
+    }
+    Planner planner(settings);
+    BatchResult& result = (*results)[i];
+    result.success = planner.setup() &&
+                     planner.solve(tasks[i].start, tasks[i].goal,
+                                   &result.solution);
+    if (!result.success) {
+      ROS_ERROR_STREAM("Failed planning batch task " << i);
+    }
+    return true;  // Continue with the remaining tasks.
+  });
+
+  return std::all_of(results->begin(), results->end(),
+                     [](const BatchResult& result) { return result.success; });
+}
+
+}  // namespace polygon_coverage_planning
+
+#endif  // POLYGON_COVERAGE_PLANNERS_PLANNERS_BATCH_PLANNER_IMPL_H_
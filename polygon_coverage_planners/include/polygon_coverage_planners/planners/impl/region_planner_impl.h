@@ -0,0 +1,66 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POLYGON_COVERAGE_PLANNERS_PLANNERS_REGION_PLANNER_IMPL_H_
+#define POLYGON_COVERAGE_PLANNERS_PLANNERS_REGION_PLANNER_IMPL_H_
+
+#include <utility>
+
+#include <ros/assert.h>
+#include <ros/console.h>
+
+#include "polygon_coverage_planners/planners/batch_planner.h"
+
+namespace polygon_coverage_planning {
+
+template <class Planner>
+bool RegionPlanner::solve(const Point_2& start, const Point_2& goal,
+                          std::vector<Point_2>* solution,
+                          const Deadline& deadline) const {
+  ROS_ASSERT(solution);
+  solution->clear();
+
+  std::vector<RegionTask> tasks;
+  if (!createTasks(start, goal, &tasks, deadline)) {
+    return false;
+  }
+  std::vector<BatchTask> batch(tasks.size());
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    batch[i].settings = getRegionSettings(tasks[i]);
+    batch[i].start = tasks[i].start;
+    batch[i].goal = tasks[i].goal;
+  }
+  std::vector<BatchResult> batch_results;
+  if (!planBatch<Planner>(batch, settings_.num_threads, &batch_results)) {
+    ROS_ERROR("Cannot plan all regions.");
+    return false;
+  }
+
+  std::vector<RegionResult> results(tasks.size());
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    results[i].region = tasks[i].region;
+    results[i].success = batch_results[i].success;
+    results[i].solution = std::move(batch_results[i].solution);
+  }
+  return stitch(start, goal, results, solution);
+}
+
+}  // namespace polygon_coverage_planning
+
+#endif  // POLYGON_COVERAGE_PLANNERS_PLANNERS_REGION_PLANNER_IMPL_H_
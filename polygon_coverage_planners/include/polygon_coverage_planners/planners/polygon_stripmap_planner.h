@@ -20,11 +20,15 @@
 #ifndef POLYGON_COVERAGE_PLANNERS_PLANNERS_POLYGON_STRIPMAP_PLANNER_H_
 #define POLYGON_COVERAGE_PLANNERS_PLANNERS_POLYGON_STRIPMAP_PLANNER_H_
 
+#include <functional>
 #include <memory>
+#include <string>
 
 #include <polygon_coverage_geometry/cgal_definitions.h>
+#include <polygon_coverage_solvers/deadline.h>
 #include "polygon_coverage_planners/cost_functions/path_cost_functions.h"
 #include "polygon_coverage_planners/graphs/sweep_plan_graph.h"
+#include "polygon_coverage_planners/result_cache.h"
 #include "polygon_coverage_planners/sensor_models/sensor_model_base.h"
 
 namespace polygon_coverage_planning {
@@ -37,34 +41,79 @@ class PolygonStripmapPlanner {
 
   // Precompute solver essentials. To be run before solving.
   bool setup();
+  // Same as setup(), but loads the sweep plan graph from a snapshot file if it
+  // was saved with the same settings. Otherwise the graph is created and
+  // saved to the file. Solvers with preprocessing cache their results next
+  // to it.
+  bool setup(const std::string& snapshot_file);
+
+  // Replace the polygon after a local edit and update the sweep plan graph
+  // incrementally. Requires a previous setup.
+  bool update(const PolygonWithHoles& polygon);
 
   // Solve the resulting generalized traveling salesman problem.
   // start: the start point.
   // goal: the goal point.
   // solution: the solution waypoints.
+  // deadline: the time budget and cancellation token of this call. The
+  // native heuristic solver returns its best solution on expiry, GK MA
+  // finishes its first run, the exact solvers fail. Solutions under a time
+  // limit are not stored in the result cache.
   bool solve(const Point_2& start, const Point_2& goal,
-             std::vector<Point_2>* solution) const;
+             std::vector<Point_2>* solution,
+             const Deadline& deadline = Deadline()) const;
+
+  // Return the stored solution of repeated queries with the same polygon,
+  // settings, planner, start and goal. If file is not empty, the cache is loaded from
+  // the file and every new solution is saved to it.
+  bool enableResultCache(const std::string& file = "");
 
   inline bool isInitialized() const { return is_initialized_; }
 
   inline std::vector<Polygon_2> getDecomposition() {
     return sweep_plan_graph_.getDecomposition();
   }
+  inline size_t getDecompositionSize() const {
+    return sweep_plan_graph_.getDecompositionSize();
+  }
+  inline size_t getNumberOfNodes() const { return sweep_plan_graph_.size(); }
+  inline size_t getNumberOfEdges() const {
+    return sweep_plan_graph_.getNumberOfEdges();
+  }
+  inline size_t getNumberOfPrunedNodes() const {
+    return sweep_plan_graph_.getNumberOfPrunedNodes();
+  }
 
  protected:
   virtual bool setupSolver() { return true; };
+  // Identifies the solutions of this planner in the result cache.
+  virtual std::string getResultCacheTag() const { return "heuristic"; }
   // Default: Heuristic GTSPP solver.
   virtual bool runSolver(const Point_2& start, const Point_2& goal,
-                         std::vector<Point_2>* solution) const;
+                         std::vector<Point_2>* solution,
+                         const Deadline& deadline) const;
+
+  typedef std::function<bool(const Point_2& start, const Point_2& goal,
+                             std::vector<Point_2>* solution)>
+      SolverFunction;
+  // Make sure start and goal are inside the polygon, run the solver and add
+  // the original start and goal to the solution.
+  bool solveWith(const SolverFunction& run_solver, const Point_2& start,
+                 const Point_2& goal, std::vector<Point_2>* solution) const;
 
   // The sweep plan graph with all possible waypoints its node connections.
   sweep_plan_graph::SweepPlanGraph sweep_plan_graph_;
+  // The sweep plan graph snapshot file of setup(). Empty if none.
+  std::string snapshot_file_;
 
  private:
   // Valid construction.
   bool is_initialized_;
   // The sweep plan settings.
   sweep_plan_graph::SweepPlanGraph::Settings settings_;
+  // The solutions of previous queries. Nullptr if disabled.
+  std::unique_ptr<ResultCache> result_cache_;
+  ResultCache::Key result_cache_key_;  // The cache key of the settings.
 };
 
 }  // namespace polygon_coverage_planning
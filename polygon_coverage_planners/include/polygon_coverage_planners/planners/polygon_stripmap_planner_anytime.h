@@ -0,0 +1,89 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POLYGON_COVERAGE_PLANNERS_PLANNERS_POLYGON_STRIPMAP_PLANNER_ANYTIME_H_
+#define POLYGON_COVERAGE_PLANNERS_PLANNERS_POLYGON_STRIPMAP_PLANNER_ANYTIME_H_
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "polygon_coverage_planners/planners/polygon_stripmap_planner_exact.h"
+
+namespace polygon_coverage_planning {
+
+// Anytime solver. Returns the heuristic GK MA solution immediately and refines
+// it with the exact product graph search in a background thread. The cost of
+// the heuristic solution prunes the exact search. Both share the sweep plan
+// graph. Cancel the refinement before calling setup() or update().
+class PolygonStripmapPlannerAnytime : public PolygonStripmapPlannerExact {
+ public:
+  // Called from the background thread with a solution that is cheaper than
+  // the heuristic solution.
+  typedef std::function<void(const std::vector<Point_2>& solution)>
+      SolutionCallback;
+
+  PolygonStripmapPlannerAnytime(
+      const sweep_plan_graph::SweepPlanGraph::Settings& settings,
+      const SolutionCallback& callback = nullptr)
+      : PolygonStripmapPlannerExact(settings),
+        cost_function_(settings.cost_function),
+        callback_(callback),
+        is_cancelled_(false),
+        is_refined_(false) {}
+  // Cancels a running refinement.
+  ~PolygonStripmapPlannerAnytime();
+
+  // Return the heuristic solution and start the exact refinement. Cancels a
+  // previous refinement. The deadline only limits the heuristic solution.
+  bool solve(const Point_2& start, const Point_2& goal,
+             std::vector<Point_2>* solution,
+             const Deadline& deadline = Deadline());
+
+  // Block until the refinement finished. Returns true and the refined
+  // solution if the exact search found a cheaper solution.
+  bool waitForRefinement(std::vector<Point_2>* solution);
+
+  // Abort the refinement and wait for the background thread.
+  void cancel();
+
+ private:
+  // Heuristic GK MA solver.
+  bool runSolver(const Point_2& start, const Point_2& goal,
+                 std::vector<Point_2>* solution,
+                 const Deadline& deadline) const override;
+  // Only the heuristic solution is stored.
+  std::string getResultCacheTag() const override {
+    return PolygonStripmapPlanner::getResultCacheTag();
+  }
+  // Exact product graph search pruned by the heuristic cost.
+  void refine(const Point_2& start, const Point_2& goal, double upper_bound);
+
+  PathCostFunction cost_function_;
+  SolutionCallback callback_;
+  std::atomic<bool> is_cancelled_;
+  std::thread refinement_;
+  std::mutex mutex_;  // Guards the refined solution.
+  std::vector<Point_2> refined_solution_;
+  bool is_refined_;
+};
+}  // namespace polygon_coverage_planning
+
+#endif  // POLYGON_COVERAGE_PLANNERS_PLANNERS_POLYGON_STRIPMAP_PLANNER_ANYTIME_H_
@@ -20,34 +20,62 @@
 #ifndef POLYGON_COVERAGE_PLANNERS_PLANNERS_POLYGON_STRIPMAP_PLANNER_EXACT_H_
 #define POLYGON_COVERAGE_PLANNERS_PLANNERS_POLYGON_STRIPMAP_PLANNER_EXACT_H_
 
+#include <memory>
+#include <mutex>
+
 #include "polygon_coverage_planners/graphs/gtspp_product_graph.h"
 #include "polygon_coverage_planners/graphs/sweep_plan_graph.h"
 #include "polygon_coverage_planners/planners/polygon_stripmap_planner.h"
 
-#include <polygon_coverage_solvers/boolean_lattice.h>
-
 namespace polygon_coverage_planning {
 
 class PolygonStripmapPlannerExact : public PolygonStripmapPlanner {
  public:
   PolygonStripmapPlannerExact(
       const sweep_plan_graph::SweepPlanGraph::Settings& settings)
-      : PolygonStripmapPlanner(settings) {}
+      : PolygonStripmapPlanner(settings),
+        memory_budget_(settings.product_graph_memory_budget),
+        use_fallback_(settings.product_graph_fallback),
+        is_fallback_(false),
+        reverse_search_(settings.reverse_search) {}
+
+  // The product graph exceeds the memory budget and the heuristic GTSP solver
+  // runs instead.
+  inline bool isFallback() const { return is_fallback_; }
 
  protected:
   virtual bool preprocess();
+  // The fallback stores heuristic solutions.
+  std::string getResultCacheTag() const override {
+    return is_fallback_ ? PolygonStripmapPlanner::getResultCacheTag()
+                        : "exact";
+  }
+  // Compare the memory estimate of the product graph with the budget before
+  // allocating it. Switches to the heuristic fallback if enabled. Returns
+  // false if the budget is exceeded without fallback.
+  bool checkMemoryBudget(bool precompute);
+  // Solve with the reverse search tree of the goal. The tree is created on
+  // the first query and whenever the goal changes.
+  bool solveReverse(const Point_2& start, const Point_2& goal,
+                    std::vector<Point_2>* solution,
+                    const Deadline& deadline) const;
 
   // The product of sweep plan graph and boolean lattice.
   gtspp_product_graph::GtsppProductGraph gtspp_product_graph_;
+  size_t memory_budget_;  // [bytes] 0: unlimited.
+  bool use_fallback_;
+  bool is_fallback_;
+  bool reverse_search_;
+  // Shared by concurrent queries. Replaced when the goal changes.
+  mutable std::mutex reverse_tree_mutex_;
+  mutable std::shared_ptr<const gtspp_product_graph::ReverseTree>
+      reverse_tree_;
 
  private:
   bool runSolver(const Point_2& start, const Point_2& goal,
-                 std::vector<Point_2>* solution) const override;
+                 std::vector<Point_2>* solution,
+                 const Deadline& deadline) const override;
   bool setupSolver() override;
-
-  // A boolean lattice to represent all possible convex polygon visiting
-  // combinations.
-  boolean_lattice::BooleanLattice boolean_lattice_;
 };
 }  // namespace polygon_coverage_planning
 
@@ -34,9 +34,15 @@ class PolygonStripmapPlannerExactPreprocessed
 
  private:
   bool runSolver(const Point_2& start, const Point_2& goal,
-                 std::vector<Point_2>* solution) const override;
-  // Precompute product graph. Allows multiple queries.
+                 std::vector<Point_2>* solution,
+                 const Deadline& deadline) const override;
+  // Precompute product graph. Allows multiple queries. With a snapshot file
+  // the product graph is loaded from and saved to "<snapshot_file>.product".
   bool preprocess() override;
+  std::string getResultCacheTag() const override {
+    return is_fallback_ ? PolygonStripmapPlanner::getResultCacheTag()
+                        : "exact_preprocessed";
+  }
 };
 
 }  // namespace polygon_coverage_planning
@@ -0,0 +1,126 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POLYGON_COVERAGE_PLANNERS_PLANNERS_REGION_PLANNER_H_
+#define POLYGON_COVERAGE_PLANNERS_PLANNERS_REGION_PLANNER_H_
+
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include <polygon_coverage_geometry/cgal_definitions.h>
+#include <polygon_coverage_geometry/visibility_graph.h>
+#include <polygon_coverage_solvers/deadline.h>
+
+#include "polygon_coverage_planners/graphs/sweep_plan_graph.h"
+#include "polygon_coverage_planners/planners/polygon_stripmap_planner.h"
+
+namespace polygon_coverage_planning {
+
+// A regional tour of a partitioned field. Tasks are independent and can be
+// planned in another process or on another host.
+struct RegionTask {
+  size_t region = 0;         // The index of the region in the partition.
+  PolygonWithHoles polygon;  // The region to cover.
+  Point_2 start;             // The entry of the regional tour.
+  Point_2 goal;              // The exit of the regional tour.
+};
+
+struct RegionResult {
+  size_t region = 0;
+  bool success = false;
+  std::vector<Point_2> solution;
+};
+
+// Write and read a task or result as text. Coordinates are exact rational
+// numbers, such that a task read on another host describes the same region.
+bool writeRegionTask(const RegionTask& task, std::ostream* os);
+bool readRegionTask(std::istream* is, RegionTask* task);
+bool writeRegionResult(const RegionResult& result, std::ostream* os);
+bool readRegionResult(std::istream* is, RegionResult* result);
+
+// Coverage planning for fields too large for a single sweep plan graph. The
+// preprocessed field is decomposed and adjacent cells are joined into regions
+// of at most max_region_size cells. Every pair of regions sharing a boundary
+// segment has a portal at its midpoint. A small GTSP over the entry and exit
+// portals of every region orders the regions. Transitions are estimated by
+// their straight segment cost; the regional tours are assumed to cost the
+// same for every entry and exit. Every region is then planned independently
+// with its own sweep plan graph and the regional tours are stitched with
+// shortest paths through the field.
+class RegionPlanner {
+ public:
+  // settings: the field and the settings of every regional planner.
+  RegionPlanner(const sweep_plan_graph::SweepPlanGraph::Settings& settings);
+
+  // Preprocess and partition the field. To be run before creating tasks.
+  bool setup();
+
+  // Order the regions from start to goal and create one task per region in
+  // tour order.
+  bool createTasks(const Point_2& start, const Point_2& goal,
+                   std::vector<RegionTask>* tasks,
+                   const Deadline& deadline = Deadline()) const;
+  // The settings to plan a task with, i.e., the preprocessed field settings
+  // with the region polygon.
+  sweep_plan_graph::SweepPlanGraph::Settings getRegionSettings(
+      const RegionTask& task) const;
+  // Concatenate the results of the tasks in tour order. start and goal are
+  // connected to the first and last regional tour.
+  bool stitch(const Point_2& start, const Point_2& goal,
+              const std::vector<RegionResult>& results,
+              std::vector<Point_2>* solution) const;
+
+  // Create the tasks, plan them on up to num_threads threads of this process
+  // and stitch the results.
+  template <class Planner = PolygonStripmapPlanner>
+  bool solve(const Point_2& start, const Point_2& goal,
+             std::vector<Point_2>* solution,
+             const Deadline& deadline = Deadline()) const;
+
+  inline bool isInitialized() const { return is_initialized_; }
+  inline const std::vector<PolygonWithHoles>& getRegions() const {
+    return regions_;
+  }
+
+ private:
+  // Simplify, offset and snap the field once, such that neighboring regions
+  // share their boundaries.
+  void preprocessField();
+  // Join connected groups of adjacent cells into regions and place the
+  // portals on the shared region boundaries.
+  bool partition(const std::vector<Polygon_2>& cells);
+  // Append the shortest path from the last waypoint to goal.
+  bool appendShortestPath(const Point_2& goal,
+                          std::vector<Point_2>* waypoints) const;
+
+  sweep_plan_graph::SweepPlanGraph::Settings settings_;
+  // The preprocessed field and the settings shared by all regions.
+  sweep_plan_graph::SweepPlanGraph::Settings region_settings_;
+  visibility_graph::VisibilityGraph visibility_graph_;
+  std::vector<PolygonWithHoles> regions_;
+  std::vector<std::vector<Point_2>> portals_;  // The portals of every region.
+  bool is_initialized_;
+};
+
+}  // namespace polygon_coverage_planning
+
+#include "polygon_coverage_planners/planners/impl/region_planner_impl.h"
+
+#endif  // POLYGON_COVERAGE_PLANNERS_PLANNERS_REGION_PLANNER_H_
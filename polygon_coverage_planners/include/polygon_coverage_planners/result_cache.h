@@ -0,0 +1,103 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POLYGON_COVERAGE_PLANNERS_RESULT_CACHE_H_
+#define POLYGON_COVERAGE_PLANNERS_RESULT_CACHE_H_
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <polygon_coverage_geometry/cgal_definitions.h>
+
+#include "polygon_coverage_planners/graphs/sweep_plan_graph.h"
+
+namespace polygon_coverage_planning {
+
+// Stores planner solutions by polygon, settings, planner, start and goal.
+// Queries and insertions are thread-safe.
+class ResultCache {
+ public:
+  // Identifies a polygon with settings.
+  struct Key {
+    uint64_t hash = 0;  // computeKey() of the settings.
+    // The canonical polygon. Compared exactly, such that a hash collision
+    // cannot return the solution of another polygon.
+    PolygonWithHoles polygon;
+  };
+
+  // Hash of the polygon, the settings that change the graph and the GTSP
+  // solver. The polygon is canonical, i.e., the hash does not depend on the
+  // first vertex of its boundaries or on the order of its holes.
+  static uint64_t computeKey(
+      const sweep_plan_graph::SweepPlanGraph::Settings& settings);
+  static Key createKey(
+      const sweep_plan_graph::SweepPlanGraph::Settings& settings);
+
+  // Get a stored solution.
+  // tag: The planner that computed the solution, e.g., to not return
+  // heuristic solutions to an exact planner. No whitespace.
+  bool find(const Key& key, const std::string& tag, const Point_2& start,
+            const Point_2& goal, std::vector<Point_2>* solution) const;
+  // Store a solution. Saves the cache if a file is set.
+  void insert(const Key& key, const std::string& tag, const Point_2& start,
+              const Point_2& goal, const std::vector<Point_2>& solution);
+
+  // Persist the cache in a text file. Coordinates are stored exactly.
+  // Loading a missing file leaves the cache empty and succeeds.
+  bool load(const std::string& file);
+  bool save(const std::string& file) const;
+  // Save after every insertion. Empty: in memory only.
+  inline void setFile(const std::string& file) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    file_ = file;
+  }
+
+  // The number of stored solutions.
+  size_t size() const;
+  void clear();
+
+ private:
+  struct Entry {
+    Point_2 start;
+    Point_2 goal;
+    std::vector<Point_2> solution;
+  };
+  // The solutions of one planner on one polygon with settings.
+  struct Field {
+    std::string tag;
+    PolygonWithHoles polygon;
+    std::vector<Entry> entries;
+  };
+  // Nullptr if none.
+  const Field* findField(const Key& key, const std::string& tag) const;
+  Field* findField(const Key& key, const std::string& tag);
+  bool saveLocked(const std::string& file) const;
+
+  mutable std::mutex mutex_;
+  // By key hash.
+  std::multimap<uint64_t, Field> fields_;
+  std::string file_;
+};
+
+}  // namespace polygon_coverage_planning
+
+#endif  // POLYGON_COVERAGE_PLANNERS_RESULT_CACHE_H_
@@ -18,88 +18,73 @@
 #ifndef POLYGON_COVERAGE_PLANNERS_TIMING_H_
 #define POLYGON_COVERAGE_PLANNERS_TIMING_H_
 
-#include <algorithm>
 #include <chrono>
+#include <cstdint>
+#include <iosfwd>
 #include <limits>
 #include <map>
+#include <mutex>
 #include <string>
 #include <vector>
 
 namespace polygon_coverage_planning {
 namespace timing {
 
-template <typename T, typename Total, int N>
-class Accumulator {
+// A log-linear histogram of durations in the style of HDR histograms. Every
+// octave [2^e, 2^(e+1)) s between kMinExponent and kMaxExponent is split into
+// kNumSubBuckets linear buckets, i.e., a relative error of at most 1/32 for
+// durations from 1 us to 9 h. Shorter durations share the linear buckets
+// of the first octave, longer ones the last bucket. The buckets are allocated
+// with the first sample and histograms merge exactly.
+class Histogram {
  public:
-  Accumulator()
-      : window_samples_(0),
-        total_samples_(0),
-        window_sum_(0),
-        sum_(0),
-        min_(std::numeric_limits<T>::max()),
-        max_(std::numeric_limits<T>::min()) {}
-
-  void Add(T sample) {
-    if (window_samples_ < N) {
-      samples_[window_samples_++] = sample;
-      window_sum_ += sample;
-    } else {
-      T& oldest = samples_[window_samples_++ % N];
-      window_sum_ += sample - oldest;
-      oldest = sample;
-    }
-    sum_ += sample;
-    ++total_samples_;
-    if (sample > max_) {
-      max_ = sample;
-    }
-    if (sample < min_) {
-      min_ = sample;
-    }
-  }
+  static constexpr int kMinExponent = -20;
+  static constexpr int kMaxExponent = 14;
+  static constexpr size_t kNumSubBuckets = 32;
+  static constexpr size_t kNumBuckets =
+      (kMaxExponent - kMinExponent + 2) * kNumSubBuckets;
 
-  int TotalSamples() const { return total_samples_; }
+  void Add(double seconds);
+  void Merge(const Histogram& other);
 
-  double Sum() const { return sum_; }
+  uint64_t TotalCount() const { return total_count_; }
+  // The smallest bucket value that is at least percentile [0, 100] % of the
+  // samples. 0 without samples.
+  double Percentile(double percentile) const;
+  // The upper bound and count of the non-empty buckets in increasing order.
+  std::vector<std::pair<double, uint64_t>> GetBuckets() const;
 
-  double Mean() const { return sum_ / total_samples_; }
+  static size_t GetBucketIndex(double seconds);
+  static double GetBucketUpperBound(size_t index);
 
-  double RollingMean() const {
-    return window_sum_ / std::min(window_samples_, N);
-  }
+ private:
+  uint64_t total_count_ = 0;
+  std::vector<uint64_t> counts_;
+};
 
-  double Max() const { return max_; }
+// The samples of a timer. Accumulators of different threads merge exactly.
+class Accumulator {
+ public:
+  void Add(double sample);
+  void Merge(const Accumulator& other);
 
+  size_t TotalSamples() const { return num_samples_; }
+  double Sum() const { return sum_; }
+  double Mean() const;
+  double Variance() const;
+  double Max() const { return max_; }
   double Min() const { return min_; }
-
-  double LazyVariance() const {
-    if (window_samples_ == 0) {
-      return 0.0;
-    }
-    double var = 0;
-    double mean = RollingMean();
-    for (int i = 0; i < std::min(window_samples_, N); ++i) {
-      var += (samples_[i] - mean) * (samples_[i] - mean);
-    }
-    var /= std::min(window_samples_, N);
-    return var;
-  }
+  // The percentile [0, 100] bounded by the minimum and maximum sample.
+  double Percentile(double percentile) const;
+  const Histogram& GetHistogram() const { return histogram_; }
 
  private:
-  int window_samples_;
-  int total_samples_;
-  Total window_sum_;
-  Total sum_;
-  T min_;
-  T max_;
-  T samples_[N];
-};
-
-struct TimerMapValue {
-  TimerMapValue() {}
-
-  // Create an accumulator with specified window size.
-  Accumulator<double, double, 50> acc_;
+  size_t num_samples_ = 0;
+  double sum_ = 0.0;
+  double sum_squared_ = 0.0;
+  double min_ = std::numeric_limits<double>::infinity();
+  double max_ = -std::numeric_limits<double>::infinity();
+  Histogram histogram_;
 };
 
 // A class that has the timer interface but does nothing. Swapping this in in
@@ -116,6 +101,11 @@ class DummyTimer {
   bool IsTiming() { return false; }
 };
 
+// Measures the steady time between Start and Stop and adds it to the timer
+// handle. Timers may run on any thread. Constructing from a tag looks up the
+// handle in the registry. In hot code register the handle once, e.g.,
+//   static const size_t kHandle = Timing::GetHandle("tag");
+//   Timer timer(kHandle);
 class Timer {
  public:
   Timer(size_t handle, bool constructStopped = false);
@@ -127,17 +117,21 @@ class Timer {
   bool IsTiming() const;
 
  private:
-  std::chrono::time_point<std::chrono::system_clock> time_;
+  std::chrono::steady_clock::time_point time_;
 
   bool timing_;
   size_t handle_;
 };
 
+// The timer registry. Every thread adds its samples to its own accumulators
+// without contention. The queries merge the accumulators of all threads,
+// including the ones that already exited.
 class Timing {
  public:
   typedef std::map<std::string, size_t> map_t;
   friend class Timer;
-  // Definition of static functions to query the timers.
+  // Definition of static functions to query the timers. Handles stay valid
+  // for the lifetime of the process, also across Reset.
   static size_t GetHandle(std::string const& tag);
   static std::string GetTag(size_t handle);
   static double GetTotalSeconds(size_t handle);
@@ -154,25 +148,45 @@ class Timing {
   static double GetMaxSeconds(std::string const& tag);
   static double GetHz(size_t handle);
   static double GetHz(std::string const& tag);
+  // Tail latency, e.g., GetPercentileSeconds(handle, 99.0).
+  static double GetPercentileSeconds(size_t handle, double percentile);
+  static double GetPercentileSeconds(std::string const& tag,
+                                     double percentile);
+  static Histogram GetHistogram(size_t handle);
+  static Histogram GetHistogram(std::string const& tag);
   static void Print(std::ostream& out);
   static std::string Print();
   static std::string SecondsToTimeString(double seconds);
+  // Remove the samples of all timers.
   static void Reset();
-  static const map_t& GetTimers() { return Instance().tag_map_; }
+  static map_t GetTimers();
 
  private:
+  // The accumulators of one thread indexed by handle.
+  struct ThreadAccumulators {
+    std::mutex mutex;  // Only contended while reading.
+    std::vector<Accumulator> accumulators;
+  };
+  // Registers the accumulators of a thread for its lifetime.
+  class ThreadRegistration;
+
   void AddTime(size_t handle, double seconds);
+  // The merged accumulator of all threads.
+  Accumulator GetAccumulator(size_t handle);
 
   static Timing& Instance();
+  static ThreadAccumulators& GetThreadAccumulators();
 
   Timing();
   ~Timing();
 
-  typedef std::vector<TimerMapValue> list_t;
-
-  list_t timers_;
+  // Guards the tags and the thread registry.
+  std::mutex mutex_;
   map_t tag_map_;
   size_t max_tag_length_;
+  std::vector<ThreadAccumulators*> threads_;
+  // The samples of exited threads.
+  std::vector<Accumulator> retired_;
 };
 
 #if DISABLE_TIMING
@@ -184,14 +198,12 @@ typedef Timer DebugTimer;
 // Small timer for benchmarking.
 class MiniTimer {
  public:
-  MiniTimer() : start_(std::chrono::system_clock::now()) {}
+  MiniTimer() : start_(std::chrono::steady_clock::now()) {}
 
-  void start() {
-    start_ = std::chrono::system_clock::now();
-  }
+  void start() { start_ = std::chrono::steady_clock::now(); }
 
   double stop() {
-    end_ = std::chrono::system_clock::now();
+    end_ = std::chrono::steady_clock::now();
     return getTime();
   }
 
@@ -204,8 +216,8 @@ class MiniTimer {
   }
 
  private:
-  std::chrono::time_point<std::chrono::system_clock> start_;
-  std::chrono::time_point<std::chrono::system_clock> end_;
+  std::chrono::steady_clock::time_point start_;
+  std::chrono::steady_clock::time_point end_;
 };
 
 }  // namespace timing
@@ -0,0 +1,102 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POLYGON_COVERAGE_PLANNERS_TRACING_H_
+#define POLYGON_COVERAGE_PLANNERS_TRACING_H_
+
+#include <chrono>
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace polygon_coverage_planning {
+namespace tracing {
+
+// Receives the begin and end of every span, e.g., to open ITT or Tracy zones
+// or to emit perf markers, whether or not a trace is recorded. Spans on
+// worker threads call the hook concurrently.
+class Hook {
+ public:
+  virtual ~Hook() = default;
+  virtual void Begin(const char* name) = 0;
+  virtual void End(const char* name) = 0;
+};
+
+// Records scoped spans of the planning pipeline and exports them in the
+// Chrome trace event format, which chrome://tracing and Perfetto open. Spans
+// on the same thread nest by time. Recording is off by default; a span then
+// costs a single atomic load.
+class Trace {
+ public:
+  // Start recording. Removes previously recorded spans.
+  static void Start();
+  // Stop recording. Keeps the recorded spans.
+  static void Stop();
+  static bool IsRecording();
+  static size_t GetNumSpans();
+
+  // Write the recorded spans as Chrome trace JSON.
+  static void Write(std::ostream& out);
+  static bool Save(const std::string& file);
+
+  // Register a profiler hook. nullptr removes it. Spans end on the hook they
+  // began on, so the hook must outlive the open spans. Without a hook a span
+  // costs another atomic load.
+  static void SetHook(Hook* hook);
+  static Hook* GetHook();
+
+  // A completed span.
+  struct Event {
+    const char* name = "";
+    size_t thread = 0;
+    double start_us = 0.0;
+    double duration_us = 0.0;
+    std::vector<std::pair<const char*, double>> args;
+  };
+
+ private:
+  friend class Span;
+  static void Add(Event* event,
+                  const std::chrono::steady_clock::time_point& start,
+                  const std::chrono::steady_clock::time_point& end);
+};
+
+// A span from construction to End or destruction. Name and attribute keys
+// must outlive the trace, e.g., string literals.
+class Span {
+ public:
+  explicit Span(const char* name);
+  ~Span();
+
+  // Attach a numeric attribute, e.g., a cluster id or node count.
+  Span& Set(const char* key, double value);
+  void End();
+
+ private:
+  bool is_recording_;
+  Hook* hook_;
+  std::chrono::steady_clock::time_point start_;
+  Trace::Event event_;
+};
+
+}  // namespace tracing
+}  // namespace polygon_coverage_planning
+
+#endif  // POLYGON_COVERAGE_PLANNERS_TRACING_H_
@@ -23,50 +23,107 @@
 #include <ros/assert.h>
 
 namespace polygon_coverage_planning {
+namespace {
+inline double computeDx(const Point_2& from, const Point_2& to) {
+  return CGAL::to_double(to.x()) - CGAL::to_double(from.x());
+}
+inline double computeDy(const Point_2& from, const Point_2& to) {
+  return CGAL::to_double(to.y()) - CGAL::to_double(from.y());
+}
+}  // namespace
 
 double computeWaypointsPathCost(const std::vector<Point_2>& path) {
   return path.size();
 }
 
 double computeEuclideanPathCost(const std::vector<Point_2>& path) {
-  double distance = 0.0;
-  for (size_t i = 0; i < path.size() - 1; i++)
-    distance += computeEuclideanSegmentCost(path[i + 1], path[i]);
-
-  return distance;
+  return computeSegmentPathCost(path, EuclideanSegmentKernel());
 }
 
 double computeEuclideanSegmentCost(const Point_2& from, const Point_2& to) {
-  return std::sqrt(CGAL::to_double(Segment_2(from, to).squared_length()));
+  return EuclideanSegmentKernel()(computeDx(from, to), computeDy(from, to));
 }
 
 double computeVelocityRampPathCost(const std::vector<Point_2>& path,
                                    double v_max, double a_max) {
-  double t = 0.0;
-  for (size_t i = 0; i < path.size() - 1; ++i) {
-    t += computeVelocityRampSegmentCost(path[i + 1], path[i], v_max, a_max);
-  }
-  return t;
+  return computeSegmentPathCost(path, VelocityRampSegmentKernel(v_max, a_max));
 }
 
 double computeVelocityRampSegmentCost(const Point_2& from, const Point_2& to,
                                       double v_max, double a_max) {
+  return VelocityRampSegmentKernel(v_max, a_max)(computeDx(from, to),
+                                                 computeDy(from, to));
+}
+
+VelocityRampSegmentKernel::VelocityRampSegmentKernel(double v_max,
+                                                     double a_max)
+    : v_max(v_max),
+      a_max(a_max),
+      acc_time(v_max / a_max),
+      acc_distance(0.5 * v_max * acc_time) {
   ROS_ASSERT(v_max > 0.0);
   ROS_ASSERT(a_max > 0.0);
+}
+
+PathCostKernel::PathCostKernel(CostFunctionType type, double v_max,
+                               double a_max)
+    : type_(type), velocity_ramp_(v_max, a_max) {
+  ROS_ASSERT(checkCostFunctionTypeValid(type));
+}
 
-  const double distance = computeEuclideanSegmentCost(from, to);
-  // Time to accelerate or decelerate to or from maximum velocity:
-  const double acc_time = v_max / a_max;
-  // Distance covered during complete acceleration or decelerate:
-  const double acc_distance = 0.5 * v_max * acc_time;
-  // Compute total segment time:
-  if (distance < 2.0 * acc_distance) {
-    // Case 1: Distance too small to accelerate to maximum velocity.
-    return 2.0 * std::sqrt(distance / a_max);
-  } else {
-    // Case 2: Distance long enough to accelerate to maximum velocity.
-    return 2.0 * acc_time + (distance - 2.0 * acc_distance) / v_max;
+double PathCostKernel::operator()(const std::vector<Point_2>& path) const {
+  switch (type_) {
+    case CostFunctionType::kTime:
+      return computeSegmentPathCost(path, velocity_ramp_);
+    case CostFunctionType::kWaypoints:
+      return computeWaypointsPathCost(path);
+    case CostFunctionType::kDistance:
+    default:
+      return computeSegmentPathCost(path, EuclideanSegmentKernel());
   }
 }
 
+double PathCostKernel::operator()(const double* x, const double* y,
+                                  size_t num_points) const {
+  switch (type_) {
+    case CostFunctionType::kTime:
+      return computeSegmentPathCost(x, y, num_points, velocity_ramp_);
+    case CostFunctionType::kWaypoints:
+      return num_points;
+    case CostFunctionType::kDistance:
+    default:
+      return computeSegmentPathCost(x, y, num_points,
+                                    EuclideanSegmentKernel());
+  }
+}
+
+double PathCostKernel::computeSegmentCost(const Point_2& from,
+                                          const Point_2& to) const {
+  return computeSegmentCost(computeDx(from, to), computeDy(from, to));
+}
+
+double PathCostKernel::computeSegmentCost(double dx, double dy) const {
+  switch (type_) {
+    case CostFunctionType::kTime:
+      return velocity_ramp_(dx, dy);
+    case CostFunctionType::kWaypoints:
+      return 2.0;
+    case CostFunctionType::kDistance:
+    default:
+      return EuclideanSegmentKernel()(dx, dy);
+  }
+}
+
+PathCostFunction makePathCostFunction(CostFunctionType type, double v_max,
+                                      double a_max) {
+  return PathCostKernel(type, v_max, a_max);
+}
+
+double computeSegmentCost(const PathCostFunction& cost_function,
+                          const Point_2& from, const Point_2& to) {
+  const PathCostKernel* kernel = getPathCostKernel(cost_function);
+  return kernel ? kernel->computeSegmentCost(from, to)
+                : cost_function({from, to});
+}
+
 }  // namespace polygon_coverage_planning
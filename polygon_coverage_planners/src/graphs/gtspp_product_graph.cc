@@ -18,502 +18,709 @@
  */
 
 #include <ros/console.h>
-#include <chrono>
+#include <cmath>
 #include <numeric>
 
 #include "polygon_coverage_planners/graphs/gtspp_product_graph.h"
+#include "polygon_coverage_planners/memory.h"
+#include "polygon_coverage_planners/tracing.h"
 
 namespace polygon_coverage_planning {
 namespace gtspp_product_graph {
 
 const double kTimeOut = 200.0;
 
+namespace {
+// Multiply and add without overflow.
+bool multiplyAdd(size_t a, size_t b, size_t c, size_t* result) {
+  if (a != 0 && b > (std::numeric_limits<size_t>::max() - c) / a) {
+    return false;
+  }
+  *result = a * b + c;
+  return true;
+}
+}  // namespace
+
 bool GtsppProductGraph::create() {
-  if (sweep_plan_graph_ == nullptr || boolean_lattice_ == nullptr) {
-    ROS_ERROR("Sweep plan graph or boolean lattice not set.");
+  if (sweep_plan_graph_ == nullptr) {
+    ROS_ERROR("Sweep plan graph not set.");
     return false;
   }
+  offsets_.clear();
+  neighbors_.clear();
+  costs_.clear();
+  tracing::Span span("product_graph");
 
-  graph_.reserve(boolean_lattice_->size() * sweep_plan_graph_->size());
+  MemoryEstimate estimate;
+  if (!estimateMemory(*sweep_plan_graph_, true, &estimate)) {
+    return false;
+  }
 
-  for (size_t lattice_id = 0; lattice_id < boolean_lattice_->size();
-       ++lattice_id) {
-    for (size_t sweep_id = 0; sweep_id < sweep_plan_graph_->size();
-         ++sweep_id) {
-      if (!addNode(NodeProperty(sweep_id, lattice_id))) {
-        return false;
+  const size_t num_sweeps = sweep_plan_graph_->size();
+  std::vector<size_t> clusters(num_sweeps);
+  for (size_t i = 0; i < num_sweeps; ++i) {
+    const sweep_plan_graph::NodeProperty* node_property =
+        sweep_plan_graph_->getNodeProperty(i);
+    if (node_property == nullptr) {
+      return false;
+    }
+    clusters[i] = node_property->cluster;
+  }
+
+  const size_t num_masks = static_cast<size_t>(1)
+                           << sweep_plan_graph_->getDecompositionSize();
+  offsets_.reserve(num_masks * num_sweeps + 1);
+  neighbors_.reserve(estimate.num_edges);
+  costs_.reserve(estimate.num_edges);
+  offsets_.push_back(0);
+  for (size_t mask = 0; mask < num_masks; ++mask) {
+    for (size_t sweep_id = 0; sweep_id < num_sweeps; ++sweep_id) {
+      const size_t cluster = clusters[sweep_id];
+      if (boolean_lattice::BitmaskLattice::includesCluster(mask, cluster)) {
+        // E1 edges: sweep plan graph out-edges into unvisited clusters.
+        sweep_plan_graph_->forEachNeighbor(
+            sweep_id, [&](size_t to_sweep_id, double cost) {
+              if (!boolean_lattice::BitmaskLattice::includesCluster(
+                      mask, clusters[to_sweep_id])) {
+                neighbors_.push_back(
+                    static_cast<uint32_t>(mask * num_sweeps + to_sweep_id));
+                costs_.push_back(cost);
+              }
+              return true;
+            });
+      } else {
+        // E2 edge: mark the cluster of the current sweep visited.
+        const size_t to_mask =
+            mask | boolean_lattice::BitmaskLattice::clusterToBitmask(cluster);
+        neighbors_.push_back(
+            static_cast<uint32_t>(to_mask * num_sweeps + sweep_id));
+        costs_.push_back(0.0);
       }
+      offsets_.push_back(neighbors_.size());
     }
   }
 
   ROS_INFO_STREAM("Created GTSPP product graph with "
-                  << graph_.size() << " nodes and " << edge_properties_.size()
-                  << " edges.");
+                  << size() << " nodes and " << getNumberOfEdges()
+                  << " edges using " << estimate.graph_bytes << " bytes.");
+  span.Set("num_nodes", size())
+      .Set("num_edges", getNumberOfEdges())
+      .Set("bytes", estimate.graph_bytes);
+  memory::Memory::Report("product_graph",
+                         offsets_.capacity() * sizeof(size_t) +
+                             neighbors_.capacity() * sizeof(uint32_t) +
+                             costs_.capacity() * sizeof(double),
+                         size());
+  // The bitmask lattice is implicit. Only its nodes are counted.
+  memory::Memory::Report("boolean_lattice", 0, num_masks);
+  memory::Memory::ReportPeakRss("peak_rss.product_graph");
   is_created_ = true;
   return true;
 }
 
 bool GtsppProductGraph::createOnline() {
-  if (sweep_plan_graph_ == nullptr || boolean_lattice_ == nullptr) {
-    ROS_ERROR("Sweep plan graph or boolean lattice not set.");
+  if (sweep_plan_graph_ == nullptr) {
+    ROS_ERROR("Sweep plan graph not set.");
     return false;
   }
 
-  graph_.resize(boolean_lattice_->size() * sweep_plan_graph_->size());
-
-  for (size_t lattice_id = 0; lattice_id < boolean_lattice_->size();
-       ++lattice_id) {
-    for (size_t sweep_id = 0; sweep_id < sweep_plan_graph_->size();
-         ++sweep_id) {
-      // Add node without edges.
-      const size_t idx = lattice_id * sweep_plan_graph_->size() + sweep_id;
-      node_properties_.insert(
-          std::make_pair(idx, NodeProperty(sweep_id, lattice_id)));
-    }
-  }
-
-  ROS_INFO_STREAM("Created GTSPP product graph with "
-                  << graph_.size() << " nodes without edges.");
+  // Nodes and edges are generated implicitly during search.
+  ROS_INFO_STREAM("Created implicit GTSPP product graph with "
+                  << sweep_plan_graph_->size() << " sweep plan graph nodes and "
+                  << sweep_plan_graph_->getDecompositionSize() << " clusters.");
   is_created_ = true;
   return true;
 }
 
 void GtsppProductGraph::clear() {
-  GraphBase::clear();
   sweep_plan_graph_ = nullptr;
-  boolean_lattice_ = nullptr;
+  is_created_ = false;
+  offsets_.clear();
+  neighbors_.clear();
+  costs_.clear();
 }
 
-bool GtsppProductGraph::addStartNode(const NodeProperty& node_property) {
-  if (boolean_lattice_ == nullptr) {
+bool GtsppProductGraph::estimateMemory(
+    const sweep_plan_graph::SweepPlanGraph& sweep_plan_graph, bool precompute,
+    MemoryEstimate* estimate) {
+  ROS_ASSERT(estimate);
+  *estimate = MemoryEstimate();
+
+  // The precomputed lattice excludes start and goal cluster, the implicit
+  // lattice of a query includes them.
+  const size_t num_clusters = sweep_plan_graph.getDecompositionSize();
+  const size_t num_lattice_clusters =
+      precompute ? num_clusters : num_clusters + 2;
+  if (num_lattice_clusters > boolean_lattice::kMaxBitmaskClusters) {
+    ROS_ERROR_STREAM("Product graph supports at most "
+                     << boolean_lattice::kMaxBitmaskClusters << " clusters.");
     return false;
   }
-  auto start_time = std::chrono::high_resolution_clock::now();
-  for (size_t lattice_id = 0; lattice_id < boolean_lattice_->size();
-       ++lattice_id) {
-    auto current_time = std::chrono::high_resolution_clock::now();
-    std::chrono::duration<double> elapsed = current_time - start_time;
-    if (elapsed.count() > kTimeOut) {
-      ROS_ERROR("Timout addStartNode.");
-      return false;
-    }
-    if (lattice_id == boolean_lattice_->getStartIdx()) {
-      start_idx_ = graph_.size();
-    }
-    if (!addNode(NodeProperty(sweep_plan_graph_->getStartIdx(), lattice_id))) {
-      return false;
+  const size_t num_masks = static_cast<size_t>(1) << num_lattice_clusters;
+  const size_t num_sweeps = sweep_plan_graph.size();
+
+  bool success = true;
+  if (precompute) {
+    // Base nodes plus start, start entry, goal entry and goal.
+    size_t num_base_nodes = 0;
+    success = multiplyAdd(num_masks, num_sweeps, 0, &num_base_nodes) &&
+              multiplyAdd(1, num_base_nodes, 4, &estimate->num_nodes);
+
+    // Every edge between two clusters exists in the quarter of the lattice
+    // that has visited the first but not the second cluster. Every sweep has
+    // an E2 edge in the half of the lattice that has not visited its cluster.
+    size_t num_cluster_edges = 0;
+    for (size_t from = 0; from < num_sweeps; ++from) {
+      const sweep_plan_graph::NodeProperty* from_property =
+          sweep_plan_graph.getNodeProperty(from);
+      if (from_property == nullptr) {
+        return false;
+      }
+      sweep_plan_graph.forEachNeighbor(from, [&](size_t to, double) {
+        const sweep_plan_graph::NodeProperty* to_property =
+            sweep_plan_graph.getNodeProperty(to);
+        if (to_property != nullptr &&
+            to_property->cluster != from_property->cluster) {
+          ++num_cluster_edges;
+        }
+        return true;
+      });
     }
-  }
-  return true;
-}
-
-bool GtsppProductGraph::addStartNode() { return addStartNode(NodeProperty()); }
-
-bool GtsppProductGraph::addGoalNode(const NodeProperty& node_property) {
-  if (boolean_lattice_ == nullptr) {
+    size_t num_e1_edges = 0;
+    success = success &&
+              multiplyAdd(num_cluster_edges, num_masks / 4, 0, &num_e1_edges);
+    success = success && multiplyAdd(num_sweeps, num_masks / 2, num_e1_edges,
+                                     &estimate->num_edges);
+    size_t offset_bytes = 0;
+    success = success &&
+              multiplyAdd(num_base_nodes + 1, sizeof(size_t), 0, &offset_bytes);
+    success = success &&
+              multiplyAdd(estimate->num_edges,
+                          sizeof(uint32_t) + sizeof(double), offset_bytes,
+                          &estimate->graph_bytes);
+    // Edge targets are 32 bit.
+    success = success && estimate->num_nodes <=
+                             std::numeric_limits<uint32_t>::max();
+  } else {
+    // Sweeps plus start and goal.
+    success = success &&
+              multiplyAdd(num_masks, num_sweeps + 2, 0, &estimate->num_nodes);
+  }
+  success = success &&
+            multiplyAdd(estimate->num_nodes, SearchWorkspace::kBytesPerNode, 0,
+                        &estimate->search_bytes);
+  success = success && estimate->graph_bytes <=
+                           std::numeric_limits<size_t>::max() -
+                               estimate->search_bytes;
+  if (!success) {
+    ROS_ERROR_STREAM("Product graph of " << num_sweeps << " sweeps and "
+                                         << num_clusters << " clusters is "
+                                         << "not addressable.");
     return false;
   }
-  auto start_time = std::chrono::high_resolution_clock::now();
-  for (size_t lattice_id = 0; lattice_id < boolean_lattice_->size();
-       ++lattice_id) {
-    auto current_time = std::chrono::high_resolution_clock::now();
-    std::chrono::duration<double> elapsed = current_time - start_time;
-    if (elapsed.count() > kTimeOut) {
-      ROS_ERROR("Timout addGoalNode.");
-      return false;
-    }
-    if (lattice_id == boolean_lattice_->getGoalIdx()) {
-      goal_idx_ = graph_.size();
-    }
-    if (!addNode(NodeProperty(sweep_plan_graph_->getGoalIdx(), lattice_id))) {
-      return false;
-    }
-  }
   return true;
 }
 
-bool GtsppProductGraph::addGoalNode() { return addGoalNode(NodeProperty()); }
-
 bool GtsppProductGraph::solve(const Point_2& start, const Point_2& goal,
-                              std::vector<Point_2>* waypoints) const {
-  if (!is_created_) {
-    return false;
-  }
-  // Create copies of graphs to add start and goal.
-  GtsppProductGraph temp_gtspp_product_graph = *this;
-  sweep_plan_graph::SweepPlanGraph temp_sweep_plan_graph = *sweep_plan_graph_;
-  boolean_lattice::BooleanLattice temp_boolean_lattice = *boolean_lattice_;
+                              std::vector<Point_2>* waypoints,
+                              const Deadline& deadline) const {
+  ROS_ASSERT(waypoints);
+  waypoints->clear();
 
-  // Add start and goal to temporary graphs.
-  if (!temp_boolean_lattice.addStartNode() ||
-      !temp_boolean_lattice.addGoalNode()) {
+  if (!is_created_ || sweep_plan_graph_ == nullptr) {
+    ROS_ERROR("Product graph not created.");
     return false;
   }
 
-  sweep_plan_graph::NodeProperty start_sweep_node, goal_sweep_node;
-  if (!temp_sweep_plan_graph.createNodeProperty(
-          temp_boolean_lattice.getStartCluster(), start, &start_sweep_node) ||
-      !temp_sweep_plan_graph.createNodeProperty(
-          temp_boolean_lattice.getGoalCluster(), goal, &goal_sweep_node)) {
+  // Add start and goal on top of the shared sweep plan graph.
+  sweep_plan_graph::Overlay sweep_overlay;
+  if (!sweep_plan_graph_->createOverlay(start, goal, &sweep_overlay)) {
     return false;
   }
-
-  if (!temp_sweep_plan_graph.addStartNode(start_sweep_node) ||
-      !temp_sweep_plan_graph.addGoalNode(goal_sweep_node)) {
+  const size_t num_sweeps = sweep_plan_graph_->size();
+  const size_t num_masks = static_cast<size_t>(1)
+                           << sweep_plan_graph_->getDecompositionSize();
+  if (size() != num_sweeps * num_masks) {
+    ROS_ERROR("Product graph does not match sweep plan graph.");
     return false;
   }
-
-  temp_gtspp_product_graph.setSweepPlanGraph(&temp_sweep_plan_graph);
-  temp_gtspp_product_graph.setBooleanLattice(&temp_boolean_lattice);
-  if (!temp_gtspp_product_graph.addStartNode() ||
-      !temp_gtspp_product_graph.addGoalNode()) {
+  const size_t start_sweep_id = sweep_overlay.getStartIdx();
+  const size_t goal_sweep_id = sweep_overlay.getGoalIdx();
+  const size_t full_mask = num_masks - 1;
+
+  // Start and goal product nodes continue after the base product nodes:
+  // - (start sweep, empty set)
+  // - (start sweep, empty base set), i.e., the start cluster is visited
+  // - (goal sweep, full base set)
+  // - (goal sweep, all clusters)
+  const size_t start_idx = size();
+  const size_t start_entry_idx = start_idx + 1;
+  const size_t goal_entry_idx = start_idx + 2;
+  const size_t goal_idx = start_idx + 3;
+  auto decode = [&](size_t n, size_t* sweep_id, size_t* mask) {
+    if (n < start_idx) {
+      *sweep_id = n % num_sweeps;
+      *mask = n / num_sweeps;
+    } else if (n < goal_entry_idx) {
+      *sweep_id = start_sweep_id;
+      *mask = 0;
+    } else {
+      *sweep_id = goal_sweep_id;
+      *mask = full_mask;
+    }
+  };
+
+  // Cache clusters of sweep plan graph nodes.
+  std::vector<size_t> clusters(sweep_overlay.size());
+  for (size_t i = 0; i < clusters.size(); ++i) {
+    const sweep_plan_graph::NodeProperty* node_property =
+        sweep_overlay.getNodeProperty(i);
+    if (node_property == nullptr) {
+      return false;
+    }
+    clusters[i] = node_property->cluster;
+  }
+  std::vector<double> min_entry_costs;
+  if (!computeMinEntryCosts(sweep_overlay, &min_entry_costs)) {
     return false;
   }
 
-  // Solve graph using Dijkstra.
   Solution solution;
-  if (!temp_gtspp_product_graph.solveDijkstra(&solution)) {
-    ROS_ERROR("Dijkstra failed.");
+  const Deadline search_deadline = deadline.limit(kTimeOut);
+  DeadlinePoller poller(search_deadline);
+  tracing::Span span("product_graph_search");
+  span.Set("num_nodes", size());
+  const bool success = searchBestFirst(
+      goal_idx + 1, start_idx, goal_idx,
+      [&](size_t current, auto relax) {
+        if (poller.isExpired()) {
+          ROS_ERROR("Timout solve.");
+          return false;
+        }
+
+        if (current == start_idx) {
+          // E2 edge: mark the start cluster visited.
+          relax(start_entry_idx, 0.0);
+        } else if (current == start_entry_idx) {
+          // E1 edges: start to all sweeps.
+          sweep_overlay.forEachNeighbor(
+              start_sweep_id, [&](size_t to_sweep_id, double cost) {
+                if (to_sweep_id < num_sweeps) {
+                  relax(to_sweep_id, cost);
+                }
+                return true;
+              });
+        } else if (current < start_idx) {
+          // Base product graph edges.
+          for (size_t i = offsets_[current]; i < offsets_[current + 1]; ++i) {
+            relax(neighbors_[i], costs_[i]);
+          }
+          // E1 edge: sweep to goal after visiting all clusters.
+          double cost = -1.0;
+          if (current / num_sweeps == full_mask &&
+              sweep_overlay.getEdgeCost(
+                  EdgeId(current % num_sweeps, goal_sweep_id), &cost)) {
+            relax(goal_entry_idx, cost);
+          }
+        } else if (current == goal_entry_idx) {
+          // E2 edge: mark the goal cluster visited.
+          relax(goal_idx, 0.0);
+        }
+        return true;
+      },
+      [&](size_t n, double* h) {
+        size_t sweep_id = 0, mask = 0;
+        decode(n, &sweep_id, &mask);
+        *h = 0.0;
+        for (size_t cluster = 0; cluster < min_entry_costs.size(); ++cluster) {
+          if (cluster != clusters[sweep_id] &&
+              !boolean_lattice::BitmaskLattice::includesCluster(mask,
+                                                                cluster)) {
+            *h += min_entry_costs[cluster];
+          }
+        }
+        return true;
+      },
+      &solution);
+  if (!success) {
+    ROS_ERROR("A* failed.");
     return false;
   }
 
-  return temp_gtspp_product_graph.getWaypoints(solution, waypoints);
+  // Translate product graph solution into sweep plan graph indices, i.e., E1
+  // edges. Only E1 edges change the sweep.
+  Solution sweep_plan_solution;
+  for (size_t i = 0; i + 1 < solution.size(); ++i) {
+    size_t from_sweep_id = 0, to_sweep_id = 0, mask = 0;
+    decode(solution[i], &from_sweep_id, &mask);
+    decode(solution[i + 1], &to_sweep_id, &mask);
+    if (from_sweep_id != to_sweep_id) {
+      if (sweep_plan_solution.empty()) {
+        sweep_plan_solution.push_back(from_sweep_id);
+      }
+      sweep_plan_solution.push_back(to_sweep_id);
+    }
+  }
+
+  return sweep_plan_graph_->getWaypoints(sweep_overlay, sweep_plan_solution,
+                                         waypoints);
 }
 
-bool GtsppProductGraph::solveOnline(const Point_2& start, const Point_2& goal,
-                                    std::vector<Point_2>* waypoints) const {
+bool GtsppProductGraph::solveOnline(
+    const Point_2& start, const Point_2& goal, std::vector<Point_2>* waypoints,
+    double upper_bound, const Deadline& deadline) const {
   ROS_ASSERT(waypoints);
   waypoints->clear();
 
-  // Create temporary graph structure.
-  GtsppProductGraph temp_gtspp_product_graph = *this;
-  sweep_plan_graph::SweepPlanGraph temp_sweep_plan_graph = *sweep_plan_graph_;
-  boolean_lattice::BooleanLattice temp_boolean_lattice = *boolean_lattice_;
+  if (!is_created_ || sweep_plan_graph_ == nullptr) {
+    ROS_ERROR("Product graph not created.");
+    return false;
+  }
 
-  // Add start and goal to temporary graphs.
+  // Add start and goal on top of the shared sweep plan graph. The implicit
+  // lattice is free to create.
+  boolean_lattice::BitmaskLattice temp_boolean_lattice(
+      sweep_plan_graph_->getDecompositionSize());
   if (!temp_boolean_lattice.addStartNode() ||
       !temp_boolean_lattice.addGoalNode()) {
     return false;
   }
 
-  sweep_plan_graph::NodeProperty start_sweep_node, goal_sweep_node;
-  if (!temp_sweep_plan_graph.createNodeProperty(
-          temp_boolean_lattice.getStartCluster(), start, &start_sweep_node) ||
-      !temp_sweep_plan_graph.createNodeProperty(
-          temp_boolean_lattice.getGoalCluster(), goal, &goal_sweep_node)) {
+  sweep_plan_graph::Overlay sweep_overlay;
+  if (!sweep_plan_graph_->createOverlay(start, goal, &sweep_overlay)) {
     return false;
   }
 
-  if (!temp_sweep_plan_graph.addStartNode(start_sweep_node) ||
-      !temp_sweep_plan_graph.addGoalNode(goal_sweep_node)) {
+  // Search implicit product graph.
+  Solution sweep_plan_solution;
+  if (!solveImplicit(sweep_overlay, temp_boolean_lattice, upper_bound,
+                     deadline, &sweep_plan_solution)) {
+    if (deadline.isCancelled()) {
+      ROS_INFO("A* cancelled.");
+    } else if (std::isfinite(upper_bound)) {
+      ROS_INFO("A* found no solution below the upper bound.");
+    } else {
+      ROS_ERROR("A* failed.");
+    }
     return false;
   }
 
-  temp_gtspp_product_graph.setSweepPlanGraph(&temp_sweep_plan_graph);
-  temp_gtspp_product_graph.setBooleanLattice(&temp_boolean_lattice);
-  if (!temp_gtspp_product_graph.addStartNode() ||
-      !temp_gtspp_product_graph.addGoalNode()) {
+  return sweep_plan_graph_->getWaypoints(sweep_overlay, sweep_plan_solution,
+                                         waypoints);
+}
+
+bool GtsppProductGraph::createReverseTree(const Point_2& goal,
+                                          ReverseTree* tree,
+                                          const Deadline& deadline) const {
+  ROS_ASSERT(tree);
+  if (!is_created_ || sweep_plan_graph_ == nullptr) {
+    ROS_ERROR("Product graph not created.");
     return false;
   }
-
-  // Create graph while solving Dijkstra.
-  Solution solution;
-  if (!temp_gtspp_product_graph.createDijkstra(&solution)) {
-    ROS_ERROR("Dijkstra failed.");
+  const size_t num_sweeps = sweep_plan_graph_->size();
+  const size_t num_clusters = sweep_plan_graph_->getDecompositionSize();
+  size_t num_nodes = 0;
+  if (num_clusters >= std::numeric_limits<size_t>::digits ||
+      num_sweeps > std::numeric_limits<uint32_t>::max() ||
+      !multiplyAdd(static_cast<size_t>(1) << num_clusters, num_sweeps, 0,
+                   &num_nodes)) {
+    ROS_ERROR("Product graph too large.");
     return false;
   }
+  tracing::Span span("reverse_tree");
+  span.Set("num_nodes", num_nodes);
 
-  return temp_gtspp_product_graph.getWaypoints(solution, waypoints);
-}
-
-bool GtsppProductGraph::getWaypoints(const Solution& solution,
-                                     std::vector<Point_2>* waypoints) const {
-  ROS_ASSERT(waypoints);
-  waypoints->clear();
-
-  if (sweep_plan_graph_ == nullptr) {
-    ROS_ERROR("Sweep plan graph not set.");
+  tree->goal = goal;
+  if (!sweep_plan_graph_->createGoalOverlay(goal, &tree->goal_overlay)) {
     return false;
   }
-  // Translate product graph solution in sweep plan graph indices.
-  Solution sweep_plan_solution;
-  for (size_t i = 0; i < solution.size() - 1; ++i) {
-    // Access edge and node properties.
-    const EdgeId edge_id(solution[i], solution[i + 1]);
-    const EdgeProperty* edge_property = getEdgeProperty(edge_id);
-    const NodeProperty* from_node_property = getNodeProperty(edge_id.first);
-    const NodeProperty* to_node_property = getNodeProperty(edge_id.second);
-    if (edge_property == nullptr || from_node_property == nullptr ||
-        to_node_property == nullptr) {
+  const size_t goal_sweep_id = tree->goal_overlay.getGoalIdx();
+  tree->clusters.resize(num_sweeps);
+  for (size_t i = 0; i < num_sweeps; ++i) {
+    const sweep_plan_graph::NodeProperty* node_property =
+        sweep_plan_graph_->getNodeProperty(i);
+    if (node_property == nullptr) {
       return false;
     }
-
-    // Check edge type (E1) and add to solution.
-    if (edge_property->type == EdgeProperty::Type::kE1) {
-      if (sweep_plan_solution.empty()) {
-        sweep_plan_solution.push_back(from_node_property->sweep_plan_graph_id);
-      }
-      sweep_plan_solution.push_back(to_node_property->sweep_plan_graph_id);
+    tree->clusters[i] = node_property->cluster;
+  }
+  tree->cost_to_go.assign(num_nodes, std::numeric_limits<double>::infinity());
+  tree->next.assign(num_nodes, std::numeric_limits<uint32_t>::max());
+
+  // Successors visit one more cluster and have a numerically larger mask, so
+  // they are complete when their predecessors are relaxed.
+  const size_t full_mask = (static_cast<size_t>(1) << num_clusters) - 1;
+  DeadlinePoller poller(deadline);
+  for (size_t mask = full_mask + 1; mask-- > 0;) {
+    if (poller.isExpired()) {
+      ROS_ERROR("Timeout reverse search.");
+      return false;
     }
-  }
-
-  // Get waypoints.
-  return sweep_plan_graph_->getWaypoints(sweep_plan_solution, waypoints);
-}
-
-bool GtsppProductGraph::addEdges() {
-  // Find 'new' node properties.
-  if (graph_.empty()) {
-    ROS_ERROR("Cannot add edges to an empty graph.");
-    return false;
-  }
-
-  const size_t new_id = graph_.size() - 1;
-  // Possible 'adjacent' nodes:
-  for (size_t adj_id = 0; adj_id < new_id; ++adj_id) {
-    // Connected based on E1 or E2 criterion.
-    const EdgeId forwards_edge_id(new_id, adj_id);
-    const EdgeId backwards_edge_id(adj_id, new_id);
-    if (isE1(forwards_edge_id)) {
-      double cost = -1.0;
-      EdgeProperty edge_property(EdgeProperty::Type::kE1);
-      if (!getSweepPlanGraphEdgeCost(forwards_edge_id, &cost) ||
-          !addEdge(forwards_edge_id, edge_property, cost)) {
-        return false;
+    for (size_t sweep_id = 0; sweep_id < num_sweeps; ++sweep_id) {
+      if (!boolean_lattice::BitmaskLattice::includesCluster(
+              mask, tree->clusters[sweep_id])) {
+        continue;
       }
-    } else if (isE1(backwards_edge_id)) {
-      double cost = -1.0;
-      EdgeProperty edge_property(EdgeProperty::Type::kE1);
-      if (!getSweepPlanGraphEdgeCost(backwards_edge_id, &cost) ||
-          !addEdge(backwards_edge_id, edge_property, cost)) {
-        return false;
-      }
-    } else if (isE2(forwards_edge_id)) {
-      double cost = -1.0;
-      EdgeProperty edge_property(EdgeProperty::Type::kE2);
-      if (!getBooleanLatticeEdgeCost(forwards_edge_id, &cost) ||
-          !addEdge(forwards_edge_id, edge_property, cost)) {
-        return false;
-      }
-    } else if (isE2(backwards_edge_id)) {
-      double cost = -1.0;
-      EdgeProperty edge_property(EdgeProperty::Type::kE2);
-      if (!getBooleanLatticeEdgeCost(backwards_edge_id, &cost) ||
-          !addEdge(backwards_edge_id, edge_property, cost)) {
-        return false;
+      const size_t n = mask * num_sweeps + sweep_id;
+      if (mask == full_mask) {
+        // E1 edge: sweep to goal after visiting all clusters.
+        double cost = -1.0;
+        if (tree->goal_overlay.getEdgeCost(EdgeId(sweep_id, goal_sweep_id),
+                                           &cost)) {
+          tree->cost_to_go[n] = cost;
+        }
+        continue;
       }
+      // E1 edges into unvisited clusters followed by their E2 edge.
+      sweep_plan_graph_->forEachNeighbor(
+          sweep_id, [&](size_t to_sweep_id, double cost) {
+            const size_t cluster = tree->clusters[to_sweep_id];
+            if (!boolean_lattice::BitmaskLattice::includesCluster(mask,
+                                                                  cluster)) {
+              const size_t to_mask =
+                  mask |
+                  boolean_lattice::BitmaskLattice::clusterToBitmask(cluster);
+              const double cost_to_go =
+                  cost + tree->cost_to_go[to_mask * num_sweeps + to_sweep_id];
+              if (cost_to_go < tree->cost_to_go[n]) {
+                tree->cost_to_go[n] = cost_to_go;
+                tree->next[n] = static_cast<uint32_t>(to_sweep_id);
+              }
+            }
+            return true;
+          });
     }
   }
 
+  memory::Memory::Report(
+      "reverse_tree",
+      tree->cost_to_go.capacity() * sizeof(double) +
+          tree->next.capacity() * sizeof(uint32_t),
+      num_nodes);
   return true;
 }
 
-bool GtsppProductGraph::isE1(const EdgeId& edge_id) const {
-  // Access node properties.
-  const NodeProperty* from = getNodeProperty(edge_id.first);
-  const NodeProperty* to = getNodeProperty(edge_id.second);
-  const boolean_lattice::NodeProperty* c =
-      getBooleanLatticeNodeProperty(edge_id.first);
-  const sweep_plan_graph::NodeProperty* from_v =
-      getSweepPlanGraphNodeProperty(edge_id.first);
-  const sweep_plan_graph::NodeProperty* to_v =
-      getSweepPlanGraphNodeProperty(edge_id.second);
-  if (from == nullptr || to == nullptr || c == nullptr || from_v == nullptr ||
-      to_v == nullptr || sweep_plan_graph_ == nullptr) {
-    return false;  // Bad access.
-  }
-
-  return isE1(from->boolean_lattice_id, to->boolean_lattice_id,
-              from->sweep_plan_graph_id, to->sweep_plan_graph_id,
-              c->visited_clusters, from_v->cluster, to_v->cluster);
-}
-
-bool GtsppProductGraph::isE1(size_t from_boolean_lattice_id,
-                             size_t to_boolean_lattice_id,
-                             size_t from_sweep_plan_graph_id,
-                             size_t to_sweep_plan_graph_id,
-                             const std::set<size_t>& cluster_set,
-                             size_t from_sweep_cluster,
-                             size_t to_sweep_cluster) const {
-  return from_boolean_lattice_id == to_boolean_lattice_id  // Same lattice node.
-         && sweep_plan_graph_->edgeExists(EdgeId(
-                from_sweep_plan_graph_id,
-                to_sweep_plan_graph_id))  // Sweep plan graph edge exists.
-         && cluster_set.count(from_sweep_cluster) >
-                0  // From vertex is covered already.
-         && cluster_set.count(to_sweep_cluster) ==
-                0;  // To vertex is not covered, yet.
-}
-
-bool GtsppProductGraph::isE2(const EdgeId& edge_id) const {
-  // Access node properties.
-  const NodeProperty* from = getNodeProperty(edge_id.first);
-  const NodeProperty* to = getNodeProperty(edge_id.second);
-  const boolean_lattice::NodeProperty* from_c =
-      getBooleanLatticeNodeProperty(edge_id.first);
-  const boolean_lattice::NodeProperty* to_c =
-      getBooleanLatticeNodeProperty(edge_id.second);
-  const sweep_plan_graph::NodeProperty* v =
-      getSweepPlanGraphNodeProperty(edge_id.first);
-  if (from == nullptr || to == nullptr || from_c == nullptr ||
-      to_c == nullptr || v == nullptr || boolean_lattice_ == nullptr) {
-    return false;  // Bad access.
-  }
-
-  return isE2(from->sweep_plan_graph_id, to->sweep_plan_graph_id,
-              from->boolean_lattice_id, to->boolean_lattice_id,
-              from_c->visited_clusters, to_c->visited_clusters, v->cluster);
-}
-
-bool GtsppProductGraph::isE2(size_t from_sweep_plan_graph_id,
-                             size_t to_sweep_plan_graph_id,
-                             size_t from_boolean_lattice_id,
-                             size_t to_boolean_lattice_id,
-                             const std::set<size_t>& from_cluster_set,
-                             const std::set<size_t>& to_cluster_set,
-                             size_t sweep_cluster) const {
-  return from_sweep_plan_graph_id ==
-             to_sweep_plan_graph_id  // Same sweep plan graph node.
-         && boolean_lattice_->edgeExists(
-                EdgeId(from_boolean_lattice_id,
-                       to_boolean_lattice_id))  // Boolean lattice edge exists.
-         && from_cluster_set.count(sweep_cluster) ==
-                0  // Vertex is not in visited clusters of from_c.
-         && to_cluster_set.count(sweep_cluster) >
-                0;  // Vertex is in visited clusters of to_c.
-}
+bool GtsppProductGraph::solveReverse(const ReverseTree& tree,
+                                     const Point_2& start,
+                                     std::vector<Point_2>* waypoints) const {
+  ROS_ASSERT(waypoints);
+  waypoints->clear();
 
-const boolean_lattice::NodeProperty*
-GtsppProductGraph::getBooleanLatticeNodeProperty(size_t node_id) const {
-  const NodeProperty* node_property = getNodeProperty(node_id);
-  if (boolean_lattice_ == nullptr || node_property == nullptr) {
-    return nullptr;
+  if (!is_created_ || sweep_plan_graph_ == nullptr) {
+    ROS_ERROR("Product graph not created.");
+    return false;
   }
-  return boolean_lattice_->getNodeProperty(node_property->boolean_lattice_id);
-}
-
-const sweep_plan_graph::NodeProperty*
-GtsppProductGraph::getSweepPlanGraphNodeProperty(size_t node_id) const {
-  const NodeProperty* node_property = getNodeProperty(node_id);
-  if (sweep_plan_graph_ == nullptr || node_property == nullptr) {
-    return nullptr;
+  const size_t num_sweeps = sweep_plan_graph_->size();
+  const size_t num_clusters = sweep_plan_graph_->getDecompositionSize();
+  if (tree.goal_overlay.getBase() != sweep_plan_graph_ ||
+      tree.clusters.size() != num_sweeps ||
+      tree.cost_to_go.size() !=
+          (static_cast<size_t>(1) << num_clusters) * num_sweeps) {
+    ROS_ERROR("Reverse tree does not match product graph.");
+    return false;
   }
-  return sweep_plan_graph_->getNodeProperty(node_property->sweep_plan_graph_id);
-}
-
-bool GtsppProductGraph::getSweepPlanGraphEdgeCost(const EdgeId& edge_id,
-                                                  double* cost) const {
-  ROS_ASSERT(cost);
-  *cost = -1.0;
-  const NodeProperty* from_node_property = getNodeProperty(edge_id.first);
-  const NodeProperty* to_node_property = getNodeProperty(edge_id.second);
 
-  if (sweep_plan_graph_ == nullptr || from_node_property == nullptr ||
-      to_node_property == nullptr) {
+  sweep_plan_graph::Overlay sweep_overlay = tree.goal_overlay;
+  if (!sweep_plan_graph_->addOverlayStart(start, &sweep_overlay)) {
     return false;
   }
+  const size_t start_sweep_id = sweep_overlay.getStartIdx();
+
+  // E1 edge from the start into the tree at the cheapest first sweep.
+  double min_cost = std::numeric_limits<double>::infinity();
+  size_t first_sweep_id = num_sweeps;
+  sweep_overlay.forEachNeighbor(
+      start_sweep_id, [&](size_t to_sweep_id, double cost) {
+        if (to_sweep_id < num_sweeps) {
+          const size_t mask = boolean_lattice::BitmaskLattice::clusterToBitmask(
+              tree.clusters[to_sweep_id]);
+          const double total_cost =
+              cost + tree.cost_to_go[mask * num_sweeps + to_sweep_id];
+          if (total_cost < min_cost) {
+            min_cost = total_cost;
+            first_sweep_id = to_sweep_id;
+          }
+        }
+        return true;
+      });
+  if (first_sweep_id == num_sweeps) {
+    ROS_ERROR("Start cannot reach the goal through all clusters.");
+    return false;
+  }
+
+  // Follow the tree until all clusters are visited.
+  const size_t full_mask = (static_cast<size_t>(1) << num_clusters) - 1;
+  Solution sweep_plan_solution({start_sweep_id, first_sweep_id});
+  size_t mask = boolean_lattice::BitmaskLattice::clusterToBitmask(
+      tree.clusters[first_sweep_id]);
+  size_t sweep_id = first_sweep_id;
+  while (mask != full_mask) {
+    sweep_id = tree.next[mask * num_sweeps + sweep_id];
+    mask |= boolean_lattice::BitmaskLattice::clusterToBitmask(
+        tree.clusters[sweep_id]);
+    sweep_plan_solution.push_back(sweep_id);
+  }
+  sweep_plan_solution.push_back(tree.goal_overlay.getGoalIdx());
 
-  EdgeId sweep_plan_graph_edge(from_node_property->sweep_plan_graph_id,
-                               to_node_property->sweep_plan_graph_id);
-  return sweep_plan_graph_->getEdgeCost(sweep_plan_graph_edge, cost);
+  return sweep_plan_graph_->getWaypoints(sweep_overlay, sweep_plan_solution,
+                                         waypoints);
 }
 
-bool GtsppProductGraph::getBooleanLatticeEdgeCost(const EdgeId& edge_id,
-                                                  double* cost) const {
-  ROS_ASSERT(cost);
-  *cost = -1.0;
-  const NodeProperty* from_node_property = getNodeProperty(edge_id.first);
-  const NodeProperty* to_node_property = getNodeProperty(edge_id.second);
+bool GtsppProductGraph::computeMinEntryCosts(
+    const sweep_plan_graph::Overlay& sweep_plan_graph,
+    std::vector<double>* min_entry_costs) {
+  ROS_ASSERT(min_entry_costs);
+  min_entry_costs->clear();
+
+  std::vector<size_t> clusters(sweep_plan_graph.size());
+  for (size_t i = 0; i < clusters.size(); ++i) {
+    const sweep_plan_graph::NodeProperty* node_property =
+        sweep_plan_graph.getNodeProperty(i);
+    if (node_property == nullptr) {
+      return false;
+    }
+    clusters[i] = node_property->cluster;
+    if (clusters[i] >= min_entry_costs->size()) {
+      min_entry_costs->resize(clusters[i] + 1,
+                              std::numeric_limits<double>::max());
+    }
+  }
 
-  if (boolean_lattice_ == nullptr || from_node_property == nullptr ||
-      to_node_property == nullptr) {
-    return false;
+  for (size_t from = 0; from < clusters.size(); ++from) {
+    sweep_plan_graph.forEachNeighbor(from, [&](size_t to, double cost) {
+      double& min_entry_cost = (*min_entry_costs)[clusters[to]];
+      if (clusters[to] != clusters[from] && cost < min_entry_cost) {
+        min_entry_cost = cost;
+      }
+      return true;
+    });
   }
 
-  EdgeId boolean_lattice_edge(from_node_property->boolean_lattice_id,
-                              to_node_property->boolean_lattice_id);
-  return boolean_lattice_->getEdgeCost(boolean_lattice_edge, cost);
+  // Clusters that cannot be entered, e.g., the start, do not add cost.
+  for (double& min_entry_cost : *min_entry_costs) {
+    if (min_entry_cost == std::numeric_limits<double>::max()) {
+      min_entry_cost = 0.0;
+    }
+  }
+  return true;
 }
 
-bool GtsppProductGraph::createDijkstra(Solution* solution) {
-  ROS_ASSERT(solution);
-  solution->clear();
-  if (!nodeExists(start_idx_) || !nodeExists(goal_idx_)) {
+bool GtsppProductGraph::solveImplicit(
+    const sweep_plan_graph::Overlay& sweep_plan_graph,
+    const boolean_lattice::BitmaskLattice& boolean_lattice, double upper_bound,
+    const Deadline& deadline, Solution* sweep_plan_solution) {
+  ROS_ASSERT(sweep_plan_solution);
+  sweep_plan_solution->clear();
+
+  // Product node id = lattice id * number of sweep plan graph nodes + sweep
+  // plan graph id.
+  const size_t num_sweeps = sweep_plan_graph.size();
+  if (num_sweeps == 0 || boolean_lattice.size() >
+                             std::numeric_limits<size_t>::max() / num_sweeps) {
+    ROS_ERROR("Product graph too large.");
     return false;
   }
-  clearEdges();
-
-  // https://en.wikipedia.org/wiki/Dijkstra%27s_algorithm
-  // Initialization.
-  std::set<size_t> open_set = {start_idx_};  // Nodes to evaluate.
-  std::set<size_t> closed_set;               // Nodes already evaluated.
-  std::map<size_t, size_t> came_from;  // Get previous node on optimal path.
-  std::map<size_t, double> cost;       // Optimal cost from start.
-  for (size_t i = 0; i < graph_.size(); i++) {
-    cost[i] = std::numeric_limits<double>::max();
-  }
-  cost[start_idx_] = 0.0;
-
-  auto start_time = std::chrono::high_resolution_clock::now();
-  while (!open_set.empty()) {
-    auto current_time = std::chrono::high_resolution_clock::now();
-    std::chrono::duration<double> elapsed = current_time - start_time;
-    if (elapsed.count() > kTimeOut) {
-      ROS_ERROR("Timout createDijkstra.");
+  const size_t num_nodes = boolean_lattice.size() * num_sweeps;
+  tracing::Span span("product_graph_search");
+  span.Set("num_nodes", num_nodes).Set("upper_bound", upper_bound);
+  const size_t start_idx = boolean_lattice.getStartIdx() * num_sweeps +
+                           sweep_plan_graph.getStartIdx();
+  const size_t goal_idx = boolean_lattice.getGoalIdx() * num_sweeps +
+                          sweep_plan_graph.getGoalIdx();
+
+  // Cache clusters of sweep plan graph nodes.
+  std::vector<size_t> clusters(num_sweeps);
+  for (size_t i = 0; i < num_sweeps; ++i) {
+    const sweep_plan_graph::NodeProperty* node_property =
+        sweep_plan_graph.getNodeProperty(i);
+    if (node_property == nullptr) {
       return false;
     }
-    // Pop vertex with lowest score from open set.
-    size_t current = *std::min_element(
-        open_set.begin(), open_set.end(),
-        [&cost](size_t i, size_t j) { return cost[i] < cost[j]; });
-    if (current == goal_idx_) {  // Reached goal.
-      *solution = reconstructSolution(came_from, current);
-      return true;
+    clusters[i] = node_property->cluster;
+  }
+  std::vector<double> min_entry_costs;
+  if (!computeMinEntryCosts(sweep_plan_graph, &min_entry_costs)) {
+    return false;
+  }
+
+  auto heuristic = [&](size_t n, double* h) {
+    const size_t lattice_id = n / num_sweeps;
+    const size_t cluster = clusters[n % num_sweeps];
+    *h = 0.0;
+    for (size_t c = 0; c < min_entry_costs.size(); ++c) {
+      if (c != cluster &&
+          !boolean_lattice::BitmaskLattice::includesCluster(lattice_id, c)) {
+        *h += min_entry_costs[c];
+      }
     }
-    open_set.erase(current);
-    closed_set.insert(current);
-
-    // Create all neighbors.
-    for (size_t adj_id = 0; adj_id < graph_.size(); ++adj_id) {
-      const EdgeId forwards_edge_id(current, adj_id);
-      // E1 edges.
-      if (isE1(forwards_edge_id)) {
-        double temp_cost = -1.0;
-        EdgeProperty edge_property(EdgeProperty::Type::kE1);
-        if (!getSweepPlanGraphEdgeCost(forwards_edge_id, &temp_cost) ||
-            !addEdge(forwards_edge_id, edge_property, temp_cost)) {
-          return false;
-        }
-      } else if (isE2(forwards_edge_id)) {
-        double temp_cost = -1.0;
-        EdgeProperty edge_property(EdgeProperty::Type::kE2);
-        if (!getBooleanLatticeEdgeCost(forwards_edge_id, &temp_cost) ||
-            !addEdge(forwards_edge_id, edge_property, temp_cost)) {
+    return true;
+  };
+
+  Solution solution;
+  SearchWorkspace workspace;
+  const Deadline search_deadline = deadline.limit(kTimeOut);
+  DeadlinePoller poller(search_deadline);
+  const bool success = searchBestFirst(
+      num_nodes, start_idx, goal_idx,
+      [&](size_t current, auto relax) {
+        if (poller.isExpired()) {
+          if (!search_deadline.isCancelled()) {
+            ROS_ERROR("Timout solveImplicit.");
+          }
           return false;
         }
-      }
-    }
 
-    // Check all neighbors.
-    for (const std::pair<size_t, double>& n : graph_[current]) {
-      if (closed_set.count(n.first) > 0) {
-        continue;  // Ignore already evaluated neighbors.
-      }
-      open_set.insert(n.first);  // Add to open set if not already in.
+        // Only relax successors that may stay below the upper bound.
+        const double cost_to_current = workspace.cost[current];
+        auto bounded_relax = [&](size_t n, double cost) {
+          double h = 0.0;
+          if (std::isfinite(upper_bound) && heuristic(n, &h) &&
+              cost_to_current + cost + h > upper_bound) {
+            return;
+          }
+          relax(n, cost);
+        };
+
+        const size_t lattice_id = current / num_sweeps;
+        const size_t sweep_id = current % num_sweeps;
+        const size_t cluster = clusters[sweep_id];
+        if (boolean_lattice::BitmaskLattice::includesCluster(lattice_id,
+                                                             cluster)) {
+          // E1 edges: sweep plan graph out-edges into unvisited clusters.
+          sweep_plan_graph.forEachNeighbor(
+              sweep_id, [&](size_t to_sweep_id, double cost) {
+                if (!boolean_lattice::BitmaskLattice::includesCluster(
+                        lattice_id, clusters[to_sweep_id])) {
+                  bounded_relax(lattice_id * num_sweeps + to_sweep_id, cost);
+                }
+                return true;
+              });
+        } else {
+          // E2 edge: mark the cluster of the current sweep visited.
+          const size_t to_lattice_id =
+              lattice_id |
+              boolean_lattice::BitmaskLattice::clusterToBitmask(cluster);
+          bounded_relax(to_lattice_id * num_sweeps + sweep_id, 0.0);
+        }
+        return true;
+      },
+      heuristic, &solution, &workspace);
+  if (!success) {
+    return false;
+  }
 
-      // The distance from start to a neighbor.
-      const double tentative_cost = cost[current] + n.second;
-      if (tentative_cost >= cost[n.first]) {
-        continue;  // This is not a better path to n.
-      } else {
-        // This path is the best path to n until now.
-        came_from[n.first] = current;
-        cost[n.first] = tentative_cost;
+  // Translate product graph solution into sweep plan graph indices, i.e., E1
+  // edges.
+  for (size_t i = 0; i + 1 < solution.size(); ++i) {
+    if (solution[i] / num_sweeps == solution[i + 1] / num_sweeps) {
+      if (sweep_plan_solution->empty()) {
+        sweep_plan_solution->push_back(solution[i] % num_sweeps);
       }
+      sweep_plan_solution->push_back(solution[i + 1] % num_sweeps);
     }
   }
 
-  return false;
+  return true;
 }
 
 }  // namespace gtspp_product_graph
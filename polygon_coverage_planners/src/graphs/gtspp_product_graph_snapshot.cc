@@ -0,0 +1,187 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "polygon_coverage_planners/graphs/gtspp_product_graph.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#include <ros/assert.h>
+#include <ros/console.h>
+
+#include "polygon_coverage_planners/memory.h"
+#include "polygon_coverage_planners/tracing.h"
+
+namespace polygon_coverage_planning {
+namespace gtspp_product_graph {
+
+namespace {
+// File layout (native byte order):
+// magic | version | sweep plan graph snapshot key | number of sweeps |
+// number of clusters | number of sweep plan graph edges | offsets |
+// neighbors | costs
+// Every array is stored as its size followed by the raw elements.
+const char kSnapshotMagic[8] = {'P', 'C', 'P', 'P', 'R', 'O', 'D', '\0'};
+const uint64_t kSnapshotVersion = 1;
+
+void writeSize(uint64_t v, std::ostream* os) {
+  ROS_ASSERT(os);
+  os->write(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+template <typename T>
+void writeArray(const std::vector<T>& v, std::ostream* os) {
+  ROS_ASSERT(os);
+  writeSize(v.size(), os);
+  os->write(reinterpret_cast<const char*>(v.data()), v.size() * sizeof(T));
+}
+
+bool readSize(std::istream* is, uint64_t* v) {
+  ROS_ASSERT(is);
+  ROS_ASSERT(v);
+  return static_cast<bool>(is->read(reinterpret_cast<char*>(v), sizeof(*v)));
+}
+
+// Fails if the array exceeds the remaining file.
+template <typename T>
+bool readArray(std::istream* is, uint64_t file_size, std::vector<T>* v) {
+  ROS_ASSERT(is);
+  ROS_ASSERT(v);
+  uint64_t size = 0;
+  if (!readSize(is, &size)) {
+    return false;
+  }
+  const std::streamoff position = is->tellg();
+  if (position < 0 ||
+      size > (file_size - static_cast<uint64_t>(position)) / sizeof(T)) {
+    return false;
+  }
+  v->resize(static_cast<size_t>(size));
+  return static_cast<bool>(
+      is->read(reinterpret_cast<char*>(v->data()), size * sizeof(T)));
+}
+}  // namespace
+
+bool GtsppProductGraph::save(const std::string& file) const {
+  if (!is_created_ || offsets_.empty() || sweep_plan_graph_ == nullptr) {
+    ROS_ERROR("Cannot save product graph that is not precomputed.");
+    return false;
+  }
+  std::ofstream os(file, std::ios::binary | std::ios::trunc);
+  if (!os) {
+    ROS_ERROR_STREAM("Cannot open product graph file " << file);
+    return false;
+  }
+  os.write(kSnapshotMagic, sizeof(kSnapshotMagic));
+  writeSize(kSnapshotVersion, &os);
+  writeSize(sweep_plan_graph_->getSnapshotKey(), &os);
+  writeSize(sweep_plan_graph_->size(), &os);
+  writeSize(sweep_plan_graph_->getDecompositionSize(), &os);
+  writeSize(sweep_plan_graph_->getNumberOfEdges(), &os);
+  writeArray(offsets_, &os);
+  writeArray(neighbors_, &os);
+  writeArray(costs_, &os);
+
+  if (!os.good()) {
+    ROS_ERROR_STREAM("Failed writing product graph file " << file);
+    return false;
+  }
+  ROS_INFO_STREAM("Saved product graph " << file);
+  return true;
+}
+
+bool GtsppProductGraph::load(const std::string& file) {
+  is_created_ = false;
+  offsets_.clear();
+  neighbors_.clear();
+  costs_.clear();
+  if (sweep_plan_graph_ == nullptr) {
+    ROS_ERROR("Sweep plan graph not set.");
+    return false;
+  }
+  tracing::Span span("product_graph_load");
+
+  std::ifstream is(file, std::ios::binary | std::ios::ate);
+  if (!is) {
+    ROS_INFO_STREAM("No product graph file " << file);
+    return false;
+  }
+  const uint64_t file_size = static_cast<uint64_t>(is.tellg());
+  is.seekg(0);
+
+  char magic[sizeof(kSnapshotMagic)];
+  uint64_t version = 0;
+  if (!is.read(magic, sizeof(magic)) ||
+      std::memcmp(magic, kSnapshotMagic, sizeof(magic)) != 0 ||
+      !readSize(&is, &version) || version != kSnapshotVersion) {
+    ROS_WARN_STREAM("Product graph file " << file
+                                          << " has a different version.");
+    return false;
+  }
+  uint64_t key = 0, num_sweeps = 0, num_clusters = 0, num_sweep_edges = 0;
+  if (!readSize(&is, &key) || !readSize(&is, &num_sweeps) ||
+      !readSize(&is, &num_clusters) || !readSize(&is, &num_sweep_edges) ||
+      key != sweep_plan_graph_->getSnapshotKey() ||
+      num_sweeps != sweep_plan_graph_->size() ||
+      num_clusters != sweep_plan_graph_->getDecompositionSize() ||
+      num_sweep_edges != sweep_plan_graph_->getNumberOfEdges()) {
+    ROS_INFO_STREAM("Product graph file "
+                    << file << " was created for another sweep plan graph.");
+    return false;
+  }
+
+  // The same layout as create(): one lattice node per cluster mask and sweep.
+  MemoryEstimate estimate;
+  if (!estimateMemory(*sweep_plan_graph_, true, &estimate) ||
+      !readArray(&is, file_size, &offsets_) ||
+      !readArray(&is, file_size, &neighbors_) ||
+      !readArray(&is, file_size, &costs_) ||
+      static_cast<uint64_t>(is.tellg()) != file_size ||
+      offsets_.size() !=
+          (static_cast<size_t>(1) << num_clusters) * num_sweeps + 1 ||
+      offsets_.front() != 0 || offsets_.back() != neighbors_.size() ||
+      costs_.size() != neighbors_.size() ||
+      !std::is_sorted(offsets_.begin(), offsets_.end()) ||
+      std::any_of(neighbors_.begin(), neighbors_.end(),
+                  [this](uint32_t n) { return n >= size(); })) {
+    ROS_ERROR_STREAM("Corrupt product graph file " << file);
+    offsets_.clear();
+    neighbors_.clear();
+    costs_.clear();
+    return false;
+  }
+
+  ROS_INFO_STREAM("Loaded GTSPP product graph with "
+                  << size() << " nodes and " << getNumberOfEdges()
+                  << " edges from " << file);
+  span.Set("num_nodes", size()).Set("num_edges", getNumberOfEdges());
+  memory::Memory::Report("product_graph",
+                         offsets_.capacity() * sizeof(size_t) +
+                             neighbors_.capacity() * sizeof(uint32_t) +
+                             costs_.capacity() * sizeof(double),
+                         size());
+  memory::Memory::Report("boolean_lattice", 0,
+                         static_cast<size_t>(1) << num_clusters);
+  is_created_ = true;
+  return true;
+}
+
+}  // namespace gtspp_product_graph
+}  // namespace polygon_coverage_planning
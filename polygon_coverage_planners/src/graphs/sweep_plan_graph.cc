@@ -18,26 +18,84 @@
  */
 
 #include "polygon_coverage_planners/graphs/sweep_plan_graph.h"
+#include "polygon_coverage_planners/memory.h"
 #include "polygon_coverage_planners/timing.h"
+#include "polygon_coverage_planners/tracing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
 
 #include <ros/assert.h>
 
 #include <polygon_coverage_geometry/bcd.h>
 #include <polygon_coverage_geometry/cgal_comm.h>
+#include <polygon_coverage_geometry/counters.h>
 #include <polygon_coverage_geometry/decomposition.h>
 #include <polygon_coverage_geometry/offset.h>
 #include <polygon_coverage_geometry/sweep.h>
 #include <polygon_coverage_geometry/tcd.h>
 #include <polygon_coverage_geometry/visibility_polygon.h>
 
-#include <polygon_coverage_solvers/gk_ma.h>
+#include <polygon_coverage_solvers/gtsp_solver.h>
+#include <polygon_coverage_solvers/held_karp.h>
+#include <polygon_coverage_solvers/parallel.h>
 
+#include <CGAL/Bbox_2.h>
 #include <CGAL/Boolean_set_operations_2.h>
 #include <CGAL/create_offset_polygons_from_polygon_with_holes_2.h>
 
 namespace polygon_coverage_planning {
 namespace sweep_plan_graph {
 
+namespace {
+// Solve the shortest path between two sweep endpoints. Visibility polygons
+// that are not stored are looked up in the visibility polygon cache, unless
+// the path itself has been solved before.
+bool solveShortestPath(
+    const visibility_graph::VisibilityGraph& visibility_graph,
+    const Point_2& start, const Polygon_2* start_visibility_polygon,
+    const Point_2& goal, const Polygon_2* goal_visibility_polygon,
+    std::vector<Point_2>* path) {
+  ROS_ASSERT(path);
+  if (start_visibility_polygon != nullptr &&
+      goal_visibility_polygon != nullptr) {
+    return visibility_graph.solve(start, *start_visibility_polygon, goal,
+                                  *goal_visibility_polygon, path);
+  }
+  if (visibility_graph.findCachedPath(start, goal, path)) {
+    return true;
+  }
+  Polygon_2 start_visibility, goal_visibility;
+  if (start_visibility_polygon == nullptr) {
+    if (!visibility_graph.computeVisibility(start, &start_visibility)) {
+      return false;
+    }
+    start_visibility_polygon = &start_visibility;
+  }
+  if (goal_visibility_polygon == nullptr) {
+    if (!visibility_graph.computeVisibility(goal, &goal_visibility)) {
+      return false;
+    }
+    goal_visibility_polygon = &goal_visibility;
+  }
+  return visibility_graph.solve(start, *start_visibility_polygon, goal,
+                                *goal_visibility_polygon, path);
+}
+}  // namespace
+
+void NodeProperty::cacheEndpoints() {
+  if (waypoints.empty()) {
+    front_x = front_y = back_x = back_y = 0.0;
+    return;
+  }
+  front_x = CGAL::to_double(waypoints.front().x());
+  front_y = CGAL::to_double(waypoints.front().y());
+  back_x = CGAL::to_double(waypoints.back().x());
+  back_y = CGAL::to_double(waypoints.back().y());
+}
+
 bool NodeProperty::isNonOptimal(
     const visibility_graph::VisibilityGraph& visibility_graph,
     const std::vector<NodeProperty>& node_properties,
@@ -48,44 +106,104 @@ bool NodeProperty::isNonOptimal(
   }
 
   for (const NodeProperty& node_property : node_properties) {
-    if (node_property.waypoints.empty()) {
-      ROS_WARN_STREAM("Comparison node does not have waypoints.");
-      continue;
-    }
-    if (node_property.cluster == cluster) {
-      std::vector<Point_2> path_front_front, path_back_back;
-      if (!visibility_graph.solve(
-              waypoints.front(), visibility_polygons.front(),
-              node_property.waypoints.front(),
-              node_property.visibility_polygons.front(), &path_front_front) ||
-          !visibility_graph.solve(node_property.waypoints.back(),
-                                  node_property.visibility_polygons.back(),
-                                  waypoints.back(), visibility_polygons.back(),
-                                  &path_back_back)) {
-        continue;
-      }
-      if (cost_function(path_front_front) + node_property.cost +
-              cost_function(path_back_back) <
-          cost) {
-        return true;
-      }
+    if (isDominatedBy(visibility_graph, node_property, cost_function)) {
+      return true;
     }
   }
   return false;
 }
 
-void SweepPlanGraph::offsetPolygonFromWalls() {
-  if (settings_.wall_distance <= 0.0) return;
+bool NodeProperty::isDominatedBy(
+    const visibility_graph::VisibilityGraph& visibility_graph,
+    const NodeProperty& other, const PathCostFunction& cost_function) const {
+  if (waypoints.empty()) {
+    return false;
+  }
+  if (other.waypoints.empty()) {
+    ROS_WARN_STREAM("Comparison node does not have waypoints.");
+    return false;
+  }
+  if (other.cluster != cluster || other.cost >= cost) {
+    return false;
+  }
+
+  // Lower bound without visibility graph queries.
+  const PathCostKernel* kernel = getPathCostKernel(cost_function);
+  const double lower_bound =
+      kernel ? kernel->computeSegmentCost(other.front_x - front_x,
+                                          other.front_y - front_y) +
+                   other.cost +
+                   kernel->computeSegmentCost(back_x - other.back_x,
+                                              back_y - other.back_y)
+             : computeSegmentCost(cost_function, waypoints.front(),
+                                  other.waypoints.front()) +
+                   other.cost +
+                   computeSegmentCost(cost_function, other.waypoints.back(),
+                                      waypoints.back());
+  if (lower_bound >= cost) {
+    return false;
+  }
+
+  std::vector<Point_2> path_front_front, path_back_back;
+  if (!solveShortestPath(visibility_graph, waypoints.front(),
+                         getFrontVisibilityPolygon(), other.waypoints.front(),
+                         other.getFrontVisibilityPolygon(),
+                         &path_front_front) ||
+      !solveShortestPath(visibility_graph, other.waypoints.back(),
+                         other.getBackVisibilityPolygon(), waypoints.back(),
+                         getBackVisibilityPolygon(), &path_back_back)) {
+    return false;
+  }
+  return cost_function(path_front_front) + other.cost +
+             cost_function(path_back_back) <
+         cost;
+}
+
+void SweepPlanGraph::preprocessPolygon() {
+  bool changed = false;
+  if (settings_.simplification_tolerance > 0.0 && settings_.sensor_model) {
+    tracing::Span span("simplification");
+    const double tolerance = settings_.simplification_tolerance *
+                             settings_.sensor_model->getSweepDistance();
+    const size_t num_removed =
+        simplifyPolygonBoundary(&settings_.polygon, tolerance);
+    span.Set("num_removed", num_removed);
+    ROS_INFO_STREAM("Simplification removed " << num_removed << " vertices.");
+    changed = num_removed > 0;
+  }
+  if (settings_.wall_distance > 0.0) {
+    PolygonWithHoles temp_poly = settings_.polygon;
+    computeOffsetPolygon(temp_poly, settings_.wall_distance,
+                         &settings_.polygon);
+    changed = true;
+  }
+  // Last, such that the offset vertices are on the grid, too.
+  if (settings_.grid_resolution > 0.0) {
+    if (snapPolygonToGrid(&settings_.polygon, settings_.grid_resolution)) {
+      changed = true;
+    } else {
+      ROS_WARN_STREAM("Cannot snap polygon to grid of resolution "
+                      << settings_.grid_resolution << " m.");
+    }
+  }
+  if (!changed) return;
 
-  PolygonWithHoles temp_poly = settings_.polygon;
-  computeOffsetPolygon(temp_poly, settings_.wall_distance, &settings_.polygon);
   // Update visibility graph.
-  visibility_graph_ = visibility_graph::VisibilityGraph(settings_.polygon);
+  tracing::Span span("visibility_graph");
+  counters::Stage stage("visibility_graph");
+  span.Set("polygon_size", settings_.polygon.outer_boundary().size());
+  visibility_graph_ = visibility_graph::VisibilityGraph(
+      settings_.polygon, settings_.num_threads,
+      settings_.bitangent_visibility_graph);
 }
 
 bool SweepPlanGraph::create() {
+  tracing::Span span("sweep_plan_graph");
+  span.Set("polygon_size", settings_.polygon.outer_boundary().size())
+      .Set("num_holes", settings_.polygon.number_of_holes());
+  snapshot_key_ = computeSnapshotKey(settings_);
   clear();
-  offsetPolygonFromWalls();
+  preprocessPolygon();
   if (!computeDecomposition()) {
     ROS_ERROR("Failed to compute decomposition.");
     return false;
@@ -94,133 +212,406 @@ bool SweepPlanGraph::create() {
     ROS_ERROR("Failed to offset neighboring decomposition cells.");
     return false;
   }
+  memory::Memory::ReportPeakRss("peak_rss.decomposition");
+
+  // Compute the sweeps of each cluster. Clusters are independent until they
+  // are added to the graph.
+  cluster_sweeps_.assign(polygon_clusters_.size(),
+                         std::vector<std::vector<Point_2>>());
+  counters::Stage stage_sweeps("sweeps");
+  if (!parallelFor(polygon_clusters_.size(), settings_.num_threads,
+                   [this](size_t cluster) {
+                     return computeClusterSweeps(cluster,
+                                                 &cluster_sweeps_[cluster]);
+                   })) {
+    return false;
+  }
+  stage_sweeps.End();
+  memory::Memory::ReportPeakRss("peak_rss.sweeps");
 
-  // Create adjacency graph.
-  size_t num_sweep_plans = 0;
-  // Create sweep plans for each cluster.
+  return createGraph(nullptr);
+}
+
+namespace {
+// Grow the edited region such that rounding of the exact coordinates cannot
+// hide an intersection.
+const double kChangedRegionMargin = 1.0e-3;
+
+// Bounding box of the region in which two polygons differ. Returns false if
+// the polygons are identical.
+bool computeChangedRegion(const PolygonWithHoles& a, const PolygonWithHoles& b,
+                          CGAL::Bbox_2* region) {
+  ROS_ASSERT(region);
+  std::vector<PolygonWithHoles> difference;
+  CGAL::symmetric_difference(a, b, std::back_inserter(difference));
+  if (difference.empty()) {
+    return false;
+  }
+  *region = difference.front().outer_boundary().bbox();
+  for (const PolygonWithHoles& d : difference) {
+    *region += d.outer_boundary().bbox();
+  }
+  *region = CGAL::Bbox_2(
+      region->xmin() - kChangedRegionMargin,
+      region->ymin() - kChangedRegionMargin,
+      region->xmax() + kChangedRegionMargin,
+      region->ymax() + kChangedRegionMargin);
+  return true;
+}
+
+double computeDistance(const Point_2& p, const CGAL::Bbox_2& box) {
+  const double x = CGAL::to_double(p.x());
+  const double y = CGAL::to_double(p.y());
+  const double dx = std::max({box.xmin() - x, 0.0, x - box.xmax()});
+  const double dy = std::max({box.ymin() - y, 0.0, y - box.ymax()});
+  return std::sqrt(dx * dx + dy * dy);
+}
+
+// A shortest path stays the shortest path after an edit inside the region if
+// it does not touch the region and every detour through the region is longer.
+bool isUnaffected(const std::vector<Point_2>& path,
+                  const CGAL::Bbox_2& region) {
+  if (path.empty()) {
+    return false;
+  }
+  double length = 0.0;
+  for (size_t i = 0; i + 1 < path.size(); ++i) {
+    const Segment_2 segment(path[i], path[i + 1]);
+    if (CGAL::do_overlap(segment.bbox(), region)) {
+      return false;
+    }
+    length += std::sqrt(CGAL::to_double(segment.squared_length()));
+  }
+  return computeDistance(path.front(), region) +
+             computeDistance(path.back(), region) >
+         length;
+}
+}  // namespace
+
+bool SweepPlanGraph::update(const PolygonWithHoles& polygon) {
+  if (!is_created_) {
+    settings_.polygon = polygon;
+    visibility_graph_ = visibility_graph::VisibilityGraph(
+        settings_.polygon, settings_.num_threads,
+        settings_.bitangent_visibility_graph);
+    is_created_ = create();
+    return is_created_;
+  }
+
+  // Keep the previous cells, sweeps and shortest paths.
+  const PolygonWithHoles old_polygon = settings_.polygon;
+  const std::vector<Polygon_2> old_clusters = polygon_clusters_;
+  std::vector<std::vector<std::vector<Point_2>>> old_sweeps;
+  old_sweeps.swap(cluster_sweeps_);
+  std::map<std::pair<Point_2, Point_2>, EdgeProperty> old_edges;
+  for (const std::pair<const EdgeId, EdgeProperty>& edge : edge_properties_) {
+    const NodeProperty* from = getNodeProperty(edge.first.first);
+    const NodeProperty* to = getNodeProperty(edge.first.second);
+    if (from == nullptr || to == nullptr) {
+      return false;
+    }
+    old_edges.emplace(
+        std::make_pair(from->waypoints.back(), to->waypoints.front()),
+        edge.second);
+  }
+
+  // Decompose the new polygon.
+  settings_.polygon = polygon;
+  snapshot_key_ = computeSnapshotKey(settings_);
+  visibility_graph_ = visibility_graph::VisibilityGraph(
+      settings_.polygon, settings_.num_threads,
+      settings_.bitangent_visibility_graph);
+  clear();
+  preprocessPolygon();
+  if (!computeDecomposition()) {
+    ROS_ERROR("Failed to compute decomposition.");
+    return false;
+  }
+  if (!offsetDecomposition()) {
+    ROS_ERROR("Failed to offset neighboring decomposition cells.");
+    return false;
+  }
+  memory::Memory::ReportPeakRss("peak_rss.decomposition");
+
+  // Only recompute the sweeps of new cells.
+  cluster_sweeps_.assign(polygon_clusters_.size(),
+                         std::vector<std::vector<Point_2>>());
+  std::vector<size_t> new_clusters;
   for (size_t cluster = 0; cluster < polygon_clusters_.size(); ++cluster) {
-    // Compute all cluster sweeps.
-    std::vector<std::vector<Point_2>> cluster_sweeps;
-    timing::Timer timer_line_sweeps("line_sweeps");
-    if (settings_.sweep_single_direction) {
-      Direction_2 best_dir;
-      findBestSweepDir(polygon_clusters_[cluster], &best_dir);
-      visibility_graph::VisibilityGraph vis_graph(polygon_clusters_[cluster]);
-      cluster_sweeps.resize(1);
-      ROS_ASSERT(settings_.sensor_model);
-      if (!computeSweep(polygon_clusters_[cluster], vis_graph,
-                        settings_.sensor_model->getSweepDistance(), best_dir,
-                        true, &cluster_sweeps.front())) {
-        ROS_ERROR_STREAM(
-            "Cannot compute single sweep for cluster: " << cluster);
-        return false;
-      }
+    std::vector<Polygon_2>::const_iterator it = std::find(
+        old_clusters.begin(), old_clusters.end(), polygon_clusters_[cluster]);
+    if (it == old_clusters.end()) {
+      new_clusters.push_back(cluster);
     } else {
-      ROS_ASSERT(settings_.sensor_model);
-      if (!computeAllSweeps(polygon_clusters_[cluster],
-                            settings_.sensor_model->getSweepDistance(),
-                            &cluster_sweeps)) {
-        ROS_ERROR_STREAM("Cannot create all sweep plans for cluster "
-                         << cluster);
-        return false;
-      }
+      cluster_sweeps_[cluster] = old_sweeps[it - old_clusters.begin()];
+    }
+  }
+  ROS_INFO_STREAM("Recomputing sweeps of " << new_clusters.size() << " of "
+                                           << polygon_clusters_.size()
+                                           << " cells.");
+  counters::Stage stage_sweeps("sweeps");
+  if (!parallelFor(new_clusters.size(), settings_.num_threads,
+                   [this, &new_clusters](size_t i) {
+                     const size_t cluster = new_clusters[i];
+                     return computeClusterSweeps(cluster,
+                                                 &cluster_sweeps_[cluster]);
+                   })) {
+    return false;
+  }
+  stage_sweeps.End();
+  memory::Memory::ReportPeakRss("peak_rss.sweeps");
+
+  // Reuse the shortest paths that are not affected by the edit.
+  CGAL::Bbox_2 region;
+  const bool is_changed =
+      computeChangedRegion(old_polygon, settings_.polygon, &region);
+  return createGraph([&](const EdgeId& edge_id, EdgeProperty* edge_property) {
+    const NodeProperty* from = getNodeProperty(edge_id.first);
+    const NodeProperty* to = getNodeProperty(edge_id.second);
+    if (from == nullptr || to == nullptr) {
+      return false;
     }
-    num_sweep_plans += cluster_sweeps.size();
-    timer_line_sweeps.Stop();
+    std::map<std::pair<Point_2, Point_2>, EdgeProperty>::const_iterator it =
+        old_edges.find(
+            std::make_pair(from->waypoints.back(), to->waypoints.front()));
+    if (it == old_edges.end() ||
+        (is_changed && !isUnaffected(it->second.waypoints, region))) {
+      return false;
+    }
+    counters::Counters::Increment(counters::kWaypointCopies);
+    *edge_property = it->second;
+    return true;
+  });
+}
 
-    // Create node properties.
-    timing::Timer timer_node_creation("node_creation");
-    std::vector<NodeProperty> node_properties;
-    node_properties.resize(cluster_sweeps.size());
-    for (size_t i = 0; i < node_properties.size(); ++i) {
-      NodeProperty node;
-      if (!createNodeProperty(cluster, &cluster_sweeps[i], &node)) {
-        return false;
-      }
-      node_properties[i] = node;
-    }
-    timer_node_creation.Stop();
-
-    timing::Timer timer_pruning("pruning");
-    // Prune nodes that are definitely not optimal.
-    std::vector<NodeProperty>::iterator new_end = std::remove_if(
-        node_properties.begin(), node_properties.end(),
-        [node_properties, this](const NodeProperty& node_property) {
-          return node_property.isNonOptimal(visibility_graph_, node_properties,
-                                            settings_.cost_function);
-        });
-    node_properties.erase(new_end, node_properties.end());
-    timer_pruning.Stop();
-
-    // For each remaining sweep create a node.
-    timing::Timer timer_edge_creation("edge_creation");
-    for (const NodeProperty& node_property : node_properties) {
-      if (!addNode(node_property)) {
+bool SweepPlanGraph::createGraph(const EdgeReuseFunction& reuse_edge) {
+  // Create the pruned nodes of each cluster.
+  std::vector<std::vector<NodeProperty>> cluster_nodes(
+      polygon_clusters_.size());
+  counters::Stage stage_node_creation("node_creation");
+  if (!parallelFor(polygon_clusters_.size(), settings_.num_threads,
+                   [&](size_t cluster) {
+                     return createClusterNodes(cluster,
+                                               cluster_sweeps_[cluster],
+                                               &cluster_nodes[cluster]);
+                   })) {
+    return false;
+  }
+  stage_node_creation.End();
+
+  if (settings_.precompute_shortest_paths &&
+      !visibility_graph_.hasShortestPathTable()) {
+    tracing::Span span("shortest_path_table");
+    span.Set("num_nodes", visibility_graph_.size());
+    if (!visibility_graph_.createShortestPathTable()) {
+      return false;
+    }
+  }
+
+  // Add all nodes in cluster order, then create all edges in one batch.
+  size_t num_sweep_plans = 0;
+  static const size_t kEdgeCreationTimer =
+      timing::Timing::GetHandle("edge_creation");
+  timing::Timer timer_edge_creation(kEdgeCreationTimer);
+  tracing::Span span_edge_creation("edge_creation");
+  counters::Stage stage_edge_creation("edge_creation");
+  defer_edges_ = true;
+  for (size_t cluster = 0; cluster < polygon_clusters_.size(); ++cluster) {
+    num_sweep_plans += cluster_sweeps_[cluster].size();
+    for (NodeProperty& node_property : cluster_nodes[cluster]) {
+      if (!addNode(std::move(node_property))) {
+        defer_edges_ = false;
         return false;
       }
     }
-    timer_edge_creation.Stop();
   }
+  defer_edges_ = false;
+  if (!addAllEdges(reuse_edge)) {
+    return false;
+  }
+  if (!settings_.store_edge_waypoints) {
+    // The cached shortest paths would keep all edge waypoints alive.
+    visibility_graph_.clearCachedPaths();
+  }
+  timer_edge_creation.Stop();
+  span_edge_creation.Set("num_nodes", graph_.size())
+      .Set("num_edges", edge_properties_.size())
+      .End();
 
   ROS_INFO_STREAM("Created sweep plan graph with "
                   << graph_.size() << " nodes and " << edge_properties_.size()
                   << " edges.");
   ROS_INFO_STREAM("Initially created " << num_sweep_plans << " nodes.");
-  ROS_INFO_STREAM("Pruned " << num_sweep_plans - graph_.size() << " nodes.");
-  is_created_ = true;
+  num_pruned_nodes_ = num_sweep_plans - graph_.size();
+  ROS_INFO_STREAM("Pruned " << num_pruned_nodes_ << " nodes.");
+  // Freeze graph for fast queries.
+  is_created_ = compact();
+  if (is_created_) {
+    createQueryCache();
+    reportMemory();
+  }
+  return is_created_;
+}
+
+bool SweepPlanGraph::computeClusterSweeps(
+    size_t cluster, std::vector<std::vector<Point_2>>* sweeps) const {
+  ROS_ASSERT(sweeps);
+  sweeps->clear();
+
+  static const size_t kLineSweepsTimer =
+      timing::Timing::GetHandle("line_sweeps");
+  timing::Timer timer_line_sweeps(kLineSweepsTimer);
+  tracing::Span span("sweeps");
+  span.Set("cluster", cluster)
+      .Set("polygon_size", polygon_clusters_[cluster].size());
+  if (settings_.sweep_single_direction) {
+    Direction_2 best_dir;
+    findBestSweepDir(polygon_clusters_[cluster], &best_dir);
+    visibility_graph::VisibilityGraph vis_graph(polygon_clusters_[cluster]);
+    sweeps->resize(1);
+    ROS_ASSERT(settings_.sensor_model);
+    if (!computeSweep(polygon_clusters_[cluster], vis_graph,
+                      settings_.sensor_model->getSweepDistance(), best_dir,
+                      true, &sweeps->front())) {
+      ROS_ERROR_STREAM("Cannot compute single sweep for cluster: " << cluster);
+      return false;
+    }
+  } else {
+    ROS_ASSERT(settings_.sensor_model);
+    // Clusters run in parallel. Spread the remaining threads over the
+    // directions of each cluster.
+    const size_t num_direction_threads = std::max<size_t>(
+        getNumThreads(settings_.num_threads) / polygon_clusters_.size(), 1);
+    if (!computeAllSweeps(polygon_clusters_[cluster],
+                          settings_.sensor_model->getSweepDistance(), sweeps,
+                          num_direction_threads)) {
+      ROS_ERROR_STREAM("Cannot create all sweep plans for cluster "
+                       << cluster);
+      return false;
+    }
+  }
+  timer_line_sweeps.Stop();
+  span.Set("num_sweeps", sweeps->size());
+
   return true;
 }
 
-bool SweepPlanGraph::computeDecomposition() {
-  // Create decomposition.
-  timing::Timer timer_decom("decomposition");
-  switch (settings_.decomposition_type) {
-    case DecompositionType::kBCD: {
-      if (!computeBestBCDFromPolygonWithHoles(settings_.polygon,
-                                              &polygon_clusters_)) {
-        ROS_ERROR_STREAM("Cannot compute boustrophedon decomposition.");
-        return false;
-      } else {
-        ROS_INFO_STREAM("Successfully created boustrophedon decomposition with "
-                        << polygon_clusters_.size() << " polygon(s).");
-      }
-      break;
+bool SweepPlanGraph::createClusterNodes(
+    size_t cluster, const std::vector<std::vector<Point_2>>& sweeps,
+    std::vector<NodeProperty>* node_properties) const {
+  ROS_ASSERT(node_properties);
+  node_properties->clear();
+
+  // Create node properties.
+  static const size_t kNodeCreationTimer =
+      timing::Timing::GetHandle("node_creation");
+  timing::Timer timer_node_creation(kNodeCreationTimer);
+  tracing::Span span_node_creation("node_creation");
+  span_node_creation.Set("cluster", cluster).Set("num_sweeps", sweeps.size());
+  node_properties->resize(sweeps.size());
+  for (size_t i = 0; i < node_properties->size(); ++i) {
+    // The sweeps of the cluster are kept for updates.
+    counters::Counters::Increment(counters::kWaypointCopies);
+    std::vector<Point_2> sweep = sweeps[i];
+    if (!createNodeProperty(cluster, &sweep, &(*node_properties)[i])) {
+      return false;
     }
-    case DecompositionType::kTCD: {
-      if (!computeBestTCDFromPolygonWithHoles(settings_.polygon,
-                                              &polygon_clusters_)) {
-        ROS_ERROR_STREAM("Cannot compute trapezoidal decomposition.");
-        return false;
-      } else {
-        ROS_INFO_STREAM("Successfully created trapezoidal decomposition with "
-                        << polygon_clusters_.size() << " polygon(s).");
+  }
+  timer_node_creation.Stop();
+  span_node_creation.End();
+
+  static const size_t kPruningTimer = timing::Timing::GetHandle("pruning");
+  timing::Timer timer_pruning(kPruningTimer);
+  tracing::Span span_pruning("pruning");
+  span_pruning.Set("cluster", cluster);
+  // Prune nodes that are definitely not optimal. Only cheaper sweeps can
+  // dominate a sweep, so every sweep is compared to the sweeps before it in
+  // cost order. Pruned sweeps remain candidates to match a full comparison.
+  std::vector<size_t> cost_order(node_properties->size());
+  std::iota(cost_order.begin(), cost_order.end(), 0);
+  std::stable_sort(cost_order.begin(), cost_order.end(),
+                   [node_properties](size_t a, size_t b) {
+                     return (*node_properties)[a].cost <
+                            (*node_properties)[b].cost;
+                   });
+  std::vector<char> is_non_optimal(node_properties->size(), false);
+  for (size_t i = 1; i < cost_order.size(); ++i) {
+    const NodeProperty& node_property = (*node_properties)[cost_order[i]];
+    for (size_t j = 0; j < i; ++j) {
+      const NodeProperty& candidate = (*node_properties)[cost_order[j]];
+      if (candidate.cost >= node_property.cost) {
+        break;  // No cheaper candidates left.
+      }
+      if (node_property.isDominatedBy(visibility_graph_, candidate,
+                                      settings_.cost_function)) {
+        is_non_optimal[cost_order[i]] = true;
+        break;
       }
-      break;
     }
-    default: {
-      ROS_ERROR_STREAM("No valid decomposition type set.");
-      return false;
-      break;
+  }
+  size_t num_optimal = 0;
+  for (size_t i = 0; i < node_properties->size(); ++i) {
+    if (!is_non_optimal[i]) {
+      if (num_optimal != i) {
+        (*node_properties)[num_optimal] = std::move((*node_properties)[i]);
+      }
+      ++num_optimal;
     }
   }
+  node_properties->resize(num_optimal);
+  timer_pruning.Stop();
+  span_pruning.Set("num_nodes", num_optimal);
+
+  return true;
+}
+
+bool SweepPlanGraph::computeDecomposition() {
+  // Create decomposition.
+  static const size_t kDecompositionTimer =
+      timing::Timing::GetHandle("decomposition");
+  timing::Timer timer_decom(kDecompositionTimer);
+  tracing::Span span("decomposition");
+  counters::Stage stage("decomposition");
+  // Qualified, because the member hides the free function.
+  if (!polygon_coverage_planning::computeDecomposition(
+          settings_.polygon, settings_.decomposition_type, &polygon_clusters_,
+          settings_.num_threads)) {
+    ROS_ERROR_STREAM("Cannot compute "
+                     << getDecompositionTypeName(settings_.decomposition_type)
+                     << ".");
+    return false;
+  }
+  ROS_INFO_STREAM("Successfully created "
+                  << getDecompositionTypeName(settings_.decomposition_type)
+                  << " with " << polygon_clusters_.size() << " polygon(s).");
   timer_decom.Stop();
+  span.Set("num_cells", polygon_clusters_.size());
 
   return true;
 }
 
 bool SweepPlanGraph::offsetDecomposition() {
-  // Compute adjacency.
-  timing::Timer timer_poly_adj("polygon_adjacency");
-  std::map<size_t, std::set<size_t>> adj;
-  if (settings_.offset_polygons && !calculateDecompositionAdjacency(&adj)) {
+  // Compute adjacency. Also used to group cells in the hierarchical solver.
+  static const size_t kPolygonAdjacencyTimer =
+      timing::Timing::GetHandle("polygon_adjacency");
+  timing::Timer timer_poly_adj(kPolygonAdjacencyTimer);
+  tracing::Span span_poly_adj("polygon_adjacency");
+  decomposition_adjacency_.clear();
+  if (!calculateDecompositionAdjacency(&decomposition_adjacency_) &&
+      settings_.offset_polygons) {
     ROS_ERROR("Decomposition not fully connected.");
     return false;
   }
   timer_poly_adj.Stop();
+  span_poly_adj.End();
 
   // Offset adjacent cells.
-  timing::Timer timer_poly_offset("poly_offset");
-  if (settings_.offset_polygons && !offsetAdjacentCells(adj)) {
+  static const size_t kPolyOffsetTimer =
+      timing::Timing::GetHandle("poly_offset");
+  timing::Timer timer_poly_offset(kPolyOffsetTimer);
+  tracing::Span span_poly_offset("poly_offset");
+  if (settings_.offset_polygons &&
+      !offsetAdjacentCells(decomposition_adjacency_)) {
     ROS_ERROR("Failed to offset rectangular decomposition.");
     return false;
   }
@@ -231,6 +622,9 @@ bool SweepPlanGraph::offsetDecomposition() {
 bool SweepPlanGraph::calculateDecompositionAdjacency(
     std::map<size_t, std::set<size_t>>* decomposition_adjacency) {
   ROS_ASSERT(decomposition_adjacency);
+  if (polygon_clusters_.empty()) {
+    return false;
+  }
   (*decomposition_adjacency)[0] = std::set<size_t>();
 
   for (size_t i = 0; i < polygon_clusters_.size() - 1; ++i) {
@@ -342,14 +736,17 @@ bool SweepPlanGraph::offsetAdjacentCells(
   return true;
 }
 
-bool SweepPlanGraph::getClusters(
-    std::vector<std::vector<int>>* clusters) const {
+namespace {
+// Shared by the sweep plan graph and its start and goal overlay.
+template <class Graph>
+bool getGraphClusters(const Graph& graph,
+                      std::vector<std::vector<int>>* clusters) {
   ROS_ASSERT(clusters);
   clusters->clear();
 
   std::set<size_t> cluster_set;
-  for (size_t i = 0; i < graph_.size(); ++i) {
-    const NodeProperty* node = getNodeProperty(i);
+  for (size_t i = 0; i < graph.size(); ++i) {
+    const NodeProperty* node = graph.getNodeProperty(i);
     if (node == nullptr) {
       return false;  // Node property does not exist.
     }
@@ -366,8 +763,8 @@ bool SweepPlanGraph::getClusters(
 
   clusters->resize(cluster_set.size());
   for (size_t i = 0; i < clusters->size(); ++i) {
-    for (size_t j = 0; j < graph_.size(); ++j) {
-      const NodeProperty* node = getNodeProperty(j);
+    for (size_t j = 0; j < graph.size(); ++j) {
+      const NodeProperty* node = graph.getNodeProperty(j);
       if (node == nullptr) {
         return false;  // Node property does not exist.
       }
@@ -380,6 +777,197 @@ bool SweepPlanGraph::getClusters(
   return true;
 }
 
+template <class Graph>
+bool visitGraphWaypoints(const Graph& graph,
+                         const SweepPlanGraph& sweep_plan_graph,
+                         const Solution& solution,
+                         const WaypointSegmentVisitor& visit) {
+  ROS_ASSERT(visit);
+
+  for (size_t i = 0; i + 1 < solution.size(); ++i) {
+    const EdgeId edge_id(solution[i], solution[i + 1]);
+
+    // Visit sweep plan / start / goal waypoints. Stored waypoints are not
+    // copied.
+    const NodeProperty* node_property = graph.getNodeProperty(edge_id.first);
+    const NodeProperty* to_node_property =
+        graph.getNodeProperty(edge_id.second);
+    if (node_property == nullptr || to_node_property == nullptr) {
+      return false;
+    }
+    if (!node_property->waypoints.empty() &&
+        !visit(node_property->waypoints.begin(),
+               node_property->waypoints.end())) {
+      return false;
+    }
+
+    // Visit shortest path.
+    const EdgeProperty* edge_property = graph.getEdgeProperty(edge_id);
+    std::vector<Point_2> shortest_path;
+    if (edge_property == nullptr ||
+        !sweep_plan_graph.getEdgeWaypoints(*node_property, *to_node_property,
+                                           *edge_property, &shortest_path) ||
+        shortest_path.empty()) {
+      return false;
+    }
+    // Crop first and last waypoint as these are included in sweep plan. Keep
+    // the last waypoint of the final edge.
+    const auto begin = shortest_path.cbegin() + 1;
+    const bool is_last_edge = i + 2 == solution.size();
+    const auto end = is_last_edge ? shortest_path.cend()
+                                  : shortest_path.cend() - 1;
+    if (begin < end && !visit(begin, end)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <class Graph>
+bool getGraphWaypoints(const Graph& graph,
+                       const SweepPlanGraph& sweep_plan_graph,
+                       const Solution& solution,
+                       std::vector<Point_2>* waypoints) {
+  ROS_ASSERT(waypoints);
+  waypoints->clear();
+
+  return visitGraphWaypoints(
+      graph, sweep_plan_graph, solution,
+      [waypoints](std::vector<Point_2>::const_iterator begin,
+                  std::vector<Point_2>::const_iterator end) {
+        waypoints->insert(waypoints->end(), begin, end);
+        return true;
+      });
+}
+
+}  // namespace
+
+bool SweepPlanGraph::getWaypoints(const Solution& solution,
+                                  std::vector<Point_2>* waypoints) const {
+  return getGraphWaypoints(*this, *this, solution, waypoints);
+}
+
+bool SweepPlanGraph::getWaypoints(const Overlay& overlay,
+                                  const Solution& solution,
+                                  std::vector<Point_2>* waypoints) const {
+  return getGraphWaypoints(overlay, *this, solution, waypoints);
+}
+
+bool SweepPlanGraph::forEachWaypointSegment(
+    const Solution& solution, const WaypointSegmentVisitor& visit) const {
+  return visitGraphWaypoints(*this, *this, solution, visit);
+}
+
+bool SweepPlanGraph::forEachWaypointSegment(
+    const Overlay& overlay, const Solution& solution,
+    const WaypointSegmentVisitor& visit) const {
+  return visitGraphWaypoints(overlay, *this, solution, visit);
+}
+
+bool SweepPlanGraph::getEdgeWaypoints(const NodeProperty& from_node_property,
+                                      const NodeProperty& to_node_property,
+                                      const EdgeProperty& edge_property,
+                                      std::vector<Point_2>* waypoints) const {
+  ROS_ASSERT(waypoints);
+  if (!edge_property.waypoints.empty()) {
+    *waypoints = edge_property.waypoints;
+    return true;
+  }
+
+  // Only the cost is stored. Recompute the shortest path.
+  EdgeProperty computed_edge_property;
+  if (!computeEdge(from_node_property, to_node_property,
+                   &computed_edge_property, true)) {
+    return false;
+  }
+  *waypoints = std::move(computed_edge_property.waypoints);
+  return true;
+}
+
+bool SweepPlanGraph::getClusters(
+    std::vector<std::vector<int>>* clusters) const {
+  return getGraphClusters(*this, clusters);
+}
+
+bool SweepPlanGraph::getClusters(const Overlay& overlay,
+                                 std::vector<std::vector<int>>* clusters) {
+  return getGraphClusters(overlay, clusters);
+}
+
+void SweepPlanGraph::createQueryCache() {
+  if (!getDistanceMatrix(&base_distance_matrix_) ||
+      !getClusters(&base_clusters_)) {
+    ROS_WARN("Cannot cache the GTSP distance matrix.");
+    base_distance_matrix_ = DistanceMatrix<int>();
+    base_clusters_.clear();
+  }
+}
+
+void SweepPlanGraph::reportMemory() const {
+  size_t node_bytes = getNodeBytes();
+  size_t num_visibility_polygons = 0;
+  size_t visibility_polygon_bytes = 0;
+  for (size_t i = 0; i < size(); ++i) {
+    const NodeProperty* node_property = getNodeProperty(i);
+    if (!node_property) continue;
+    node_bytes += node_property->waypoints.capacity() * sizeof(Point_2);
+    num_visibility_polygons += node_property->visibility_polygons.size();
+    visibility_polygon_bytes +=
+        node_property->visibility_polygons.capacity() * sizeof(Polygon_2);
+    for (const Polygon_2& visibility_polygon :
+         node_property->visibility_polygons) {
+      visibility_polygon_bytes += visibility_polygon.size() * sizeof(Point_2);
+    }
+  }
+  size_t edge_bytes = getEdgeBytes();
+  for (const std::pair<const EdgeId, EdgeProperty>& edge_property :
+       edge_properties_) {
+    edge_bytes += edge_property.second.waypoints.capacity() * sizeof(Point_2);
+  }
+  size_t query_cache_bytes = base_distance_matrix_.size() *
+                             base_distance_matrix_.size() * sizeof(int);
+  for (const std::vector<int>& cluster : base_clusters_) {
+    query_cache_bytes += cluster.capacity() * sizeof(int);
+  }
+
+  memory::Memory::Report("sweep_plan_graph.nodes", node_bytes, size());
+  memory::Memory::Report("sweep_plan_graph.visibility_polygons",
+                         visibility_polygon_bytes, num_visibility_polygons);
+  memory::Memory::Report("sweep_plan_graph.edges", edge_bytes,
+                         getNumberOfEdges());
+  memory::Memory::Report("sweep_plan_graph.query_cache", query_cache_bytes,
+                         base_distance_matrix_.size());
+  memory::Memory::Report("visibility_graph",
+                         visibility_graph_.getMemoryBytes(),
+                         visibility_graph_.size());
+  memory::Memory::ReportPeakRss("peak_rss.sweep_plan_graph");
+}
+
+bool SweepPlanGraph::getOverlayDistanceMatrix(const Overlay& overlay,
+                                              DistanceMatrix<int>* m) const {
+  ROS_ASSERT(m);
+  if (overlay.getBase() != this || base_distance_matrix_.empty() ||
+      base_distance_matrix_.size() != size()) {
+    return overlay.getDistanceMatrix(m);
+  }
+  return overlay.getDistanceMatrix(base_distance_matrix_, m);
+}
+
+bool SweepPlanGraph::getOverlayClusters(
+    const Overlay& overlay, std::vector<std::vector<int>>* clusters) const {
+  ROS_ASSERT(clusters);
+  if (overlay.getBase() != this || base_clusters_.empty() ||
+      base_clusters_.size() != polygon_clusters_.size() ||
+      overlay.size() != size() + 2) {
+    return getClusters(overlay, clusters);
+  }
+  // Start and goal are the only overlay nodes and form the last clusters.
+  *clusters = base_clusters_;
+  clusters->push_back({static_cast<int>(overlay.getStartIdx())});
+  clusters->push_back({static_cast<int>(overlay.getGoalIdx())});
+  return true;
+}
+
 bool SweepPlanGraph::createNodeProperty(size_t cluster,
                                         std::vector<Point_2>* waypoints,
                                         NodeProperty* node) const {
@@ -387,14 +975,17 @@ bool SweepPlanGraph::createNodeProperty(size_t cluster,
   ROS_ASSERT(node);
 
   std::vector<Polygon_2> visibility_polygons;
-  if (!computeStartAndGoalVisibility(settings_.polygon, waypoints,
-                                     &visibility_polygons)) {
+  if (!computeStartAndGoalVisibility(waypoints, &visibility_polygons)) {
     ROS_ERROR("Cannot compute start and goal visibility graph.");
     return false;
   }
 
-  *node = NodeProperty(*waypoints, settings_.cost_function, cluster,
-                       visibility_polygons);
+  // The computed visibility polygons remain in the visibility polygon cache.
+  if (!settings_.store_visibility_polygons) {
+    visibility_polygons.clear();
+  }
+  *node = NodeProperty(std::move(*waypoints), settings_.cost_function, cluster,
+                       std::move(visibility_polygons));
 
   return true;
 }
@@ -404,68 +995,306 @@ bool SweepPlanGraph::addEdges() {
     ROS_ERROR("Cannot add edges to an empty graph.");
     return false;
   }
+  if (defer_edges_) {
+    return true;  // Edges are created by addAllEdges.
+  }
 
   const size_t new_id = graph_.size() - 1;
+  const NodeProperty* new_node_property = getNodeProperty(new_id);
+  if (new_node_property == nullptr) {
+    return false;
+  }
+  std::vector<size_t> forwards_ids, backwards_ids;
   for (size_t adj_id = 0; adj_id < new_id; ++adj_id) {
-    EdgeId forwards_edge_id(new_id, adj_id);
-    EdgeProperty edge_property;
-    if (isConnected(forwards_edge_id) &&
-        computeEdge(forwards_edge_id, &edge_property)) {
-      double cost = -1.0;
-      if (!computeCost(forwards_edge_id, edge_property, &cost) ||
-          !addEdge(forwards_edge_id, edge_property, cost)) {
-        return false;
+    if (isConnected(EdgeId(new_id, adj_id))) forwards_ids.push_back(adj_id);
+    if (isConnected(EdgeId(adj_id, new_id))) backwards_ids.push_back(adj_id);
+  }
+
+  // One shortest path search per direction instead of one per edge.
+  std::vector<EdgeProperty> forwards_edges, backwards_edges;
+  std::vector<char> is_forwards_computed, is_backwards_computed;
+  computeEdges(*new_node_property, forwards_ids, true, &forwards_edges,
+               &is_forwards_computed);
+  computeEdges(*new_node_property, backwards_ids, false, &backwards_edges,
+               &is_backwards_computed);
+
+  size_t f = 0, b = 0;
+  for (size_t adj_id = 0; adj_id < new_id; ++adj_id) {
+    if (f < forwards_ids.size() && forwards_ids[f] == adj_id) {
+      const EdgeId forwards_edge_id(new_id, adj_id);
+      if (is_forwards_computed[f]) {
+        double cost = -1.0;
+        if (!computeCost(forwards_edge_id, forwards_edges[f], &cost) ||
+            !addEdge(forwards_edge_id, std::move(forwards_edges[f]), cost)) {
+          return false;
+        }
       }
+      ++f;
     }
-    EdgeId backwards_edge_id(adj_id, new_id);
-    if (isConnected(backwards_edge_id) &&
-        computeEdge(backwards_edge_id, &edge_property)) {
-      double cost = -1.0;
-      if (!computeCost(backwards_edge_id, edge_property, &cost) ||
-          !addEdge(backwards_edge_id, edge_property, cost)) {
-        return false;
+    if (b < backwards_ids.size() && backwards_ids[b] == adj_id) {
+      const EdgeId backwards_edge_id(adj_id, new_id);
+      if (is_backwards_computed[b]) {
+        double cost = -1.0;
+        if (!computeCost(backwards_edge_id, backwards_edges[b], &cost) ||
+            !addEdge(backwards_edge_id, std::move(backwards_edges[b]),
+                     cost)) {
+          return false;
+        }
       }
+      ++b;
     }
   }
 
   return true;
 }
 
-bool SweepPlanGraph::computeEdge(const EdgeId& edge_id,
-                                 EdgeProperty* edge_property) const {
-  ROS_ASSERT(edge_property);
+bool SweepPlanGraph::addAllEdges(const EdgeReuseFunction& reuse_edge) {
+  // Collect all connected node pairs.
+  std::vector<EdgeId> edge_ids;
+  for (size_t from = 0; from < graph_.size(); ++from) {
+    for (size_t to = 0; to < graph_.size(); ++to) {
+      const EdgeId edge_id(from, to);
+      if (from != to && isConnected(edge_id)) {
+        edge_ids.push_back(edge_id);
+      }
+    }
+  }
 
-  // Access node properties:
-  const NodeProperty* from_node_property = getNodeProperty(edge_id.first);
-  const NodeProperty* to_node_property = getNodeProperty(edge_id.second);
-  if (from_node_property == nullptr || to_node_property == nullptr) {
-    return false;
+  // Reuse the previous edges, then compute the remaining shortest paths from
+  // the distinct sweep endpoints. Pairs without a path are skipped like in
+  // addEdges.
+  std::vector<EdgeProperty> edge_properties(edge_ids.size());
+  std::vector<char> is_reused(edge_ids.size(), false);
+  if (reuse_edge) {
+    parallelFor(edge_ids.size(), settings_.num_threads, [&](size_t i) {
+      is_reused[i] = reuse_edge(edge_ids[i], &edge_properties[i]);
+      return true;
+    });
+  }
+  std::vector<char> is_computed = is_reused;
+  computeEndpointEdges(edge_ids, &edge_properties, &is_computed);
+  if (reuse_edge) {
+    ROS_INFO_STREAM("Reused "
+                    << std::count(is_reused.begin(), is_reused.end(), true)
+                    << " of " << edge_ids.size() << " edges.");
   }
 
+  for (size_t i = 0; i < edge_ids.size(); ++i) {
+    if (!is_computed[i]) {
+      continue;
+    }
+    double cost = -1.0;
+    if (!computeCost(edge_ids[i], edge_properties[i], &cost) ||
+        !addEdge(edge_ids[i], std::move(edge_properties[i]), cost)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void SweepPlanGraph::computeEndpointEdges(
+    const std::vector<EdgeId>& edge_ids,
+    std::vector<EdgeProperty>* edge_properties,
+    std::vector<char>* is_computed) const {
+  ROS_ASSERT(edge_properties);
+  ROS_ASSERT(is_computed);
+  ROS_ASSERT(edge_properties->size() == edge_ids.size());
+  ROS_ASSERT(is_computed->size() == edge_ids.size());
+
+  // Deduplicate the sweep ends (rows) and sweep starts (columns) of the
+  // missing edges. Many sweeps share an endpoint.
+  std::vector<Point_2> ends, starts;
+  std::vector<const Polygon_2*> end_visibility_polygons,
+      start_visibility_polygons;
+  std::map<Point_2, size_t> end_ids, start_ids;
+  const size_t kNoEntry = std::numeric_limits<size_t>::max();
+  std::vector<std::pair<size_t, size_t>> edge_entries(
+      edge_ids.size(), std::make_pair(kNoEntry, kNoEntry));
+  for (size_t i = 0; i < edge_ids.size(); ++i) {
+    if ((*is_computed)[i]) {
+      continue;
+    }
+    const NodeProperty* from_node_property = getNodeProperty(edge_ids[i].first);
+    const NodeProperty* to_node_property = getNodeProperty(edge_ids[i].second);
+    if (from_node_property == nullptr || to_node_property == nullptr) {
+      continue;
+    }
+    if (from_node_property->waypoints.empty() ||
+        to_node_property->waypoints.empty()) {
+      ROS_ERROR("Waypoints in node property are empty.");
+      continue;
+    }
+    const Point_2& end = from_node_property->waypoints.back();
+    auto end_it = end_ids.emplace(end, ends.size());
+    if (end_it.second) {
+      ends.push_back(end);
+      end_visibility_polygons.push_back(
+          from_node_property->getBackVisibilityPolygon());
+    }
+    const Point_2& start = to_node_property->waypoints.front();
+    auto start_it = start_ids.emplace(start, starts.size());
+    if (start_it.second) {
+      starts.push_back(start);
+      start_visibility_polygons.push_back(
+          to_node_property->getFrontVisibilityPolygon());
+    }
+    edge_entries[i] = std::make_pair(end_it.first->second,
+                                     start_it.first->second);
+  }
+  if (ends.empty()) {
+    return;
+  }
+
+  // One one-to-many query per row fills the dense endpoint matrix.
+  std::vector<std::vector<EdgeProperty>> matrix(ends.size());
+  std::vector<std::vector<char>> is_solved(ends.size());
+  parallelFor(ends.size(), settings_.num_threads, [&](size_t row) {
+    matrix[row].resize(starts.size());
+    is_solved[row].assign(starts.size(), false);
+    std::vector<std::vector<Point_2>> shortest_paths;
+    if (!visibility_graph_.solveOneToMany(ends[row],
+                                          end_visibility_polygons[row], starts,
+                                          start_visibility_polygons,
+                                          &shortest_paths)) {
+      return true;
+    }
+    for (size_t col = 0; col < starts.size(); ++col) {
+      if (shortest_paths[col].empty()) {
+        continue;
+      }
+      matrix[row][col] =
+          EdgeProperty(std::move(shortest_paths[col]), settings_.cost_function);
+      if (!settings_.store_edge_waypoints) {
+        std::vector<Point_2>().swap(matrix[row][col].waypoints);
+      }
+      is_solved[row][col] = true;
+    }
+    return true;
+  });
+
+  // Fill the edges by table lookup.
+  for (size_t i = 0; i < edge_ids.size(); ++i) {
+    const size_t row = edge_entries[i].first;
+    const size_t col = edge_entries[i].second;
+    if (row == kNoEntry) {
+      continue;
+    }
+    if (!is_solved[row][col]) {
+      ROS_ERROR_STREAM("Cannot compute shortest path from "
+                       << ends[row] << " to " << starts[col]);
+      continue;
+    }
+    (*edge_properties)[i] = matrix[row][col];
+    (*is_computed)[i] = true;
+  }
+}
+
+bool SweepPlanGraph::computeEdge(const NodeProperty& from_node_property,
+                                 const NodeProperty& to_node_property,
+                                 EdgeProperty* edge_property,
+                                 bool store_waypoints) const {
+  ROS_ASSERT(edge_property);
+
   // Calculate shortest path.
-  if (from_node_property->waypoints.empty() ||
-      to_node_property->waypoints.empty()) {
+  if (from_node_property.waypoints.empty() ||
+      to_node_property.waypoints.empty()) {
     ROS_ERROR("Waypoints in node property are empty.");
     return false;
   }
 
   std::vector<Point_2> shortest_path;
-  if (!visibility_graph_.solve(from_node_property->waypoints.back(),
-                               from_node_property->visibility_polygons.back(),
-                               to_node_property->waypoints.front(),
-                               to_node_property->visibility_polygons.front(),
-                               &shortest_path)) {
+  if (!solveShortestPath(visibility_graph_, from_node_property.waypoints.back(),
+                         from_node_property.getBackVisibilityPolygon(),
+                         to_node_property.waypoints.front(),
+                         to_node_property.getFrontVisibilityPolygon(),
+                         &shortest_path)) {
     ROS_ERROR_STREAM("Cannot compute shortest path from "
-                     << from_node_property->waypoints.back() << " to "
-                     << to_node_property->waypoints.front());
+                     << from_node_property.waypoints.back() << " to "
+                     << to_node_property.waypoints.front());
     return false;
   }
 
-  *edge_property = EdgeProperty(shortest_path, settings_.cost_function);
+  *edge_property =
+      EdgeProperty(std::move(shortest_path), settings_.cost_function);
+  if (!store_waypoints) {
+    std::vector<Point_2>().swap(edge_property->waypoints);
+  }
 
   return true;
 }
 
+void SweepPlanGraph::computeEdges(const NodeProperty& node_property,
+                                  const std::vector<size_t>& adj_ids,
+                                  bool forwards,
+                                  std::vector<EdgeProperty>* edge_properties,
+                                  std::vector<char>* is_computed) const {
+  ROS_ASSERT(edge_properties);
+  ROS_ASSERT(is_computed);
+  edge_properties->assign(adj_ids.size(), EdgeProperty());
+  is_computed->assign(adj_ids.size(), false);
+  if (adj_ids.empty()) {
+    return;
+  }
+  if (node_property.waypoints.empty()) {
+    ROS_ERROR("Waypoints in node property are empty.");
+    return;
+  }
+
+  // Shortest paths are symmetric. Backwards edges are solved from the node's
+  // start to the adjacent sweep ends and reversed.
+  const Point_2& start = forwards ? node_property.waypoints.back()
+                                  : node_property.waypoints.front();
+  const Polygon_2* start_visibility_polygon =
+      forwards ? node_property.getBackVisibilityPolygon()
+               : node_property.getFrontVisibilityPolygon();
+  std::vector<size_t> goal_ids;
+  std::vector<Point_2> goals;
+  std::vector<const Polygon_2*> goal_visibility_polygons;
+  for (size_t i = 0; i < adj_ids.size(); ++i) {
+    const NodeProperty* adj_node_property = getNodeProperty(adj_ids[i]);
+    if (adj_node_property == nullptr) {
+      continue;
+    }
+    if (adj_node_property->waypoints.empty()) {
+      ROS_ERROR("Waypoints in node property are empty.");
+      continue;
+    }
+    goal_ids.push_back(i);
+    goals.push_back(forwards ? adj_node_property->waypoints.front()
+                             : adj_node_property->waypoints.back());
+    goal_visibility_polygons.push_back(
+        forwards ? adj_node_property->getFrontVisibilityPolygon()
+                 : adj_node_property->getBackVisibilityPolygon());
+  }
+
+  std::vector<std::vector<Point_2>> shortest_paths;
+  if (!visibility_graph_.solveOneToMany(start, start_visibility_polygon, goals,
+                                        goal_visibility_polygons,
+                                        &shortest_paths)) {
+    return;
+  }
+  for (size_t j = 0; j < goal_ids.size(); ++j) {
+    std::vector<Point_2>& shortest_path = shortest_paths[j];
+    if (shortest_path.empty()) {
+      ROS_ERROR_STREAM("Cannot compute shortest path from "
+                       << (forwards ? start : goals[j]) << " to "
+                       << (forwards ? goals[j] : start));
+      continue;
+    }
+    if (!forwards) {
+      std::reverse(shortest_path.begin(), shortest_path.end());
+    }
+    EdgeProperty* edge_property = &(*edge_properties)[goal_ids[j]];
+    *edge_property =
+        EdgeProperty(std::move(shortest_path), settings_.cost_function);
+    if (!settings_.store_edge_waypoints) {
+      std::vector<Point_2>().swap(edge_property->waypoints);
+    }
+    (*is_computed)[goal_ids[j]] = true;
+  }
+}
+
 bool SweepPlanGraph::computeCost(const EdgeId& edge_id,
                                  const EdgeProperty& edge_property,
                                  double* cost) const {
@@ -496,7 +1325,8 @@ bool SweepPlanGraph::isConnected(const EdgeId& edge_id) const {
 }
 
 bool SweepPlanGraph::solve(const Point_2& start, const Point_2& goal,
-                           std::vector<Point_2>* waypoints) const {
+                           std::vector<Point_2>* waypoints,
+                           const Deadline& deadline) const {
   ROS_ASSERT(waypoints);
   waypoints->clear();
 
@@ -505,41 +1335,63 @@ bool SweepPlanGraph::solve(const Point_2& start, const Point_2& goal,
     return false;
   }
 
-  // Create temporary copies to add start and goal.
-  SweepPlanGraph temp_gtsp_graph = *this;
-
-  NodeProperty start_node, goal_node;
-  if (!createNodeProperty(polygon_clusters_.size(), start, &start_node) ||
-      !createNodeProperty(polygon_clusters_.size() + 1, goal, &goal_node)) {
+  // Add start and goal on top of this graph.
+  Overlay overlay;
+  if (!createOverlay(start, goal, &overlay)) {
     return false;
   }
+  const size_t goal_idx = overlay.getGoalIdx();
+  const size_t start_idx = overlay.getStartIdx();
 
-  if (!temp_gtsp_graph.addStartNode(start_node) ||
-      !temp_gtsp_graph.addGoalNode(goal_node)) {
-    ROS_ERROR("Cannot add start and goal.");
+  // Solve GTSP.
+  DistanceMatrix<int> m;
+  if (!getOverlayDistanceMatrix(overlay, &m)) {
+    ROS_ERROR("Cannot get distance matrix.");
     return false;
   }
-  const size_t goal_idx = temp_gtsp_graph.size() - 1;
-  const size_t start_idx = temp_gtsp_graph.size() - 2;
-
-  // Solve using GK MA.
-  std::vector<std::vector<int>> m = temp_gtsp_graph.getAdjacencyMatrix();
   std::vector<std::vector<int>> clusters;
-  if (!temp_gtsp_graph.getClusters(&clusters)) {
+  if (!getOverlayClusters(overlay, &clusters)) {
     ROS_ERROR("Cannot get clusters.");
     return false;
   }
-  gk_ma::Task task(m, clusters);
-  gk_ma::GkMa& solver = gk_ma::GkMa::getInstance();
-  solver.setSolver(task);
+  gtsp::Task task(std::move(m), clusters);
+  gtsp::SolverSettings solver_settings = settings_.gtsp_solver_settings;
+  if (deadline.hasTimeLimit() || deadline.isCancelled()) {
+    // A non-positive budget means none. Leave the solver a minimal budget to
+    // return its first tour.
+    const double kMinTimeBudget = 1.0e-3;
+    double time_budget =
+        std::max(deadline.getRemainingSeconds(), kMinTimeBudget);
+    if (solver_settings.time_budget > 0.0) {
+      time_budget = std::min(time_budget, solver_settings.time_budget);
+    }
+    solver_settings.time_budget = time_budget;
+  }
+  std::unique_ptr<gtsp::SolverBase> solver =
+      gtsp::createSolver(settings_.gtsp_solver_type, solver_settings);
+  if (solver == nullptr) {
+    ROS_ERROR("Cannot create GTSP solver.");
+    return false;
+  }
 
-  ROS_INFO("Start solving GTSP");
-  if (!solver.solve()) {
-    ROS_ERROR("GkMa solution failed.");
+  ROS_INFO_STREAM("Start solving GTSP using "
+                  << gtsp::getSolverTypeName(settings_.gtsp_solver_type)
+                  << " with " << settings_.gtsp_solver_settings.num_starts
+                  << " start(s)");
+  std::vector<int> solution_int;
+  static const size_t kGtspSolveTimer =
+      timing::Timing::GetHandle("gtsp_solve");
+  timing::Timer timer_gtsp(kGtspSolveTimer);
+  tracing::Span span_gtsp("gtsp_solve");
+  span_gtsp.Set("num_nodes", overlay.size())
+      .Set("num_clusters", clusters.size());
+  if (!solver->solve(task, &solution_int)) {
+    ROS_ERROR("GTSP solution failed.");
     return false;
   }
+  timer_gtsp.Stop();
+  span_gtsp.End();
   ROS_INFO("Finished solving GTSP");
-  std::vector<int> solution_int = solver.getSolution();
   Solution solution(solution_int.size());
   std::copy(solution_int.begin(), solution_int.end(), solution.begin());
 
@@ -556,7 +1408,7 @@ bool SweepPlanGraph::solve(const Point_2& start, const Point_2& goal,
     return false;
   }
 
-  if (!temp_gtsp_graph.getWaypoints(solution, waypoints)) {
+  if (!getWaypoints(overlay, solution, waypoints)) {
     ROS_ERROR("Cannot recover waypoints.");
     return false;
   }
@@ -564,41 +1416,326 @@ bool SweepPlanGraph::solve(const Point_2& start, const Point_2& goal,
   return true;
 }
 
-bool SweepPlanGraph::getWaypoints(const Solution& solution,
-                                  std::vector<Point_2>* waypoints) const {
+bool SweepPlanGraph::solveHeldKarp(const Point_2& start, const Point_2& goal,
+                                   std::vector<Point_2>* waypoints,
+                                   const Deadline& deadline) const {
   ROS_ASSERT(waypoints);
   waypoints->clear();
 
-  for (size_t i = 0; i < solution.size() - 1; ++i) {
-    const EdgeId edge_id(solution[i], solution[i + 1]);
+  if (!is_created_) {
+    ROS_ERROR("Graph not created.");
+    return false;
+  }
 
-    // Add sweep plan / start / goal waypoints.
-    const NodeProperty* node_property = getNodeProperty(edge_id.first);
-    if (node_property == nullptr) {
-      return false;
+  Overlay overlay;
+  if (!createOverlay(start, goal, &overlay)) {
+    return false;
+  }
+
+  // Dense cost matrix and the decomposition clusters without start and goal.
+  DistanceMatrix<double> m(overlay.size());
+  for (size_t i = 0; i < overlay.size(); ++i) {
+    overlay.forEachNeighbor(i, [&m, i](size_t j, double cost) {
+      m(i, j) = cost;
+      return true;
+    });
+  }
+  std::vector<std::vector<int>> clusters;
+  if (!getOverlayClusters(overlay, &clusters)) {
+    ROS_ERROR("Cannot get clusters.");
+    return false;
+  }
+  clusters.resize(polygon_clusters_.size());
+
+  ROS_INFO_STREAM("Start solving GTSPP with Held-Karp over "
+                  << clusters.size() << " clusters.");
+  held_karp::HeldKarp solver;
+  Solution solution;
+  tracing::Span span_held_karp("held_karp");
+  span_held_karp.Set("num_nodes", overlay.size())
+      .Set("num_clusters", clusters.size());
+  if (!solver.solve(m, clusters, overlay.getStartIdx(), overlay.getGoalIdx(),
+                    &solution, deadline)) {
+    ROS_ERROR("Held-Karp solution failed.");
+    return false;
+  }
+  span_held_karp.End();
+  ROS_INFO("Finished solving GTSPP");
+
+  if (!getWaypoints(overlay, solution, waypoints)) {
+    ROS_ERROR("Cannot recover waypoints.");
+    return false;
+  }
+
+  return true;
+}
+
+bool SweepPlanGraph::solveHierarchical(const Point_2& start,
+                                       const Point_2& goal,
+                                       std::vector<Point_2>* waypoints,
+                                       const Deadline& deadline) const {
+  ROS_ASSERT(waypoints);
+  waypoints->clear();
+
+  if (!is_created_) {
+    ROS_ERROR("Graph not created.");
+    return false;
+  }
+
+  Overlay overlay;
+  if (!createOverlay(start, goal, &overlay)) {
+    return false;
+  }
+  std::vector<std::vector<size_t>> groups;
+  if (!computeCellGroups(settings_.max_group_size, &groups)) {
+    return false;
+  }
+
+  // Dense cost matrix and the sweeps of every group.
+  DistanceMatrix<double> m(overlay.size());
+  for (size_t i = 0; i < overlay.size(); ++i) {
+    overlay.forEachNeighbor(i, [&m, i](size_t j, double cost) {
+      m(i, j) = cost;
+      return true;
+    });
+  }
+  std::vector<std::vector<int>> clusters;
+  if (!getOverlayClusters(overlay, &clusters)) {
+    ROS_ERROR("Cannot get clusters.");
+    return false;
+  }
+  std::vector<std::vector<size_t>> group_sweeps(groups.size());
+  for (size_t g = 0; g < groups.size(); ++g) {
+    for (size_t cell : groups[g]) {
+      group_sweeps[g].insert(group_sweeps[g].end(), clusters[cell].begin(),
+                             clusters[cell].end());
+    }
+  }
+  const size_t start_idx = overlay.getStartIdx();
+  const size_t goal_idx = overlay.getGoalIdx();
+  auto min_cost = [&m](const std::vector<size_t>& from,
+                       const std::vector<size_t>& to) {
+    double cost = DistanceMatrix<double>::kNoConnection;
+    for (size_t u : from) {
+      for (size_t v : to) {
+        cost = std::min(cost, m(u, v));
+      }
+    }
+    return cost;
+  };
+
+  // Order the groups. Node 0 is the start, node 1 the goal and node 2 + g
+  // group g.
+  ROS_INFO_STREAM("Start solving GTSPP hierarchically over "
+                  << groups.size() << " groups of at most "
+                  << settings_.max_group_size << " clusters.");
+  DistanceMatrix<double> m_groups(groups.size() + 2);
+  std::vector<std::vector<int>> group_clusters(groups.size());
+  for (size_t a = 0; a < groups.size(); ++a) {
+    group_clusters[a] = {static_cast<int>(a + 2)};
+    m_groups(0, a + 2) = min_cost({start_idx}, group_sweeps[a]);
+    m_groups(a + 2, 1) = min_cost(group_sweeps[a], {goal_idx});
+    for (size_t b = 0; b < groups.size(); ++b) {
+      if (a != b) {
+        m_groups(a + 2, b + 2) = min_cost(group_sweeps[a], group_sweeps[b]);
+      }
+    }
+  }
+  held_karp::HeldKarp solver;
+  Solution group_order;
+  if (!solver.solve(m_groups, group_clusters, 0, 1, &group_order, deadline)) {
+    ROS_ERROR("Cannot order cluster groups.");
+    return false;
+  }
+
+  // Solve the groups in order. Node 0 is the last sweep of the previous group,
+  // node 1 leaves towards the next group and node 2 + i is the i-th sweep of
+  // the group.
+  Solution solution({start_idx});
+  for (size_t k = 1; k + 1 < group_order.size(); ++k) {
+    const size_t g = group_order[k] - 2;
+    const std::vector<size_t>& sweeps = group_sweeps[g];
+    const std::vector<size_t> next_sweeps =
+        k + 2 < group_order.size() ? group_sweeps[group_order[k + 1] - 2]
+                                   : std::vector<size_t>({goal_idx});
+    DistanceMatrix<double> m_group(sweeps.size() + 2);
+    for (size_t i = 0; i < sweeps.size(); ++i) {
+      m_group(0, i + 2) = m(solution.back(), sweeps[i]);
+      m_group(i + 2, 1) = min_cost({sweeps[i]}, next_sweeps);
+      for (size_t j = 0; j < sweeps.size(); ++j) {
+        m_group(i + 2, j + 2) = m(sweeps[i], sweeps[j]);
+      }
+    }
+    std::vector<std::vector<int>> cell_clusters;
+    int local_id = 2;
+    for (size_t cell : groups[g]) {
+      cell_clusters.emplace_back(clusters[cell].size());
+      std::iota(cell_clusters.back().begin(), cell_clusters.back().end(),
+                local_id);
+      local_id += static_cast<int>(clusters[cell].size());
     }
-    waypoints->insert(waypoints->end(), node_property->waypoints.begin(),
-                      node_property->waypoints.end());
 
-    // Add shortest path.
-    const EdgeProperty* edge_property = getEdgeProperty(edge_id);
-    if (edge_property == nullptr) {
+    Solution group_solution;
+    if (!solver.solve(m_group, cell_clusters, 0, 1, &group_solution,
+                      deadline)) {
+      ROS_ERROR_STREAM("Cannot solve cluster group " << g << ".");
       return false;
     }
-    // Crop first and last waypoint as these are included in sweep plan.
-    waypoints->insert(waypoints->end(), edge_property->waypoints.begin() + 1,
-                      edge_property->waypoints.end() - 1);
-    // Add last waypoint.
-    if (i == solution.size() - 2) {
-      waypoints->insert(waypoints->end(), edge_property->waypoints.end() - 1,
-                        edge_property->waypoints.end());
+    for (size_t i = 1; i + 1 < group_solution.size(); ++i) {
+      solution.push_back(sweeps[group_solution[i] - 2]);
     }
   }
+  solution.push_back(goal_idx);
+  ROS_INFO("Finished solving GTSPP");
+
+  if (!getWaypoints(overlay, solution, waypoints)) {
+    ROS_ERROR("Cannot recover waypoints.");
+    return false;
+  }
+
+  return true;
+}
+
+bool SweepPlanGraph::computeCellGroups(
+    size_t max_group_size, std::vector<std::vector<size_t>>* groups) const {
+  ROS_ASSERT(groups);
+  groups->clear();
+  if (max_group_size == 0) {
+    ROS_ERROR("Maximum group size has to be positive.");
+    return false;
+  }
+
+  // Grow every group breadth-first from the lowest unassigned cell.
+  std::vector<bool> is_assigned(polygon_clusters_.size(), false);
+  for (size_t seed = 0; seed < polygon_clusters_.size(); ++seed) {
+    if (is_assigned[seed]) {
+      continue;
+    }
+    std::vector<size_t> group({seed});
+    is_assigned[seed] = true;
+    for (size_t i = 0; i < group.size() && group.size() < max_group_size;
+         ++i) {
+      const auto adjacent = decomposition_adjacency_.find(group[i]);
+      if (adjacent == decomposition_adjacency_.end()) {
+        continue;
+      }
+      for (size_t cell : adjacent->second) {
+        if (group.size() < max_group_size && !is_assigned[cell]) {
+          is_assigned[cell] = true;
+          group.push_back(cell);
+        }
+      }
+    }
+    groups->push_back(group);
+  }
+  return true;
+}
+
+bool SweepPlanGraph::createOverlay(const Point_2& start, const Point_2& goal,
+                                   Overlay* overlay) const {
+  ROS_ASSERT(overlay);
+  overlay->reset(this);
+  tracing::Span span("overlay");
+  span.Set("num_nodes", graph_.size());
+
+  NodeProperty start_node, goal_node;
+  if (!createNodeProperty(polygon_clusters_.size(), start, &start_node) ||
+      !createNodeProperty(polygon_clusters_.size() + 1, goal, &goal_node)) {
+    ROS_ERROR("Cannot add start and goal.");
+    return false;
+  }
+  const size_t start_idx = overlay->addStartNode(std::move(start_node));
+  const size_t goal_idx = overlay->addGoalNode(std::move(goal_node));
+
+  // The start connects to all sweeps and all sweeps connect to the goal. There
+  // is no direct connection between start and goal.
+  std::vector<EdgeId> edge_ids;
+  edge_ids.reserve(2 * graph_.size());
+  for (size_t id = 0; id < graph_.size(); ++id) {
+    edge_ids.emplace_back(start_idx, id);
+    edge_ids.emplace_back(id, goal_idx);
+  }
+  return addOverlayEdges(edge_ids, overlay);
+}
+
+bool SweepPlanGraph::createGoalOverlay(const Point_2& goal,
+                                       Overlay* overlay) const {
+  ROS_ASSERT(overlay);
+  overlay->reset(this);
+  tracing::Span span("goal_overlay");
+  span.Set("num_nodes", graph_.size());
+
+  NodeProperty goal_node;
+  if (!createNodeProperty(polygon_clusters_.size() + 1, goal, &goal_node)) {
+    ROS_ERROR("Cannot add goal.");
+    return false;
+  }
+  const size_t goal_idx = overlay->addGoalNode(std::move(goal_node));
+
+  std::vector<EdgeId> edge_ids;
+  edge_ids.reserve(graph_.size());
+  for (size_t id = 0; id < graph_.size(); ++id) {
+    edge_ids.emplace_back(id, goal_idx);
+  }
+  return addOverlayEdges(edge_ids, overlay);
+}
+
+bool SweepPlanGraph::addOverlayStart(const Point_2& start,
+                                     Overlay* overlay) const {
+  ROS_ASSERT(overlay);
+  if (overlay->getBase() != this) {
+    ROS_ERROR("Overlay is not on top of this graph.");
+    return false;
+  }
+  tracing::Span span("start_overlay");
+  span.Set("num_nodes", graph_.size());
+
+  NodeProperty start_node;
+  if (!createNodeProperty(polygon_clusters_.size(), start, &start_node)) {
+    ROS_ERROR("Cannot add start.");
+    return false;
+  }
+  const size_t start_idx = overlay->addStartNode(std::move(start_node));
+
+  std::vector<EdgeId> edge_ids;
+  edge_ids.reserve(graph_.size());
+  for (size_t id = 0; id < graph_.size(); ++id) {
+    edge_ids.emplace_back(start_idx, id);
+  }
+  return addOverlayEdges(edge_ids, overlay);
+}
+
+bool SweepPlanGraph::addOverlayEdges(const std::vector<EdgeId>& edge_ids,
+                                     Overlay* overlay) const {
+  ROS_ASSERT(overlay);
+  std::vector<EdgeProperty> edge_properties(edge_ids.size());
+  std::vector<char> is_computed(edge_ids.size(), false);
+  parallelFor(edge_ids.size(), settings_.num_threads, [&](size_t i) {
+    const NodeProperty* from = overlay->getNodeProperty(edge_ids[i].first);
+    const NodeProperty* to = overlay->getNodeProperty(edge_ids[i].second);
+    // Overlays are small and always keep their paths.
+    is_computed[i] = from != nullptr && to != nullptr &&
+                     computeEdge(*from, *to, &edge_properties[i], true);
+    return true;
+  });
+
+  for (size_t i = 0; i < edge_ids.size(); ++i) {
+    if (!is_computed[i]) {
+      continue;
+    }
+    // cost = from_sweep_cost + cost(from_end, to_start)
+    const double cost = overlay->getNodeProperty(edge_ids[i].first)->cost +
+                        edge_properties[i].cost;
+    if (!overlay->addEdge(edge_ids[i], std::move(edge_properties[i]), cost)) {
+      return false;
+    }
+  }
+
   return true;
 }
 
 bool SweepPlanGraph::computeStartAndGoalVisibility(
-    const PolygonWithHoles& polygon, std::vector<Point_2>* sweep,
+    std::vector<Point_2>* sweep,
     std::vector<Polygon_2>* visibility_polygons) const {
   ROS_ASSERT(sweep);
   ROS_ASSERT(visibility_polygons);
@@ -606,8 +1743,7 @@ bool SweepPlanGraph::computeStartAndGoalVisibility(
 
   if (sweep->front() == sweep->back()) {
     visibility_polygons->resize(1);
-    if (!computeVisibility(polygon, &sweep->front(),
-                           &visibility_polygons->front())) {
+    if (!computeVisibility(&sweep->front(), &visibility_polygons->front())) {
       return false;
     } else {
       sweep->back() = sweep->front();
@@ -615,23 +1751,22 @@ bool SweepPlanGraph::computeStartAndGoalVisibility(
     }
   } else {
     visibility_polygons->resize(2);
-    return computeVisibility(polygon, &sweep->front(),
+    return computeVisibility(&sweep->front(),
                              &visibility_polygons->front()) &&
-           computeVisibility(polygon, &sweep->back(),
-                             &visibility_polygons->back());
+           computeVisibility(&sweep->back(), &visibility_polygons->back());
   }
 }
 
-bool SweepPlanGraph::computeVisibility(const PolygonWithHoles& polygon,
-                                       Point_2* vertex,
+bool SweepPlanGraph::computeVisibility(Point_2* vertex,
                                        Polygon_2* visibility_polygon) const {
   ROS_ASSERT(vertex);
   ROS_ASSERT(visibility_polygon);
 
-  *vertex = pointInPolygon(polygon, *vertex)
+  *vertex = visibility_graph_.containsPoint(*vertex)
                 ? *vertex
-                : projectPointOnHull(polygon, *vertex);
-  return computeVisibilityPolygon(polygon, *vertex, visibility_polygon);
+                : visibility_graph_.projectOnHull(*vertex);
+  // Sweep endpoints and start and goal recur, e.g., in reversed sweeps.
+  return visibility_graph_.computeVisibility(*vertex, visibility_polygon);
 }
 
 }  // namespace sweep_plan_graph
@@ -0,0 +1,474 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "polygon_coverage_planners/graphs/sweep_plan_graph.h"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include <ros/assert.h>
+#include <ros/console.h>
+
+namespace polygon_coverage_planning {
+namespace sweep_plan_graph {
+
+namespace {
+// File layout (native byte order):
+// magic | version | settings key | offset polygon | decomposition |
+// cluster sweeps | nodes | edges
+// Exact coordinates are stored as rational number strings.
+const char kSnapshotMagic[8] = {'P', 'C', 'P', 'S', 'N', 'A', 'P', '\0'};
+const uint64_t kSnapshotVersion = 2;
+
+// 64 bit FNV-1a hash.
+class Hash {
+ public:
+  void add(const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+      hash_ = (hash_ ^ bytes[i]) * 1099511628211ull;
+    }
+  }
+  void add(const std::string& s) { add(s.data(), s.size()); }
+  void add(uint64_t v) { add(&v, sizeof(v)); }
+  void add(double v) { add(&v, sizeof(v)); }
+  void add(const FT& v) {
+    std::ostringstream os;
+    os << CGAL::exact(v) << ';';
+    add(os.str());
+  }
+  void add(const Polygon_2& polygon) {
+    add(static_cast<uint64_t>(polygon.size()));
+    for (const Point_2& p : polygon) {
+      add(p.x());
+      add(p.y());
+    }
+  }
+  uint64_t get() const { return hash_; }
+
+ private:
+  uint64_t hash_ = 14695981039346656037ull;
+};
+
+class SnapshotWriter {
+ public:
+  explicit SnapshotWriter(std::ostream* os) : os_(os) { ROS_ASSERT(os_); }
+
+  void writeSize(uint64_t v) {
+    os_->write(reinterpret_cast<const char*>(&v), sizeof(v));
+  }
+  void writeDouble(double v) {
+    os_->write(reinterpret_cast<const char*>(&v), sizeof(v));
+  }
+  void writeFT(const FT& v) {
+    std::ostringstream os;
+    os << CGAL::exact(v);
+    const std::string s = os.str();
+    writeSize(s.size());
+    os_->write(s.data(), s.size());
+  }
+  void writePoints(const std::vector<Point_2>& points) {
+    writeSize(points.size());
+    for (const Point_2& p : points) {
+      writeFT(p.x());
+      writeFT(p.y());
+    }
+  }
+  void writePolygon(const Polygon_2& polygon) {
+    writePoints(std::vector<Point_2>(polygon.vertices_begin(),
+                                     polygon.vertices_end()));
+  }
+  void writePolygonWithHoles(const PolygonWithHoles& polygon) {
+    writePolygon(polygon.outer_boundary());
+    writeSize(polygon.number_of_holes());
+    for (PolygonWithHoles::Hole_const_iterator h = polygon.holes_begin();
+         h != polygon.holes_end(); ++h) {
+      writePolygon(*h);
+    }
+  }
+
+  bool good() const { return os_->good(); }
+
+ private:
+  std::ostream* os_;
+};
+
+// Reads a snapshot written by SnapshotWriter. Every read fails once the
+// stream fails or a size exceeds the remaining file.
+class SnapshotReader {
+ public:
+  SnapshotReader(std::istream* is, uint64_t file_size)
+      : is_(is), remaining_(file_size) {
+    ROS_ASSERT(is_);
+  }
+
+  bool readBytes(char* data, uint64_t size) {
+    if (size > remaining_ || !is_->read(data, size)) {
+      return false;
+    }
+    remaining_ -= size;
+    return true;
+  }
+  bool readSize(uint64_t* v) {
+    ROS_ASSERT(v);
+    return readBytes(reinterpret_cast<char*>(v), sizeof(*v));
+  }
+  // Sizes of containers. Every element takes at least one byte.
+  bool readCount(size_t* v) {
+    ROS_ASSERT(v);
+    uint64_t count = 0;
+    if (!readSize(&count) || count > remaining_) {
+      return false;
+    }
+    *v = static_cast<size_t>(count);
+    return true;
+  }
+  bool readDouble(double* v) {
+    ROS_ASSERT(v);
+    return readBytes(reinterpret_cast<char*>(v), sizeof(*v));
+  }
+  bool readFT(FT* v) {
+    ROS_ASSERT(v);
+    size_t size = 0;
+    if (!readCount(&size)) {
+      return false;
+    }
+    std::string s(size, '\0');
+    if (!readBytes(&s[0], size)) {
+      return false;
+    }
+    std::istringstream is(s);
+    return static_cast<bool>(is >> *v);
+  }
+  bool readPoints(std::vector<Point_2>* points) {
+    ROS_ASSERT(points);
+    size_t size = 0;
+    if (!readCount(&size)) {
+      return false;
+    }
+    points->clear();
+    points->reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+      FT x, y;
+      if (!readFT(&x) || !readFT(&y)) {
+        return false;
+      }
+      points->emplace_back(x, y);
+    }
+    return true;
+  }
+  bool readPolygon(Polygon_2* polygon) {
+    ROS_ASSERT(polygon);
+    std::vector<Point_2> points;
+    if (!readPoints(&points)) {
+      return false;
+    }
+    *polygon = Polygon_2(points.begin(), points.end());
+    return true;
+  }
+  bool readPolygonWithHoles(PolygonWithHoles* polygon) {
+    ROS_ASSERT(polygon);
+    Polygon_2 outer;
+    size_t num_holes = 0;
+    if (!readPolygon(&outer) || !readCount(&num_holes)) {
+      return false;
+    }
+    *polygon = PolygonWithHoles(outer);
+    for (size_t i = 0; i < num_holes; ++i) {
+      Polygon_2 hole;
+      if (!readPolygon(&hole)) {
+        return false;
+      }
+      polygon->add_hole(hole);
+    }
+    return true;
+  }
+
+  bool atEnd() const { return remaining_ == 0; }
+
+ private:
+  std::istream* is_;
+  uint64_t remaining_;
+};
+}  // namespace
+
+uint64_t SweepPlanGraph::computeSnapshotKey(const Settings& settings) {
+  Hash hash;
+  hash.add(kSnapshotVersion);
+  hash.add(settings.polygon.outer_boundary());
+  hash.add(static_cast<uint64_t>(settings.polygon.number_of_holes()));
+  for (PolygonWithHoles::Hole_const_iterator h =
+           settings.polygon.holes_begin();
+       h != settings.polygon.holes_end(); ++h) {
+    hash.add(*h);
+  }
+  if (settings.cost_function) {
+    const Polygon_2& outer = settings.polygon.outer_boundary();
+    hash.add(settings.cost_function(
+        std::vector<Point_2>(outer.vertices_begin(), outer.vertices_end())));
+  }
+  if (settings.sensor_model) {
+    hash.add(settings.sensor_model->getSweepDistance());
+  }
+  hash.add(static_cast<uint64_t>(settings.decomposition_type));
+  hash.add(settings.wall_distance);
+  hash.add(settings.simplification_tolerance);
+  hash.add(settings.grid_resolution);
+  hash.add(static_cast<uint64_t>(settings.offset_polygons));
+  hash.add(static_cast<uint64_t>(settings.sweep_single_direction));
+  hash.add(static_cast<uint64_t>(settings.store_edge_waypoints));
+  hash.add(static_cast<uint64_t>(settings.store_visibility_polygons));
+  return hash.get();
+}
+
+bool SweepPlanGraph::save(const std::string& file) const {
+  if (!is_created_) {
+    ROS_ERROR("Cannot save sweep plan graph that is not created.");
+    return false;
+  }
+  std::ofstream os(file, std::ios::binary | std::ios::trunc);
+  if (!os) {
+    ROS_ERROR_STREAM("Cannot open snapshot file " << file);
+    return false;
+  }
+  SnapshotWriter writer(&os);
+  os.write(kSnapshotMagic, sizeof(kSnapshotMagic));
+  writer.writeSize(kSnapshotVersion);
+  writer.writeSize(snapshot_key_);
+
+  writer.writePolygonWithHoles(settings_.polygon);
+  writer.writeSize(polygon_clusters_.size());
+  for (const Polygon_2& cluster : polygon_clusters_) {
+    writer.writePolygon(cluster);
+  }
+  for (size_t i = 0; i < polygon_clusters_.size(); ++i) {
+    const auto adjacent = decomposition_adjacency_.find(i);
+    if (adjacent == decomposition_adjacency_.end()) {
+      writer.writeSize(0);
+      continue;
+    }
+    writer.writeSize(adjacent->second.size());
+    for (size_t j : adjacent->second) {
+      writer.writeSize(j);
+    }
+  }
+  writer.writeSize(cluster_sweeps_.size());
+  for (const std::vector<std::vector<Point_2>>& sweeps : cluster_sweeps_) {
+    writer.writeSize(sweeps.size());
+    for (const std::vector<Point_2>& sweep : sweeps) {
+      writer.writePoints(sweep);
+    }
+  }
+
+  writer.writeSize(size());
+  for (size_t i = 0; i < size(); ++i) {
+    const NodeProperty* node_property = getNodeProperty(i);
+    if (node_property == nullptr) {
+      return false;
+    }
+    writer.writeSize(node_property->cluster);
+    writer.writeDouble(node_property->cost);
+    writer.writePoints(node_property->waypoints);
+    writer.writeSize(node_property->visibility_polygons.size());
+    for (const Polygon_2& visibility_polygon :
+         node_property->visibility_polygons) {
+      writer.writePolygon(visibility_polygon);
+    }
+  }
+
+  writer.writeSize(edge_properties_.size());
+  for (const std::pair<const EdgeId, EdgeProperty>& edge : edge_properties_) {
+    double cost = -1.0;
+    if (!getEdgeCost(edge.first, &cost)) {
+      return false;
+    }
+    writer.writeSize(edge.first.first);
+    writer.writeSize(edge.first.second);
+    writer.writeDouble(cost);
+    writer.writeDouble(edge.second.cost);
+    writer.writePoints(edge.second.waypoints);
+  }
+
+  if (!writer.good()) {
+    ROS_ERROR_STREAM("Failed writing snapshot file " << file);
+    return false;
+  }
+  ROS_INFO_STREAM("Saved sweep plan graph snapshot " << file);
+  return true;
+}
+
+bool SweepPlanGraph::load(const Settings& settings, const std::string& file) {
+  clear();
+  settings_ = settings;
+  num_pruned_nodes_ = 0;
+  snapshot_key_ = computeSnapshotKey(settings_);
+
+  std::ifstream is(file, std::ios::binary | std::ios::ate);
+  if (!is) {
+    ROS_INFO_STREAM("No snapshot file " << file);
+    return false;
+  }
+  const uint64_t file_size = static_cast<uint64_t>(is.tellg());
+  is.seekg(0);
+  SnapshotReader reader(&is, file_size);
+
+  char magic[sizeof(kSnapshotMagic)];
+  uint64_t version = 0, key = 0;
+  if (!reader.readBytes(magic, sizeof(magic)) ||
+      std::memcmp(magic, kSnapshotMagic, sizeof(magic)) != 0 ||
+      !reader.readSize(&version) || version != kSnapshotVersion) {
+    ROS_WARN_STREAM("Snapshot file " << file << " has a different version.");
+    return false;
+  }
+  if (!reader.readSize(&key) || key != snapshot_key_) {
+    ROS_INFO_STREAM("Snapshot file " << file
+                                     << " was created for other settings.");
+    return false;
+  }
+
+  // Geometry.
+  size_t num_clusters = 0;
+  if (!reader.readPolygonWithHoles(&settings_.polygon) ||
+      !reader.readCount(&num_clusters)) {
+    ROS_ERROR_STREAM("Corrupt snapshot file " << file);
+    return false;
+  }
+  polygon_clusters_.resize(num_clusters);
+  for (Polygon_2& cluster : polygon_clusters_) {
+    if (!reader.readPolygon(&cluster)) {
+      ROS_ERROR_STREAM("Corrupt snapshot file " << file);
+      return false;
+    }
+  }
+  decomposition_adjacency_.clear();
+  for (size_t i = 0; i < num_clusters; ++i) {
+    size_t num_adjacent = 0;
+    if (!reader.readCount(&num_adjacent)) {
+      ROS_ERROR_STREAM("Corrupt snapshot file " << file);
+      return false;
+    }
+    if (i == 0 || num_adjacent > 0) {
+      decomposition_adjacency_[i];
+    }
+    for (size_t k = 0; k < num_adjacent; ++k) {
+      uint64_t j = 0;
+      if (!reader.readSize(&j) || j >= num_clusters) {
+        ROS_ERROR_STREAM("Corrupt snapshot file " << file);
+        return false;
+      }
+      decomposition_adjacency_[i].insert(static_cast<size_t>(j));
+    }
+  }
+  size_t num_cluster_sweeps = 0;
+  if (!reader.readCount(&num_cluster_sweeps)) {
+    ROS_ERROR_STREAM("Corrupt snapshot file " << file);
+    return false;
+  }
+  cluster_sweeps_.resize(num_cluster_sweeps);
+  for (std::vector<std::vector<Point_2>>& sweeps : cluster_sweeps_) {
+    size_t num_sweeps = 0;
+    if (!reader.readCount(&num_sweeps)) {
+      ROS_ERROR_STREAM("Corrupt snapshot file " << file);
+      return false;
+    }
+    sweeps.resize(num_sweeps);
+    for (std::vector<Point_2>& sweep : sweeps) {
+      if (!reader.readPoints(&sweep)) {
+        ROS_ERROR_STREAM("Corrupt snapshot file " << file);
+        return false;
+      }
+    }
+  }
+
+  // Nodes.
+  size_t num_nodes = 0;
+  if (!reader.readCount(&num_nodes)) {
+    ROS_ERROR_STREAM("Corrupt snapshot file " << file);
+    return false;
+  }
+  defer_edges_ = true;
+  for (size_t i = 0; i < num_nodes; ++i) {
+    NodeProperty node_property;
+    uint64_t cluster = 0;
+    size_t num_visibility_polygons = 0;
+    if (!reader.readSize(&cluster) || !reader.readDouble(&node_property.cost) ||
+        !reader.readPoints(&node_property.waypoints) ||
+        !reader.readCount(&num_visibility_polygons)) {
+      ROS_ERROR_STREAM("Corrupt snapshot file " << file);
+      defer_edges_ = false;
+      return false;
+    }
+    node_property.cluster = static_cast<size_t>(cluster);
+    node_property.cacheEndpoints();
+    node_property.visibility_polygons.resize(num_visibility_polygons);
+    for (Polygon_2& visibility_polygon : node_property.visibility_polygons) {
+      if (!reader.readPolygon(&visibility_polygon)) {
+        ROS_ERROR_STREAM("Corrupt snapshot file " << file);
+        defer_edges_ = false;
+        return false;
+      }
+    }
+    if (!addNode(std::move(node_property))) {
+      defer_edges_ = false;
+      return false;
+    }
+  }
+  defer_edges_ = false;
+
+  // Edges.
+  size_t num_edges = 0;
+  if (!reader.readCount(&num_edges)) {
+    ROS_ERROR_STREAM("Corrupt snapshot file " << file);
+    return false;
+  }
+  for (size_t i = 0; i < num_edges; ++i) {
+    uint64_t from = 0, to = 0;
+    double cost = -1.0;
+    EdgeProperty edge_property;
+    if (!reader.readSize(&from) || !reader.readSize(&to) ||
+        !reader.readDouble(&cost) || !reader.readDouble(&edge_property.cost) ||
+        !reader.readPoints(&edge_property.waypoints) ||
+        !addEdge(EdgeId(from, to), std::move(edge_property), cost)) {
+      ROS_ERROR_STREAM("Corrupt snapshot file " << file);
+      return false;
+    }
+  }
+  if (!reader.atEnd()) {
+    ROS_ERROR_STREAM("Corrupt snapshot file " << file);
+    return false;
+  }
+
+  // The visibility graph is cheap compared to the sweeps and edges.
+  visibility_graph_ = visibility_graph::VisibilityGraph(
+      settings_.polygon, settings_.num_threads,
+      settings_.bitangent_visibility_graph);
+  ROS_INFO_STREAM("Loaded sweep plan graph with "
+                  << graph_.size() << " nodes and " << edge_properties_.size()
+                  << " edges from " << file);
+  is_created_ = compact();
+  if (is_created_) {
+    createQueryCache();
+    reportMemory();
+  }
+  return is_created_;
+}
+
+}  // namespace sweep_plan_graph
+}  // namespace polygon_coverage_planning
@@ -0,0 +1,129 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "polygon_coverage_planners/memory.h"
+
+#include <sys/resource.h>
+
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+
+namespace polygon_coverage_planning {
+namespace memory {
+namespace {
+struct Registry {
+  std::mutex mutex;  // Guards usage.
+  Memory::map_t usage;
+};
+
+Registry& getRegistry() {
+  static Registry registry;
+  return registry;
+}
+}  // namespace
+
+void Memory::Report(const std::string& tag, size_t bytes, size_t count) {
+  Registry& registry = getRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  Usage& usage = registry.usage[tag];
+  usage.bytes = bytes;
+  usage.count = count;
+}
+
+void Memory::ReportPeakRss(const std::string& tag) {
+  Report(tag, GetPeakRssBytes(), 1);
+}
+
+size_t Memory::GetBytes(const std::string& tag) {
+  Registry& registry = getRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  map_t::const_iterator it = registry.usage.find(tag);
+  return it == registry.usage.end() ? 0 : it->second.bytes;
+}
+
+size_t Memory::GetCount(const std::string& tag) {
+  Registry& registry = getRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  map_t::const_iterator it = registry.usage.find(tag);
+  return it == registry.usage.end() ? 0 : it->second.count;
+}
+
+size_t Memory::GetPeakRssBytes() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+  return static_cast<size_t>(usage.ru_maxrss);  // Bytes.
+#else
+  return static_cast<size_t>(usage.ru_maxrss) * 1024;  // Kilobytes.
+#endif
+}
+
+Memory::map_t Memory::GetUsage() {
+  Registry& registry = getRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  return registry.usage;
+}
+
+std::string Memory::BytesToString(size_t bytes) {
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(1);
+  if (bytes < 1024) {
+    ss << bytes << " B";
+  } else if (bytes < 1024 * 1024) {
+    ss << bytes / 1024.0 << " KB";
+  } else if (bytes < 1024 * 1024 * 1024) {
+    ss << bytes / (1024.0 * 1024.0) << " MB";
+  } else {
+    ss << bytes / (1024.0 * 1024.0 * 1024.0) << " GB";
+  }
+  return ss.str();
+}
+
+void Memory::Print(std::ostream& out) {
+  const map_t usage = GetUsage();
+  out << "SM Memory\n";
+  out << "-----------\n";
+  for (map_t::const_iterator it = usage.begin(); it != usage.end(); ++it) {
+    out.width(32);
+    out.setf(std::ios::left, std::ios::adjustfield);
+    out << it->first << "\t";
+    out.width(12);
+    out.setf(std::ios::right, std::ios::adjustfield);
+    out << BytesToString(it->second.bytes) << "\t(" << it->second.count
+        << ")\n";
+  }
+  out.setf(std::ios::left, std::ios::adjustfield);
+}
+
+std::string Memory::Print() {
+  std::stringstream ss;
+  Print(ss);
+  return ss.str();
+}
+
+void Memory::Reset() {
+  Registry& registry = getRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.usage.clear();
+}
+
+}  // namespace memory
+}  // namespace polygon_coverage_planning
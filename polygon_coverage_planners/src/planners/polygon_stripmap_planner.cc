@@ -22,9 +22,11 @@
 #include <cmath>
 
 #include <polygon_coverage_geometry/cgal_comm.h>
+#include <polygon_coverage_geometry/counters.h>
 
 #include "polygon_coverage_planners/planners/polygon_stripmap_planner.h"
 #include "polygon_coverage_planners/timing.h"
+#include "polygon_coverage_planners/tracing.h"
 
 namespace polygon_coverage_planning {
 
@@ -33,10 +35,13 @@ PolygonStripmapPlanner::PolygonStripmapPlanner(
     : is_initialized_(false), settings_(settings) {}
 
 bool PolygonStripmapPlanner::setup() {
+  tracing::Span span("setup");
   is_initialized_ = true;
 
   // Create sweep plan graph.
-  timing::Timer timer_sweep_graph("sweep_graph");
+  static const size_t kSweepGraphTimer =
+      timing::Timing::GetHandle("sweep_graph");
+  timing::Timer timer_sweep_graph(kSweepGraphTimer);
   if (is_initialized_) {
     ROS_INFO("Start creating sweep plan graph.");
     sweep_plan_graph_ = sweep_plan_graph::SweepPlanGraph(settings_);
@@ -48,16 +53,126 @@ bool PolygonStripmapPlanner::setup() {
   timer_sweep_graph.Stop();
 
   // Solver specific setup.
-  timing::Timer timer_setup_solver("setup_solver");
+  static const size_t kSetupSolverTimer =
+      timing::Timing::GetHandle("setup_solver");
+  timing::Timer timer_setup_solver(kSetupSolverTimer);
+  tracing::Span span_setup_solver("setup_solver");
   is_initialized_ = setupSolver();
   timer_setup_solver.Stop();
 
   return is_initialized_;
 }
 
+bool PolygonStripmapPlanner::setup(const std::string& snapshot_file) {
+  tracing::Span span("setup");
+  snapshot_file_ = snapshot_file;
+  static const size_t kSweepGraphLoadTimer =
+      timing::Timing::GetHandle("sweep_graph_load");
+  timing::Timer timer_sweep_graph(kSweepGraphLoadTimer);
+  is_initialized_ = sweep_plan_graph_.load(settings_, snapshot_file);
+  timer_sweep_graph.Stop();
+  if (!is_initialized_) {
+    if (!setup()) {
+      return false;
+    }
+    if (!sweep_plan_graph_.save(snapshot_file)) {
+      ROS_WARN_STREAM("Cannot save sweep plan graph to " << snapshot_file);
+    }
+    return true;
+  }
+
+  // Solver specific setup.
+  static const size_t kSetupSolverTimer =
+      timing::Timing::GetHandle("setup_solver");
+  timing::Timer timer_setup_solver(kSetupSolverTimer);
+  tracing::Span span_setup_solver("setup_solver");
+  is_initialized_ = setupSolver();
+  timer_setup_solver.Stop();
+
+  return is_initialized_;
+}
+
+bool PolygonStripmapPlanner::update(const PolygonWithHoles& polygon) {
+  tracing::Span span("update");
+  if (!is_initialized_) {
+    ROS_ERROR("Cannot update sweep planner before setup.");
+    return false;
+  }
+  settings_.polygon = polygon;
+  if (result_cache_) {
+    result_cache_key_ = ResultCache::createKey(settings_);
+  }
+
+  static const size_t kSweepGraphUpdateTimer =
+      timing::Timing::GetHandle("sweep_graph_update");
+  timing::Timer timer_sweep_graph(kSweepGraphUpdateTimer);
+  ROS_INFO("Start updating sweep plan graph.");
+  is_initialized_ = sweep_plan_graph_.update(settings_.polygon);
+  if (!is_initialized_) {
+    ROS_ERROR("Cannot update sweep plan graph.");
+  }
+  timer_sweep_graph.Stop();
+
+  // Solver specific setup.
+  static const size_t kSetupSolverTimer =
+      timing::Timing::GetHandle("setup_solver");
+  timing::Timer timer_setup_solver(kSetupSolverTimer);
+  tracing::Span span_setup_solver("setup_solver");
+  is_initialized_ = is_initialized_ && setupSolver();
+  timer_setup_solver.Stop();
+
+  return is_initialized_;
+}
+
 bool PolygonStripmapPlanner::solve(const Point_2& start, const Point_2& goal,
-                                   std::vector<Point_2>* solution) const {
-  timing::Timer timer_solve("solve");
+                                   std::vector<Point_2>* solution,
+                                   const Deadline& deadline) const {
+  ROS_ASSERT(solution);
+  tracing::Span span("solve");
+  counters::Stage stage("solve");
+  if (is_initialized_ && result_cache_ &&
+      result_cache_->find(result_cache_key_, getResultCacheTag(), start, goal,
+                          solution)) {
+    ROS_INFO("Found solution in result cache.");
+    return true;
+  }
+
+  if (!solveWith(
+          [this, &deadline](const Point_2& start, const Point_2& goal,
+                            std::vector<Point_2>* solution) {
+            return runSolver(start, goal, solution, deadline);
+          },
+          start, goal, solution)) {
+    ROS_ERROR("Failed solving graph.");
+    return false;
+  }
+  // A time limit may cut the solver short. Later queries without limit would
+  // return the truncated solution.
+  const bool is_limited = deadline.hasTimeLimit() || deadline.isCancelled() ||
+                          settings_.gtsp_solver_settings.time_budget > 0.0;
+  if (result_cache_ && !is_limited) {
+    result_cache_->insert(result_cache_key_, getResultCacheTag(), start, goal,
+                          *solution);
+  }
+  return true;
+}
+
+bool PolygonStripmapPlanner::enableResultCache(const std::string& file) {
+  result_cache_.reset(new ResultCache());
+  result_cache_key_ = ResultCache::createKey(settings_);
+  if (file.empty()) {
+    return true;
+  }
+  result_cache_->setFile(file);
+  return result_cache_->load(file);
+}
+
+bool PolygonStripmapPlanner::solveWith(const SolverFunction& run_solver,
+                                       const Point_2& start,
+                                       const Point_2& goal,
+                                       std::vector<Point_2>* solution) const {
+  static const size_t kSolveTimer = timing::Timing::GetHandle("solve");
+  timing::Timer timer_solve(kSolveTimer);
   ROS_ASSERT(solution);
   solution->clear();
 
@@ -76,8 +191,7 @@ bool PolygonStripmapPlanner::solve(const Point_2& start, const Point_2& goal,
                                ? goal
                                : projectPointOnHull(settings_.polygon, goal);
 
-  if (!runSolver(start_new, goal_new, solution)) {
-    ROS_ERROR("Failed solving graph.");
+  if (!run_solver(start_new, goal_new, solution)) {
     return false;
   }
 
@@ -96,11 +210,12 @@ bool PolygonStripmapPlanner::solve(const Point_2& start, const Point_2& goal,
 
 bool PolygonStripmapPlanner::runSolver(const Point_2& start,
                                        const Point_2& goal,
-                                       std::vector<Point_2>* solution) const {
+                                       std::vector<Point_2>* solution,
+                                       const Deadline& deadline) const {
   ROS_ASSERT(solution);
 
   ROS_INFO("Start solving GTSP using GK MA.");
-  return sweep_plan_graph_.solve(start, goal, solution);
+  return sweep_plan_graph_.solve(start, goal, solution, deadline);
 }
 
 }  // namespace polygon_coverage_planning
@@ -0,0 +1,115 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "polygon_coverage_planners/planners/polygon_stripmap_planner_anytime.h"
+
+#include <ros/assert.h>
+#include <ros/console.h>
+
+namespace polygon_coverage_planning {
+
+PolygonStripmapPlannerAnytime::~PolygonStripmapPlannerAnytime() { cancel(); }
+
+bool PolygonStripmapPlannerAnytime::solve(const Point_2& start,
+                                          const Point_2& goal,
+                                          std::vector<Point_2>* solution,
+                                          const Deadline& deadline) {
+  ROS_ASSERT(solution);
+  cancel();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    refined_solution_.clear();
+    is_refined_ = false;
+  }
+
+  if (!PolygonStripmapPlanner::solve(start, goal, solution, deadline)) {
+    return false;
+  }
+  if (is_fallback_) {
+    ROS_INFO("Product graph exceeds memory budget. No exact refinement.");
+    return true;
+  }
+
+  is_cancelled_ = false;
+  refinement_ = std::thread(&PolygonStripmapPlannerAnytime::refine, this,
+                            start, goal, cost_function_(*solution));
+  return true;
+}
+
+bool PolygonStripmapPlannerAnytime::waitForRefinement(
+    std::vector<Point_2>* solution) {
+  ROS_ASSERT(solution);
+  if (refinement_.joinable()) {
+    refinement_.join();
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (is_refined_) {
+    *solution = refined_solution_;
+  }
+  return is_refined_;
+}
+
+void PolygonStripmapPlannerAnytime::cancel() {
+  is_cancelled_ = true;
+  if (refinement_.joinable()) {
+    refinement_.join();
+  }
+}
+
+bool PolygonStripmapPlannerAnytime::runSolver(
+    const Point_2& start, const Point_2& goal, std::vector<Point_2>* solution,
+    const Deadline& deadline) const {
+  ROS_ASSERT(solution);
+
+  ROS_INFO("Start solving GTSP using GK MA before exact refinement.");
+  return sweep_plan_graph_.solve(start, goal, solution, deadline);
+}
+
+void PolygonStripmapPlannerAnytime::refine(const Point_2& start,
+                                           const Point_2& goal,
+                                           double upper_bound) {
+  // The cost of the original start and goal segments only loosens the bound.
+  ROS_INFO("Start refining GTSP solution using exact solver.");
+  std::vector<Point_2> solution;
+  if (!solveWith(
+          [this, upper_bound](const Point_2& start, const Point_2& goal,
+                              std::vector<Point_2>* solution) {
+            return gtspp_product_graph_.solveOnline(
+                start, goal, solution, upper_bound,
+                Deadline(0.0, &is_cancelled_));
+          },
+          start, goal, &solution) ||
+      is_cancelled_ || cost_function_(solution) >= upper_bound) {
+    ROS_INFO("Exact solver found no cheaper solution.");
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    refined_solution_ = solution;
+    is_refined_ = true;
+  }
+  ROS_INFO("Exact solver found a cheaper solution.");
+  if (callback_) {
+    callback_(solution);
+  }
+}
+
+}  // namespace polygon_coverage_planning
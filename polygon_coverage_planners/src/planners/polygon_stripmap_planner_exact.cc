@@ -19,28 +19,32 @@
 
 #include "polygon_coverage_planners/planners/polygon_stripmap_planner_exact.h"
 
+#include <limits>
+
 #include <ros/assert.h>
 #include <ros/console.h>
 
 namespace polygon_coverage_planning {
 
 bool PolygonStripmapPlannerExact::setupSolver() {
-  ROS_INFO("Creating boolean lattice.");
-  boolean_lattice_ = boolean_lattice::BooleanLattice(
-      sweep_plan_graph_.getDecomposition().size());
-  if (!boolean_lattice_.isInitialized()) {
-    ROS_ERROR("Cannot create boolean lattice.");
-    return false;
-  }
-
   ROS_INFO("Initializing product graph.");
-  gtspp_product_graph_ = gtspp_product_graph::GtsppProductGraph(
-      &sweep_plan_graph_, &boolean_lattice_);
+  {
+    std::lock_guard<std::mutex> lock(reverse_tree_mutex_);
+    reverse_tree_.reset();
+  }
+  gtspp_product_graph_ =
+      gtspp_product_graph::GtsppProductGraph(&sweep_plan_graph_);
 
   return preprocess();
 }
 
 bool PolygonStripmapPlannerExact::preprocess() {
+  if (!checkMemoryBudget(false)) {
+    return false;
+  } else if (is_fallback_) {
+    return true;
+  }
+
   ROS_INFO("Preset product graph.");
   if (!gtspp_product_graph_.createOnline()) {
     ROS_ERROR("Could not create product graph.");
@@ -49,13 +53,80 @@ bool PolygonStripmapPlannerExact::preprocess() {
   return true;
 }
 
+bool PolygonStripmapPlannerExact::checkMemoryBudget(bool precompute) {
+  is_fallback_ = false;
+  gtspp_product_graph::MemoryEstimate estimate;
+  const bool is_addressable =
+      gtspp_product_graph::GtsppProductGraph::estimateMemory(
+          sweep_plan_graph_, precompute, &estimate);
+  if (reverse_search_) {
+    // One cost-to-go and successor per product node.
+    estimate.search_bytes +=
+        estimate.num_nodes * (sizeof(double) + sizeof(uint32_t));
+  }
+  if (is_addressable &&
+      (memory_budget_ == 0 || estimate.getTotalBytes() <= memory_budget_)) {
+    ROS_INFO_STREAM("Product graph memory estimate: "
+                    << estimate.getTotalBytes() << " bytes.");
+    return true;
+  }
+
+  if (is_addressable) {
+    ROS_WARN_STREAM("Product graph memory estimate of "
+                    << estimate.getTotalBytes()
+                    << " bytes exceeds budget of " << memory_budget_
+                    << " bytes.");
+  }
+  if (!use_fallback_) {
+    ROS_ERROR("Cannot create product graph within memory budget.");
+    return false;
+  }
+  ROS_WARN("Falling back to heuristic GTSP solver.");
+  is_fallback_ = true;
+  return true;
+}
+
 bool PolygonStripmapPlannerExact::runSolver(
-    const Point_2& start, const Point_2& goal,
-    std::vector<Point_2>* solution) const {
+    const Point_2& start, const Point_2& goal, std::vector<Point_2>* solution,
+    const Deadline& deadline) const {
   ROS_ASSERT(solution);
+  if (is_fallback_) {
+    return PolygonStripmapPlanner::runSolver(start, goal, solution, deadline);
+  }
+
+  if (reverse_search_) {
+    return solveReverse(start, goal, solution, deadline);
+  }
 
   ROS_INFO("Start solving GTSP using exact solver without preprocessing.");
-  return gtspp_product_graph_.solveOnline(start, goal, solution);
+  return gtspp_product_graph_.solveOnline(
+      start, goal, solution, std::numeric_limits<double>::infinity(),
+      deadline);
+}
+
+bool PolygonStripmapPlannerExact::solveReverse(
+    const Point_2& start, const Point_2& goal, std::vector<Point_2>* solution,
+    const Deadline& deadline) const {
+  ROS_ASSERT(solution);
+  std::shared_ptr<const gtspp_product_graph::ReverseTree> tree;
+  {
+    std::lock_guard<std::mutex> lock(reverse_tree_mutex_);
+    if (reverse_tree_ == nullptr || reverse_tree_->goal != goal) {
+      ROS_INFO("Searching backwards from the goal.");
+      std::shared_ptr<gtspp_product_graph::ReverseTree> new_tree =
+          std::make_shared<gtspp_product_graph::ReverseTree>();
+      if (!gtspp_product_graph_.createReverseTree(goal, new_tree.get(),
+                                                  deadline)) {
+        ROS_ERROR("Cannot create reverse search tree.");
+        return false;
+      }
+      reverse_tree_ = new_tree;
+    }
+    tree = reverse_tree_;
+  }
+
+  ROS_INFO("Start solving GTSP using the reverse search tree.");
+  return gtspp_product_graph_.solveReverse(*tree, start, solution);
 }
 
 }  // namespace polygon_coverage_planning
@@ -19,27 +19,56 @@
 
 #include "polygon_coverage_planners/planners/polygon_stripmap_planner_exact_preprocessed.h"
 
+#include <string>
+
 #include <ros/assert.h>
 #include <ros/console.h>
 
 namespace polygon_coverage_planning {
 
+const std::string kProductGraphSuffix = ".product";
+
 bool PolygonStripmapPlannerExactPreprocessed::preprocess() {
+  if (!checkMemoryBudget(true)) {
+    return false;
+  } else if (is_fallback_) {
+    return true;
+  }
+
+  // Reuse the product graph of a previous run on the same sweep plan graph.
+  const std::string product_graph_file =
+      snapshot_file_.empty() ? "" : snapshot_file_ + kProductGraphSuffix;
+  if (!product_graph_file.empty() &&
+      gtspp_product_graph_.load(product_graph_file)) {
+    return true;
+  }
+
   ROS_INFO("Precomputing product graph.");
   if (!gtspp_product_graph_.create()) {
     ROS_ERROR("Could not create product graph.");
     return false;
   }
+  if (!product_graph_file.empty() &&
+      !gtspp_product_graph_.save(product_graph_file)) {
+    ROS_WARN_STREAM("Cannot save product graph to " << product_graph_file);
+  }
   return true;
 }
 
 bool PolygonStripmapPlannerExactPreprocessed::runSolver(
-    const Point_2& start, const Point_2& goal,
-    std::vector<Point_2>* solution) const {
+    const Point_2& start, const Point_2& goal, std::vector<Point_2>* solution,
+    const Deadline& deadline) const {
   ROS_ASSERT(solution);
+  if (is_fallback_) {
+    return PolygonStripmapPlanner::runSolver(start, goal, solution, deadline);
+  }
+
+  if (reverse_search_) {
+    return solveReverse(start, goal, solution, deadline);
+  }
 
   ROS_INFO("Start solving GTSP using exact solver with preprocessing.");
-  return gtspp_product_graph_.solve(start, goal, solution);
+  return gtspp_product_graph_.solve(start, goal, solution, deadline);
 }
 
 }  // namespace polygon_coverage_planning
@@ -0,0 +1,36 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "polygon_coverage_planners/planners/polygon_stripmap_planner_hierarchical.h"
+
+#include <ros/assert.h>
+#include <ros/console.h>
+
+namespace polygon_coverage_planning {
+
+bool PolygonStripmapPlannerHierarchical::runSolver(
+    const Point_2& start, const Point_2& goal, std::vector<Point_2>* solution,
+    const Deadline& deadline) const {
+  ROS_ASSERT(solution);
+
+  ROS_INFO("Start solving GTSP using hierarchical Held-Karp solver.");
+  return sweep_plan_graph_.solveHierarchical(start, goal, solution, deadline);
+}
+
+}  // namespace polygon_coverage_planning
@@ -0,0 +1,527 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "polygon_coverage_planners/planners/region_planner.h"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <CGAL/Boolean_set_operations_2.h>
+#include <polygon_coverage_geometry/cgal_comm.h>
+#include <polygon_coverage_geometry/decomposition.h>
+#include <polygon_coverage_geometry/offset.h>
+#include <polygon_coverage_solvers/graph_base.h>
+#include <polygon_coverage_solvers/gtsp_solver.h>
+#include <polygon_coverage_solvers/held_karp.h>
+#include <ros/assert.h>
+#include <ros/console.h>
+
+#include "polygon_coverage_planners/cost_functions/path_cost_functions.h"
+
+namespace polygon_coverage_planning {
+
+namespace {
+// Text layout: header version | region | start | goal | polygon with holes,
+// respectively header version | region | success | solution.
+const char kRegionTaskHeader[] = "region_task";
+const char kRegionResultHeader[] = "region_result";
+const int kRegionFormatVersion = 1;
+
+void writePoint(const Point_2& p, std::ostream* os) {
+  *os << CGAL::exact(p.x()) << ' ' << CGAL::exact(p.y()) << '\n';
+}
+
+bool readPoint(std::istream* is, Point_2* p) {
+  FT x, y;
+  if (!(*is >> x >> y)) {
+    return false;
+  }
+  *p = Point_2(x, y);
+  return true;
+}
+
+template <class InputIterator>
+void writePoints(InputIterator begin, InputIterator end, std::ostream* os) {
+  *os << std::distance(begin, end) << '\n';
+  for (InputIterator it = begin; it != end; ++it) {
+    writePoint(*it, os);
+  }
+}
+
+// The size is not trusted, so the points are not reserved.
+bool readPoints(std::istream* is, std::vector<Point_2>* points) {
+  size_t size = 0;
+  if (!(*is >> size)) {
+    return false;
+  }
+  points->clear();
+  for (size_t i = 0; i < size; ++i) {
+    Point_2 p;
+    if (!readPoint(is, &p)) {
+      return false;
+    }
+    points->push_back(p);
+  }
+  return true;
+}
+
+void writePolygonWithHoles(const PolygonWithHoles& polygon, std::ostream* os) {
+  writePoints(polygon.outer_boundary().vertices_begin(),
+              polygon.outer_boundary().vertices_end(), os);
+  *os << polygon.number_of_holes() << '\n';
+  for (PolygonWithHoles::Hole_const_iterator h = polygon.holes_begin();
+       h != polygon.holes_end(); ++h) {
+    writePoints(h->vertices_begin(), h->vertices_end(), os);
+  }
+}
+
+bool readPolygonWithHoles(std::istream* is, PolygonWithHoles* polygon) {
+  std::vector<Point_2> points;
+  size_t num_holes = 0;
+  if (!readPoints(is, &points) || !(*is >> num_holes)) {
+    return false;
+  }
+  *polygon = PolygonWithHoles(Polygon_2(points.begin(), points.end()));
+  for (size_t i = 0; i < num_holes; ++i) {
+    if (!readPoints(is, &points)) {
+      return false;
+    }
+    polygon->add_hole(Polygon_2(points.begin(), points.end()));
+  }
+  return true;
+}
+
+bool readHeader(std::istream* is, const std::string& expected) {
+  std::string header;
+  int version = 0;
+  return (*is >> header >> version) && header == expected &&
+         version == kRegionFormatVersion;
+}
+
+// The longest segment shared by the boundaries of two cells. Returns false if
+// the cells share no segment, e.g., if they only touch in a vertex.
+bool computeSharedSegment(const Polygon_2& a, const Polygon_2& b,
+                          Segment_2* shared) {
+  ROS_ASSERT(shared);
+  if (!CGAL::do_overlap(a.bbox(), b.bbox())) {
+    return false;
+  }
+  bool is_shared = false;
+  for (EdgeConstIterator ea = a.edges_begin(); ea != a.edges_end(); ++ea) {
+    if (!CGAL::do_overlap(ea->bbox(), b.bbox())) continue;
+    for (EdgeConstIterator eb = b.edges_begin(); eb != b.edges_end(); ++eb) {
+      CGAL::cpp11::result_of<Intersect_2(Segment_2, Segment_2)>::type result =
+          CGAL::intersection(*ea, *eb);
+      if (!result) continue;
+      const Segment_2* s = boost::get<Segment_2>(&*result);
+      if (s != nullptr &&
+          (!is_shared || s->squared_length() > shared->squared_length())) {
+        *shared = *s;
+        is_shared = true;
+      }
+    }
+  }
+  return is_shared;
+}
+
+// A node of the inter-region GTSP, i.e., a region entered and left at two of
+// its portals. Start and goal are nodes of their own.
+struct RegionNode {
+  size_t region;
+  Point_2 entry;
+  Point_2 exit;
+};
+
+// Solve the path from node 0 to node 1 as a GTSP tour that returns from the
+// goal to the start for free.
+bool solveGtspPath(const DistanceMatrix<double>& m,
+                   std::vector<std::vector<int>> clusters,
+                   const sweep_plan_graph::SweepPlanGraph::Settings& settings,
+                   const Deadline& deadline, Solution* solution) {
+  ROS_ASSERT(solution);
+  DistanceMatrix<int> m_int(m.size());
+  for (size_t i = 0; i < m.size(); ++i) {
+    for (size_t j = 0; j < m.size(); ++j) {
+      if (m(i, j) != DistanceMatrix<double>::kNoConnection &&
+          !setDistance(i, j, m(i, j), &m_int)) {
+        return false;
+      }
+    }
+  }
+  m_int(1, 0) = 0;
+  clusters.push_back({0});
+  clusters.push_back({1});
+
+  gtsp::SolverSettings solver_settings = settings.gtsp_solver_settings;
+  if (deadline.hasTimeLimit() || deadline.isCancelled()) {
+    const double kMinTimeBudget = 1.0e-3;
+    double time_budget =
+        std::max(deadline.getRemainingSeconds(), kMinTimeBudget);
+    if (solver_settings.time_budget > 0.0) {
+      time_budget = std::min(time_budget, solver_settings.time_budget);
+    }
+    solver_settings.time_budget = time_budget;
+  }
+  std::unique_ptr<gtsp::SolverBase> solver =
+      gtsp::createSolver(settings.gtsp_solver_type, solver_settings);
+  std::vector<int> tour;
+  if (solver == nullptr ||
+      !solver->solve(gtsp::Task(std::move(m_int), clusters), &tour)) {
+    return false;
+  }
+  std::vector<int>::iterator start_it = std::find(tour.begin(), tour.end(), 0);
+  if (start_it == tour.end()) {
+    return false;
+  }
+  std::rotate(tour.begin(), start_it, tour.end());
+  if (tour.back() != 1) {
+    return false;
+  }
+  solution->assign(tour.begin(), tour.end());
+  return true;
+}
+}  // namespace
+
+bool writeRegionTask(const RegionTask& task, std::ostream* os) {
+  ROS_ASSERT(os);
+  *os << kRegionTaskHeader << ' ' << kRegionFormatVersion << '\n'
+      << task.region << '\n';
+  writePoint(task.start, os);
+  writePoint(task.goal, os);
+  writePolygonWithHoles(task.polygon, os);
+  return os->good();
+}
+
+bool readRegionTask(std::istream* is, RegionTask* task) {
+  ROS_ASSERT(is);
+  ROS_ASSERT(task);
+  if (!readHeader(is, kRegionTaskHeader) || !(*is >> task->region) ||
+      !readPoint(is, &task->start) || !readPoint(is, &task->goal) ||
+      !readPolygonWithHoles(is, &task->polygon)) {
+    ROS_ERROR("Corrupt region task.");
+    return false;
+  }
+  return true;
+}
+
+bool writeRegionResult(const RegionResult& result, std::ostream* os) {
+  ROS_ASSERT(os);
+  *os << kRegionResultHeader << ' ' << kRegionFormatVersion << '\n'
+      << result.region << '\n'
+      << result.success << '\n';
+  writePoints(result.solution.begin(), result.solution.end(), os);
+  return os->good();
+}
+
+bool readRegionResult(std::istream* is, RegionResult* result) {
+  ROS_ASSERT(is);
+  ROS_ASSERT(result);
+  if (!readHeader(is, kRegionResultHeader) || !(*is >> result->region) ||
+      !(*is >> result->success) || !readPoints(is, &result->solution)) {
+    ROS_ERROR("Corrupt region result.");
+    return false;
+  }
+  return true;
+}
+
+RegionPlanner::RegionPlanner(
+    const sweep_plan_graph::SweepPlanGraph::Settings& settings)
+    : settings_(settings), is_initialized_(false) {}
+
+bool RegionPlanner::setup() {
+  is_initialized_ = false;
+  if (settings_.max_region_size == 0) {
+    ROS_ERROR("Maximum region size has to be positive.");
+    return false;
+  }
+  preprocessField();
+  visibility_graph_ = visibility_graph::VisibilityGraph(
+      region_settings_.polygon, region_settings_.num_threads,
+      region_settings_.bitangent_visibility_graph);
+
+  std::vector<Polygon_2> cells;
+  if (!computeDecomposition(region_settings_.polygon,
+                            region_settings_.decomposition_type, &cells,
+                            region_settings_.num_threads)) {
+    ROS_ERROR("Cannot decompose the field.");
+    return false;
+  }
+  if (!partition(cells)) {
+    return false;
+  }
+  ROS_INFO_STREAM("Partitioned " << cells.size() << " cell(s) into "
+                                 << regions_.size() << " region(s).");
+  is_initialized_ = true;
+  return true;
+}
+
+void RegionPlanner::preprocessField() {
+  region_settings_ = settings_;
+  if (region_settings_.simplification_tolerance > 0.0 &&
+      region_settings_.sensor_model) {
+    const double tolerance =
+        region_settings_.simplification_tolerance *
+        region_settings_.sensor_model->getSweepDistance();
+    simplifyPolygonBoundary(&region_settings_.polygon, tolerance);
+  }
+  if (region_settings_.wall_distance > 0.0) {
+    const PolygonWithHoles temp_poly = region_settings_.polygon;
+    computeOffsetPolygon(temp_poly, region_settings_.wall_distance,
+                         &region_settings_.polygon);
+  }
+  if (region_settings_.grid_resolution > 0.0 &&
+      !snapPolygonToGrid(&region_settings_.polygon,
+                         region_settings_.grid_resolution)) {
+    ROS_WARN_STREAM("Cannot snap field to grid of resolution "
+                    << region_settings_.grid_resolution << " m.");
+  }
+  // Simplifying or offsetting a region would move its shared boundaries.
+  // Snapping to the same grid again keeps them.
+  region_settings_.simplification_tolerance = 0.0;
+  region_settings_.wall_distance = 0.0;
+}
+
+bool RegionPlanner::partition(const std::vector<Polygon_2>& cells) {
+  // Cells sharing a boundary segment are adjacent.
+  std::vector<std::vector<size_t>> adjacency(cells.size());
+  std::map<std::pair<size_t, size_t>, Segment_2> shared_segments;
+  for (size_t i = 0; i < cells.size(); ++i) {
+    for (size_t j = i + 1; j < cells.size(); ++j) {
+      Segment_2 shared;
+      if (computeSharedSegment(cells[i], cells[j], &shared)) {
+        adjacency[i].push_back(j);
+        adjacency[j].push_back(i);
+        shared_segments.emplace(std::make_pair(i, j), shared);
+      }
+    }
+  }
+
+  // Grow every region breadth-first from the lowest unassigned cell. Every
+  // cell shares a segment with a previous cell of its region, such that the
+  // joined region is connected.
+  const size_t kUnassigned = std::numeric_limits<size_t>::max();
+  std::vector<size_t> cell_region(cells.size(), kUnassigned);
+  regions_.clear();
+  for (size_t seed = 0; seed < cells.size(); ++seed) {
+    if (cell_region[seed] != kUnassigned) {
+      continue;
+    }
+    const size_t region = regions_.size();
+    std::vector<size_t> group({seed});
+    cell_region[seed] = region;
+    for (size_t i = 0;
+         i < group.size() && group.size() < settings_.max_region_size; ++i) {
+      for (size_t cell : adjacency[group[i]]) {
+        if (group.size() < settings_.max_region_size &&
+            cell_region[cell] == kUnassigned) {
+          cell_region[cell] = region;
+          group.push_back(cell);
+        }
+      }
+    }
+
+    PolygonWithHoles joined(cells[group.front()]);
+    for (size_t i = 1; i < group.size(); ++i) {
+      PolygonWithHoles result;
+      if (!CGAL::join(joined, cells[group[i]], result)) {
+        ROS_ERROR_STREAM("Cannot join cell " << group[i] << " into region "
+                                             << region << ".");
+        return false;
+      }
+      joined = result;
+    }
+    simplifyPolygon(&joined);
+    regions_.push_back(joined);
+  }
+
+  // One portal per pair of neighboring regions at the midpoint of their
+  // longest shared segment.
+  std::map<std::pair<size_t, size_t>, Segment_2> region_segments;
+  for (const auto& shared : shared_segments) {
+    const size_t a = cell_region[shared.first.first];
+    const size_t b = cell_region[shared.first.second];
+    if (a == b) continue;
+    const std::pair<size_t, size_t> key(std::min(a, b), std::max(a, b));
+    std::map<std::pair<size_t, size_t>, Segment_2>::iterator it =
+        region_segments.find(key);
+    if (it == region_segments.end()) {
+      region_segments.emplace(key, shared.second);
+    } else if (shared.second.squared_length() > it->second.squared_length()) {
+      it->second = shared.second;
+    }
+  }
+  portals_.assign(regions_.size(), std::vector<Point_2>());
+  for (const auto& segment : region_segments) {
+    const Point_2 portal =
+        CGAL::midpoint(segment.second.source(), segment.second.target());
+    portals_[segment.first.first].push_back(portal);
+    portals_[segment.first.second].push_back(portal);
+  }
+  return true;
+}
+
+bool RegionPlanner::createTasks(const Point_2& start, const Point_2& goal,
+                                std::vector<RegionTask>* tasks,
+                                const Deadline& deadline) const {
+  ROS_ASSERT(tasks);
+  tasks->clear();
+  if (!is_initialized_) {
+    ROS_ERROR("Region planner is not set up.");
+    return false;
+  }
+
+  // Start and goal are portals of the regions containing them. A region
+  // without neighbors is entered at a vertex.
+  std::vector<std::vector<Point_2>> portals = portals_;
+  for (size_t r = 0; r < regions_.size(); ++r) {
+    if (pointInPolygon(regions_[r], start)) portals[r].push_back(start);
+    if (pointInPolygon(regions_[r], goal)) portals[r].push_back(goal);
+    if (portals[r].empty()) {
+      portals[r].push_back(*regions_[r].outer_boundary().vertices_begin());
+    }
+  }
+
+  // Node 0 is the start, node 1 the goal. Regions with several portals are
+  // left through another portal than they were entered.
+  std::vector<RegionNode> nodes;
+  nodes.push_back({regions_.size(), start, start});
+  nodes.push_back({regions_.size() + 1, goal, goal});
+  std::vector<std::vector<int>> clusters(regions_.size());
+  for (size_t r = 0; r < regions_.size(); ++r) {
+    for (size_t a = 0; a < portals[r].size(); ++a) {
+      for (size_t b = 0; b < portals[r].size(); ++b) {
+        if (a != b || portals[r].size() == 1) {
+          clusters[r].push_back(static_cast<int>(nodes.size()));
+          nodes.push_back({r, portals[r][a], portals[r][b]});
+        }
+      }
+    }
+  }
+  DistanceMatrix<double> m(nodes.size());
+  for (size_t u = 0; u < nodes.size(); ++u) {
+    for (size_t v = 0; v < nodes.size(); ++v) {
+      if (u == 1 || v == 0 || nodes[u].region == nodes[v].region ||
+          (u == 0 && v == 1)) {
+        continue;
+      }
+      m(u, v) = computeSegmentCost(region_settings_.cost_function,
+                                   nodes[u].exit, nodes[v].entry);
+    }
+  }
+
+  // Exact if the table fits.
+  ROS_INFO_STREAM("Start ordering " << regions_.size() << " region(s) over "
+                                    << nodes.size() << " portal pairs.");
+  Solution order;
+  held_karp::HeldKarp::Settings held_karp_settings;
+  size_t table_size = 0;
+  if (regions_.size() <= held_karp_settings.max_clusters &&
+      held_karp::HeldKarp::computeTableSize(regions_.size(), nodes.size(),
+                                            &table_size) &&
+      table_size <= held_karp_settings.max_table_size) {
+    held_karp::HeldKarp solver(held_karp_settings);
+    if (!solver.solve(m, clusters, 0, 1, &order, deadline)) {
+      ROS_ERROR("Cannot order regions.");
+      return false;
+    }
+  } else if (!solveGtspPath(m, clusters, region_settings_, deadline,
+                            &order)) {
+    ROS_ERROR("Cannot order regions.");
+    return false;
+  }
+
+  for (size_t k = 1; k + 1 < order.size(); ++k) {
+    const RegionNode& node = nodes[order[k]];
+    RegionTask task;
+    task.region = node.region;
+    task.polygon = regions_[node.region];
+    task.start = node.entry;
+    task.goal = node.exit;
+    tasks->push_back(std::move(task));
+  }
+  return true;
+}
+
+sweep_plan_graph::SweepPlanGraph::Settings RegionPlanner::getRegionSettings(
+    const RegionTask& task) const {
+  sweep_plan_graph::SweepPlanGraph::Settings settings = region_settings_;
+  settings.polygon = task.polygon;
+  return settings;
+}
+
+bool RegionPlanner::stitch(const Point_2& start, const Point_2& goal,
+                           const std::vector<RegionResult>& results,
+                           std::vector<Point_2>* solution) const {
+  ROS_ASSERT(solution);
+  solution->clear();
+  if (!is_initialized_) {
+    ROS_ERROR("Region planner is not set up.");
+    return false;
+  }
+  if (results.size() != regions_.size()) {
+    ROS_ERROR_STREAM("Expected " << regions_.size() << " regional tours, got "
+                                 << results.size() << ".");
+    return false;
+  }
+
+  std::vector<bool> is_covered(regions_.size(), false);
+  solution->push_back(start);
+  for (const RegionResult& result : results) {
+    if (result.region >= regions_.size() || is_covered[result.region]) {
+      ROS_ERROR_STREAM("Invalid or repeated region " << result.region << ".");
+      return false;
+    }
+    is_covered[result.region] = true;
+    if (!result.success || result.solution.empty()) {
+      ROS_ERROR_STREAM("Region " << result.region << " has no tour.");
+      return false;
+    }
+    if (!appendShortestPath(result.solution.front(), solution)) {
+      return false;
+    }
+    solution->insert(solution->end(), result.solution.begin() + 1,
+                     result.solution.end());
+  }
+  return appendShortestPath(goal, solution);
+}
+
+bool RegionPlanner::appendShortestPath(const Point_2& goal,
+                                       std::vector<Point_2>* waypoints) const {
+  ROS_ASSERT(waypoints);
+  ROS_ASSERT(!waypoints->empty());
+  if (waypoints->back() == goal) {
+    return true;
+  }
+  std::vector<Point_2> path;
+  if (!visibility_graph_.solve(waypoints->back(), goal, &path) ||
+      path.empty()) {
+    ROS_ERROR_STREAM("Cannot connect " << waypoints->back() << " to " << goal
+                                       << ".");
+    return false;
+  }
+  waypoints->insert(waypoints->end(), path.begin() + 1, path.end());
+  return true;
+}
+
+}  // namespace polygon_coverage_planning
@@ -0,0 +1,311 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "polygon_coverage_planners/result_cache.h"
+
+#include <algorithm>
+#include <fstream>
+
+#include <ros/assert.h>
+#include <ros/console.h>
+
+namespace polygon_coverage_planning {
+
+namespace {
+const char kCacheHeader[] = "PCPRESULTCACHE";
+const uint64_t kCacheVersion = 2;
+
+// Start the boundary at its lexicographically smallest vertex.
+Polygon_2 canonicalize(const Polygon_2& polygon) {
+  std::vector<Point_2> vertices(polygon.vertices_begin(),
+                                polygon.vertices_end());
+  std::rotate(vertices.begin(),
+              std::min_element(vertices.begin(), vertices.end()),
+              vertices.end());
+  return Polygon_2(vertices.begin(), vertices.end());
+}
+
+// Canonical boundaries with sorted holes.
+PolygonWithHoles canonicalize(const PolygonWithHoles& polygon) {
+  std::vector<Polygon_2> holes;
+  for (PolygonWithHoles::Hole_const_iterator h = polygon.holes_begin();
+       h != polygon.holes_end(); ++h) {
+    holes.push_back(canonicalize(*h));
+  }
+  std::sort(holes.begin(), holes.end(),
+            [](const Polygon_2& a, const Polygon_2& b) {
+              return std::lexicographical_compare(
+                  a.vertices_begin(), a.vertices_end(), b.vertices_begin(),
+                  b.vertices_end());
+            });
+  PolygonWithHoles canonical(canonicalize(polygon.outer_boundary()));
+  for (const Polygon_2& hole : holes) {
+    canonical.add_hole(hole);
+  }
+  return canonical;
+}
+
+bool equalRings(const Polygon_2& a, const Polygon_2& b) {
+  return a.size() == b.size() &&
+         std::equal(a.vertices_begin(), a.vertices_end(), b.vertices_begin());
+}
+
+// Vertex by vertex equality of canonical polygons.
+bool equalPolygons(const PolygonWithHoles& a, const PolygonWithHoles& b) {
+  return a.number_of_holes() == b.number_of_holes() &&
+         equalRings(a.outer_boundary(), b.outer_boundary()) &&
+         std::equal(a.holes_begin(), a.holes_end(), b.holes_begin(),
+                    equalRings);
+}
+
+uint64_t combine(uint64_t hash, uint64_t value) {
+  return hash ^ (value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2));
+}
+
+void writePoint(std::ostream& os, const Point_2& p) {
+  os << CGAL::exact(p.x()) << ' ' << CGAL::exact(p.y()) << ' ';
+}
+
+bool readPoint(std::istream& is, Point_2* p) {
+  ROS_ASSERT(p);
+  FT x, y;
+  if (!(is >> x >> y)) {
+    return false;
+  }
+  *p = Point_2(x, y);
+  return true;
+}
+
+void writeRing(std::ostream& os, const Polygon_2& ring) {
+  os << ring.size() << ' ';
+  for (const Point_2& p : ring) {
+    writePoint(os, p);
+  }
+}
+
+bool readRing(std::istream& is, Polygon_2* ring) {
+  ROS_ASSERT(ring);
+  size_t num_vertices = 0;
+  if (!(is >> num_vertices)) {
+    return false;
+  }
+  ring->clear();
+  for (size_t i = 0; i < num_vertices; ++i) {
+    Point_2 p;
+    if (!readPoint(is, &p)) {
+      return false;
+    }
+    ring->push_back(p);
+  }
+  return true;
+}
+}  // namespace
+
+uint64_t ResultCache::computeKey(
+    const sweep_plan_graph::SweepPlanGraph::Settings& settings) {
+  return createKey(settings).hash;
+}
+
+ResultCache::Key ResultCache::createKey(
+    const sweep_plan_graph::SweepPlanGraph::Settings& settings) {
+  sweep_plan_graph::SweepPlanGraph::Settings canonical = settings;
+  canonical.polygon = canonicalize(settings.polygon);
+
+  Key key;
+  key.hash = sweep_plan_graph::SweepPlanGraph::computeSnapshotKey(canonical);
+  key.hash =
+      combine(key.hash, static_cast<uint64_t>(settings.gtsp_solver_type));
+  key.hash = combine(key.hash, settings.gtsp_solver_settings.num_starts);
+  key.polygon = std::move(canonical.polygon);
+  return key;
+}
+
+const ResultCache::Field* ResultCache::findField(
+    const Key& key, const std::string& tag) const {
+  auto range = fields_.equal_range(key.hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second.tag == tag &&
+        equalPolygons(it->second.polygon, key.polygon)) {
+      return &it->second;
+    }
+  }
+  return nullptr;
+}
+
+ResultCache::Field* ResultCache::findField(const Key& key,
+                                           const std::string& tag) {
+  return const_cast<Field*>(
+      static_cast<const ResultCache*>(this)->findField(key, tag));
+}
+
+bool ResultCache::find(const Key& key, const std::string& tag,
+                       const Point_2& start, const Point_2& goal,
+                       std::vector<Point_2>* solution) const {
+  ROS_ASSERT(solution);
+  std::lock_guard<std::mutex> lock(mutex_);
+  const Field* field = findField(key, tag);
+  if (field == nullptr) {
+    return false;
+  }
+  for (const Entry& entry : field->entries) {
+    if (entry.start == start && entry.goal == goal) {
+      *solution = entry.solution;
+      return true;
+    }
+  }
+  return false;
+}
+
+void ResultCache::insert(const Key& key, const std::string& tag,
+                         const Point_2& start, const Point_2& goal,
+                         const std::vector<Point_2>& solution) {
+  ROS_ASSERT(!tag.empty() && tag.find_first_of(" \t\n") == std::string::npos);
+  std::lock_guard<std::mutex> lock(mutex_);
+  Field* field = findField(key, tag);
+  if (field == nullptr) {
+    field = &fields_.emplace(key.hash, Field{tag, key.polygon, {}})->second;
+  }
+  for (Entry& entry : field->entries) {
+    if (entry.start == start && entry.goal == goal) {
+      entry.solution = solution;
+      return;
+    }
+  }
+  field->entries.push_back(Entry{start, goal, solution});
+  if (!file_.empty() && !saveLocked(file_)) {
+    ROS_WARN_STREAM("Cannot save result cache to " << file_);
+  }
+}
+
+bool ResultCache::load(const std::string& file) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  fields_.clear();
+  std::ifstream is(file);
+  if (!is) {
+    ROS_INFO_STREAM("No result cache file " << file);
+    return true;
+  }
+
+  // Layout: header version num_fields, then per field: key tag num_holes
+  // hull holes num_entries, and per entry: start goal num_waypoints
+  // waypoints. Every ring is num_vertices vertices.
+  std::string header;
+  uint64_t version = 0;
+  size_t num_fields = 0;
+  if (!(is >> header >> version >> num_fields) || header != kCacheHeader ||
+      version != kCacheVersion) {
+    ROS_WARN_STREAM("Result cache file " << file
+                                         << " has a different version.");
+    return false;
+  }
+  std::multimap<uint64_t, Field> fields;
+  for (size_t i = 0; i < num_fields; ++i) {
+    uint64_t key = 0;
+    Field field;
+    size_t num_holes = 0;
+    size_t num_entries = 0;
+    if (!(is >> key >> field.tag >> num_holes) ||
+        !readRing(is, &field.polygon.outer_boundary())) {
+      ROS_ERROR_STREAM("Corrupt result cache file " << file);
+      return false;
+    }
+    for (size_t h = 0; h < num_holes; ++h) {
+      Polygon_2 hole;
+      if (!readRing(is, &hole)) {
+        ROS_ERROR_STREAM("Corrupt result cache file " << file);
+        return false;
+      }
+      field.polygon.add_hole(std::move(hole));
+    }
+    if (!(is >> num_entries)) {
+      ROS_ERROR_STREAM("Corrupt result cache file " << file);
+      return false;
+    }
+    field.entries.resize(num_entries);
+    for (Entry& entry : field.entries) {
+      size_t num_waypoints = 0;
+      if (!readPoint(is, &entry.start) || !readPoint(is, &entry.goal) ||
+          !(is >> num_waypoints)) {
+        ROS_ERROR_STREAM("Corrupt result cache file " << file);
+        return false;
+      }
+      entry.solution.resize(num_waypoints);
+      for (Point_2& waypoint : entry.solution) {
+        if (!readPoint(is, &waypoint)) {
+          ROS_ERROR_STREAM("Corrupt result cache file " << file);
+          return false;
+        }
+      }
+    }
+    fields.emplace(key, std::move(field));
+  }
+  fields_ = std::move(fields);
+  return true;
+}
+
+bool ResultCache::save(const std::string& file) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return saveLocked(file);
+}
+
+bool ResultCache::saveLocked(const std::string& file) const {
+  std::ofstream os(file, std::ios::trunc);
+  if (!os) {
+    ROS_ERROR_STREAM("Cannot open result cache file " << file);
+    return false;
+  }
+  os << kCacheHeader << ' ' << kCacheVersion << ' ' << fields_.size() << '\n';
+  for (const std::pair<const uint64_t, Field>& field : fields_) {
+    os << field.first << ' ' << field.second.tag << ' '
+       << field.second.polygon.number_of_holes() << ' ';
+    writeRing(os, field.second.polygon.outer_boundary());
+    for (PolygonWithHoles::Hole_const_iterator h =
+             field.second.polygon.holes_begin();
+         h != field.second.polygon.holes_end(); ++h) {
+      writeRing(os, *h);
+    }
+    os << field.second.entries.size() << '\n';
+    for (const Entry& entry : field.second.entries) {
+      writePoint(os, entry.start);
+      writePoint(os, entry.goal);
+      os << entry.solution.size() << ' ';
+      for (const Point_2& waypoint : entry.solution) {
+        writePoint(os, waypoint);
+      }
+      os << '\n';
+    }
+  }
+  return os.good();
+}
+
+size_t ResultCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t num_entries = 0;
+  for (const std::pair<const uint64_t, Field>& field : fields_) {
+    num_entries += field.second.entries.size();
+  }
+  return num_entries;
+}
+
+void ResultCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  fields_.clear();
+}
+
+}  // namespace polygon_coverage_planning
@@ -27,28 +27,175 @@
 namespace polygon_coverage_planning {
 namespace timing {
 
+constexpr int Histogram::kMinExponent;
+constexpr int Histogram::kMaxExponent;
+constexpr size_t Histogram::kNumSubBuckets;
+constexpr size_t Histogram::kNumBuckets;
+
+size_t Histogram::GetBucketIndex(double seconds) {
+  if (!(seconds > 0.0)) return 0;
+  int exponent = 0;
+  // seconds = fraction * 2^exponent with fraction in [0.5, 1).
+  const double fraction = frexp(seconds, &exponent);
+  --exponent;
+  if (exponent < kMinExponent) {
+    // Linear buckets of the first octave.
+    const double sub_bucket =
+        ldexp(seconds, -kMinExponent) * static_cast<double>(kNumSubBuckets);
+    return std::min(static_cast<size_t>(sub_bucket), kNumSubBuckets - 1);
+  }
+  if (exponent > kMaxExponent) return kNumBuckets - 1;
+  const size_t octave = static_cast<size_t>(exponent - kMinExponent) + 1;
+  const size_t sub_bucket = std::min(
+      static_cast<size_t>((2.0 * fraction - 1.0) * kNumSubBuckets),
+      kNumSubBuckets - 1);
+  return octave * kNumSubBuckets + sub_bucket;
+}
+
+double Histogram::GetBucketUpperBound(size_t index) {
+  const size_t octave = index / kNumSubBuckets;
+  const size_t sub_bucket = index % kNumSubBuckets;
+  // The first octave starts at 0.
+  const double base =
+      octave == 0 ? 0.0
+                  : ldexp(1.0, kMinExponent + static_cast<int>(octave) - 1);
+  const double step =
+      ldexp(1.0, kMinExponent + std::max(static_cast<int>(octave) - 1, 0)) /
+      static_cast<double>(kNumSubBuckets);
+  return base + (sub_bucket + 1) * step;
+}
+
+void Histogram::Add(double seconds) {
+  if (counts_.empty()) counts_.resize(kNumBuckets, 0);
+  ++counts_[GetBucketIndex(seconds)];
+  ++total_count_;
+}
+
+void Histogram::Merge(const Histogram& other) {
+  if (other.counts_.empty()) return;
+  if (counts_.empty()) counts_.resize(kNumBuckets, 0);
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    counts_[i] += other.counts_[i];
+  }
+  total_count_ += other.total_count_;
+}
+
+double Histogram::Percentile(double percentile) const {
+  if (total_count_ == 0) return 0.0;
+  percentile = std::min(std::max(percentile, 0.0), 100.0);
+  const uint64_t rank = std::max<uint64_t>(
+      static_cast<uint64_t>(ceil(percentile / 100.0 * total_count_)), 1);
+  uint64_t count = 0;
+  for (size_t i = 0; i < counts_.size(); ++i) {
+    count += counts_[i];
+    if (count >= rank) return GetBucketUpperBound(i);
+  }
+  return GetBucketUpperBound(kNumBuckets - 1);
+}
+
+std::vector<std::pair<double, uint64_t>> Histogram::GetBuckets() const {
+  std::vector<std::pair<double, uint64_t>> buckets;
+  for (size_t i = 0; i < counts_.size(); ++i) {
+    if (counts_[i] > 0) {
+      buckets.emplace_back(GetBucketUpperBound(i), counts_[i]);
+    }
+  }
+  return buckets;
+}
+
+void Accumulator::Add(double sample) {
+  ++num_samples_;
+  sum_ += sample;
+  sum_squared_ += sample * sample;
+  min_ = std::min(min_, sample);
+  max_ = std::max(max_, sample);
+  histogram_.Add(sample);
+}
+
+void Accumulator::Merge(const Accumulator& other) {
+  num_samples_ += other.num_samples_;
+  sum_ += other.sum_;
+  sum_squared_ += other.sum_squared_;
+  min_ = std::min(min_, other.min_);
+  max_ = std::max(max_, other.max_);
+  histogram_.Merge(other.histogram_);
+}
+
+double Accumulator::Mean() const {
+  return num_samples_ == 0 ? 0.0 : sum_ / num_samples_;
+}
+
+double Accumulator::Percentile(double percentile) const {
+  if (num_samples_ == 0) {
+    return 0.0;
+  } else if (percentile <= 0.0) {
+    return min_;
+  }
+  return std::min(std::max(histogram_.Percentile(percentile), min_), max_);
+}
+
+double Accumulator::Variance() const {
+  if (num_samples_ == 0) {
+    return 0.0;
+  }
+  const double mean = Mean();
+  return std::max(sum_squared_ / num_samples_ - mean * mean, 0.0);
+}
+
+class Timing::ThreadRegistration {
+ public:
+  ThreadRegistration() {
+    Timing& timing = Instance();
+    std::lock_guard<std::mutex> lock(timing.mutex_);
+    timing.threads_.push_back(&accumulators);
+  }
+  ~ThreadRegistration() {
+    // Keep the samples of worker threads after they exit.
+    Timing& timing = Instance();
+    std::lock_guard<std::mutex> lock(timing.mutex_);
+    std::lock_guard<std::mutex> thread_lock(accumulators.mutex);
+    if (timing.retired_.size() < accumulators.accumulators.size()) {
+      timing.retired_.resize(accumulators.accumulators.size());
+    }
+    for (size_t i = 0; i < accumulators.accumulators.size(); ++i) {
+      timing.retired_[i].Merge(accumulators.accumulators[i]);
+    }
+    timing.threads_.erase(std::remove(timing.threads_.begin(),
+                                      timing.threads_.end(), &accumulators),
+                          timing.threads_.end());
+  }
+
+  ThreadAccumulators accumulators;
+};
+
 Timing& Timing::Instance() {
   static Timing t;
   return t;
 }
 
+Timing::ThreadAccumulators& Timing::GetThreadAccumulators() {
+  // Constructed after Instance, such that it is destroyed before.
+  thread_local ThreadRegistration registration;
+  return registration.accumulators;
+}
+
 Timing::Timing() : max_tag_length_(0) {}
 
 Timing::~Timing() {}
 
 // Static functions to query the timers:
 size_t Timing::GetHandle(std::string const& tag) {
+  Timing& timing = Instance();
+  std::lock_guard<std::mutex> lock(timing.mutex_);
   // Search for an existing tag.
-  map_t::iterator i = Instance().tag_map_.find(tag);
-  if (i == Instance().tag_map_.end()) {
+  map_t::iterator i = timing.tag_map_.find(tag);
+  if (i == timing.tag_map_.end()) {
     // If it is not there, create a tag.
-    size_t handle = Instance().timers_.size();
-    Instance().tag_map_[tag] = handle;
-    Instance().timers_.push_back(TimerMapValue());
+    size_t handle = timing.tag_map_.size();
+    timing.tag_map_[tag] = handle;
     // Track the maximum tag length to help printing a table of timing values
     // later.
-    Instance().max_tag_length_ =
-        std::max(Instance().max_tag_length_, tag.size());
+    timing.max_tag_length_ = std::max(timing.max_tag_length_, tag.size());
     return handle;
   } else {
     return i->second;
@@ -56,15 +203,21 @@ size_t Timing::GetHandle(std::string const& tag) {
 }
 
 std::string Timing::GetTag(size_t handle) {
-  std::string tag;
-
+  Timing& timing = Instance();
+  std::lock_guard<std::mutex> lock(timing.mutex_);
   // Perform a linear search for the tag.
-  for (typename map_t::value_type current_tag : Instance().tag_map_) {
+  for (const map_t::value_type& current_tag : timing.tag_map_) {
     if (current_tag.second == handle) {
       return current_tag.first;
     }
   }
-  return tag;
+  return std::string();
+}
+
+Timing::map_t Timing::GetTimers() {
+  Timing& timing = Instance();
+  std::lock_guard<std::mutex> lock(timing.mutex_);
+  return timing.tag_map_;
 }
 
 // Class functions used for timing.
@@ -84,12 +237,13 @@ Timer::~Timer() {
 
 void Timer::Start() {
   timing_ = true;
-  time_ = std::chrono::system_clock::now();
+  time_ = std::chrono::steady_clock::now();
 }
 
 void Timer::Stop() {
-  std::chrono::time_point<std::chrono::system_clock> now =
-      std::chrono::system_clock::now();
+  if (!timing_) return;
+  const std::chrono::steady_clock::time_point now =
+      std::chrono::steady_clock::now();
   double dt = std::chrono::duration<double>(now - time_).count();
 
   Timing::Instance().AddTime(handle_, dt);
@@ -99,52 +253,86 @@ void Timer::Stop() {
 bool Timer::IsTiming() const { return timing_; }
 
 void Timing::AddTime(size_t handle, double seconds) {
-  timers_[handle].acc_.Add(seconds);
+  ThreadAccumulators& thread = GetThreadAccumulators();
+  std::lock_guard<std::mutex> lock(thread.mutex);
+  if (handle >= thread.accumulators.size()) {
+    thread.accumulators.resize(handle + 1);
+  }
+  thread.accumulators[handle].Add(seconds);
+}
+
+Accumulator Timing::GetAccumulator(size_t handle) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Accumulator accumulator;
+  if (handle < retired_.size()) {
+    accumulator.Merge(retired_[handle]);
+  }
+  for (ThreadAccumulators* thread : threads_) {
+    std::lock_guard<std::mutex> thread_lock(thread->mutex);
+    if (handle < thread->accumulators.size()) {
+      accumulator.Merge(thread->accumulators[handle]);
+    }
+  }
+  return accumulator;
 }
 
 double Timing::GetTotalSeconds(size_t handle) {
-  return Instance().timers_[handle].acc_.Sum();
+  return Instance().GetAccumulator(handle).Sum();
 }
 double Timing::GetTotalSeconds(std::string const& tag) {
   return GetTotalSeconds(GetHandle(tag));
 }
 double Timing::GetMeanSeconds(size_t handle) {
-  return Instance().timers_[handle].acc_.Mean();
+  return Instance().GetAccumulator(handle).Mean();
 }
 double Timing::GetMeanSeconds(std::string const& tag) {
   return GetMeanSeconds(GetHandle(tag));
 }
 size_t Timing::GetNumSamples(size_t handle) {
-  return Instance().timers_[handle].acc_.TotalSamples();
+  return Instance().GetAccumulator(handle).TotalSamples();
 }
 size_t Timing::GetNumSamples(std::string const& tag) {
   return GetNumSamples(GetHandle(tag));
 }
 double Timing::GetVarianceSeconds(size_t handle) {
-  return Instance().timers_[handle].acc_.LazyVariance();
+  return Instance().GetAccumulator(handle).Variance();
 }
 double Timing::GetVarianceSeconds(std::string const& tag) {
   return GetVarianceSeconds(GetHandle(tag));
 }
 double Timing::GetMinSeconds(size_t handle) {
-  return Instance().timers_[handle].acc_.Min();
+  return Instance().GetAccumulator(handle).Min();
 }
 double Timing::GetMinSeconds(std::string const& tag) {
   return GetMinSeconds(GetHandle(tag));
 }
 double Timing::GetMaxSeconds(size_t handle) {
-  return Instance().timers_[handle].acc_.Max();
+  return Instance().GetAccumulator(handle).Max();
 }
 double Timing::GetMaxSeconds(std::string const& tag) {
   return GetMaxSeconds(GetHandle(tag));
 }
 
 double Timing::GetHz(size_t handle) {
-  return 1.0 / Instance().timers_[handle].acc_.RollingMean();
+  return 1.0 / Instance().GetAccumulator(handle).Mean();
 }
 
 double Timing::GetHz(std::string const& tag) { return GetHz(GetHandle(tag)); }
 
+double Timing::GetPercentileSeconds(size_t handle, double percentile) {
+  return Instance().GetAccumulator(handle).Percentile(percentile);
+}
+double Timing::GetPercentileSeconds(std::string const& tag,
+                                    double percentile) {
+  return GetPercentileSeconds(GetHandle(tag), percentile);
+}
+Histogram Timing::GetHistogram(size_t handle) {
+  return Instance().GetAccumulator(handle).GetHistogram();
+}
+Histogram Timing::GetHistogram(std::string const& tag) {
+  return GetHistogram(GetHandle(tag));
+}
+
 std::string Timing::SecondsToTimeString(double seconds) {
   char buffer[256];
   snprintf(buffer, sizeof(buffer), "%09.6f", seconds);
@@ -152,36 +340,45 @@ std::string Timing::SecondsToTimeString(double seconds) {
 }
 
 void Timing::Print(std::ostream& out) {
-  map_t& tagMap = Instance().tag_map_;
+  const map_t tagMap = GetTimers();
 
   if (tagMap.empty()) {
     return;
   }
 
+  size_t max_tag_length = 0;
+  {
+    std::lock_guard<std::mutex> lock(Instance().mutex_);
+    max_tag_length = Instance().max_tag_length_;
+  }
+
   out << "SM Timing\n";
   out << "-----------\n";
-  for (typename map_t::value_type t : tagMap) {
-    size_t i = t.second;
-    out.width((std::streamsize)Instance().max_tag_length_);
+  for (const map_t::value_type& t : tagMap) {
+    const Accumulator accumulator = Instance().GetAccumulator(t.second);
+    out.width((std::streamsize)max_tag_length);
     out.setf(std::ios::left, std::ios::adjustfield);
     out << t.first << "\t";
     out.width(7);
 
     out.setf(std::ios::right, std::ios::adjustfield);
-    out << GetNumSamples(i) << "\t";
-    if (GetNumSamples(i) > 0) {
-      out << SecondsToTimeString(GetTotalSeconds(i)) << "\t";
-      double meansec = GetMeanSeconds(i);
-      double stddev = sqrt(GetVarianceSeconds(i));
+    out << accumulator.TotalSamples() << "\t";
+    if (accumulator.TotalSamples() > 0) {
+      out << SecondsToTimeString(accumulator.Sum()) << "\t";
+      double meansec = accumulator.Mean();
+      double stddev = sqrt(accumulator.Variance());
       out << "(" << SecondsToTimeString(meansec) << " +- ";
       out << SecondsToTimeString(stddev) << ")\t";
 
-      double minsec = GetMinSeconds(i);
-      double maxsec = GetMaxSeconds(i);
+      double minsec = accumulator.Min();
+      double maxsec = accumulator.Max();
 
       // The min or max are out of bounds.
       out << "[" << SecondsToTimeString(minsec) << ","
-          << SecondsToTimeString(maxsec) << "]";
+          << SecondsToTimeString(maxsec) << "]\t";
+      out << "{p95 " << SecondsToTimeString(accumulator.Percentile(95.0))
+          << ", p99 " << SecondsToTimeString(accumulator.Percentile(99.0))
+          << "}";
     }
     out << std::endl;
   }
@@ -192,7 +389,16 @@ std::string Timing::Print() {
   return ss.str();
 }
 
-void Timing::Reset() { Instance().tag_map_.clear(); }
+void Timing::Reset() {
+  // Keep the tags such that registered handles stay valid.
+  Timing& timing = Instance();
+  std::lock_guard<std::mutex> lock(timing.mutex_);
+  timing.retired_.clear();
+  for (ThreadAccumulators* thread : timing.threads_) {
+    std::lock_guard<std::mutex> thread_lock(thread->mutex);
+    thread->accumulators.clear();
+  }
+}
 
 }  // namespace timing
 } // namespace polygon_coverage_planning
@@ -0,0 +1,178 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "polygon_coverage_planners/tracing.h"
+
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+
+#include <ros/console.h>
+
+namespace polygon_coverage_planning {
+namespace tracing {
+namespace {
+struct Recorder {
+  std::atomic<bool> is_recording{false};
+  std::atomic<Hook*> hook{nullptr};
+  std::mutex mutex;  // Guards origin and events.
+  std::chrono::steady_clock::time_point origin;
+  std::vector<Trace::Event> events;
+};
+
+Recorder& getRecorder() {
+  static Recorder recorder;
+  return recorder;
+}
+
+// Small, stable thread ids in order of the first span of each thread.
+size_t getThreadId() {
+  static std::atomic<size_t> next_id{0};
+  thread_local const size_t id = next_id++;
+  return id;
+}
+
+void writeString(const char* s, std::ostream& out) {
+  out << '"';
+  for (; *s != '\0'; ++s) {
+    if (*s == '"' || *s == '\\') {
+      out << '\\';
+    }
+    out << *s;
+  }
+  out << '"';
+}
+}  // namespace
+
+void Trace::Start() {
+  Recorder& recorder = getRecorder();
+  std::lock_guard<std::mutex> lock(recorder.mutex);
+  recorder.events.clear();
+  recorder.origin = std::chrono::steady_clock::now();
+  recorder.is_recording = true;
+}
+
+void Trace::Stop() { getRecorder().is_recording = false; }
+
+bool Trace::IsRecording() {
+  return getRecorder().is_recording.load(std::memory_order_relaxed);
+}
+
+void Trace::SetHook(Hook* hook) {
+  getRecorder().hook.store(hook, std::memory_order_release);
+}
+
+Hook* Trace::GetHook() {
+  return getRecorder().hook.load(std::memory_order_acquire);
+}
+
+size_t Trace::GetNumSpans() {
+  Recorder& recorder = getRecorder();
+  std::lock_guard<std::mutex> lock(recorder.mutex);
+  return recorder.events.size();
+}
+
+void Trace::Add(Event* event,
+                const std::chrono::steady_clock::time_point& start,
+                const std::chrono::steady_clock::time_point& end) {
+  Recorder& recorder = getRecorder();
+  event->thread = getThreadId();
+  std::lock_guard<std::mutex> lock(recorder.mutex);
+  if (!recorder.is_recording || start < recorder.origin) {
+    return;  // Span started before the current recording.
+  }
+  event->start_us =
+      std::chrono::duration<double, std::micro>(start - recorder.origin)
+          .count();
+  event->duration_us =
+      std::chrono::duration<double, std::micro>(end - start).count();
+  recorder.events.push_back(std::move(*event));
+}
+
+void Trace::Write(std::ostream& out) {
+  Recorder& recorder = getRecorder();
+  std::lock_guard<std::mutex> lock(recorder.mutex);
+  const std::ios::fmtflags flags = out.flags();
+  const std::streamsize precision = out.precision();
+  out << std::fixed << std::setprecision(3);
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  for (size_t i = 0; i < recorder.events.size(); ++i) {
+    const Event& event = recorder.events[i];
+    out << (i == 0 ? "\n" : ",\n") << "{\"name\":";
+    writeString(event.name, out);
+    out << ",\"cat\":\"polygon_coverage\",\"ph\":\"X\",\"pid\":0,\"tid\":"
+        << event.thread << ",\"ts\":" << event.start_us
+        << ",\"dur\":" << event.duration_us << ",\"args\":{";
+    for (size_t j = 0; j < event.args.size(); ++j) {
+      if (j > 0) out << ",";
+      writeString(event.args[j].first, out);
+      out << ":" << event.args[j].second;
+    }
+    out << "}}";
+  }
+  out << "\n]}\n";
+  out.flags(flags);
+  out.precision(precision);
+}
+
+bool Trace::Save(const std::string& file) {
+  std::ofstream out(file);
+  if (!out.is_open()) {
+    ROS_ERROR_STREAM("Cannot open trace file " << file);
+    return false;
+  }
+  Write(out);
+  ROS_INFO_STREAM("Saved " << GetNumSpans() << " trace spans to " << file);
+  return out.good();
+}
+
+Span::Span(const char* name)
+    : is_recording_(Trace::IsRecording()), hook_(Trace::GetHook()) {
+  event_.name = name;
+  if (hook_) {
+    hook_->Begin(name);
+  }
+  if (is_recording_) {
+    start_ = std::chrono::steady_clock::now();
+  }
+}
+
+Span::~Span() { End(); }
+
+Span& Span::Set(const char* key, double value) {
+  if (is_recording_) {
+    event_.args.emplace_back(key, value);
+  }
+  return *this;
+}
+
+void Span::End() {
+  if (hook_) {
+    hook_->End(event_.name);
+    hook_ = nullptr;
+  }
+  if (!is_recording_) return;
+  is_recording_ = false;
+  Trace::Add(&event_, start_, std::chrono::steady_clock::now());
+}
+
+}  // namespace tracing
+}  // namespace polygon_coverage_planning
@@ -17,7 +17,16 @@
  * this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
 #include <cstdlib>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
 
 #include <CGAL/Random.h>
 #include <gtest/gtest.h>
@@ -28,10 +37,19 @@
 
 #include "polygon_coverage_planners/cost_functions/path_cost_functions.h"
 #include "polygon_coverage_planners/graphs/sweep_plan_graph.h"
+#include "polygon_coverage_planners/memory.h"
+#include "polygon_coverage_planners/planners/batch_planner.h"
 #include "polygon_coverage_planners/planners/polygon_stripmap_planner.h"
+#include "polygon_coverage_planners/planners/polygon_stripmap_planner_anytime.h"
 #include "polygon_coverage_planners/planners/polygon_stripmap_planner_exact.h"
 #include "polygon_coverage_planners/planners/polygon_stripmap_planner_exact_preprocessed.h"
+#include "polygon_coverage_planners/planners/polygon_stripmap_planner_held_karp.h"
+#include "polygon_coverage_planners/planners/polygon_stripmap_planner_hierarchical.h"
+#include "polygon_coverage_planners/planners/region_planner.h"
+#include "polygon_coverage_planners/result_cache.h"
 #include "polygon_coverage_planners/sensor_models/frustum.h"
+#include "polygon_coverage_planners/timing.h"
+#include "polygon_coverage_planners/tracing.h"
 
 using namespace polygon_coverage_planning;
 
@@ -49,6 +67,46 @@ const int kNumPolygons = 1e2;
 const size_t kSeed = 123456;
 const double kNear = 1e-3;
 
+// The settings shared by the planner tests.
+sweep_plan_graph::SweepPlanGraph::Settings createTestSettings(
+    const PolygonWithHoles& polygon) {
+  sweep_plan_graph::SweepPlanGraph::Settings settings;
+  settings.polygon = polygon;
+  settings.cost_function =
+      std::bind(&computeEuclideanPathCost, std::placeholders::_1);
+  settings.sensor_model = std::make_shared<Frustum>(10.0, M_PI / 2.0, 0.5);
+  settings.decomposition_type = DecompositionType::kBCD;
+  settings.offset_polygons = false;
+  return settings;
+}
+
+// A width x 20 rectangle with a notch in the middle of its top edge.
+sweep_plan_graph::SweepPlanGraph::Settings createNotchedRectangleSettings(
+    double width = 40.0) {
+  Polygon_2 outer;
+  outer.push_back(Point_2(0.0, 0.0));
+  outer.push_back(Point_2(width, 0.0));
+  outer.push_back(Point_2(width, 20.0));
+  outer.push_back(Point_2(width / 2.0, 10.0));
+  outer.push_back(Point_2(0.0, 20.0));
+  return createTestSettings(PolygonWithHoles(outer));
+}
+
+// A 40 x 20 rectangle with two deep notches in its top edge, which decomposes
+// into several cells.
+sweep_plan_graph::SweepPlanGraph::Settings
+createDoubleNotchedRectangleSettings() {
+  Polygon_2 outer;
+  outer.push_back(Point_2(0.0, 0.0));
+  outer.push_back(Point_2(40.0, 0.0));
+  outer.push_back(Point_2(40.0, 20.0));
+  outer.push_back(Point_2(30.0, 5.0));
+  outer.push_back(Point_2(20.0, 20.0));
+  outer.push_back(Point_2(10.0, 5.0));
+  outer.push_back(Point_2(0.0, 20.0));
+  return createTestSettings(PolygonWithHoles(outer));
+}
+
 // Given a set of polygons run all planners.
 void runPlanners(const std::vector<PolygonWithHoles>& polygons) {
   for (const PolygonWithHoles& p : polygons) {
@@ -72,16 +130,19 @@ void runPlanners(const std::vector<PolygonWithHoles>& polygons) {
     PolygonStripmapPlannerExact planner_exact(settings);
     PolygonStripmapPlannerExactPreprocessed planner_exact_preprocessed(
         settings);
+    PolygonStripmapPlannerHeldKarp planner_held_karp(settings);
 
     EXPECT_TRUE(planner_gk_ma.setup());
     EXPECT_TRUE(planner_exact.setup());
     EXPECT_TRUE(planner_exact_preprocessed.setup());
+    EXPECT_TRUE(planner_held_karp.setup());
     EXPECT_TRUE(planner_gk_ma.isInitialized());
     EXPECT_TRUE(planner_exact.isInitialized());
     EXPECT_TRUE(planner_exact_preprocessed.isInitialized());
+    EXPECT_TRUE(planner_held_karp.isInitialized());
 
     std::vector<Point_2> waypoints_gk_ma, waypoints_exact,
-        waypoints_exact_preprocessed;
+        waypoints_exact_preprocessed, waypoints_held_karp;
     Point_2 start = Point_2(CGAL::ORIGIN);
     Point_2 goal = Point_2(CGAL::ORIGIN);
 
@@ -89,10 +150,12 @@ void runPlanners(const std::vector<PolygonWithHoles>& polygons) {
     EXPECT_TRUE(planner_exact.solve(start, goal, &waypoints_exact));
     EXPECT_TRUE(planner_exact_preprocessed.solve(
         start, goal, &waypoints_exact_preprocessed));
+    EXPECT_TRUE(planner_held_karp.solve(start, goal, &waypoints_held_karp));
 
     EXPECT_LT(static_cast<size_t>(2), waypoints_gk_ma.size());
     EXPECT_LT(static_cast<size_t>(2), waypoints_exact.size());
     EXPECT_LT(static_cast<size_t>(2), waypoints_exact_preprocessed.size());
+    EXPECT_LT(static_cast<size_t>(2), waypoints_held_karp.size());
 
     // Start and goal may lie outside of polygon.
     EXPECT_TRUE(pointsInPolygon(settings.polygon,
@@ -108,11 +171,269 @@ void runPlanners(const std::vector<PolygonWithHoles>& polygons) {
     EXPECT_GT(settings.cost_function(waypoints_exact), 0.0);
     EXPECT_EQ(settings.cost_function(waypoints_exact),
               settings.cost_function(waypoints_exact_preprocessed));
+    EXPECT_NEAR(settings.cost_function(waypoints_exact),
+                settings.cost_function(waypoints_held_karp), kNear);
     EXPECT_GE(settings.cost_function(waypoints_gk_ma) + kNear,
               settings.cost_function(waypoints_exact));
+
+    // An expired deadline aborts the exact searches. The heuristic still
+    // returns its best tour.
+    std::atomic<bool> is_cancelled(true);
+    const Deadline expired(0.0, &is_cancelled);
+    std::vector<Point_2> waypoints_expired;
+    EXPECT_TRUE(planner_gk_ma.solve(start, goal, &waypoints_expired, expired));
+    EXPECT_LT(static_cast<size_t>(2), waypoints_expired.size());
+    EXPECT_FALSE(planner_exact.solve(start, goal, &waypoints_expired, expired));
+    EXPECT_FALSE(planner_exact_preprocessed.solve(start, goal,
+                                                  &waypoints_expired, expired));
+    EXPECT_FALSE(
+        planner_held_karp.solve(start, goal, &waypoints_expired, expired));
+    EXPECT_TRUE(planner_exact.solve(start, goal, &waypoints_expired,
+                                    Deadline(60.0)));
+
+    // The anytime planner refines the heuristic solution to the exact cost.
+    size_t num_callbacks = 0;
+    PolygonStripmapPlannerAnytime planner_anytime(
+        settings,
+        [&num_callbacks](const std::vector<Point_2>&) { ++num_callbacks; });
+    EXPECT_TRUE(planner_anytime.setup());
+    std::vector<Point_2> waypoints_anytime, waypoints_refined;
+    EXPECT_TRUE(planner_anytime.solve(start, goal, &waypoints_anytime));
+    EXPECT_LT(static_cast<size_t>(2), waypoints_anytime.size());
+    const bool is_refined =
+        planner_anytime.waitForRefinement(&waypoints_refined);
+    EXPECT_EQ(is_refined ? 1u : 0u, num_callbacks);
+    if (is_refined) {
+      EXPECT_LT(settings.cost_function(waypoints_refined),
+                settings.cost_function(waypoints_anytime));
+      waypoints_anytime = waypoints_refined;
+    }
+    EXPECT_NEAR(settings.cost_function(waypoints_exact),
+                settings.cost_function(waypoints_anytime), kNear);
   }
 }
 
+TEST(TimingTest, WorkerThreads) {
+  static const size_t kHandle = timing::Timing::GetHandle("test_worker");
+  EXPECT_EQ(kHandle, timing::Timing::GetHandle("test_worker"));
+  EXPECT_EQ("test_worker", timing::Timing::GetTag(kHandle));
+
+  // Samples of exited threads are kept.
+  const size_t kNumThreads = 4;
+  const size_t kNumSamples = 100;
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([] {
+      for (size_t j = 0; j < kNumSamples; ++j) {
+        timing::Timer timer(kHandle);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(kNumThreads * kNumSamples, timing::Timing::GetNumSamples(kHandle));
+  EXPECT_LE(0.0, timing::Timing::GetMinSeconds(kHandle));
+  EXPECT_LE(timing::Timing::GetMinSeconds(kHandle),
+            timing::Timing::GetMaxSeconds(kHandle));
+
+  // Reset keeps the handle.
+  timing::Timing::Reset();
+  EXPECT_EQ(0u, timing::Timing::GetNumSamples(kHandle));
+  { timing::Timer timer(kHandle); }
+  EXPECT_EQ(1u, timing::Timing::GetNumSamples("test_worker"));
+}
+
+TEST(TimingTest, Percentiles) {
+  // 1 ms to 100 ms.
+  timing::Accumulator accumulator;
+  for (size_t i = 1; i <= 100; ++i) {
+    accumulator.Add(i * 1.0e-3);
+  }
+  const double kRelativeError = 1.0 / timing::Histogram::kNumSubBuckets;
+  EXPECT_NEAR(50.0e-3, accumulator.Percentile(50.0), 50.0e-3 * kRelativeError);
+  EXPECT_NEAR(95.0e-3, accumulator.Percentile(95.0), 95.0e-3 * kRelativeError);
+  EXPECT_NEAR(99.0e-3, accumulator.Percentile(99.0), 99.0e-3 * kRelativeError);
+  EXPECT_DOUBLE_EQ(accumulator.Min(), accumulator.Percentile(0.0));
+  EXPECT_DOUBLE_EQ(accumulator.Max(), accumulator.Percentile(100.0));
+
+  // Histograms merge exactly.
+  timing::Accumulator first, second;
+  for (size_t i = 1; i <= 100; ++i) {
+    (i % 2 ? first : second).Add(i * 1.0e-3);
+  }
+  first.Merge(second);
+  EXPECT_EQ(accumulator.GetHistogram().GetBuckets(),
+            first.GetHistogram().GetBuckets());
+
+  // Out of range durations are clamped to the first and last bucket.
+  EXPECT_EQ(0u, timing::Histogram::GetBucketIndex(0.0));
+  EXPECT_EQ(timing::Histogram::kNumBuckets - 1,
+            timing::Histogram::GetBucketIndex(1.0e9));
+}
+
+TEST(TracingTest, PlannerSpans) {
+  sweep_plan_graph::SweepPlanGraph::Settings settings =
+      createNotchedRectangleSettings();
+
+  // Nothing is recorded by default.
+  EXPECT_FALSE(tracing::Trace::IsRecording());
+  { tracing::Span span("unrecorded"); }
+  EXPECT_EQ(0u, tracing::Trace::GetNumSpans());
+
+  tracing::Trace::Start();
+  PolygonStripmapPlanner planner(settings);
+  EXPECT_TRUE(planner.setup());
+  std::vector<Point_2> waypoints;
+  EXPECT_TRUE(planner.solve(Point_2(1.0, 1.0), Point_2(39.0, 1.0), &waypoints));
+  tracing::Trace::Stop();
+  const size_t num_spans = tracing::Trace::GetNumSpans();
+  EXPECT_LT(0u, num_spans);
+  { tracing::Span span("unrecorded"); }
+  EXPECT_EQ(num_spans, tracing::Trace::GetNumSpans());
+
+  std::stringstream trace;
+  tracing::Trace::Write(trace);
+  for (const char* name : {"setup", "decomposition", "sweeps", "pruning",
+                           "edge_creation", "solve", "gtsp_solve"}) {
+    EXPECT_NE(std::string::npos,
+              trace.str().find("\"name\":\"" + std::string(name) + "\""))
+        << name;
+  }
+  EXPECT_NE(std::string::npos, trace.str().find("\"cluster\":"));
+}
+
+TEST(TracingTest, Hook) {
+  // Counts the open and closed spans per name.
+  class CountingHook : public tracing::Hook {
+   public:
+    void Begin(const char* name) override {
+      std::lock_guard<std::mutex> lock(mutex);
+      ++begins[name];
+    }
+    void End(const char* name) override {
+      std::lock_guard<std::mutex> lock(mutex);
+      ++ends[name];
+    }
+    std::mutex mutex;
+    std::map<std::string, size_t> begins, ends;
+  };
+
+  Polygon_2 outer;
+  outer.push_back(Point_2(0.0, 0.0));
+  outer.push_back(Point_2(40.0, 0.0));
+  outer.push_back(Point_2(40.0, 20.0));
+  outer.push_back(Point_2(0.0, 20.0));
+  sweep_plan_graph::SweepPlanGraph::Settings settings =
+      createTestSettings(PolygonWithHoles(outer));
+  settings.num_threads = 2;
+
+  // Hooks are called without recording a trace.
+  CountingHook hook;
+  tracing::Trace::SetHook(&hook);
+  EXPECT_EQ(&hook, tracing::Trace::GetHook());
+  PolygonStripmapPlanner planner(settings);
+  EXPECT_TRUE(planner.setup());
+  std::vector<Point_2> waypoints;
+  EXPECT_TRUE(planner.solve(Point_2(1.0, 1.0), Point_2(39.0, 1.0), &waypoints));
+  tracing::Trace::SetHook(nullptr);
+  { tracing::Span span("unhooked"); }
+
+  EXPECT_FALSE(tracing::Trace::IsRecording());
+  EXPECT_EQ(hook.begins, hook.ends);
+  for (const char* name : {"setup", "sweep_plan_graph", "setup_solver",
+                           "solve", "gtsp_solve"}) {
+    EXPECT_EQ(1u, hook.begins[name]) << name;
+  }
+  EXPECT_EQ(0u, hook.begins.count("unhooked"));
+}
+
+TEST(MemoryTest, PlannerStages) {
+  sweep_plan_graph::SweepPlanGraph::Settings settings =
+      createNotchedRectangleSettings();
+
+  memory::Memory::Reset();
+  EXPECT_EQ(0u, memory::Memory::GetBytes("sweep_plan_graph.nodes"));
+  PolygonStripmapPlanner planner(settings);
+  EXPECT_TRUE(planner.setup());
+
+  EXPECT_EQ(planner.getNumberOfNodes(),
+            memory::Memory::GetCount("sweep_plan_graph.nodes"));
+  EXPECT_EQ(planner.getNumberOfEdges(),
+            memory::Memory::GetCount("sweep_plan_graph.edges"));
+  for (const char* tag :
+       {"sweep_plan_graph.nodes", "sweep_plan_graph.edges",
+        "sweep_plan_graph.visibility_polygons", "sweep_plan_graph.query_cache",
+        "visibility_graph"}) {
+    EXPECT_LT(0u, memory::Memory::GetBytes(tag)) << tag;
+  }
+  // The peak RSS never decreases between phases.
+  const size_t rss_decomposition =
+      memory::Memory::GetBytes("peak_rss.decomposition");
+  EXPECT_LT(0u, rss_decomposition);
+  EXPECT_LE(rss_decomposition, memory::Memory::GetBytes("peak_rss.sweeps"));
+  EXPECT_LE(memory::Memory::GetBytes("peak_rss.sweeps"),
+            memory::Memory::GetBytes("peak_rss.sweep_plan_graph"));
+  EXPECT_NE(std::string::npos,
+            memory::Memory::Print().find("sweep_plan_graph.edges"));
+}
+
+TEST(PathCostTest, Kernels) {
+  const std::vector<Point_2> path = {Point_2(0.0, 0.0), Point_2(3.0, 4.0),
+                                     Point_2(3.0, 4.5), Point_2(-10.0, 4.5)};
+  const double kVMax = 3.0;
+  const double kAMax = 1.0;
+
+  // Built-in cost functions are recognized. Custom ones are not.
+  const PathCostFunction distance =
+      makePathCostFunction(CostFunctionType::kDistance);
+  const PathCostFunction velocity_ramp =
+      makePathCostFunction(CostFunctionType::kTime, kVMax, kAMax);
+  const PathCostFunction waypoints =
+      makePathCostFunction(CostFunctionType::kWaypoints);
+  const PathCostFunction custom =
+      std::bind(&computeEuclideanPathCost, std::placeholders::_1);
+  ASSERT_NE(nullptr, getPathCostKernel(distance));
+  ASSERT_NE(nullptr, getPathCostKernel(velocity_ramp));
+  ASSERT_NE(nullptr, getPathCostKernel(waypoints));
+  EXPECT_EQ(nullptr, getPathCostKernel(custom));
+  EXPECT_EQ(CostFunctionType::kTime,
+            getPathCostKernel(velocity_ramp)->getType());
+
+  // Path costs.
+  EXPECT_NEAR(5.0 + 0.5 + 13.0, distance(path), kNear);
+  EXPECT_NEAR(custom(path), distance(path), kNear);
+  double expected_time = 0.0;
+  for (size_t i = 0; i + 1 < path.size(); ++i) {
+    expected_time +=
+        computeVelocityRampSegmentCost(path[i], path[i + 1], kVMax, kAMax);
+  }
+  EXPECT_NEAR(expected_time, velocity_ramp(path), kNear);
+  EXPECT_NEAR(expected_time,
+              computeVelocityRampPathCost(path, kVMax, kAMax), kNear);
+  EXPECT_EQ(4.0, waypoints(path));
+  EXPECT_EQ(0.0, distance(std::vector<Point_2>()));
+
+  // Segment costs equal the cost of the two point path.
+  for (const PathCostFunction& cost_function :
+       {distance, velocity_ramp, waypoints, custom}) {
+    EXPECT_NEAR(cost_function({path[0], path[1]}),
+                computeSegmentCost(cost_function, path[0], path[1]), kNear);
+  }
+  EXPECT_NEAR(computeVelocityRampSegmentCost(path[2], path[3], kVMax, kAMax),
+              getPathCostKernel(velocity_ramp)->computeSegmentCost(-13.0, 0.0),
+              kNear);
+
+  // Nodes cache the double endpoints of their waypoints.
+  sweep_plan_graph::NodeProperty node(path, distance, 0,
+                                      std::vector<Polygon_2>());
+  EXPECT_NEAR(distance(path), node.cost, kNear);
+  EXPECT_EQ(0.0, node.front_x);
+  EXPECT_EQ(0.0, node.front_y);
+  EXPECT_EQ(-10.0, node.back_x);
+  EXPECT_EQ(4.5, node.back_y);
+}
+
 TEST(StripmapPlannerTest, RandomConvexPolygon) {
   std::srand(kSeed);
   std::vector<PolygonWithHoles> polygons(kNumPolygons);
@@ -147,6 +468,490 @@ TEST(StripmapPlannerTest, RandomSimplePolygon) {
   runPlanners(polygons);
 }
 
+TEST(StripmapPlannerTest, IncrementalUpdate) {
+  Polygon_2 outer;
+  outer.push_back(Point_2(0.0, 0.0));
+  outer.push_back(Point_2(40.0, 0.0));
+  outer.push_back(Point_2(40.0, 20.0));
+  outer.push_back(Point_2(0.0, 20.0));
+  Polygon_2 hole;
+  hole.push_back(Point_2(30.0, 8.0));
+  hole.push_back(Point_2(30.0, 12.0));
+  hole.push_back(Point_2(34.0, 12.0));
+  hole.push_back(Point_2(34.0, 8.0));
+  PolygonWithHoles edited(outer);
+  edited.add_hole(hole);
+
+  sweep_plan_graph::SweepPlanGraph::Settings settings =
+      createTestSettings(PolygonWithHoles(outer));
+
+  // Add a hole to the polygon of a planner and compare it to a new planner.
+  PolygonStripmapPlannerExact planner_updated(settings);
+  EXPECT_TRUE(planner_updated.setup());
+  EXPECT_TRUE(planner_updated.update(edited));
+  EXPECT_TRUE(planner_updated.isInitialized());
+
+  settings.polygon = edited;
+  PolygonStripmapPlannerExact planner_created(settings);
+  EXPECT_TRUE(planner_created.setup());
+
+  const Point_2 start(1.0, 1.0);
+  const Point_2 goal(39.0, 19.0);
+  std::vector<Point_2> waypoints_updated, waypoints_created;
+  EXPECT_TRUE(planner_updated.solve(start, goal, &waypoints_updated));
+  EXPECT_TRUE(planner_created.solve(start, goal, &waypoints_created));
+  EXPECT_TRUE(pointsInPolygon(edited, waypoints_updated.begin(),
+                              waypoints_updated.end()));
+  EXPECT_NEAR(settings.cost_function(waypoints_created),
+              settings.cost_function(waypoints_updated), kNear);
+}
+
+TEST(StripmapPlannerTest, CompactStorage) {
+  sweep_plan_graph::SweepPlanGraph::Settings settings =
+      createNotchedRectangleSettings();
+
+  PolygonStripmapPlannerExact planner_stored(settings);
+  settings.store_edge_waypoints = false;
+  PolygonStripmapPlannerExact planner_lazy(settings);
+  settings.store_visibility_polygons = false;
+  PolygonStripmapPlannerExact planner_compact(settings);
+  EXPECT_TRUE(planner_stored.setup());
+  EXPECT_TRUE(planner_lazy.setup());
+  EXPECT_TRUE(planner_compact.setup());
+
+  const Point_2 start(1.0, 1.0);
+  const Point_2 goal(39.0, 1.0);
+  std::vector<Point_2> waypoints_stored, waypoints_lazy, waypoints_compact;
+  EXPECT_TRUE(planner_stored.solve(start, goal, &waypoints_stored));
+  EXPECT_TRUE(planner_lazy.solve(start, goal, &waypoints_lazy));
+  EXPECT_TRUE(planner_compact.solve(start, goal, &waypoints_compact));
+  EXPECT_EQ(waypoints_stored, waypoints_lazy);
+  EXPECT_EQ(waypoints_stored, waypoints_compact);
+}
+
+TEST(StripmapPlannerTest, ReverseSearch) {
+  sweep_plan_graph::SweepPlanGraph::Settings settings =
+      createNotchedRectangleSettings();
+
+  PolygonStripmapPlannerExact planner_forwards(settings);
+  settings.reverse_search = true;
+  PolygonStripmapPlannerExact planner_reverse(settings);
+  PolygonStripmapPlannerExactPreprocessed planner_reverse_preprocessed(
+      settings);
+  EXPECT_TRUE(planner_forwards.setup());
+  EXPECT_TRUE(planner_reverse.setup());
+  EXPECT_TRUE(planner_reverse_preprocessed.setup());
+
+  // Changing starts reuse the tree of the goal. A new goal replaces it.
+  const std::vector<Point_2> starts = {Point_2(1.0, 1.0), Point_2(20.0, 2.0),
+                                       Point_2(39.0, 19.0)};
+  const std::vector<Point_2> goals = {Point_2(39.0, 1.0), Point_2(1.0, 19.0)};
+  for (const Point_2& goal : goals) {
+    for (const Point_2& start : starts) {
+      std::vector<Point_2> waypoints_forwards, waypoints_reverse,
+          waypoints_reverse_preprocessed;
+      EXPECT_TRUE(planner_forwards.solve(start, goal, &waypoints_forwards));
+      EXPECT_TRUE(planner_reverse.solve(start, goal, &waypoints_reverse));
+      EXPECT_TRUE(planner_reverse_preprocessed.solve(
+          start, goal, &waypoints_reverse_preprocessed));
+      EXPECT_EQ(start, waypoints_reverse.front());
+      EXPECT_EQ(goal, waypoints_reverse.back());
+      EXPECT_NEAR(settings.cost_function(waypoints_forwards),
+                  settings.cost_function(waypoints_reverse), kNear);
+      EXPECT_NEAR(settings.cost_function(waypoints_forwards),
+                  settings.cost_function(waypoints_reverse_preprocessed),
+                  kNear);
+    }
+  }
+}
+
+TEST(StripmapPlannerTest, WaypointSegments) {
+  sweep_plan_graph::SweepPlanGraph::Settings settings =
+      createNotchedRectangleSettings();
+  settings.store_edge_waypoints = false;
+
+  sweep_plan_graph::SweepPlanGraph sweep_plan_graph(settings);
+  ASSERT_TRUE(sweep_plan_graph.isInitialized());
+  sweep_plan_graph::Overlay overlay;
+  ASSERT_TRUE(sweep_plan_graph.createOverlay(Point_2(1.0, 1.0),
+                                             Point_2(39.0, 1.0), &overlay));
+
+  // Visit the first sweep of every cluster.
+  std::vector<std::vector<int>> clusters;
+  ASSERT_TRUE(sweep_plan_graph.getClusters(&clusters));
+  Solution solution({overlay.getStartIdx()});
+  for (const std::vector<int>& cluster : clusters) {
+    ASSERT_FALSE(cluster.empty());
+    solution.push_back(static_cast<size_t>(cluster.front()));
+  }
+  solution.push_back(overlay.getGoalIdx());
+
+  // The concatenated segments equal the waypoints.
+  std::vector<Point_2> waypoints, concatenated;
+  size_t num_segments = 0;
+  EXPECT_TRUE(sweep_plan_graph.getWaypoints(overlay, solution, &waypoints));
+  EXPECT_TRUE(sweep_plan_graph.forEachWaypointSegment(
+      overlay, solution,
+      [&](std::vector<Point_2>::const_iterator begin,
+          std::vector<Point_2>::const_iterator end) {
+        EXPECT_TRUE(begin < end);
+        concatenated.insert(concatenated.end(), begin, end);
+        ++num_segments;
+        return true;
+      }));
+  EXPECT_EQ(waypoints, concatenated);
+  EXPECT_LT(clusters.size(), num_segments);
+
+  // The visitor aborts the traversal.
+  num_segments = 0;
+  EXPECT_FALSE(sweep_plan_graph.forEachWaypointSegment(
+      overlay, solution,
+      [&num_segments](std::vector<Point_2>::const_iterator,
+                      std::vector<Point_2>::const_iterator) {
+        ++num_segments;
+        return false;
+      }));
+  EXPECT_EQ(1u, num_segments);
+}
+
+TEST(StripmapPlannerTest, ProductGraphMemoryBudget) {
+  sweep_plan_graph::SweepPlanGraph::Settings settings =
+      createNotchedRectangleSettings();
+
+  // The estimate matches the precomputed product graph.
+  sweep_plan_graph::SweepPlanGraph sweep_plan_graph(settings);
+  ASSERT_TRUE(sweep_plan_graph.isInitialized());
+  gtspp_product_graph::MemoryEstimate estimate;
+  ASSERT_TRUE(gtspp_product_graph::GtsppProductGraph::estimateMemory(
+      sweep_plan_graph, true, &estimate));
+  gtspp_product_graph::GtsppProductGraph product_graph(&sweep_plan_graph);
+  ASSERT_TRUE(product_graph.create());
+  EXPECT_EQ(estimate.num_nodes, product_graph.size() + 4);
+  EXPECT_EQ(estimate.num_edges, product_graph.getNumberOfEdges());
+
+  const Point_2 start(1.0, 1.0);
+  const Point_2 goal(39.0, 1.0);
+  PolygonStripmapPlannerExactPreprocessed planner_unlimited(settings);
+  EXPECT_TRUE(planner_unlimited.setup());
+  EXPECT_FALSE(planner_unlimited.isFallback());
+  std::vector<Point_2> waypoints_unlimited;
+  EXPECT_TRUE(planner_unlimited.solve(start, goal, &waypoints_unlimited));
+
+  // Fall back to the heuristic solver or refuse if the budget is exceeded.
+  settings.product_graph_memory_budget = estimate.getTotalBytes() - 1;
+  PolygonStripmapPlannerExactPreprocessed planner_fallback(settings);
+  EXPECT_TRUE(planner_fallback.setup());
+  EXPECT_TRUE(planner_fallback.isFallback());
+  std::vector<Point_2> waypoints_fallback;
+  EXPECT_TRUE(planner_fallback.solve(start, goal, &waypoints_fallback));
+  EXPECT_GE(settings.cost_function(waypoints_fallback) + kNear,
+            settings.cost_function(waypoints_unlimited));
+
+  settings.product_graph_fallback = false;
+  PolygonStripmapPlannerExactPreprocessed planner_refused(settings);
+  EXPECT_FALSE(planner_refused.setup());
+}
+
+TEST(StripmapPlannerTest, Hierarchical) {
+  sweep_plan_graph::SweepPlanGraph::Settings settings =
+      createDoubleNotchedRectangleSettings();
+
+  // Adjacent cells are grouped.
+  sweep_plan_graph::SweepPlanGraph sweep_plan_graph(settings);
+  ASSERT_TRUE(sweep_plan_graph.isInitialized());
+  const size_t num_cells = sweep_plan_graph.getDecompositionSize();
+  EXPECT_LT(1u, num_cells);
+  std::vector<std::vector<size_t>> groups;
+  EXPECT_TRUE(sweep_plan_graph.computeCellGroups(num_cells, &groups));
+  EXPECT_EQ(1u, groups.size());
+  EXPECT_TRUE(sweep_plan_graph.computeCellGroups(2, &groups));
+  size_t num_grouped_cells = 0;
+  for (const std::vector<size_t>& group : groups) {
+    EXPECT_GE(2u, group.size());
+    num_grouped_cells += group.size();
+  }
+  EXPECT_EQ(num_cells, num_grouped_cells);
+  EXPECT_FALSE(sweep_plan_graph.computeCellGroups(0, &groups));
+
+  // Exact with a single group. Feasible with single cell groups.
+  const Point_2 start(1.0, 1.0);
+  const Point_2 goal(39.0, 1.0);
+  PolygonStripmapPlannerHeldKarp planner_held_karp(settings);
+  PolygonStripmapPlannerHierarchical planner_one_group(settings);
+  settings.max_group_size = 1;
+  PolygonStripmapPlannerHierarchical planner_single_cells(settings);
+  EXPECT_TRUE(planner_held_karp.setup());
+  EXPECT_TRUE(planner_one_group.setup());
+  EXPECT_TRUE(planner_single_cells.setup());
+  std::vector<Point_2> waypoints_held_karp, waypoints_one_group,
+      waypoints_single_cells;
+  EXPECT_TRUE(planner_held_karp.solve(start, goal, &waypoints_held_karp));
+  EXPECT_TRUE(planner_one_group.solve(start, goal, &waypoints_one_group));
+  EXPECT_TRUE(
+      planner_single_cells.solve(start, goal, &waypoints_single_cells));
+  EXPECT_NEAR(settings.cost_function(waypoints_held_karp),
+              settings.cost_function(waypoints_one_group), kNear);
+  EXPECT_GE(settings.cost_function(waypoints_single_cells) + kNear,
+            settings.cost_function(waypoints_held_karp));
+}
+
+TEST(StripmapPlannerTest, Regions) {
+  sweep_plan_graph::SweepPlanGraph::Settings settings =
+      createDoubleNotchedRectangleSettings();
+  settings.max_region_size = 1;
+
+  // Every cell is a region. The regions cover the field.
+  RegionPlanner planner(settings);
+  ASSERT_TRUE(planner.setup());
+  const std::vector<PolygonWithHoles>& regions = planner.getRegions();
+  EXPECT_LT(1u, regions.size());
+  double area = 0.0;
+  for (const PolygonWithHoles& region : regions) {
+    area += CGAL::to_double(computeArea(region));
+  }
+  EXPECT_NEAR(CGAL::to_double(computeArea(settings.polygon)), area, kNear);
+
+  // One task per region in tour order. Tasks and results survive
+  // serialization, as if they were planned on another host.
+  const Point_2 start(1.0, 1.0);
+  const Point_2 goal(39.0, 1.0);
+  std::vector<RegionTask> tasks;
+  ASSERT_TRUE(planner.createTasks(start, goal, &tasks));
+  ASSERT_EQ(regions.size(), tasks.size());
+  std::vector<RegionResult> results;
+  for (const RegionTask& task : tasks) {
+    std::stringstream task_stream;
+    ASSERT_TRUE(writeRegionTask(task, &task_stream));
+    RegionTask remote_task;
+    ASSERT_TRUE(readRegionTask(&task_stream, &remote_task));
+    EXPECT_EQ(task.region, remote_task.region);
+    EXPECT_EQ(task.start, remote_task.start);
+    EXPECT_EQ(task.goal, remote_task.goal);
+    EXPECT_EQ(task.polygon.outer_boundary(),
+              remote_task.polygon.outer_boundary());
+
+    RegionResult result;
+    result.region = remote_task.region;
+    PolygonStripmapPlanner remote_planner(
+        planner.getRegionSettings(remote_task));
+    result.success = remote_planner.setup() &&
+                     remote_planner.solve(remote_task.start, remote_task.goal,
+                                          &result.solution);
+    EXPECT_TRUE(result.success);
+    std::stringstream result_stream;
+    ASSERT_TRUE(writeRegionResult(result, &result_stream));
+    results.emplace_back();
+    ASSERT_TRUE(readRegionResult(&result_stream, &results.back()));
+    EXPECT_EQ(result.solution, results.back().solution);
+  }
+  std::stringstream corrupt("region_task 1\n0\n1 2\n");
+  RegionTask corrupt_task;
+  EXPECT_FALSE(readRegionTask(&corrupt, &corrupt_task));
+
+  // The stitched tour connects start and goal through all regions. Missing
+  // regions fail.
+  std::vector<Point_2> waypoints, waypoints_local;
+  ASSERT_TRUE(planner.stitch(start, goal, results, &waypoints));
+  EXPECT_EQ(start, waypoints.front());
+  EXPECT_EQ(goal, waypoints.back());
+  for (const Point_2& waypoint : waypoints) {
+    EXPECT_TRUE(pointInPolygon(settings.polygon, waypoint));
+  }
+  EXPECT_TRUE(planner.solve(start, goal, &waypoints_local));
+  EXPECT_EQ(start, waypoints_local.front());
+  EXPECT_EQ(goal, waypoints_local.back());
+  results.pop_back();
+  EXPECT_FALSE(planner.stitch(start, goal, results, &waypoints));
+}
+
+TEST(StripmapPlannerTest, Snapshot) {
+  sweep_plan_graph::SweepPlanGraph::Settings settings =
+      createNotchedRectangleSettings();
+
+  const std::string kSnapshotFile = "sweep_plan_graph_snapshot-test.bin";
+  std::remove(kSnapshotFile.c_str());
+  sweep_plan_graph::SweepPlanGraph created(settings);
+  EXPECT_TRUE(created.isInitialized());
+  EXPECT_TRUE(created.save(kSnapshotFile));
+
+  sweep_plan_graph::SweepPlanGraph loaded;
+  EXPECT_TRUE(loaded.load(settings, kSnapshotFile));
+  EXPECT_EQ(created.size(), loaded.size());
+  EXPECT_EQ(created.getDecompositionSize(), loaded.getDecompositionSize());
+
+  const Point_2 start(1.0, 1.0);
+  const Point_2 goal(39.0, 1.0);
+  std::vector<Point_2> waypoints_created, waypoints_loaded;
+  EXPECT_TRUE(created.solveHeldKarp(start, goal, &waypoints_created));
+  EXPECT_TRUE(loaded.solveHeldKarp(start, goal, &waypoints_loaded));
+  EXPECT_EQ(waypoints_created, waypoints_loaded);
+
+  // A snapshot of other settings is rejected.
+  settings.sweep_single_direction = true;
+  EXPECT_FALSE(loaded.load(settings, kSnapshotFile));
+  EXPECT_FALSE(loaded.isInitialized());
+  std::remove(kSnapshotFile.c_str());
+}
+
+TEST(StripmapPlannerTest, ProductGraphSnapshot) {
+  sweep_plan_graph::SweepPlanGraph::Settings settings =
+      createNotchedRectangleSettings();
+
+  const std::string kProductFile = "gtspp_product_graph_snapshot-test.bin";
+  std::remove(kProductFile.c_str());
+  sweep_plan_graph::SweepPlanGraph sweep_plan_graph(settings);
+  ASSERT_TRUE(sweep_plan_graph.isInitialized());
+  gtspp_product_graph::GtsppProductGraph created(&sweep_plan_graph);
+  ASSERT_TRUE(created.create());
+  EXPECT_TRUE(created.save(kProductFile));
+
+  gtspp_product_graph::GtsppProductGraph loaded(&sweep_plan_graph);
+  EXPECT_TRUE(loaded.load(kProductFile));
+  EXPECT_EQ(created.size(), loaded.size());
+  EXPECT_EQ(created.getNumberOfEdges(), loaded.getNumberOfEdges());
+
+  const Point_2 start(1.0, 1.0);
+  const Point_2 goal(39.0, 1.0);
+  std::vector<Point_2> waypoints_created, waypoints_loaded;
+  EXPECT_TRUE(created.solve(start, goal, &waypoints_created));
+  EXPECT_TRUE(loaded.solve(start, goal, &waypoints_loaded));
+  EXPECT_EQ(waypoints_created, waypoints_loaded);
+
+  // A product graph of another sweep plan graph is rejected.
+  settings.sweep_single_direction = true;
+  sweep_plan_graph::SweepPlanGraph other(settings);
+  ASSERT_TRUE(other.isInitialized());
+  loaded.setSweepPlanGraph(&other);
+  EXPECT_FALSE(loaded.load(kProductFile));
+  EXPECT_FALSE(loaded.isInitialized());
+  std::remove(kProductFile.c_str());
+
+  // The planner caches the product graph next to the sweep plan graph.
+  const std::string kSnapshotFile = "planner_snapshot-test.bin";
+  std::remove(kSnapshotFile.c_str());
+  std::remove((kSnapshotFile + ".product").c_str());
+  PolygonStripmapPlannerExactPreprocessed planner_created(settings);
+  EXPECT_TRUE(planner_created.setup(kSnapshotFile));
+  std::ifstream product_file(kSnapshotFile + ".product");
+  EXPECT_TRUE(product_file.good());
+  PolygonStripmapPlannerExactPreprocessed planner_loaded(settings);
+  EXPECT_TRUE(planner_loaded.setup(kSnapshotFile));
+  waypoints_created.clear();
+  waypoints_loaded.clear();
+  EXPECT_TRUE(planner_created.solve(start, goal, &waypoints_created));
+  EXPECT_TRUE(planner_loaded.solve(start, goal, &waypoints_loaded));
+  EXPECT_EQ(waypoints_created, waypoints_loaded);
+  std::remove(kSnapshotFile.c_str());
+  std::remove((kSnapshotFile + ".product").c_str());
+}
+
+TEST(StripmapPlannerTest, ResultCache) {
+  sweep_plan_graph::SweepPlanGraph::Settings settings =
+      createNotchedRectangleSettings();
+
+  // The key does not depend on the first polygon vertex.
+  sweep_plan_graph::SweepPlanGraph::Settings rotated_settings = settings;
+  const Polygon_2& outer = settings.polygon.outer_boundary();
+  std::vector<Point_2> rotated(outer.vertices_begin(), outer.vertices_end());
+  std::rotate(rotated.begin(), rotated.begin() + 2, rotated.end());
+  rotated_settings.polygon =
+      PolygonWithHoles(Polygon_2(rotated.begin(), rotated.end()));
+  EXPECT_EQ(ResultCache::computeKey(settings),
+            ResultCache::computeKey(rotated_settings));
+  sweep_plan_graph::SweepPlanGraph::Settings other_settings = settings;
+  other_settings.decomposition_type = DecompositionType::kTCD;
+  EXPECT_NE(ResultCache::computeKey(settings),
+            ResultCache::computeKey(other_settings));
+
+  const std::string kCacheFile = "result_cache-test.txt";
+  std::remove(kCacheFile.c_str());
+  PolygonStripmapPlanner planner(settings);
+  EXPECT_TRUE(planner.setup());
+  EXPECT_TRUE(planner.enableResultCache(kCacheFile));
+
+  const Point_2 start(1.0, 1.0);
+  const Point_2 goal(39.0, 1.0);
+  std::vector<Point_2> waypoints, waypoints_cached, waypoints_loaded;
+  EXPECT_TRUE(planner.solve(start, goal, &waypoints));
+  EXPECT_TRUE(planner.solve(start, goal, &waypoints_cached));
+  EXPECT_EQ(waypoints, waypoints_cached);
+
+  // A planner with the persisted cache returns the stored solution.
+  PolygonStripmapPlanner loaded(settings);
+  EXPECT_TRUE(loaded.setup());
+  EXPECT_TRUE(loaded.enableResultCache(kCacheFile));
+  EXPECT_TRUE(loaded.solve(start, goal, &waypoints_loaded));
+  EXPECT_EQ(waypoints, waypoints_loaded);
+
+  ResultCache cache;
+  EXPECT_TRUE(cache.load(kCacheFile));
+  EXPECT_EQ(1u, cache.size());
+  const ResultCache::Key key = ResultCache::createKey(rotated_settings);
+  EXPECT_TRUE(cache.find(key, "heuristic", start, goal, &waypoints_loaded));
+  EXPECT_EQ(waypoints, waypoints_loaded);
+
+  // Other planners and polygons with a colliding hash do not match.
+  PolygonStripmapPlannerExact exact(settings);
+  EXPECT_TRUE(exact.setup());
+  EXPECT_TRUE(exact.enableResultCache(kCacheFile));
+  std::vector<Point_2> waypoints_exact;
+  EXPECT_TRUE(exact.solve(start, goal, &waypoints_exact));
+  EXPECT_TRUE(cache.load(kCacheFile));
+  EXPECT_EQ(2u, cache.size());
+  ResultCache::Key collision =
+      ResultCache::createKey(createNotchedRectangleSettings(20.0));
+  collision.hash = key.hash;
+  EXPECT_FALSE(cache.find(collision, "heuristic", start, goal, &waypoints));
+  std::remove(kCacheFile.c_str());
+
+  // Solutions under a deadline are not stored. The deterministic native
+  // solver without limit returns the same tour as a planner without cache.
+  settings.gtsp_solver_type = gtsp::SolverType::kNative;
+  PolygonStripmapPlanner limited(settings);
+  PolygonStripmapPlanner uncached(settings);
+  EXPECT_TRUE(limited.setup());
+  EXPECT_TRUE(uncached.setup());
+  EXPECT_TRUE(limited.enableResultCache(kCacheFile));
+  std::atomic<bool> is_cancelled(true);
+  std::vector<Point_2> waypoints_expired, waypoints_unlimited,
+      waypoints_uncached;
+  EXPECT_TRUE(limited.solve(start, goal, &waypoints_expired,
+                            Deadline(0.0, &is_cancelled)));
+  EXPECT_TRUE(cache.load(kCacheFile));
+  EXPECT_EQ(0u, cache.size());
+  EXPECT_TRUE(limited.solve(start, goal, &waypoints_unlimited));
+  EXPECT_TRUE(uncached.solve(start, goal, &waypoints_uncached));
+  EXPECT_EQ(waypoints_uncached, waypoints_unlimited);
+  EXPECT_TRUE(cache.load(kCacheFile));
+  EXPECT_EQ(1u, cache.size());
+  std::remove(kCacheFile.c_str());
+}
+
+TEST(StripmapPlannerTest, BatchPlanning) {
+  std::vector<BatchTask> tasks;
+  for (double width : {20.0, 40.0, 60.0, 80.0}) {
+    BatchTask task;
+    task.settings = createNotchedRectangleSettings(width);
+    task.start = Point_2(1.0, 1.0);
+    task.goal = Point_2(width - 1.0, 1.0);
+    tasks.push_back(task);
+  }
+
+  // The exact planner is deterministic, such that the batch results equal
+  // the sequential results.
+  std::vector<BatchResult> results;
+  EXPECT_TRUE(planBatch<PolygonStripmapPlannerHeldKarp>(tasks, 4, &results));
+  ASSERT_EQ(tasks.size(), results.size());
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    PolygonStripmapPlannerHeldKarp planner(tasks[i].settings);
+    std::vector<Point_2> solution;
+    EXPECT_TRUE(planner.setup());
+    EXPECT_TRUE(planner.solve(tasks[i].start, tasks[i].goal, &solution));
+    EXPECT_TRUE(results[i].success);
+    EXPECT_EQ(solution, results[i].solution);
+  }
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -20,8 +20,10 @@
 #ifndef POLYGON_COVERAGE_ROS_COVERAGE_PLANNER_H_
 #define POLYGON_COVERAGE_ROS_COVERAGE_PLANNER_H_
 
+#include <algorithm>
 #include <memory>
 #include <optional>
+#include <string>
 
 #include <ros/ros.h>
 
@@ -30,6 +32,7 @@
 #include <polygon_coverage_planners/sensor_models/frustum.h>
 #include <polygon_coverage_planners/sensor_models/line.h>
 #include <polygon_coverage_planners/sensor_models/sensor_model_base.h>
+#include <polygon_coverage_solvers/gtsp_solver.h>
 
 #include "polygon_coverage_ros/polygon_planner_base.h"
 #include "polygon_coverage_ros/ros_interface.h"
@@ -45,8 +48,22 @@ class CoveragePlanner : public PolygonPlannerBase {
       : PolygonPlannerBase(nh, nh_private),
         decomposition_type_(DecompositionType::kBCD),
         sensor_model_type_(SensorModelType::kLine),
+        gtsp_solver_type_(gtsp::SolverType::kGkMa),
         offset_polygons_(true),
-        sweep_single_direction_(false) {
+        simplification_tolerance_(0.0),
+        grid_resolution_(0.0),
+        sweep_single_direction_(false),
+        num_threads_(1),
+        store_edge_waypoints_(true),
+        store_visibility_polygons_(true),
+        precompute_shortest_paths_(false),
+        bitangent_visibility_graph_(false),
+        max_group_size_(8),
+        product_graph_memory_budget_(0),
+        product_graph_fallback_(true),
+        reverse_search_(false),
+        use_result_cache_(false),
+        solve_deadline_(-1.0) {
     // Parameters.
     if (!nh_private_.getParam("offset_polygons", offset_polygons_)) {
       ROS_WARN_STREAM(
@@ -71,6 +88,38 @@ class CoveragePlanner : public PolygonPlannerBase {
     decomposition_type_ =
         static_cast<DecompositionType>(decomposition_type_int);
 
+    // GTSP solver type.
+    int gtsp_solver_type_int = static_cast<int>(gtsp_solver_type_);
+    if (!nh_private_.getParam("gtsp_solver_type", gtsp_solver_type_int)) {
+      ROS_WARN_STREAM("No GTSP solver type specified. Using default value of: "
+                      << gtsp::getSolverTypeName(gtsp_solver_type_));
+    }
+    if (!gtsp::checkSolverTypeValid(gtsp_solver_type_int)) {
+      ROS_WARN_STREAM(
+          "Selected GTSP solver type is invalid. Using default value of: "
+          << gtsp::getSolverTypeName(gtsp_solver_type_));
+      gtsp_solver_type_int = static_cast<int>(gtsp_solver_type_);
+    }
+    gtsp_solver_type_ = static_cast<gtsp::SolverType>(gtsp_solver_type_int);
+
+    // GTSP multi-start.
+    int gtsp_num_starts_int =
+        static_cast<int>(gtsp_solver_settings_.num_starts);
+    if (nh_private_.getParam("gtsp_num_starts", gtsp_num_starts_int)) {
+      gtsp_solver_settings_.num_starts =
+          static_cast<size_t>(std::max(gtsp_num_starts_int, 1));
+    }
+    int gtsp_num_threads_int =
+        static_cast<int>(gtsp_solver_settings_.num_threads);
+    if (nh_private_.getParam("gtsp_num_threads", gtsp_num_threads_int)) {
+      gtsp_solver_settings_.num_threads =
+          static_cast<size_t>(std::max(gtsp_num_threads_int, 0));
+    }
+    nh_private_.getParam("gtsp_time_budget", gtsp_solver_settings_.time_budget);
+    ROS_INFO_STREAM("GTSP starts: " << gtsp_solver_settings_.num_starts
+                                    << " time budget: "
+                                    << gtsp_solver_settings_.time_budget);
+
     // Get sensor model.
     int sensor_model_type_int = static_cast<int>(sensor_model_type_);
     if (!nh_private_.getParam("sensor_model_type", sensor_model_type_int)) {
@@ -100,7 +149,7 @@ class CoveragePlanner : public PolygonPlannerBase {
       lateral_fov_ = std::make_optional(lateral_fov_temp);
     }
 
-    updateSensorModel();
+    updateSensorModel(&altitude_);
 
     if (!nh_private_.getParam("sweep_single_direction",
                               sweep_single_direction_)) {
@@ -109,12 +158,79 @@ class CoveragePlanner : public PolygonPlannerBase {
     }
     ROS_INFO_STREAM("Sweep single direction: " << sweep_single_direction_);
 
+    int num_threads_int = static_cast<int>(num_threads_);
+    if (nh_private_.getParam("num_threads", num_threads_int)) {
+      num_threads_ = static_cast<size_t>(std::max(num_threads_int, 0));
+    }
+    ROS_INFO_STREAM("Sweep plan graph threads: " << num_threads_);
+
+    nh_private_.getParam("store_edge_waypoints", store_edge_waypoints_);
+    ROS_INFO_STREAM("Store edge waypoints: " << store_edge_waypoints_);
+    nh_private_.getParam("store_visibility_polygons",
+                         store_visibility_polygons_);
+    ROS_INFO_STREAM(
+        "Store visibility polygons: " << store_visibility_polygons_);
+    nh_private_.getParam("precompute_shortest_paths",
+                         precompute_shortest_paths_);
+    ROS_INFO_STREAM(
+        "Precompute shortest paths: " << precompute_shortest_paths_);
+    nh_private_.getParam("bitangent_visibility_graph",
+                         bitangent_visibility_graph_);
+    if (nh_private_.getParam("simplification_tolerance",
+                             simplification_tolerance_)) {
+      ROS_INFO_STREAM("Simplification tolerance: "
+                      << simplification_tolerance_ << " sweep distances");
+    }
+    if (nh_private_.getParam("grid_resolution", grid_resolution_)) {
+      ROS_INFO_STREAM("Grid resolution: " << grid_resolution_ << " m");
+    }
+    ROS_INFO_STREAM(
+        "Bitangent visibility graph: " << bitangent_visibility_graph_);
+    int max_group_size_int = static_cast<int>(max_group_size_);
+    if (nh_private_.getParam("max_group_size", max_group_size_int)) {
+      max_group_size_ = static_cast<size_t>(std::max(max_group_size_int, 1));
+    }
+    ROS_INFO_STREAM("Hierarchical solver group size: " << max_group_size_);
+    double product_graph_memory_budget_mb = 0.0;
+    if (nh_private_.getParam("product_graph_memory_budget_mb",
+                             product_graph_memory_budget_mb)) {
+      product_graph_memory_budget_ = static_cast<size_t>(
+          std::max(product_graph_memory_budget_mb, 0.0) * 1.0e6);
+    }
+    ROS_INFO_STREAM(
+        "Product graph memory budget: " << product_graph_memory_budget_
+                                        << " bytes");
+    nh_private_.getParam("product_graph_fallback", product_graph_fallback_);
+    ROS_INFO_STREAM("Product graph fallback: " << product_graph_fallback_);
+    nh_private_.getParam("reverse_search", reverse_search_);
+    ROS_INFO_STREAM("Reverse search: " << reverse_search_);
+
+    if (nh_private_.getParam("snapshot_file", snapshot_file_)) {
+      ROS_INFO_STREAM("Sweep plan graph snapshot file: " << snapshot_file_);
+    }
+    nh_private_.getParam("use_result_cache", use_result_cache_);
+    ROS_INFO_STREAM("Use result cache: " << use_result_cache_);
+    if (nh_private_.getParam("result_cache_file", result_cache_file_)) {
+      ROS_INFO_STREAM("Result cache file: " << result_cache_file_);
+    }
+    if (nh_private_.getParam("solve_deadline", solve_deadline_)) {
+      ROS_INFO_STREAM("Solve deadline: " << solve_deadline_ << " s");
+    }
+    if ((solve_deadline_ > 0.0 || gtsp_solver_settings_.time_budget > 0.0) &&
+        !gtsp::checkSolverStopsOnBudget(gtsp_solver_type_)) {
+      ROS_WARN_STREAM(gtsp::getSolverTypeName(gtsp_solver_type_)
+                      << " cannot stop a run on the solve deadline or the "
+                         "GTSP time budget. Use the native solver to bound "
+                         "solving.");
+    }
+
     // Creating the line sweep planner from the retrieved parameters.
     // This operation may take some time.
     if (polygon_.has_value()) {
-      resetPlanner();
+      reset();
     }
   }
+  ~CoveragePlanner() { stopSetupWorker(); }
 
  protected:
   inline visualization_msgs::MarkerArray createDecompositionMarkers()
@@ -145,48 +261,114 @@ class CoveragePlanner : public PolygonPlannerBase {
     return markers;
   }
 
+  inline void addPlannerDiagnostics(
+      diagnostic_msgs::DiagnosticStatus* status) const override {
+    ROS_ASSERT(status);
+    if (!planner_) {
+      return;
+    }
+    addDiagnosticValue("decomposition_size",
+                       planner_->getDecompositionSize(), status);
+    addDiagnosticValue("num_nodes", planner_->getNumberOfNodes(), status);
+    addDiagnosticValue("num_edges", planner_->getNumberOfEdges(), status);
+    addDiagnosticValue("num_pruned_nodes",
+                       planner_->getNumberOfPrunedNodes(), status);
+  }
+
  private:
   // Call to the sweep planner library.
-  inline bool solvePlanner(const Point_2& start, const Point_2& goal) override {
-    return planner_->solve(start, goal, &solution_);
+  inline bool solvePlanner(const Point_2& start, const Point_2& goal,
+                           const Deadline& deadline) override {
+    return planner_->solve(start, goal, &solution_,
+                           deadline.limit(solve_deadline_));
   }
 
   // Reset the sweep planner when a new polygon is set.
   inline bool resetPlanner() override {
     ROS_INFO_STREAM("Reset planner.");
-    sweep_plan_graph::SweepPlanGraph::Settings settings;
     if (!polygon_.has_value()) {
       ROS_ERROR("Polygon not set.");
       return false;
-    } else {
-      settings.polygon = polygon_.value();
     }
+
+    // All other settings are fixed after construction. Reuse the unaffected
+    // parts of the previous sweep plan graph.
+    if (planner_ && planner_->isInitialized()) {
+      if (planner_->update(polygon_.value())) {
+        ROS_INFO("Finished updating the sweep planner.");
+        return true;
+      }
+      ROS_WARN("Failed updating sweep planner. Recreating it.");
+    }
+
+    planner_ = createPlanner(polygon_.value(), &altitude_);
+    return planner_ != nullptr && planner_->isInitialized();
+  }
+
+  // Set up a new sweep planner while the current one keeps serving. Always
+  // recreates the sweep plan graph, since updating it would modify the
+  // serving planner.
+  inline bool preparePlanner(const PolygonWithHoles& polygon,
+                             std::optional<double>* altitude) override {
+    ROS_INFO_STREAM("Prepare planner.");
+    next_planner_ = createPlanner(polygon, altitude);
+    return next_planner_ != nullptr && next_planner_->isInitialized();
+  }
+
+  inline void commitPlanner() override { planner_ = std::move(next_planner_); }
+
+  // Create and set up a sweep planner. Returns nullptr without sensor model.
+  inline std::unique_ptr<Planner> createPlanner(
+      const PolygonWithHoles& polygon, std::optional<double>* altitude) {
+    sweep_plan_graph::SweepPlanGraph::Settings settings;
+    settings.polygon = polygon;
     settings.cost_function = path_cost_function_.first;
 
-    updateSensorModel();
+    updateSensorModel(altitude);
     if (sensor_model_ == nullptr) {
       ROS_ERROR("Sensor model not set.");
-      return false;
+      return nullptr;
     } else {
       settings.sensor_model = sensor_model_;
     }
     settings.decomposition_type = decomposition_type_;
     settings.wall_distance = wall_distance_;
     settings.offset_polygons = offset_polygons_;
+    settings.simplification_tolerance = simplification_tolerance_;
+    settings.grid_resolution = grid_resolution_;
     settings.sweep_single_direction = sweep_single_direction_;
+    settings.gtsp_solver_type = gtsp_solver_type_;
+    settings.gtsp_solver_settings = gtsp_solver_settings_;
+    settings.num_threads = num_threads_;
+    settings.store_edge_waypoints = store_edge_waypoints_;
+    settings.store_visibility_polygons = store_visibility_polygons_;
+    settings.precompute_shortest_paths = precompute_shortest_paths_;
+    settings.bitangent_visibility_graph = bitangent_visibility_graph_;
+    settings.max_group_size = max_group_size_;
+    settings.product_graph_memory_budget = product_graph_memory_budget_;
+    settings.product_graph_fallback = product_graph_fallback_;
+    settings.reverse_search = reverse_search_;
 
-    planner_.reset(new Planner(settings));
-    planner_->setup();
-    if (planner_->isInitialized()) {
+    std::unique_ptr<Planner> planner(new Planner(settings));
+    if (snapshot_file_.empty()) {
+      planner->setup();
+    } else {
+      planner->setup(snapshot_file_);
+    }
+    if (use_result_cache_ && !planner->enableResultCache(result_cache_file_)) {
+      ROS_WARN_STREAM("Cannot load result cache " << result_cache_file_);
+    }
+    if (planner->isInitialized()) {
       ROS_INFO("Finished creating the sweep planner.");
-      return true;
     } else {
       ROS_ERROR("Failed creating sweep planner from user input.");
-      return false;
     }
+    return planner;
   }
 
-  inline void updateSensorModel() {
+  // Set the sensor model. A frustum defaults the altitude to 1 m.
+  inline void updateSensorModel(std::optional<double>* altitude) {
+    ROS_ASSERT(altitude);
     switch (sensor_model_type_) {
       case SensorModelType::kLine: {
         if (!lateral_footprint_.has_value()) {
@@ -214,21 +396,22 @@ class CoveragePlanner : public PolygonPlannerBase {
           ROS_ERROR("No lateral_overlap specified. Cannot set sensor model.");
           break;
         }
-        if (!altitude_.has_value()) {
+        if (!altitude->has_value()) {
           ROS_WARN("No altitude specified. Creating default altitude of 1m.");
-          altitude_ = std::make_optional(1.0);
-        } else if (altitude_.value() < std::numeric_limits<double>::epsilon()) {
+          *altitude = std::make_optional(1.0);
+        } else if (altitude->value() <
+                   std::numeric_limits<double>::epsilon()) {
           ROS_WARN(
               "Altitude to small %.3fm. Please set altitude through first "
               "z-value of polygon. Setting default altitude of 1m.",
-              altitude_.value());
-          altitude_ = std::make_optional(1.0);
+              altitude->value());
+          *altitude = std::make_optional(1.0);
         }
         sensor_model_ = std::make_shared<Frustum>(
-            altitude_.value(), lateral_fov_.value(), lateral_overlap_.value());
+            altitude->value(), lateral_fov_.value(), lateral_overlap_.value());
         ROS_INFO("Sensor model: frustum");
         ROS_INFO_STREAM("Lateral FOV: " << lateral_fov_.value());
-        ROS_INFO_STREAM("Altitude: " << altitude_.value());
+        ROS_INFO_STREAM("Altitude: " << altitude->value());
         break;
       }
     }
@@ -238,13 +421,32 @@ class CoveragePlanner : public PolygonPlannerBase {
 
   // The library object that actually does planning.
   std::unique_ptr<Planner> planner_;
+  // The planner set up in the background for a new polygon.
+  std::unique_ptr<Planner> next_planner_;
 
   // System Parameters
   std::shared_ptr<SensorModelBase> sensor_model_;
   DecompositionType decomposition_type_;
   SensorModelType sensor_model_type_;
+  gtsp::SolverType gtsp_solver_type_;
+  gtsp::SolverSettings gtsp_solver_settings_;
   bool offset_polygons_;
+  double simplification_tolerance_;  // Relative to the sweep distance.
+  double grid_resolution_;           // [m]
   bool sweep_single_direction_;
+  size_t num_threads_;
+  bool store_edge_waypoints_;
+  bool store_visibility_polygons_;
+  bool precompute_shortest_paths_;
+  bool bitangent_visibility_graph_;
+  size_t max_group_size_;
+  size_t product_graph_memory_budget_;  // [bytes] 0: unlimited.
+  bool product_graph_fallback_;
+  bool reverse_search_;
+  std::string snapshot_file_;
+  bool use_result_cache_;
+  std::string result_cache_file_;
+  double solve_deadline_;  // Per-request time budget [s]. Non-positive: none.
   std::optional<double> lateral_footprint_;
   std::optional<double> lateral_overlap_;
   std::optional<double> lateral_fov_;
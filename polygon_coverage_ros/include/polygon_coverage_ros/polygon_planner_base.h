@@ -20,15 +20,25 @@
 #ifndef POLYGON_COVERAGE_ROS_POLYGON_PLANNER_BASE_H_
 #define POLYGON_COVERAGE_ROS_POLYGON_PLANNER_BASE_H_
 
+#include <atomic>
+#include <condition_variable>
+#include <future>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <string>
+#include <thread>
 
 #include <polygon_coverage_geometry/cgal_definitions.h>
+#include <polygon_coverage_msgs/PlanPathAction.h>
 #include <polygon_coverage_msgs/PolygonService.h>
 #include <polygon_coverage_msgs/PolygonWithHolesStamped.h>
 #include <polygon_coverage_planners/cost_functions/path_cost_functions.h>
 #include <polygon_coverage_planners/sensor_models/sensor_model_base.h>
+#include <polygon_coverage_solvers/deadline.h>
 
+#include <actionlib/server/simple_action_server.h>
+#include <diagnostic_msgs/DiagnosticStatus.h>
 #include <geometry_msgs/PointStamped.h>
 #include <mav_planning_msgs/PlannerService.h>
 #include <ros/ros.h>
@@ -43,17 +53,40 @@ class PolygonPlannerBase {
   // Constructor
   PolygonPlannerBase(const ros::NodeHandle& nh,
                      const ros::NodeHandle& nh_private);
+  virtual ~PolygonPlannerBase();
 
  protected:
-  // Call to the actual planner.
-  virtual bool solvePlanner(const Point_2& start, const Point_2& goal) = 0;
+  // Call to the actual planner. Planners that support it stop at the deadline
+  // and return their best solution so far.
+  virtual bool solvePlanner(const Point_2& start, const Point_2& goal,
+                            const Deadline& deadline) = 0;
   // Reset the planner when a new polygon is set.
   virtual bool resetPlanner() = 0;
+  // Set up the next planner for a new polygon on the setup worker while the
+  // current planner keeps serving. May update the altitude.
+  virtual bool preparePlanner(const PolygonWithHoles& polygon,
+                              std::optional<double>* altitude) = 0;
+  // Replace the current planner with the prepared one. Called under
+  // planner_mutex_.
+  virtual void commitPlanner() = 0;
   // Publish the decomposition.
   virtual inline visualization_msgs::MarkerArray createDecompositionMarkers()
       const {
     return visualization_msgs::MarkerArray();
   }
+  // Add the planner statistics, e.g., graph size, to the diagnostics.
+  virtual inline void addPlannerDiagnostics(
+      diagnostic_msgs::DiagnosticStatus* status) const {}
+
+  // Reset the planner and publish the setup diagnostics.
+  bool reset();
+  // Finish the running setup and join the setup worker. Derived planners call
+  // this in their destructor, before their planner members are destroyed.
+  void stopSetupWorker();
+  static void addDiagnosticValue(const std::string& key, double value,
+                                 diagnostic_msgs::DiagnosticStatus* status);
+  static void addDiagnosticValue(const std::string& key, size_t value,
+                                 diagnostic_msgs::DiagnosticStatus* status);
 
   // Node handles
   ros::NodeHandle nh_;
@@ -75,13 +108,40 @@ class PolygonPlannerBase {
   std::optional<double> a_max_;
   bool set_start_goal_from_rviz_;
   bool set_polygon_from_rviz_;
+  std::string trace_file_;  // Chrome trace of the last plan. Empty: off.
   std::optional<Point_2> start_;
   std::optional<Point_2> goal_;
+  bool background_setup_;  // Set up new polygons on the setup worker.
+
+  // Serializes planning on the action server thread, the setup worker and the
+  // ROS callbacks. Callbacks that would block the spinner report a busy
+  // planner instead.
+  std::mutex planner_mutex_;
 
  private:
+  typedef actionlib::SimpleActionServer<polygon_coverage_msgs::PlanPathAction>
+      PlanPathActionServer;
+
   // Solve the planning problem. Stores status planning_complete_ and publishes
   // trajectory and visualization if enabled.
-  void solve(const Point_2& start, const Point_2& goal);
+  void solve(const Point_2& start, const Point_2& goal,
+             const Deadline& deadline = Deadline());
+  // Set the polygon, altitude and frame from a message.
+  bool setPolygon(const polygon_coverage_msgs::PolygonWithHolesStamped& msg);
+
+  // A polygon waiting for the setup worker.
+  struct SetupJob {
+    PolygonWithHoles polygon;
+    double altitude;
+    std::string frame_id;
+    std::promise<bool> done;  // Whether the new planner serves.
+  };
+  // Queue the polygon for the setup worker. A newer polygon replaces a pending
+  // one. Returns false if the message is invalid.
+  bool queueSetup(const polygon_coverage_msgs::PolygonWithHolesStamped& msg,
+                  std::future<bool>* done);
+  // Prepares the queued polygons and swaps in the new planners.
+  void setupWorker();
 
   // Initial interactions with ROS
   void getParametersFromRos();
@@ -100,6 +160,12 @@ class PolygonPlannerBase {
   // Solves the planning problem from start to goal.
   bool planPathCallback(mav_planning_msgs::PlannerService::Request& request,
                         mav_planning_msgs::PlannerService::Response& response);
+  // Sets up and solves on the action server thread. Publishes the started
+  // pipeline stages as feedback.
+  void planPathActionCallback(
+      const polygon_coverage_msgs::PlanPathGoalConstPtr& goal);
+  // Cancels the in-flight solve.
+  void preemptPlanPathActionCallback();
   bool publishAllCallback(std_srvs::Empty::Request& request,
                           std_srvs::Empty::Response& response);
   bool publishVisualizationCallback(std_srvs::Empty::Request& request,
@@ -107,14 +173,22 @@ class PolygonPlannerBase {
   bool publishTrajectoryPointsCallback(std_srvs::Empty::Request& request,
                                        std_srvs::Empty::Response& response);
 
-  // Visualization
+  // Visualization. Sends only the marker groups that changed since the last
+  // call. Resends all cached markers if nothing changed.
   bool publishVisualization();
+  // Publish the timers, memory usage and planner statistics after a planner
+  // stage, i.e., setup or solve.
+  void publishDiagnostics(const std::string& stage, bool success);
 
-  // Publishing the plan
+  // Publishing the plan. Publishes it in chunks if waypoint_chunk_size_ is
+  // positive.
   bool publishTrajectoryPoints();
+  bool publishTrajectoryChunks();
   // Publishers and Services
   ros::Publisher marker_pub_;
   ros::Publisher waypoint_list_pub_;
+  ros::Publisher waypoint_chunk_pub_;
+  ros::Publisher diagnostics_pub_;
   ros::Subscriber clicked_point_sub_;
   ros::Subscriber polygon_sub_;
   ros::ServiceServer set_polygon_srv_;
@@ -122,11 +196,28 @@ class PolygonPlannerBase {
   ros::ServiceServer publish_visualization_srv_;
   ros::ServiceServer publish_plan_points_srv_;
   ros::ServiceServer publish_all_srv_;
+  std::unique_ptr<PlanPathActionServer> plan_path_action_server_;
 
   // Planner status
   bool planning_complete_;
-
-  visualization_msgs::MarkerArray markers_;
+  std::atomic<bool> is_preempted_;
+
+  // Setup worker
+  std::thread setup_thread_;
+  std::mutex setup_mutex_;  // Guards pending_setup_ and stop_setup_.
+  std::condition_variable setup_cv_;
+  std::optional<SetupJob> pending_setup_;
+  bool stop_setup_;
+
+  // Visualization cache
+  visualization_msgs::MarkerArray polygon_markers_;   // With decomposition.
+  visualization_msgs::MarkerArray solution_markers_;  // Path, start and goal.
+  size_t polygon_version_;   // Incremented on every planner setup.
+  size_t solution_version_;  // Incremented on every setup and solve.
+  size_t published_polygon_version_;
+  size_t published_solution_version_;
+  int max_visualization_waypoints_;  // Decimates the displayed path.
+  int waypoint_chunk_size_;  // Waypoints per published chunk. 0: one list.
 };
 }  // namespace polygon_coverage_planning
 
@@ -21,6 +21,7 @@
 #define POLYGON_COVERAGE_ROS_INTERFACE_H_
 
 #include <fstream>
+#include <functional>
 #include <vector>
 
 #include <eigen_conversions/eigen_msg.h>
@@ -82,6 +83,38 @@ void msgMultiDofJointTrajectoryFromPath(
     const std::vector<Point_2>& waypoints, double altitude,
     trajectory_msgs::MultiDOFJointTrajectory* msg);
 
+// Append the waypoints [begin, end) without an intermediate trajectory. Allows
+// converting a plan segment by segment, e.g., from
+// SweepPlanGraph::forEachWaypointSegment.
+void appendPoseArrayMsgFromPath(
+    std::vector<Point_2>::const_iterator begin,
+    std::vector<Point_2>::const_iterator end, double altitude,
+    geometry_msgs::PoseArray* trajectory_points_pose_array);
+
+void appendPosesFromPath(std::vector<Point_2>::const_iterator begin,
+                         std::vector<Point_2>::const_iterator end,
+                         double altitude,
+                         std::vector<geometry_msgs::Pose>* poses);
+
+// Visits a chunk of consecutive waypoints [begin, end) and its sequence
+// number. Returns false to stop the traversal.
+typedef std::function<bool(std::vector<Point_2>::const_iterator begin,
+                           std::vector<Point_2>::const_iterator end,
+                           size_t sequence)>
+    WaypointChunkVisitor;
+
+// Visit the waypoints in order in chunks of at most chunk_size waypoints, e.g.,
+// to publish a long plan without one monolithic message. Aborts and returns
+// false if the visitor returns false.
+bool forEachWaypointChunk(const std::vector<Point_2>& waypoints,
+                          size_t chunk_size, const WaypointChunkVisitor& visit);
+size_t getNumberOfWaypointChunks(size_t num_waypoints, size_t chunk_size);
+
+void appendMsgMultiDofJointTrajectoryFromPath(
+    std::vector<Point_2>::const_iterator begin,
+    std::vector<Point_2>::const_iterator end, double altitude,
+    trajectory_msgs::MultiDOFJointTrajectory* msg);
+
 void createMarkers(const std::vector<Point_2>& vertices, double altitude,
                    const std::string& frame_id, const std::string& ns,
                    const Color& points_color, const Color& lines_color,
@@ -89,6 +122,18 @@ void createMarkers(const std::vector<Point_2>& vertices, double altitude,
                    visualization_msgs::Marker* points,
                    visualization_msgs::Marker* line_strip);
 
+// Keep at most max_waypoints evenly strided waypoints, always including the
+// first and the last, e.g., to display long paths.
+void decimatePath(const std::vector<Point_2>& waypoints, size_t max_waypoints,
+                  std::vector<Point_2>* decimated);
+
+// Append the markers to send to replace the previous markers by the current
+// ones: DELETE for previous markers that are not current, identified by
+// namespace and id, and ADD for all current markers.
+void appendMarkerUpdate(const visualization_msgs::MarkerArray& previous,
+                        const visualization_msgs::MarkerArray& current,
+                        visualization_msgs::MarkerArray* update);
+
 void createTriangles(const std::vector<std::vector<Point_2>>& triangles,
                      const std::string& frame_id, const std::string& ns,
                      const Color& color, const double altitude,
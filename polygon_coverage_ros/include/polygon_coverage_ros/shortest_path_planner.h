@@ -28,6 +28,7 @@
 
 #include <polygon_coverage_geometry/cgal_definitions.h>
 #include <polygon_coverage_geometry/visibility_graph.h>
+#include <polygon_coverage_msgs/ShortestPathBatchService.h>
 
 namespace polygon_coverage_planning {
 
@@ -37,16 +38,37 @@ class ShortestPathPlanner : public PolygonPlannerBase {
   // Constructor
   ShortestPathPlanner(const ros::NodeHandle& nh,
                       const ros::NodeHandle& nh_private);
+  ~ShortestPathPlanner();
 
  private:
   // Call to the shortest path planner library.
-  bool solvePlanner(const Point_2& start, const Point_2& goal) override;
+  // The shortest path is fast and ignores the deadline.
+  bool solvePlanner(const Point_2& start, const Point_2& goal,
+                    const Deadline& deadline) override;
 
   // Reset the shortest path planner when a new polygon is set.
   bool resetPlanner() override;
+  // Build the visibility graph of a new polygon on the setup worker.
+  bool preparePlanner(const PolygonWithHoles& polygon,
+                      std::optional<double>* altitude) override;
+  // Swap in the prepared visibility graph and its offset polygon.
+  void commitPlanner() override;
+
+  // Solves many start and goal pairs concurrently against the same visibility
+  // graph. In all_pairs mode every start is one one-to-many query.
+  bool planPathBatchCallback(
+      polygon_coverage_msgs::ShortestPathBatchService::Request& request,
+      polygon_coverage_msgs::ShortestPathBatchService::Response& response);
 
   // The library object that actually does planning.
   std::unique_ptr<visibility_graph::VisibilityGraph> planner_;
+  // The prepared visibility graph and offset polygon.
+  std::unique_ptr<visibility_graph::VisibilityGraph> next_planner_;
+  PolygonWithHoles next_polygon_;
+  // Threads to build the visibility graph and answer batch queries.
+  size_t num_threads_;
+
+  ros::ServiceServer plan_path_batch_srv_;
 };
 
 }  // namespace polygon_coverage_planning
@@ -33,8 +33,11 @@ int main(int argc, char** argv) {
   polygon_coverage_planning::CoveragePlanner<
       polygon_coverage_planning::PolygonStripmapPlannerExact>
       planner(nh, nh_private);
-  // Spinning (and processing service calls)
-  ros::spin();
+  // Spinning (and processing service calls) on several threads such that
+  // clicks and services stay responsive during long plans.
+  ros::AsyncSpinner spinner(4);
+  spinner.start();
+  ros::waitForShutdown();
   // Exit tranquilly
   return 0;
 }
@@ -20,11 +20,25 @@
 #include "polygon_coverage_ros/polygon_planner_base.h"
 #include "polygon_coverage_ros/ros_interface.h"
 
+#include <algorithm>
+#include <chrono>
 #include <functional>
-
+#include <iterator>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+#include <polygon_coverage_geometry/cgal_comm.h>
+#include <polygon_coverage_geometry/polygon_file.h>
+#include <polygon_coverage_msgs/WaypointChunk.h>
 #include <polygon_coverage_msgs/msg_from_xml_rpc.h>
 #include <polygon_coverage_planners/cost_functions/path_cost_functions.h>
+#include <polygon_coverage_planners/memory.h>
+#include <polygon_coverage_planners/timing.h>
+#include <polygon_coverage_planners/tracing.h>
 
+#include <diagnostic_msgs/DiagnosticArray.h>
+#include <diagnostic_msgs/KeyValue.h>
 #include <geometry_msgs/PoseArray.h>
 #include <visualization_msgs/MarkerArray.h>
 
@@ -36,7 +50,7 @@ PolygonPlannerBase::PolygonPlannerBase(const ros::NodeHandle& nh,
       nh_private_(nh_private),
       wall_distance_(0.0),
       path_cost_function_(
-          {std::bind(&computeEuclideanPathCost, std::placeholders::_1),
+          {makePathCostFunction(CostFunctionType::kDistance),
            CostFunctionType::kDistance}),
       latch_topics_(true),
       global_frame_id_("world"),
@@ -44,26 +58,69 @@ PolygonPlannerBase::PolygonPlannerBase(const ros::NodeHandle& nh,
       publish_visualization_on_planning_complete_(true),
       set_start_goal_from_rviz_(false),
       set_polygon_from_rviz_(true),
-      planning_complete_(false) {
+      background_setup_(true),
+      planning_complete_(false),
+      is_preempted_(false),
+      stop_setup_(false),
+      polygon_version_(1),
+      solution_version_(1),
+      published_polygon_version_(0),
+      published_solution_version_(0),
+      max_visualization_waypoints_(10000),
+      waypoint_chunk_size_(0) {
   // Initial interactions with ROS
   getParametersFromRos();
   advertiseTopics();
 
+  // Polygons only arrive once the node spins, i.e., after construction.
+  if (background_setup_) {
+    setup_thread_ = std::thread(&PolygonPlannerBase::setupWorker, this);
+  }
+
   // Publish RVIZ.
   publishVisualization();
 }
 
+PolygonPlannerBase::~PolygonPlannerBase() { stopSetupWorker(); }
+
+void PolygonPlannerBase::stopSetupWorker() {
+  {
+    std::lock_guard<std::mutex> lock(setup_mutex_);
+    stop_setup_ = true;
+    if (pending_setup_.has_value()) {
+      pending_setup_->done.set_value(false);
+      pending_setup_.reset();
+    }
+  }
+  setup_cv_.notify_all();
+  if (setup_thread_.joinable()) setup_thread_.join();
+}
+
 void PolygonPlannerBase::advertiseTopics() {
   // Advertising the visualization and planning messages
   marker_pub_ = nh_private_.advertise<visualization_msgs::MarkerArray>(
       "path_markers", 1, true);
   waypoint_list_pub_ = nh_.advertise<geometry_msgs::PoseArray>(
       "waypoint_list", 1, latch_topics_);
+  // Do not drop chunks of a plan.
+  waypoint_chunk_pub_ = nh_.advertise<polygon_coverage_msgs::WaypointChunk>(
+      "waypoint_chunks", 0);
+  diagnostics_pub_ =
+      nh_private_.advertise<diagnostic_msgs::DiagnosticArray>("diagnostics", 1);
   // Services for generating the plan.
   set_polygon_srv_ = nh_private_.advertiseService(
       "set_polygon", &PolygonPlannerBase::setPolygonCallback, this);
   plan_path_srv_ = nh_private_.advertiseService(
       "plan_path", &PolygonPlannerBase::planPathCallback, this);
+  // Goals only arrive once the node spins, i.e., after construction.
+  plan_path_action_server_ = std::make_unique<PlanPathActionServer>(
+      nh_private_, "plan_path_action",
+      std::bind(&PolygonPlannerBase::planPathActionCallback, this,
+                std::placeholders::_1),
+      false);
+  plan_path_action_server_->registerPreemptCallback(
+      std::bind(&PolygonPlannerBase::preemptPlanPathActionCallback, this));
+  plan_path_action_server_->start();
   // Services for performing publishing and visualization
   publish_all_srv_ = nh_private_.advertiseService(
       "publish_all", &PolygonPlannerBase::publishAllCallback, this);
@@ -81,11 +138,29 @@ void PolygonPlannerBase::advertiseTopics() {
 }
 
 void PolygonPlannerBase::getParametersFromRos() {
-  // Load the polygon from polygon message from parameter server.
-  // The altitude and the global frame ID are set from the same message.
+  // Load the polygon from a binary polygon file or from polygon message from
+  // parameter server. The altitude and the global frame ID are set from the
+  // same message.
   XmlRpc::XmlRpcValue polygon_xml_rpc;
   const std::string polygon_param_name = "polygon";
-  if (nh_private_.getParam(polygon_param_name, polygon_xml_rpc)) {
+  std::string polygon_file;
+  if (nh_private_.getParam("polygon_file", polygon_file)) {
+    PolygonWithHoles temp_pwh;
+    double temp_alt;
+    if (!loadPolygonFile(polygon_file, &temp_pwh, &temp_alt)) {
+      ROS_WARN_STREAM("Failed reading polygon file " << polygon_file);
+    } else if (!isStrictlySimple(temp_pwh)) {
+      ROS_WARN_STREAM("Polygon in " << polygon_file << " is not simple.");
+    } else {
+      ROS_INFO_STREAM("Successfully loaded polygon file " << polygon_file);
+      ROS_INFO_STREAM("Altitude: " << temp_alt << " m");
+      ROS_INFO_STREAM("Vertices: " << temp_pwh.outer_boundary().size()
+                                   << ", holes: "
+                                   << temp_pwh.number_of_holes());
+      polygon_ = std::make_optional(std::move(temp_pwh));
+      altitude_ = std::make_optional(temp_alt);
+    }
+  } else if (nh_private_.getParam(polygon_param_name, polygon_xml_rpc)) {
     polygon_coverage_msgs::PolygonWithHolesStamped poly_msg;
     if (PolygonWithHolesStampedMsgFromXmlRpc(polygon_xml_rpc, &poly_msg)) {
       PolygonWithHoles temp_pwh;
@@ -95,7 +170,7 @@ void PolygonPlannerBase::getParametersFromRos() {
         ROS_INFO_STREAM("Altitude: " << temp_alt << " m");
         ROS_INFO_STREAM("Global frame: " << global_frame_id_);
         ROS_INFO_STREAM("Polygon:" << temp_pwh);
-        polygon_ = std::make_optional(temp_pwh);
+        polygon_ = std::make_optional(std::move(temp_pwh));
         altitude_ = std::make_optional(temp_alt);
       }
     } else {
@@ -162,18 +237,17 @@ void PolygonPlannerBase::getParametersFromRos() {
   switch (path_cost_function_.second) {
     case CostFunctionType::kDistance: {
       path_cost_function_.first =
-          std::bind(&computeEuclideanPathCost, std::placeholders::_1);
+          makePathCostFunction(CostFunctionType::kDistance);
       break;
     }
     case CostFunctionType::kTime: {
-      path_cost_function_.first =
-          std::bind(&computeVelocityRampPathCost, std::placeholders::_1,
-                    v_max_.value(), a_max_.value());
+      path_cost_function_.first = makePathCostFunction(
+          CostFunctionType::kTime, v_max_.value(), a_max_.value());
       break;
     }
     case CostFunctionType::kWaypoints: {
       path_cost_function_.first =
-          std::bind(&computeWaypointsPathCost, std::placeholders::_1);
+          makePathCostFunction(CostFunctionType::kWaypoints);
       break;
     }
     default: {
@@ -193,11 +267,33 @@ void PolygonPlannerBase::getParametersFromRos() {
   nh_private_.getParam("global_frame_id", global_frame_id_);
   nh_private_.getParam("set_start_goal_from_rviz", set_start_goal_from_rviz_);
   nh_private_.getParam("set_polygon_from_rviz", set_polygon_from_rviz_);
+  nh_private_.getParam("background_setup", background_setup_);
+  nh_private_.getParam("max_visualization_waypoints",
+                       max_visualization_waypoints_);
+  nh_private_.getParam("waypoint_chunk_size", waypoint_chunk_size_);
+  if (waypoint_chunk_size_ > 0) {
+    ROS_INFO_STREAM("Waypoint chunk size: " << waypoint_chunk_size_);
+  }
+  ROS_INFO_STREAM("Background setup: " << background_setup_);
+  nh_private_.getParam("trace_file", trace_file_);
+  if (!trace_file_.empty()) {
+    // Record the planner setup and the first plan.
+    tracing::Trace::Start();
+  }
 }
 
-void PolygonPlannerBase::solve(const Point_2& start, const Point_2& goal) {
+void PolygonPlannerBase::solve(const Point_2& start, const Point_2& goal,
+                               const Deadline& deadline) {
   ROS_INFO_STREAM("Start solving.");
-  if ((planning_complete_ = solvePlanner(start, goal))) {
+  planning_complete_ = solvePlanner(start, goal, deadline);
+  ++solution_version_;
+  publishDiagnostics("solve", planning_complete_);
+  if (!trace_file_.empty()) {
+    // Every plan overwrites the trace file of the previous plan.
+    tracing::Trace::Save(trace_file_);
+    tracing::Trace::Start();
+  }
+  if (planning_complete_) {
     ROS_INFO_STREAM("Finished plan."
                     << std::endl
                     << "Optimization Criterion: "
@@ -230,73 +326,90 @@ void PolygonPlannerBase::solve(const Point_2& start, const Point_2& goal) {
 
 bool PolygonPlannerBase::publishVisualization() {
   ROS_INFO_STREAM("Sending visualization messages.");
+  visualization_msgs::MarkerArray update;
+
+  // The original polygon and the decomposed polygons.
+  if (published_polygon_version_ != polygon_version_) {
+    visualization_msgs::MarkerArray markers;
+    if (polygon_.has_value() && altitude_.has_value()) {
+      const double kPolygonLineSize = 0.4;
+      createPolygonMarkers(polygon_.value(), altitude_.value(),
+                           global_frame_id_, "polygon", Color::Black(),
+                           Color::Black(), kPolygonLineSize, kPolygonLineSize,
+                           &markers);
+      visualization_msgs::MarkerArray decomposition_markers =
+          createDecompositionMarkers();
+      markers.markers.insert(markers.markers.end(),
+                             decomposition_markers.markers.begin(),
+                             decomposition_markers.markers.end());
+    }
+    appendMarkerUpdate(polygon_markers_, markers, &update);
+    polygon_markers_ = std::move(markers);
+    published_polygon_version_ = polygon_version_;
+  }
 
-  // Delete old markers.
-  for (visualization_msgs::Marker& m : markers_.markers)
-    m.action = visualization_msgs::Marker::DELETE;
-  marker_pub_.publish(markers_);
-
-  // Create new markers.
-  markers_.markers.clear();
   // The planned path:
-  visualization_msgs::Marker path_points, path_line_strips;
-  const double kPathLineSize = 0.2;
-  const double kPathPointSize = 0.2;
+  if (published_solution_version_ != solution_version_) {
+    visualization_msgs::MarkerArray markers;
+    if (planning_complete_ && altitude_.has_value() && !solution_.empty()) {
+      visualization_msgs::Marker path_points, path_line_strips;
+      const double kPathLineSize = 0.2;
+      const double kPathPointSize = 0.2;
+      const size_t max_waypoints =
+          static_cast<size_t>(std::max(max_visualization_waypoints_, 0));
+      std::vector<Point_2> displayed_path;
+      decimatePath(solution_, max_waypoints, &displayed_path);
+      createMarkers(displayed_path, altitude_.value(), global_frame_id_,
+                    "vertices_and_strip", Color::Gray(), Color::Gray(),
+                    kPathLineSize, kPathPointSize, &path_points,
+                    &path_line_strips);
+      markers.markers.push_back(path_points);
+      markers.markers.push_back(path_line_strips);
+
+      // Start and end points
+      visualization_msgs::Marker start_point, end_point;
+      createStartAndEndPointMarkers(solution_.front(), solution_.back(),
+                                    altitude_.value(), global_frame_id_,
+                                    "points", &start_point, &end_point);
+      markers.markers.push_back(start_point);
+      markers.markers.push_back(end_point);
+
+      // Start and end text.
+      visualization_msgs::Marker start_text, end_text;
+      createStartAndEndTextMarkers(solution_.front(), solution_.back(),
+                                   altitude_.value(), global_frame_id_,
+                                   "points", &start_text, &end_text);
+      markers.markers.push_back(start_text);
+      markers.markers.push_back(end_text);
+    }
+    appendMarkerUpdate(solution_markers_, markers, &update);
+    solution_markers_ = std::move(markers);
+    published_solution_version_ = solution_version_;
+  }
+
+  // Nothing changed, e.g., a service call for a restarted RVIZ.
+  if (update.markers.empty()) {
+    update = polygon_markers_;
+    update.markers.insert(update.markers.end(),
+                          solution_markers_.markers.begin(),
+                          solution_markers_.markers.end());
+  }
+
+  // Publishing
+  marker_pub_.publish(update);
+
   if (!altitude_.has_value()) {
     ROS_WARN_STREAM("Cannot send visualization because altitude not set.");
     return false;
   }
-
   if (!planning_complete_) {
     ROS_WARN_STREAM(
         "Cannot send solution visualization because plan has not been made.");
-  } else {
-    createMarkers(solution_, altitude_.value(), global_frame_id_,
-                  "vertices_and_strip", Color::Gray(), Color::Gray(),
-                  kPathLineSize, kPathPointSize, &path_points,
-                  &path_line_strips);
-    markers_.markers.push_back(path_points);
-    markers_.markers.push_back(path_line_strips);
-
-    // Start and end points
-    visualization_msgs::Marker start_point, end_point;
-    createStartAndEndPointMarkers(solution_.front(), solution_.back(),
-                                  altitude_.value(), global_frame_id_, "points",
-                                  &start_point, &end_point);
-    markers_.markers.push_back(start_point);
-    markers_.markers.push_back(end_point);
-
-    // Start and end text.
-    visualization_msgs::Marker start_text, end_text;
-    createStartAndEndTextMarkers(solution_.front(), solution_.back(),
-                                 altitude_.value(), global_frame_id_, "points",
-                                 &start_text, &end_text);
-    markers_.markers.push_back(start_text);
-    markers_.markers.push_back(end_text);
-  }
-
-  // The original polygon:
-  const double kPolygonLineSize = 0.4;
-  visualization_msgs::MarkerArray polygon;
+  }
   if (!polygon_.has_value()) {
     ROS_WARN_STREAM("Cannot send visualization because polygon not set.");
     return false;
   }
-  createPolygonMarkers(polygon_.value(), altitude_.value(), global_frame_id_,
-                       "polygon", Color::Black(), Color::Black(),
-                       kPolygonLineSize, kPolygonLineSize, &polygon);
-  markers_.markers.insert(markers_.markers.end(), polygon.markers.begin(),
-                          polygon.markers.end());
-
-  // The decomposed polygons.
-  visualization_msgs::MarkerArray decomposition_markers =
-      createDecompositionMarkers();
-  markers_.markers.insert(markers_.markers.end(),
-                          decomposition_markers.markers.begin(),
-                          decomposition_markers.markers.end());
-
-  // Publishing
-  marker_pub_.publish(markers_);
 
   // Success
   return true;
@@ -308,13 +421,16 @@ bool PolygonPlannerBase::publishTrajectoryPoints() {
     return false;
   }
   ROS_INFO_STREAM("Sending trajectory messages");
-
-  // Convert path to pose array.
-  geometry_msgs::PoseArray trajectory_points_pose_array;
   if (!altitude_.has_value()) {
     ROS_WARN_STREAM("Cannot send trajectory because altitude not set.");
     return false;
   }
+  if (waypoint_chunk_size_ > 0) {
+    return publishTrajectoryChunks();
+  }
+
+  // Convert path to pose array.
+  geometry_msgs::PoseArray trajectory_points_pose_array;
   poseArrayMsgFromPath(solution_, altitude_.value(), global_frame_id_,
                        &trajectory_points_pose_array);
 
@@ -325,33 +441,148 @@ bool PolygonPlannerBase::publishTrajectoryPoints() {
   return true;
 }
 
+bool PolygonPlannerBase::publishTrajectoryChunks() {
+  const size_t chunk_size = static_cast<size_t>(waypoint_chunk_size_);
+  // One message buffer for all chunks. Publishing serializes it.
+  polygon_coverage_msgs::WaypointChunk chunk;
+  chunk.header.frame_id = global_frame_id_;
+  chunk.header.stamp = ros::Time::now();
+  chunk.plan_id = static_cast<uint32_t>(solution_version_);
+  chunk.num_chunks = getNumberOfWaypointChunks(solution_.size(), chunk_size);
+  chunk.num_waypoints = solution_.size();
+  chunk.poses.reserve(std::min(chunk_size, solution_.size()));
+  const double altitude = altitude_.value();
+  forEachWaypointChunk(
+      solution_, chunk_size,
+      [this, altitude, &chunk](std::vector<Point_2>::const_iterator begin,
+                               std::vector<Point_2>::const_iterator end,
+                               size_t sequence) {
+        chunk.sequence = sequence;
+        chunk.first_waypoint = std::distance(solution_.cbegin(), begin);
+        chunk.poses.clear();
+        appendPosesFromPath(begin, end, altitude, &chunk.poses);
+        waypoint_chunk_pub_.publish(chunk);
+        return true;
+      });
+  ROS_INFO_STREAM("Sent " << chunk.num_chunks << " waypoint chunks of plan "
+                          << chunk.plan_id << ".");
+  return true;
+}
+
+bool PolygonPlannerBase::setPolygon(
+    const polygon_coverage_msgs::PolygonWithHolesStamped& msg) {
+  PolygonWithHoles temp_pwh;
+  double temp_alt;
+  if (!polygonFromMsg(msg, &temp_pwh, &temp_alt, &global_frame_id_)) {
+    return false;
+  }
+  ROS_INFO_STREAM("Successfully loaded polygon.");
+  ROS_INFO_STREAM("Altitude: " << temp_alt << " m");
+  ROS_INFO_STREAM("Global frame: " << global_frame_id_);
+  ROS_INFO_STREAM("Polygon:" << temp_pwh);
+  polygon_ = std::make_optional(std::move(temp_pwh));
+  altitude_ = std::make_optional(temp_alt);
+  return true;
+}
+
+bool PolygonPlannerBase::queueSetup(
+    const polygon_coverage_msgs::PolygonWithHolesStamped& msg,
+    std::future<bool>* done) {
+  SetupJob job;
+  if (!polygonFromMsg(msg, &job.polygon, &job.altitude, &job.frame_id)) {
+    return false;
+  }
+  if (done) *done = job.done.get_future();
+
+  std::lock_guard<std::mutex> lock(setup_mutex_);
+  if (pending_setup_.has_value()) {
+    ROS_INFO("Replacing the pending polygon.");
+    pending_setup_->done.set_value(false);
+  }
+  pending_setup_ = std::move(job);
+  setup_cv_.notify_one();
+  return true;
+}
+
+void PolygonPlannerBase::setupWorker() {
+  while (true) {
+    SetupJob job;
+    {
+      std::unique_lock<std::mutex> lock(setup_mutex_);
+      setup_cv_.wait(
+          lock, [this] { return stop_setup_ || pending_setup_.has_value(); });
+      if (stop_setup_) return;
+      job = std::move(pending_setup_.value());
+      pending_setup_.reset();
+    }
+
+    // The current planner keeps serving requests meanwhile.
+    ROS_INFO_STREAM("Setting up the planner for the new polygon.");
+    std::optional<double> altitude = std::make_optional(job.altitude);
+    const bool success = preparePlanner(job.polygon, &altitude);
+    {
+      std::lock_guard<std::mutex> lock(planner_mutex_);
+      if (success) {
+        ROS_INFO_STREAM("Altitude: " << altitude.value() << " m");
+        ROS_INFO_STREAM("Global frame: " << job.frame_id);
+        ROS_INFO_STREAM("Polygon:" << job.polygon);
+        polygon_ = std::make_optional(job.polygon);
+        altitude_ = altitude;
+        global_frame_id_ = job.frame_id;
+        commitPlanner();
+        planning_complete_ = false;
+        ++polygon_version_;
+        ++solution_version_;
+        publishVisualization();
+      } else {
+        ROS_ERROR("Failed setting up the planner. Keeping the previous one.");
+      }
+      publishDiagnostics("setup", success);
+    }
+    job.done.set_value(success);
+  }
+}
+
 bool PolygonPlannerBase::setPolygonCallback(
     polygon_coverage_msgs::PolygonService::Request& request,
     polygon_coverage_msgs::PolygonService::Response& response) {
-  PolygonWithHoles temp_pwh;
-  double temp_alt;
-  if (!polygonFromMsg(request.polygon, &temp_pwh, &temp_alt,
-                      &global_frame_id_)) {
+  if (background_setup_) {
+    std::future<bool> done;
+    if (!queueSetup(request.polygon, &done)) {
+      ROS_ERROR_STREAM("Failed loading correct polygon.");
+      return false;
+    }
+    // Only this spinner thread waits for the setup.
+    response.success = done.get();
+    return true;
+  }
+
+  std::unique_lock<std::mutex> lock(planner_mutex_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    ROS_WARN("Planner busy. Cannot set polygon.");
+    response.success = false;
+    return true;
+  }
+  if (!setPolygon(request.polygon)) {
     ROS_ERROR_STREAM("Failed loading correct polygon.");
     ROS_ERROR_STREAM("Planner is in an invalid state.");
     polygon_.reset();
     return false;
   }
-  polygon_ = std::make_optional(temp_pwh);
-  altitude_ = std::make_optional(temp_alt);
 
-  ROS_INFO_STREAM("Successfully loaded polygon.");
-  ROS_INFO_STREAM("Altitude: " << altitude_.value() << "m");
-  ROS_INFO_STREAM("Global frame: " << global_frame_id_);
-  ROS_INFO_STREAM("Polygon:" << polygon_.value());
-
-  response.success = resetPlanner();
+  response.success = reset();
   return true;  // Still return true to identify service has been reached.
 }
 
 bool PolygonPlannerBase::planPathCallback(
     mav_planning_msgs::PlannerService::Request& request,
     mav_planning_msgs::PlannerService::Response& response) {
+  std::unique_lock<std::mutex> lock(planner_mutex_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    ROS_WARN("Planner busy. Use the plan_path_action to queue plans.");
+    response.success = false;
+    return true;
+  }
   planning_complete_ = false;
   if (!polygon_.has_value()) {
     ROS_WARN("Polygon not set. Cannot plan path.");
@@ -373,8 +604,115 @@ bool PolygonPlannerBase::planPathCallback(
   return true;
 }
 
+namespace {
+// Publishes the pipeline stages started on the action server thread as
+// feedback. Forwards all spans to the previously registered hook.
+class FeedbackHook : public tracing::Hook {
+ public:
+  typedef actionlib::SimpleActionServer<polygon_coverage_msgs::PlanPathAction>
+      Server;
+
+  explicit FeedbackHook(Server* server)
+      : server_(server),
+        previous_(tracing::Trace::GetHook()),
+        thread_(std::this_thread::get_id()),
+        start_(std::chrono::steady_clock::now()) {
+    tracing::Trace::SetHook(this);
+  }
+  ~FeedbackHook() { tracing::Trace::SetHook(previous_); }
+
+  void Begin(const char* name) override {
+    if (previous_) previous_->Begin(name);
+    // Skip the spans of worker threads, e.g., per cell sweeps.
+    if (std::this_thread::get_id() != thread_) return;
+    polygon_coverage_msgs::PlanPathFeedback feedback;
+    feedback.stage = name;
+    feedback.elapsed = std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - start_)
+                           .count();
+    server_->publishFeedback(feedback);
+  }
+  void End(const char* name) override {
+    if (previous_) previous_->End(name);
+  }
+
+ private:
+  Server* server_;
+  tracing::Hook* previous_;
+  std::thread::id thread_;
+  std::chrono::steady_clock::time_point start_;
+};
+}  // namespace
+
+void PolygonPlannerBase::planPathActionCallback(
+    const polygon_coverage_msgs::PlanPathGoalConstPtr& goal) {
+  polygon_coverage_msgs::PlanPathResult result;
+  result.success = false;
+  const bool has_polygon = !goal->polygon.polygon.hull.points.empty();
+  if (has_polygon && background_setup_) {
+    // All setups run on the setup worker.
+    std::future<bool> done;
+    if (!queueSetup(goal->polygon, &done) || !done.get()) {
+      ROS_ERROR("Failed setting up the planner for the goal polygon.");
+      plan_path_action_server_->setAborted(result);
+      return;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(planner_mutex_);
+  // A preemption before the lock cancels this goal right away.
+  is_preempted_ = plan_path_action_server_->isPreemptRequested();
+  FeedbackHook feedback_hook(plan_path_action_server_.get());
+
+  if (has_polygon && !background_setup_) {
+    planning_complete_ = false;
+    if (!setPolygon(goal->polygon) || !reset()) {
+      ROS_ERROR("Failed setting up the planner for the goal polygon.");
+      plan_path_action_server_->setAborted(result);
+      return;
+    }
+    publishVisualization();
+  }
+  if (!polygon_.has_value() || !altitude_.has_value()) {
+    ROS_WARN("Polygon not set. Cannot plan path.");
+    plan_path_action_server_->setAborted(result);
+    return;
+  }
+
+  const Point_2 start(goal->start_pose.pose.position.x,
+                      goal->start_pose.pose.position.y);
+  const Point_2 goal_point(goal->goal_pose.pose.position.x,
+                           goal->goal_pose.pose.position.y);
+  solve(start, goal_point, Deadline(goal->time_budget, &is_preempted_));
+  result.success = planning_complete_;
+  if (planning_complete_) {
+    msgMultiDofJointTrajectoryFromPath(solution_, altitude_.value(),
+                                       &result.sampled_plan);
+    result.cost = path_cost_function_.first(solution_);
+  }
+
+  if (is_preempted_) {
+    // The best solution found until the preemption, if any.
+    plan_path_action_server_->setPreempted(result);
+  } else if (planning_complete_) {
+    plan_path_action_server_->setSucceeded(result);
+  } else {
+    plan_path_action_server_->setAborted(result);
+  }
+}
+
+void PolygonPlannerBase::preemptPlanPathActionCallback() {
+  ROS_INFO("Preempting the plan path action.");
+  is_preempted_ = true;
+}
+
 bool PolygonPlannerBase::publishAllCallback(
     std_srvs::Empty::Request& request, std_srvs::Empty::Response& response) {
+  std::unique_lock<std::mutex> lock(planner_mutex_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    ROS_WARN("Planner busy. Cannot publish.");
+    return false;
+  }
   bool success_publish_trajectory = publishTrajectoryPoints();
   bool success_publish_visualization = publishVisualization();
   return (success_publish_trajectory && success_publish_visualization);
@@ -382,14 +720,95 @@ bool PolygonPlannerBase::publishAllCallback(
 
 bool PolygonPlannerBase::publishVisualizationCallback(
     std_srvs::Empty::Request& request, std_srvs::Empty::Response& response) {
+  std::unique_lock<std::mutex> lock(planner_mutex_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    ROS_WARN("Planner busy. Cannot publish visualization.");
+    return false;
+  }
   return publishVisualization();
 }
 
 bool PolygonPlannerBase::publishTrajectoryPointsCallback(
     std_srvs::Empty::Request& request, std_srvs::Empty::Response& response) {
+  std::unique_lock<std::mutex> lock(planner_mutex_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    ROS_WARN("Planner busy. Cannot publish trajectory points.");
+    return false;
+  }
   return publishTrajectoryPoints();
 }
 
+bool PolygonPlannerBase::reset() {
+  const bool success = resetPlanner();
+  ++polygon_version_;
+  ++solution_version_;
+  publishDiagnostics("setup", success);
+  return success;
+}
+
+void PolygonPlannerBase::publishDiagnostics(const std::string& stage,
+                                            bool success) {
+  diagnostic_msgs::DiagnosticStatus status;
+  status.name = ros::this_node::getName();
+  status.hardware_id = global_frame_id_;
+  status.level = success ? diagnostic_msgs::DiagnosticStatus::OK
+                         : diagnostic_msgs::DiagnosticStatus::ERROR;
+  status.message = stage + (success ? " succeeded" : " failed");
+
+  // Stage timings accumulate over all setups and solves of this node. [s]
+  for (const std::pair<const std::string, size_t>& timer :
+       timing::Timing::GetTimers()) {
+    const size_t num_samples = timing::Timing::GetNumSamples(timer.second);
+    if (num_samples == 0) continue;
+    addDiagnosticValue(timer.first + ".num_samples", num_samples, &status);
+    addDiagnosticValue(timer.first + ".total",
+                       timing::Timing::GetTotalSeconds(timer.second), &status);
+    addDiagnosticValue(timer.first + ".mean",
+                       timing::Timing::GetMeanSeconds(timer.second), &status);
+    addDiagnosticValue(timer.first + ".max",
+                       timing::Timing::GetMaxSeconds(timer.second), &status);
+    addDiagnosticValue(
+        timer.first + ".p95",
+        timing::Timing::GetPercentileSeconds(timer.second, 95.0), &status);
+    addDiagnosticValue(
+        timer.first + ".p99",
+        timing::Timing::GetPercentileSeconds(timer.second, 99.0), &status);
+  }
+  // Memory of the last setup. [bytes]
+  for (const std::pair<const std::string, memory::Usage>& usage :
+       memory::Memory::GetUsage()) {
+    addDiagnosticValue(usage.first + ".bytes", usage.second.bytes, &status);
+  }
+  addPlannerDiagnostics(&status);
+
+  diagnostic_msgs::DiagnosticArray diagnostics;
+  diagnostics.header.stamp = ros::Time::now();
+  diagnostics.status.push_back(status);
+  diagnostics_pub_.publish(diagnostics);
+}
+
+void PolygonPlannerBase::addDiagnosticValue(
+    const std::string& key, double value,
+    diagnostic_msgs::DiagnosticStatus* status) {
+  ROS_ASSERT(status);
+  std::stringstream ss;
+  ss << value;
+  diagnostic_msgs::KeyValue key_value;
+  key_value.key = key;
+  key_value.value = ss.str();
+  status->values.push_back(key_value);
+}
+
+void PolygonPlannerBase::addDiagnosticValue(
+    const std::string& key, size_t value,
+    diagnostic_msgs::DiagnosticStatus* status) {
+  ROS_ASSERT(status);
+  diagnostic_msgs::KeyValue key_value;
+  key_value.key = key;
+  key_value.value = std::to_string(value);
+  status->values.push_back(key_value);
+}
+
 // Reset the planner when a new polygon is set.
 bool PolygonPlannerBase::resetPlanner() {
   ROS_ERROR_STREAM("resetPlanner is not implemented.");
@@ -399,6 +818,11 @@ bool PolygonPlannerBase::resetPlanner() {
 void PolygonPlannerBase::clickPointCallback(
     const geometry_msgs::PointStampedConstPtr& msg) {
   if (!set_start_goal_from_rviz_) return;
+  std::unique_lock<std::mutex> lock(planner_mutex_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    ROS_WARN("Planner busy. Ignoring clicked point.");
+    return;
+  }
 
   if (!start_.has_value()) {
     ROS_INFO("Selecting START from RVIZ PublishPoint tool.");
@@ -422,19 +846,21 @@ void PolygonPlannerBase::clickPolygonCallback(
   if (!set_polygon_from_rviz_) return;
 
   ROS_INFO("Updating polygon from RVIZ polygon tool.");
-  PolygonWithHoles temp_pwh;
-  double temp_alt;
-  if (polygonFromMsg(msg, &temp_pwh, &temp_alt, &global_frame_id_)) {
-    ROS_INFO_STREAM("Successfully loaded polygon.");
-    ROS_INFO_STREAM("Altitude: " << temp_alt << " m");
-    ROS_INFO_STREAM("Global frame: " << global_frame_id_);
-    ROS_INFO_STREAM("Polygon:" << temp_pwh);
-    polygon_ = std::make_optional(temp_pwh);
-    altitude_ = std::make_optional(temp_alt);
+  if (background_setup_) {
+    if (!queueSetup(msg, nullptr)) ROS_ERROR("Failed loading polygon.");
+    return;
   }
 
+  std::unique_lock<std::mutex> lock(planner_mutex_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    ROS_WARN("Planner busy. Ignoring polygon.");
+    return;
+  }
+
+  setPolygon(msg);
+
   planning_complete_ = false;
-  resetPlanner();
+  reset();
   publishVisualization();
 
   return;
@@ -20,7 +20,11 @@
 #include "polygon_coverage_ros/ros_interface.h"
 
 #include <algorithm>
+#include <iterator>
 #include <limits>
+#include <set>
+#include <string>
+#include <utility>
 
 #include <geometry_msgs/Point.h>
 #include <mav_msgs/conversions.h>
@@ -29,6 +33,7 @@
 #include <polygon_coverage_geometry/cgal_comm.h>
 #include <polygon_coverage_geometry/cgal_definitions.h>
 #include <polygon_coverage_geometry/triangulation.h>
+#include <polygon_coverage_msgs/conversion.h>
 #include <ros/assert.h>
 #include <ros/ros.h>
 #include <Eigen/Core>
@@ -72,10 +77,11 @@ void poseArrayMsgFromPath(
     geometry_msgs::PoseArray* trajectory_points_pose_array) {
   ROS_ASSERT(trajectory_points_pose_array);
 
-  mav_msgs::EigenTrajectoryPointVector eigen_traj;
-  eigenTrajectoryPointVectorFromPath(waypoints, altitude, &eigen_traj);
-  poseArrayMsgFromEigenTrajectoryPointVector(eigen_traj, frame_id,
-                                             trajectory_points_pose_array);
+  trajectory_points_pose_array->header.frame_id = frame_id;
+  trajectory_points_pose_array->poses.reserve(
+      trajectory_points_pose_array->poses.size() + waypoints.size());
+  appendPoseArrayMsgFromPath(waypoints.begin(), waypoints.end(), altitude,
+                             trajectory_points_pose_array);
 }
 
 void msgMultiDofJointTrajectoryFromPath(
@@ -83,9 +89,77 @@ void msgMultiDofJointTrajectoryFromPath(
     trajectory_msgs::MultiDOFJointTrajectory* msg) {
   ROS_ASSERT(msg);
 
-  mav_msgs::EigenTrajectoryPointVector eigen_traj;
-  eigenTrajectoryPointVectorFromPath(waypoints, altitude, &eigen_traj);
-  mav_msgs::msgMultiDofJointTrajectoryFromEigen(eigen_traj, msg);
+  // Same layout as mav_msgs::msgMultiDofJointTrajectoryFromEigen.
+  msg->header.stamp = ros::Time::now();
+  msg->points.clear();
+  msg->points.reserve(waypoints.size());
+  appendMsgMultiDofJointTrajectoryFromPath(waypoints.begin(), waypoints.end(),
+                                           altitude, msg);
+  msg->joint_names.clear();
+  msg->joint_names.push_back("base_link");
+}
+
+void appendPoseArrayMsgFromPath(
+    std::vector<Point_2>::const_iterator begin,
+    std::vector<Point_2>::const_iterator end, double altitude,
+    geometry_msgs::PoseArray* trajectory_points_pose_array) {
+  ROS_ASSERT(trajectory_points_pose_array);
+  appendPosesFromPath(begin, end, altitude,
+                      &trajectory_points_pose_array->poses);
+}
+
+void appendPosesFromPath(std::vector<Point_2>::const_iterator begin,
+                         std::vector<Point_2>::const_iterator end,
+                         double altitude,
+                         std::vector<geometry_msgs::Pose>* poses) {
+  ROS_ASSERT(poses);
+
+  for (auto it = begin; it != end; ++it) {
+    geometry_msgs::Pose pose;
+    pose.position.x = CGAL::to_double(it->x());
+    pose.position.y = CGAL::to_double(it->y());
+    pose.position.z = altitude;
+    pose.orientation.w = 1.0;
+    poses->push_back(pose);
+  }
+}
+
+bool forEachWaypointChunk(const std::vector<Point_2>& waypoints,
+                          size_t chunk_size,
+                          const WaypointChunkVisitor& visit) {
+  ROS_ASSERT(chunk_size > 0);
+  size_t sequence = 0;
+  for (auto begin = waypoints.begin(); begin != waypoints.end(); ++sequence) {
+    const size_t size = std::min(
+        chunk_size, static_cast<size_t>(std::distance(begin, waypoints.end())));
+    const auto end = begin + size;
+    if (!visit(begin, end, sequence)) return false;
+    begin = end;
+  }
+  return true;
+}
+
+size_t getNumberOfWaypointChunks(size_t num_waypoints, size_t chunk_size) {
+  ROS_ASSERT(chunk_size > 0);
+  return (num_waypoints + chunk_size - 1) / chunk_size;
+}
+
+void appendMsgMultiDofJointTrajectoryFromPath(
+    std::vector<Point_2>::const_iterator begin,
+    std::vector<Point_2>::const_iterator end, double altitude,
+    trajectory_msgs::MultiDOFJointTrajectory* msg) {
+  ROS_ASSERT(msg);
+
+  // Reuse a single trajectory point instead of converting the whole path.
+  mav_msgs::EigenTrajectoryPoint trajectory_point;
+  for (auto it = begin; it != end; ++it) {
+    trajectory_point.position_W = Eigen::Vector3d(
+        CGAL::to_double(it->x()), CGAL::to_double(it->y()), altitude);
+    trajectory_msgs::MultiDOFJointTrajectoryPoint point_msg;
+    mav_msgs::msgMultiDofJointTrajectoryPointFromEigen(trajectory_point,
+                                                       &point_msg);
+    msg->points.push_back(point_msg);
+  }
 }
 
 void createMarkers(const std::vector<Point_2>& vertices, double altitude,
@@ -129,6 +203,45 @@ void createMarkers(const std::vector<Point_2>& vertices, double altitude,
   }
 }
 
+void decimatePath(const std::vector<Point_2>& waypoints, size_t max_waypoints,
+                  std::vector<Point_2>* decimated) {
+  ROS_ASSERT(decimated);
+  decimated->clear();
+  max_waypoints = std::max(max_waypoints, static_cast<size_t>(2));
+  if (waypoints.size() <= max_waypoints) {
+    *decimated = waypoints;
+    return;
+  }
+  // Round the stride up to stay within the limit including the last waypoint.
+  const size_t stride = (waypoints.size() - 2) / (max_waypoints - 1) + 1;
+  decimated->reserve(max_waypoints);
+  for (size_t i = 0; i < waypoints.size() - 1; i += stride) {
+    decimated->push_back(waypoints[i]);
+  }
+  decimated->push_back(waypoints.back());
+}
+
+void appendMarkerUpdate(const visualization_msgs::MarkerArray& previous,
+                        const visualization_msgs::MarkerArray& current,
+                        visualization_msgs::MarkerArray* update) {
+  ROS_ASSERT(update);
+  std::set<std::pair<std::string, int>> current_ids;
+  for (const visualization_msgs::Marker& m : current.markers) {
+    current_ids.emplace(m.ns, m.id);
+  }
+  for (const visualization_msgs::Marker& m : previous.markers) {
+    if (current_ids.count(std::make_pair(m.ns, m.id))) continue;
+    visualization_msgs::Marker deletion;
+    deletion.header = m.header;
+    deletion.ns = m.ns;
+    deletion.id = m.id;
+    deletion.action = visualization_msgs::Marker::DELETE;
+    update->markers.push_back(deletion);
+  }
+  update->markers.insert(update->markers.end(), current.markers.begin(),
+                         current.markers.end());
+}
+
 void createPolygonMarkers(const PolygonWithHoles& polygon, double altitude,
                           const std::string& frame_id, const std::string& ns,
                           const Color& polygon_color, const Color& hole_color,
@@ -251,7 +364,7 @@ void createStartAndEndTextMarkers(const mav_msgs::EigenTrajectoryPoint& start,
   start_text->header.frame_id = end_text->header.frame_id = frame_id;
   start_text->header.stamp = end_text->header.stamp = ros::Time::now();
   start_text->ns = ns + "_start_text";
-  start_text->ns = ns + "_end_text";
+  end_text->ns = ns + "_end_text";
   start_text->action = end_text->action = visualization_msgs::Marker::ADD;
   start_text->type = end_text->type =
       visualization_msgs::Marker::TEXT_VIEW_FACING;
@@ -277,12 +390,7 @@ void createStartAndEndTextMarkers(const mav_msgs::EigenTrajectoryPoint& start,
 void polygon2FromPolygonMsg(const geometry_msgs::Polygon& msg,
                             Polygon_2* polygon) {
   ROS_ASSERT(polygon);
-
-  std::vector<Point_2> vertices(msg.points.size());
-  for (size_t i = 0; i < msg.points.size(); ++i)
-    vertices[i] = Point_2(msg.points[i].x, msg.points[i].y);
-
-  *polygon = Polygon_2(vertices.begin(), vertices.end());
+  convertPolygonFromMsg(msg, polygon);
 }
 
 bool polygonFromMsg(const polygon_coverage_msgs::PolygonWithHolesStamped& msg,
@@ -307,11 +415,10 @@ bool polygonFromMsg(const polygon_coverage_msgs::PolygonWithHolesStamped& msg,
   polygon2FromPolygonMsg(msg.polygon.hull, &hull);
   if (hull.is_clockwise_oriented()) hull.reverse_orientation();
 
-  std::list<Polygon_2> holes(msg.polygon.holes.size());
-  for (size_t i = 0; i < msg.polygon.holes.size(); ++i) {
-    auto hole = std::next(holes.begin(), i);
-    polygon2FromPolygonMsg(msg.polygon.holes[i], &(*hole));
-    if (hole->is_counterclockwise_oriented()) hole->reverse_orientation();
+  std::list<Polygon_2> holes;
+  convertPolygonsFromMsg(msg.polygon.holes, &holes);
+  for (Polygon_2& hole : holes) {
+    if (hole.is_counterclockwise_oriented()) hole.reverse_orientation();
   }
 
   // Cut holes from hull.
@@ -322,7 +429,7 @@ bool polygonFromMsg(const polygon_coverage_msgs::PolygonWithHolesStamped& msg,
     ROS_ERROR("Failed to create polygon with holes from msg.");
     return false;
   }
-  *polygon = res.front();
+  *polygon = std::move(res.front());
 
   if (polygon->outer_boundary().size() < 3) {
     ROS_ERROR_STREAM("Input polygon is not valid.");
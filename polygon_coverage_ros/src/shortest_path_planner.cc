@@ -19,9 +19,12 @@
 
 #include "polygon_coverage_ros/shortest_path_planner.h"
 
+#include <algorithm>
+
 #include <geometry_msgs/PointStamped.h>
 #include <polygon_coverage_geometry/cgal_definitions.h>
 #include <polygon_coverage_geometry/offset.h>
+#include <polygon_coverage_solvers/parallel.h>
 #include <ros/console.h>
 #include <ros/ros.h>
 #include <ros/topic.h>
@@ -30,14 +33,25 @@ namespace polygon_coverage_planning {
 
 ShortestPathPlanner::ShortestPathPlanner(const ros::NodeHandle& nh,
                                          const ros::NodeHandle& nh_private)
-    : PolygonPlannerBase(nh, nh_private) {
+    : PolygonPlannerBase(nh, nh_private), num_threads_(1) {
+  int num_threads_int = static_cast<int>(num_threads_);
+  if (nh_private_.getParam("num_threads", num_threads_int)) {
+    num_threads_ = static_cast<size_t>(std::max(num_threads_int, 0));
+  }
+  ROS_INFO_STREAM("Shortest path planner threads: " << num_threads_);
+  plan_path_batch_srv_ = nh_private_.advertiseService(
+      "plan_path_batch", &ShortestPathPlanner::planPathBatchCallback, this);
+
   // Creating the visibility graph from the received parameters.
   // This operation may take some time.
-  resetPlanner();
+  reset();
 }
 
+ShortestPathPlanner::~ShortestPathPlanner() { stopSetupWorker(); }
+
 bool ShortestPathPlanner::solvePlanner(const Point_2& start,
-                                       const Point_2& goal) {
+                                       const Point_2& goal,
+                                       const Deadline& deadline) {
   return planner_->solveWithOutsideStartAndGoal(start, goal, &solution_);
 }
 
@@ -50,7 +64,8 @@ bool ShortestPathPlanner::resetPlanner() {
   }
   PolygonWithHoles temp_poly = polygon_.value();
   computeOffsetPolygon(temp_poly, wall_distance_, &polygon_.value());
-  planner_.reset(new visibility_graph::VisibilityGraph(polygon_.value()));
+  planner_.reset(
+      new visibility_graph::VisibilityGraph(polygon_.value(), num_threads_));
   if (planner_->isInitialized()) {
     ROS_INFO("Finished creating the shortest plan graph.");
     return true;
@@ -60,4 +75,99 @@ bool ShortestPathPlanner::resetPlanner() {
   }
 }
 
+bool ShortestPathPlanner::preparePlanner(const PolygonWithHoles& polygon,
+                                         std::optional<double>* altitude) {
+  ROS_INFO_STREAM("Start preparing the shortest plan graph.");
+  computeOffsetPolygon(polygon, wall_distance_, &next_polygon_);
+  next_planner_.reset(
+      new visibility_graph::VisibilityGraph(next_polygon_, num_threads_));
+  if (next_planner_->isInitialized()) {
+    ROS_INFO("Finished preparing the shortest plan graph.");
+    return true;
+  } else {
+    ROS_ERROR("Failed preparing shortest path planner from user input.");
+    return false;
+  }
+}
+
+void ShortestPathPlanner::commitPlanner() {
+  planner_ = std::move(next_planner_);
+  polygon_ = std::make_optional(next_polygon_);
+}
+
+bool ShortestPathPlanner::planPathBatchCallback(
+    polygon_coverage_msgs::ShortestPathBatchService::Request& request,
+    polygon_coverage_msgs::ShortestPathBatchService::Response& response) {
+  response.success = false;
+  std::unique_lock<std::mutex> lock(planner_mutex_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    ROS_WARN("Planner busy. Cannot plan paths.");
+    return true;
+  }
+  if (planner_ == nullptr || !planner_->isInitialized()) {
+    ROS_WARN("Planner not initialized. Cannot plan paths.");
+    return true;
+  }
+  if (!request.all_pairs && request.starts.size() != request.goals.size()) {
+    ROS_WARN("Number of starts and goals differ. Cannot plan paths.");
+    return true;
+  }
+
+  std::vector<Point_2> starts, goals;
+  for (const geometry_msgs::Point& p : request.starts) {
+    starts.emplace_back(p.x, p.y);
+  }
+  for (const geometry_msgs::Point& p : request.goals) {
+    goals.emplace_back(p.x, p.y);
+  }
+  const PathCostFunction& cost_function = path_cost_function_.first;
+  std::vector<double> costs(request.all_pairs ? starts.size() * goals.size()
+                                              : starts.size(),
+                            -1.0);
+
+  if (request.all_pairs) {
+    // Snap goals into the polygon once and solve one row per start.
+    std::vector<Point_2> goals_new(goals.size());
+    for (size_t j = 0; j < goals.size(); ++j) {
+      goals_new[j] = planner_->containsPoint(goals[j])
+                         ? goals[j]
+                         : planner_->projectOnHull(goals[j]);
+    }
+    const std::vector<const Polygon_2*> goal_visibility_polygons(
+        goals.size(), nullptr);
+    parallelFor(starts.size(), num_threads_, [&](size_t i) {
+      const Point_2 start_new = planner_->containsPoint(starts[i])
+                                    ? starts[i]
+                                    : planner_->projectOnHull(starts[i]);
+      std::vector<std::vector<Point_2>> paths;
+      if (!planner_->solveOneToMany(start_new, nullptr, goals_new,
+                                    goal_visibility_polygons, &paths)) {
+        return true;
+      }
+      for (size_t j = 0; j < goals.size(); ++j) {
+        std::vector<Point_2>& path = paths[j];
+        if (path.empty()) continue;
+        // Same as solveWithOutsideStartAndGoal.
+        if (start_new != starts[i]) path.insert(path.begin(), starts[i]);
+        if (goals_new[j] != goals[j]) path.push_back(goals[j]);
+        costs[i * goals.size() + j] = cost_function(path);
+      }
+      return true;
+    });
+  } else {
+    parallelFor(starts.size(), num_threads_, [&](size_t i) {
+      std::vector<Point_2> path;
+      if (planner_->solveWithOutsideStartAndGoal(starts[i], goals[i], &path)) {
+        costs[i] = cost_function(path);
+      }
+      return true;
+    });
+  }
+
+  response.costs = costs;
+  response.success = std::none_of(costs.begin(), costs.end(),
+                                  [](double c) { return c < 0.0; });
+  return true;
+}
+
 }  // namespace polygon_coverage_planning
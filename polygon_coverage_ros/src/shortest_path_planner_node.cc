@@ -30,8 +30,11 @@ int main(int argc, char** argv) {
   ros::NodeHandle nh_private("~");
   // Creating the coverage planner with ros interface
   polygon_coverage_planning::ShortestPathPlanner shortest_path(nh, nh_private);
-  // Spinning (and processing service calls)
-  ros::spin();
+  // Spinning (and processing service calls) on several threads such that
+  // clicks and services stay responsive during long plans.
+  ros::AsyncSpinner spinner(4);
+  spinner.start();
+  ros::waitForShutdown();
   // Exit tranquilly
   return 0;
 }
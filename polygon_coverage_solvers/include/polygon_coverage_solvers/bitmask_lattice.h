@@ -0,0 +1,98 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POLYGON_COVERAGE_SOLVERS_BITMASK_LATTICE_H_
+#define POLYGON_COVERAGE_SOLVERS_BITMASK_LATTICE_H_
+
+#include <cstdint>
+#include <limits>
+#include <set>
+
+#include "polygon_coverage_solvers/graph_base.h"
+
+namespace polygon_coverage_planning {
+namespace boolean_lattice {
+
+typedef uint64_t Bitmask;
+// Maximum number of clusters including start and goal cluster.
+const size_t kMaxBitmaskClusters = 63;
+
+// An implicit boolean lattice. Every node id is its visited cluster bitmask,
+// i.e., node i has visited cluster c if bit c of i is set. The successors of a
+// node are all single bit flips from 0 to 1 with zero cost. Neither nodes nor
+// edges are stored, such that creating the lattice is free.
+// Like BooleanLattice, start and goal add a unique cluster each. The start node
+// is the empty set and the goal node is the set of all clusters.
+class BitmaskLattice {
+ public:
+  // num_clusters: Number of clusters to visit, excluding start and goal
+  // cluster.
+  BitmaskLattice(size_t num_clusters);
+  BitmaskLattice() : BitmaskLattice(0) {}
+
+  // Add the unique start cluster.
+  bool addStartNode();
+  // Add the unique goal cluster.
+  bool addGoalNode();
+
+  inline size_t size() const { return static_cast<size_t>(1) << num_clusters_; }
+  inline size_t getNumberOfClusters() const { return num_clusters_; }
+  inline size_t getStartIdx() const { return start_idx_; }
+  inline size_t getGoalIdx() const { return goal_idx_; }
+  inline size_t getStartCluster() const { return start_cluster_; }
+  inline size_t getGoalCluster() const { return goal_cluster_; }
+  inline bool isInitialized() const { return is_created_; }
+
+  inline static Bitmask clusterToBitmask(size_t cluster) {
+    return static_cast<Bitmask>(1) << cluster;
+  }
+  inline static bool includesCluster(size_t node_id, size_t cluster) {
+    return (node_id & clusterToBitmask(cluster)) != 0;
+  }
+
+  inline bool nodeExists(size_t node_id) const { return node_id < size(); }
+  // An edge exists if it adds exactly one cluster.
+  bool edgeExists(const EdgeId& edge_id) const;
+  bool getEdgeCost(const EdgeId& edge_id, double* cost) const;
+  std::set<size_t> getVisitedClusters(size_t node_id) const;
+
+  // Call visit(successor_id, added_cluster) for all successors of a node.
+  template <class Visitor>
+  void forEachSuccessor(size_t node_id, Visitor visit) const {
+    for (size_t cluster = 0; cluster < num_clusters_; ++cluster) {
+      if (!includesCluster(node_id, cluster)) {
+        visit(node_id | clusterToBitmask(cluster), cluster);
+      }
+    }
+  }
+
+ private:
+  bool addCluster(size_t* cluster);
+
+  size_t num_clusters_;  // Total number of clusters including start and goal.
+  size_t start_cluster_;  // Unique start cluster.
+  size_t goal_cluster_;   // Unique goal cluster.
+  size_t start_idx_;
+  size_t goal_idx_;
+  bool is_created_;
+};
+}  // namespace boolean_lattice
+}  // namespace polygon_coverage_planning
+
+#endif  // POLYGON_COVERAGE_SOLVERS_BITMASK_LATTICE_H_
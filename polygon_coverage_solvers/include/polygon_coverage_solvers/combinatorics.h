@@ -21,6 +21,7 @@
 #define POLYGON_COVERAGE_SOLVERS_COMBINATORICS_H_
 
 #include <cstddef>
+#include <cstdint>
 #include <set>
 #include <vector>
 
@@ -45,6 +46,67 @@ void getAllCombinationsOfKElementsFromN(
     const std::vector<size_t>& sorted_elements, int k, int start_pos,
     std::vector<size_t>* combination, std::vector<std::set<size_t>>* result);
 
+// The largest n for which k-subsets are enumerated as bitmasks.
+constexpr size_t kMaxSubsetElements = 64;
+
+// The binomial coefficient "n choose k" from a precomputed table. Does not
+// overflow for n <= kMaxSubsetElements.
+uint64_t binomial(size_t n, size_t k);
+
+// The rank of a k-subset bitmask in colexicographic order, i.e., its position
+// in the enumeration of KSubsets. O(k) table lookups.
+uint64_t rankSubset(uint64_t subset);
+// The k-subset bitmask of the given colexicographic rank.
+uint64_t unrankSubset(uint64_t rank, size_t k);
+
+// The successor of a k-subset bitmask in colexicographic order (Gosper's hack).
+inline uint64_t nextSubset(uint64_t subset) {
+  const uint64_t lowest = subset & -subset;
+  const uint64_t ripple = subset + lowest;
+  return (((ripple ^ subset) >> 2) / lowest) | ripple;
+}
+
+// Lazily enumerates all k-element subsets of {0, ..., n-1} as bitmasks in
+// colexicographic order without allocating:
+// for (uint64_t subset : KSubsets(n, k)) { ... }
+class KSubsets {
+ public:
+  class Iterator {
+   public:
+    Iterator(uint64_t subset, uint64_t rank) : subset_(subset), rank_(rank) {}
+    inline uint64_t operator*() const { return subset_; }
+    inline Iterator& operator++() {
+      // Do not step past the last subset, which may overflow for n = 64.
+      if (++rank_ < end_rank_) subset_ = nextSubset(subset_);
+      return *this;
+    }
+    inline bool operator!=(const Iterator& other) const {
+      return rank_ != other.rank_;
+    }
+    inline uint64_t rank() const { return rank_; }
+
+   private:
+    friend class KSubsets;
+    uint64_t subset_;
+    uint64_t rank_;
+    uint64_t end_rank_ = 0;
+  };
+
+  KSubsets(size_t n, size_t k);
+
+  inline Iterator begin() const {
+    Iterator it(first_, 0);
+    it.end_rank_ = size_;
+    return it;
+  }
+  inline Iterator end() const { return Iterator(0, size_); }
+  inline uint64_t size() const { return size_; }
+
+ private:
+  uint64_t first_;
+  uint64_t size_;
+};
+
 }  // namespace polygon_coverage_planning
 
 #endif /* POLYGON_COVERAGE_SOLVERS_COMBINATORICS_H_ */
@@ -0,0 +1,112 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POLYGON_COVERAGE_SOLVERS_DEADLINE_H_
+#define POLYGON_COVERAGE_SOLVERS_DEADLINE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <limits>
+
+namespace polygon_coverage_planning {
+
+// A wall clock deadline and an optional cancellation token for a single solve
+// call. The default deadline never expires.
+class Deadline {
+ public:
+  typedef std::chrono::steady_clock Clock;
+
+  Deadline() : Deadline(0.0) {}
+  // seconds: The time budget from now. Non-positive: No time limit.
+  // is_cancelled: Optional. Setting it from another thread expires the
+  // deadline.
+  explicit Deadline(double seconds,
+                    const std::atomic<bool>* is_cancelled = nullptr)
+      : has_time_limit_(seconds > 0.0),
+        end_(has_time_limit_
+                 ? Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                                      std::chrono::duration<double>(seconds))
+                 : Clock::time_point::max()),
+        is_cancelled_(is_cancelled) {}
+
+  inline bool hasTimeLimit() const { return has_time_limit_; }
+  inline bool isCancelled() const {
+    return is_cancelled_ != nullptr && *is_cancelled_;
+  }
+  inline bool isExpired() const {
+    return isCancelled() || (has_time_limit_ && Clock::now() >= end_);
+  }
+
+  // The remaining seconds. Infinite without time limit, zero if expired.
+  inline double getRemainingSeconds() const {
+    if (isCancelled()) {
+      return 0.0;
+    }
+    if (!has_time_limit_) {
+      return std::numeric_limits<double>::infinity();
+    }
+    const std::chrono::duration<double> remaining = end_ - Clock::now();
+    return std::max(remaining.count(), 0.0);
+  }
+
+  // The earlier of this deadline and seconds from now, keeping the
+  // cancellation token.
+  inline Deadline limit(double seconds) const {
+    Deadline deadline(seconds, is_cancelled_);
+    if (has_time_limit_ &&
+        (!deadline.has_time_limit_ || end_ < deadline.end_)) {
+      deadline.has_time_limit_ = true;
+      deadline.end_ = end_;
+    }
+    return deadline;
+  }
+
+ private:
+  bool has_time_limit_;
+  Clock::time_point end_;
+  const std::atomic<bool>* is_cancelled_;
+};
+
+// Cheap deadline check for tight loops, e.g., graph search expansions. Only
+// reads the clock on the first and every kInterval-th call and stays expired
+// afterwards.
+class DeadlinePoller {
+ public:
+  static constexpr size_t kInterval = 256;
+
+  explicit DeadlinePoller(const Deadline& deadline) : deadline_(deadline) {}
+
+  inline bool isExpired() {
+    if (!is_expired_ && count_++ % kInterval == 0) {
+      is_expired_ = deadline_.isExpired();
+    }
+    return is_expired_;
+  }
+
+ private:
+  const Deadline& deadline_;
+  size_t count_ = 0;
+  bool is_expired_ = false;
+};
+
+}  // namespace polygon_coverage_planning
+
+#endif  // POLYGON_COVERAGE_SOLVERS_DEADLINE_H_
@@ -0,0 +1,71 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POLYGON_COVERAGE_SOLVERS_DISTANCE_MATRIX_H_
+#define POLYGON_COVERAGE_SOLVERS_DISTANCE_MATRIX_H_
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace polygon_coverage_planning {
+
+// A square distance matrix stored contiguously in row-major order, such that
+// solvers can consume the buffer without copying. The maximum value of T marks
+// no connection.
+template <class T>
+class DistanceMatrix {
+ public:
+  static constexpr T kNoConnection = std::numeric_limits<T>::max();
+
+  DistanceMatrix() : DistanceMatrix(0) {}
+  explicit DistanceMatrix(size_t size, T value = kNoConnection)
+      : size_(size), data_(size * size, value) {}
+
+  // Convert nested rows. Returns false if the rows are not square.
+  static bool fromRows(const std::vector<std::vector<T>>& rows,
+                       DistanceMatrix* m);
+  std::vector<std::vector<T>> toRows() const;
+
+  inline size_t size() const { return size_; }
+  inline bool empty() const { return size_ == 0; }
+
+  inline T& operator()(size_t row, size_t col) {
+    return data_[row * size_ + col];
+  }
+  inline const T& operator()(size_t row, size_t col) const {
+    return data_[row * size_ + col];
+  }
+  inline T* row(size_t i) { return data_.data() + i * size_; }
+  inline const T* row(size_t i) const { return data_.data() + i * size_; }
+  inline T* data() { return data_.data(); }
+  inline const T* data() const { return data_.data(); }
+
+  bool isSymmetric() const;
+
+ private:
+  size_t size_;
+  std::vector<T> data_;
+};
+
+}  // namespace polygon_coverage_planning
+
+#include "polygon_coverage_solvers/impl/distance_matrix_impl.h"
+
+#endif  // POLYGON_COVERAGE_SOLVERS_DISTANCE_MATRIX_H_
@@ -25,18 +25,15 @@
 
 #include <mono/metadata/object.h>
 
+#include "polygon_coverage_solvers/gtsp_solver.h"
+
 // Interfaces with the GK MA GTSP solver.
 namespace polygon_coverage_planning {
 namespace gk_ma {
-struct Task {
-  Task(const std::vector<std::vector<int>>& m,
-       const std::vector<std::vector<int>>& clusters)
-      : m(m), clusters(clusters) {}
-  bool mIsSymmetric() const;
-  bool mIsSquare() const;
-  std::vector<std::vector<int>> m;
-  std::vector<std::vector<int>> clusters;
-};
+using Task = gtsp::Task;
+
+// The catkin library directory that contains GkMa.exe.
+std::string getLibraryPath();
 
 // References GkMa.exe. Singleton, because it may only be referenced once during
 // runtime.
@@ -61,13 +58,27 @@ class GkMa {
 
   MonoArray* vectorOfVectorToMonoArray(
       const std::vector<std::vector<int>>& in) const;
+  // Copies the flat row-major matrix in one block.
+  MonoArray* distanceMatrixToMonoArray(const DistanceMatrix<int>& m) const;
 
   MonoDomain* domain_;
   MonoObject* solver_;
   MonoClass* solver_class_;
+  // Cached method handles.
+  MonoMethod* file_ctor_;
+  MonoMethod* task_ctor_;
+  MonoMethod* solve_;
+  MonoMethod* get_solution_;
 
   std::vector<int> solution_;
 };
+
+// Common solver interface to the GkMa singleton. Concurrent calls are
+// serialized, because there is only one Mono runtime.
+class GkMaSolver : public gtsp::SolverBase {
+ public:
+  bool solve(const Task& task, std::vector<int>* solution) override;
+};
 }  // namespace gk_ma
 }  // namespace polygon_coverage_planning
 
@@ -0,0 +1,104 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POLYGON_COVERAGE_SOLVERS_GK_MA_POOL_H_
+#define POLYGON_COVERAGE_SOLVERS_GK_MA_POOL_H_
+
+#include <sys/types.h>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "polygon_coverage_solvers/gtsp_solver.h"
+
+// Hosts the GK MA GTSP solver in long-lived worker processes. Mono can only be
+// initialized once per process, so every worker runs its own runtime and
+// solves in different workers run concurrently.
+namespace polygon_coverage_planning {
+namespace gk_ma {
+using Task = gtsp::Task;
+
+// Shared memory layout in 32 bit integers:
+// num_nodes | num_clusters | num_cluster_nodes | solution_size |
+// solution[num_clusters] | cluster_sizes[num_clusters] |
+// cluster_nodes[num_cluster_nodes] | m[num_nodes * num_nodes]
+size_t getSharedTaskSize(const Task& task);  // In bytes.
+void writeSharedTask(const Task& task, int32_t* data);
+bool readSharedTask(const int32_t* data, size_t size, Task* task);
+void writeSharedSolution(const std::vector<int>& solution, int32_t* data);
+bool readSharedSolution(const int32_t* data, size_t size,
+                        std::vector<int>* solution);
+
+// A pool of gk_ma_worker processes. Each worker has a shared memory segment
+// for the task and the tour and a socket to signal requests and replies.
+// Workers are spawned on demand up to the maximum number of workers and are
+// terminated with the pool.
+class GkMaWorkerPool {
+ public:
+  inline static GkMaWorkerPool& getInstance() {
+    static GkMaWorkerPool instance;
+    return instance;
+  }
+  GkMaWorkerPool(GkMaWorkerPool const&) = delete;
+  void operator=(GkMaWorkerPool const&) = delete;
+
+  // Solve on an idle worker. Blocks while all workers are busy and the pool
+  // is full. Thread-safe.
+  bool solve(const Task& task, std::vector<int>* solution);
+
+  // 0: hardware concurrency.
+  void setMaxWorkers(size_t max_workers);
+  size_t getNumWorkers() const;
+
+ private:
+  struct Worker {
+    pid_t pid = -1;
+    int socket = -1;  // Parent end.
+    int shm = -1;     // Shared memory file descriptor.
+  };
+
+  GkMaWorkerPool();
+  ~GkMaWorkerPool();
+
+  bool spawnWorker(Worker* worker) const;
+  void terminateWorker(Worker* worker) const;
+  // Run a task on a worker. Returns false if the task or the worker failed.
+  bool runWorker(Worker* worker, const Task& task, std::vector<int>* solution,
+                 bool* is_alive) const;
+
+  mutable std::mutex mutex_;
+  std::condition_variable worker_released_;
+  std::vector<std::unique_ptr<Worker>> idle_workers_;
+  size_t num_workers_;  // Idle and busy.
+  size_t max_workers_;
+  std::string worker_path_;
+};
+
+// Common solver interface to the worker pool.
+class GkMaPoolSolver : public gtsp::SolverBase {
+ public:
+  bool solve(const Task& task, std::vector<int>* solution) override;
+};
+}  // namespace gk_ma
+}  // namespace polygon_coverage_planning
+
+#endif  // POLYGON_COVERAGE_SOLVERS_GK_MA_POOL_H_
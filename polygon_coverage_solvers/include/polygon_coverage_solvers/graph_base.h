@@ -21,10 +21,14 @@
 #define POLYGON_COVERAGE_SOLVERS_GRAPH_BASE_H_
 
 #include <cmath>
+#include <functional>
 #include <limits>
 #include <map>
 #include <vector>
 
+#include "polygon_coverage_solvers/distance_matrix.h"
+#include "polygon_coverage_solvers/graph_search.h"
+
 // Utilities to create graphs.
 namespace polygon_coverage_planning {
 
@@ -45,13 +49,22 @@ typedef std::pair<size_t, size_t> EdgeId;
 // An edge.
 typedef std::pair<EdgeId, double> Edge;
 
-// The solution.
-typedef std::vector<size_t> Solution;
-
 // A heuristic.
-// first: node
-// second: heuristic cost to goal
-typedef std::map<size_t, double> Heuristic;
+// Sets the heuristic cost to goal of a node. Evaluated lazily on the nodes a
+// search touches. Returns false if the node has no heuristic.
+typedef std::function<bool(size_t, double*)> Heuristic;
+
+// Create the flat row-major distance matrix of any graph providing size() and
+// forEachNeighbor(), e.g., GraphBase or GraphOverlay. No connections are set to
+// DistanceMatrix<T>::kNoConnection and cost is transformed into milli T.
+// Returns false if a cost does not fit into T, e.g., uint16_t.
+template <class Graph, class T>
+bool createDistanceMatrix(const Graph& graph, DistanceMatrix<T>* m);
+
+// Set the milli T distance from node i to j. Sets no connection and returns
+// false if the cost does not fit into T.
+template <class T>
+bool setDistance(size_t i, size_t j, double cost, DistanceMatrix<T>* m);
 
 // The base graph class.
 template <class NodeProperty, class EdgeProperty>
@@ -65,10 +78,11 @@ class GraphBase {
   GraphBase()
       : start_idx_(std::numeric_limits<size_t>::max()),
         goal_idx_(std::numeric_limits<size_t>::max()),
-        is_created_(false){};
+        is_created_(false),
+        is_compact_(false){};
 
-  // Add a node.
-  bool addNode(const NodeProperty& node_property);
+  // Add a node. The property is moved into the graph.
+  bool addNode(NodeProperty node_property);
   // Add a start node, that often follows special construction details.
   virtual bool addStartNode(const NodeProperty& node_property);
   // Add a goal node, that often follows special construction details.
@@ -78,6 +92,17 @@ class GraphBase {
   void clearEdges();
   // Create graph given the internal settings.
   virtual bool create() = 0;
+  // Freeze the graph into a compressed sparse row (CSR) layout. Neighbor ids
+  // and costs are stored in flat arrays and node properties in a vector
+  // indexed by node id. Searches and lookups use the compact layout until the
+  // graph is modified again. Call after create().
+  bool compact();
+  inline bool isCompact() const { return is_compact_; }
+  // Estimated bytes of the node and of the edge containers, including the
+  // compact layout. Properties count with sizeof only; derived graphs add the
+  // heap memory their properties own.
+  size_t getNodeBytes() const;
+  size_t getEdgeBytes() const;
 
   inline size_t size() const { return graph_.size(); }
   inline size_t getNumberOfEdges() const { return edge_properties_.size(); }
@@ -94,19 +119,32 @@ class GraphBase {
   bool getEdgeCost(const EdgeId& edge_id, double* cost) const;
   const NodeProperty* getNodeProperty(size_t node_id) const;
   const EdgeProperty* getEdgeProperty(const EdgeId& edge_id) const;
+  // Call visit(neighbor_id, cost) for all neighbors of a node. Iteration stops
+  // early if visit returns false.
+  template <class Visitor>
+  void forEachNeighbor(size_t node_id, Visitor visit) const;
 
   // Solve the graph with Dijkstra using arbitrary start and goal index.
-  bool solveDijkstra(size_t start, size_t goal, Solution* solution) const;
+  // Searches only read the graph. Concurrent searches on a compact graph are
+  // safe if each uses its own (optional) workspace.
+  bool solveDijkstra(size_t start, size_t goal, Solution* solution,
+                     SearchWorkspace* workspace = nullptr) const;
   // Solve the graph with Dijkstra using internal start and goal index.
   bool solveDijkstra(Solution* solution) const;
   // Solve the graph with A* using arbitrary start and goal index.
-  bool solveAStar(size_t start, size_t goal, Solution* solution) const;
+  bool solveAStar(size_t start, size_t goal, Solution* solution,
+                  SearchWorkspace* workspace = nullptr) const;
   // Solve the graph with A* using internal start and goal index.
   bool solveAStar(Solution* solution) const;
 
   // Create the adjacency matrix setting no connectings to INT_MAX and
   // transforming cost into milli int.
   std::vector<std::vector<int>> getAdjacencyMatrix() const;
+  // Create the flat row-major distance matrix setting no connections to
+  // DistanceMatrix<T>::kNoConnection and transforming cost into milli T.
+  // Returns false if a cost does not fit into T, e.g., uint16_t.
+  template <class T = int>
+  bool getDistanceMatrix(DistanceMatrix<T>* m) const;
 
   // Preserving three decimal digits.
   inline int doubleToMilliInt(double in) const {
@@ -120,14 +158,14 @@ class GraphBase {
   // Called from addNode. Creates all edges to the node at the back of the
   // graph.
   virtual bool addEdges() = 0;
-  // Given the goal, calculate and set the heuristic for all nodes in the graph.
-  virtual bool calculateHeuristic(size_t goal, Heuristic* heuristic) const;
+  // Given the goal, create the heuristic for the nodes in the graph.
+  virtual bool createHeuristic(size_t goal, Heuristic* heuristic) const;
 
-  bool addEdge(const EdgeId& edge_id, const EdgeProperty& edge_property,
-               double cost);
+  bool addEdge(const EdgeId& edge_id, EdgeProperty edge_property, double cost);
 
-  Solution reconstructSolution(const std::map<size_t, size_t>& came_from,
-                               size_t current) const;
+  // Leave the compact layout and move the node properties back into the map.
+  // Needs to be called before modifying the graph structures directly.
+  void uncompact();
 
   Graph graph_;
   // Map to store all node properties. Key is the graph node id.
@@ -137,6 +175,15 @@ class GraphBase {
   size_t start_idx_;
   size_t goal_idx_;
   bool is_created_;
+
+  // Compact CSR layout. The neighbors of node i are stored in
+  // [csr_offsets_[i], csr_offsets_[i + 1]) and sorted by id.
+  bool is_compact_;
+  std::vector<size_t> csr_offsets_;
+  std::vector<size_t> csr_neighbors_;
+  std::vector<double> csr_costs_;
+  // Node properties indexed by node id while the graph is compact.
+  std::vector<NodeProperty> compact_node_properties_;
 };
 }  // namespace polygon_coverage_planning
 
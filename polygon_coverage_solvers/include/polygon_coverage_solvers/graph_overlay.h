@@ -0,0 +1,116 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POLYGON_COVERAGE_SOLVERS_GRAPH_OVERLAY_H_
+#define POLYGON_COVERAGE_SOLVERS_GRAPH_OVERLAY_H_
+
+#include <limits>
+#include <map>
+#include <vector>
+
+#include "polygon_coverage_solvers/graph_base.h"
+
+namespace polygon_coverage_planning {
+
+// A small set of nodes and edges layered on top of an immutable base graph,
+// e.g., the start and goal of a single query. Overlay node ids continue after
+// the base node ids. All lookups fall through to the base graph, such that
+// the base graph is shared between queries and never copied.
+template <class NodeProperty, class EdgeProperty>
+class GraphOverlay {
+ public:
+  using Base = GraphBase<NodeProperty, EdgeProperty>;
+
+  GraphOverlay() : GraphOverlay(nullptr) {}
+  explicit GraphOverlay(const Base* base)
+      : base_(base),
+        start_idx_(std::numeric_limits<size_t>::max()),
+        goal_idx_(std::numeric_limits<size_t>::max()) {}
+
+  // Remove all overlay nodes and edges and set a new base graph.
+  void reset(const Base* base);
+
+  // Add an overlay node. Returns its id. The properties are moved into the
+  // overlay.
+  size_t addNode(NodeProperty node_property);
+  // Add an overlay start or goal node. Returns its id.
+  size_t addStartNode(NodeProperty node_property);
+  size_t addGoalNode(NodeProperty node_property);
+  // Add an edge from or to an overlay node. Edges between two base nodes
+  // belong to the base graph and are rejected.
+  bool addEdge(const EdgeId& edge_id, EdgeProperty edge_property, double cost);
+
+  inline const Base* getBase() const { return base_; }
+  inline size_t getBaseSize() const {
+    return base_ == nullptr ? 0 : base_->size();
+  }
+  inline size_t size() const {
+    return getBaseSize() + node_properties_.size();
+  }
+  inline size_t getNumberOfOverlayEdges() const {
+    return edge_properties_.size();
+  }
+  inline size_t getStartIdx() const { return start_idx_; }
+  inline size_t getGoalIdx() const { return goal_idx_; }
+  inline bool isOverlayNode(size_t node_id) const {
+    return node_id >= getBaseSize();
+  }
+
+  bool nodeExists(size_t node_id) const;
+  bool edgeExists(const EdgeId& edge_id) const;
+  bool getEdgeCost(const EdgeId& edge_id, double* cost) const;
+  const NodeProperty* getNodeProperty(size_t node_id) const;
+  const EdgeProperty* getEdgeProperty(const EdgeId& edge_id) const;
+  // Call visit(neighbor_id, cost) for all base and overlay neighbors of a
+  // node. Iteration stops early if visit returns false.
+  template <class Visitor>
+  void forEachNeighbor(size_t node_id, Visitor visit) const;
+
+  // Solve the combined graph with Dijkstra.
+  bool solveDijkstra(size_t start, size_t goal, Solution* solution) const;
+  // Create the distance matrix of the combined graph, see
+  // createDistanceMatrix.
+  template <class T = int>
+  bool getDistanceMatrix(DistanceMatrix<T>* m) const {
+    return createDistanceMatrix(*this, m);
+  }
+  // Create the distance matrix of the combined graph from the distance matrix
+  // of the base graph. Only the overlay edges are converted, such that the
+  // base matrix can be cached across queries. Returns false if base_matrix
+  // does not match the base graph size.
+  template <class T>
+  bool getDistanceMatrix(const DistanceMatrix<T>& base_matrix,
+                         DistanceMatrix<T>* m) const;
+
+ private:
+  const Base* base_;
+  // Overlay node properties. Index is node id minus base size.
+  std::vector<NodeProperty> node_properties_;
+  // Overlay edge properties.
+  std::map<EdgeId, EdgeProperty> edge_properties_;
+  // Overlay out-edges of base and overlay nodes sorted by neighbor id.
+  std::map<size_t, std::map<size_t, double>> adjacency_;
+  size_t start_idx_;
+  size_t goal_idx_;
+};
+}  // namespace polygon_coverage_planning
+
+#include "polygon_coverage_solvers/impl/graph_overlay_impl.h"
+
+#endif  // POLYGON_COVERAGE_SOLVERS_GRAPH_OVERLAY_H_
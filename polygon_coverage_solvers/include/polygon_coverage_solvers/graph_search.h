@@ -0,0 +1,114 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POLYGON_COVERAGE_SOLVERS_GRAPH_SEARCH_H_
+#define POLYGON_COVERAGE_SOLVERS_GRAPH_SEARCH_H_
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+// A best-first search engine shared by all graph types.
+namespace polygon_coverage_planning {
+
+// The solution.
+typedef std::vector<size_t> Solution;
+
+// Marks nodes without predecessor in a shortest path tree.
+const size_t kNoParent = std::numeric_limits<size_t>::max();
+
+// An indexed binary min-heap over node ids [0, num_nodes) with decrease-key.
+class IndexedMinHeap {
+ public:
+  explicit IndexedMinHeap(size_t num_nodes = 0);
+
+  // Empty the heap for node ids [0, num_nodes) keeping the allocated memory.
+  void reset(size_t num_nodes);
+
+  inline bool empty() const { return heap_.empty(); }
+  inline size_t size() const { return heap_.size(); }
+  inline bool contains(size_t id) const { return position_[id] != kNotInHeap; }
+
+  // Insert a node or decrease its key if it is already in the heap.
+  void push(size_t id, double key);
+  // Remove and return the node with the lowest key.
+  size_t pop();
+
+ private:
+  static constexpr size_t kNotInHeap = std::numeric_limits<size_t>::max();
+
+  void siftUp(size_t pos);
+  void siftDown(size_t pos);
+  void swap(size_t a, size_t b);
+
+  std::vector<size_t> heap_;      // Node ids ordered as binary heap.
+  std::vector<size_t> position_;  // Heap position for each node id.
+  std::vector<double> key_;       // Key for each node id.
+};
+
+// The scratch buffers of a search. Searches reusing a workspace do not
+// reallocate them. A workspace must not be used by two searches at the same
+// time, e.g., keep one per thread.
+struct SearchWorkspace {
+  // Upper bound of the buffer memory per node [bytes], i.e., heap, heap
+  // position, key, closed flag, predecessor and cost.
+  static constexpr size_t kBytesPerNode =
+      3 * sizeof(size_t) + 2 * sizeof(double) + 1;
+
+  // Prepare the buffers for a search over the nodes [0, num_nodes).
+  void reset(size_t num_nodes);
+
+  IndexedMinHeap open_set;        // Nodes to evaluate.
+  std::vector<bool> closed_set;   // Nodes already evaluated.
+  std::vector<size_t> came_from;  // Optimal predecessor.
+  std::vector<double> cost;       // Cost from start.
+};
+
+// Best-first search (A*, Dijkstra if the heuristic is zero) over the nodes
+// [0, num_nodes).
+// expand(current, relax): Call relax(neighbor, cost) for all successors of
+// current. Returning false aborts the search.
+// heuristic(node, h): Set the heuristic cost to goal. Returning false aborts
+// the search.
+// workspace: Optional scratch buffers. Allocated per call if nullptr.
+template <class ExpandFunction, class HeuristicFunction>
+bool searchBestFirst(size_t num_nodes, size_t start, size_t goal,
+                     ExpandFunction expand, HeuristicFunction heuristic,
+                     Solution* solution, SearchWorkspace* workspace = nullptr);
+
+// Dijkstra search, i.e., best-first search without heuristic.
+template <class ExpandFunction>
+bool searchDijkstra(size_t num_nodes, size_t start, size_t goal,
+                    ExpandFunction expand, Solution* solution,
+                    SearchWorkspace* workspace = nullptr);
+
+// Dijkstra search from start to all nodes. Sets the cost from start and the
+// optimal predecessor of every node. Unreachable nodes keep infinite cost and
+// kNoParent.
+template <class ExpandFunction>
+bool searchShortestPathTree(size_t num_nodes, size_t start,
+                            ExpandFunction expand, std::vector<double>* cost,
+                            std::vector<size_t>* came_from,
+                            SearchWorkspace* workspace = nullptr);
+
+}  // namespace polygon_coverage_planning
+
+#include "polygon_coverage_solvers/impl/graph_search_impl.h"
+
+#endif  // POLYGON_COVERAGE_SOLVERS_GRAPH_SEARCH_H_
@@ -0,0 +1,109 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POLYGON_COVERAGE_SOLVERS_GTSP_SOLVER_H_
+#define POLYGON_COVERAGE_SOLVERS_GTSP_SOLVER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "polygon_coverage_solvers/distance_matrix.h"
+
+// Common interface for generalized traveling salesman problem (GTSP) solvers.
+namespace polygon_coverage_planning {
+namespace gtsp {
+
+// A GTSP instance.
+// m: Flat distance matrix in milli int. std::numeric_limits<int>::max() marks
+// no connection.
+// clusters: The node ids of every cluster.
+struct Task {
+  // Takes ownership of the distance matrix without copying.
+  Task(DistanceMatrix<int>&& m, const std::vector<std::vector<int>>& clusters)
+      : m(std::move(m)), clusters(clusters) {}
+  // Converts nested rows. The matrix is empty if the rows are not square.
+  Task(const std::vector<std::vector<int>>& m,
+       const std::vector<std::vector<int>>& clusters);
+  inline bool mIsSymmetric() const { return m.isSymmetric(); }
+  DistanceMatrix<int> m;
+  std::vector<std::vector<int>> clusters;
+};
+
+// The cost of a cyclic tour.
+int64_t computeCost(const DistanceMatrix<int>& m, const std::vector<int>& tour);
+
+enum SolverType {
+  kGkMa = 0,  // GK MA memetic solver running in Mono.
+  kNative,    // Native memetic solver running in process.
+  kGkMaPool   // GK MA in a pool of worker processes. Solves concurrently.
+};
+
+inline bool checkSolverTypeValid(const int type) {
+  return (type == SolverType::kGkMa) || (type == SolverType::kNative) ||
+         (type == SolverType::kGkMaPool);
+}
+
+inline std::string getSolverTypeName(const SolverType& type) {
+  switch (type) {
+    case SolverType::kGkMa:
+      return "GK MA";
+    case SolverType::kNative:
+      return "Native Memetic";
+    case SolverType::kGkMaPool:
+      return "GK MA Worker Pool";
+  }
+  return "Unknown!";
+}
+
+// Whether a run stops with its best tour when the time budget runs out. GK MA
+// cannot be interrupted, so its runs always finish.
+inline bool checkSolverStopsOnBudget(const SolverType& type) {
+  return type == SolverType::kNative;
+}
+
+class SolverBase {
+ public:
+  virtual ~SolverBase() {}
+
+  // Solve the task. The solution is a cyclic tour visiting exactly one node of
+  // every cluster.
+  virtual bool solve(const Task& task, std::vector<int>* solution) = 0;
+};
+
+struct SolverSettings {
+  // Number of independent runs with different seeds. The best tour is
+  // returned.
+  size_t num_starts = 1;
+  size_t num_threads = 0;     // Concurrent runs. 0: hardware concurrency.
+  // Wall-clock budget [s]. Non-positive: none. Only the native solver stops a
+  // run on expiry. Otherwise the budget only skips the starts after the first.
+  double time_budget = -1.0;
+};
+
+// Create a solver of the given type.
+std::unique_ptr<SolverBase> createSolver(
+    const SolverType& type, const SolverSettings& settings = SolverSettings());
+
+}  // namespace gtsp
+}  // namespace polygon_coverage_planning
+
+#endif  // POLYGON_COVERAGE_SOLVERS_GTSP_SOLVER_H_
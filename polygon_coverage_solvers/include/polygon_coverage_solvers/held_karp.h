@@ -0,0 +1,78 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POLYGON_COVERAGE_SOLVERS_HELD_KARP_H_
+#define POLYGON_COVERAGE_SOLVERS_HELD_KARP_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "polygon_coverage_solvers/deadline.h"
+#include "polygon_coverage_solvers/distance_matrix.h"
+#include "polygon_coverage_solvers/graph_search.h"
+
+namespace polygon_coverage_planning {
+namespace held_karp {
+
+// Exact generalized traveling salesman path solver using Held-Karp dynamic
+// programming over (visited cluster bitmask, last node). For details see: M.
+// Held, R. Karp, "A Dynamic Programming Approach to Sequencing Problems"
+// The cost table is one flat array of 2^k x n entries for k clusters with n
+// nodes in total. Its size is known before solving.
+class HeldKarp {
+ public:
+  struct Settings {
+    size_t max_clusters = 24;  // Maximum number of clusters to visit.
+    size_t max_table_size =
+        static_cast<size_t>(1) << 27;  // Maximum number of table entries.
+  };
+
+  HeldKarp() : HeldKarp(Settings()) {}
+  HeldKarp(const Settings& settings) : settings_(settings) {}
+
+  // Find the cheapest path from start to goal that visits exactly one node of
+  // every cluster.
+  // m: The edge costs. DistanceMatrix<double>::kNoConnection marks no
+  // connection.
+  // clusters: The node ids of every cluster, excluding start and goal.
+  // solution: The start, one node per cluster and the goal.
+  // deadline: Fails if it expires before the table is complete. There is no
+  // intermediate solution.
+  bool solve(const DistanceMatrix<double>& m,
+             const std::vector<std::vector<int>>& clusters, size_t start,
+             size_t goal, Solution* solution,
+             const Deadline& deadline = Deadline());
+
+  // The cost of the last solution.
+  inline double getCost() const { return cost_; }
+
+  // The number of table entries 2^num_clusters * num_nodes. Returns false on
+  // overflow.
+  static bool computeTableSize(size_t num_clusters, size_t num_nodes,
+                               size_t* table_size);
+
+ private:
+  Settings settings_;
+  double cost_ = 0.0;
+};
+
+}  // namespace held_karp
+}  // namespace polygon_coverage_planning
+
+#endif  // POLYGON_COVERAGE_SOLVERS_HELD_KARP_H_
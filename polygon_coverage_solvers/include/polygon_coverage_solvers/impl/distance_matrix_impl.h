@@ -0,0 +1,70 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POLYGON_COVERAGE_SOLVERS_DISTANCE_MATRIX_IMPL_H_
+#define POLYGON_COVERAGE_SOLVERS_DISTANCE_MATRIX_IMPL_H_
+
+#include <algorithm>
+
+#include <ros/assert.h>
+
+namespace polygon_coverage_planning {
+
+template <class T>
+bool DistanceMatrix<T>::fromRows(const std::vector<std::vector<T>>& rows,
+                                 DistanceMatrix* m) {
+  ROS_ASSERT(m);
+  for (const std::vector<T>& row : rows) {
+    if (row.size() != rows.size()) {
+      *m = DistanceMatrix();
+      return false;
+    }
+  }
+
+  *m = DistanceMatrix(rows.size());
+  for (size_t i = 0; i < rows.size(); ++i) {
+    std::copy(rows[i].begin(), rows[i].end(), m->row(i));
+  }
+  return true;
+}
+
+template <class T>
+std::vector<std::vector<T>> DistanceMatrix<T>::toRows() const {
+  std::vector<std::vector<T>> rows(size_);
+  for (size_t i = 0; i < size_; ++i) {
+    rows[i].assign(row(i), row(i) + size_);
+  }
+  return rows;
+}
+
+template <class T>
+bool DistanceMatrix<T>::isSymmetric() const {
+  for (size_t i = 0; i < size_; ++i) {
+    for (size_t j = i + 1; j < size_; ++j) {
+      if ((*this)(i, j) != (*this)(j, i)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace polygon_coverage_planning
+
+#endif  // POLYGON_COVERAGE_SOLVERS_DISTANCE_MATRIX_IMPL_H_
@@ -22,6 +22,7 @@
 
 #include <algorithm>
 #include <set>
+#include <utility>
 
 #include <ros/assert.h>
 #include <ros/console.h>
@@ -30,12 +31,13 @@ namespace polygon_coverage_planning {
 
 template <class NodeProperty, class EdgeProperty>
 bool GraphBase<NodeProperty, EdgeProperty>::addNode(
-    const NodeProperty& node_property) {
+    NodeProperty node_property) {
+  uncompact();
   graph_.push_back(std::map<size_t, double>());  // Add node.
 
   // Add node properties.
   const size_t idx = graph_.size() - 1;
-  node_properties_.insert(std::make_pair(idx, node_property));
+  node_properties_.emplace(idx, std::move(node_property));
   // Create all adjacent edges.
   if (!addEdges()) {
     graph_.pop_back();
@@ -79,10 +81,16 @@ void GraphBase<NodeProperty, EdgeProperty>::clear() {
   start_idx_ = std::numeric_limits<size_t>::max();
   goal_idx_ = std::numeric_limits<size_t>::max();
   is_created_ = false;
+  is_compact_ = false;
+  csr_offsets_.clear();
+  csr_neighbors_.clear();
+  csr_costs_.clear();
+  compact_node_properties_.clear();
 }
 
 template <class NodeProperty, class EdgeProperty>
 void GraphBase<NodeProperty, EdgeProperty>::clearEdges() {
+  uncompact();
   edge_properties_.clear();
   for (std::map<size_t, double>& neighbors : graph_) {
     neighbors.clear();
@@ -96,14 +104,24 @@ bool GraphBase<NodeProperty, EdgeProperty>::nodeExists(size_t node_id) const {
 template <class NodeProperty, class EdgeProperty>
 bool GraphBase<NodeProperty, EdgeProperty>::nodePropertyExists(
     size_t node_id) const {
+  if (is_compact_) {
+    return node_id < compact_node_properties_.size();
+  }
   return node_properties_.count(node_id) > 0;
 }
 
 template <class NodeProperty, class EdgeProperty>
 bool GraphBase<NodeProperty, EdgeProperty>::edgeExists(
     const EdgeId& edge_id) const {
-  return nodeExists(edge_id.first) &&
-         graph_[edge_id.first].count(edge_id.second) > 0;
+  if (!nodeExists(edge_id.first)) {
+    return false;
+  }
+  if (is_compact_) {
+    const auto begin = csr_neighbors_.begin() + csr_offsets_[edge_id.first];
+    const auto end = csr_neighbors_.begin() + csr_offsets_[edge_id.first + 1];
+    return std::binary_search(begin, end, edge_id.second);
+  }
+  return graph_[edge_id.first].count(edge_id.second) > 0;
 }
 
 template <class NodeProperty, class EdgeProperty>
@@ -117,21 +135,31 @@ bool GraphBase<NodeProperty, EdgeProperty>::getEdgeCost(const EdgeId& edge_id,
                                                         double* cost) const {
   ROS_ASSERT(cost);
 
-  if (edgeExists(edge_id)) {
+  if (is_compact_ && nodeExists(edge_id.first)) {
+    const auto begin = csr_neighbors_.begin() + csr_offsets_[edge_id.first];
+    const auto end = csr_neighbors_.begin() + csr_offsets_[edge_id.first + 1];
+    const auto it = std::lower_bound(begin, end, edge_id.second);
+    if (it != end && *it == edge_id.second) {
+      *cost = csr_costs_[it - csr_neighbors_.begin()];
+      return true;
+    }
+  } else if (!is_compact_ && edgeExists(edge_id)) {
     *cost = graph_.at(edge_id.first).at(edge_id.second);
     return true;
-  } else {
-    ROS_ERROR_STREAM("Edge from " << edge_id.first << " to " << edge_id.second
-                                  << " does not exist.");
-    *cost = -1.0;
-    return false;
   }
+
+  ROS_ERROR_STREAM("Edge from " << edge_id.first << " to " << edge_id.second
+                                << " does not exist.");
+  *cost = -1.0;
+  return false;
 }
 
 template <class NodeProperty, class EdgeProperty>
 const NodeProperty* GraphBase<NodeProperty, EdgeProperty>::getNodeProperty(
     size_t node_id) const {
-  if (nodePropertyExists(node_id)) {
+  if (is_compact_ && node_id < compact_node_properties_.size()) {
+    return &(compact_node_properties_[node_id]);
+  } else if (!is_compact_ && nodePropertyExists(node_id)) {
     return &(node_properties_.at(node_id));
   } else {
     ROS_ERROR_STREAM("Cannot access node property " << node_id << ".");
@@ -154,56 +182,19 @@ GraphBase<NodeProperty, EdgeProperty>::GraphBase::getEdgeProperty(
 
 template <class NodeProperty, class EdgeProperty>
 bool GraphBase<NodeProperty, EdgeProperty>::solveDijkstra(
-    size_t start, size_t goal, Solution* solution) const {
+    size_t start, size_t goal, Solution* solution,
+    SearchWorkspace* workspace) const {
   ROS_ASSERT(solution);
-  solution->clear();
-  if (!nodeExists(start) || !nodeExists(goal)) {
-    return false;
-  }
-
-  // https://en.wikipedia.org/wiki/Dijkstra%27s_algorithm
-  // Initialization.
-  std::set<size_t> open_set = {start};  // Nodes to evaluate.
-  std::set<size_t> closed_set;          // Nodes already evaluated.
-  std::map<size_t, size_t> came_from;   // Get previous node on optimal path.
-  std::map<size_t, double> cost;        // Optimal cost from start.
-  for (size_t i = 0; i < graph_.size(); i++) {
-    cost[i] = std::numeric_limits<double>::max();
-  }
-  cost[start] = 0.0;
-
-  while (!open_set.empty()) {
-    // Pop vertex with lowest score from open set.
-    size_t current = *std::min_element(
-        open_set.begin(), open_set.end(),
-        [&cost](size_t i, size_t j) { return cost[i] < cost[j]; });
-    if (current == goal) {  // Reached goal.
-      *solution = reconstructSolution(came_from, current);
-      return true;
-    }
-    open_set.erase(current);
-    closed_set.insert(current);
-
-    // Check all neighbors.
-    for (const std::pair<size_t, double>& n : graph_[current]) {
-      if (closed_set.count(n.first) > 0) {
-        continue;  // Ignore already evaluated neighbors.
-      }
-      open_set.insert(n.first);  // Add to open set if not already in.
-
-      // The distance from start to a neighbor.
-      const double tentative_cost = cost[current] + n.second;
-      if (tentative_cost >= cost[n.first]) {
-        continue;  // This is not a better path to n.
-      } else {
-        // This path is the best path to n until now.
-        came_from[n.first] = current;
-        cost[n.first] = tentative_cost;
-      }
-    }
-  }
-
-  return false;
+  return searchDijkstra(
+      graph_.size(), start, goal,
+      [this](size_t current, auto relax) {
+        forEachNeighbor(current, [&relax](size_t n, double cost) {
+          relax(n, cost);
+          return true;
+        });
+        return true;
+      },
+      solution, workspace);
 }
 
 template <class NodeProperty, class EdgeProperty>
@@ -213,7 +204,7 @@ bool GraphBase<NodeProperty, EdgeProperty>::solveDijkstra(
 }
 
 template <class NodeProperty, class EdgeProperty>
-bool GraphBase<NodeProperty, EdgeProperty>::calculateHeuristic(
+bool GraphBase<NodeProperty, EdgeProperty>::createHeuristic(
     size_t goal, Heuristic* heuristic) const {
   ROS_ERROR_STREAM("Heuristic not implemented.");
   return false;
@@ -221,74 +212,29 @@ bool GraphBase<NodeProperty, EdgeProperty>::calculateHeuristic(
 
 template <class NodeProperty, class EdgeProperty>
 bool GraphBase<NodeProperty, EdgeProperty>::solveAStar(
-    size_t start, size_t goal, Solution* solution) const {
+    size_t start, size_t goal, Solution* solution,
+    SearchWorkspace* workspace) const {
   ROS_ASSERT(solution);
+  solution->clear();
   if (!nodeExists(start) || !nodeExists(goal)) {
     return false;
   }
 
   Heuristic heuristic;
-  if (!calculateHeuristic(goal, &heuristic)) {
+  if (!createHeuristic(goal, &heuristic)) {
     return false;
   }
 
-  // https://en.wikipedia.org/wiki/A*_search_algorithm
-  // Initialization.
-  std::set<size_t> open_set = {start};  // Nodes to evaluate.
-  std::set<size_t> closed_set;          // Nodes already evaluated.
-  std::map<size_t, size_t> came_from;   // Get previous node on optimal path.
-  std::map<size_t, double> cost;        // Optimal cost from start.
-  std::map<size_t, double> cost_with_heuristic;  // cost + heuristic
-  for (size_t i = 0; i < graph_.size(); i++) {
-    cost[i] = std::numeric_limits<double>::max();
-    cost_with_heuristic[i] = std::numeric_limits<double>::max();
-  }
-  cost[start] = 0.0;
-  const Heuristic::const_iterator start_heuristic_it = heuristic.find(start);
-  if (start_heuristic_it == heuristic.end()) {
-    return false;  // Heuristic not found.
-  }
-  cost_with_heuristic[start] = start_heuristic_it->second;
-
-  while (!open_set.empty()) {
-    // Pop vertex with lowest cost with heuristic from open set.
-    size_t current = *std::min_element(
-        open_set.begin(), open_set.end(),
-        [&cost_with_heuristic](size_t i, size_t j) {
-          return cost_with_heuristic[i] < cost_with_heuristic[j];
+  return searchBestFirst(
+      graph_.size(), start, goal,
+      [this](size_t current, auto relax) {
+        forEachNeighbor(current, [&relax](size_t n, double cost) {
+          relax(n, cost);
+          return true;
         });
-    if (current == goal) {  // Reached goal.
-      *solution = reconstructSolution(came_from, current);
-      return true;
-    }
-    open_set.erase(current);
-    closed_set.insert(current);
-
-    // Check all neighbors.
-    for (const std::pair<size_t, double>& n : graph_[current]) {
-      if (closed_set.count(n.first) > 0) {
-        continue;  // Ignore already evaluated neighbors.
-      }
-      open_set.insert(n.first);  // Add to open set if not already in.
-
-      // The distance from start to a neighbor.
-      const double tentative_cost = cost[current] + n.second;
-      if (tentative_cost >= cost[n.first]) {
-        continue;  // This is not a better path to n.
-      } else {
-        // This path is the best path to n until now.
-        came_from[n.first] = current;
-        cost[n.first] = tentative_cost;
-        const Heuristic::const_iterator heuristic_it = heuristic.find(n.first);
-        if (heuristic_it == heuristic.end()) {
-          return false;  // Heuristic not found.
-        }
-        cost_with_heuristic[n.first] = cost[n.first] + heuristic_it->second;
-      }
-    }
-  }
-
-  return false;
+        return true;
+      },
+      heuristic, solution, workspace);
 }
 
 template <class NodeProperty, class EdgeProperty>
@@ -299,10 +245,11 @@ bool GraphBase<NodeProperty, EdgeProperty>::solveAStar(
 
 template <class NodeProperty, class EdgeProperty>
 bool GraphBase<NodeProperty, EdgeProperty>::addEdge(
-    const EdgeId& edge_id, const EdgeProperty& edge_property, double cost) {
+    const EdgeId& edge_id, EdgeProperty edge_property, double cost) {
+  uncompact();
   if (cost >= 0.0 && nodeExists(edge_id.first)) {
     graph_[edge_id.first][edge_id.second] = cost;
-    edge_properties_.insert(std::make_pair(edge_id, edge_property));
+    edge_properties_.emplace(edge_id, std::move(edge_property));
     return true;
   } else {
     return false;
@@ -310,36 +257,158 @@ bool GraphBase<NodeProperty, EdgeProperty>::addEdge(
 }
 
 template <class NodeProperty, class EdgeProperty>
-Solution GraphBase<NodeProperty, EdgeProperty>::reconstructSolution(
-    const std::map<size_t, size_t>& came_from, size_t current) const {
-  Solution solution = {current};
-  while (came_from.find(current) != came_from.end()) {
-    current = came_from.at(current);
-    solution.push_back(current);
+bool GraphBase<NodeProperty, EdgeProperty>::compact() {
+  if (is_compact_) {
+    return true;
+  }
+  // Node properties need to be dense to be stored in a vector.
+  if (node_properties_.size() != graph_.size() ||
+      (!node_properties_.empty() &&
+       node_properties_.rbegin()->first != graph_.size() - 1)) {
+    ROS_ERROR_STREAM("Cannot compact graph with missing node properties.");
+    return false;
+  }
+
+  size_t num_edges = 0;
+  for (const std::map<size_t, double>& neighbors : graph_) {
+    num_edges += neighbors.size();
   }
-  std::reverse(solution.begin(), solution.end());
-  return solution;
+
+  csr_offsets_.clear();
+  csr_neighbors_.clear();
+  csr_costs_.clear();
+  csr_offsets_.reserve(graph_.size() + 1);
+  csr_neighbors_.reserve(num_edges);
+  csr_costs_.reserve(num_edges);
+  csr_offsets_.push_back(0);
+  for (const std::map<size_t, double>& neighbors : graph_) {
+    // The map is sorted by neighbor id, which allows binary search lookups.
+    for (const std::pair<const size_t, double>& n : neighbors) {
+      csr_neighbors_.push_back(n.first);
+      csr_costs_.push_back(n.second);
+    }
+    csr_offsets_.push_back(csr_neighbors_.size());
+  }
+
+  compact_node_properties_.clear();
+  compact_node_properties_.reserve(node_properties_.size());
+  for (std::pair<const size_t, NodeProperty>& node_property :
+       node_properties_) {
+    compact_node_properties_.push_back(std::move(node_property.second));
+  }
+  node_properties_.clear();
+
+  is_compact_ = true;
+  return true;
 }
 
 template <class NodeProperty, class EdgeProperty>
-std::vector<std::vector<int>>
-GraphBase<NodeProperty, EdgeProperty>::getAdjacencyMatrix() const {
-  std::vector<std::vector<int>> m(graph_.size(),
-                                  std::vector<int>(graph_.size()));
-
-  for (size_t i = 0; i < m.size(); ++i) {
-    for (size_t j = 0; j < m[i].size(); ++j) {
-      const EdgeId edge(i, j);
-      double cost;
-      if (edgeExists(edge) && getEdgeCost(edge, &cost)) {
-        m[i][j] = doubleToMilliInt(cost);
-      } else {
-        m[i][j] = std::numeric_limits<int>::max();
+void GraphBase<NodeProperty, EdgeProperty>::uncompact() {
+  if (!is_compact_) {
+    return;
+  }
+  for (size_t i = 0; i < compact_node_properties_.size(); ++i) {
+    node_properties_.insert(
+        node_properties_.end(),
+        std::make_pair(i, std::move(compact_node_properties_[i])));
+  }
+  compact_node_properties_.clear();
+  csr_offsets_.clear();
+  csr_neighbors_.clear();
+  csr_costs_.clear();
+  is_compact_ = false;
+}
+
+template <class NodeProperty, class EdgeProperty>
+size_t GraphBase<NodeProperty, EdgeProperty>::getNodeBytes() const {
+  // An ordered container node stores the value and the tree links.
+  const size_t kTreeNodeBytes = 4 * sizeof(void*);
+  return graph_.capacity() * sizeof(std::map<size_t, double>) +
+         node_properties_.size() *
+             (sizeof(typename NodeProperties::value_type) + kTreeNodeBytes) +
+         csr_offsets_.capacity() * sizeof(size_t) +
+         compact_node_properties_.capacity() * sizeof(NodeProperty);
+}
+
+template <class NodeProperty, class EdgeProperty>
+size_t GraphBase<NodeProperty, EdgeProperty>::getEdgeBytes() const {
+  const size_t kTreeNodeBytes = 4 * sizeof(void*);
+  size_t bytes = 0;
+  for (const std::map<size_t, double>& neighbors : graph_) {
+    bytes += neighbors.size() *
+             (sizeof(std::pair<const size_t, double>) + kTreeNodeBytes);
+  }
+  return bytes +
+         edge_properties_.size() *
+             (sizeof(typename EdgeProperties::value_type) + kTreeNodeBytes) +
+         csr_neighbors_.capacity() * sizeof(size_t) +
+         csr_costs_.capacity() * sizeof(double);
+}
+
+template <class NodeProperty, class EdgeProperty>
+template <class Visitor>
+void GraphBase<NodeProperty, EdgeProperty>::forEachNeighbor(
+    size_t node_id, Visitor visit) const {
+  if (is_compact_) {
+    for (size_t i = csr_offsets_[node_id]; i < csr_offsets_[node_id + 1];
+         ++i) {
+      if (!visit(csr_neighbors_[i], csr_costs_[i])) {
+        return;
+      }
+    }
+  } else {
+    for (const std::pair<const size_t, double>& n : graph_[node_id]) {
+      if (!visit(n.first, n.second)) {
+        return;
       }
     }
   }
+}
 
-  return m;
+template <class NodeProperty, class EdgeProperty>
+std::vector<std::vector<int>>
+GraphBase<NodeProperty, EdgeProperty>::getAdjacencyMatrix() const {
+  DistanceMatrix<int> m;
+  getDistanceMatrix(&m);
+  return m.toRows();
+}
+
+template <class NodeProperty, class EdgeProperty>
+template <class T>
+bool GraphBase<NodeProperty, EdgeProperty>::getDistanceMatrix(
+    DistanceMatrix<T>* m) const {
+  return createDistanceMatrix(*this, m);
+}
+
+template <class Graph, class T>
+bool createDistanceMatrix(const Graph& graph, DistanceMatrix<T>* m) {
+  ROS_ASSERT(m);
+  *m = DistanceMatrix<T>(graph.size());
+
+  bool success = true;
+  for (size_t i = 0; i < graph.size(); ++i) {
+    graph.forEachNeighbor(i, [&](size_t j, double cost) {
+      success = setDistance(i, j, cost, m) && success;
+      return true;
+    });
+  }
+
+  return success;
+}
+
+template <class T>
+bool setDistance(size_t i, size_t j, double cost, DistanceMatrix<T>* m) {
+  ROS_ASSERT(m);
+  const long long milli = std::llround(cost * kToMilli);
+  if (milli < 0 ||
+      milli >= static_cast<long long>(DistanceMatrix<T>::kNoConnection)) {
+    ROS_ERROR_STREAM("Cost " << cost << " from " << i << " to " << j
+                             << " exceeds distance matrix type.");
+    (*m)(i, j) = DistanceMatrix<T>::kNoConnection;
+    return false;
+  }
+  (*m)(i, j) = static_cast<T>(milli);
+  return true;
 }
 
 }  // namespace polygon_coverage_planning
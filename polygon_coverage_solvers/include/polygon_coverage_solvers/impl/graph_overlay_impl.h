@@ -0,0 +1,206 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POLYGON_COVERAGE_SOLVERS_GRAPH_OVERLAY_IMPL_H_
+#define POLYGON_COVERAGE_SOLVERS_GRAPH_OVERLAY_IMPL_H_
+
+#include <algorithm>
+#include <utility>
+
+#include <ros/assert.h>
+#include <ros/console.h>
+
+namespace polygon_coverage_planning {
+
+template <class NodeProperty, class EdgeProperty>
+void GraphOverlay<NodeProperty, EdgeProperty>::reset(const Base* base) {
+  base_ = base;
+  node_properties_.clear();
+  edge_properties_.clear();
+  adjacency_.clear();
+  start_idx_ = std::numeric_limits<size_t>::max();
+  goal_idx_ = std::numeric_limits<size_t>::max();
+}
+
+template <class NodeProperty, class EdgeProperty>
+size_t GraphOverlay<NodeProperty, EdgeProperty>::addNode(
+    NodeProperty node_property) {
+  node_properties_.push_back(std::move(node_property));
+  return size() - 1;
+}
+
+template <class NodeProperty, class EdgeProperty>
+size_t GraphOverlay<NodeProperty, EdgeProperty>::addStartNode(
+    NodeProperty node_property) {
+  start_idx_ = addNode(std::move(node_property));
+  return start_idx_;
+}
+
+template <class NodeProperty, class EdgeProperty>
+size_t GraphOverlay<NodeProperty, EdgeProperty>::addGoalNode(
+    NodeProperty node_property) {
+  goal_idx_ = addNode(std::move(node_property));
+  return goal_idx_;
+}
+
+template <class NodeProperty, class EdgeProperty>
+bool GraphOverlay<NodeProperty, EdgeProperty>::addEdge(
+    const EdgeId& edge_id, EdgeProperty edge_property, double cost) {
+  if (cost < 0.0 || !nodeExists(edge_id.first) ||
+      !nodeExists(edge_id.second)) {
+    ROS_ERROR_STREAM("Cannot add overlay edge " << edge_id.first << " -> "
+                                                << edge_id.second);
+    return false;
+  }
+  if (!isOverlayNode(edge_id.first) && !isOverlayNode(edge_id.second)) {
+    ROS_ERROR_STREAM("Edge " << edge_id.first << " -> " << edge_id.second
+                             << " belongs to the base graph.");
+    return false;
+  }
+  adjacency_[edge_id.first][edge_id.second] = cost;
+  edge_properties_[edge_id] = std::move(edge_property);
+  return true;
+}
+
+template <class NodeProperty, class EdgeProperty>
+bool GraphOverlay<NodeProperty, EdgeProperty>::nodeExists(
+    size_t node_id) const {
+  return node_id < size();
+}
+
+template <class NodeProperty, class EdgeProperty>
+bool GraphOverlay<NodeProperty, EdgeProperty>::edgeExists(
+    const EdgeId& edge_id) const {
+  if (!isOverlayNode(edge_id.first) && !isOverlayNode(edge_id.second)) {
+    return base_->edgeExists(edge_id);
+  }
+  return edge_properties_.count(edge_id) > 0;
+}
+
+template <class NodeProperty, class EdgeProperty>
+bool GraphOverlay<NodeProperty, EdgeProperty>::getEdgeCost(
+    const EdgeId& edge_id, double* cost) const {
+  ROS_ASSERT(cost);
+  if (!isOverlayNode(edge_id.first) && !isOverlayNode(edge_id.second)) {
+    return base_->getEdgeCost(edge_id, cost);
+  }
+  const auto from_it = adjacency_.find(edge_id.first);
+  if (from_it == adjacency_.end()) {
+    return false;
+  }
+  const auto to_it = from_it->second.find(edge_id.second);
+  if (to_it == from_it->second.end()) {
+    return false;
+  }
+  *cost = to_it->second;
+  return true;
+}
+
+template <class NodeProperty, class EdgeProperty>
+const NodeProperty* GraphOverlay<NodeProperty, EdgeProperty>::getNodeProperty(
+    size_t node_id) const {
+  if (!isOverlayNode(node_id)) {
+    return base_->getNodeProperty(node_id);
+  }
+  const size_t overlay_id = node_id - getBaseSize();
+  return overlay_id < node_properties_.size() ? &node_properties_[overlay_id]
+                                              : nullptr;
+}
+
+template <class NodeProperty, class EdgeProperty>
+const EdgeProperty* GraphOverlay<NodeProperty, EdgeProperty>::getEdgeProperty(
+    const EdgeId& edge_id) const {
+  if (!isOverlayNode(edge_id.first) && !isOverlayNode(edge_id.second)) {
+    return base_->getEdgeProperty(edge_id);
+  }
+  const auto it = edge_properties_.find(edge_id);
+  return it == edge_properties_.end() ? nullptr : &it->second;
+}
+
+template <class NodeProperty, class EdgeProperty>
+template <class Visitor>
+void GraphOverlay<NodeProperty, EdgeProperty>::forEachNeighbor(
+    size_t node_id, Visitor visit) const {
+  if (!isOverlayNode(node_id)) {
+    bool stopped = false;
+    base_->forEachNeighbor(node_id, [&visit, &stopped](size_t n, double cost) {
+      stopped = !visit(n, cost);
+      return !stopped;
+    });
+    if (stopped) {
+      return;
+    }
+  }
+  const auto it = adjacency_.find(node_id);
+  if (it == adjacency_.end()) {
+    return;
+  }
+  for (const std::pair<const size_t, double>& n : it->second) {
+    if (!visit(n.first, n.second)) {
+      return;
+    }
+  }
+}
+
+template <class NodeProperty, class EdgeProperty>
+bool GraphOverlay<NodeProperty, EdgeProperty>::solveDijkstra(
+    size_t start, size_t goal, Solution* solution) const {
+  ROS_ASSERT(solution);
+  return searchDijkstra(
+      size(), start, goal,
+      [this](size_t current, auto relax) {
+        forEachNeighbor(current, [&relax](size_t n, double cost) {
+          relax(n, cost);
+          return true;
+        });
+        return true;
+      },
+      solution);
+}
+
+template <class NodeProperty, class EdgeProperty>
+template <class T>
+bool GraphOverlay<NodeProperty, EdgeProperty>::getDistanceMatrix(
+    const DistanceMatrix<T>& base_matrix, DistanceMatrix<T>* m) const {
+  ROS_ASSERT(m);
+  const size_t base_size = getBaseSize();
+  if (base_matrix.size() != base_size) {
+    ROS_ERROR_STREAM("Base distance matrix size "
+                     << base_matrix.size()
+                     << " does not match base graph size " << base_size);
+    return false;
+  }
+
+  *m = DistanceMatrix<T>(size());
+  for (size_t i = 0; i < base_size; ++i) {
+    std::copy(base_matrix.row(i), base_matrix.row(i) + base_size, m->row(i));
+  }
+
+  bool success = true;
+  for (const auto& from : adjacency_) {
+    for (const std::pair<const size_t, double>& to : from.second) {
+      success = setDistance(from.first, to.first, to.second, m) && success;
+    }
+  }
+  return success;
+}
+
+}  // namespace polygon_coverage_planning
+
+#endif  // POLYGON_COVERAGE_SOLVERS_GRAPH_OVERLAY_IMPL_H_
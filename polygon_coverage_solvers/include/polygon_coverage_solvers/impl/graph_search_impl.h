@@ -0,0 +1,152 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POLYGON_COVERAGE_SOLVERS_GRAPH_SEARCH_IMPL_H_
+#define POLYGON_COVERAGE_SOLVERS_GRAPH_SEARCH_IMPL_H_
+
+#include <algorithm>
+
+#include <ros/assert.h>
+
+namespace polygon_coverage_planning {
+
+template <class ExpandFunction, class HeuristicFunction>
+bool searchBestFirst(size_t num_nodes, size_t start, size_t goal,
+                     ExpandFunction expand, HeuristicFunction heuristic,
+                     Solution* solution, SearchWorkspace* workspace) {
+  ROS_ASSERT(solution);
+  solution->clear();
+  if (start >= num_nodes || goal >= num_nodes) {
+    return false;
+  }
+
+  // https://en.wikipedia.org/wiki/A*_search_algorithm
+  // Initialization.
+  SearchWorkspace local_workspace;
+  if (workspace == nullptr) workspace = &local_workspace;
+  workspace->reset(num_nodes);
+  IndexedMinHeap& open_set = workspace->open_set;
+  std::vector<bool>& closed_set = workspace->closed_set;
+  std::vector<size_t>& came_from = workspace->came_from;
+  std::vector<double>& cost = workspace->cost;
+
+  double start_heuristic = 0.0;
+  if (!heuristic(start, &start_heuristic)) {
+    return false;  // Heuristic not found.
+  }
+  cost[start] = 0.0;
+  open_set.push(start, start_heuristic);
+
+  bool heuristic_found = true;
+  while (!open_set.empty()) {
+    // Pop vertex with lowest cost with heuristic from open set.
+    const size_t current = open_set.pop();
+    if (current == goal) {  // Reached goal.
+      for (size_t n = current; n != kNoParent; n = came_from[n]) {
+        solution->push_back(n);
+      }
+      std::reverse(solution->begin(), solution->end());
+      return true;
+    }
+    closed_set[current] = true;
+
+    // Relax all neighbors.
+    auto relax = [&](size_t n, double edge_cost) {
+      ROS_ASSERT(n < num_nodes);
+      if (closed_set[n] || !heuristic_found) {
+        return;  // Ignore already evaluated neighbors.
+      }
+      // The distance from start to a neighbor.
+      const double tentative_cost = cost[current] + edge_cost;
+      if (tentative_cost >= cost[n]) {
+        return;  // This is not a better path to n.
+      }
+      double h = 0.0;
+      if (!heuristic(n, &h)) {
+        heuristic_found = false;
+        return;
+      }
+      // This path is the best path to n until now.
+      came_from[n] = current;
+      cost[n] = tentative_cost;
+      open_set.push(n, tentative_cost + h);
+    };
+    if (!expand(current, relax) || !heuristic_found) {
+      return false;
+    }
+  }
+
+  return false;
+}
+
+template <class ExpandFunction>
+bool searchDijkstra(size_t num_nodes, size_t start, size_t goal,
+                    ExpandFunction expand, Solution* solution,
+                    SearchWorkspace* workspace) {
+  return searchBestFirst(num_nodes, start, goal, expand,
+                         [](size_t, double* h) {
+                           *h = 0.0;
+                           return true;
+                         },
+                         solution, workspace);
+}
+
+template <class ExpandFunction>
+bool searchShortestPathTree(size_t num_nodes, size_t start,
+                            ExpandFunction expand, std::vector<double>* cost,
+                            std::vector<size_t>* came_from,
+                            SearchWorkspace* workspace) {
+  ROS_ASSERT(cost);
+  ROS_ASSERT(came_from);
+  cost->assign(num_nodes, std::numeric_limits<double>::infinity());
+  came_from->assign(num_nodes, kNoParent);
+  if (start >= num_nodes) {
+    return false;
+  }
+
+  SearchWorkspace local_workspace;
+  if (workspace == nullptr) workspace = &local_workspace;
+  workspace->reset(num_nodes);
+  IndexedMinHeap& open_set = workspace->open_set;
+  std::vector<bool>& closed_set = workspace->closed_set;
+  (*cost)[start] = 0.0;
+  open_set.push(start, 0.0);
+  while (!open_set.empty()) {
+    const size_t current = open_set.pop();
+    closed_set[current] = true;
+    auto relax = [&](size_t n, double edge_cost) {
+      ROS_ASSERT(n < num_nodes);
+      const double tentative_cost = (*cost)[current] + edge_cost;
+      if (closed_set[n] || tentative_cost >= (*cost)[n]) {
+        return;
+      }
+      (*came_from)[n] = current;
+      (*cost)[n] = tentative_cost;
+      open_set.push(n, tentative_cost);
+    };
+    if (!expand(current, relax)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace polygon_coverage_planning
+
+#endif  // POLYGON_COVERAGE_SOLVERS_GRAPH_SEARCH_IMPL_H_
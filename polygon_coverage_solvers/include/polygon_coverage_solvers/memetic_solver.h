@@ -0,0 +1,95 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POLYGON_COVERAGE_SOLVERS_MEMETIC_SOLVER_H_
+#define POLYGON_COVERAGE_SOLVERS_MEMETIC_SOLVER_H_
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "polygon_coverage_solvers/gtsp_solver.h"
+
+namespace polygon_coverage_planning {
+namespace gtsp {
+
+// A native memetic GTSP solver in the spirit of GK MA: G. Gutin, D.
+// Karapetyan, "A memetic algorithm for the generalized traveling salesman
+// problem". A population of cluster orders is evolved with ordered crossover
+// and mutation. Every tour is improved with cluster insertion local search and
+// cluster optimization, i.e., choosing the optimal node per cluster for a fixed
+// cluster order.
+class MemeticSolver : public SolverBase {
+ public:
+  struct Settings {
+    size_t population_size = 20;  // Number of tours in the population.
+    size_t max_generations = 1000;  // Maximum number of generations.
+    size_t max_idle_generations = 30;  // Stop if best tour does not improve.
+    double mutation_probability = 0.1;  // Probability to mutate a child.
+    unsigned int seed = 123456;         // Random seed.
+    double time_budget = -1.0;  // Wall-clock budget [s]. Non-positive: none.
+  };
+
+  MemeticSolver() : MemeticSolver(Settings()) {}
+  MemeticSolver(const Settings& settings) : settings_(settings) {}
+
+  bool solve(const Task& task, std::vector<int>* solution) override;
+
+  // The cost of the last solution.
+  inline int64_t getCost() const { return cost_; }
+
+ private:
+  struct Tour {
+    std::vector<size_t> clusters;  // Cluster order.
+    std::vector<int> nodes;        // Selected node per position.
+    int64_t cost = 0;
+  };
+
+  bool checkTask(const Task& task) const;
+
+  inline int64_t distance(int from, int to) const {
+    return static_cast<int64_t>(m_->row(from)[to]);
+  }
+  int64_t computeCost(const std::vector<int>& nodes) const;
+
+  // Select the optimal nodes for the given cluster order.
+  void optimizeClusters(Tour* tour) const;
+  // Move single clusters to their best position and node.
+  bool improveInsertion(Tour* tour) const;
+  // Alternate insertion and cluster optimization until no improvement.
+  void improve(Tour* tour) const;
+
+  Tour createRandomTour();
+  Tour crossover(const Tour& a, const Tour& b);
+  void mutate(Tour* tour);
+  const Tour& selectTournament(const std::vector<Tour>& population);
+
+  Settings settings_;
+  std::mt19937 generator_;
+  int64_t cost_ = 0;
+
+  // Current task.
+  const DistanceMatrix<int>* m_ = nullptr;
+  const std::vector<std::vector<int>>* clusters_ = nullptr;
+};
+
+}  // namespace gtsp
+}  // namespace polygon_coverage_planning
+
+#endif  // POLYGON_COVERAGE_SOLVERS_MEMETIC_SOLVER_H_
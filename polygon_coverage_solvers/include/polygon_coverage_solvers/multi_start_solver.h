@@ -0,0 +1,66 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POLYGON_COVERAGE_SOLVERS_MULTI_START_SOLVER_H_
+#define POLYGON_COVERAGE_SOLVERS_MULTI_START_SOLVER_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "polygon_coverage_solvers/gtsp_solver.h"
+
+namespace polygon_coverage_planning {
+namespace gtsp {
+
+// Runs several independent solver instances on a pool of threads and returns
+// the best tour. All runs share the same read-only task.
+class MultiStartSolver : public SolverBase {
+ public:
+  // Creates the solver for the given start index with the given remaining
+  // wall-clock budget [s]. Non-positive budget: none.
+  typedef std::function<std::unique_ptr<SolverBase>(size_t, double)> Factory;
+
+  struct Settings {
+    size_t num_starts = 4;      // Number of independent runs.
+    size_t num_threads = 0;     // Number of threads. 0: hardware concurrency.
+    double time_budget = -1.0;  // Wall-clock budget [s]. Non-positive: none.
+  };
+
+  MultiStartSolver(const Factory& factory, const Settings& settings)
+      : factory_(factory), settings_(settings) {}
+
+  // Runs that have not started when the budget is exceeded are skipped. The
+  // first run is always executed. Ties are broken by the lowest start index.
+  bool solve(const Task& task, std::vector<int>* solution) override;
+
+  // The cost of the last solution.
+  inline int64_t getCost() const { return cost_; }
+
+ private:
+  Factory factory_;
+  Settings settings_;
+  int64_t cost_ = 0;
+};
+
+}  // namespace gtsp
+}  // namespace polygon_coverage_planning
+
+#endif  // POLYGON_COVERAGE_SOLVERS_MULTI_START_SOLVER_H_
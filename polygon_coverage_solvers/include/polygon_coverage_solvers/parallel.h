@@ -0,0 +1,68 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POLYGON_COVERAGE_SOLVERS_PARALLEL_H_
+#define POLYGON_COVERAGE_SOLVERS_PARALLEL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace polygon_coverage_planning {
+
+// The number of worker threads. 0: hardware concurrency.
+inline size_t getNumThreads(size_t num_threads) {
+  if (num_threads == 0) {
+    num_threads =
+        std::max<unsigned int>(std::thread::hardware_concurrency(), 1);
+  }
+  return num_threads;
+}
+
+// Run task(i) for all i in [0, num_tasks) on up to num_threads threads (0:
+// hardware concurrency). Tasks are pulled in order. Returns false if any task
+// returned false. Remaining tasks are skipped after a failure.
+template <class Task>
+bool parallelFor(size_t num_tasks, size_t num_threads, Task task) {
+  num_threads = std::min(getNumThreads(num_threads), num_tasks);
+  std::atomic<size_t> next_task(0);
+  std::atomic<bool> success(true);
+  auto work = [&]() {
+    for (size_t i = next_task++; i < num_tasks && success; i = next_task++) {
+      if (!task(i)) {
+        success = false;
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < num_threads; ++i) {
+    threads.emplace_back(work);
+  }
+  work();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  return success;
+}
+
+}  // namespace polygon_coverage_planning
+
+#endif  // POLYGON_COVERAGE_SOLVERS_PARALLEL_H_
@@ -0,0 +1,103 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <ros/assert.h>
+#include <ros/console.h>
+
+#include "polygon_coverage_solvers/bitmask_lattice.h"
+
+namespace polygon_coverage_planning {
+namespace boolean_lattice {
+
+BitmaskLattice::BitmaskLattice(size_t num_clusters)
+    : num_clusters_(num_clusters),
+      start_cluster_(0),
+      goal_cluster_(0),
+      start_idx_(std::numeric_limits<size_t>::max()),
+      goal_idx_(std::numeric_limits<size_t>::max()),
+      is_created_(num_clusters <= kMaxBitmaskClusters) {
+  if (!is_created_) {
+    ROS_ERROR_STREAM("Bitmask lattice supports at most "
+                     << kMaxBitmaskClusters << " clusters.");
+  }
+}
+
+bool BitmaskLattice::addCluster(size_t* cluster) {
+  ROS_ASSERT(cluster);
+  if (!is_created_ || num_clusters_ + 1 > kMaxBitmaskClusters) {
+    ROS_ERROR_STREAM("Cannot add cluster to bitmask lattice.");
+    is_created_ = false;
+    return false;
+  }
+  *cluster = num_clusters_++;
+  return true;
+}
+
+bool BitmaskLattice::addStartNode() {
+  if (!addCluster(&start_cluster_)) {
+    return false;
+  }
+  // Nothing visited.
+  start_idx_ = 0;
+  return true;
+}
+
+bool BitmaskLattice::addGoalNode() {
+  if (!addCluster(&goal_cluster_)) {
+    return false;
+  }
+  // Everything visited.
+  goal_idx_ = size() - 1;
+  return true;
+}
+
+bool BitmaskLattice::edgeExists(const EdgeId& edge_id) const {
+  const Bitmask from = edge_id.first;
+  const Bitmask to = edge_id.second;
+  const Bitmask added = from ^ to;
+  return nodeExists(edge_id.first) && nodeExists(edge_id.second) &&
+         (from & to) == from  // To is a superset of from.
+         && added != 0 && (added & (added - 1)) == 0;  // Exactly one bit added.
+}
+
+bool BitmaskLattice::getEdgeCost(const EdgeId& edge_id, double* cost) const {
+  ROS_ASSERT(cost);
+  if (edgeExists(edge_id)) {
+    *cost = 0.0;
+    return true;
+  } else {
+    ROS_ERROR_STREAM("Edge from " << edge_id.first << " to " << edge_id.second
+                                  << " does not exist.");
+    *cost = -1.0;
+    return false;
+  }
+}
+
+std::set<size_t> BitmaskLattice::getVisitedClusters(size_t node_id) const {
+  std::set<size_t> visited_clusters;
+  for (size_t cluster = 0; cluster < num_clusters_; ++cluster) {
+    if (includesCluster(node_id, cluster)) {
+      visited_clusters.insert(visited_clusters.end(), cluster);
+    }
+  }
+  return visited_clusters;
+}
+
+}  // namespace boolean_lattice
+}  // namespace polygon_coverage_planning
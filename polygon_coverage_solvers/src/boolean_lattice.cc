@@ -42,11 +42,14 @@ bool BooleanLattice::create() {
   graph_.reserve(
       std::exp2(num_clusters_));  // A boolean lattice has 2^n elements.
   for (size_t k = 0; k < num_clusters_ + 1; ++k) {
-    std::vector<std::set<size_t>> combinations;
-    getAllCombinationsOfKElementsFromN(sorted_original_clusters_, k,
-                                       &combinations);
     // Add combinations as nodes to the graph.
-    for (const std::set<size_t>& combination : combinations) {
+    for (uint64_t subset : KSubsets(num_clusters_, k)) {
+      std::set<size_t> combination;
+      for (; subset; subset &= subset - 1) {
+        combination.insert(
+            combination.end(),
+            sorted_original_clusters_[__builtin_ctzll(subset)]);
+      }
       if (!addNode(NodeProperty(combination))) {
         return false;
       }
@@ -57,12 +60,14 @@ bool BooleanLattice::create() {
                   << graph_.size() << " nodes and " << edge_properties_.size()
                   << " edges.");
 
-  is_created_ = true;
-  return graph_.size() == std::exp2(num_clusters_)  // 2^n elements.
+  // Freeze graph for fast queries.
+  is_created_ = compact();
+  return is_created_ &&
+         graph_.size() == std::exp2(num_clusters_)  // 2^n elements.
          && edge_properties_.size() ==
                 num_clusters_ *
                     std::exp2(num_clusters_ - 1)  //  n * 2^(n-1) edges.
-         && graph_.size() == node_properties_.size();
+         && graph_.size() == compact_node_properties_.size();
 }
 
 bool BooleanLattice::addEdges() {
@@ -111,6 +116,8 @@ bool BooleanLattice::addStartNode(const NodeProperty& node_property) {
     return false;
   }
 
+  // Node properties are modified in place.
+  uncompact();
   start_idx_ = graph_.size();
   // Add start cluster to all existing node properties.
   start_cluster_ = num_clusters_;  // Unique start cluster.
@@ -140,6 +147,7 @@ bool BooleanLattice::addGoalNode(const NodeProperty& node_property) {
     return false;
   }
 
+  uncompact();
   goal_idx_ = graph_.size();
   goal_cluster_ = num_clusters_;  // Unique goal cluster.
   num_clusters_++;
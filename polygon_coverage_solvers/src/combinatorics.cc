@@ -19,6 +19,8 @@
 
 #include "polygon_coverage_solvers/combinatorics.h"
 
+#include <array>
+
 #include <ros/console.h>
 #include <ros/assert.h>
 
@@ -61,4 +63,64 @@ void getAllCombinationsOfKElementsFromN(
   }
 }
 
+namespace {
+typedef std::array<std::array<uint64_t, kMaxSubsetElements + 1>,
+                   kMaxSubsetElements + 1>
+    BinomialTable;
+
+// Pascal's triangle up to kMaxSubsetElements, computed once.
+const BinomialTable& getBinomialTable() {
+  static const BinomialTable table = [] {
+    BinomialTable t{};
+    for (size_t n = 0; n <= kMaxSubsetElements; ++n) {
+      t[n][0] = 1;
+      for (size_t k = 1; k <= n; ++k) {
+        t[n][k] = t[n - 1][k - 1] + t[n - 1][k];
+      }
+    }
+    return t;
+  }();
+  return table;
+}
+}  // namespace
+
+uint64_t binomial(size_t n, size_t k) {
+  ROS_ASSERT(n <= kMaxSubsetElements);
+  return k > n ? 0 : getBinomialTable()[n][k];
+}
+
+uint64_t rankSubset(uint64_t subset) {
+  // Combinatorial number system: sum of C(c_i, i + 1) over the ascending
+  // elements c_i.
+  const BinomialTable& table = getBinomialTable();
+  uint64_t rank = 0;
+  for (size_t i = 1; subset; ++i, subset &= subset - 1) {
+    rank += table[__builtin_ctzll(subset)][i];
+  }
+  return rank;
+}
+
+uint64_t unrankSubset(uint64_t rank, size_t k) {
+  ROS_ASSERT(k <= kMaxSubsetElements);
+  const BinomialTable& table = getBinomialTable();
+  uint64_t subset = 0;
+  // Greedily pick the largest element c with C(c, k) <= rank.
+  size_t c = kMaxSubsetElements;
+  for (; k > 0; --k) {
+    do {
+      --c;
+    } while (table[c][k] > rank);
+    rank -= table[c][k];
+    subset |= static_cast<uint64_t>(1) << c;
+  }
+  return subset;
+}
+
+KSubsets::KSubsets(size_t n, size_t k)
+    : first_(k >= kMaxSubsetElements ? ~static_cast<uint64_t>(0)
+                                     : (static_cast<uint64_t>(1) << k) - 1),
+      size_(binomial(n, k)) {
+  ROS_ASSERT(n <= kMaxSubsetElements);
+}
+
 }  // namespace polygon_coverage_planning
@@ -19,6 +19,9 @@
 
 #include "polygon_coverage_solvers/gk_ma.h"
 
+#include <cstring>
+#include <mutex>
+
 #include <mono/jit/jit.h>
 #include <mono/metadata/assembly.h>
 
@@ -37,28 +40,7 @@ const std::string kCatkinPath =
 const std::string kLibraryPath = kCatkinPath + "/devel/lib";
 const std::string kExecutablePath = kLibraryPath + "/" + kFile;
 
-bool Task::mIsSquare() const {
-  for (size_t i = 0; i < m.size(); ++i) {
-    if (m[i].size() != m.size()) {
-      return false;
-    }
-  }
-  return true;
-}
-
-bool Task::mIsSymmetric() const {
-  if (!mIsSquare()) {
-    return false;
-  }
-  for (size_t i = 0; i < m.size(); ++i) {
-    for (size_t j = 0; j < m[i].size(); ++j) {
-      if (m[i][j] != m[j][i]) {
-        return false;
-      }
-    }
-  }
-  return true;
-}
+std::string getLibraryPath() { return kLibraryPath; }
 
 GkMa::GkMa() {
   domain_ = mono_jit_init(kFile.c_str());
@@ -73,6 +55,21 @@ GkMa::GkMa() {
   ROS_ASSERT_MSG(solver_class_, "Cannot find OurSolver in assembly %s",
                  mono_image_get_filename(image));
   solver_ = mono_object_new(domain_, solver_class_);  // Allocate memory.
+
+  // Resolve method handles once. The Solution property is inherited from the
+  // base class Solver.
+  file_ctor_ = mono_class_get_method_from_name(solver_class_, ".ctor", 2);
+  ROS_ASSERT_MSG(file_ctor_, "Constructor OurSolver(file, binary) not found.");
+  // Flat matrix, its size, the clusters and the symmetry flag.
+  task_ctor_ = mono_class_get_method_from_name(solver_class_, ".ctor", 4);
+  ROS_ASSERT_MSG(task_ctor_, "Constructor OurSolver(m, n, ...) not found.");
+  solve_ = mono_class_get_method_from_name(solver_class_, "Solve", 0);
+  ROS_ASSERT_MSG(solve_, "Method Solve() not found.");
+  MonoProperty* prop =
+      mono_class_get_property_from_name(solver_class_, "Solution");
+  ROS_ASSERT_MSG(prop, "Property Solution not found.");
+  get_solution_ = mono_property_get_get_method(prop);
+  ROS_ASSERT_MSG(get_solution_, "Getter Solution() not found.");
 }
 
 GkMa::~GkMa() { mono_jit_cleanup(domain_); }
@@ -82,48 +79,24 @@ void GkMa::setSolver(const std::string& file, bool binary) {
   args[0] = mono_string_new(domain_, file.c_str());
   args[1] = &binary;
 
-  // Find constructor method.
-  void* iter = NULL;
-  MonoMethod* ctor = NULL;
-  while ((ctor = mono_class_get_methods(solver_class_, &iter))) {
-    if (strcmp(mono_method_get_name(ctor), ".ctor") == 0) {
-      // Check if the ctor takes two arguments.
-      MonoMethodSignature* sig = mono_method_signature(ctor);
-      if (mono_signature_get_param_count(sig) == 2) {
-        break;
-      }
-    }
-  }
-
-  mono_runtime_invoke(ctor, solver_, args, NULL);
+  mono_runtime_invoke(file_ctor_, solver_, args, NULL);
   MonoObject* exception = nullptr;
-  mono_runtime_invoke(ctor, solver_, args, &exception);
+  mono_runtime_invoke(file_ctor_, solver_, args, &exception);
   if (exception) {
     mono_print_unhandled_exception(exception);
   }
 }
 
 void GkMa::setSolver(const Task& task) {
-  void* args[3];
-  args[0] = vectorOfVectorToMonoArray(task.m);
-  args[1] = vectorOfVectorToMonoArray(task.clusters);
+  void* args[4];
+  args[0] = distanceMatrixToMonoArray(task.m);
+  int size = static_cast<int>(task.m.size());
+  args[1] = &size;
+  args[2] = vectorOfVectorToMonoArray(task.clusters);
   bool is_symmetric = task.mIsSymmetric();
-  args[2] = &is_symmetric;
-
-  // Find constructor method.
-  void* iter = NULL;
-  MonoMethod* ctor = NULL;
-  while ((ctor = mono_class_get_methods(solver_class_, &iter))) {
-    if (strcmp(mono_method_get_name(ctor), ".ctor") == 0) {
-      // Check if the ctor takes two arguments.
-      MonoMethodSignature* sig = mono_method_signature(ctor);
-      if (mono_signature_get_param_count(sig) == 3) {
-        break;
-      }
-    }
-  }
+  args[3] = &is_symmetric;
 
-  mono_runtime_invoke(ctor, solver_, args, NULL);
+  mono_runtime_invoke(task_ctor_, solver_, args, NULL);
 }
 
 MonoArray* GkMa::vectorOfVectorToMonoArray(
@@ -133,14 +106,26 @@ MonoArray* GkMa::vectorOfVectorToMonoArray(
   for (size_t i = 0; i < in.size(); ++i) {
     MonoArray* row =
         mono_array_new(domain_, mono_get_int32_class(), in[i].size());
-    for (size_t j = 0; j < in[i].size(); ++j) {
-      mono_array_set(row, int, j, in[i][j]);
+    if (!in[i].empty()) {
+      std::memcpy(mono_array_addr(row, int, 0), in[i].data(),
+                  in[i].size() * sizeof(int));
     }
     mono_array_set(result, MonoArray*, i, row);
   }
   return result;
 }
 
+MonoArray* GkMa::distanceMatrixToMonoArray(const DistanceMatrix<int>& m) const {
+  const size_t num_elements = m.size() * m.size();
+  MonoArray* result =
+      mono_array_new(domain_, mono_get_int32_class(), num_elements);
+  if (num_elements > 0) {
+    std::memcpy(mono_array_addr(result, int, 0), m.data(),
+                num_elements * sizeof(int));
+  }
+  return result;
+}
+
 bool GkMa::solve() {
   // TODO(rikba): Check if solver ctor was called.
   if (!solver_) {
@@ -148,51 +133,38 @@ bool GkMa::solve() {
     return false;
   }
 
-  // Find methods SolutionAtIndex(int index) and Solve().
-  void* iter = NULL;
-  MonoMethod* m = NULL;
-  MonoMethod* solve = NULL;
-  MonoMethod* solution_at_index = NULL;
-  while ((m = mono_class_get_methods(solver_class_, &iter))) {
-    if (strcmp(mono_method_get_name(m), "Solve") == 0) {
-      solve = m;
-    } else if (strcmp(mono_method_get_name(m), "SolutionAtIndex") == 0) {
-      solution_at_index = m;
-    }
-  }
-  if (solve == NULL || solution_at_index == NULL) {
-    ROS_ERROR_COND(solve == NULL, "Method Solve() not found.");
-    ROS_ERROR_COND(solution_at_index == NULL,
-                   "Method SolutionAtIndex(int index) not found.");
-    return false;
-  }
-
   // Solve()
-  mono_runtime_invoke(solve, solver_, NULL, NULL);
+  mono_runtime_invoke(solve_, solver_, NULL, NULL);
 
-  // Solution().
-  MonoProperty* prop =
-      mono_class_get_property_from_name(solver_class_, "SolutionLength");
-  MonoMethod* solution_length = mono_property_get_get_method(prop);
-  if (solution_length == NULL) {
-    ROS_ERROR_STREAM("Getter SolutionLength() not found.");
+  // Copy the whole tour out of the managed int[] in one block.
+  MonoArray* result = reinterpret_cast<MonoArray*>(
+      mono_runtime_invoke(get_solution_, solver_, NULL, NULL));
+  if (result == NULL) {
+    ROS_ERROR_STREAM("Solver returned no solution.");
     return false;
   }
-  MonoObject* result =
-      mono_runtime_invoke(solution_length, solver_, NULL, NULL);
-  int num_nodes = *(int*)mono_object_unbox(result);
-
-  solution_.resize(num_nodes);
-  for (int i = 0; i < num_nodes; ++i) {
-    void* args[1];
-    args[0] = &i;
-    MonoObject* node =
-        mono_runtime_invoke(solution_at_index, solver_, args, NULL);
-    solution_[i] = *(int*)mono_object_unbox(node);
+  solution_.resize(mono_array_length(result));
+  if (!solution_.empty()) {
+    std::memcpy(solution_.data(), mono_array_addr(result, int, 0),
+                solution_.size() * sizeof(int));
   }
 
   return true;
 }
 
+bool GkMaSolver::solve(const Task& task, std::vector<int>* solution) {
+  ROS_ASSERT(solution);
+  static std::mutex mutex;
+  std::lock_guard<std::mutex> lock(mutex);
+
+  GkMa& instance = GkMa::getInstance();
+  instance.setSolver(task);
+  if (!instance.solve()) {
+    return false;
+  }
+  *solution = instance.getSolution();
+  return true;
+}
+
 }  // namespace gk_ma
 }  // namespace polygon_coverage_planning
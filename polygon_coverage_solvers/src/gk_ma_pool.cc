@@ -0,0 +1,341 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "polygon_coverage_solvers/gk_ma_pool.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include <ros/assert.h>
+#include <ros/console.h>
+
+#include "polygon_coverage_solvers/gk_ma.h"
+#include "polygon_coverage_solvers/parallel.h"
+
+namespace polygon_coverage_planning {
+namespace gk_ma {
+
+namespace {
+const size_t kHeaderSize = 4;
+
+bool sendAll(int socket, const void* data, size_t size) {
+  const char* bytes = static_cast<const char*>(data);
+  while (size > 0) {
+    const ssize_t sent = send(socket, bytes, size, MSG_NOSIGNAL);
+    if (sent <= 0) {
+      return false;
+    }
+    bytes += sent;
+    size -= sent;
+  }
+  return true;
+}
+
+bool receiveAll(int socket, void* data, size_t size) {
+  char* bytes = static_cast<char*>(data);
+  while (size > 0) {
+    const ssize_t received = recv(socket, bytes, size, 0);
+    if (received <= 0) {
+      return false;
+    }
+    bytes += received;
+    size -= received;
+  }
+  return true;
+}
+}  // namespace
+
+size_t getSharedTaskSize(const Task& task) {
+  size_t num_cluster_nodes = 0;
+  for (const std::vector<int>& cluster : task.clusters) {
+    num_cluster_nodes += cluster.size();
+  }
+  return sizeof(int32_t) * (kHeaderSize + 2 * task.clusters.size() +
+                            num_cluster_nodes + task.m.size() * task.m.size());
+}
+
+void writeSharedTask(const Task& task, int32_t* data) {
+  ROS_ASSERT(data);
+  size_t num_cluster_nodes = 0;
+  for (const std::vector<int>& cluster : task.clusters) {
+    num_cluster_nodes += cluster.size();
+  }
+  const size_t num_clusters = task.clusters.size();
+  data[0] = static_cast<int32_t>(task.m.size());
+  data[1] = static_cast<int32_t>(num_clusters);
+  data[2] = static_cast<int32_t>(num_cluster_nodes);
+  data[3] = 0;
+
+  int32_t* cluster_sizes = data + kHeaderSize + num_clusters;
+  int32_t* cluster_nodes = cluster_sizes + num_clusters;
+  for (size_t i = 0; i < num_clusters; ++i) {
+    cluster_sizes[i] = static_cast<int32_t>(task.clusters[i].size());
+    std::copy(task.clusters[i].begin(), task.clusters[i].end(),
+              cluster_nodes);
+    cluster_nodes += task.clusters[i].size();
+  }
+  if (!task.m.empty()) {
+    std::memcpy(cluster_nodes, task.m.data(),
+                task.m.size() * task.m.size() * sizeof(int32_t));
+  }
+}
+
+bool readSharedTask(const int32_t* data, size_t size, Task* task) {
+  ROS_ASSERT(data);
+  ROS_ASSERT(task);
+  if (size < kHeaderSize * sizeof(int32_t) || data[0] < 0 || data[1] < 0 ||
+      data[2] < 0) {
+    return false;
+  }
+  const size_t num_nodes = data[0];
+  const size_t num_clusters = data[1];
+  const size_t num_cluster_nodes = data[2];
+  if (size != sizeof(int32_t) * (kHeaderSize + 2 * num_clusters +
+                                 num_cluster_nodes + num_nodes * num_nodes)) {
+    return false;
+  }
+
+  const int32_t* cluster_sizes = data + kHeaderSize + num_clusters;
+  const int32_t* cluster_nodes = cluster_sizes + num_clusters;
+  std::vector<std::vector<int>> clusters(num_clusters);
+  size_t offset = 0;
+  for (size_t i = 0; i < num_clusters; ++i) {
+    if (cluster_sizes[i] < 0 ||
+        offset + static_cast<size_t>(cluster_sizes[i]) > num_cluster_nodes) {
+      return false;
+    }
+    clusters[i].assign(cluster_nodes + offset,
+                       cluster_nodes + offset + cluster_sizes[i]);
+    offset += cluster_sizes[i];
+  }
+  DistanceMatrix<int> m(num_nodes);
+  if (num_nodes > 0) {
+    std::memcpy(m.data(), cluster_nodes + num_cluster_nodes,
+                num_nodes * num_nodes * sizeof(int32_t));
+  }
+  *task = Task(std::move(m), clusters);
+  return true;
+}
+
+void writeSharedSolution(const std::vector<int>& solution, int32_t* data) {
+  ROS_ASSERT(data);
+  const size_t num_clusters = data[1];
+  const size_t solution_size = std::min(solution.size(), num_clusters);
+  data[3] = static_cast<int32_t>(solution_size);
+  std::copy(solution.begin(), solution.begin() + solution_size,
+            data + kHeaderSize);
+}
+
+bool readSharedSolution(const int32_t* data, size_t size,
+                        std::vector<int>* solution) {
+  ROS_ASSERT(data);
+  ROS_ASSERT(solution);
+  if (size < kHeaderSize * sizeof(int32_t) || data[3] < 0 ||
+      data[3] > data[1]) {
+    return false;
+  }
+  solution->assign(data + kHeaderSize, data + kHeaderSize + data[3]);
+  return true;
+}
+
+GkMaWorkerPool::GkMaWorkerPool()
+    : num_workers_(0),
+      max_workers_(getNumThreads(0)),
+      worker_path_(getLibraryPath() +
+                   "/polygon_coverage_solvers/gk_ma_worker") {}
+
+GkMaWorkerPool::~GkMaWorkerPool() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (std::unique_ptr<Worker>& worker : idle_workers_) {
+    terminateWorker(worker.get());
+  }
+}
+
+void GkMaWorkerPool::setMaxWorkers(size_t max_workers) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  max_workers_ = getNumThreads(max_workers);
+  worker_released_.notify_all();
+}
+
+size_t GkMaWorkerPool::getNumWorkers() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_workers_;
+}
+
+bool GkMaWorkerPool::solve(const Task& task, std::vector<int>* solution) {
+  ROS_ASSERT(solution);
+  solution->clear();
+
+  // Take an idle worker or spawn a new one.
+  std::unique_ptr<Worker> worker;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    worker_released_.wait(lock, [this]() {
+      return !idle_workers_.empty() || num_workers_ < max_workers_;
+    });
+    if (!idle_workers_.empty()) {
+      worker = std::move(idle_workers_.back());
+      idle_workers_.pop_back();
+    } else {
+      ++num_workers_;
+    }
+  }
+  if (worker == nullptr) {
+    worker.reset(new Worker());
+    if (!spawnWorker(worker.get())) {
+      ROS_ERROR_STREAM("Cannot spawn GK MA worker " << worker_path_);
+      std::lock_guard<std::mutex> lock(mutex_);
+      --num_workers_;
+      worker_released_.notify_one();
+      return false;
+    }
+  }
+
+  bool is_alive = true;
+  const bool success = runWorker(worker.get(), task, solution, &is_alive);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (is_alive) {
+    idle_workers_.push_back(std::move(worker));
+  } else {
+    ROS_ERROR("GK MA worker died.");
+    terminateWorker(worker.get());
+    --num_workers_;
+  }
+  worker_released_.notify_one();
+  return success;
+}
+
+bool GkMaWorkerPool::spawnWorker(Worker* worker) const {
+  ROS_ASSERT(worker);
+  static std::atomic<size_t> id(0);
+  const std::string shm_name = "/polygon_coverage_gk_ma_" +
+                               std::to_string(getpid()) + "_" +
+                               std::to_string(id++);
+  worker->shm =
+      shm_open(shm_name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+  if (worker->shm < 0) {
+    return false;
+  }
+  int sockets[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sockets) != 0) {
+    shm_unlink(shm_name.c_str());
+    close(worker->shm);
+    worker->shm = -1;
+    return false;
+  }
+  worker->socket = sockets[0];
+
+  // Prepare the arguments before forking. Only async-signal-safe calls are
+  // allowed in the child of a multi-threaded process.
+  const std::string socket_arg = std::to_string(sockets[1]);
+  char* const argv[] = {const_cast<char*>(worker_path_.c_str()),
+                        const_cast<char*>(socket_arg.c_str()),
+                        const_cast<char*>(shm_name.c_str()), nullptr};
+  worker->pid = fork();
+  if (worker->pid == 0) {
+    // Inherit only the worker end of the socket.
+    fcntl(sockets[1], F_SETFD, 0);
+    execv(argv[0], argv);
+    _exit(EXIT_FAILURE);
+  }
+  close(sockets[1]);
+  if (worker->pid < 0) {
+    shm_unlink(shm_name.c_str());
+    terminateWorker(worker);
+    return false;
+  }
+
+  // The worker unlinks the segment after opening it. It reports once the
+  // solver is loaded.
+  int32_t ready = 0;
+  if (!receiveAll(worker->socket, &ready, sizeof(ready)) || ready != 1) {
+    shm_unlink(shm_name.c_str());
+    terminateWorker(worker);
+    return false;
+  }
+  return true;
+}
+
+void GkMaWorkerPool::terminateWorker(Worker* worker) const {
+  ROS_ASSERT(worker);
+  // Closing the socket makes the worker exit.
+  if (worker->socket >= 0) {
+    close(worker->socket);
+    worker->socket = -1;
+  }
+  if (worker->shm >= 0) {
+    close(worker->shm);
+    worker->shm = -1;
+  }
+  if (worker->pid > 0) {
+    waitpid(worker->pid, nullptr, 0);
+    worker->pid = -1;
+  }
+}
+
+bool GkMaWorkerPool::runWorker(Worker* worker, const Task& task,
+                               std::vector<int>* solution,
+                               bool* is_alive) const {
+  ROS_ASSERT(worker);
+  ROS_ASSERT(solution);
+  ROS_ASSERT(is_alive);
+  *is_alive = true;
+
+  const uint64_t size = getSharedTaskSize(task);
+  if (ftruncate(worker->shm, size) != 0) {
+    ROS_ERROR_STREAM("Cannot resize GK MA shared memory: "
+                     << std::strerror(errno));
+    return false;
+  }
+  void* data =
+      mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, worker->shm, 0);
+  if (data == MAP_FAILED) {
+    ROS_ERROR_STREAM("Cannot map GK MA shared memory: "
+                     << std::strerror(errno));
+    return false;
+  }
+  writeSharedTask(task, static_cast<int32_t*>(data));
+
+  // Request: task size. Reply: 1 on success.
+  int32_t status = 0;
+  *is_alive = sendAll(worker->socket, &size, sizeof(size)) &&
+              receiveAll(worker->socket, &status, sizeof(status));
+  const bool success =
+      *is_alive && status == 1 &&
+      readSharedSolution(static_cast<int32_t*>(data), size, solution);
+  munmap(data, size);
+  return success;
+}
+
+bool GkMaPoolSolver::solve(const Task& task, std::vector<int>* solution) {
+  return GkMaWorkerPool::getInstance().solve(task, solution);
+}
+
+}  // namespace gk_ma
+}  // namespace polygon_coverage_planning
@@ -0,0 +1,81 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Hosts one GK MA solver for the GkMaWorkerPool.
+// Usage: gk_ma_worker <socket fd> <shared memory name>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "polygon_coverage_solvers/gk_ma.h"
+#include "polygon_coverage_solvers/gk_ma_pool.h"
+
+using namespace polygon_coverage_planning;
+using namespace gk_ma;
+
+int main(int argc, char** argv) {
+  if (argc != 3) {
+    return EXIT_FAILURE;
+  }
+  const int socket = std::atoi(argv[1]);
+  const int shm = shm_open(argv[2], O_RDWR, 0);
+  shm_unlink(argv[2]);
+  if (shm < 0) {
+    return EXIT_FAILURE;
+  }
+
+  // Load the solver once and report readiness.
+  GkMa& instance = GkMa::getInstance();
+  int32_t status = 1;
+  if (send(socket, &status, sizeof(status), MSG_NOSIGNAL) != sizeof(status)) {
+    return EXIT_FAILURE;
+  }
+
+  // Serve requests until the pool closes the socket.
+  uint64_t size = 0;
+  while (recv(socket, &size, sizeof(size), MSG_WAITALL) == sizeof(size)) {
+    status = 0;
+    void* data =
+        mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, shm, 0);
+    if (data != MAP_FAILED) {
+      int32_t* shared = static_cast<int32_t*>(data);
+      Task task{DistanceMatrix<int>(), {}};
+      if (readSharedTask(shared, size, &task)) {
+        instance.setSolver(task);
+        if (instance.solve()) {
+          writeSharedSolution(instance.getSolution(), shared);
+          status = 1;
+        }
+      }
+      munmap(data, size);
+    }
+    if (send(socket, &status, sizeof(status), MSG_NOSIGNAL) !=
+        sizeof(status)) {
+      break;
+    }
+  }
+
+  close(shm);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,108 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <utility>
+
+#include <ros/assert.h>
+
+#include "polygon_coverage_solvers/graph_search.h"
+
+namespace polygon_coverage_planning {
+
+IndexedMinHeap::IndexedMinHeap(size_t num_nodes)
+    : position_(num_nodes, kNotInHeap),
+      key_(num_nodes, std::numeric_limits<double>::max()) {}
+
+void IndexedMinHeap::reset(size_t num_nodes) {
+  heap_.clear();
+  position_.assign(num_nodes, kNotInHeap);
+  key_.assign(num_nodes, std::numeric_limits<double>::max());
+}
+
+void IndexedMinHeap::push(size_t id, double key) {
+  ROS_ASSERT(id < position_.size());
+  if (contains(id)) {
+    if (key < key_[id]) {
+      key_[id] = key;
+      siftUp(position_[id]);
+    }
+  } else {
+    key_[id] = key;
+    position_[id] = heap_.size();
+    heap_.push_back(id);
+    siftUp(heap_.size() - 1);
+  }
+}
+
+size_t IndexedMinHeap::pop() {
+  ROS_ASSERT(!heap_.empty());
+  const size_t top = heap_.front();
+  swap(0, heap_.size() - 1);
+  heap_.pop_back();
+  position_[top] = kNotInHeap;
+  if (!heap_.empty()) {
+    siftDown(0);
+  }
+  return top;
+}
+
+void IndexedMinHeap::siftUp(size_t pos) {
+  while (pos > 0) {
+    const size_t parent = (pos - 1) / 2;
+    if (key_[heap_[parent]] <= key_[heap_[pos]]) {
+      break;
+    }
+    swap(pos, parent);
+    pos = parent;
+  }
+}
+
+void IndexedMinHeap::siftDown(size_t pos) {
+  while (true) {
+    const size_t left = 2 * pos + 1;
+    const size_t right = left + 1;
+    size_t smallest = pos;
+    if (left < heap_.size() && key_[heap_[left]] < key_[heap_[smallest]]) {
+      smallest = left;
+    }
+    if (right < heap_.size() && key_[heap_[right]] < key_[heap_[smallest]]) {
+      smallest = right;
+    }
+    if (smallest == pos) {
+      break;
+    }
+    swap(pos, smallest);
+    pos = smallest;
+  }
+}
+
+void IndexedMinHeap::swap(size_t a, size_t b) {
+  std::swap(heap_[a], heap_[b]);
+  position_[heap_[a]] = a;
+  position_[heap_[b]] = b;
+}
+
+void SearchWorkspace::reset(size_t num_nodes) {
+  open_set.reset(num_nodes);
+  closed_set.assign(num_nodes, false);
+  came_from.assign(num_nodes, kNoParent);
+  cost.assign(num_nodes, std::numeric_limits<double>::max());
+}
+
+}  // namespace polygon_coverage_planning
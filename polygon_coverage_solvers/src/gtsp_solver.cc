@@ -0,0 +1,95 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "polygon_coverage_solvers/gtsp_solver.h"
+#include "polygon_coverage_solvers/gk_ma.h"
+#include "polygon_coverage_solvers/gk_ma_pool.h"
+#include "polygon_coverage_solvers/memetic_solver.h"
+#include "polygon_coverage_solvers/multi_start_solver.h"
+
+#include <algorithm>
+
+#include <ros/console.h>
+
+namespace polygon_coverage_planning {
+namespace gtsp {
+
+Task::Task(const std::vector<std::vector<int>>& m,
+           const std::vector<std::vector<int>>& clusters)
+    : clusters(clusters) {
+  if (!DistanceMatrix<int>::fromRows(m, &this->m)) {
+    ROS_ERROR_STREAM("Distance matrix is not square.");
+  }
+}
+
+int64_t computeCost(const DistanceMatrix<int>& m,
+                    const std::vector<int>& tour) {
+  int64_t cost = 0;
+  for (size_t i = 0; i < tour.size(); ++i) {
+    cost += m(tour[i], tour[(i + 1) % tour.size()]);
+  }
+  return cost;
+}
+
+std::unique_ptr<SolverBase> createSolver(const SolverType& type,
+                                         const SolverSettings& settings) {
+  MultiStartSolver::Factory factory;
+  switch (type) {
+    case SolverType::kGkMa:
+      // GK MA runs in a single Mono runtime. Multiple starts are serialized.
+      factory = [](size_t, double) {
+        return std::make_unique<gk_ma::GkMaSolver>();
+      };
+      break;
+    case SolverType::kGkMaPool:
+      // Every start takes its own worker process.
+      factory = [](size_t, double) {
+        return std::make_unique<gk_ma::GkMaPoolSolver>();
+      };
+      break;
+    case SolverType::kNative:
+      factory = [](size_t start, double time_budget) {
+        MemeticSolver::Settings memetic_settings;
+        memetic_settings.seed += static_cast<unsigned int>(start);
+        memetic_settings.time_budget = time_budget;
+        return std::make_unique<MemeticSolver>(memetic_settings);
+      };
+      break;
+    default:
+      return nullptr;
+  }
+
+  if (settings.time_budget > 0.0 && !checkSolverStopsOnBudget(type)) {
+    ROS_WARN_STREAM_ONCE(getSolverTypeName(type)
+                         << " cannot stop a run. The time budget only skips "
+                            "further starts. Use the native solver to bound "
+                            "solving time.");
+  }
+  if (settings.num_starts <= 1 && settings.time_budget <= 0.0) {
+    return factory(0, settings.time_budget);
+  }
+  MultiStartSolver::Settings multi_start_settings;
+  multi_start_settings.num_starts = std::max<size_t>(settings.num_starts, 1);
+  multi_start_settings.num_threads = settings.num_threads;
+  multi_start_settings.time_budget = settings.time_budget;
+  return std::make_unique<MultiStartSolver>(factory, multi_start_settings);
+}
+
+}  // namespace gtsp
+}  // namespace polygon_coverage_planning
@@ -0,0 +1,205 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "polygon_coverage_solvers/held_karp.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+#include <ros/assert.h>
+#include <ros/console.h>
+
+namespace polygon_coverage_planning {
+namespace held_karp {
+
+const double kInfinity = std::numeric_limits<double>::infinity();
+
+inline double toCost(double cost) {
+  return cost == DistanceMatrix<double>::kNoConnection ? kInfinity : cost;
+}
+
+// The minimum of a[i] + b[i]. Floating point min-reductions are only
+// vectorized if explicitly allowed, see -fopenmp-simd in CMakeLists.txt.
+inline double minSum(const double* a, const double* b, size_t n) {
+  double min = kInfinity;
+#pragma omp simd reduction(min : min)
+  for (size_t i = 0; i < n; ++i) {
+    const double sum = a[i] + b[i];
+    min = sum < min ? sum : min;
+  }
+  return min;
+}
+
+bool HeldKarp::computeTableSize(size_t num_clusters, size_t num_nodes,
+                                size_t* table_size) {
+  ROS_ASSERT(table_size);
+  if (num_clusters >= std::numeric_limits<size_t>::digits) {
+    return false;
+  }
+  const size_t num_masks = static_cast<size_t>(1) << num_clusters;
+  if (num_nodes > 0 &&
+      num_masks > std::numeric_limits<size_t>::max() / num_nodes) {
+    return false;
+  }
+  *table_size = num_masks * num_nodes;
+  return true;
+}
+
+bool HeldKarp::solve(const DistanceMatrix<double>& m,
+                     const std::vector<std::vector<int>>& clusters,
+                     size_t start, size_t goal, Solution* solution,
+                     const Deadline& deadline) {
+  ROS_ASSERT(solution);
+  solution->clear();
+  cost_ = kInfinity;
+
+  const size_t num_clusters = clusters.size();
+  if (start >= m.size() || goal >= m.size() || start == goal) {
+    ROS_ERROR_STREAM("Invalid start " << start << " or goal " << goal << ".");
+    return false;
+  }
+  if (num_clusters > settings_.max_clusters) {
+    ROS_ERROR_STREAM("Number of clusters " << num_clusters
+                                           << " exceeds maximum of "
+                                           << settings_.max_clusters << ".");
+    return false;
+  }
+
+  // Order the nodes by cluster.
+  std::vector<size_t> nodes;
+  std::vector<size_t> cluster_of_node;
+  for (size_t c = 0; c < num_clusters; ++c) {
+    if (clusters[c].empty()) {
+      ROS_ERROR_STREAM("Cluster " << c << " is empty.");
+      return false;
+    }
+    for (int node : clusters[c]) {
+      if (node < 0 || static_cast<size_t>(node) >= m.size() ||
+          static_cast<size_t>(node) == start ||
+          static_cast<size_t>(node) == goal) {
+        ROS_ERROR_STREAM("Invalid node " << node << " in cluster " << c << ".");
+        return false;
+      }
+      nodes.push_back(static_cast<size_t>(node));
+      cluster_of_node.push_back(c);
+    }
+  }
+  const size_t num_nodes = nodes.size();
+
+  if (num_clusters == 0) {
+    cost_ = toCost(m(start, goal));
+    if (cost_ == kInfinity) {
+      return false;
+    }
+    *solution = {start, goal};
+    return true;
+  }
+
+  size_t table_size = 0;
+  if (!computeTableSize(num_clusters, num_nodes, &table_size) ||
+      table_size > settings_.max_table_size) {
+    ROS_ERROR_STREAM("Held-Karp table with "
+                     << num_clusters << " clusters and " << num_nodes
+                     << " nodes exceeds maximum size of "
+                     << settings_.max_table_size << " entries.");
+    return false;
+  }
+
+  // The costs into every node, such that all predecessors are contiguous.
+  std::vector<double> costs_to(num_nodes * num_nodes);
+  for (size_t v = 0; v < num_nodes; ++v) {
+    for (size_t u = 0; u < num_nodes; ++u) {
+      costs_to[v * num_nodes + u] = toCost(m(nodes[u], nodes[v]));
+    }
+  }
+
+  // table[mask * num_nodes + v]: The cheapest path from start through all
+  // clusters in mask ending in v. Infinite if the cluster of v is not in mask.
+  std::vector<double> table(table_size, kInfinity);
+  for (size_t v = 0; v < num_nodes; ++v) {
+    const size_t mask = static_cast<size_t>(1) << cluster_of_node[v];
+    table[mask * num_nodes + v] = toCost(m(start, nodes[v]));
+  }
+  const size_t num_masks = static_cast<size_t>(1) << num_clusters;
+  DeadlinePoller poller(deadline);
+  for (size_t mask = 1; mask < num_masks; ++mask) {
+    if (poller.isExpired()) {
+      ROS_ERROR_STREAM("Held-Karp deadline expired.");
+      return false;
+    }
+    double* row = table.data() + mask * num_nodes;
+    for (size_t v = 0; v < num_nodes; ++v) {
+      const size_t bit = static_cast<size_t>(1) << cluster_of_node[v];
+      const size_t previous = mask ^ bit;
+      if ((mask & bit) == 0 || previous == 0) {
+        continue;
+      }
+      // Entries of nodes outside the previous clusters are infinite.
+      row[v] = minSum(table.data() + previous * num_nodes,
+                      costs_to.data() + v * num_nodes, num_nodes);
+    }
+  }
+
+  // Close the path at the goal.
+  const size_t full_mask = num_masks - 1;
+  const double* full_row = table.data() + full_mask * num_nodes;
+  size_t last = num_nodes;
+  for (size_t v = 0; v < num_nodes; ++v) {
+    const double cost = full_row[v] + toCost(m(nodes[v], goal));
+    if (cost < cost_) {
+      cost_ = cost;
+      last = v;
+    }
+  }
+  if (last == num_nodes) {
+    ROS_ERROR_STREAM("Goal is not reachable.");
+    return false;
+  }
+
+  // Backtrack by recomputing the minimizing predecessor.
+  solution->push_back(goal);
+  size_t mask = full_mask;
+  size_t v = last;
+  while (true) {
+    solution->push_back(nodes[v]);
+    const size_t previous =
+        mask ^ (static_cast<size_t>(1) << cluster_of_node[v]);
+    if (previous == 0) {
+      break;
+    }
+    const double cost = table[mask * num_nodes + v];
+    const double* previous_row = table.data() + previous * num_nodes;
+    const double* to_v = costs_to.data() + v * num_nodes;
+    size_t u = 0;
+    while (u < num_nodes && previous_row[u] + to_v[u] != cost) {
+      ++u;
+    }
+    ROS_ASSERT(u < num_nodes);
+    mask = previous;
+    v = u;
+  }
+  solution->push_back(start);
+  std::reverse(solution->begin(), solution->end());
+
+  return true;
+}
+
+}  // namespace held_karp
+}  // namespace polygon_coverage_planning
@@ -0,0 +1,321 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "polygon_coverage_solvers/memetic_solver.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <numeric>
+
+#include <ros/assert.h>
+#include <ros/console.h>
+
+namespace polygon_coverage_planning {
+namespace gtsp {
+
+bool MemeticSolver::solve(const Task& task, std::vector<int>* solution) {
+  ROS_ASSERT(solution);
+  solution->clear();
+  if (!checkTask(task)) {
+    return false;
+  }
+  m_ = &task.m;
+  clusters_ = &task.clusters;
+  generator_.seed(settings_.seed);
+  const std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  auto budget_exceeded = [this, &start]() {
+    return settings_.time_budget > 0.0 &&
+           std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+                   .count() >= settings_.time_budget;
+  };
+
+  // Initial population.
+  const size_t population_size = std::max<size_t>(settings_.population_size, 2);
+  std::vector<Tour> population;
+  population.reserve(population_size);
+  for (size_t i = 0; i < population_size; ++i) {
+    population.push_back(createRandomTour());
+  }
+  auto cost_compare = [](const Tour& a, const Tour& b) {
+    return a.cost < b.cost;
+  };
+  Tour best =
+      *std::min_element(population.begin(), population.end(), cost_compare);
+
+  // Evolution.
+  std::uniform_real_distribution<double> probability(0.0, 1.0);
+  size_t idle_generations = 0;
+  for (size_t generation = 0;
+       generation < settings_.max_generations &&
+       idle_generations < settings_.max_idle_generations && !budget_exceeded();
+       ++generation) {
+    bool improved = false;
+    for (size_t i = 0; i < population_size; ++i) {
+      Tour child = crossover(selectTournament(population),
+                             selectTournament(population));
+      if (probability(generator_) < settings_.mutation_probability) {
+        mutate(&child);
+      }
+      improve(&child);
+
+      // Replace worst tour. Keep population diverse by rejecting duplicate
+      // costs.
+      std::vector<Tour>::iterator worst = std::max_element(
+          population.begin(), population.end(), cost_compare);
+      const bool is_duplicate =
+          std::any_of(population.begin(), population.end(),
+                      [&child](const Tour& t) { return t.cost == child.cost; });
+      if (child.cost < worst->cost && !is_duplicate) {
+        *worst = child;
+      }
+      if (child.cost < best.cost) {
+        best = child;
+        improved = true;
+      }
+    }
+    idle_generations = improved ? 0 : idle_generations + 1;
+  }
+
+  *solution = best.nodes;
+  cost_ = best.cost;
+  m_ = nullptr;
+  clusters_ = nullptr;
+  return true;
+}
+
+bool MemeticSolver::checkTask(const Task& task) const {
+  if (task.m.empty()) {
+    ROS_ERROR_STREAM("Distance matrix needs to be square and non-empty.");
+    return false;
+  }
+  if (task.clusters.empty()) {
+    ROS_ERROR_STREAM("No clusters.");
+    return false;
+  }
+  for (const std::vector<int>& cluster : task.clusters) {
+    if (cluster.empty()) {
+      ROS_ERROR_STREAM("Empty cluster.");
+      return false;
+    }
+    for (int node : cluster) {
+      if (node < 0 || static_cast<size_t>(node) >= task.m.size()) {
+        ROS_ERROR_STREAM("Cluster node " << node << " is not in matrix.");
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+int64_t MemeticSolver::computeCost(const std::vector<int>& nodes) const {
+  int64_t cost = 0;
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    cost += distance(nodes[i], nodes[(i + 1) % nodes.size()]);
+  }
+  return cost;
+}
+
+void MemeticSolver::optimizeClusters(Tour* tour) const {
+  ROS_ASSERT(tour);
+  const size_t n = tour->clusters.size();
+  ROS_ASSERT(n > 0);
+
+  // Start the cyclic tour at the smallest cluster.
+  std::vector<size_t>::iterator first = std::min_element(
+      tour->clusters.begin(), tour->clusters.end(),
+      [this](size_t a, size_t b) {
+        return (*clusters_)[a].size() < (*clusters_)[b].size();
+      });
+  std::rotate(tour->clusters.begin(), first, tour->clusters.end());
+
+  // Layered shortest path for every start node.
+  const int64_t kInfinity = std::numeric_limits<int64_t>::max();
+  int64_t best_cost = kInfinity;
+  std::vector<int> best_nodes;
+  std::vector<std::vector<size_t>> parents(n);
+  std::vector<int64_t> previous_cost, current_cost;
+  for (int start : (*clusters_)[tour->clusters.front()]) {
+    const std::vector<int> start_layer = {start};
+    previous_cost = {0};
+    for (size_t l = 1; l < n; ++l) {
+      const std::vector<int>& previous_layer =
+          l == 1 ? start_layer : (*clusters_)[tour->clusters[l - 1]];
+      const std::vector<int>& layer = (*clusters_)[tour->clusters[l]];
+      current_cost.assign(layer.size(), kInfinity);
+      parents[l].assign(layer.size(), 0);
+      for (size_t j = 0; j < layer.size(); ++j) {
+        for (size_t i = 0; i < previous_layer.size(); ++i) {
+          const int64_t cost =
+              previous_cost[i] + distance(previous_layer[i], layer[j]);
+          if (cost < current_cost[j]) {
+            current_cost[j] = cost;
+            parents[l][j] = i;
+          }
+        }
+      }
+      std::swap(previous_cost, current_cost);
+    }
+
+    // Close the tour.
+    const std::vector<int>& last_layer =
+        n == 1 ? start_layer : (*clusters_)[tour->clusters.back()];
+    for (size_t j = 0; j < last_layer.size(); ++j) {
+      const int64_t cost = previous_cost[j] + distance(last_layer[j], start);
+      if (cost < best_cost) {
+        best_cost = cost;
+        best_nodes.resize(n);
+        size_t idx = j;
+        for (size_t l = n - 1; l > 0; --l) {
+          best_nodes[l] = (*clusters_)[tour->clusters[l]][idx];
+          idx = parents[l][idx];
+        }
+        best_nodes[0] = start;
+      }
+    }
+  }
+
+  tour->nodes = best_nodes;
+  tour->cost = best_cost;
+}
+
+bool MemeticSolver::improveInsertion(Tour* tour) const {
+  ROS_ASSERT(tour);
+  const size_t n = tour->clusters.size();
+  if (n < 3) {
+    return false;  // All cyclic orders are equivalent.
+  }
+
+  bool improved = false;
+  for (size_t i = 0; i < n; ++i) {
+    // Remove cluster i.
+    const int v = tour->nodes[i];
+    const int prev = tour->nodes[(i + n - 1) % n];
+    const int next = tour->nodes[(i + 1) % n];
+    const int64_t removal_gain =
+        distance(prev, v) + distance(v, next) - distance(prev, next);
+    const size_t cluster = tour->clusters[i];
+    tour->clusters.erase(tour->clusters.begin() + i);
+    tour->nodes.erase(tour->nodes.begin() + i);
+
+    // Find best reinsertion, defaults to original position.
+    int64_t best_delta = removal_gain;
+    size_t best_pos = i;
+    int best_node = v;
+    for (size_t pos = 0; pos < n - 1; ++pos) {
+      const int a = tour->nodes[pos];
+      const int b = tour->nodes[(pos + 1) % (n - 1)];
+      const int64_t d_ab = distance(a, b);
+      for (int w : (*clusters_)[cluster]) {
+        const int64_t delta = distance(a, w) + distance(w, b) - d_ab;
+        if (delta < best_delta) {
+          best_delta = delta;
+          best_pos = pos + 1;
+          best_node = w;
+        }
+      }
+    }
+
+    tour->clusters.insert(tour->clusters.begin() + best_pos, cluster);
+    tour->nodes.insert(tour->nodes.begin() + best_pos, best_node);
+    if (best_delta < removal_gain) {
+      tour->cost += best_delta - removal_gain;
+      improved = true;
+    }
+  }
+
+  return improved;
+}
+
+void MemeticSolver::improve(Tour* tour) const {
+  ROS_ASSERT(tour);
+  optimizeClusters(tour);
+  while (true) {
+    const bool improved_insertion = improveInsertion(tour);
+    const int64_t cost = tour->cost;
+    optimizeClusters(tour);
+    if (!improved_insertion && tour->cost >= cost) {
+      break;
+    }
+  }
+}
+
+MemeticSolver::Tour MemeticSolver::createRandomTour() {
+  Tour tour;
+  tour.clusters.resize(clusters_->size());
+  std::iota(tour.clusters.begin(), tour.clusters.end(), 0);
+  std::shuffle(tour.clusters.begin(), tour.clusters.end(), generator_);
+  improve(&tour);
+  return tour;
+}
+
+MemeticSolver::Tour MemeticSolver::crossover(const Tour& a, const Tour& b) {
+  const size_t n = a.clusters.size();
+  ROS_ASSERT(b.clusters.size() == n);
+
+  // Ordered crossover: Copy a segment of a and fill the remaining clusters in
+  // the order of b.
+  std::uniform_int_distribution<size_t> position(0, n - 1);
+  size_t begin = position(generator_);
+  size_t end = position(generator_);
+  if (begin > end) {
+    std::swap(begin, end);
+  }
+
+  Tour child;
+  std::vector<bool> is_copied(clusters_->size(), false);
+  for (size_t i = begin; i <= end; ++i) {
+    child.clusters.push_back(a.clusters[i]);
+    is_copied[a.clusters[i]] = true;
+  }
+  for (size_t i = 0; i < n; ++i) {
+    const size_t cluster = b.clusters[(end + 1 + i) % n];
+    if (!is_copied[cluster]) {
+      child.clusters.push_back(cluster);
+    }
+  }
+  return child;
+}
+
+void MemeticSolver::mutate(Tour* tour) {
+  ROS_ASSERT(tour);
+  // Reverse a random segment.
+  const size_t n = tour->clusters.size();
+  std::uniform_int_distribution<size_t> position(0, n - 1);
+  size_t begin = position(generator_);
+  size_t end = position(generator_);
+  if (begin > end) {
+    std::swap(begin, end);
+  }
+  std::reverse(tour->clusters.begin() + begin,
+               tour->clusters.begin() + end + 1);
+}
+
+const MemeticSolver::Tour& MemeticSolver::selectTournament(
+    const std::vector<Tour>& population) {
+  std::uniform_int_distribution<size_t> index(0, population.size() - 1);
+  const Tour& a = population[index(generator_)];
+  const Tour& b = population[index(generator_)];
+  return a.cost < b.cost ? a : b;
+}
+
+}  // namespace gtsp
+}  // namespace polygon_coverage_planning
@@ -0,0 +1,109 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "polygon_coverage_solvers/multi_start_solver.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <ros/assert.h>
+#include <ros/console.h>
+
+namespace polygon_coverage_planning {
+namespace gtsp {
+
+bool MultiStartSolver::solve(const Task& task, std::vector<int>* solution) {
+  ROS_ASSERT(solution);
+  solution->clear();
+  if (!factory_) {
+    ROS_ERROR_STREAM("No solver factory set.");
+    return false;
+  }
+
+  const size_t num_starts = std::max<size_t>(settings_.num_starts, 1);
+  size_t num_threads = settings_.num_threads;
+  if (num_threads == 0) {
+    num_threads =
+        std::max<unsigned int>(std::thread::hardware_concurrency(), 1);
+  }
+  num_threads = std::min(num_threads, num_starts);
+
+  const std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  auto remaining_budget = [this, &start]() {
+    if (settings_.time_budget <= 0.0) {
+      return -1.0;
+    }
+    return settings_.time_budget -
+           std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+               .count();
+  };
+
+  // Every worker pulls the next start index until all runs are done or the
+  // budget is exceeded.
+  struct Run {
+    bool success = false;
+    std::vector<int> tour;
+  };
+  std::vector<Run> runs(num_starts);
+  std::atomic<size_t> next_start(0);
+  auto work = [&]() {
+    for (size_t i = next_start++; i < num_starts; i = next_start++) {
+      const double budget = remaining_budget();
+      if (i > 0 && settings_.time_budget > 0.0 && budget <= 0.0) {
+        break;
+      }
+      std::unique_ptr<SolverBase> solver = factory_(i, budget);
+      runs[i].success = solver && solver->solve(task, &runs[i].tour);
+    }
+  };
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads - 1);
+  for (size_t i = 1; i < num_threads; ++i) {
+    threads.emplace_back(work);
+  }
+  work();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  // Best-of selection.
+  bool found = false;
+  for (size_t i = 0; i < num_starts; ++i) {
+    if (!runs[i].success) {
+      continue;
+    }
+    const int64_t cost = computeCost(task.m, runs[i].tour);
+    if (!found || cost < cost_) {
+      found = true;
+      cost_ = cost;
+      *solution = runs[i].tour;
+    }
+  }
+  if (!found) {
+    ROS_ERROR_STREAM("All " << num_starts << " GTSP runs failed.");
+  }
+  return found;
+}
+
+}  // namespace gtsp
+}  // namespace polygon_coverage_planning
@@ -0,0 +1,101 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "polygon_coverage_solvers/bitmask_lattice.h"
+#include "polygon_coverage_solvers/boolean_lattice.h"
+#include "polygon_coverage_solvers/graph_search.h"
+
+using namespace polygon_coverage_planning;
+using namespace boolean_lattice;
+
+TEST(BooleanLatticeTest, BitmaskEdges) {
+  const size_t kNumClusters = 5;
+  BooleanLattice lattice(kNumClusters);
+  BitmaskLattice bitmask_lattice(kNumClusters);
+  EXPECT_TRUE(lattice.isInitialized());
+  EXPECT_TRUE(bitmask_lattice.isInitialized());
+  EXPECT_EQ(lattice.size(), bitmask_lattice.size());
+
+  // Both lattices have the same edges between equal cluster sets.
+  size_t num_edges = 0;
+  for (size_t from = 0; from < bitmask_lattice.size(); ++from) {
+    bitmask_lattice.forEachSuccessor(from, [&](size_t to, size_t cluster) {
+      EXPECT_TRUE(bitmask_lattice.edgeExists(EdgeId(from, to)));
+      EXPECT_FALSE(bitmask_lattice.edgeExists(EdgeId(to, from)));
+      EXPECT_TRUE(bitmask_lattice.includesCluster(to, cluster));
+      EXPECT_FALSE(bitmask_lattice.includesCluster(from, cluster));
+      num_edges++;
+    });
+  }
+  EXPECT_EQ(lattice.getNumberOfEdges(), num_edges);
+
+  for (size_t from = 0; from < lattice.size(); ++from) {
+    for (size_t to = 0; to < lattice.size(); ++to) {
+      const std::set<size_t>& from_set =
+          lattice.getNodeProperty(from)->visited_clusters;
+      const std::set<size_t>& to_set =
+          lattice.getNodeProperty(to)->visited_clusters;
+      size_t from_mask = 0, to_mask = 0;
+      for (size_t c : from_set) {
+        from_mask |= BitmaskLattice::clusterToBitmask(c);
+      }
+      for (size_t c : to_set) {
+        to_mask |= BitmaskLattice::clusterToBitmask(c);
+      }
+      EXPECT_EQ(from_set, bitmask_lattice.getVisitedClusters(from_mask));
+      EXPECT_EQ(lattice.edgeExists(EdgeId(from, to)),
+                bitmask_lattice.edgeExists(EdgeId(from_mask, to_mask)));
+    }
+  }
+}
+
+TEST(BooleanLatticeTest, BitmaskStartGoal) {
+  const size_t kNumClusters = 4;
+  BitmaskLattice lattice(kNumClusters);
+  EXPECT_TRUE(lattice.addStartNode());
+  EXPECT_TRUE(lattice.addGoalNode());
+  EXPECT_EQ(kNumClusters, lattice.getStartCluster());
+  EXPECT_EQ(kNumClusters + 1, lattice.getGoalCluster());
+  EXPECT_EQ(std::exp2(kNumClusters + 2), lattice.size());
+
+  // Every cluster is added once.
+  Solution solution;
+  EXPECT_TRUE(searchDijkstra(
+      lattice.size(), lattice.getStartIdx(), lattice.getGoalIdx(),
+      [&lattice](size_t current, auto relax) {
+        lattice.forEachSuccessor(
+            current, [&relax](size_t n, size_t) { relax(n, 0.0); });
+        return true;
+      },
+      &solution));
+  EXPECT_EQ(kNumClusters + 3, solution.size());
+
+  // Too many clusters.
+  BitmaskLattice large_lattice(kMaxBitmaskClusters);
+  EXPECT_TRUE(large_lattice.isInitialized());
+  EXPECT_FALSE(large_lattice.addStartNode());
+  EXPECT_FALSE(BitmaskLattice(kMaxBitmaskClusters + 1).isInitialized());
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -54,6 +54,43 @@ TEST(MathTest, KElementsFromNTest) {
   }
 }
 
+TEST(MathTest, KSubsetsTest) {
+  EXPECT_EQ(nChooseK(10, 4), binomial(10, 4));
+  EXPECT_EQ(1u, binomial(64, 64));
+  EXPECT_EQ(0u, binomial(3, 4));
+
+  const size_t kN = 8;
+  for (size_t k = 0; k <= kN; ++k) {
+    uint64_t num_subsets = 0;
+    uint64_t previous = 0;
+    for (KSubsets::Iterator it = KSubsets(kN, k).begin();
+         it != KSubsets(kN, k).end(); ++it) {
+      const uint64_t subset = *it;
+      EXPECT_EQ(k, static_cast<size_t>(__builtin_popcountll(subset)));
+      EXPECT_LT(subset, static_cast<uint64_t>(1) << kN);
+      // Colexicographic order is ascending as integers.
+      if (num_subsets > 0) {
+        EXPECT_GT(subset, previous);
+      }
+      EXPECT_EQ(num_subsets, it.rank());
+      EXPECT_EQ(num_subsets, rankSubset(subset));
+      EXPECT_EQ(subset, unrankSubset(num_subsets, k));
+      previous = subset;
+      num_subsets++;
+    }
+    EXPECT_EQ(binomial(kN, k), num_subsets);
+  }
+
+  // The last subset of 64 elements does not overflow.
+  size_t num_subsets = 0;
+  for (uint64_t subset : KSubsets(64, 63)) {
+    EXPECT_EQ(63, __builtin_popcountll(subset));
+    num_subsets++;
+  }
+  EXPECT_EQ(64u, num_subsets);
+  EXPECT_EQ(~static_cast<uint64_t>(0), *KSubsets(64, 64).begin());
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
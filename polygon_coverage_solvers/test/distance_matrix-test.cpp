@@ -0,0 +1,70 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+#include "polygon_coverage_solvers/boolean_lattice.h"
+#include "polygon_coverage_solvers/distance_matrix.h"
+
+using namespace polygon_coverage_planning;
+
+TEST(DistanceMatrixTest, Rows) {
+  const std::vector<std::vector<int>> rows = {{0, 1, 2}, {3, 4, 5}, {6, 7, 8}};
+  DistanceMatrix<int> m;
+  EXPECT_TRUE(DistanceMatrix<int>::fromRows(rows, &m));
+  EXPECT_EQ(3, m.size());
+  EXPECT_EQ(5, m(1, 2));
+  EXPECT_EQ(7, m.row(2)[1]);
+  EXPECT_EQ(8, m.data()[8]);
+  EXPECT_EQ(rows, m.toRows());
+  EXPECT_FALSE(m.isSymmetric());
+
+  EXPECT_FALSE(DistanceMatrix<int>::fromRows({{0, 1}}, &m));
+  EXPECT_TRUE(m.empty());
+
+  DistanceMatrix<uint16_t> symmetric(2);
+  EXPECT_EQ(DistanceMatrix<uint16_t>::kNoConnection, symmetric(0, 1));
+  symmetric(0, 1) = symmetric(1, 0) = 3;
+  EXPECT_TRUE(symmetric.isSymmetric());
+}
+
+TEST(DistanceMatrixTest, Graph) {
+  boolean_lattice::BooleanLattice lattice(3);
+  const std::vector<std::vector<int>> adjacency = lattice.getAdjacencyMatrix();
+
+  DistanceMatrix<int> m;
+  EXPECT_TRUE(lattice.getDistanceMatrix(&m));
+  EXPECT_EQ(adjacency, m.toRows());
+
+  DistanceMatrix<uint16_t> m_16;
+  EXPECT_TRUE(lattice.getDistanceMatrix(&m_16));
+  for (size_t i = 0; i < m.size(); ++i) {
+    for (size_t j = 0; j < m.size(); ++j) {
+      EXPECT_EQ(lattice.edgeExists(EdgeId(i, j)),
+                m_16(i, j) != DistanceMatrix<uint16_t>::kNoConnection);
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
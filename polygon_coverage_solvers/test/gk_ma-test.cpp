@@ -25,6 +25,8 @@
 #include <ros/package.h>
 
 #include "polygon_coverage_solvers/gk_ma.h"
+#include "polygon_coverage_solvers/gk_ma_pool.h"
+#include "polygon_coverage_solvers/parallel.h"
 
 using namespace polygon_coverage_planning;
 using namespace gk_ma;
@@ -89,6 +91,58 @@ TEST(GkMa, LoadFromTask) {
   EXPECT_EQ(solution.size(), clusters.size());
 }
 
+TEST(GkMa, SharedTask) {
+  std::vector<std::vector<int>> m = {{0, 1, 2}, {3, 0, 4}, {5, 6, 0}};
+  std::vector<std::vector<int>> clusters = {{0}, {1, 2}};
+  Task task(m, clusters);
+
+  std::vector<int32_t> data(getSharedTaskSize(task) / sizeof(int32_t));
+  writeSharedTask(task, data.data());
+  Task shared_task{DistanceMatrix<int>(), {}};
+  EXPECT_TRUE(readSharedTask(data.data(), data.size() * sizeof(int32_t),
+                             &shared_task));
+  EXPECT_EQ(m, shared_task.m.toRows());
+  EXPECT_EQ(clusters, shared_task.clusters);
+  EXPECT_FALSE(readSharedTask(data.data(), data.size() * sizeof(int32_t) - 1,
+                              &shared_task));
+
+  std::vector<int> solution;
+  writeSharedSolution({0, 2}, data.data());
+  EXPECT_TRUE(readSharedSolution(data.data(), data.size() * sizeof(int32_t),
+                                 &solution));
+  EXPECT_EQ(std::vector<int>({0, 2}), solution);
+}
+
+TEST(GkMa, WorkerPool) {
+  std::srand(123456);
+
+  std::vector<std::vector<int>> m(10, std::vector<int>(10));
+  for (size_t i = 0; i < m.size(); ++i) {
+    for (size_t j = 0; j < m[i].size(); ++j) {
+      if (i == j) {
+        m[i][j] = std::numeric_limits<int>::max();
+      } else {
+        m[i][j] = rand() % 100;
+      }
+    }
+  }
+  std::vector<std::vector<int>> clusters = {{0}, {1, 2, 3, 4, 5}, {6, 7, 8},
+                                            {9}};
+  const Task task(m, clusters);
+
+  // Concurrent solves run in separate worker processes.
+  GkMaWorkerPool::getInstance().setMaxWorkers(2);
+  std::vector<std::vector<int>> solutions(4);
+  EXPECT_TRUE(parallelFor(solutions.size(), 2, [&](size_t i) {
+    GkMaPoolSolver solver;
+    return solver.solve(task, &solutions[i]);
+  }));
+  EXPECT_GE(2u, GkMaWorkerPool::getInstance().getNumWorkers());
+  for (const std::vector<int>& solution : solutions) {
+    EXPECT_EQ(clusters.size(), solution.size());
+  }
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,153 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include "polygon_coverage_solvers/graph_overlay.h"
+
+using namespace polygon_coverage_planning;
+
+// A chain 0 -> 1 -> ... -> n-1 with unit cost. The node property is the id.
+class ChainGraph : public GraphBase<size_t, int> {
+ public:
+  ChainGraph(size_t num_nodes) : GraphBase(), num_nodes_(num_nodes) {
+    is_created_ = create();
+  }
+  virtual bool create() override {
+    clear();
+    for (size_t i = 0; i < num_nodes_; ++i) {
+      if (!addNode(i)) return false;
+    }
+    return compact();
+  }
+
+ private:
+  virtual bool addEdges() override {
+    const size_t new_id = graph_.size() - 1;
+    return new_id == 0 || addEdge(EdgeId(new_id - 1, new_id), 0, 1.0);
+  }
+
+  size_t num_nodes_;
+};
+
+TEST(GraphOverlayTest, StartAndGoal) {
+  const ChainGraph base(3);
+  ASSERT_TRUE(base.isInitialized());
+
+  GraphOverlay<size_t, int> overlay(&base);
+  const size_t start = overlay.addStartNode(10);
+  const size_t goal = overlay.addGoalNode(11);
+  EXPECT_EQ(3, start);
+  EXPECT_EQ(4, goal);
+  EXPECT_EQ(5, overlay.size());
+  EXPECT_TRUE(overlay.addEdge(EdgeId(start, 0), 1, 2.0));
+  EXPECT_TRUE(overlay.addEdge(EdgeId(start, 1), 2, 5.0));
+  EXPECT_TRUE(overlay.addEdge(EdgeId(2, goal), 3, 1.0));
+  // Base edges cannot be modified.
+  EXPECT_FALSE(overlay.addEdge(EdgeId(0, 2), 4, 1.0));
+  EXPECT_FALSE(overlay.addEdge(EdgeId(start, 5), 4, 1.0));
+
+  // Lookups fall through to the base graph.
+  EXPECT_EQ(10, *overlay.getNodeProperty(start));
+  EXPECT_EQ(1, *overlay.getNodeProperty(1));
+  EXPECT_EQ(nullptr, overlay.getNodeProperty(5));
+  EXPECT_TRUE(overlay.edgeExists(EdgeId(0, 1)));
+  EXPECT_FALSE(overlay.edgeExists(EdgeId(0, 2)));
+  EXPECT_EQ(3, *overlay.getEdgeProperty(EdgeId(2, goal)));
+  double cost = -1.0;
+  EXPECT_TRUE(overlay.getEdgeCost(EdgeId(start, 1), &cost));
+  EXPECT_EQ(5.0, cost);
+  EXPECT_FALSE(overlay.getEdgeCost(EdgeId(goal, start), &cost));
+
+  // Base node 2 has no base neighbors but the overlay goal.
+  std::vector<size_t> neighbors;
+  overlay.forEachNeighbor(2, [&neighbors](size_t n, double) {
+    neighbors.push_back(n);
+    return true;
+  });
+  EXPECT_EQ(std::vector<size_t>({goal}), neighbors);
+
+  Solution solution;
+  EXPECT_TRUE(overlay.solveDijkstra(start, goal, &solution));
+  EXPECT_EQ(Solution({start, 0, 1, 2, goal}), solution);
+
+  DistanceMatrix<int> m;
+  EXPECT_TRUE(overlay.getDistanceMatrix(&m));
+  EXPECT_EQ(5, m.size());
+  EXPECT_EQ(2000, m(start, 0));
+  EXPECT_EQ(1000, m(0, 1));
+  EXPECT_EQ(DistanceMatrix<int>::kNoConnection, m(0, goal));
+
+  // Reusing the base matrix gives the same matrix.
+  DistanceMatrix<int> base_m, m_from_base;
+  EXPECT_TRUE(base.getDistanceMatrix(&base_m));
+  EXPECT_TRUE(overlay.getDistanceMatrix(base_m, &m_from_base));
+  EXPECT_EQ(m.toRows(), m_from_base.toRows());
+  EXPECT_FALSE(overlay.getDistanceMatrix(DistanceMatrix<int>(2), &m_from_base));
+
+  // The base graph is untouched.
+  EXPECT_EQ(3, base.size());
+  EXPECT_EQ(2, base.getNumberOfEdges());
+
+  overlay.reset(&base);
+  EXPECT_EQ(3, overlay.size());
+  EXPECT_EQ(0, overlay.getNumberOfOverlayEdges());
+}
+
+// A property that counts its copies.
+struct CopyCounted {
+  CopyCounted() : value(0) {}
+  explicit CopyCounted(int value) : value(value) {}
+  CopyCounted(const CopyCounted& other) : value(other.value) { ++copies; }
+  CopyCounted(CopyCounted&& other) noexcept = default;
+  CopyCounted& operator=(const CopyCounted& other) {
+    value = other.value;
+    ++copies;
+    return *this;
+  }
+  CopyCounted& operator=(CopyCounted&& other) noexcept = default;
+
+  int value;
+  static int copies;
+};
+int CopyCounted::copies = 0;
+
+TEST(GraphOverlayTest, MovesProperties) {
+  GraphOverlay<CopyCounted, CopyCounted> overlay;
+  CopyCounted::copies = 0;
+  CopyCounted start_property(1);
+  const size_t start = overlay.addStartNode(std::move(start_property));
+  const size_t goal = overlay.addGoalNode(CopyCounted(2));
+  EXPECT_TRUE(overlay.addEdge(EdgeId(start, goal), CopyCounted(3), 1.0));
+  EXPECT_EQ(0, CopyCounted::copies);
+  EXPECT_EQ(1, overlay.getNodeProperty(start)->value);
+  EXPECT_EQ(3, overlay.getEdgeProperty(EdgeId(start, goal))->value);
+
+  // Lvalues are still copied.
+  const CopyCounted node_property(4);
+  overlay.addNode(node_property);
+  EXPECT_EQ(1, CopyCounted::copies);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
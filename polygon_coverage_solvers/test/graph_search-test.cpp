@@ -0,0 +1,141 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "polygon_coverage_solvers/boolean_lattice.h"
+#include "polygon_coverage_solvers/graph_search.h"
+
+using namespace polygon_coverage_planning;
+
+TEST(GraphSearchTest, IndexedMinHeap) {
+  IndexedMinHeap heap(5);
+  EXPECT_TRUE(heap.empty());
+  heap.push(3, 3.0);
+  heap.push(1, 1.0);
+  heap.push(4, 4.0);
+  heap.push(0, 5.0);
+  EXPECT_EQ(4, heap.size());
+  EXPECT_TRUE(heap.contains(0));
+  EXPECT_FALSE(heap.contains(2));
+
+  // Decrease key.
+  heap.push(0, 0.5);
+  // Increasing the key is ignored.
+  heap.push(1, 10.0);
+  EXPECT_EQ(4, heap.size());
+
+  EXPECT_EQ(0, heap.pop());
+  EXPECT_EQ(1, heap.pop());
+  EXPECT_EQ(3, heap.pop());
+  EXPECT_EQ(4, heap.pop());
+  EXPECT_TRUE(heap.empty());
+  EXPECT_FALSE(heap.contains(0));
+}
+
+TEST(GraphSearchTest, Dijkstra) {
+  // 0 -> 1 -> 3 is cheaper than 0 -> 2 -> 3, 4 is disconnected.
+  const std::vector<std::vector<std::pair<size_t, double>>> adj = {
+      {{1, 1.0}, {2, 1.0}}, {{3, 1.0}}, {{3, 2.0}}, {}, {}};
+  auto expand = [&adj](size_t current, auto relax) {
+    for (const std::pair<size_t, double>& n : adj[current]) {
+      relax(n.first, n.second);
+    }
+    return true;
+  };
+
+  Solution solution;
+  EXPECT_TRUE(searchDijkstra(adj.size(), 0, 3, expand, &solution));
+  EXPECT_EQ(Solution({0, 1, 3}), solution);
+
+  EXPECT_FALSE(searchDijkstra(adj.size(), 0, 4, expand, &solution));
+  EXPECT_TRUE(solution.empty());
+
+  // Aborting the search.
+  EXPECT_FALSE(searchDijkstra(adj.size(), 0, 3,
+                              [](size_t, auto) { return false; }, &solution));
+}
+
+TEST(GraphSearchTest, SearchWorkspace) {
+  const std::vector<std::vector<std::pair<size_t, double>>> adj = {
+      {{1, 1.0}, {2, 1.0}}, {{3, 1.0}}, {{3, 2.0}}, {}, {}};
+  auto expand = [&adj](size_t current, auto relax) {
+    for (const std::pair<size_t, double>& n : adj[current]) {
+      relax(n.first, n.second);
+    }
+    return true;
+  };
+
+  // Reused workspaces are reset between searches, also between graph sizes.
+  SearchWorkspace workspace;
+  Solution solution;
+  EXPECT_TRUE(searchDijkstra(adj.size(), 0, 3, expand, &solution, &workspace));
+  EXPECT_EQ(Solution({0, 1, 3}), solution);
+  EXPECT_TRUE(searchDijkstra(adj.size(), 2, 3, expand, &solution, &workspace));
+  EXPECT_EQ(Solution({2, 3}), solution);
+  EXPECT_FALSE(searchDijkstra(adj.size(), 0, 4, expand, &solution, &workspace));
+  EXPECT_TRUE(searchDijkstra(4, 0, 3, expand, &solution, &workspace));
+  EXPECT_EQ(Solution({0, 1, 3}), solution);
+
+  std::vector<double> cost;
+  std::vector<size_t> came_from;
+  EXPECT_TRUE(searchShortestPathTree(adj.size(), 0, expand, &cost, &came_from,
+                                     &workspace));
+  EXPECT_DOUBLE_EQ(2.0, cost[3]);
+  EXPECT_EQ(1, came_from[3]);
+}
+
+TEST(GraphSearchTest, ShortestPathTree) {
+  const std::vector<std::vector<std::pair<size_t, double>>> adj = {
+      {{1, 1.0}, {2, 1.0}}, {{3, 1.0}}, {{3, 2.0}}, {}, {}};
+  auto expand = [&adj](size_t current, auto relax) {
+    for (const std::pair<size_t, double>& n : adj[current]) {
+      relax(n.first, n.second);
+    }
+    return true;
+  };
+
+  std::vector<double> cost;
+  std::vector<size_t> came_from;
+  EXPECT_TRUE(searchShortestPathTree(adj.size(), 0, expand, &cost, &came_from));
+  EXPECT_EQ(std::vector<double>({0.0, 1.0, 1.0, 2.0,
+                                 std::numeric_limits<double>::infinity()}),
+            cost);
+  EXPECT_EQ(std::vector<size_t>({kNoParent, 0, 0, 1, kNoParent}), came_from);
+}
+
+TEST(GraphSearchTest, BooleanLattice) {
+  const size_t kNumClusters = 4;
+  boolean_lattice::BooleanLattice lattice(kNumClusters);
+  EXPECT_TRUE(lattice.isInitialized());
+  EXPECT_TRUE(lattice.addStartNode());
+  EXPECT_TRUE(lattice.addGoalNode());
+
+  // Start, empty set, one node per cluster and goal.
+  Solution solution;
+  EXPECT_TRUE(lattice.solveDijkstra(&solution));
+  EXPECT_EQ(kNumClusters + 3, solution.size());
+  EXPECT_EQ(lattice.getStartIdx(), solution.front());
+  EXPECT_EQ(lattice.getGoalIdx(), solution.back());
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,189 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "polygon_coverage_solvers/held_karp.h"
+
+using namespace polygon_coverage_planning;
+using namespace held_karp;
+
+const double kNear = 1e-9;
+
+// Random asymmetric instance. Node 0 is the start, node 1 the goal and the
+// remaining nodes are distributed over num_clusters clusters.
+void createRandomInstance(size_t num_nodes, size_t num_clusters,
+                          std::mt19937* generator, DistanceMatrix<double>* m,
+                          std::vector<std::vector<int>>* clusters) {
+  std::uniform_real_distribution<double> cost(0.0, 100.0);
+  *m = DistanceMatrix<double>(num_nodes);
+  for (size_t i = 0; i < num_nodes; ++i) {
+    for (size_t j = 0; j < num_nodes; ++j) {
+      if (i != j) {
+        (*m)(i, j) = cost(*generator);
+      }
+    }
+  }
+  clusters->assign(num_clusters, std::vector<int>());
+  for (size_t i = 2; i < num_nodes; ++i) {
+    (*clusters)[i % num_clusters].push_back(static_cast<int>(i));
+  }
+}
+
+// Enumerate all cluster orders and node selections.
+double solveBruteForce(const DistanceMatrix<double>& m,
+                       const std::vector<std::vector<int>>& clusters) {
+  std::vector<size_t> order(clusters.size());
+  std::iota(order.begin(), order.end(), 0);
+  double best = std::numeric_limits<double>::max();
+  do {
+    std::vector<size_t> selection(order.size(), 0);
+    while (true) {
+      double cost = 0.0;
+      size_t from = 0;
+      for (size_t i = 0; i < order.size(); ++i) {
+        const size_t to = clusters[order[i]][selection[i]];
+        cost += m(from, to);
+        from = to;
+      }
+      best = std::min(best, cost + m(from, 1));
+      size_t k = 0;
+      while (k < order.size() && ++selection[k] == clusters[order[k]].size()) {
+        selection[k++] = 0;
+      }
+      if (k == order.size()) break;
+    }
+  } while (std::next_permutation(order.begin(), order.end()));
+  return best;
+}
+
+TEST(HeldKarpTest, Optimality) {
+  std::mt19937 generator(42);
+  HeldKarp solver;
+  for (size_t i = 0; i < 20; ++i) {
+    const size_t num_clusters = 1 + i % 5;
+    DistanceMatrix<double> m;
+    std::vector<std::vector<int>> clusters;
+    createRandomInstance(2 + 3 * num_clusters, num_clusters, &generator, &m,
+                         &clusters);
+
+    Solution solution;
+    ASSERT_TRUE(solver.solve(m, clusters, 0, 1, &solution));
+    ASSERT_EQ(num_clusters + 2, solution.size());
+    EXPECT_EQ(0u, solution.front());
+    EXPECT_EQ(1u, solution.back());
+
+    // One node per cluster.
+    double cost = 0.0;
+    std::vector<bool> visited(num_clusters, false);
+    for (size_t j = 1; j + 1 < solution.size(); ++j) {
+      for (size_t c = 0; c < num_clusters; ++c) {
+        if (std::count(clusters[c].begin(), clusters[c].end(), solution[j])) {
+          EXPECT_FALSE(visited[c]);
+          visited[c] = true;
+        }
+      }
+    }
+    for (size_t j = 0; j + 1 < solution.size(); ++j) {
+      cost += m(solution[j], solution[j + 1]);
+    }
+    EXPECT_EQ(std::vector<bool>(num_clusters, true), visited);
+    EXPECT_NEAR(cost, solver.getCost(), kNear);
+    EXPECT_NEAR(solveBruteForce(m, clusters), solver.getCost(), kNear);
+  }
+}
+
+TEST(HeldKarpTest, Connectivity) {
+  DistanceMatrix<double> m(4);
+  m(0, 2) = 1.0;
+  m(2, 3) = 1.0;
+  m(3, 1) = 1.0;
+  HeldKarp solver;
+  Solution solution;
+  EXPECT_TRUE(solver.solve(m, {{2}, {3}}, 0, 1, &solution));
+  EXPECT_EQ(Solution({0, 2, 3, 1}), solution);
+  EXPECT_DOUBLE_EQ(3.0, solver.getCost());
+
+  // No path.
+  m(3, 1) = DistanceMatrix<double>::kNoConnection;
+  EXPECT_FALSE(solver.solve(m, {{2}, {3}}, 0, 1, &solution));
+
+  // No clusters.
+  EXPECT_FALSE(solver.solve(m, {}, 0, 1, &solution));
+  m(0, 1) = 5.0;
+  EXPECT_TRUE(solver.solve(m, {}, 0, 1, &solution));
+  EXPECT_EQ(Solution({0, 1}), solution);
+}
+
+TEST(HeldKarpTest, Invalid) {
+  DistanceMatrix<double> m(4, 1.0);
+  HeldKarp solver;
+  Solution solution;
+  EXPECT_FALSE(solver.solve(m, {{2}, {3}}, 0, 0, &solution));
+  EXPECT_FALSE(solver.solve(m, {{2}, {4}}, 0, 1, &solution));
+  EXPECT_FALSE(solver.solve(m, {{2}, {}}, 0, 1, &solution));
+  EXPECT_FALSE(solver.solve(m, {{0}, {3}}, 0, 1, &solution));
+
+  HeldKarp::Settings settings;
+  settings.max_table_size = 7;
+  HeldKarp small_solver(settings);
+  EXPECT_FALSE(small_solver.solve(m, {{2}, {3}}, 0, 1, &solution));
+  settings.max_table_size = 8;
+  small_solver = HeldKarp(settings);
+  EXPECT_TRUE(small_solver.solve(m, {{2}, {3}}, 0, 1, &solution));
+
+  size_t table_size = 0;
+  EXPECT_TRUE(HeldKarp::computeTableSize(3, 5, &table_size));
+  EXPECT_EQ(40u, table_size);
+  EXPECT_FALSE(HeldKarp::computeTableSize(64, 1, &table_size));
+}
+
+TEST(HeldKarpTest, Deadline) {
+  DistanceMatrix<double> m(4, 1.0);
+  HeldKarp solver;
+  Solution solution;
+  std::atomic<bool> is_cancelled(false);
+  EXPECT_TRUE(solver.solve(m, {{2}, {3}}, 0, 1, &solution,
+                           Deadline(60.0, &is_cancelled)));
+  is_cancelled = true;
+  EXPECT_FALSE(solver.solve(m, {{2}, {3}}, 0, 1, &solution,
+                            Deadline(60.0, &is_cancelled)));
+
+  // Limits keep the earlier end and the cancellation token.
+  const Deadline unlimited;
+  EXPECT_FALSE(unlimited.hasTimeLimit());
+  EXPECT_FALSE(unlimited.isExpired());
+  EXPECT_TRUE(unlimited.limit(60.0).hasTimeLimit());
+  EXPECT_GT(Deadline(60.0).limit(1.0).getRemainingSeconds(), 0.0);
+  EXPECT_LE(Deadline(1.0).limit(60.0).getRemainingSeconds(), 1.0);
+  EXPECT_TRUE(Deadline(0.0, &is_cancelled).limit(60.0).isExpired());
+  EXPECT_EQ(0.0, Deadline(60.0, &is_cancelled).getRemainingSeconds());
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
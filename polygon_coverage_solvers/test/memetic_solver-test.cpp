@@ -0,0 +1,123 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "polygon_coverage_solvers/memetic_solver.h"
+
+using namespace polygon_coverage_planning;
+using namespace gtsp;
+
+// Random asymmetric instance with num_nodes nodes in num_clusters clusters.
+Task createRandomTask(size_t num_nodes, size_t num_clusters,
+                      std::mt19937* generator) {
+  std::uniform_int_distribution<int> cost(0, 99);
+  std::vector<std::vector<int>> m(num_nodes, std::vector<int>(num_nodes));
+  for (size_t i = 0; i < m.size(); ++i) {
+    for (size_t j = 0; j < m[i].size(); ++j) {
+      m[i][j] = i == j ? std::numeric_limits<int>::max() : cost(*generator);
+    }
+  }
+  std::vector<std::vector<int>> clusters(num_clusters);
+  for (size_t i = 0; i < num_nodes; ++i) {
+    clusters[i % num_clusters].push_back(static_cast<int>(i));
+  }
+  return Task(m, clusters);
+}
+
+// Enumerate all cluster orders and node selections.
+int64_t solveBruteForce(const Task& task) {
+  std::vector<size_t> order(task.clusters.size());
+  std::iota(order.begin(), order.end(), 0);
+  int64_t best = std::numeric_limits<int64_t>::max();
+  do {
+    std::vector<size_t> selection(order.size(), 0);
+    while (true) {
+      std::vector<int> tour;
+      for (size_t i = 0; i < order.size(); ++i) {
+        tour.push_back(task.clusters[order[i]][selection[i]]);
+      }
+      best = std::min(best, computeCost(task.m, tour));
+      size_t k = 0;
+      while (k < order.size() &&
+             ++selection[k] == task.clusters[order[k]].size()) {
+        selection[k++] = 0;
+      }
+      if (k == order.size()) break;
+    }
+  } while (std::next_permutation(order.begin() + 1, order.end()));
+  return best;
+}
+
+TEST(MemeticSolverTest, Optimality) {
+  std::mt19937 generator(123456);
+  MemeticSolver solver;
+  for (size_t i = 0; i < 10; ++i) {
+    Task task = createRandomTask(12, 5, &generator);
+    std::vector<int> solution;
+    EXPECT_TRUE(solver.solve(task, &solution));
+
+    // One node per cluster.
+    ASSERT_EQ(task.clusters.size(), solution.size());
+    for (const std::vector<int>& cluster : task.clusters) {
+      EXPECT_EQ(1, std::count_if(solution.begin(), solution.end(), [&](int n) {
+                  return std::find(cluster.begin(), cluster.end(), n) !=
+                         cluster.end();
+                }));
+    }
+    EXPECT_EQ(computeCost(task.m, solution), solver.getCost());
+    EXPECT_EQ(solveBruteForce(task), solver.getCost());
+  }
+}
+
+TEST(MemeticSolverTest, Degenerate) {
+  MemeticSolver solver;
+  std::vector<int> solution;
+
+  // Single cluster.
+  Task single({{5, 1}, {1, 3}}, {{0, 1}});
+  EXPECT_TRUE(solver.solve(single, &solution));
+  EXPECT_EQ(std::vector<int>({1}), solution);
+
+  // Invalid tasks.
+  EXPECT_FALSE(solver.solve(Task({{0, 1}}, {{0}}), &solution));
+  const std::vector<std::vector<int>> m_single = {{0}};
+  EXPECT_FALSE(solver.solve(Task(m_single, {{}}), &solution));
+  EXPECT_FALSE(solver.solve(Task(m_single, {{1}}), &solution));
+}
+
+TEST(MemeticSolverTest, Deterministic) {
+  std::mt19937 generator(42);
+  Task task = createRandomTask(60, 15, &generator);
+  std::vector<int> a, b;
+  EXPECT_TRUE(MemeticSolver().solve(task, &a));
+  EXPECT_TRUE(MemeticSolver().solve(task, &b));
+  EXPECT_EQ(a, b);
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
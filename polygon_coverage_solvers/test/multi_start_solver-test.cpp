@@ -0,0 +1,121 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "polygon_coverage_solvers/memetic_solver.h"
+#include "polygon_coverage_solvers/multi_start_solver.h"
+
+using namespace polygon_coverage_planning;
+using namespace gtsp;
+
+// Random asymmetric instance with num_nodes nodes in num_clusters clusters.
+Task createRandomTask(size_t num_nodes, size_t num_clusters,
+                      std::mt19937* generator) {
+  std::uniform_int_distribution<int> cost(0, 99);
+  std::vector<std::vector<int>> m(num_nodes, std::vector<int>(num_nodes));
+  for (size_t i = 0; i < m.size(); ++i) {
+    for (size_t j = 0; j < m[i].size(); ++j) {
+      m[i][j] = i == j ? std::numeric_limits<int>::max() : cost(*generator);
+    }
+  }
+  std::vector<std::vector<int>> clusters(num_clusters);
+  for (size_t i = 0; i < num_nodes; ++i) {
+    clusters[i % num_clusters].push_back(static_cast<int>(i));
+  }
+  return Task(m, clusters);
+}
+
+std::unique_ptr<SolverBase> createMemeticSolver(size_t start, double budget) {
+  MemeticSolver::Settings settings;
+  settings.seed += static_cast<unsigned int>(start);
+  settings.time_budget = budget;
+  return std::make_unique<MemeticSolver>(settings);
+}
+
+TEST(MultiStartSolverTest, BestOf) {
+  std::mt19937 generator(42);
+  const size_t kNumStarts = 6;
+  for (size_t i = 0; i < 10; ++i) {
+    Task task = createRandomTask(40, 12, &generator);
+
+    MultiStartSolver::Settings settings;
+    settings.num_starts = kNumStarts;
+    settings.num_threads = 3;
+    MultiStartSolver solver(createMemeticSolver, settings);
+    std::vector<int> solution;
+    ASSERT_TRUE(solver.solve(task, &solution));
+    EXPECT_EQ(task.clusters.size(), solution.size());
+    EXPECT_EQ(computeCost(task.m, solution), solver.getCost());
+
+    // Never worse than any of the single runs.
+    for (size_t start = 0; start < kNumStarts; ++start) {
+      std::vector<int> single_solution;
+      ASSERT_TRUE(createMemeticSolver(start, -1.0)->solve(task,
+                                                          &single_solution));
+      EXPECT_LE(solver.getCost(), computeCost(task.m, single_solution));
+    }
+
+    // Independent of the number of threads.
+    settings.num_threads = 1;
+    MultiStartSolver sequential(createMemeticSolver, settings);
+    std::vector<int> sequential_solution;
+    ASSERT_TRUE(sequential.solve(task, &sequential_solution));
+    EXPECT_EQ(solution, sequential_solution);
+  }
+}
+
+TEST(MultiStartSolverTest, Budget) {
+  std::mt19937 generator(7);
+  Task task = createRandomTask(60, 20, &generator);
+
+  // The first run is always executed.
+  MultiStartSolver::Settings settings;
+  settings.num_starts = 100;
+  settings.num_threads = 2;
+  settings.time_budget = 1e-6;
+  MultiStartSolver solver(createMemeticSolver, settings);
+  std::vector<int> solution;
+  EXPECT_TRUE(solver.solve(task, &solution));
+  EXPECT_EQ(task.clusters.size(), solution.size());
+}
+
+TEST(MultiStartSolverTest, Failure) {
+  std::mt19937 generator(3);
+  Task task = createRandomTask(10, 3, &generator);
+  std::vector<int> solution;
+
+  MultiStartSolver no_solver(
+      [](size_t, double) { return std::unique_ptr<SolverBase>(); },
+      MultiStartSolver::Settings());
+  EXPECT_FALSE(no_solver.solve(task, &solution));
+
+  MultiStartSolver invalid_task(createMemeticSolver,
+                                MultiStartSolver::Settings());
+  EXPECT_FALSE(invalid_task.solve(Task(DistanceMatrix<int>(), {}), &solution));
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
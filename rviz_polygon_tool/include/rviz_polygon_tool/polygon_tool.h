@@ -33,6 +33,8 @@
 #include <rviz/geometry.h>
 #include <rviz/ogre_helpers/line.h>
 #include <rviz/ogre_helpers/shape.h>
+#include <rviz/properties/bool_property.h>
+#include <rviz/properties/float_property.h>
 #include <rviz/properties/vector_property.h>
 #include <rviz/render_panel.h>
 #include <rviz/tool.h>
@@ -41,6 +43,10 @@
 #include <std_msgs/Bool.h>
 #include <std_msgs/Int8.h>
 
+#include <map>
+#include <memory>
+#include <vector>
+
 namespace rviz_polygon_tool {
 
 // Declare polygon tool as subclass of rviz::Tool.
@@ -52,6 +58,8 @@ namespace rviz_polygon_tool {
 // 'r': Reset currently selected polygon
 // 'c': Clear all
 // Enter: Publish polygon if valid
+// With the 'Auto Publish' property set, edits are published as well, at most
+// once per 'Publish Period'.
 class PolygonTool : public rviz::Tool {
   Q_OBJECT
 
@@ -78,6 +86,9 @@ class PolygonTool : public rviz::Tool {
   void resetPolygon();
   void clearAll();
   void publishPolygon();
+  void schedulePublish();
+  void autoPublish();
+  void publishTimerCallback(const ros::WallTimerEvent& event);
   void updateStatus();
   void removeEmptyHoles();
   void increaseAltitude(rviz::ViewportMouseEvent& event);
@@ -89,9 +100,22 @@ class PolygonTool : public rviz::Tool {
   double altitude_;
 
   // Rendering
-  void renderPolygon(const Polygon_2& polygon, const Ogre::ColourValue& c);
+  // The OGRE objects of a single polygon. They are retained between renders
+  // and only rebuilt when the vertices of the polygon change.
+  struct PolygonVisual {
+    std::vector<Ogre::Vector3> points;
+    std::vector<std::unique_ptr<rviz::Shape>> vertices;
+    std::vector<std::unique_ptr<rviz::Line>> edges;  // Ending at vertex i.
+    Ogre::ColourValue colour;
+    int selection = -1;
+  };
+  void renderPolygon(const Polygon_2& polygon, const Ogre::ColourValue& c,
+                     int selection, PolygonVisual* visual);
   void renderPolygons();
+  void setVertexColour(size_t i, const Ogre::ColourValue& c,
+                       PolygonVisual* visual) const;
   Ogre::SceneNode* polygon_node_;
+  std::map<const Polygon_2*, PolygonVisual> visuals_;
 
   // Sphere currently displayed.
   Ogre::SceneNode* moving_vertex_node_;
@@ -100,6 +124,14 @@ class PolygonTool : public rviz::Tool {
   // ROS messaging
   ros::NodeHandle nh_;
   ros::Publisher polygon_pub_;
+  rviz::BoolProperty* auto_publish_property_;
+  rviz::FloatProperty* publish_period_property_;
+  ros::WallTimer publish_timer_;
+  bool publish_pending_;
+  ros::WallTime last_publish_time_;
+  // The last published state, to skip automatic publications without edits.
+  std::list<Polygon_2> published_polygons_;
+  double published_altitude_;
 };
 
 }  // namespace rviz_polygon_tool
@@ -19,6 +19,8 @@
 
 #include "rviz_polygon_tool/polygon_tool.h"
 
+#include <algorithm>
+
 #include <CGAL/number_utils.h>
 #include <polygon_coverage_geometry/boolean.h>
 #include <polygon_coverage_msgs/PolygonWithHolesStamped.h>
@@ -60,6 +62,9 @@ const double kNormalAltitudeDelta = 1.0;
 const double kLargeAltitudeDelta = 10.0;
 const double kDefaultAltitude = 3.0;
 
+// Automatic publishing.
+const float kDefaultPublishPeriod = 1.0;
+
 PolygonTool::PolygonTool()
     : Tool(),
       polygons_({Polygon_2()}),
@@ -68,7 +73,11 @@ PolygonTool::PolygonTool()
       altitude_(kDefaultAltitude),
       polygon_node_(nullptr),
       moving_vertex_node_(nullptr),
-      sphere_(nullptr) {
+      sphere_(nullptr),
+      auto_publish_property_(nullptr),
+      publish_period_property_(nullptr),
+      publish_pending_(false),
+      published_altitude_(kDefaultAltitude) {
   shortcut_key_ = 'p';
 }
 
@@ -88,6 +97,21 @@ void PolygonTool::onInitialize() {
   // ROS.
   polygon_pub_ = nh_.advertise<polygon_coverage_msgs::PolygonWithHolesStamped>(
       "polygon", 1, true);
+  // One-shot timer that publishes the edits of a throttled period. It is
+  // called from the rviz main thread that also handles the user input.
+  publish_timer_ = nh_.createWallTimer(ros::WallDuration(kDefaultPublishPeriod),
+                                       &PolygonTool::publishTimerCallback,
+                                       this, true, false);
+
+  // Properties.
+  auto_publish_property_ = new rviz::BoolProperty(
+      "Auto Publish", false, "Publish the polygon after every edit.",
+      getPropertyContainer());
+  publish_period_property_ = new rviz::FloatProperty(
+      "Publish Period", kDefaultPublishPeriod,
+      "Minimum time between automatic publications [s].",
+      getPropertyContainer());
+  publish_period_property_->setMin(0.0);
 }
 
 void PolygonTool::activate() {
@@ -149,6 +173,7 @@ void PolygonTool::clickLeft(const rviz::ViewportMouseEvent& event) {
   }
 
   updateStatus();
+  schedulePublish();
   renderPolygons();
 }
 
@@ -167,6 +192,7 @@ void PolygonTool::clickRight(const rviz::ViewportMouseEvent& event) {
   }
 
   updateStatus();
+  schedulePublish();
   renderPolygons();
 }
 
@@ -188,47 +214,87 @@ void PolygonTool::deleteVertex(const Ogre::Vector3& position) {
 }
 
 void PolygonTool::renderPolygon(const Polygon_2& polygon,
-                                const Ogre::ColourValue& c) {
-  // Render vertices and edges.
+                                const Ogre::ColourValue& c, int selection,
+                                PolygonVisual* visual) {
+  ROS_ASSERT(visual);
+  // Rebuild the vertices and edges only if the polygon changed.
+  std::vector<Ogre::Vector3> points;
+  points.reserve(polygon.size());
   for (auto v = polygon.vertices_begin(); v != polygon.vertices_end(); ++v) {
-    // Render vertices as spheres.
-    rviz::Shape* sphere =
-        new rviz::Shape(rviz::Shape::Sphere, scene_manager_, polygon_node_);
-    sphere->setColor(c);
-    sphere->setScale(Ogre::Vector3(kPtScale));
-    Ogre::Vector3 p(CGAL::to_double(v->x()), CGAL::to_double(v->y()),
-                    altitude_);
-    sphere->setPosition(p);
-    if (v == vertex_selection_) sphere->setColor(kGreen);
-
-    // Render edges as lines.
-    if (polygon.size() < 2) continue;
-    auto v_prev = v == polygon.vertices_begin()
-                      ? std::prev(polygon.vertices_end())
-                      : std::prev(v);
-    Ogre::Vector3 start(CGAL::to_double(v_prev->x()),
-                        CGAL::to_double(v_prev->y()), altitude_);
-    rviz::Line* line = new rviz::Line(scene_manager_, polygon_node_);
-    line->setColor(c);
-    line->setPoints(start, p);
-    if (v == vertex_selection_) line->setColor(kGreen);
+    points.emplace_back(CGAL::to_double(v->x()), CGAL::to_double(v->y()), 0.0);
+  }
+  const bool rebuild = points != visual->points;
+  if (rebuild) {
+    visual->points = std::move(points);
+    visual->vertices.clear();
+    visual->edges.clear();
+    for (size_t i = 0; i < visual->points.size(); ++i) {
+      // Render vertices as spheres.
+      visual->vertices.emplace_back(
+          new rviz::Shape(rviz::Shape::Sphere, scene_manager_, polygon_node_));
+      visual->vertices.back()->setScale(Ogre::Vector3(kPtScale));
+      visual->vertices.back()->setPosition(visual->points[i]);
+
+      // Render edges as lines.
+      if (visual->points.size() < 2) continue;
+      const size_t i_prev = i == 0 ? visual->points.size() - 1 : i - 1;
+      visual->edges.emplace_back(new rviz::Line(scene_manager_, polygon_node_));
+      visual->edges.back()->setPoints(visual->points[i_prev],
+                                      visual->points[i]);
+    }
+  }
+
+  // Only recolour what changed.
+  if (rebuild || c != visual->colour) {
+    for (size_t i = 0; i < visual->vertices.size(); ++i) {
+      setVertexColour(i, c, visual);
+    }
+    visual->colour = c;
+    visual->selection = -1;
   }
+  if (selection != visual->selection) {
+    if (visual->selection >= 0) setVertexColour(visual->selection, c, visual);
+    if (selection >= 0) setVertexColour(selection, kGreen, visual);
+    visual->selection = selection;
+  }
+}
+
+void PolygonTool::setVertexColour(size_t i, const Ogre::ColourValue& c,
+                                  PolygonVisual* visual) const {
+  ROS_ASSERT(visual);
+  if (i < visual->vertices.size()) visual->vertices[i]->setColor(c);
+  if (i < visual->edges.size()) visual->edges[i]->setColor(c);
 }
 
 void PolygonTool::renderPolygons() {
   ROS_ASSERT(polygon_node_);
 
-  polygon_node_->removeAllChildren();  // Clear polygon visualization.
+  // The vertices are rendered in the plane of the polygon node, such that
+  // changing the altitude does not touch them.
+  polygon_node_->setPosition(0.0, 0.0, altitude_);
+
+  // Destroy the visuals of removed polygons.
+  for (auto it = visuals_.begin(); it != visuals_.end();) {
+    const bool exists =
+        std::any_of(polygons_.begin(), polygons_.end(),
+                    [&it](const Polygon_2& p) { return &p == it->first; });
+    it = exists ? std::next(it) : visuals_.erase(it);
+  }
+
   for (auto p = polygons_.begin(); p != polygons_.end(); ++p) {
     // Hull is blue, holes are red. Selected polygon is yellow.
     Ogre::ColourValue c = kRed;
+    int selection = -1;
     if (p == polygon_selection_) {
       c = kYellow;
+      if (vertex_selection_ != p->vertices_end()) {
+        selection = std::distance(p->vertices_begin(), vertex_selection_);
+      }
     } else if (p == polygons_.begin()) {
       c = kBlue;
     }
 
-    renderPolygon(*p, c);
+    renderPolygon(*p, c, selection, &visuals_[&*p]);
   }
 }
 
@@ -248,6 +314,9 @@ int PolygonTool::processKeyEvent(QKeyEvent* event, rviz::RenderPanel* panel) {
   }
 
   updateStatus();
+  if (!event->matches(QKeySequence::InsertParagraphSeparator)) {
+    schedulePublish();
+  }
   renderPolygons();
   return Render;
 }
@@ -327,8 +396,49 @@ void PolygonTool::publishPolygon() {
         res.front(), altitude_, &msg.polygon);
   }
   polygon_pub_.publish(msg);
+  published_polygons_ = polygons_;
+  published_altitude_ = altitude_;
+
+  if (!res.empty()) ROS_INFO_STREAM("Publishing polygon: " << res.front());
+}
+
+void PolygonTool::schedulePublish() {
+  if (!auto_publish_property_ || !auto_publish_property_->getBool()) return;
+  if (publish_pending_) return;  // Edit is published with the pending one.
+
+  const ros::WallDuration period(
+      std::max(0.0f, publish_period_property_->getFloat()));
+  const ros::WallDuration wait =
+      last_publish_time_ + period - ros::WallTime::now();
+  if (wait <= ros::WallDuration(0.0)) {
+    autoPublish();
+  } else {
+    // Coalesce all edits until the end of the period.
+    publish_timer_.stop();
+    publish_timer_.setPeriod(wait);
+    publish_timer_.start();
+    publish_pending_ = true;
+  }
+}
 
-  ROS_INFO_STREAM("Publishing polygon: " << res.front());
+void PolygonTool::autoPublish() {
+  last_publish_time_ = ros::WallTime::now();
+  // Incomplete polygons are still being edited.
+  for (const Polygon_2& p : polygons_) {
+    if (p.size() < 3) return;
+  }
+  if (polygons_ == published_polygons_ && altitude_ == published_altitude_) {
+    return;
+  }
+  publishPolygon();
+}
+
+void PolygonTool::publishTimerCallback(const ros::WallTimerEvent& event) {
+  publish_pending_ = false;
+  autoPublish();
+  // Publishing may reorient the polygons.
+  renderPolygons();
+  context_->queueRender();
 }
 
 void PolygonTool::updateStatus() {
@@ -366,6 +476,7 @@ void PolygonTool::increaseAltitude(rviz::ViewportMouseEvent& event) {
   }
 
   updateStatus();
+  schedulePublish();
   renderPolygons();
 }
 
@@ -379,6 +490,7 @@ void PolygonTool::decreaseAltitude(rviz::ViewportMouseEvent& event) {
   }
 
   updateStatus();
+  schedulePublish();
   renderPolygons();
 }
 